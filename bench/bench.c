@@ -0,0 +1,434 @@
+/**
+ * @file bench.c
+ * @brief Microbenchmarks of the hot paths of the common FSMs and of the display port.
+ *
+ * Each benchmark takes `BENCH_NUM_SAMPLES` samples with the time base of the platform (nanoseconds on the host, core cycles on the STM32F4). Before each repetition of the operation a preparation puts the FSMs in the state under test. A sample times a batch of `BENCH_BATCH_SIZE` repetitions and subtracts the time of the same batch of preparations alone, so that neither the preparations nor the reading of the time base are counted. The DWT counter is exact, so the target times each repetition on its own; the clock of the host is much coarser than the operations, so the host uses larger batches.
+ *
+ * The results are written as JSON to the standard output (semihosting on the target), or to the file given as first argument. Use `bench_compare` to compare them with a stored baseline.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* HW libraries */
+#include "port_system.h"
+#include "port_button.h"
+#include "port_ultrasound.h"
+#include "port_display.h"
+#include "port_buzzer.h"
+#include "fsm.h"
+#include "fsm_button.h"
+#include "fsm_ultrasound.h"
+#include "fsm_display.h"
+#include "fsm_buzzer.h"
+#include "fsm_urbanite.h"
+
+/* Other libraries */
+#include "bench_timer.h"
+
+/* Defines ------------------------------------------------------------------*/
+#ifndef BENCH_NUM_SAMPLES
+#define BENCH_NUM_SAMPLES 501 /*!< Number of timed repetitions of each operation. Odd, so that the median is a sample */
+#endif
+
+#ifndef BENCH_BATCH_SIZE
+#define BENCH_BATCH_SIZE 1 /*!< Number of repetitions of the operation timed by each sample */
+#endif
+
+#define BENCH_NUM_WARMUPS 16 /*!< Number of untimed samples before the timed ones */
+
+#define BENCH_ON_OFF_PRESS_TIME_MS 1000 /*!< Time in milliseconds to toggle the system on/off (as in `main.c`) */
+#define BENCH_PAUSE_DISPLAY_TIME_MS 500 /*!< Time in milliseconds to pause/resume the display (as in `main.c`) */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing a benchmark.
+ */
+typedef struct
+{
+    const char *p_name;            /*!< Name of the benchmark in the results */
+    void (*p_prepare)(int32_t arg); /*!< Untimed preparation of each repetition (NULL if none) */
+    void (*p_operation)(void);     /*!< Timed operation */
+    int32_t arg;                   /*!< Argument of the preparation, usually the state under test */
+} bench_t;
+
+/* Global variables -----------------------------------------------------------*/
+static fsm_button_t *p_fsm_button;           /*!< Button FSM */
+static fsm_ultrasound_t *p_fsm_ultrasound;   /*!< Ultrasound FSM */
+static fsm_display_t *p_fsm_display;         /*!< Display FSM */
+static fsm_buzzer_t *p_fsm_buzzer;           /*!< Buzzer FSM */
+static fsm_ultrasound_t *p_fsm_urbanite_ultrasound; /*!< Ultrasound FSM of the Urbanite FSM, which never has a new measurement */
+static fsm_urbanite_t *p_fsm_urbanite;       /*!< Urbanite FSM */
+
+static uint32_t samples[BENCH_NUM_SAMPLES]; /*!< Duration of each batch of the current benchmark */
+static uint32_t input_idx = 0;              /*!< Index of the next input of the benchmarks that go through a set of inputs */
+static volatile uint32_t sink;              /*!< Destination of the results of pure functions, so that they are not optimized out */
+
+/**
+ * @brief Distances that cover every band of the default display table and the out-of-range case.
+ */
+static const uint32_t distances_cm[] = {5, 20, 40, 100, 160, 190, 250};
+
+/**
+ * @brief Colors written to the display by `port_display_set_rgb()`.
+ */
+static const rgb_color_t colors[] = {{255, 0, 0}, {237, 237, 0}, {0, 255, 0}, {25, 89, 81}, {0, 0, 255}, {0, 0, 0}};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Returns the next distance of the set of inputs.
+ *
+ * @return Distance in cm.
+ */
+static uint32_t _next_distance(void)
+{
+    return distances_cm[input_idx++ % (sizeof(distances_cm) / sizeof(distances_cm[0]))];
+}
+
+/* Operations */
+static void _op_button_fire(void)
+{
+    fsm_button_fire(p_fsm_button);
+}
+
+static void _op_ultrasound_fire(void)
+{
+    fsm_ultrasound_fire(p_fsm_ultrasound);
+}
+
+static void _op_display_fire(void)
+{
+    fsm_display_fire(p_fsm_display);
+}
+
+static void _op_buzzer_fire(void)
+{
+    fsm_buzzer_fire(p_fsm_buzzer);
+}
+
+static void _op_urbanite_fire(void)
+{
+    fsm_urbanite_fire(p_fsm_urbanite);
+}
+
+static void _op_display_get_urgency(void)
+{
+    sink = fsm_display_get_urgency(p_fsm_display, (int32_t)_next_distance());
+}
+
+static void _op_display_compute_levels(void)
+{
+    rgb_color_t color;
+    uint8_t level = _compute_display_levels(p_fsm_display, &color, (int32_t)_next_distance());
+    sink = level + color.r;
+}
+
+static void _op_port_display_set_rgb(void)
+{
+    port_display_set_rgb(PORT_REAR_PARKING_DISPLAY_ID, colors[input_idx++ % (sizeof(colors) / sizeof(colors[0]))]);
+}
+
+/* Preparations */
+/**
+ * @brief Puts the button FSM in a state with no input: the pressed flag keeps the level of the state.
+ *
+ * @param state State under test.
+ */
+static void _prepare_button_idle(int32_t state)
+{
+    port_button_set_pressed(PORT_PARKING_BUTTON_ID, (state == BUTTON_PRESSED) || (state == BUTTON_PRESSED_WAIT));
+    fsm_set_state(fsm_button_get_inner_fsm(p_fsm_button), state);
+    while (fsm_button_get_event(p_fsm_button, NULL))
+    {
+        // Discard the gestures of the previous repetitions
+    }
+}
+
+/**
+ * @brief Puts the ultrasound FSM in a state with no input: no trigger, no echo and the sensor on.
+ *
+ * @param state State under test.
+ */
+static void _prepare_ultrasound_idle(int32_t state)
+{
+    port_ultrasound_set_trigger_ready(PORT_REAR_PARKING_SENSOR_ID, false);
+    port_ultrasound_set_trigger_end(PORT_REAR_PARKING_SENSOR_ID, false);
+    port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, false);
+    port_ultrasound_reset_echo_ticks(PORT_REAR_PARKING_SENSOR_ID);
+    fsm_ultrasound_set_status(p_fsm_ultrasound, true);
+    fsm_ultrasound_set_state(p_fsm_ultrasound, state);
+}
+
+/**
+ * @brief Puts the ultrasound FSM in `WAIT_ECHO_END` with a complete echo, so that the operation runs `do_set_distance()`. Every fifth echo also computes the median of the last measurements.
+ *
+ * @param arg Not used.
+ */
+static void _prepare_ultrasound_echo(int32_t arg)
+{
+    uint32_t echo_us = (_next_distance() * 20000 + 171) / 343;
+    port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, 1000);
+    port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, 1000 + echo_us);
+    port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, 0);
+    port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+    fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+}
+
+/**
+ * @brief Puts the display FSM in a state with no input. The pending color, if any, is shown before the operation.
+ *
+ * @param state State under test.
+ */
+static void _prepare_display_idle(int32_t state)
+{
+    fsm_display_set_status(p_fsm_display, state == SET_DISPLAY);
+    fsm_display_set_state(p_fsm_display, state);
+    fsm_display_fire(p_fsm_display);
+    fsm_display_set_state(p_fsm_display, state);
+}
+
+/**
+ * @brief Puts the display FSM in `SET_DISPLAY` with a new distance, so that the operation computes and shows its color and level.
+ *
+ * @param arg Not used.
+ */
+static void _prepare_display_color(int32_t arg)
+{
+    fsm_display_set_status(p_fsm_display, true);
+    fsm_display_set_state(p_fsm_display, SET_DISPLAY);
+    fsm_display_set_distance(p_fsm_display, _next_distance());
+}
+
+/**
+ * @brief Puts the buzzer FSM in a state with no input. The pending cadence, if any, is set before the operation.
+ *
+ * @param state State under test.
+ */
+static void _prepare_buzzer_idle(int32_t state)
+{
+    fsm_buzzer_set_status(p_fsm_buzzer, state == SET_BUZZER);
+    fsm_buzzer_set_state(p_fsm_buzzer, state);
+    fsm_buzzer_fire(p_fsm_buzzer);
+    fsm_buzzer_set_state(p_fsm_buzzer, state);
+}
+
+/**
+ * @brief Puts the buzzer FSM in `SET_BUZZER` with a new distance, so that the operation computes and sets its cadence.
+ *
+ * @param arg Not used.
+ */
+static void _prepare_buzzer_cadence(int32_t arg)
+{
+    fsm_buzzer_set_status(p_fsm_buzzer, true);
+    fsm_buzzer_set_state(p_fsm_buzzer, SET_BUZZER);
+    fsm_buzzer_set_distance(p_fsm_buzzer, _next_distance());
+}
+
+/**
+ * @brief Puts the Urbanite FSM in a state with no command. The button is kept pressed so that the system never goes to sleep during the benchmark.
+ *
+ * @param state State under test.
+ */
+static void _prepare_urbanite_idle(int32_t state)
+{
+    _prepare_button_idle(BUTTON_PRESSED);
+    fsm_set_state((fsm_t *)p_fsm_urbanite, state);
+}
+
+/**
+ * @brief List of the benchmarks.
+ */
+static const bench_t benches_arr[] = {
+    {"button_fire_released", _prepare_button_idle, _op_button_fire, BUTTON_RELEASED},
+    {"button_fire_pressed_wait", _prepare_button_idle, _op_button_fire, BUTTON_PRESSED_WAIT},
+    {"button_fire_pressed", _prepare_button_idle, _op_button_fire, BUTTON_PRESSED},
+    {"button_fire_released_wait", _prepare_button_idle, _op_button_fire, BUTTON_RELEASED_WAIT},
+    {"ultrasound_fire_wait_start", _prepare_ultrasound_idle, _op_ultrasound_fire, WAIT_START},
+    {"ultrasound_fire_trigger_start", _prepare_ultrasound_idle, _op_ultrasound_fire, TRIGGER_START},
+    {"ultrasound_fire_wait_echo_start", _prepare_ultrasound_idle, _op_ultrasound_fire, WAIT_ECHO_START},
+    {"ultrasound_fire_wait_echo_end", _prepare_ultrasound_idle, _op_ultrasound_fire, WAIT_ECHO_END},
+    {"ultrasound_fire_set_distance", _prepare_ultrasound_idle, _op_ultrasound_fire, SET_DISTANCE},
+    {"ultrasound_do_set_distance", _prepare_ultrasound_echo, _op_ultrasound_fire, 0},
+    {"display_fire_wait_display", _prepare_display_idle, _op_display_fire, WAIT_DISPLAY},
+    {"display_fire_set_display", _prepare_display_idle, _op_display_fire, SET_DISPLAY},
+    {"display_do_set_color", _prepare_display_color, _op_display_fire, 0},
+    {"display_get_urgency", NULL, _op_display_get_urgency, 0},
+    {"display_compute_levels", NULL, _op_display_compute_levels, 0},
+    {"buzzer_fire_wait_buzzer", _prepare_buzzer_idle, _op_buzzer_fire, WAIT_BUZZER},
+    {"buzzer_fire_set_buzzer", _prepare_buzzer_idle, _op_buzzer_fire, SET_BUZZER},
+    {"buzzer_do_set_cadence", _prepare_buzzer_cadence, _op_buzzer_fire, 0},
+    {"urbanite_fire_off", _prepare_urbanite_idle, _op_urbanite_fire, OFF},
+    {"urbanite_fire_measure", _prepare_urbanite_idle, _op_urbanite_fire, MEASURE},
+    {"urbanite_fire_sleep_while_off", _prepare_urbanite_idle, _op_urbanite_fire, SLEEP_WHILE_OFF},
+    {"urbanite_fire_sleep_while_on", _prepare_urbanite_idle, _op_urbanite_fire, SLEEP_WHILE_ON},
+    {"port_display_set_rgb", NULL, _op_port_display_set_rgb, 0},
+};
+
+/**
+ * @brief Comparison function of two samples for `qsort()`.
+ *
+ * @param p_a Pointer to the first sample.
+ * @param p_b Pointer to the second sample.
+ *
+ * @return Negative, zero or positive if the first sample is shorter, equal or longer than the second one.
+ */
+static int _compare_samples(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Runs the preparation of a benchmark, if any.
+ *
+ * @param p_bench Pointer to the benchmark.
+ */
+static void _prepare(const bench_t *p_bench)
+{
+    if (p_bench->p_prepare != NULL)
+    {
+        p_bench->p_prepare(p_bench->arg);
+    }
+}
+
+/**
+ * @brief Runs a benchmark and sorts its samples.
+ *
+ * @param p_bench Pointer to the benchmark.
+ */
+static void _run(const bench_t *p_bench)
+{
+    for (uint32_t i = 0; i < BENCH_NUM_WARMUPS + BENCH_NUM_SAMPLES; i++)
+    {
+        uint32_t start = bench_timer_get_ticks();
+        for (uint32_t j = 0; j < BENCH_BATCH_SIZE; j++)
+        {
+            _prepare(p_bench);
+            p_bench->p_operation();
+        }
+        uint32_t ticks = bench_timer_get_ticks() - start;
+
+        start = bench_timer_get_ticks();
+        for (uint32_t j = 0; j < BENCH_BATCH_SIZE; j++)
+        {
+            _prepare(p_bench);
+        }
+        uint32_t prepare_ticks = bench_timer_get_ticks() - start;
+
+        if (i >= BENCH_NUM_WARMUPS)
+        {
+            samples[i - BENCH_NUM_WARMUPS] = (ticks > prepare_ticks) ? ticks - prepare_ticks : 0;
+        }
+    }
+    qsort(samples, BENCH_NUM_SAMPLES, sizeof(samples[0]), _compare_samples);
+}
+
+/**
+ * @brief Writes the duration of a batch as the duration of a single repetition, with one decimal.
+ *
+ * @param p_out Output stream.
+ * @param p_key JSON key of the value.
+ * @param batch_ticks Duration of a batch, in ticks.
+ */
+static void _print_per_op(FILE *p_out, const char *p_key, uint64_t batch_ticks)
+{
+    uint64_t tenths = (batch_ticks * 10 + BENCH_BATCH_SIZE / 2) / BENCH_BATCH_SIZE;
+    fprintf(p_out, ", \"%s\": %lu.%lu", p_key, (unsigned long)(tenths / 10), (unsigned long)(tenths % 10));
+}
+
+/**
+ * @brief Returns the mean of the samples of the last benchmark.
+ *
+ * @return Mean duration of a batch, rounded to the nearest tick.
+ */
+static uint64_t _mean(void)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < BENCH_NUM_SAMPLES; i++)
+    {
+        sum += samples[i];
+    }
+    return (sum + BENCH_NUM_SAMPLES / 2) / BENCH_NUM_SAMPLES;
+}
+
+/**
+ * @brief Runs the benchmarks and writes the results as JSON.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments: the optional path of the output file.
+ *
+ * @return int 0 on success, `EXIT_FAILURE` if the output file cannot be opened.
+ */
+int main(int argc, char *argv[])
+{
+    /* Init board, as in main.c */
+    port_system_init();
+    p_fsm_button = fsm_button_new(0, PORT_PARKING_BUTTON_ID);
+    p_fsm_ultrasound = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
+    p_fsm_display = fsm_display_new(PORT_REAR_PARKING_DISPLAY_ID);
+    p_fsm_buzzer = fsm_buzzer_new(PORT_REAR_PARKING_BUZZER_ID);
+    p_fsm_urbanite_ultrasound = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
+    p_fsm_urbanite = fsm_urbanite_new(p_fsm_button, BENCH_ON_OFF_PRESS_TIME_MS, BENCH_PAUSE_DISPLAY_TIME_MS, p_fsm_urbanite_ultrasound, p_fsm_display, p_fsm_buzzer);
+
+    // Every distance must reach the display, with no frame rate limit
+    fsm_display_set_max_frame_rate(p_fsm_display, 0);
+
+    FILE *p_out = stdout;
+    if (argc > 1)
+    {
+        p_out = fopen(argv[1], "w");
+        if (p_out == NULL)
+        {
+            perror(argv[1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // A first untimed pass warms up the caches (and the clock frequency of the host)
+    bench_timer_init();
+    uint32_t num_benches = sizeof(benches_arr) / sizeof(benches_arr[0]);
+    for (uint32_t i = 0; i < num_benches; i++)
+    {
+        _run(&benches_arr[i]);
+    }
+
+    fprintf(p_out, "{\n");
+    fprintf(p_out, "  \"platform\": \"%s\",\n", bench_timer_get_platform());
+    fprintf(p_out, "  \"unit\": \"%s\",\n", bench_timer_get_unit());
+    fprintf(p_out, "  \"samples\": %lu,\n", (unsigned long)BENCH_NUM_SAMPLES);
+    fprintf(p_out, "  \"batch\": %lu,\n", (unsigned long)BENCH_BATCH_SIZE);
+    fprintf(p_out, "  \"results\": [\n");
+    for (uint32_t i = 0; i < num_benches; i++)
+    {
+        _run(&benches_arr[i]);
+        fprintf(p_out, "    {\"name\": \"%s\"", benches_arr[i].p_name);
+        _print_per_op(p_out, "min", samples[0]);
+        _print_per_op(p_out, "median", samples[BENCH_NUM_SAMPLES / 2]);
+        _print_per_op(p_out, "mean", _mean());
+        _print_per_op(p_out, "max", samples[BENCH_NUM_SAMPLES - 1]);
+        fprintf(p_out, "}%s\n", (i + 1 < num_benches) ? "," : "");
+    }
+    fprintf(p_out, "  ]\n");
+    fprintf(p_out, "}\n");
+
+    if (p_out != stdout)
+    {
+        fclose(p_out);
+    }
+
+    fsm_urbanite_destroy(p_fsm_urbanite);
+    fsm_ultrasound_destroy(p_fsm_urbanite_ultrasound);
+    fsm_buzzer_destroy(p_fsm_buzzer);
+    fsm_display_destroy(p_fsm_display);
+    fsm_ultrasound_destroy(p_fsm_ultrasound);
+    fsm_button_destroy(p_fsm_button);
+    return 0;
+}
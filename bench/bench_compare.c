@@ -0,0 +1,257 @@
+/**
+ * @file bench_compare.c
+ * @brief Compares the results of the microbenchmarks with a stored baseline and flags the regressions.
+ *
+ * The median of each benchmark is compared with the median of the benchmark with the same name in the baseline. A benchmark regresses if it is slower by more than a relative threshold and by more than an absolute number of ticks, which filters out the jitter of the very short operations. The results of the target can be compared as well, since both files are plain JSON written by `bench`.
+ *
+ * Usage: `bench_compare [-t percent] [-d ticks] baseline.json results.json`
+ *
+ * - `-t percent`: relative threshold (10 % by default).
+ * - `-d ticks`: absolute threshold (2 ticks by default).
+ *
+ * The exit code is 0 if there are no regressions and 1 otherwise.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* Defines ------------------------------------------------------------------*/
+#define BENCH_COMPARE_MAX_RESULTS 64 /*!< Maximum number of benchmarks in a results file */
+#define BENCH_COMPARE_MAX_NAME 64    /*!< Maximum length of the name of a benchmark, including the terminator */
+#define BENCH_COMPARE_MAX_FILE 16384 /*!< Maximum size of a results file, in bytes */
+#define BENCH_COMPARE_DEFAULT_THRESHOLD_PERCENT 10 /*!< Default relative threshold of a regression */
+#define BENCH_COMPARE_DEFAULT_THRESHOLD_TICKS 2    /*!< Default absolute threshold of a regression */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the result of a benchmark.
+ */
+typedef struct
+{
+    char name[BENCH_COMPARE_MAX_NAME]; /*!< Name of the benchmark */
+    double median;                     /*!< Median duration of an operation, in ticks */
+} bench_result_t;
+
+/**
+ * @brief Structure representing a results file.
+ */
+typedef struct
+{
+    char unit[BENCH_COMPARE_MAX_NAME];                    /*!< Unit of the ticks */
+    bench_result_t results[BENCH_COMPARE_MAX_RESULTS];    /*!< Results of the benchmarks */
+    uint32_t num_results;                                 /*!< Number of results */
+} bench_file_t;
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Copies the string value of a JSON key that follows a position of a text.
+ *
+ * @param p_text Position from which the key is searched.
+ * @param p_key Key, including the quotes.
+ * @param p_value Destination of the value.
+ * @param size Size of the destination.
+ *
+ * @return Position after the value, or NULL if the key is not found.
+ */
+static const char *_get_string(const char *p_text, const char *p_key, char *p_value, size_t size)
+{
+    const char *p = strstr(p_text, p_key);
+    if (p == NULL || (p = strchr(p + strlen(p_key), '"')) == NULL)
+    {
+        return NULL;
+    }
+    p++;
+    size_t len = strcspn(p, "\"");
+    if (len >= size)
+    {
+        len = size - 1;
+    }
+    memcpy(p_value, p, len);
+    p_value[len] = '\0';
+    return p + len;
+}
+
+/**
+ * @brief Reads the numeric value of a JSON key that follows a position of a text.
+ *
+ * @param p_text Position from which the key is searched.
+ * @param p_key Key, including the quotes.
+ * @param p_value Destination of the value.
+ *
+ * @return Position after the value, or NULL if the key is not found.
+ */
+static const char *_get_number(const char *p_text, const char *p_key, double *p_value)
+{
+    const char *p = strstr(p_text, p_key);
+    if (p == NULL || (p = strchr(p + strlen(p_key), ':')) == NULL)
+    {
+        return NULL;
+    }
+    char *p_end;
+    *p_value = strtod(p + 1, &p_end);
+    return p_end;
+}
+
+/**
+ * @brief Loads a results file written by `bench`.
+ *
+ * @param p_path Path of the file.
+ * @param p_file Destination of the results.
+ *
+ * @retval true if the file has been loaded.
+ * @retval false if it cannot be read or it has no results.
+ */
+static bool _load(const char *p_path, bench_file_t *p_file)
+{
+    static char text[BENCH_COMPARE_MAX_FILE];
+    FILE *p_stream = fopen(p_path, "r");
+    if (p_stream == NULL)
+    {
+        perror(p_path);
+        return false;
+    }
+    size_t len = fread(text, 1, sizeof(text) - 1, p_stream);
+    fclose(p_stream);
+    text[len] = '\0';
+
+    p_file->num_results = 0;
+    if (_get_string(text, "\"unit\"", p_file->unit, sizeof(p_file->unit)) == NULL)
+    {
+        fprintf(stderr, "%s: no unit\n", p_path);
+        return false;
+    }
+    const char *p = strstr(text, "\"results\"");
+    while (p != NULL && p_file->num_results < BENCH_COMPARE_MAX_RESULTS)
+    {
+        bench_result_t *p_result = &p_file->results[p_file->num_results];
+        p = _get_string(p, "\"name\"", p_result->name, sizeof(p_result->name));
+        if (p != NULL)
+        {
+            p = _get_number(p, "\"median\"", &p_result->median);
+        }
+        if (p != NULL)
+        {
+            p_file->num_results++;
+        }
+    }
+    if (p_file->num_results == 0)
+    {
+        fprintf(stderr, "%s: no results\n", p_path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Finds the result of a benchmark by name.
+ *
+ * @param p_file Results file.
+ * @param p_name Name of the benchmark.
+ *
+ * @return Pointer to the result, or NULL if the benchmark is not in the file.
+ */
+static const bench_result_t *_find(const bench_file_t *p_file, const char *p_name)
+{
+    for (uint32_t i = 0; i < p_file->num_results; i++)
+    {
+        if (strcmp(p_file->results[i].name, p_name) == 0)
+        {
+            return &p_file->results[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Writes the usage of the program.
+ *
+ * @param p_program Name of the program.
+ */
+static void _usage(const char *p_program)
+{
+    fprintf(stderr, "Usage: %s [-t percent] [-d ticks] baseline.json results.json\n", p_program);
+}
+
+/**
+ * @brief Compares a results file with a baseline.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ *
+ * @return int 0 if there are no regressions, 1 if there are, `EXIT_FAILURE` if the files cannot be compared.
+ */
+int main(int argc, char *argv[])
+{
+    static bench_file_t baseline;
+    static bench_file_t current;
+    double threshold_percent = BENCH_COMPARE_DEFAULT_THRESHOLD_PERCENT;
+    double threshold_ticks = BENCH_COMPARE_DEFAULT_THRESHOLD_TICKS;
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            threshold_percent = strtod(argv[++i], NULL);
+        }
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+        {
+            threshold_ticks = strtod(argv[++i], NULL);
+        }
+        else
+        {
+            _usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - i != 2)
+    {
+        _usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!_load(argv[i], &baseline) || !_load(argv[i + 1], &current))
+    {
+        return EXIT_FAILURE;
+    }
+    if (strcmp(baseline.unit, current.unit) != 0)
+    {
+        fprintf(stderr, "The baseline is in %s and the results are in %s\n", baseline.unit, current.unit);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t num_regressions = 0;
+    printf("%-34s %10s %10s %8s\n", "benchmark", "baseline", "current", "change");
+    for (uint32_t j = 0; j < current.num_results; j++)
+    {
+        const bench_result_t *p_result = &current.results[j];
+        const bench_result_t *p_base = _find(&baseline, p_result->name);
+        if (p_base == NULL)
+        {
+            printf("%-34s %10s %10.1f %8s  new\n", p_result->name, "-", p_result->median, "-");
+            continue;
+        }
+        double delta = p_result->median - p_base->median;
+        double change = (p_base->median > 0) ? 100.0 * delta / p_base->median : 0.0;
+        bool regression = (delta > threshold_ticks) && (delta * 100 > p_base->median * threshold_percent);
+        num_regressions += regression ? 1 : 0;
+        printf("%-34s %10.1f %10.1f %+7.1f%%%s\n", p_result->name, p_base->median, p_result->median, change, regression ? "  REGRESSION" : "");
+    }
+    for (uint32_t j = 0; j < baseline.num_results; j++)
+    {
+        if (_find(&current, baseline.results[j].name) == NULL)
+        {
+            printf("%-34s %10.1f %10s %8s  missing\n", baseline.results[j].name, baseline.results[j].median, "-", "-");
+        }
+    }
+    printf("%lu regressions (threshold %g %% and %g %s)\n", (unsigned long)num_regressions, threshold_percent, threshold_ticks, current.unit);
+    return (num_regressions > 0) ? 1 : 0;
+}
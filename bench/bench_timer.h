@@ -0,0 +1,45 @@
+/**
+ * @file bench_timer.h
+ * @brief Header of the time base of the microbenchmarks.
+ *
+ * Each platform provides its own implementation: the host counts nanoseconds of a monotonic clock and the STM32F4 counts core cycles with the DWT cycle counter.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef BENCH_TIMER_H_
+#define BENCH_TIMER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Starts the counter of the time base.
+ */
+void bench_timer_init(void);
+
+/**
+ * @brief Returns the value of the counter of the time base. The counter is free-running and wraps around, so only the difference between two values is meaningful.
+ *
+ * @return Value of the counter, in the unit returned by `bench_timer_get_unit()`.
+ */
+uint32_t bench_timer_get_ticks(void);
+
+/**
+ * @brief Returns the unit of the counter of the time base.
+ *
+ * @return Name of the unit (`"ns"` or `"cycles"`).
+ */
+const char *bench_timer_get_unit(void);
+
+/**
+ * @brief Returns the name of the platform on which the benchmarks run.
+ *
+ * @return Name of the platform.
+ */
+const char *bench_timer_get_platform(void);
+
+#endif /* BENCH_TIMER_H_ */
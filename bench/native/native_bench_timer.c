@@ -0,0 +1,39 @@
+/**
+ * @file native_bench_timer.c
+ * @brief Time base of the microbenchmarks in the native platform: nanoseconds of the monotonic clock of the host.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+
+/* Other includes */
+#include "bench_timer.h"
+
+/* Public functions -----------------------------------------------------------*/
+void bench_timer_init(void)
+{
+    // The monotonic clock is always running
+}
+
+uint32_t bench_timer_get_ticks(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+
+const char *bench_timer_get_unit(void)
+{
+    return "ns";
+}
+
+const char *bench_timer_get_platform(void)
+{
+    return "native";
+}
@@ -0,0 +1,38 @@
+/**
+ * @file stm32f4_bench_timer.c
+ * @brief Time base of the microbenchmarks in the STM32F4 platform: core cycles counted by the DWT unit.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW dependent includes */
+#include "stm32f4_system.h"
+
+/* Other includes */
+#include "bench_timer.h"
+
+/* Public functions -----------------------------------------------------------*/
+void bench_timer_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; // Enable the trace and debug blocks (DWT)
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; // Start the cycle counter
+}
+
+uint32_t bench_timer_get_ticks(void)
+{
+    return DWT->CYCCNT;
+}
+
+const char *bench_timer_get_unit(void)
+{
+    return "cycles";
+}
+
+const char *bench_timer_get_platform(void)
+{
+    return "stm32f4";
+}
@@ -0,0 +1,190 @@
+/**
+ * @file distance_history.h
+ * @brief Header for distance_history.c file.
+ *
+ * A distance history keeps every filtered distance of an ultrasound sensor with its timestamp, compressed into a fixed amount of RAM. Each sample is stored as the step from the previous one: the change of distance and, only when it changes, the time since the previous sample. The values are zig-zag encoded (so that small negative changes are small numbers) and written as varints (7 bits per byte). A sample taken at the usual period takes one byte, three samples that change by at most 1 cm take one byte, and a run of samples with the same step (the vehicle still, or approaching at a constant speed) takes one or two bytes for the whole run. Ten minutes of parking manoeuvres at 20 Hz take less than 4 KB.
+ *
+ * The history is split into blocks that start from the absolute timestamp and distance of the sample before them, so that when the history is full the oldest block is dropped and the rest can still be decoded. The history lives in RAM and its memory image is also its file format, so it can be dumped from the target with the debugger (`dump binary memory history.bin &history (&history)+1` in GDB) or saved with semihosting, and decoded on the host with `history_dump`.
+ *
+ * Token of a sample (varint): `(payload << 2) | kind`.
+ * - `DISTANCE_HISTORY_KIND_STEP`: the payload is the zig-zag change of distance; the time since the previous sample is that of the previous step.
+ * - `DISTANCE_HISTORY_KIND_STEP_TIME`: as above, followed by a varint with the time since the previous sample, in ms.
+ * - `DISTANCE_HISTORY_KIND_RUN`: the payload is the number of samples that repeat the previous step.
+ * - `DISTANCE_HISTORY_KIND_SMALL_STEPS`: three samples at the time of the previous step with changes of -1, 0 or +1 cm (the noise of a still vehicle, or a slow one), as the base-3 digits `change + 1` of the payload from the least significant one. It takes one byte.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef DISTANCE_HISTORY_H_
+#define DISTANCE_HISTORY_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#ifndef DISTANCE_HISTORY_NUM_BLOCKS
+#define DISTANCE_HISTORY_NUM_BLOCKS 16 /*!< Number of blocks of a history (4 KB). When it is full, the oldest block is dropped.*/
+#endif
+#define DISTANCE_HISTORY_BLOCK_SIZE 256 /*!< Size of a block, header included, in bytes */
+#define DISTANCE_HISTORY_BLOCK_HEADER_SIZE 20 /*!< Size of the header of a block, in bytes */
+#define DISTANCE_HISTORY_BLOCK_DATA_SIZE (DISTANCE_HISTORY_BLOCK_SIZE - DISTANCE_HISTORY_BLOCK_HEADER_SIZE) /*!< Size of the tokens of a block, in bytes */
+
+#define DISTANCE_HISTORY_MAGIC 0x31484944 /*!< Identifier of a distance history ("DIH1" in memory).*/
+
+/**
+ * @brief Kinds of the tokens of a history.
+ */
+enum DISTANCE_HISTORY_KINDS
+{
+    DISTANCE_HISTORY_KIND_STEP = 0,    /*!< New change of distance, same time since the previous sample */
+    DISTANCE_HISTORY_KIND_STEP_TIME,   /*!< New change of distance and new time since the previous sample */
+    DISTANCE_HISTORY_KIND_RUN,         /*!< Samples that repeat the previous step */
+    DISTANCE_HISTORY_KIND_SMALL_STEPS, /*!< Three changes of distance of -1, 0 or +1 cm, same time since the previous sample */
+};
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing a sample of a history.
+ */
+typedef struct
+{
+    uint32_t timestamp_ms; /*!< System time (in ms) at which the distance was measured.*/
+    uint32_t distance_cm;  /*!< Filtered distance, in cm.*/
+} distance_history_sample_t;
+
+/**
+ * @brief Structure representing a block of a history: the state of the decoder before its first token, and its tokens.
+ */
+typedef struct
+{
+    uint32_t timestamp_ms;   /*!< Timestamp of the sample before the block.*/
+    uint32_t distance_cm;    /*!< Distance of the sample before the block.*/
+    uint32_t dt_ms;          /*!< Time between the last two samples before the block.*/
+    int32_t delta_cm;        /*!< Change of distance between the last two samples before the block.*/
+    uint16_t num_samples;    /*!< Number of samples of the block.*/
+    uint16_t num_bytes;      /*!< Number of bytes of tokens of the block.*/
+    uint8_t data[DISTANCE_HISTORY_BLOCK_DATA_SIZE]; /*!< Tokens of the samples.*/
+} distance_history_block_t;
+
+/**
+ * @brief Structure representing a distance history: a header followed by a circular buffer of blocks.
+ */
+typedef struct
+{
+    uint32_t magic;            /*!< `DISTANCE_HISTORY_MAGIC`.*/
+    uint16_t block_size;       /*!< Size of a block, in bytes.*/
+    uint16_t num_blocks;       /*!< Number of blocks of the buffer.*/
+    uint32_t first_block;      /*!< Index of the oldest block.*/
+    uint32_t used_blocks;      /*!< Number of blocks in use.*/
+    uint32_t num_samples;      /*!< Number of samples added since the history was initialized, including those already dropped.*/
+    uint32_t run_length;       /*!< Samples that repeat the last step written and have not been written to a block yet.*/
+    uint16_t num_small_steps;  /*!< Samples of a group of small steps that have not been written to a block yet (less than three).*/
+    uint16_t small_steps;      /*!< Changes of distance of the group of small steps, as in `DISTANCE_HISTORY_KIND_SMALL_STEPS`.*/
+    uint32_t timestamp_ms;     /*!< Timestamp of the last sample written to a block.*/
+    uint32_t distance_cm;      /*!< Distance of the last sample written to a block.*/
+    uint32_t dt_ms;            /*!< Time between the last two samples written to a block.*/
+    int32_t delta_cm;          /*!< Change of distance between the last two samples written to a block.*/
+    uint32_t last_timestamp_ms; /*!< Timestamp of the last sample added.*/
+    uint32_t last_distance_cm;  /*!< Distance of the last sample added.*/
+    distance_history_block_t blocks[DISTANCE_HISTORY_NUM_BLOCKS]; /*!< Blocks of the history.*/
+} distance_history_t;
+
+/**
+ * @brief Structure representing a reader of a history, from the oldest sample to the newest one.
+ */
+typedef struct
+{
+    const distance_history_t *p_history; /*!< History being read.*/
+    uint32_t block;                      /*!< Block being read, from 0 for the oldest one.*/
+    uint32_t offset;                     /*!< Offset of the next token in the block.*/
+    uint32_t run_length;                 /*!< Samples left of the current run.*/
+    uint32_t num_small_steps;            /*!< Samples left of the current group of small steps.*/
+    uint32_t small_steps;                /*!< Changes of distance left of the current group of small steps.*/
+    bool pending_done;                   /*!< The samples not written to a block yet have been read.*/
+    uint32_t timestamp_ms;               /*!< Timestamp of the last sample read.*/
+    uint32_t distance_cm;                /*!< Distance of the last sample read.*/
+    uint32_t dt_ms;                      /*!< Time between the last two samples read.*/
+    int32_t delta_cm;                    /*!< Change of distance between the last two samples read.*/
+} distance_history_iter_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Empties a history and writes its header.
+ *
+ * @param p_history Pointer to the history.
+ */
+void distance_history_init(distance_history_t *p_history);
+
+/**
+ * @brief Adds a sample to a history. The oldest block is dropped if the history is full.
+ *
+ * @param p_history Pointer to the history.
+ * @param timestamp_ms System time (in ms) at which the distance was measured. The samples must be added in order of time.
+ * @param distance_cm Filtered distance, in cm.
+ */
+void distance_history_add(distance_history_t *p_history, uint32_t timestamp_ms, uint32_t distance_cm);
+
+/**
+ * @brief Returns the number of samples of a history that can be read.
+ *
+ * @param p_history Pointer to the history.
+ *
+ * @return uint32_t Number of samples kept.
+ */
+uint32_t distance_history_get_count(const distance_history_t *p_history);
+
+/**
+ * @brief Returns the number of bytes of tokens written to a history.
+ *
+ * @param p_history Pointer to the history.
+ *
+ * @return uint32_t Bytes used by the blocks kept, headers included.
+ */
+uint32_t distance_history_get_bytes_used(const distance_history_t *p_history);
+
+/**
+ * @brief Starts reading a history from its oldest sample kept.
+ *
+ * @param p_iter Pointer to the reader.
+ * @param p_history Pointer to the history. It must not change while it is read.
+ */
+void distance_history_iter_init(distance_history_iter_t *p_iter, const distance_history_t *p_history);
+
+/**
+ * @brief Reads the next sample of a history.
+ *
+ * @param p_iter Pointer to the reader.
+ * @param p_sample Pointer to the sample read.
+ *
+ * @retval true if a sample has been read.
+ * @retval false if there are no more samples, or the history is corrupt.
+ */
+bool distance_history_iter_next(distance_history_iter_t *p_iter, distance_history_sample_t *p_sample);
+
+/**
+ * @brief Saves the memory image of a history to a file (host or semihosting).
+ *
+ * @param p_history Pointer to the history.
+ * @param p_path Path of the file.
+ *
+ * @retval true if the history has been saved.
+ * @retval false if the file cannot be written.
+ */
+bool distance_history_save(const distance_history_t *p_history, const char *p_path);
+
+/**
+ * @brief Loads a history from a file. The file may come from a build with a different `DISTANCE_HISTORY_NUM_BLOCKS`: the newest blocks that fit are kept.
+ *
+ * @param p_history Pointer to the history.
+ * @param p_path Path of the file.
+ *
+ * @retval true if the history has been loaded.
+ * @retval false if the file cannot be read or it is not a distance history.
+ */
+bool distance_history_load(distance_history_t *p_history, const char *p_path);
+
+#endif /* DISTANCE_HISTORY_H_ */
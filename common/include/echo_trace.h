@@ -0,0 +1,110 @@
+/**
+ * @file echo_trace.h
+ * @brief Header for echo_trace.c file.
+ *
+ * An echo trace keeps the raw timings of the last echoes of the ultrasound sensors, as read by `do_set_distance()` before any filtering. The trace lives in RAM and its memory image is also its file format, so it can be dumped from the target with the debugger (`dump binary memory trace.bin &trace (&trace)+1` in GDB) or saved with semihosting, and replayed on the host through the filters of the ultrasound FSM. The image is little-endian, as both the STM32F4 and the usual hosts.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef ECHO_TRACE_H_
+#define ECHO_TRACE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#ifndef ECHO_TRACE_MAX_RECORDS
+#define ECHO_TRACE_MAX_RECORDS 256 /*!< Number of records of a trace. When it is full, each new echo overwrites the oldest one.*/
+#endif
+
+#define ECHO_TRACE_MAGIC 0x31525445 /*!< Identifier of an echo trace ("ETR1" in memory).*/
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the raw timings of an echo (12 bytes).
+ */
+
+typedef struct {
+    uint32_t timestamp_ms;  /*!< System time (in ms) at which the echo was processed.*/
+    uint16_t init_tick;     /*!< Value of the echo timer at the rising edge of the echo.*/
+    uint16_t end_tick;      /*!< Value of the echo timer at the falling edge of the echo.*/
+    uint16_t overflows;     /*!< Number of overflows of the echo timer between both edges.*/
+    uint16_t ultrasound_id; /*!< ID of the ultrasound sensor.*/
+} echo_trace_record_t;
+
+/**
+ * @brief Structure representing an echo trace: a header followed by a circular buffer of records.
+ */
+
+typedef struct {
+    uint32_t magic;        /*!< `ECHO_TRACE_MAGIC`.*/
+    uint16_t record_size;  /*!< Size of a record, in bytes.*/
+    uint16_t max_records;  /*!< Number of records of the buffer.*/
+    uint32_t next_idx;     /*!< Index of the record that the next echo will be written to.*/
+    uint32_t num_echoes;   /*!< Number of echoes written since the trace was initialized, including those already overwritten.*/
+    echo_trace_record_t records[ECHO_TRACE_MAX_RECORDS]; /*!< Records of the echoes.*/
+} echo_trace_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Empties an echo trace and writes its header.
+ *
+ * @param p_trace Pointer to the trace.
+ */
+void echo_trace_init(echo_trace_t *p_trace);
+
+/**
+ * @brief Adds the raw timings of an echo to a trace. The oldest record is overwritten if the trace is full.
+ *
+ * @param p_trace Pointer to the trace.
+ * @param p_record Pointer to the record of the echo.
+ */
+void echo_trace_add(echo_trace_t *p_trace, const echo_trace_record_t *p_record);
+
+/**
+ * @brief Returns the number of records of a trace that can be read.
+ *
+ * @param p_trace Pointer to the trace.
+ *
+ * @return Number of records, up to `max_records`.
+ */
+uint32_t echo_trace_get_count(const echo_trace_t *p_trace);
+
+/**
+ * @brief Returns a record of a trace, from the oldest one to the newest one.
+ *
+ * @param p_trace Pointer to the trace.
+ * @param idx Index of the record: 0 for the oldest record kept.
+ *
+ * @return Pointer to the record, or NULL if there is no such record.
+ */
+const echo_trace_record_t *echo_trace_get_record(const echo_trace_t *p_trace, uint32_t idx);
+
+/**
+ * @brief Saves the memory image of a trace to a file (host or semihosting).
+ *
+ * @param p_trace Pointer to the trace.
+ * @param p_path Path of the file.
+ *
+ * @retval true if the trace has been saved.
+ * @retval false if the file cannot be written.
+ */
+bool echo_trace_save(const echo_trace_t *p_trace, const char *p_path);
+
+/**
+ * @brief Loads a trace from a file. The file may come from a build with a different `ECHO_TRACE_MAX_RECORDS`: the newest records that fit are kept.
+ *
+ * @param p_trace Pointer to the trace.
+ * @param p_path Path of the file.
+ *
+ * @retval true if the trace has been loaded.
+ * @retval false if the file cannot be read or it is not an echo trace.
+ */
+bool echo_trace_load(echo_trace_t *p_trace, const char *p_path);
+
+#endif /* ECHO_TRACE_H_ */
@@ -0,0 +1,183 @@
+/**
+ * @file flash_log.h
+ * @brief Header for flash_log.c file.
+ *
+ * A flash log is an append-only store of small records in the sectors of the non-volatile storage (`port_storage.h`), so that measurements and events survive power cycles without an external EEPROM. The sectors are written in turn: when the active sector is full, the next one is erased and becomes the active one, dropping its old records, so every sector is erased as often as the others.
+ *
+ * Each sector starts with a header with its sequence number (one more than the previous active sector), its number of erases and a CRC-32. Each record is a header word with its length, type and a check byte, a CRC-32 word of the header and the payload, and the payload padded to a whole word. A record never spans two sectors.
+ *
+ * Programming a word stalls the CPU, so the records are appended to a batch in RAM and programmed together by `flash_log_flush()` when the system is about to sleep, or when the batch is full. The records still in the batch are lost on a power loss.
+ *
+ * Erasing a sector stalls the CPU much longer (1 to 2 s on the STM32F4), so the erases can be forbidden while the system must respond (`flash_log_set_erase_allowed()`): a batch that needs a new sector is then held in RAM, and the records that do not fit in it are dropped. `flash_log_prepare()` erases the next sector in advance when a stall does not matter, e.g., when the system is switched off.
+ *
+ * At boot, the active sector is the valid one with the highest sequence number, and the write head is found by following the lengths of its records up to the first erased header: only one word per record is read. A record torn by a power loss while it was programmed is skipped when it is read, as its CRC does not match, and the next records are written after it. A header torn by a power loss makes the sector full, so the next records go to the next sector.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef FLASH_LOG_H_
+#define FLASH_LOG_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#ifndef FLASH_LOG_BATCH_SIZE
+#define FLASH_LOG_BATCH_SIZE 256 /*!< Size of the batch of records kept in RAM before they are programmed, in bytes (a multiple of 4). It is also the largest record.*/
+#endif
+#define FLASH_LOG_MAGIC 0x474F4C46 /*!< Identifier of a sector of a flash log ("FLOG" in memory).*/
+#define FLASH_LOG_SECTOR_HEADER_SIZE 16 /*!< Size of the header of a sector, in bytes */
+#define FLASH_LOG_RECORD_HEADER_SIZE 8 /*!< Size of the header of a record, in bytes */
+#define FLASH_LOG_MAX_PAYLOAD (FLASH_LOG_BATCH_SIZE - FLASH_LOG_RECORD_HEADER_SIZE) /*!< Largest payload of a record, in bytes */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing a flash log: the write head in the storage and the batch of records not programmed yet.
+ */
+typedef struct
+{
+    uint32_t num_sectors;   /*!< Number of sectors of the storage.*/
+    uint32_t sector_size;   /*!< Size of a sector, in bytes.*/
+    uint32_t sector;        /*!< Index of the active sector.*/
+    uint32_t sequence;      /*!< Sequence number of the active sector.*/
+    uint32_t offset;        /*!< Offset in the active sector where the batch will be programmed.*/
+    bool rotate_pending;    /*!< The active sector is full: the batch will be programmed in the next sector, after erasing it.*/
+    bool erase_allowed;     /*!< The sectors can be erased to continue the log. Otherwise, a batch that needs a new sector is held.*/
+    uint32_t batch_bytes;   /*!< Bytes of records in the batch.*/
+    uint32_t batch_records; /*!< Number of records in the batch.*/
+    uint32_t batch[FLASH_LOG_BATCH_SIZE / sizeof(uint32_t)]; /*!< Records not programmed yet, as they will be programmed.*/
+    uint32_t num_appended;  /*!< Number of records appended since the log was initialized.*/
+    uint32_t num_dropped;   /*!< Number of records lost because the storage failed, the record is too large, or the batch is held and full.*/
+    uint32_t num_flushes;   /*!< Number of batches programmed.*/
+    uint32_t num_rotations; /*!< Number of sectors erased to continue the log.*/
+} flash_log_t;
+
+/**
+ * @brief Structure representing a record read from a flash log.
+ */
+typedef struct
+{
+    uint8_t type;        /*!< Type of the record, defined by the application.*/
+    uint16_t length;     /*!< Length of the payload, in bytes.*/
+    uint32_t sequence;   /*!< Sequence number of the sector of the record.*/
+    uint32_t payload[FLASH_LOG_MAX_PAYLOAD / sizeof(uint32_t)]; /*!< Payload of the record.*/
+} flash_log_record_t;
+
+/**
+ * @brief Structure representing a reader of a flash log, from the oldest record to the newest one.
+ */
+typedef struct
+{
+    const flash_log_t *p_log; /*!< Log being read.*/
+    uint32_t num_sectors_read; /*!< Number of sectors read, including the current one.*/
+    uint32_t sector;          /*!< Sector being read.*/
+    uint32_t sequence;        /*!< Sequence number of the sector being read.*/
+    uint32_t offset;          /*!< Offset of the next record in the sector, or 0 if the sector has not been opened yet.*/
+    uint32_t num_corrupt;     /*!< Number of records skipped because their CRC does not match.*/
+} flash_log_iter_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Initializes the storage and recovers the write head of a flash log. If no sector holds a valid header, the first sector is erased and the log starts empty.
+ *
+ * @param p_log Pointer to the log.
+ *
+ * @retval true if the log can be used.
+ * @retval false if the storage is not available or too small (less than two sectors, or sectors smaller than a batch).
+ */
+bool flash_log_init(flash_log_t *p_log);
+
+/**
+ * @brief Erases every sector of a flash log and starts it empty. The number of erases of the sectors is kept.
+ *
+ * @param p_log Pointer to the log.
+ *
+ * @retval true if the log has been erased.
+ * @retval false if the storage failed.
+ */
+bool flash_log_format(flash_log_t *p_log);
+
+/**
+ * @brief Appends a record to the batch of a flash log. If the batch is full, or the record does not fit in the rest of the active sector, the batch is programmed first.
+ *
+ * @param p_log Pointer to the log.
+ * @param type Type of the record, defined by the application.
+ * @param p_payload Pointer to the payload.
+ * @param length Length of the payload, in bytes (up to `FLASH_LOG_MAX_PAYLOAD`).
+ *
+ * @retval true if the record has been appended.
+ * @retval false if the record is too large, or the batch could not be programmed to make room for it.
+ */
+bool flash_log_append(flash_log_t *p_log, uint8_t type, const void *p_payload, uint32_t length);
+
+/**
+ * @brief Programs the batch of a flash log. If the active sector is full, the next sector is erased first (1 to 2 s on the STM32F4), unless the erases are not allowed.
+ *
+ * @param p_log Pointer to the log.
+ *
+ * @retval true if the batch is empty or has been programmed.
+ * @retval false if the storage failed, or if the batch needs a new sector and the erases are not allowed. In the first case the records of the batch are dropped and the next batch goes to the next sector; in the second one they are held in the batch.
+ */
+bool flash_log_flush(flash_log_t *p_log);
+
+/**
+ * @brief Allows or forbids erasing the sectors of a flash log. The erases are allowed after `flash_log_init()`.
+ *
+ * @param p_log Pointer to the log.
+ * @param allowed `true` to erase the next sector when the active one is full, `false` to hold the batch in RAM instead.
+ */
+void flash_log_set_erase_allowed(flash_log_t *p_log, bool allowed);
+
+/**
+ * @brief Continues a flash log in the next sector in advance if less than half of the active sector is free: the batch is programmed and the next sector is erased now (1 to 2 s on the STM32F4), so that the next records rarely need an erase. It erases even if the erases are not allowed.
+ *
+ * @param p_log Pointer to the log.
+ *
+ * @retval true if the log has room for the next records.
+ * @retval false if the storage failed.
+ */
+bool flash_log_prepare(flash_log_t *p_log);
+
+/**
+ * @brief Returns the number of bytes of records in the batch of a flash log.
+ *
+ * @param p_log Pointer to the log.
+ *
+ * @return uint32_t Bytes not programmed yet, headers included.
+ */
+uint32_t flash_log_get_pending_bytes(const flash_log_t *p_log);
+
+/**
+ * @brief Returns the number of erases of a sector of a flash log.
+ *
+ * @param p_log Pointer to the log.
+ * @param sector Index of the sector.
+ *
+ * @return uint32_t Number of erases written in the header of the sector, or 0 if it has no valid header.
+ */
+uint32_t flash_log_get_erase_count(const flash_log_t *p_log, uint32_t sector);
+
+/**
+ * @brief Starts reading the records programmed in a flash log, from the oldest one. The records in the batch are not read.
+ *
+ * @param p_iter Pointer to the reader.
+ * @param p_log Pointer to the log. It must not be flushed while it is read.
+ */
+void flash_log_iter_init(flash_log_iter_t *p_iter, const flash_log_t *p_log);
+
+/**
+ * @brief Reads the next valid record of a flash log. Records whose CRC does not match are skipped and counted.
+ *
+ * @param p_iter Pointer to the reader.
+ * @param p_record Pointer to the record read.
+ *
+ * @retval true if a record has been read.
+ * @retval false if there are no more records.
+ */
+bool flash_log_iter_next(flash_log_iter_t *p_iter, flash_log_record_t *p_record);
+
+#endif /* FLASH_LOG_H_ */
@@ -16,9 +16,19 @@
 
 /* Other includes */
 #include "fsm.h"
+#include "transition_trace.h"
 
 
 /* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define FSM_BUTTON_EVENT_QUEUE_SIZE 8 /*!< Maximum number of gestures waiting to be consumed.*/
+
+#define FSM_BUTTON_DEFAULT_LONG_PRESS_MS 1000 /*!< Default time (in ms) a press must last to be a long press.*/
+
+#define FSM_BUTTON_DEFAULT_DOUBLE_CLICK_MS 300 /*!< Default maximum time (in ms) between the release of a click and the next press to make a double click.*/
+
+#define FSM_BUTTON_DEFAULT_REPEAT_MS 250 /*!< Default period (in ms) of the hold-repeat gestures after a long press.*/
+
 /* Enums */
 /**
  * @brief Enumeration of button states in the FSM.
@@ -31,6 +41,17 @@ enum FSM_BUTTON_STATES {
     BUTTON_PRESSED_WAIT
 };
 
+/**
+ * @brief Enumeration of the gestures recognized by the button FSM.
+ */
+enum FSM_BUTTON_GESTURES {
+    FSM_BUTTON_GESTURE_NONE = 0,     /*!< No gesture.*/
+    FSM_BUTTON_GESTURE_CLICK,        /*!< Press shorter than a long press, not followed by another press within the double-click time.*/
+    FSM_BUTTON_GESTURE_DOUBLE_CLICK, /*!< Two clicks within the double-click time.*/
+    FSM_BUTTON_GESTURE_LONG_PRESS,   /*!< Press that has lasted the long-press time. It is reported while the button is still pressed.*/
+    FSM_BUTTON_GESTURE_HOLD_REPEAT   /*!< Reported periodically while the button is held after a long press.*/
+};
+
 /* Typedefs --------------------------------------------------------------------*/
 
 /**
@@ -38,6 +59,15 @@ enum FSM_BUTTON_STATES {
  */
 typedef struct fsm_button_t fsm_button_t;
 
+/**
+ * @brief Structure representing a gesture of the button.
+ */
+typedef struct {
+    uint8_t gesture;       /*!< Gesture (see `FSM_BUTTON_GESTURES`).*/
+    uint32_t timestamp_ms; /*!< System time (in ms) at which the gesture was recognized.*/
+    uint32_t duration_ms;  /*!< Time (in ms) the button was pressed: the whole press for clicks (the second press for double clicks), the time held so far for long presses and hold-repeats.*/
+} fsm_button_event_t;
+
 
 /* Function prototypes and explanation -------------------------------------------------*/
 
@@ -117,7 +147,7 @@ void fsm_button_reset_duration (fsm_button_t *p_fsm);
 uint32_t fsm_button_get_debounce_time_ms (fsm_button_t *p_fsm);
 
 /**
- * @brief Checks if the button FSM has detected activity.
+ * @brief Checks if the button FSM has detected activity. A click waiting for the double-click time and the gestures not consumed yet count as activity.
  * 
  * @param p_fsm Pointer to the button FSM instance.
  * 
@@ -125,6 +155,40 @@ uint32_t fsm_button_get_debounce_time_ms (fsm_button_t *p_fsm);
  */
 
 bool fsm_button_check_activity (fsm_button_t *p_fsm);
+/**
+ * @brief Sets the times used to classify the gestures of the button.
+ * 
+ * @param p_fsm Pointer to the button FSM instance.
+ * @param long_press_ms Time a press must last to be a long press, or 0 to report every press as a click.
+ * @param double_click_ms Maximum time between a click and the next press to make a double click, or 0 to report clicks as soon as the button is released.
+ * @param repeat_ms Period of the hold-repeat gestures after a long press, or 0 to disable them.
+ */
+void fsm_button_set_gesture_times (fsm_button_t *p_fsm, uint32_t long_press_ms, uint32_t double_click_ms, uint32_t repeat_ms);
+/**
+ * @brief Gets the oldest gesture of the queue without removing it.
+ * 
+ * @param p_fsm Pointer to the button FSM instance.
+ * 
+ * @return Pointer to the gesture, or NULL if the queue is empty.
+ */
+const fsm_button_event_t * fsm_button_peek_event (fsm_button_t *p_fsm);
+/**
+ * @brief Removes the oldest gesture of the queue.
+ * 
+ * @param p_fsm Pointer to the button FSM instance.
+ * @param p_event Pointer to store the gesture, or NULL to discard it.
+ * 
+ * @return True if a gesture has been removed, false if the queue is empty.
+ */
+bool fsm_button_get_event (fsm_button_t *p_fsm, fsm_button_event_t *p_event);
+
+/**
+ * @brief Starts or stops recording the changes of the state of the FSM in a transition trace. A change is recorded when the FSM is fired.
+ *
+ * @param p_fsm Pointer to the button FSM instance.
+ * @param p_trace Pointer to an initialized trace, or NULL to stop recording.
+ */
+void fsm_button_set_transition_trace (fsm_button_t *p_fsm, transition_trace_t *p_trace);
 
 
 #endif
\ No newline at end of file
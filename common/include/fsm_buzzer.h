@@ -0,0 +1,172 @@
+/**
+ * @file fsm_buzzer.h
+ * @brief Header for fsm_buzzer.c file.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+
+#ifndef FSM_BUZZER_H_
+#define FSM_BUZZER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include "fsm.h"
+#include "transition_trace.h"
+#include "fsm_display.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define FSM_BUZZER_BEEP_MS 100 /*!< Duration (in ms) of each beep when the buzzer is not continuous.*/
+
+#define FSM_BUZZER_DANGER_PERIOD_MS 0 /*!< Beep period (in ms) in the "Danger" range. 0 means continuous tone.*/
+
+#define FSM_BUZZER_WARNING_PERIOD_MS 250 /*!< Beep period (in ms) in the "Warning" range.*/
+
+#define FSM_BUZZER_NO_PROBLEM_PERIOD_MS 500 /*!< Beep period (in ms) in the "No Problem" range.*/
+
+#define FSM_BUZZER_INFO_PERIOD_MS 1000 /*!< Beep period (in ms) in the "Info" range.*/
+
+#define FSM_BUZZER_NO_DISTANCE UINT32_MAX /*!< Distance reported before the buzzer has been given one. Out of every band, so the buzzer stays silent.*/
+
+/**
+ * @brief Enum representing the states of the buzzer FSM.
+ */
+
+enum FSM_BUZZER {
+    WAIT_BUZZER = 0,
+    SET_BUZZER
+  };
+
+/* Typedefs --------------------------------------------------------------------*/
+
+/**
+ * @brief Opaque structure representing the FSM for the buzzer.
+ */
+
+typedef struct fsm_buzzer_t fsm_buzzer_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Creates a new FSM instance for the buzzer.
+ *
+ * @param buzzer_id The ID of the buzzer to associate with the FSM.
+ * @return Pointer to the newly created FSM instance.
+ */
+
+fsm_buzzer_t * fsm_buzzer_new(uint32_t buzzer_id);
+
+/**
+ * @brief Destroys an FSM instance and frees its resources.
+ *
+ * @param p_fsm Pointer to the FSM instance to destroy.
+ */
+
+void fsm_buzzer_destroy(fsm_buzzer_t *p_fsm);
+
+/**
+ * @brief Gets the last distance in centimeters.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ *
+ * @return The last distance in centimeters, or `FSM_BUZZER_NO_DISTANCE` if none has been set yet.
+ */
+
+uint32_t fsm_buzzer_get_distance(fsm_buzzer_t *p_fsm);
+
+/**
+ * @brief Sets the distance (in cm) that determines the beep repetition rate.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param distance_cm The distance in centimeters.
+ */
+
+void fsm_buzzer_set_distance(fsm_buzzer_t *p_fsm, uint32_t distance_cm);
+
+/**
+ * @brief Triggers the FSM to process its current state and transition if necessary.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ */
+
+void fsm_buzzer_fire(fsm_buzzer_t *p_fsm);
+
+/**
+ * @brief Gets the current status of the FSM (active or paused).
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ *
+ * @return `true` if the FSM is active, `false` if it is paused.
+ */
+
+bool fsm_buzzer_get_status(fsm_buzzer_t *p_fsm);
+
+/**
+ * @brief Sets the status of the FSM (active or paused).
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param status `true` to activate the FSM, `false` to pause it.
+ */
+
+void fsm_buzzer_set_status(fsm_buzzer_t *p_fsm, bool status);
+
+/**
+ * @brief Checks if the FSM has pending work. The cadence is kept by the hardware, so the buzzer is idle while beeping.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ *
+ * @return `true` if the FSM is active, `false` otherwise.
+ */
+
+bool fsm_buzzer_check_activity(fsm_buzzer_t *p_fsm);
+
+/**
+ * @brief Retrieves the inner FSM structure.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ *
+ * @return Pointer to the inner FSM structure.
+ */
+
+fsm_t * fsm_buzzer_get_inner_fsm(fsm_buzzer_t *p_fsm);
+
+/**
+ * @brief Retrieves the current state of the FSM.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ *
+ * @return Current state.
+ */
+
+uint32_t fsm_buzzer_get_state(fsm_buzzer_t *p_fsm);
+
+/**
+ * @brief Sets the current state of the FSM.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param state The state to set.
+ */
+
+void fsm_buzzer_set_state(fsm_buzzer_t *p_fsm, int8_t state);
+
+/**
+ * @brief Starts or stops recording the changes of the state of the FSM in a transition trace. A change is recorded when the FSM is fired.
+ *
+ * @param p_fsm Pointer to the buzzer FSM instance.
+ * @param p_trace Pointer to an initialized trace, or NULL to stop recording.
+ */
+
+void fsm_buzzer_set_transition_trace(fsm_buzzer_t *p_fsm, transition_trace_t *p_trace);
+
+/**
+ * @brief Sets the display whose band table gives the beep period of the distances, so that the buzzer follows the bands loaded at runtime. The new bands are applied with the next distance.
+ *
+ * @param p_fsm Pointer to the buzzer FSM instance.
+ * @param p_display Pointer to the display FSM, or NULL to use the default band table.
+ */
+
+void fsm_buzzer_set_display(fsm_buzzer_t *p_fsm, fsm_display_t *p_display);
+
+#endif /* FSM_BUZZER_H_ */
@@ -14,7 +14,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "fsm.h"
+#include "port_display.h"
+#include "latency_probe.h"
+#include "transition_trace.h"
 /* Defines and enums ----------------------------------------------------------*/
+/* The thresholds below are the limits of the default band table. They can be changed at runtime with fsm_display_load_bands() */
 #define DANGER_MIN_CM 0 /*!< inimum distance (in cm) for the "Danger" state.*/
 
 #define WARNING_MIN_CM 25 /*!< Minimum distance (in cm) for the "Warning" state.*/
@@ -26,8 +30,26 @@
 #define OK_MIN_CM 175 /*!< Minimum distance (in cm) for the "OK" state.*/
  
 #define OK_MAX_CM 200 /*!< Maximum distance (in cm) for the "OK" state.*/
+
+#define FSM_DISPLAY_MAX_BANDS 8 /*!< Maximum number of bands of the band table of a display.*/
+
+#define FSM_DISPLAY_BEEP_SILENT 0xFFFF /*!< Beep period of a band in which the buzzer is silent.*/
+
+#define FSM_DISPLAY_DEFAULT_MAX_FPS 25 /*!< Default maximum frame rate (in frames per second) of a display. Faster distances are coalesced and only the latest one is shown.*/
 /* Enums */
 
+/**
+ * @brief Enum representing the urgency of a distance band.
+ */
+
+enum FSM_DISPLAY_URGENCY {
+    FSM_DISPLAY_URGENCY_NONE = 0, /*!< Out of range: nothing to show.*/
+    FSM_DISPLAY_URGENCY_LOW,      /*!< Far obstacle.*/
+    FSM_DISPLAY_URGENCY_MEDIUM,   /*!< Approaching obstacle.*/
+    FSM_DISPLAY_URGENCY_HIGH,     /*!< Close obstacle.*/
+    FSM_DISPLAY_URGENCY_DANGER    /*!< Imminent collision: it must be shown even if the display is paused.*/
+  };
+
 /* Defines and enums ----------------------------------------------------------*/
 
 /**
@@ -47,6 +69,17 @@ enum  FSM_DISPLAY_SYSTEM {
 
 typedef struct fsm_display_t fsm_display_t;
 
+/**
+ * @brief Structure representing a band of the band table of a display. A band covers the distances greater than the `max_cm` of the previous band (or from `DANGER_MIN_CM` for the first one) up to its own `max_cm`, both included.
+ */
+
+typedef struct {
+    uint16_t max_cm;     /*!< Upper limit (in cm) of the band.*/
+    rgb_color_t color;   /*!< Color shown in the band.*/
+    uint8_t urgency;     /*!< Urgency of the band (see `FSM_DISPLAY_URGENCY`).*/
+    uint16_t beep_period_ms; /*!< Beep period (in ms) of the buzzer in the band. 0 means continuous tone and `FSM_DISPLAY_BEEP_SILENT` means silent.*/
+} fsm_display_band_t;
+
 /* Function prototypes and explanation -------------------------------------------------*/
 
 /**
@@ -113,7 +146,7 @@ bool fsm_display_get_status(fsm_display_t *p_fsm);
 void fsm_display_set_status(fsm_display_t *p_fsm, bool pause);
  
 /**
- * @brief Checks if the FSM is currently active.
+ * @brief Checks if the FSM is currently active. A display that is switched off is never active. A distance that can be shown counts as activity, whereas one that is held back until the next frame does not (see `fsm_display_check_pending_frame()`).
  * 
  * @param p_fsm Pointer to the FSM instance.
  * 
@@ -122,6 +155,16 @@ void fsm_display_set_status(fsm_display_t *p_fsm, bool pause);
 
 bool fsm_display_check_activity(fsm_display_t *p_fsm);
 
+/**
+ * @brief Checks if a distance is held back by the maximum frame rate until the next frame. The system may sleep meanwhile, but it must wake up by itself to show it, since no interrupt may come.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ *
+ * @return `true` if a distance is waiting for the next frame, `false` otherwise.
+ */
+
+bool fsm_display_check_pending_frame(fsm_display_t *p_fsm);
+
 /**
  * @brief Retrieves the inner FSM structure for advanced control.
  * 
@@ -151,4 +194,115 @@ uint32_t fsm_display_get_state(fsm_display_t *p_fsm);
 
 void fsm_display_set_state(fsm_display_t *p_fsm, int8_t state);
 
+/**
+ * @brief Loads the band table of the display. The table is copied, so it does not need to outlive the call. The new bands are applied with the next distance.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param p_bands Pointer to the bands, sorted by strictly increasing `max_cm`.
+ * @param num_bands Number of bands, from 1 to `FSM_DISPLAY_MAX_BANDS`.
+ *
+ * @return `true` if the table has been loaded, `false` if it is not valid (the previous table is kept).
+ */
+
+bool fsm_display_load_bands(fsm_display_t *p_fsm, const fsm_display_band_t *p_bands, uint32_t num_bands);
+
+/**
+ * @brief Restores the default band table of the display, built from `DANGER_MIN_CM` ... `OK_MAX_CM`.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ */
+
+void fsm_display_load_default_bands(fsm_display_t *p_fsm);
+
+/**
+ * @brief Copies the band table of the display, e.g., to change some of its bands and load it again.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param p_bands Pointer to the copy of the bands.
+ * @param max_bands Number of bands that fit in the copy.
+ *
+ * @return uint32_t Number of bands copied.
+ */
+uint32_t fsm_display_get_bands(fsm_display_t *p_fsm, fsm_display_band_t *p_bands, uint32_t max_bands);
+
+/**
+ * @brief Gets the band of the band table that contains a distance. The band is found with a binary search.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param distance_cm The distance in centimeters.
+ *
+ * @return Pointer to the band, or NULL if the distance is out of the range of the table.
+ */
+
+const fsm_display_band_t * fsm_display_get_band(fsm_display_t *p_fsm, int32_t distance_cm);
+
+/**
+ * @brief Computes the RGB color levels and the fill level of the display based on the distance, with the band table of the display.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param pcolor Pointer to the RGB color structure to update. It is off if the distance is out of the range of the band table.
+ * @param distance_cm The distance in centimeters.
+ *
+ * @return The fill level, from 0 to `PORT_DISPLAY_RGB_MAX_VALUE`.
+ */
+
+uint8_t _compute_display_levels(fsm_display_t *p_fsm, rgb_color_t *pcolor, int32_t distance_cm);
+
+/**
+ * @brief Gets the urgency of a distance according to the band table of the display.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param distance_cm The distance in centimeters.
+ *
+ * @return The urgency of the band that contains the distance, or `FSM_DISPLAY_URGENCY_NONE` if it is out of range.
+ */
+
+uint8_t fsm_display_get_urgency(fsm_display_t *p_fsm, int32_t distance_cm);
+
+/**
+ * @brief Gets the band of the default band table that contains a distance, e.g., for an output that is not attached to a display.
+ *
+ * @param distance_cm The distance in centimeters.
+ *
+ * @return Pointer to the default band, or NULL if the distance is out of range.
+ */
+
+const fsm_display_band_t * fsm_display_get_default_band(int32_t distance_cm);
+
+/**
+ * @brief Sets the maximum frame rate of the display. Distances can be set at any rate, but a new frame is shown only once the frame period has elapsed since the previous one, with the latest distance. Distances in a band of urgency `FSM_DISPLAY_URGENCY_DANGER` are shown at once.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param max_fps Maximum number of frames per second, or 0 to show every distance at once.
+ */
+
+void fsm_display_set_max_frame_rate(fsm_display_t *p_fsm, uint32_t max_fps);
+
+/**
+ * @brief Sets the time of the echo of the last distance set. When the color of that distance is applied, the time since the echo is recorded in the latency probe (if any). The probe pin is lowered when the color is applied or the frame is dropped, with or without a latency probe.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param echo_time_us Time of the falling edge of the echo, in the time base of `port_system_get_micros()`.
+ */
+
+void fsm_display_set_distance_time_us(fsm_display_t *p_fsm, uint32_t echo_time_us);
+
+/**
+ * @brief Sets the histogram where the latencies from the echo to the color applied are recorded.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param p_probe Pointer to the histogram, or NULL to stop measuring.
+ */
+
+void fsm_display_set_latency_probe(fsm_display_t *p_fsm, latency_probe_t *p_probe);
+
+/**
+ * @brief Starts or stops recording the changes of the state of the FSM in a transition trace. A change is recorded when the FSM is fired.
+ *
+ * @param p_fsm Pointer to the display FSM instance.
+ * @param p_trace Pointer to an initialized trace, or NULL to stop recording.
+ */
+
+void fsm_display_set_transition_trace(fsm_display_t *p_fsm, transition_trace_t *p_trace);
+
 #endif /* FSM_DISPLAY_SYSTEM_H_ */
\ No newline at end of file
@@ -14,9 +14,16 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "fsm.h"
+#include "echo_trace.h"
+#include "distance_history.h"
+#include "ranging_stats.h"
+#include "transition_trace.h"
 
 /* Defines and enums ----------------------------------------------------------*/
-#define FSM_ULTRASOUND_NUM_MEASUREMENTS  5 /*!< Number of measurements to average */
+#define FSM_ULTRASOUND_NUM_MEASUREMENTS  5 /*!< Number of measurements to average (the largest number that can be set at runtime) */
+#define FSM_ULTRASOUND_TEMPERATURE_PERIOD_PINGS 50 /*!< Number of pings between two readings of the temperature of the air (5 s at the default period) */
+#define FSM_ULTRASOUND_DEFAULT_TEMPERATURE_DC 200 /*!< Temperature of the air assumed until it is read, in tenths of ºC (the speed of sound is then `SPEED_OF_SOUND_MS`) */
+#define FSM_ULTRASOUND_MAX_ECHOES 4 /*!< Largest number of echoes of a ping that can be captured (`PORT_ULTRASOUND_MAX_ECHOES`) */
 
 /**
  * @brief States of the ultrasound FSM.
@@ -59,6 +66,22 @@ void fsm_ultrasound_destroy (fsm_ultrasound_t *p_fsm);
  */
 uint32_t fsm_ultrasound_get_distance (fsm_ultrasound_t *p_fsm);
 
+/**
+ * @brief Retrieves the last distance measured without consuming it, so that an observer (e.g., the telemetry) does not hide a new measurement from the Urbanite FSM.
+ * 
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @return Distance in cm.
+ */
+uint32_t fsm_ultrasound_get_last_distance (fsm_ultrasound_t *p_fsm);
+
+/**
+ * @brief Retrieves the time of the falling edge of the last echo of the distance measured, to follow the distance through the system.
+ * 
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @return Time of the edge in microseconds, in the time base of `port_system_get_micros()`.
+ */
+uint32_t fsm_ultrasound_get_distance_time_us (fsm_ultrasound_t *p_fsm);
+
 /**
  * @brief Fires the ultrasound FSM.
  * 
@@ -140,6 +163,115 @@ uint32_t fsm_ultrasound_get_state (fsm_ultrasound_t *p_fsm);
  */
 bool fsm_ultrasound_check_activity (fsm_ultrasound_t *p_fsm);
 
+/**
+ * @brief Starts or stops tracing the raw timings of the echoes. Each echo is added to the trace before it is filtered.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param p_trace Pointer to an initialized trace, or NULL to stop tracing.
+ */
+void fsm_ultrasound_set_trace (fsm_ultrasound_t *p_fsm, echo_trace_t *p_trace);
+
+/**
+ * @brief Starts or stops keeping the history of the distances. Each filtered distance is added to the history with the time at which it is measured.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param p_history Pointer to an initialized history, or NULL to stop keeping it.
+ */
+void fsm_ultrasound_set_history (fsm_ultrasound_t *p_fsm, distance_history_t *p_history);
+
+/**
+ * @brief Starts or stops keeping the statistics of the pings. Each echo is added to the statistics as it is measured, before the filter.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param p_stats Pointer to initialized statistics, or NULL to stop keeping them.
+ */
+void fsm_ultrasound_set_stats (fsm_ultrasound_t *p_fsm, ranging_stats_t *p_stats);
+
+/**
+ * @brief Starts or stops recording the changes of the state of the FSM in a transition trace. A change is recorded when the FSM is fired.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param p_trace Pointer to an initialized trace, or NULL to stop recording.
+ */
+void fsm_ultrasound_set_transition_trace (fsm_ultrasound_t *p_fsm, transition_trace_t *p_trace);
+
+/**
+ * @brief Takes a snapshot of the statistics of the pings, in constant time.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param p_snapshot Pointer to the snapshot.
+ * @return true if the statistics are kept, false otherwise.
+ */
+bool fsm_ultrasound_get_stats (fsm_ultrasound_t *p_fsm, ranging_stats_snapshot_t *p_snapshot);
+
+/**
+ * @brief Sets the number of measurements whose median gives a distance. The measurements taken for the next distance are discarded.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param num_measurements Number of measurements, from 1 to `FSM_ULTRASOUND_NUM_MEASUREMENTS` (the default).
+ * @return true if the number has been set, false if it is out of range.
+ */
+bool fsm_ultrasound_set_num_measurements (fsm_ultrasound_t *p_fsm, uint32_t num_measurements);
+
+/**
+ * @brief Gets the number of measurements whose median gives a distance.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @return uint32_t Number of measurements.
+ */
+uint32_t fsm_ultrasound_get_num_measurements (fsm_ultrasound_t *p_fsm);
+
+/**
+ * @brief Sets the temperature of the air, which gives the speed of sound used to convert the echoes into distances. The FSM sets it itself from the readings of the temperature sensor, at a low rate, so it only needs to be called to impose a temperature.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param temperature_dc Temperature, in tenths of ºC.
+ */
+void fsm_ultrasound_set_temperature (fsm_ultrasound_t *p_fsm, int32_t temperature_dc);
+
+/**
+ * @brief Gets the temperature of the air used to convert the echoes into distances.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @return int32_t Temperature, in tenths of ºC.
+ */
+int32_t fsm_ultrasound_get_temperature (fsm_ultrasound_t *p_fsm);
+
+/**
+ * @brief Sets the number of echoes captured in each ping, from the next ping. With more than one, the ping lasts until they have arrived or the window of the echoes is over, and the distances of all of them are kept. The median distance is always that of the first echo.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param max_echoes Number of echoes, from 1 (the default) to `FSM_ULTRASOUND_MAX_ECHOES`.
+ * @return true if the number has been set, false if it is out of range.
+ */
+bool fsm_ultrasound_set_max_echoes (fsm_ultrasound_t *p_fsm, uint32_t max_echoes);
+
+/**
+ * @brief Gets the number of echoes captured in each ping.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @return uint32_t Number of echoes.
+ */
+uint32_t fsm_ultrasound_get_max_echoes (fsm_ultrasound_t *p_fsm);
+
+/**
+ * @brief Gets the distances of the echoes of the last ping, from the nearest one.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param p_distances_cm Pointer to the array where the distances are copied, in cm.
+ * @param max_distances Size of the array.
+ * @return uint32_t Number of distances copied.
+ */
+uint32_t fsm_ultrasound_get_echoes (fsm_ultrasound_t *p_fsm, uint32_t *p_distances_cm, uint32_t max_distances);
+
+/**
+ * @brief Gets the distance up to which the echoes of a ping are captured when more than one is listened to: the window of the echoes at the speed of sound of the current temperature.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @return uint32_t Distance in cm.
+ */
+uint32_t fsm_ultrasound_get_echo_range (fsm_ultrasound_t *p_fsm);
+
 
 
 /**
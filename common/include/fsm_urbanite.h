@@ -12,6 +12,10 @@
 #include "fsm_button.h"
 #include "fsm_display.h"
 #include "fsm_ultrasound.h"
+#include "fsm_buzzer.h"
+#include "power_stats.h"
+#include "flash_log.h"
+#include "transition_trace.h"
 
 
 /* Defines and enums ----------------------------------------------------------*/
@@ -27,6 +31,32 @@ enum FSM_URBANITE {
     SLEEP_WHILE_ON
   };
 
+/**
+ * @brief Types of the records of the Urbanite FSM in a flash log. The payload of both is a `fsm_urbanite_log_record_t`.
+ */
+enum FSM_URBANITE_LOG_TYPES {
+    FSM_URBANITE_LOG_DISTANCE = 1, /*!< Distance measured while on. The value is the distance in cm. */
+    FSM_URBANITE_LOG_EVENT,        /*!< Command of the user. The value is one of `FSM_URBANITE_LOG_EVENTS`. */
+};
+
+/**
+ * @brief Events of the Urbanite FSM in a flash log.
+ */
+enum FSM_URBANITE_LOG_EVENTS {
+    FSM_URBANITE_EVENT_ON = 0, /*!< The system has been turned on. */
+    FSM_URBANITE_EVENT_OFF,    /*!< The system has been turned off. */
+    FSM_URBANITE_EVENT_PAUSE,  /*!< The display has been paused. */
+    FSM_URBANITE_EVENT_RESUME, /*!< The display has been resumed. */
+};
+
+/**
+ * @brief Payload of the records of the Urbanite FSM in a flash log.
+ */
+typedef struct {
+    uint32_t timestamp_ms; /*!< System time (in ms) of the record. */
+    uint32_t value;        /*!< Distance in cm or event, depending on the type of the record. */
+} fsm_urbanite_log_record_t;
+
   
 /**
  * @brief Structure of the Urbanite FSM.
@@ -38,14 +68,15 @@ typedef struct fsm_urbanite_t fsm_urbanite_t;
  * @brief Creates a new Urbanite FSM instance.
  * 
  * @param p_fsm_button Pointer to the button FSM.
- * @param on_off_press_time_ms Time in milliseconds to toggle the system on/off.
- * @param pause_display_time_ms Time in milliseconds to pause/resume the display.
+ * @param on_off_press_time_ms Time in milliseconds to toggle the system on/off. It is used as the long-press time of the button.
+ * @param pause_display_time_ms Time in milliseconds to pause/resume the display. Shorter clicks are ignored.
  * @param p_fsm_ultrasound_rear Pointer to the rear ultrasound FSM.
  * @param p_fsm_display_rear Pointer to the rear display FSM.
+ * @param p_fsm_buzzer_rear Pointer to the rear buzzer FSM.
  *
  * @return Pointer to the newly created Urbanite FSM instance.
  */
-fsm_urbanite_t * fsm_urbanite_new (fsm_button_t *p_fsm_button, uint32_t on_off_press_time_ms, uint32_t pause_display_time_ms, fsm_ultrasound_t *p_fsm_ultrasound_rear, fsm_display_t *p_fsm_display_rear);
+fsm_urbanite_t * fsm_urbanite_new (fsm_button_t *p_fsm_button, uint32_t on_off_press_time_ms, uint32_t pause_display_time_ms, fsm_ultrasound_t *p_fsm_ultrasound_rear, fsm_display_t *p_fsm_display_rear, fsm_buzzer_t *p_fsm_buzzer_rear);
 
 
 /**
@@ -56,6 +87,89 @@ fsm_urbanite_t * fsm_urbanite_new (fsm_button_t *p_fsm_button, uint32_t on_off_p
 void fsm_urbanite_fire (fsm_urbanite_t *p_fsm);
 
 
+/**
+ * @brief Accounts the time and the energy spent in each state and power mode of the Urbanite FSM.
+ *
+ * The accounting is initialized with the current state and updated on every change of state and every sleep.
+ *
+ * @param p_fsm Pointer to the Urbanite FSM instance.
+ * @param p_power_stats Pointer to the power accounting, or NULL to stop accounting.
+ */
+void fsm_urbanite_set_power_stats (fsm_urbanite_t *p_fsm, power_stats_t *p_power_stats);
+
+
+/**
+ * @brief Keeps the distances measured and the commands of the user in a flash log, so that they survive power cycles.
+ * The records are programmed in batches when the system goes to sleep with half a batch pending, and when the system is turned off.
+ * @param p_fsm Pointer to the Urbanite FSM instance.
+ * @param p_flash_log Pointer to the initialized flash log, or NULL to stop logging.
+ */
+void fsm_urbanite_set_flash_log (fsm_urbanite_t *p_fsm, flash_log_t *p_flash_log);
+
+/**
+ * @brief Starts or stops recording the changes of the state of the Urbanite FSM in a transition trace.
+ * A change to a sleep state is recorded before the system sleeps, so the time of the record is that of the transition.
+ * @param p_fsm Pointer to the Urbanite FSM instance.
+ * @param p_trace Pointer to an initialized trace, or NULL to stop recording.
+ */
+void fsm_urbanite_set_transition_trace (fsm_urbanite_t *p_fsm, transition_trace_t *p_trace);
+
+
+/**
+ * @brief Retrieves the state of the Urbanite FSM.
+ * 
+ * @param p_fsm Pointer to the Urbanite FSM instance.
+ * @return uint32_t State of the Urbanite FSM.
+ */
+uint32_t fsm_urbanite_get_state (fsm_urbanite_t *p_fsm);
+
+
+/**
+ * @brief Changes the times of the commands of the button. The gesture being classified keeps the old long-press time.
+ * 
+ * @param p_fsm Pointer to the Urbanite FSM instance.
+ * @param on_off_press_time_ms Time in milliseconds to toggle the system on/off. It is used as the long-press time of the button.
+ * @param pause_display_time_ms Time in milliseconds to pause/resume the display. Shorter clicks are ignored.
+ */
+void fsm_urbanite_set_press_times (fsm_urbanite_t *p_fsm, uint32_t on_off_press_time_ms, uint32_t pause_display_time_ms);
+
+
+/**
+ * @brief Retrieves the time to toggle the system on/off.
+ * 
+ * @param p_fsm Pointer to the Urbanite FSM instance.
+ * @return uint32_t Time in milliseconds.
+ */
+uint32_t fsm_urbanite_get_on_off_press_time_ms (fsm_urbanite_t *p_fsm);
+
+
+/**
+ * @brief Retrieves the time to pause/resume the display.
+ * 
+ * @param p_fsm Pointer to the Urbanite FSM instance.
+ * @return uint32_t Time in milliseconds.
+ */
+uint32_t fsm_urbanite_get_pause_display_time_ms (fsm_urbanite_t *p_fsm);
+
+
+/**
+ * @brief Sets the distance below which the echoes of the rear sensor are not obstacles, such as those of the tow bar or the bumper of the car. When the distance measured is below it, the nearest echo of the last ping beyond it is displayed instead, so the rear sensor must capture several echoes per ping (see `fsm_ultrasound_set_max_echoes()`).
+ * 
+ * @param p_fsm Pointer to the Urbanite FSM instance.
+ * @param min_obstacle_cm Distance in cm, or 0 (the default) to take all the echoes.
+ */
+void fsm_urbanite_set_min_obstacle_distance (fsm_urbanite_t *p_fsm, uint32_t min_obstacle_cm);
+
+
+/**
+ * @brief Retrieves the distance below which the echoes of the rear sensor are not obstacles.
+ * 
+ * @param p_fsm Pointer to the Urbanite FSM instance.
+ * @return uint32_t Distance in cm.
+ */
+uint32_t fsm_urbanite_get_min_obstacle_distance (fsm_urbanite_t *p_fsm);
+
+
 
 /**
  * @brief Destroys the Urbanite FSM instance and frees its resources.
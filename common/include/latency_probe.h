@@ -0,0 +1,74 @@
+/**
+ * @file latency_probe.h
+ * @brief Header for latency_probe.c file.
+ *
+ * Histogram of the latencies of a path of the system, with the minimum, the maximum and any percentile. The buckets are linear up to `LATENCY_PROBE_LINEAR_US` and then split every power of two into `LATENCY_PROBE_SUB_BUCKETS` buckets, so a percentile is given with an error below 1/`LATENCY_PROBE_SUB_BUCKETS` in constant memory and constant time per sample.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef LATENCY_PROBE_H_
+#define LATENCY_PROBE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define LATENCY_PROBE_SUB_BUCKET_BITS 3                                   /*!< Logarithm in base 2 of the number of buckets of each power of two */
+#define LATENCY_PROBE_SUB_BUCKETS (1U << LATENCY_PROBE_SUB_BUCKET_BITS)   /*!< Number of buckets of each power of two */
+#define LATENCY_PROBE_LINEAR_US (2U * LATENCY_PROBE_SUB_BUCKETS)          /*!< Latencies below this value have a bucket of 1 us each */
+#define LATENCY_PROBE_MAX_BITS 24                                         /*!< Latencies of `2^LATENCY_PROBE_MAX_BITS` us (16.7 s) or more go to the last bucket */
+#define LATENCY_PROBE_NUM_BUCKETS (LATENCY_PROBE_LINEAR_US + (LATENCY_PROBE_MAX_BITS - LATENCY_PROBE_SUB_BUCKET_BITS - 1) * LATENCY_PROBE_SUB_BUCKETS) /*!< Number of buckets of the histogram */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the histogram of the latencies of a path.
+ */
+typedef struct
+{
+    uint32_t buckets[LATENCY_PROBE_NUM_BUCKETS]; /*!< Number of latencies of each bucket */
+    uint32_t count;                              /*!< Number of latencies recorded */
+    uint32_t min_us;                             /*!< Minimum latency, in us */
+    uint32_t max_us;                             /*!< Maximum latency, in us */
+    uint32_t last_us;                            /*!< Last latency, in us */
+    uint64_t sum_us;                             /*!< Sum of the latencies, in us */
+} latency_probe_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Empties the histogram.
+ *
+ * @param p_probe Pointer to the histogram.
+ */
+void latency_probe_init(latency_probe_t *p_probe);
+
+/**
+ * @brief Records a latency.
+ *
+ * @param p_probe Pointer to the histogram.
+ * @param latency_us Latency, in us.
+ */
+void latency_probe_record(latency_probe_t *p_probe, uint32_t latency_us);
+
+/**
+ * @brief Returns a percentile of the latencies recorded.
+ *
+ * @param p_probe Pointer to the histogram.
+ * @param permille Percentile, in per mille (500 for the median, 990 for the 99th percentile).
+ *
+ * @return uint32_t Upper limit of the bucket of the percentile, within the minimum and the maximum latencies, in us (0 if no latency has been recorded).
+ */
+uint32_t latency_probe_get_percentile_us(latency_probe_t *p_probe, uint32_t permille);
+
+/**
+ * @brief Prints the number of latencies recorded, and their minimum, median, 99th percentile, maximum and mean.
+ *
+ * @param p_probe Pointer to the histogram.
+ * @param p_name Name of the path.
+ */
+void latency_probe_print(latency_probe_t *p_probe, const char *p_name);
+
+#endif /* LATENCY_PROBE_H_ */
@@ -0,0 +1,173 @@
+/**
+ * @file power_stats.h
+ * @brief Header for power_stats.c file.
+ *
+ * Accounting of the time and the energy that the system spends in each power mode for each state of an FSM. The caller timestamps every change of state and every entry and exit of a low-power mode with the power clock of the port, which keeps counting while the system sleeps. The structure lives in RAM and can be read with a debugger, or printed with `power_stats_print()` (through semihosting on the target).
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef POWER_STATS_H_
+#define POWER_STATS_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define POWER_STATS_MAGIC 0x52575050U /*!< Magic number of an initialized structure ("PPWR"), so that a debugger can find it in RAM */
+#define POWER_STATS_MAX_STATES 8      /*!< Maximum number of states accounted. Higher states are accounted as the last one */
+
+#define POWER_STATS_DEFAULT_RUN_UA 6000   /*!< Default current in run mode, in uA (STM32F446 running from the 16 MHz HSI, with the peripherals of the Urbanite) */
+#define POWER_STATS_DEFAULT_SLEEP_UA 2500 /*!< Default current in sleep mode, in uA (same clock, with the timers of the Urbanite running) */
+#define POWER_STATS_DEFAULT_STOP_UA 300   /*!< Default current in stop mode, in uA */
+#define POWER_STATS_DEFAULT_VOLTAGE_MV 3300 /*!< Default supply voltage, in mV */
+
+/* Enums */
+/**
+ * @brief Power modes of the system.
+ */
+enum POWER_STATS_MODES
+{
+    POWER_STATS_MODE_RUN = 0, /*!< The CPU is running */
+    POWER_STATS_MODE_SLEEP,   /*!< The CPU waits for an interrupt with the peripherals running (`port_system_sleep()`) */
+    POWER_STATS_MODE_STOP,    /*!< The clocks are stopped (`port_system_power_stop()`) */
+    POWER_STATS_NUM_MODES
+};
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the accounting of the power modes of an FSM.
+ */
+typedef struct
+{
+    uint32_t magic;                                                       /*!< `POWER_STATS_MAGIC` once initialized */
+    uint32_t voltage_mv;                                                  /*!< Supply voltage, in mV */
+    uint32_t current_ua[POWER_STATS_NUM_MODES];                           /*!< Current of each power mode, in uA */
+    uint64_t residency_us[POWER_STATS_MAX_STATES][POWER_STATS_NUM_MODES]; /*!< Time spent in each state and power mode, in us */
+    uint32_t num_entries[POWER_STATS_MAX_STATES][POWER_STATS_NUM_MODES];  /*!< Number of entries in each state and power mode */
+    uint32_t num_state_changes;                                           /*!< Number of changes of state */
+    uint64_t start_us;                                                    /*!< Time of the power clock when the accounting started */
+    uint64_t last_us;                                                     /*!< Time of the power clock of the last event accounted */
+    uint8_t state;                                                        /*!< Current state */
+    uint8_t mode;                                                         /*!< Current power mode (see `POWER_STATS_MODES`) */
+} power_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initializes the accounting with the default current table, in run mode.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param state Current state of the FSM.
+ * @param now_us Current time of the power clock.
+ */
+void power_stats_init(power_stats_t *p_stats, uint8_t state, uint64_t now_us);
+
+/**
+ * @brief Sets the current of each power mode and the supply voltage used to estimate the energy.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param p_current_ua Current of each power mode, in uA (`POWER_STATS_NUM_MODES` values).
+ * @param voltage_mv Supply voltage, in mV.
+ */
+void power_stats_set_current_table(power_stats_t *p_stats, const uint32_t *p_current_ua, uint32_t voltage_mv);
+
+/**
+ * @brief Accounts a change of state. The time since the last event is accounted to the previous state.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param state New state. Nothing changes if it is the current one.
+ * @param now_us Current time of the power clock.
+ */
+void power_stats_set_state(power_stats_t *p_stats, uint8_t state, uint64_t now_us);
+
+/**
+ * @brief Accounts a change of power mode. The time since the last event is accounted to the previous mode.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param mode New power mode (see `POWER_STATS_MODES`). Nothing changes if it is the current one.
+ * @param now_us Current time of the power clock.
+ */
+void power_stats_set_mode(power_stats_t *p_stats, uint8_t mode, uint64_t now_us);
+
+/**
+ * @brief Accounts the time since the last event to the current state and power mode, so that the results are up to date.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param now_us Current time of the power clock.
+ */
+void power_stats_update(power_stats_t *p_stats, uint64_t now_us);
+
+/**
+ * @brief Puts the system to sleep with `port_system_sleep()` and accounts the time asleep in `POWER_STATS_MODE_SLEEP`.
+ *
+ * @param p_stats Pointer to the accounting, or NULL to sleep without accounting.
+ */
+void power_stats_sleep(power_stats_t *p_stats);
+
+/**
+ * @brief Puts the system to sleep with `port_system_power_sleep()`, with the SysTick running so that its next tick wakes the system up within 1 ms, and accounts the time asleep in `POWER_STATS_MODE_SLEEP`. It lets the system sleep while it waits for a time instead of an interrupt.
+ *
+ * @param p_stats Pointer to the accounting, or NULL to sleep without accounting.
+ */
+void power_stats_sleep_tick(power_stats_t *p_stats);
+
+/**
+ * @brief Stops the system with `port_system_power_stop()` and accounts the time stopped in `POWER_STATS_MODE_STOP`.
+ *
+ * @param p_stats Pointer to the accounting, or NULL to stop without accounting.
+ */
+void power_stats_stop(power_stats_t *p_stats);
+
+/**
+ * @brief Returns the time spent in a state and power mode.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param state State.
+ * @param mode Power mode (see `POWER_STATS_MODES`).
+ *
+ * @return uint64_t Time in us, up to the last event accounted.
+ */
+uint64_t power_stats_get_residency_us(power_stats_t *p_stats, uint8_t state, uint8_t mode);
+
+/**
+ * @brief Returns the CPU load: the fraction of the time spent in run mode.
+ *
+ * @param p_stats Pointer to the accounting.
+ *
+ * @return uint32_t CPU load in per mille, up to the last event accounted (0 if no time has been accounted).
+ */
+uint32_t power_stats_get_cpu_load_permille(power_stats_t *p_stats);
+
+/**
+ * @brief Returns the energy estimated for a state, from the time spent in each power mode and the current table.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param state State.
+ *
+ * @return uint64_t Energy in uJ, up to the last event accounted.
+ */
+uint64_t power_stats_get_energy_uj(power_stats_t *p_stats, uint8_t state);
+
+/**
+ * @brief Returns the energy estimated for all the states.
+ *
+ * @param p_stats Pointer to the accounting.
+ *
+ * @return uint64_t Energy in uJ, up to the last event accounted.
+ */
+uint64_t power_stats_get_total_energy_uj(power_stats_t *p_stats);
+
+/**
+ * @brief Prints the residency and the energy of every state and power mode, and the CPU load.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param p_state_names Names of the states, or NULL to print their numbers.
+ * @param num_states Number of states to print.
+ */
+void power_stats_print(power_stats_t *p_stats, const char *const *p_state_names, uint8_t num_states);
+
+#endif /* POWER_STATS_H_ */
@@ -0,0 +1,111 @@
+/**
+ * @file ranging_stats.h
+ * @brief Header for ranging_stats.c file.
+ *
+ * Running statistics of the pings of an ultrasound sensor, to tell a degraded sensor from a healthy one and to tune the ping rate from field data. Every ping is classified as a timeout (the sensor gave up waiting for an echo), out of range (an echo beyond the range of the sensor) or a sample. The samples update the minimum, the maximum, and the mean and the variance of the distance with Welford's algorithm in Q16.16 fixed point. The times of the pings update the ping period and its jitter with the smoothed estimators of RFC 3550 (gain 1/16). Each update and each snapshot take constant time, with no floating point and no division in the update but the one of Welford's mean.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef RANGING_STATS_H_
+#define RANGING_STATS_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define RANGING_STATS_MIN_RANGE_CM 2       /*!< Shortest distance that the sensor measures (HC-SR04) */
+#define RANGING_STATS_MAX_RANGE_CM 400     /*!< Longest distance that the sensor measures (HC-SR04) */
+#define RANGING_STATS_TIMEOUT_ECHO_US 30000 /*!< Echoes at least this long are the pulse that the sensor sends when no echo comes back (about 38 ms on the HC-SR04) */
+#define RANGING_STATS_MAX_INTERVAL_US 1000000 /*!< Longer times between two pings are a pause of the sensor, not a ping period */
+#define RANGING_STATS_GAIN_SHIFT 4         /*!< Gain of the smoothed period and jitter: 1/2^RANGING_STATS_GAIN_SHIFT */
+#define RANGING_STATS_FRAC_BITS 16         /*!< Fractional bits of the mean and the variance */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the running statistics of the pings of a sensor.
+ */
+typedef struct
+{
+    uint32_t num_pings;        /*!< Pings whose echo has been measured */
+    uint32_t num_samples;      /*!< Pings in range, used by the distance statistics */
+    uint32_t num_timeouts;     /*!< Pings with no echo */
+    uint32_t num_out_of_range; /*!< Pings with an echo out of the range of the sensor */
+    uint32_t num_overflows;    /*!< Pings during which the echo timer overflowed */
+    uint32_t min_cm;           /*!< Shortest distance of the samples, in cm */
+    uint32_t max_cm;           /*!< Longest distance of the samples, in cm */
+    uint32_t mean_q16;         /*!< Mean distance of the samples, in cm (Q16.16) */
+    uint64_t m2_q16;           /*!< Sum of the squared deviations from the mean, in cm^2 (Q16.16) */
+    uint32_t last_ping_us;     /*!< Time of the last ping, in us */
+    uint32_t last_interval_us; /*!< Time between the last two pings, in us */
+    uint8_t num_times;         /*!< Times of pings of the current run known (up to 2): 1 for a period, 2 for a jitter */
+    uint32_t period_q4;        /*!< Smoothed time between two pings, in us (Q28.4) */
+    uint32_t jitter_q4;        /*!< Smoothed change of the time between two pings, in us (Q28.4) */
+} ranging_stats_t;
+
+/**
+ * @brief Structure representing a snapshot of the statistics of a sensor, in plain units.
+ */
+typedef struct
+{
+    uint32_t num_pings;         /*!< Pings whose echo has been measured */
+    uint32_t num_samples;       /*!< Pings in range */
+    uint32_t num_timeouts;      /*!< Pings with no echo */
+    uint32_t num_out_of_range;  /*!< Pings with an echo out of range */
+    uint32_t num_overflows;     /*!< Pings during which the echo timer overflowed */
+    uint32_t min_cm;            /*!< Shortest distance, in cm (0 with no samples) */
+    uint32_t max_cm;            /*!< Longest distance, in cm (0 with no samples) */
+    uint32_t mean_cm_q16;       /*!< Mean distance, in cm (Q16.16) */
+    uint32_t variance_cm2_q16;  /*!< Sample variance of the distance, in cm^2 (Q16.16, saturated) */
+    uint32_t period_us;         /*!< Smoothed time between two pings, in us (0 if unknown) */
+    uint32_t ping_rate_millihz; /*!< Pings per second, in thousandths (0 if unknown) */
+    uint32_t jitter_us;         /*!< Smoothed change of the time between two pings, in us */
+} ranging_stats_snapshot_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Empties the statistics.
+ *
+ * @param p_stats Pointer to the statistics.
+ */
+void ranging_stats_init(ranging_stats_t *p_stats);
+
+/**
+ * @brief Starts a new run of pings, after the sensor has been stopped: the time since the last ping is not a ping period.
+ *
+ * @param p_stats Pointer to the statistics.
+ */
+void ranging_stats_restart(ranging_stats_t *p_stats);
+
+/**
+ * @brief Adds a ping.
+ *
+ * @param p_stats Pointer to the statistics.
+ * @param time_us Time of the rising edge of the echo, in us.
+ * @param echo_us Width of the echo, in us.
+ * @param distance_cm Distance of the echo, in cm.
+ * @param overflow The echo timer overflowed during the ping.
+ */
+void ranging_stats_add_ping(ranging_stats_t *p_stats, uint32_t time_us, uint32_t echo_us, uint32_t distance_cm, bool overflow);
+
+/**
+ * @brief Takes a snapshot of the statistics.
+ *
+ * @param p_stats Pointer to the statistics.
+ * @param p_snapshot Pointer to the snapshot.
+ */
+void ranging_stats_get_snapshot(const ranging_stats_t *p_stats, ranging_stats_snapshot_t *p_snapshot);
+
+/**
+ * @brief Prints a snapshot of the statistics.
+ *
+ * @param p_snapshot Pointer to the snapshot.
+ * @param p_name Name of the sensor.
+ */
+void ranging_stats_print(const ranging_stats_snapshot_t *p_snapshot, const char *p_name);
+
+#endif /* RANGING_STATS_H_ */
@@ -0,0 +1,169 @@
+/**
+ * @file shell.h
+ * @brief Header for shell.c file.
+ *
+ * The shell is a small command line over the UART (`port_shell.h`) to tune the system and read its statistics at runtime. The bytes received are queued by the receive interrupt and parsed one at a time by `shell_service()` from the main loop, so a command never blocks the FSMs: a line is only executed once its end has been received, and its execution is a few table lookups and a reply.
+ *
+ * The tunable parameters are registered in a table of `shell_param_t`, one line each (see `SHELL_PARAM`). Each parameter is a `uint32_t` with a range, and optionally a setter that applies the new value to the system and may reject it. Commands (separated by spaces, ended by CR or LF):
+ *
+ * - `help [name]`: lists the commands and the parameters, or describes a parameter.
+ * - `get [name]`: writes the value of a parameter, or of all of them.
+ * - `set <name> <value>`: changes a parameter. The value is decimal, or hexadecimal with `0x`.
+ * - `stats`: writes the statistics of the system.
+ *
+ * Every reply line ends with LF; errors start with `error:`.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef SHELL_H_
+#define SHELL_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#define SHELL_LINE_SIZE 64 /*!< Longest command line, terminator included. Longer lines are discarded.*/
+#define SHELL_REPLY_SIZE 96 /*!< Longest reply written by a single `shell_printf()`, terminator included.*/
+#define SHELL_MAX_ARGS 4 /*!< Maximum number of words of a command line.*/
+
+/**
+ * @brief Entry of a table of parameters.
+ *
+ * @param name Name of the parameter in the commands.
+ * @param p_value Pointer to the `uint32_t` that holds the value.
+ * @param min Smallest value accepted.
+ * @param max Largest value accepted.
+ * @param p_set Setter that applies a new value (see `shell_set_t`), or NULL if the value is only stored.
+ * @param help Description of the parameter.
+ */
+#define SHELL_PARAM(name, p_value, min, max, p_set, help) {(name), (p_value), (min), (max), (p_set), (help)}
+
+/* Typedefs --------------------------------------------------------------------*/
+typedef struct shell_t shell_t;
+typedef struct shell_param_t shell_param_t;
+
+/**
+ * @brief Applies a new value of a parameter to the system. It is called before the value is stored.
+ *
+ * @param p_ctx Context given to `shell_init()`.
+ * @param p_param Parameter being changed.
+ * @param value New value, already within the range of the parameter.
+ *
+ * @retval true if the value has been applied.
+ * @retval false if the system rejects it: the parameter keeps its value.
+ */
+typedef bool (shell_set_t)(void *p_ctx, const shell_param_t *p_param, uint32_t value);
+
+/**
+ * @brief Writes the reply of a command to the UART.
+ *
+ * @param p_ctx Context given to `shell_init()`.
+ * @param p_text Pointer to the text. It is not terminated.
+ * @param length Length of the text, in bytes.
+ */
+typedef void (shell_write_t)(void *p_ctx, const char *p_text, uint32_t length);
+
+/**
+ * @brief Writes the statistics of the system with `shell_printf()`, for the `stats` command.
+ *
+ * @param p_ctx Context given to `shell_init()`.
+ * @param p_shell Pointer to the shell.
+ */
+typedef void (shell_stats_t)(void *p_ctx, shell_t *p_shell);
+
+/**
+ * @brief Structure representing a tunable parameter.
+ */
+struct shell_param_t
+{
+    const char *p_name;  /*!< Name of the parameter in the commands.*/
+    uint32_t *p_value;   /*!< Value of the parameter.*/
+    uint32_t min;        /*!< Smallest value accepted.*/
+    uint32_t max;        /*!< Largest value accepted.*/
+    shell_set_t *p_set;  /*!< Setter that applies a new value, or NULL.*/
+    const char *p_help;  /*!< Description of the parameter.*/
+};
+
+/**
+ * @brief Structure representing a shell: the line being received and the table of parameters.
+ */
+struct shell_t
+{
+    char line[SHELL_LINE_SIZE];   /*!< Characters of the line being received.*/
+    uint32_t length;              /*!< Characters of the line received so far.*/
+    bool overflow;                /*!< The line being received is longer than `SHELL_LINE_SIZE`: it is discarded at its end.*/
+    const shell_param_t *p_params; /*!< Table of parameters.*/
+    uint32_t num_params;          /*!< Number of parameters of the table.*/
+    shell_write_t *p_write;       /*!< Writer of the replies.*/
+    shell_stats_t *p_stats;       /*!< Writer of the statistics, or NULL.*/
+    void *p_ctx;                  /*!< Context of the callbacks.*/
+    uint32_t num_commands;        /*!< Command lines executed.*/
+    uint32_t num_errors;          /*!< Command lines rejected.*/
+};
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Initializes a shell and the reception of the UART.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param p_params Pointer to the table of parameters. It must outlive the shell.
+ * @param num_params Number of parameters of the table.
+ * @param p_write Writer of the replies.
+ * @param p_stats Writer of the statistics, or NULL if the shell has no `stats` command.
+ * @param p_ctx Context of the callbacks.
+ */
+void shell_init(shell_t *p_shell, const shell_param_t *p_params, uint32_t num_params, shell_write_t *p_write, shell_stats_t *p_stats, void *p_ctx);
+
+/**
+ * @brief Parses the bytes received by the UART since the last call, and executes the lines completed. It never waits for a byte, so it must be called when the system wakes up.
+ *
+ * @param p_shell Pointer to the shell.
+ */
+void shell_service(shell_t *p_shell);
+
+/**
+ * @brief Feeds a character to the line being received. CR or LF ends the line and executes it, backspace (BS or DEL) removes the last character, and the other control characters are ignored.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param c Character received.
+ *
+ * @retval true if the character has completed a command line, which has been executed.
+ * @retval false otherwise.
+ */
+bool shell_feed(shell_t *p_shell, char c);
+
+/**
+ * @brief Executes a command line.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param p_line Pointer to the line, without its end. It is modified.
+ *
+ * @retval true if the command has been executed.
+ * @retval false if it has been rejected (an error has been written).
+ */
+bool shell_execute(shell_t *p_shell, char *p_line);
+
+/**
+ * @brief Finds a parameter of the table by its name.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param p_name Name of the parameter.
+ *
+ * @return Pointer to the parameter, or NULL if there is none with that name.
+ */
+const shell_param_t *shell_find_param(const shell_t *p_shell, const char *p_name);
+
+/**
+ * @brief Writes a formatted reply. Replies longer than `SHELL_REPLY_SIZE` are truncated.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param p_format Format of the reply, as in `printf()`.
+ */
+void shell_printf(shell_t *p_shell, const char *p_format, ...);
+
+#endif /* SHELL_H_ */
@@ -0,0 +1,61 @@
+/**
+ * @file speed_of_sound.h
+ * @brief Header for speed_of_sound.c file.
+ *
+ * The speed of sound in air grows with the temperature, from about 319 m/s at -20 ºC to 355 m/s at 40 ºC, so a fixed speed reads up to 7 % too long or too short. The speed is approximated by the line that best fits the exact law, 331.3 * sqrt(1 + T / 273.15) m/s, between -20 ºC and 40 ºC: its error is below 0.25 m/s (0.1 %) in that range.
+ *
+ * The ultrasound FSM converts the width of each echo into a distance with a scale factor in fixed point, which is only computed again when the temperature is read: the compensation adds no cost to each echo.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef SPEED_OF_SOUND_H_
+#define SPEED_OF_SOUND_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#define SPEED_OF_SOUND_0C_MM_S 331107 /*!< Speed of sound of the line at 0 ºC, in mm/s.*/
+#define SPEED_OF_SOUND_SLOPE_MM_S 5965 /*!< Slope of the line, in mm/s per 10 ºC (i.e., 0.5965 m/s per ºC).*/
+
+#define SPEED_OF_SOUND_MIN_TEMPERATURE_DC (-400) /*!< Lowest temperature considered, in tenths of ºC. Colder readings are clamped to it.*/
+#define SPEED_OF_SOUND_MAX_TEMPERATURE_DC 850    /*!< Highest temperature considered, in tenths of ºC. Hotter readings are clamped to it.*/
+
+#define SPEED_OF_SOUND_SCALE_SHIFT 24 /*!< Number of fractional bits of the scale from microseconds of echo to cm.*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Returns the speed of sound in air at a temperature.
+ *
+ * @param temperature_dc Temperature, in tenths of ºC.
+ *
+ * @return uint32_t Speed of sound, in mm/s.
+ */
+uint32_t speed_of_sound_get_mm_s(int32_t temperature_dc);
+
+/**
+ * @brief Returns the scale from the width of an echo to the distance of its obstacle: `distance_cm = (width_us * scale + 2^(SHIFT - 1)) >> SHIFT`, i.e., half the round trip, to the closest cm.
+ *
+ * @param speed_mm_s Speed of sound, in mm/s.
+ *
+ * @return uint32_t Scale, in cm per us with `SPEED_OF_SOUND_SCALE_SHIFT` fractional bits.
+ */
+uint32_t speed_of_sound_get_scale(uint32_t speed_mm_s);
+
+/**
+ * @brief Converts the width of an echo into the distance of its obstacle.
+ *
+ * @param width_us Width of the echo, in us.
+ * @param scale Scale given by `speed_of_sound_get_scale()`.
+ *
+ * @return uint32_t Distance, in cm.
+ */
+static inline uint32_t speed_of_sound_get_distance_cm(uint32_t width_us, uint32_t scale)
+{
+    return (uint32_t)(((uint64_t)width_us * scale + (1ULL << (SPEED_OF_SOUND_SCALE_SHIFT - 1))) >> SPEED_OF_SOUND_SCALE_SHIFT);
+}
+
+#endif /* SPEED_OF_SOUND_H_ */
@@ -0,0 +1,236 @@
+/**
+ * @file telemetry.h
+ * @brief Header for telemetry.c file.
+ *
+ * The telemetry is a stream of binary packets sent through a UART (`port_telemetry.h`) to a host, where they are decoded by `telemetry_decode`. Each packet is a type, a sequence number, a payload and a CRC-16/CCITT of them (little endian). It is COBS-encoded (Consistent Overhead Byte Stuffing) so that it has no zero byte, and followed by a zero byte that delimits the frame: a decoder that starts in the middle of the stream, or that loses bytes, synchronizes again at the next zero byte. COBS adds one byte every 254 bytes at most.
+ *
+ * The frames are encoded into a ring buffer, and the UART sends the bytes of the ring with a DMA transfer, so the CPU does not copy nor wait for any byte once the frame is in the ring. A transfer takes the contiguous bytes from the tail of the ring to its head, or to the end of the ring if the frames wrap; the next transfer is started by `telemetry_service()` after the transfer complete interrupt wakes the system up. When the ring has no room for a frame, the whole frame is dropped and counted, so the stream never has half frames.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#ifndef TELEMETRY_RING_SIZE
+#define TELEMETRY_RING_SIZE 512 /*!< Size of the ring buffer of the frames, in bytes (a power of 2) */
+#endif
+#define TELEMETRY_MAX_PAYLOAD 60 /*!< Largest payload of a packet, in bytes */
+#define TELEMETRY_HEADER_SIZE 2 /*!< Size of the type and the sequence number of a packet, in bytes */
+#define TELEMETRY_CRC_SIZE 2 /*!< Size of the CRC of a packet, in bytes */
+#define TELEMETRY_MAX_PACKET (TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + TELEMETRY_CRC_SIZE) /*!< Largest packet, in bytes */
+#define TELEMETRY_MAX_FRAME (TELEMETRY_MAX_PACKET + TELEMETRY_MAX_PACKET / 254 + 2) /*!< Largest frame: the COBS-encoded packet and its delimiter, in bytes */
+#define TELEMETRY_STATUS_SIZE 20 /*!< Size of the payload of a `TELEMETRY_PACKET_STATUS` packet, in bytes */
+
+/**
+ * @brief Types of the packets of the telemetry.
+ */
+enum TELEMETRY_PACKET_TYPES
+{
+    TELEMETRY_PACKET_STATUS = 1, /*!< Periodic status of the system. The payload is a `telemetry_status_t`, little endian.*/
+    TELEMETRY_PACKET_TEXT,       /*!< Text, e.g., the replies of the shell. The payload is a piece of the text, not terminated; a long text is split into consecutive packets.*/
+};
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the status of the system sent in a `TELEMETRY_PACKET_STATUS` packet.
+ */
+typedef struct
+{
+    uint32_t timestamp_ms;    /*!< System time (in ms) of the status.*/
+    uint32_t distance_cm;     /*!< Last distance measured by the rear sensor, in cm.*/
+    uint8_t urbanite_state;   /*!< State of the Urbanite FSM.*/
+    uint8_t ultrasound_state; /*!< State of the rear ultrasound FSM.*/
+    uint8_t display_state;    /*!< State of the rear display FSM.*/
+    uint8_t buzzer_state;     /*!< State of the rear buzzer FSM.*/
+    uint32_t num_packets;     /*!< Packets queued by the sender before this one.*/
+    uint32_t num_dropped;     /*!< Packets dropped by the sender because the ring was full.*/
+} telemetry_status_t;
+
+/**
+ * @brief Structure representing the sender of the telemetry: the ring buffer of the frames and the DMA transfer in flight.
+ */
+typedef struct
+{
+    uint8_t ring[TELEMETRY_RING_SIZE]; /*!< Encoded frames waiting to be sent.*/
+    uint32_t head;          /*!< Free-running index where the next frame is written.*/
+    uint32_t tail;          /*!< Free-running index of the first byte not sent yet.*/
+    uint32_t in_flight;     /*!< Bytes from the tail being sent by the DMA transfer in progress.*/
+    uint8_t sequence;       /*!< Sequence number of the next packet.*/
+    uint32_t period_ms;     /*!< Period of the status packets, in ms.*/
+    uint32_t next_ms;       /*!< System time (in ms) of the next status packet.*/
+    uint32_t num_packets;   /*!< Packets queued in the ring.*/
+    uint32_t num_dropped;   /*!< Packets dropped because the ring was full.*/
+    uint32_t num_transfers; /*!< DMA transfers started.*/
+} telemetry_t;
+
+/**
+ * @brief Structure representing a packet decoded from the stream.
+ */
+typedef struct
+{
+    uint8_t type;     /*!< Type of the packet, one of `TELEMETRY_PACKET_TYPES`.*/
+    uint8_t sequence; /*!< Sequence number of the packet.*/
+    uint32_t length;  /*!< Length of the payload, in bytes.*/
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD]; /*!< Payload of the packet.*/
+} telemetry_packet_t;
+
+/**
+ * @brief Structure representing a decoder of the stream, fed one byte at a time.
+ */
+typedef struct
+{
+    uint8_t frame[TELEMETRY_MAX_FRAME]; /*!< Bytes of the frame being received.*/
+    uint32_t length;      /*!< Bytes of the frame received so far.*/
+    bool synced;          /*!< A delimiter has been received, so the frame being received is whole.*/
+    bool overflow;        /*!< The frame being received is longer than the largest frame.*/
+    bool has_sequence;    /*!< A packet has been decoded, so `sequence` is valid.*/
+    uint8_t sequence;     /*!< Sequence number of the last packet decoded.*/
+    uint32_t num_packets; /*!< Packets decoded.*/
+    uint32_t num_errors;  /*!< Frames discarded: wrong COBS encoding, length or CRC.*/
+    uint32_t num_lost;    /*!< Packets missing from the sequence numbers.*/
+} telemetry_decoder_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Initializes the UART of the telemetry and empties the ring.
+ *
+ * @param p_telemetry Pointer to the sender.
+ * @param period_ms Period of the status packets, in ms. The first one is due at once.
+ */
+void telemetry_init(telemetry_t *p_telemetry, uint32_t period_ms);
+
+/**
+ * @brief Checks whether a status packet is due, and schedules the next one. The packets are sent at the period as long as the system is awake; a late packet does not make the next ones come sooner.
+ *
+ * @param p_telemetry Pointer to the sender.
+ * @param now_ms System time, in ms.
+ *
+ * @retval true if a status packet must be sent.
+ * @retval false otherwise.
+ */
+bool telemetry_is_due(telemetry_t *p_telemetry, uint32_t now_ms);
+
+/**
+ * @brief Encodes a packet into the ring and starts sending it if the UART is idle.
+ *
+ * @param p_telemetry Pointer to the sender.
+ * @param type Type of the packet, one of `TELEMETRY_PACKET_TYPES`.
+ * @param p_payload Pointer to the payload.
+ * @param length Length of the payload, in bytes (up to `TELEMETRY_MAX_PAYLOAD`).
+ *
+ * @retval true if the packet has been queued.
+ * @retval false if the payload is too large, or the packet has been dropped because the ring is full.
+ */
+bool telemetry_send(telemetry_t *p_telemetry, uint8_t type, const void *p_payload, uint32_t length);
+
+/**
+ * @brief Sends a `TELEMETRY_PACKET_STATUS` packet. The counters of the status are filled with those of the sender.
+ *
+ * @param p_telemetry Pointer to the sender.
+ * @param p_status Pointer to the status.
+ *
+ * @retval true if the packet has been queued.
+ * @retval false if the packet has been dropped.
+ */
+bool telemetry_send_status(telemetry_t *p_telemetry, const telemetry_status_t *p_status);
+
+/**
+ * @brief Sends a text in `TELEMETRY_PACKET_TEXT` packets of up to `TELEMETRY_MAX_PAYLOAD` bytes.
+ *
+ * @param p_telemetry Pointer to the sender.
+ * @param p_text Pointer to the text. It does not need to be terminated.
+ * @param length Length of the text, in bytes.
+ *
+ * @retval true if all the packets have been queued.
+ * @retval false if some packet has been dropped.
+ */
+bool telemetry_send_text(telemetry_t *p_telemetry, const char *p_text, uint32_t length);
+
+/**
+ * @brief Releases the bytes of the ring sent by the last DMA transfer, if it has completed, and starts a transfer with the next bytes. It must be called when the system wakes up.
+ *
+ * @param p_telemetry Pointer to the sender.
+ */
+void telemetry_service(telemetry_t *p_telemetry);
+
+/**
+ * @brief Returns the number of bytes of the ring not sent yet.
+ *
+ * @param p_telemetry Pointer to the sender.
+ *
+ * @return uint32_t Bytes queued, including those being sent.
+ */
+uint32_t telemetry_get_pending_bytes(const telemetry_t *p_telemetry);
+
+/**
+ * @brief Encodes bytes with COBS. The result has no zero byte and no delimiter.
+ *
+ * @param p_src Pointer to the bytes to encode.
+ * @param length Number of bytes to encode.
+ * @param p_dst Pointer to the encoded bytes (at least `length + length / 254 + 1` bytes).
+ *
+ * @return uint32_t Number of encoded bytes.
+ */
+uint32_t telemetry_cobs_encode(const uint8_t *p_src, uint32_t length, uint8_t *p_dst);
+
+/**
+ * @brief Decodes bytes encoded with COBS, without the delimiter.
+ *
+ * @param p_src Pointer to the encoded bytes.
+ * @param length Number of encoded bytes.
+ * @param p_dst Pointer to the decoded bytes (at least `length` bytes). It may be `p_src`.
+ *
+ * @return int32_t Number of decoded bytes, or -1 if the bytes are not a valid COBS encoding.
+ */
+int32_t telemetry_cobs_decode(const uint8_t *p_src, uint32_t length, uint8_t *p_dst);
+
+/**
+ * @brief Returns the CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of some bytes.
+ *
+ * @param p_data Pointer to the bytes.
+ * @param length Number of bytes.
+ *
+ * @return uint16_t CRC of the bytes.
+ */
+uint16_t telemetry_crc16(const uint8_t *p_data, uint32_t length);
+
+/**
+ * @brief Initializes a decoder. The bytes before the first delimiter are discarded, as the decoder may have started in the middle of a frame.
+ *
+ * @param p_decoder Pointer to the decoder.
+ */
+void telemetry_decoder_init(telemetry_decoder_t *p_decoder);
+
+/**
+ * @brief Feeds a byte of the stream to a decoder.
+ *
+ * @param p_decoder Pointer to the decoder.
+ * @param byte Byte received.
+ * @param p_packet Pointer to the packet decoded.
+ *
+ * @retval true if the byte completes a valid packet.
+ * @retval false otherwise.
+ */
+bool telemetry_decoder_feed(telemetry_decoder_t *p_decoder, uint8_t byte, telemetry_packet_t *p_packet);
+
+/**
+ * @brief Parses the payload of a `TELEMETRY_PACKET_STATUS` packet.
+ *
+ * @param p_packet Pointer to the packet.
+ * @param p_status Pointer to the status parsed.
+ *
+ * @retval true if the packet is a status packet.
+ * @retval false if it has another type or length.
+ */
+bool telemetry_parse_status(const telemetry_packet_t *p_packet, telemetry_status_t *p_status);
+
+#endif /* TELEMETRY_H_ */
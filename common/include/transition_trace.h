@@ -0,0 +1,156 @@
+/**
+ * @file transition_trace.h
+ * @brief Header for transition_trace.c file.
+ *
+ * A transition trace keeps the last state changes of the FSMs, to see after the fact what the system did before it misbehaved or reset. Each FSM with a trace attached records a change of its state when it is fired: recording is a compare per fire, and a handful of stores per change, so the trace can stay enabled in production.
+ *
+ * On the target the trace lives in a RAM section that the startup code does not initialize (`TRANSITION_TRACE_NOINIT`), so it survives a reset: `transition_trace_restore()` keeps the records of a valid trace and marks the reset. As with the echo trace, the memory image of the trace is its file format: dump it with `dump binary memory transitions.bin &urbanite_transition_trace (&urbanite_transition_trace)+1` in GDB and decode it on the host with `transition_trace_dump`.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef TRANSITION_TRACE_H_
+#define TRANSITION_TRACE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#ifndef TRANSITION_TRACE_MAX_RECORDS
+#define TRANSITION_TRACE_MAX_RECORDS 256 /*!< Number of records of a trace (a power of 2). When it is full, each new transition overwrites the oldest one.*/
+#endif
+
+#define TRANSITION_TRACE_MAGIC 0x31525354 /*!< Identifier of a transition trace ("TSR1" in memory).*/
+
+#define TRANSITION_TRACE_ID(fsm, instance) ((uint8_t)(((fsm) << 4) | ((instance) & 0x0F))) /*!< ID of a FSM in the records: its type (see `TRANSITION_TRACE_FSMS`) and the ID of its hardware.*/
+#define TRANSITION_TRACE_GET_FSM(id) ((id) >> 4)         /*!< Type of the FSM of an ID.*/
+#define TRANSITION_TRACE_GET_INSTANCE(id) ((id) & 0x0F)  /*!< ID of the hardware of the FSM of an ID.*/
+
+#define TRANSITION_TRACE_ID_RESET 0xFF /*!< ID of the records that mark a reset survived by the trace.*/
+
+#ifndef TRANSITION_TRACE_NOINIT
+#define TRANSITION_TRACE_NOINIT __attribute__((section(".noinit"))) /*!< Placement of the trace of the target. The linker script must keep `.noinit` in RAM, out of `.bss` and of the heap, so that it is neither zeroed nor initialized at startup. The `footprint` target fails if `.noinit` does not end below the heap.*/
+#endif
+
+/**
+ * @brief Types of the FSMs that record their transitions.
+ */
+enum TRANSITION_TRACE_FSMS {
+    TRANSITION_TRACE_FSM_BUTTON = 0, /*!< Button FSM.*/
+    TRANSITION_TRACE_FSM_ULTRASOUND, /*!< Ultrasound FSM.*/
+    TRANSITION_TRACE_FSM_DISPLAY,    /*!< Display FSM.*/
+    TRANSITION_TRACE_FSM_BUZZER,     /*!< Buzzer FSM.*/
+    TRANSITION_TRACE_FSM_URBANITE    /*!< Urbanite FSM.*/
+};
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing a change of the state of a FSM (8 bytes).
+ */
+typedef struct {
+    uint32_t timestamp_ms; /*!< System time (in ms) at which the FSM entered the new state.*/
+    uint8_t fsm_id;        /*!< ID of the FSM (see `TRANSITION_TRACE_ID`), or `TRANSITION_TRACE_ID_RESET`.*/
+    uint8_t from_state;    /*!< State the FSM has left.*/
+    uint8_t to_state;      /*!< State the FSM has entered.*/
+    uint8_t reserved;      /*!< Zero.*/
+} transition_trace_record_t;
+
+/**
+ * @brief Structure representing a transition trace: a header followed by a circular buffer of records.
+ */
+typedef struct {
+    uint32_t magic;           /*!< `TRANSITION_TRACE_MAGIC`.*/
+    uint16_t record_size;     /*!< Size of a record, in bytes.*/
+    uint16_t max_records;     /*!< Number of records of the buffer.*/
+    uint32_t num_transitions; /*!< Number of records written since the trace was initialized, including those already overwritten. The next record is written at this index, modulo `max_records`.*/
+    uint32_t num_resets;      /*!< Number of resets survived by the trace.*/
+    transition_trace_record_t records[TRANSITION_TRACE_MAX_RECORDS]; /*!< Records of the transitions.*/
+} transition_trace_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Empties a transition trace and writes its header.
+ *
+ * @param p_trace Pointer to the trace.
+ */
+void transition_trace_init(transition_trace_t *p_trace);
+
+/**
+ * @brief Keeps the records of a trace that has survived a reset, and marks the reset with a record. A trace whose header is not valid (e.g., after a power-on) is emptied instead.
+ *
+ * @param p_trace Pointer to the trace.
+ * @param timestamp_ms System time (in ms) of the reset record.
+ *
+ * @retval true if the records have been kept.
+ * @retval false if the trace has been emptied.
+ */
+bool transition_trace_restore(transition_trace_t *p_trace, uint32_t timestamp_ms);
+
+/**
+ * @brief Adds a change of the state of a FSM to a trace. The oldest record is overwritten if the trace is full.
+ *
+ * The record is written before it is counted, so a reset in the middle of the write leaves the trace valid.
+ *
+ * @param p_trace Pointer to the trace.
+ * @param timestamp_ms System time (in ms) of the transition.
+ * @param fsm_id ID of the FSM (see `TRANSITION_TRACE_ID`).
+ * @param from_state State the FSM has left.
+ * @param to_state State the FSM has entered.
+ */
+static inline void transition_trace_add(transition_trace_t *p_trace, uint32_t timestamp_ms, uint8_t fsm_id, uint8_t from_state, uint8_t to_state)
+{
+    transition_trace_record_t *p_record = &p_trace->records[p_trace->num_transitions & (TRANSITION_TRACE_MAX_RECORDS - 1)];
+    p_record->timestamp_ms = timestamp_ms;
+    p_record->fsm_id = fsm_id;
+    p_record->from_state = from_state;
+    p_record->to_state = to_state;
+    p_record->reserved = 0;
+    p_trace->num_transitions++;
+}
+
+/**
+ * @brief Returns the number of records of a trace that can be read.
+ *
+ * @param p_trace Pointer to the trace.
+ *
+ * @return Number of records, up to `max_records`.
+ */
+uint32_t transition_trace_get_count(const transition_trace_t *p_trace);
+
+/**
+ * @brief Returns a record of a trace, from the oldest one to the newest one.
+ *
+ * @param p_trace Pointer to the trace.
+ * @param idx Index of the record: 0 for the oldest record kept.
+ *
+ * @return Pointer to the record, or NULL if there is no such record.
+ */
+const transition_trace_record_t *transition_trace_get_record(const transition_trace_t *p_trace, uint32_t idx);
+
+/**
+ * @brief Saves the memory image of a trace to a file (host or semihosting).
+ *
+ * @param p_trace Pointer to the trace.
+ * @param p_path Path of the file.
+ *
+ * @retval true if the trace has been saved.
+ * @retval false if the file cannot be written.
+ */
+bool transition_trace_save(const transition_trace_t *p_trace, const char *p_path);
+
+/**
+ * @brief Loads a trace from a file. The file may come from a build with a different `TRANSITION_TRACE_MAX_RECORDS`: the newest records that fit are kept.
+ *
+ * @param p_trace Pointer to the trace.
+ * @param p_path Path of the file.
+ *
+ * @retval true if the trace has been loaded.
+ * @retval false if the file cannot be read or it is not a transition trace.
+ */
+bool transition_trace_load(transition_trace_t *p_trace, const char *p_path);
+
+#endif /* TRANSITION_TRACE_H_ */
@@ -0,0 +1,52 @@
+/**
+ * @file urbanite_shell.h
+ * @brief Header for urbanite_shell.c file.
+ *
+ * The command shell of the Urbanite (see `shell.h`): the table of its tunable parameters, which apply at once to the running FSMs, and its statistics. A new parameter is a line of the table in `urbanite_shell.c`, with a setter if it must be applied to a FSM or to the port. The values set are kept until the system is reset.
+ *
+ * | Parameter | Default | Effect |
+ * |-----------|---------|--------|
+ * | `on_off_ms` | `URBANITE_ON_OFF_PRESS_TIME_MS` | Hold time of the button to switch the system on/off |
+ * | `pause_ms` | `URBANITE_PAUSE_DISPLAY_TIME_MS` | Shortest click that pauses/resumes the display (shorter than `on_off_ms`) |
+ * | `ping_ms` | `PORT_PARKING_SENSOR_TIMEOUT_MS` | Period of the pings of the rear sensor |
+ * | `median_n` | `FSM_ULTRASOUND_NUM_MEASUREMENTS` | Pings whose median gives a distance |
+ * | `band0_cm` ... `band5_cm` | `fsm_display.h` | Upper limits of the bands of the rear display (strictly increasing) |
+ * | `echoes` | 1 | Echoes captured in each ping of the rear sensor |
+ * | `min_obstacle_cm` | 0 | Distance below which the echoes are not obstacles, so the nearest echo beyond it is displayed |
+ *
+ * The replies are sent in the telemetry stream, as text packets, since the shell and the telemetry share the UART; without a telemetry sender they are written with `printf()`.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef URBANITE_SHELL_H_
+#define URBANITE_SHELL_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Other includes */
+#include "shell.h"
+#include "telemetry.h"
+#include "fsm_urbanite.h"
+#include "fsm_ultrasound.h"
+#include "fsm_display.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define URBANITE_SHELL_NUM_BANDS 6 /*!< Bands of the rear display whose limits can be tuned (those of the default band table).*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initializes the shell of the Urbanite. The parameters take the current settings of the FSMs and of the port.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param p_fsm_urbanite Pointer to the Urbanite FSM.
+ * @param p_fsm_ultrasound_rear Pointer to the rear ultrasound FSM.
+ * @param p_fsm_display_rear Pointer to the rear display FSM.
+ * @param p_telemetry Pointer to the initialized telemetry sender that carries the replies, or NULL to write them with `printf()`.
+ */
+void urbanite_shell_init(shell_t *p_shell, fsm_urbanite_t *p_fsm_urbanite, fsm_ultrasound_t *p_fsm_ultrasound_rear, fsm_display_t *p_fsm_display_rear, telemetry_t *p_telemetry);
+
+#endif /* URBANITE_SHELL_H_ */
@@ -0,0 +1,461 @@
+/**
+ * @file distance_history.c
+ * @brief History of the filtered distances of an ultrasound sensor, compressed as zig-zag varint deltas.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Project includes */
+#include "distance_history.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define DISTANCE_HISTORY_HEADER_SIZE offsetof(distance_history_t, blocks) /*!< Size of the header of a history, in bytes */
+#define DISTANCE_HISTORY_MAX_VARINT_BYTES 10 /*!< Maximum size of a varint of 64 bits, in bytes */
+#define DISTANCE_HISTORY_MAX_RUN UINT16_MAX  /*!< Maximum number of samples of a run, so that it always fits in the count of a block */
+
+_Static_assert(sizeof(distance_history_block_t) == DISTANCE_HISTORY_BLOCK_SIZE, "The blocks of a history must be packed");
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Zig-zag encodes a change of distance: 0, -1, 1, -2, 2... become 0, 1, 2, 3, 4...
+ *
+ * @param value Change of distance.
+ *
+ * @return uint32_t Encoded change.
+ */
+static uint32_t _zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ ((value < 0) ? UINT32_MAX : 0);
+}
+
+/**
+ * @brief Decodes a zig-zag encoded change of distance.
+ *
+ * @param value Encoded change.
+ *
+ * @return int32_t Change of distance.
+ */
+static int32_t _unzigzag(uint32_t value)
+{
+    return (int32_t)((value >> 1) ^ (0U - (value & 1)));
+}
+
+/**
+ * @brief Writes a varint: 7 bits per byte, from the least significant ones, with the highest bit set in all the bytes but the last one.
+ *
+ * @param p_bytes Pointer to the bytes to write (at least `DISTANCE_HISTORY_MAX_VARINT_BYTES`).
+ * @param value Value to write.
+ *
+ * @return uint32_t Number of bytes written.
+ */
+static uint32_t _put_varint(uint8_t *p_bytes, uint64_t value)
+{
+    uint32_t len = 0;
+    while (value >= 0x80)
+    {
+        p_bytes[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p_bytes[len++] = (uint8_t)value;
+    return len;
+}
+
+/**
+ * @brief Reads a varint of a block.
+ *
+ * @param p_block Pointer to the block.
+ * @param p_offset Offset of the varint in the block, advanced past it.
+ * @param p_value Value read.
+ *
+ * @retval true if a varint has been read.
+ * @retval false if the varint goes past the tokens of the block.
+ */
+static bool _get_varint(const distance_history_block_t *p_block, uint32_t *p_offset, uint64_t *p_value)
+{
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 7 * DISTANCE_HISTORY_MAX_VARINT_BYTES && *p_offset < p_block->num_bytes; shift += 7)
+    {
+        uint8_t byte = p_block->data[(*p_offset)++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            *p_value = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the position in the buffer of a block of a history.
+ *
+ * @param p_history Pointer to the history.
+ * @param idx Index of the block from the oldest one.
+ *
+ * @return uint32_t Index of the block in the buffer.
+ */
+static uint32_t _block_idx(const distance_history_t *p_history, uint32_t idx)
+{
+    return (p_history->first_block + idx) % DISTANCE_HISTORY_NUM_BLOCKS;
+}
+
+/**
+ * @brief Writes a token to the newest block of a history, or to a new block if it does not fit. A new block drops the oldest one if the history is full and starts from the state of the samples written.
+ *
+ * @param p_history Pointer to the history.
+ * @param token Token (see `DISTANCE_HISTORY_KINDS`).
+ * @param time_ms Time since the previous sample, written after the token if it is `DISTANCE_HISTORY_KIND_STEP_TIME`.
+ * @param num_samples Number of samples of the token.
+ */
+static void _write(distance_history_t *p_history, uint64_t token, uint32_t time_ms, uint32_t num_samples)
+{
+    uint8_t bytes[2 * DISTANCE_HISTORY_MAX_VARINT_BYTES];
+    uint32_t len = _put_varint(bytes, token);
+    if ((token & 3) == DISTANCE_HISTORY_KIND_STEP_TIME)
+    {
+        len += _put_varint(&bytes[len], time_ms);
+    }
+
+    distance_history_block_t *p_block = (p_history->used_blocks > 0) ? &p_history->blocks[_block_idx(p_history, p_history->used_blocks - 1)] : NULL;
+    if ((p_block == NULL) || (p_block->num_bytes + len > DISTANCE_HISTORY_BLOCK_DATA_SIZE) || (p_block->num_samples + num_samples > UINT16_MAX))
+    {
+        if (p_history->used_blocks == DISTANCE_HISTORY_NUM_BLOCKS)
+        {
+            p_history->first_block = (p_history->first_block + 1) % DISTANCE_HISTORY_NUM_BLOCKS;
+            p_history->used_blocks--;
+        }
+        p_block = &p_history->blocks[_block_idx(p_history, p_history->used_blocks++)];
+        p_block->timestamp_ms = p_history->timestamp_ms;
+        p_block->distance_cm = p_history->distance_cm;
+        p_block->dt_ms = p_history->dt_ms;
+        p_block->delta_cm = p_history->delta_cm;
+        p_block->num_samples = 0;
+        p_block->num_bytes = 0;
+    }
+    memcpy(&p_block->data[p_block->num_bytes], bytes, len);
+    p_block->num_bytes += (uint16_t)len;
+    p_block->num_samples += (uint16_t)num_samples;
+}
+
+/**
+ * @brief Writes a sample to a block, as a change of distance and, if it changes, a time since the previous sample.
+ *
+ * @param p_history Pointer to the history.
+ * @param dt_ms Time since the previous sample.
+ * @param delta_cm Change of distance since the previous sample.
+ */
+static void _write_step(distance_history_t *p_history, uint32_t dt_ms, int32_t delta_cm)
+{
+    uint32_t kind = (dt_ms == p_history->dt_ms) ? DISTANCE_HISTORY_KIND_STEP : DISTANCE_HISTORY_KIND_STEP_TIME;
+    _write(p_history, ((uint64_t)_zigzag(delta_cm) << 2) | kind, dt_ms, 1);
+    p_history->timestamp_ms += dt_ms;
+    p_history->distance_cm += (uint32_t)delta_cm;
+    p_history->dt_ms = dt_ms;
+    p_history->delta_cm = delta_cm;
+}
+
+/**
+ * @brief Writes the samples that repeat the last step written to a block.
+ *
+ * @param p_history Pointer to the history.
+ */
+static void _flush_run(distance_history_t *p_history)
+{
+    if (p_history->run_length == 0)
+    {
+        return;
+    }
+    _write(p_history, ((uint64_t)p_history->run_length << 2) | DISTANCE_HISTORY_KIND_RUN, 0, p_history->run_length);
+    p_history->timestamp_ms += p_history->run_length * p_history->dt_ms;
+    p_history->distance_cm += p_history->run_length * (uint32_t)p_history->delta_cm;
+    p_history->run_length = 0;
+}
+
+/**
+ * @brief Writes the samples of an incomplete group of small steps to a block, one by one.
+ *
+ * @param p_history Pointer to the history.
+ */
+static void _flush_small_steps(distance_history_t *p_history)
+{
+    uint32_t small_steps = p_history->small_steps;
+    for (uint32_t i = 0; i < p_history->num_small_steps; i++)
+    {
+        _write_step(p_history, p_history->dt_ms, (int32_t)(small_steps % 3) - 1);
+        small_steps /= 3;
+    }
+    p_history->num_small_steps = 0;
+    p_history->small_steps = 0;
+}
+
+/**
+ * @brief Moves a reader to the beginning of a block, with the state of the decoder before it.
+ *
+ * @param p_iter Pointer to the reader.
+ * @param block Index of the block from the oldest one.
+ */
+static void _iter_load_block(distance_history_iter_t *p_iter, uint32_t block)
+{
+    p_iter->block = block;
+    p_iter->offset = 0;
+    if (block < p_iter->p_history->used_blocks)
+    {
+        const distance_history_block_t *p_block = &p_iter->p_history->blocks[_block_idx(p_iter->p_history, block)];
+        p_iter->timestamp_ms = p_block->timestamp_ms;
+        p_iter->distance_cm = p_block->distance_cm;
+        p_iter->dt_ms = p_block->dt_ms;
+        p_iter->delta_cm = p_block->delta_cm;
+    }
+}
+
+/**
+ * @brief Reads the next sample of the current run or group of small steps of a reader.
+ *
+ * @param p_iter Pointer to the reader.
+ * @param p_sample Pointer to the sample read.
+ *
+ * @retval true if a sample has been read.
+ * @retval false if the run and the group are over.
+ */
+static bool _iter_next_pending(distance_history_iter_t *p_iter, distance_history_sample_t *p_sample)
+{
+    if (p_iter->run_length > 0)
+    {
+        p_iter->run_length--;
+    }
+    else if (p_iter->num_small_steps > 0)
+    {
+        p_iter->delta_cm = (int32_t)(p_iter->small_steps % 3) - 1;
+        p_iter->small_steps /= 3;
+        p_iter->num_small_steps--;
+    }
+    else
+    {
+        return false;
+    }
+    p_iter->timestamp_ms += p_iter->dt_ms;
+    p_iter->distance_cm += (uint32_t)p_iter->delta_cm;
+    p_sample->timestamp_ms = p_iter->timestamp_ms;
+    p_sample->distance_cm = p_iter->distance_cm;
+    return true;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void distance_history_init(distance_history_t *p_history)
+{
+    p_history->magic = DISTANCE_HISTORY_MAGIC;
+    p_history->block_size = sizeof(distance_history_block_t);
+    p_history->num_blocks = DISTANCE_HISTORY_NUM_BLOCKS;
+    p_history->first_block = 0;
+    p_history->used_blocks = 0;
+    p_history->num_samples = 0;
+    p_history->run_length = 0;
+    p_history->num_small_steps = 0;
+    p_history->small_steps = 0;
+    p_history->timestamp_ms = 0;
+    p_history->distance_cm = 0;
+    p_history->dt_ms = 0;
+    p_history->delta_cm = 0;
+    p_history->last_timestamp_ms = 0;
+    p_history->last_distance_cm = 0;
+}
+
+void distance_history_add(distance_history_t *p_history, uint32_t timestamp_ms, uint32_t distance_cm)
+{
+    // The decoder starts from a sample at 0 ms and 0 cm, so the first sample is a step from it like any other
+    uint32_t dt_ms = timestamp_ms - p_history->last_timestamp_ms;
+    int32_t delta_cm = (int32_t)(distance_cm - p_history->last_distance_cm);
+    bool small_step = (dt_ms == p_history->dt_ms) && (delta_cm >= -1) && (delta_cm <= 1);
+    p_history->last_timestamp_ms = timestamp_ms;
+    p_history->last_distance_cm = distance_cm;
+    p_history->num_samples++;
+
+    if (p_history->num_small_steps > 0)
+    {
+        if (small_step)
+        {
+            static const uint16_t weights[] = {1, 3, 9};
+            p_history->small_steps += (uint16_t)((delta_cm + 1) * weights[p_history->num_small_steps++]);
+            if (p_history->num_small_steps == 3)
+            {
+                _write(p_history, ((uint64_t)p_history->small_steps << 2) | DISTANCE_HISTORY_KIND_SMALL_STEPS, 0, 3);
+                p_history->timestamp_ms = timestamp_ms;
+                p_history->distance_cm = distance_cm;
+                p_history->delta_cm = delta_cm;
+                p_history->num_small_steps = 0;
+                p_history->small_steps = 0;
+            }
+            return;
+        }
+        _flush_small_steps(p_history);
+    }
+    if ((dt_ms == p_history->dt_ms) && (delta_cm == p_history->delta_cm) && (p_history->run_length < DISTANCE_HISTORY_MAX_RUN))
+    {
+        p_history->run_length++;
+        return;
+    }
+    _flush_run(p_history);
+    if (small_step)
+    {
+        p_history->num_small_steps = 1;
+        p_history->small_steps = (uint16_t)(delta_cm + 1);
+    }
+    else
+    {
+        _write_step(p_history, dt_ms, delta_cm);
+    }
+}
+
+uint32_t distance_history_get_count(const distance_history_t *p_history)
+{
+    uint32_t count = p_history->run_length + p_history->num_small_steps;
+    for (uint32_t i = 0; i < p_history->used_blocks; i++)
+    {
+        count += p_history->blocks[_block_idx(p_history, i)].num_samples;
+    }
+    return count;
+}
+
+uint32_t distance_history_get_bytes_used(const distance_history_t *p_history)
+{
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < p_history->used_blocks; i++)
+    {
+        bytes += DISTANCE_HISTORY_BLOCK_HEADER_SIZE + p_history->blocks[_block_idx(p_history, i)].num_bytes;
+    }
+    return bytes;
+}
+
+void distance_history_iter_init(distance_history_iter_t *p_iter, const distance_history_t *p_history)
+{
+    p_iter->p_history = p_history;
+    p_iter->run_length = 0;
+    p_iter->num_small_steps = 0;
+    p_iter->small_steps = 0;
+    p_iter->pending_done = false;
+    p_iter->timestamp_ms = 0;
+    p_iter->distance_cm = 0;
+    p_iter->dt_ms = 0;
+    p_iter->delta_cm = 0;
+    _iter_load_block(p_iter, 0);
+}
+
+bool distance_history_iter_next(distance_history_iter_t *p_iter, distance_history_sample_t *p_sample)
+{
+    const distance_history_t *p_history = p_iter->p_history;
+    if (_iter_next_pending(p_iter, p_sample))
+    {
+        return true;
+    }
+    while (p_iter->block < p_history->used_blocks)
+    {
+        const distance_history_block_t *p_block = &p_history->blocks[_block_idx(p_history, p_iter->block)];
+        if (p_iter->offset >= p_block->num_bytes)
+        {
+            _iter_load_block(p_iter, p_iter->block + 1);
+            continue;
+        }
+        uint64_t token;
+        if (!_get_varint(p_block, &p_iter->offset, &token))
+        {
+            return false;
+        }
+        uint64_t payload = token >> 2;
+        switch (token & 3)
+        {
+        case DISTANCE_HISTORY_KIND_STEP_TIME:
+        {
+            uint64_t dt_ms;
+            if (!_get_varint(p_block, &p_iter->offset, &dt_ms))
+            {
+                return false;
+            }
+            p_iter->dt_ms = (uint32_t)dt_ms;
+        }
+            // fall through
+        case DISTANCE_HISTORY_KIND_STEP:
+            p_iter->delta_cm = _unzigzag((uint32_t)payload);
+            p_iter->run_length = 1;
+            break;
+        case DISTANCE_HISTORY_KIND_RUN:
+            if ((payload == 0) || (payload > DISTANCE_HISTORY_MAX_RUN))
+            {
+                return false;
+            }
+            p_iter->run_length = (uint32_t)payload;
+            break;
+        default:
+            if (payload >= 27)
+            {
+                return false;
+            }
+            p_iter->num_small_steps = 3;
+            p_iter->small_steps = (uint32_t)payload;
+            break;
+        }
+        return _iter_next_pending(p_iter, p_sample);
+    }
+    // The samples that are not in a block yet
+    if (!p_iter->pending_done)
+    {
+        p_iter->pending_done = true;
+        p_iter->run_length = p_history->run_length;
+        p_iter->num_small_steps = p_history->num_small_steps;
+        p_iter->small_steps = p_history->small_steps;
+        return _iter_next_pending(p_iter, p_sample);
+    }
+    return false;
+}
+bool distance_history_save(const distance_history_t *p_history, const char *p_path)
+{
+    FILE *p_file = fopen(p_path, "wb");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    size_t size = DISTANCE_HISTORY_HEADER_SIZE + (size_t)p_history->num_blocks * sizeof(distance_history_block_t);
+    bool ok = fwrite(p_history, 1, size, p_file) == size;
+    return (fclose(p_file) == 0) && ok;
+}
+
+bool distance_history_load(distance_history_t *p_history, const char *p_path)
+{
+    FILE *p_file = fopen(p_path, "rb");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    // The header of the file is read in place and the newest blocks that fit are then copied from the oldest one, to the beginning of the buffer
+    bool ok = (fread(p_history, 1, DISTANCE_HISTORY_HEADER_SIZE, p_file) == DISTANCE_HISTORY_HEADER_SIZE) &&
+              (p_history->magic == DISTANCE_HISTORY_MAGIC) && (p_history->block_size == sizeof(distance_history_block_t)) &&
+              (p_history->num_blocks > 0) && (p_history->first_block < p_history->num_blocks) && (p_history->used_blocks <= p_history->num_blocks);
+    uint32_t file_num_blocks = ok ? p_history->num_blocks : 0;
+    uint32_t count = ok ? p_history->used_blocks : 0;
+    uint32_t oldest_block = ok ? p_history->first_block : 0;
+    if (count > DISTANCE_HISTORY_NUM_BLOCKS)
+    {
+        oldest_block += count - DISTANCE_HISTORY_NUM_BLOCKS;
+        count = DISTANCE_HISTORY_NUM_BLOCKS;
+    }
+
+    p_history->num_blocks = DISTANCE_HISTORY_NUM_BLOCKS;
+    p_history->first_block = 0;
+    p_history->used_blocks = 0;
+    for (uint32_t i = 0; ok && i < count; i++)
+    {
+        long offset = (long)(DISTANCE_HISTORY_HEADER_SIZE + ((oldest_block + i) % file_num_blocks) * sizeof(distance_history_block_t));
+        distance_history_block_t *p_block = &p_history->blocks[i];
+        ok = (fseek(p_file, offset, SEEK_SET) == 0) && (fread(p_block, sizeof(*p_block), 1, p_file) == 1) &&
+             (p_block->num_bytes <= DISTANCE_HISTORY_BLOCK_DATA_SIZE);
+        p_history->used_blocks += ok ? 1 : 0;
+    }
+    fclose(p_file);
+    return ok;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file echo_trace.c
+ * @brief Trace of the raw timings of the echoes of the ultrasound sensors.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stddef.h>
+
+/* Project includes */
+#include "echo_trace.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define ECHO_TRACE_HEADER_SIZE offsetof(echo_trace_t, records) /*!< Size of the header of a trace, in bytes */
+
+/* Public functions -----------------------------------------------------------*/
+void echo_trace_init(echo_trace_t *p_trace)
+{
+    p_trace->magic = ECHO_TRACE_MAGIC;
+    p_trace->record_size = sizeof(echo_trace_record_t);
+    p_trace->max_records = ECHO_TRACE_MAX_RECORDS;
+    p_trace->next_idx = 0;
+    p_trace->num_echoes = 0;
+}
+
+void echo_trace_add(echo_trace_t *p_trace, const echo_trace_record_t *p_record)
+{
+    p_trace->records[p_trace->next_idx] = *p_record;
+    p_trace->next_idx = (p_trace->next_idx + 1) % ECHO_TRACE_MAX_RECORDS;
+    p_trace->num_echoes++;
+}
+
+uint32_t echo_trace_get_count(const echo_trace_t *p_trace)
+{
+    return (p_trace->num_echoes < p_trace->max_records) ? p_trace->num_echoes : p_trace->max_records;
+}
+
+const echo_trace_record_t *echo_trace_get_record(const echo_trace_t *p_trace, uint32_t idx)
+{
+    uint32_t count = echo_trace_get_count(p_trace);
+    if (idx >= count)
+    {
+        return NULL;
+    }
+    // Once the buffer is full, the oldest record is the one that will be overwritten next
+    uint32_t oldest_idx = (p_trace->num_echoes > p_trace->max_records) ? p_trace->next_idx : 0;
+    return &p_trace->records[(oldest_idx + idx) % p_trace->max_records];
+}
+
+bool echo_trace_save(const echo_trace_t *p_trace, const char *p_path)
+{
+    FILE *p_file = fopen(p_path, "wb");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    size_t size = ECHO_TRACE_HEADER_SIZE + (size_t)p_trace->max_records * sizeof(echo_trace_record_t);
+    bool ok = fwrite(p_trace, 1, size, p_file) == size;
+    return (fclose(p_file) == 0) && ok;
+}
+
+bool echo_trace_load(echo_trace_t *p_trace, const char *p_path)
+{
+    FILE *p_file = fopen(p_path, "rb");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    // The header of the file is read in place and the records are then replayed into the trace, from the oldest to the newest one
+    bool ok = (fread(p_trace, 1, ECHO_TRACE_HEADER_SIZE, p_file) == ECHO_TRACE_HEADER_SIZE) &&
+              (p_trace->magic == ECHO_TRACE_MAGIC) && (p_trace->record_size == sizeof(echo_trace_record_t)) &&
+              (p_trace->max_records > 0) && (p_trace->next_idx < p_trace->max_records);
+    uint32_t file_max_records = ok ? p_trace->max_records : 0;
+    uint32_t count = ok ? echo_trace_get_count(p_trace) : 0;
+    uint32_t oldest_idx = (ok && p_trace->num_echoes > file_max_records) ? p_trace->next_idx : 0;
+
+    echo_trace_init(p_trace);
+    for (uint32_t i = 0; ok && i < count; i++)
+    {
+        echo_trace_record_t record;
+        long offset = (long)(ECHO_TRACE_HEADER_SIZE + ((oldest_idx + i) % file_max_records) * sizeof(echo_trace_record_t));
+        ok = (fseek(p_file, offset, SEEK_SET) == 0) && (fread(&record, sizeof(record), 1, p_file) == 1);
+        if (ok)
+        {
+            echo_trace_add(p_trace, &record);
+        }
+    }
+    fclose(p_file);
+    return ok;
+}
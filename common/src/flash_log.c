@@ -0,0 +1,432 @@
+/**
+ * @file flash_log.c
+ * @brief Wear-levelled, append-only log of records in the non-volatile storage.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_storage.h"
+
+/* Other includes */
+#include "flash_log.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define FLASH_LOG_CHECK_SEED 0xA5 /*!< Seed of the check byte of the header of a record, so that an erased header is never valid */
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief Table of the CRC-32 (IEEE 802.3, reflected) for a nibble, to keep the table small.
+ */
+static const uint32_t crc32_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Updates a CRC-32 with some bytes.
+ *
+ * @param crc CRC of the previous bytes (`0xFFFFFFFF` before the first one).
+ * @param p_data Pointer to the bytes.
+ * @param length Number of bytes.
+ *
+ * @return uint32_t CRC of the bytes so far. The final CRC is its complement.
+ */
+static uint32_t _crc32_update(uint32_t crc, const void *p_data, uint32_t length)
+{
+    const uint8_t *p_bytes = (const uint8_t *)p_data;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        crc ^= p_bytes[i];
+        crc = (crc >> 4) ^ crc32_table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_table[crc & 0x0F];
+    }
+    return crc;
+}
+
+/**
+ * @brief Returns the header word of a record.
+ *
+ * @param length Length of the payload, in bytes.
+ * @param type Type of the record.
+ *
+ * @return uint32_t Length in the low half-word, type in the third byte and check byte in the fourth one.
+ */
+static uint32_t _record_header(uint32_t length, uint8_t type)
+{
+    uint8_t check = (uint8_t)((length & 0xFF) ^ (length >> 8) ^ type ^ FLASH_LOG_CHECK_SEED);
+    return (length & 0xFFFF) | ((uint32_t)type << 16) | ((uint32_t)check << 24);
+}
+
+/**
+ * @brief Returns the size of a record in the storage.
+ *
+ * @param length Length of the payload, in bytes.
+ *
+ * @return uint32_t Size of the header and the payload padded to a whole word, in bytes.
+ */
+static uint32_t _record_size(uint32_t length)
+{
+    return FLASH_LOG_RECORD_HEADER_SIZE + ((length + 3) & ~3U);
+}
+
+/**
+ * @brief Checks whether a word read at the head of a sector is the header of a complete record.
+ *
+ * @param p_log Pointer to the log.
+ * @param header Word read.
+ * @param offset Offset of the word in the sector.
+ *
+ * @return `true` if the check byte matches and the record fits in the sector, `false` otherwise.
+ */
+static bool _record_header_is_valid(const flash_log_t *p_log, uint32_t header, uint32_t offset)
+{
+    uint32_t length = header & 0xFFFF;
+    return (header == _record_header(length, (uint8_t)(header >> 16))) && (length <= FLASH_LOG_MAX_PAYLOAD) && (offset + _record_size(length) <= p_log->sector_size);
+}
+
+/**
+ * @brief Returns the CRC-32 of a record.
+ *
+ * @param header Header word of the record.
+ * @param p_payload Pointer to the payload.
+ * @param length Length of the payload, in bytes.
+ *
+ * @return uint32_t CRC of the header word and the payload.
+ */
+static uint32_t _record_crc(uint32_t header, const void *p_payload, uint32_t length)
+{
+    uint32_t crc = _crc32_update(0xFFFFFFFF, &header, sizeof(header));
+    return ~_crc32_update(crc, p_payload, length);
+}
+
+/**
+ * @brief Reads the header of a sector.
+ *
+ * @param sector Index of the sector.
+ * @param p_sequence Pointer to the sequence number of the sector.
+ * @param p_erase_count Pointer to the number of erases of the sector.
+ *
+ * @return `true` if the header is valid, `false` otherwise.
+ */
+static bool _read_sector_header(uint32_t sector, uint32_t *p_sequence, uint32_t *p_erase_count)
+{
+    uint32_t header[FLASH_LOG_SECTOR_HEADER_SIZE / sizeof(uint32_t)];
+    port_storage_read(sector, 0, header, FLASH_LOG_SECTOR_HEADER_SIZE / sizeof(uint32_t));
+    if (header[0] != FLASH_LOG_MAGIC || header[3] != ~_crc32_update(0xFFFFFFFF, header, 3 * sizeof(uint32_t)))
+    {
+        return false;
+    }
+    *p_sequence = header[1];
+    *p_erase_count = header[2];
+    return true;
+}
+
+/**
+ * @brief Erases a sector, writes its header and makes it the active sector.
+ *
+ * @param p_log Pointer to the log.
+ * @param sector Index of the sector.
+ * @param sequence Sequence number of the sector.
+ *
+ * @return `true` if the sector is ready, `false` if the storage failed.
+ */
+static bool _start_sector(flash_log_t *p_log, uint32_t sector, uint32_t sequence)
+{
+    uint32_t old_sequence;
+    uint32_t erase_count = 0;
+    _read_sector_header(sector, &old_sequence, &erase_count);
+
+    uint32_t header[FLASH_LOG_SECTOR_HEADER_SIZE / sizeof(uint32_t)] = {FLASH_LOG_MAGIC, sequence, erase_count + 1, 0};
+    header[3] = ~_crc32_update(0xFFFFFFFF, header, 3 * sizeof(uint32_t));
+    if (!port_storage_erase(sector) || !port_storage_program(sector, 0, header, FLASH_LOG_SECTOR_HEADER_SIZE / sizeof(uint32_t)))
+    {
+        return false;
+    }
+    p_log->sector = sector;
+    p_log->sequence = sequence;
+    p_log->offset = FLASH_LOG_SECTOR_HEADER_SIZE;
+    p_log->rotate_pending = false;
+    return true;
+}
+
+/**
+ * @brief Finds the write head of the active sector by following the lengths of its records. The sector is full if the head is not followed by an erased word.
+ *
+ * @param p_log Pointer to the log.
+ */
+static void _recover_head(flash_log_t *p_log)
+{
+    uint32_t offset = FLASH_LOG_SECTOR_HEADER_SIZE;
+    while (offset + FLASH_LOG_RECORD_HEADER_SIZE <= p_log->sector_size)
+    {
+        uint32_t header;
+        port_storage_read(p_log->sector, offset, &header, 1);
+        if (header == PORT_STORAGE_ERASED_WORD)
+        {
+            p_log->offset = offset;
+            p_log->rotate_pending = false;
+            return;
+        }
+        if (!_record_header_is_valid(p_log, header, offset))
+        {
+            break; // Torn or corrupt header: the length of the record cannot be trusted
+        }
+        offset += _record_size(header & 0xFFFF);
+    }
+    p_log->offset = offset;
+    p_log->rotate_pending = true;
+}
+
+/**
+ * @brief Drops the records of the batch.
+ *
+ * @param p_log Pointer to the log.
+ */
+static void _drop_batch(flash_log_t *p_log)
+{
+    p_log->num_dropped += p_log->batch_records;
+    p_log->batch_bytes = 0;
+    p_log->batch_records = 0;
+}
+
+/**
+ * @brief Moves a reader to the next sector.
+ *
+ * @param p_iter Pointer to the reader.
+ */
+static void _iter_next_sector(flash_log_iter_t *p_iter)
+{
+    p_iter->sector = (p_iter->sector + 1) % p_iter->p_log->num_sectors;
+    p_iter->offset = 0;
+}
+
+/* Public functions -----------------------------------------------------------*/
+bool flash_log_init(flash_log_t *p_log)
+{
+    memset(p_log, 0, sizeof(*p_log));
+    p_log->erase_allowed = true;
+    if (!port_storage_init())
+    {
+        return false;
+    }
+    p_log->num_sectors = port_storage_get_num_sectors();
+    p_log->sector_size = port_storage_get_sector_size();
+    if (p_log->num_sectors < 2 || p_log->sector_size < FLASH_LOG_SECTOR_HEADER_SIZE + FLASH_LOG_BATCH_SIZE)
+    {
+        return false;
+    }
+
+    // The active sector is the one written last, even if the sequence numbers have wrapped around
+    bool found = false;
+    for (uint32_t sector = 0; sector < p_log->num_sectors; sector++)
+    {
+        uint32_t sequence;
+        uint32_t erase_count;
+        if (_read_sector_header(sector, &sequence, &erase_count) && (!found || (int32_t)(sequence - p_log->sequence) > 0))
+        {
+            found = true;
+            p_log->sector = sector;
+            p_log->sequence = sequence;
+        }
+    }
+    if (!found)
+    {
+        return _start_sector(p_log, 0, 1);
+    }
+    _recover_head(p_log);
+    return true;
+}
+
+bool flash_log_format(flash_log_t *p_log)
+{
+    _drop_batch(p_log);
+    // The other sectors get older sequence numbers than the first one, so that their number of erases is kept
+    for (uint32_t sector = 1; sector < p_log->num_sectors; sector++)
+    {
+        if (!_start_sector(p_log, sector, sector))
+        {
+            return false;
+        }
+    }
+    return _start_sector(p_log, 0, p_log->num_sectors);
+}
+
+bool flash_log_append(flash_log_t *p_log, uint8_t type, const void *p_payload, uint32_t length)
+{
+    if (length > FLASH_LOG_MAX_PAYLOAD)
+    {
+        p_log->num_dropped++;
+        return false;
+    }
+    uint32_t size = _record_size(length);
+    uint32_t base = p_log->rotate_pending ? FLASH_LOG_SECTOR_HEADER_SIZE : p_log->offset;
+    if ((p_log->batch_bytes + size > FLASH_LOG_BATCH_SIZE) || (base + p_log->batch_bytes + size > p_log->sector_size))
+    {
+        if (!flash_log_flush(p_log))
+        {
+            p_log->num_dropped++;
+            return false;
+        }
+    }
+    if (!p_log->rotate_pending && (p_log->offset + size > p_log->sector_size))
+    {
+        p_log->rotate_pending = true;
+    }
+
+    uint32_t *p_words = &p_log->batch[p_log->batch_bytes / sizeof(uint32_t)];
+    uint8_t *p_data = (uint8_t *)&p_words[FLASH_LOG_RECORD_HEADER_SIZE / sizeof(uint32_t)];
+    memset(p_data, 0, size - FLASH_LOG_RECORD_HEADER_SIZE);
+    memcpy(p_data, p_payload, length);
+    p_words[0] = _record_header(length, type);
+    p_words[1] = _record_crc(p_words[0], p_data, length);
+
+    p_log->batch_bytes += size;
+    p_log->batch_records++;
+    p_log->num_appended++;
+    return true;
+}
+
+bool flash_log_flush(flash_log_t *p_log)
+{
+    if (p_log->batch_bytes == 0)
+    {
+        return true;
+    }
+    if (p_log->rotate_pending)
+    {
+        if (!p_log->erase_allowed)
+        {
+            return false; // The batch is held until the sector can be erased
+        }
+        if (!_start_sector(p_log, (p_log->sector + 1) % p_log->num_sectors, p_log->sequence + 1))
+        {
+            _drop_batch(p_log);
+            return false;
+        }
+        p_log->num_rotations++;
+    }
+
+    bool ok = port_storage_program(p_log->sector, p_log->offset, p_log->batch, p_log->batch_bytes / sizeof(uint32_t));
+    p_log->offset += p_log->batch_bytes;
+    if (!ok)
+    {
+        // The sector may be left with a torn record: continue in the next one
+        p_log->rotate_pending = true;
+        _drop_batch(p_log);
+        return false;
+    }
+    p_log->batch_bytes = 0;
+    p_log->batch_records = 0;
+    p_log->num_flushes++;
+    return true;
+}
+
+void flash_log_set_erase_allowed(flash_log_t *p_log, bool allowed)
+{
+    p_log->erase_allowed = allowed;
+}
+
+bool flash_log_prepare(flash_log_t *p_log)
+{
+    bool erase_allowed = p_log->erase_allowed;
+    p_log->erase_allowed = true;
+    bool ok = flash_log_flush(p_log);
+    if (ok && (p_log->rotate_pending || (p_log->sector_size - p_log->offset < p_log->sector_size / 2)))
+    {
+        ok = _start_sector(p_log, (p_log->sector + 1) % p_log->num_sectors, p_log->sequence + 1);
+        if (ok)
+        {
+            p_log->num_rotations++;
+        }
+        else
+        {
+            p_log->rotate_pending = true;
+        }
+    }
+    p_log->erase_allowed = erase_allowed;
+    return ok;
+}
+
+uint32_t flash_log_get_pending_bytes(const flash_log_t *p_log)
+{
+    return p_log->batch_bytes;
+}
+
+uint32_t flash_log_get_erase_count(const flash_log_t *p_log, uint32_t sector)
+{
+    uint32_t sequence;
+    uint32_t erase_count;
+    if (sector >= p_log->num_sectors || !_read_sector_header(sector, &sequence, &erase_count))
+    {
+        return 0;
+    }
+    return erase_count;
+}
+
+void flash_log_iter_init(flash_log_iter_t *p_iter, const flash_log_t *p_log)
+{
+    memset(p_iter, 0, sizeof(*p_iter));
+    p_iter->p_log = p_log;
+    p_iter->sector = (p_log->sector + 1) % p_log->num_sectors; // The sectors are written in turn, so the oldest one follows the active one
+}
+
+bool flash_log_iter_next(flash_log_iter_t *p_iter, flash_log_record_t *p_record)
+{
+    const flash_log_t *p_log = p_iter->p_log;
+    while (true)
+    {
+        if (p_iter->offset == 0)
+        {
+            if (p_iter->num_sectors_read >= p_log->num_sectors)
+            {
+                return false;
+            }
+            p_iter->num_sectors_read++;
+
+            // Only sectors newer than the previous one and not newer than the active one belong to the log
+            uint32_t sequence;
+            uint32_t erase_count;
+            if (!_read_sector_header(p_iter->sector, &sequence, &erase_count) ||
+                (p_iter->num_sectors_read > 1 && (int32_t)(sequence - p_iter->sequence) <= 0) ||
+                (int32_t)(p_log->sequence - sequence) < 0)
+            {
+                _iter_next_sector(p_iter);
+                continue;
+            }
+            p_iter->sequence = sequence;
+            p_iter->offset = FLASH_LOG_SECTOR_HEADER_SIZE;
+        }
+
+        uint32_t header[FLASH_LOG_RECORD_HEADER_SIZE / sizeof(uint32_t)];
+        if (p_iter->offset + FLASH_LOG_RECORD_HEADER_SIZE > p_log->sector_size)
+        {
+            _iter_next_sector(p_iter);
+            continue;
+        }
+        port_storage_read(p_iter->sector, p_iter->offset, header, FLASH_LOG_RECORD_HEADER_SIZE / sizeof(uint32_t));
+        if (header[0] == PORT_STORAGE_ERASED_WORD || !_record_header_is_valid(p_log, header[0], p_iter->offset))
+        {
+            _iter_next_sector(p_iter);
+            continue;
+        }
+
+        uint32_t length = header[0] & 0xFFFF;
+        port_storage_read(p_iter->sector, p_iter->offset + FLASH_LOG_RECORD_HEADER_SIZE, p_record->payload, (length + 3) / sizeof(uint32_t));
+        p_iter->offset += _record_size(length);
+        if (header[1] != _record_crc(header[0], p_record->payload, length))
+        {
+            p_iter->num_corrupt++;
+            continue;
+        }
+        p_record->type = (uint8_t)(header[0] >> 16);
+        p_record->length = (uint16_t)length;
+        p_record->sequence = p_iter->sequence;
+        return true;
+    }
+}
@@ -28,8 +28,22 @@ struct fsm_button_t
     uint32_t debounce_time; /*!< Debounce time in milliseconds */
     uint32_t next_timeout; /*!< Next timeout value in milliseconds */
     uint32_t tick_pressed; /*!< Timestamp when the button was pressed */
+    uint32_t tick_released; /*!< Timestamp when the button was released */
+    uint32_t edge_pressed_us; /*!< Time of the press edge in microseconds, captured by the port */
     uint32_t duration; /*!< Duration the button was pressed in milliseconds */
     uint32_t button_id; /*!< ID of the button */
+    uint32_t long_press_ms; /*!< Time in milliseconds a press must last to be a long press */
+    uint32_t double_click_ms; /*!< Maximum time in milliseconds between a click and the next press to make a double click */
+    uint32_t repeat_ms; /*!< Period in milliseconds of the hold-repeat gestures */
+    uint32_t next_hold_ms; /*!< Timestamp of the next long press or hold-repeat gesture */
+    bool long_press_sent; /*!< Flag to indicate that the current press has been reported as a long press */
+    bool click_pending; /*!< Flag to indicate that a click is waiting for the double-click time */
+    uint32_t click_ms; /*!< Timestamp of the release of the pending click */
+    uint32_t click_duration; /*!< Duration of the pending click in milliseconds */
+    fsm_button_event_t events[FSM_BUTTON_EVENT_QUEUE_SIZE]; /*!< Queue of gestures not consumed yet */
+    uint8_t event_head; /*!< Index of the oldest gesture of the queue */
+    uint8_t event_count; /*!< Number of gestures of the queue */
+    transition_trace_t *p_transition_trace; /*!< Trace of the changes of state (NULL if they are not recorded) */
 };
 
 
@@ -71,31 +85,55 @@ static bool check_timeout(fsm_t *p_this)
     return port_system_get_millis()>= p_fsm->next_timeout;
 }
 
+/**
+ * @brief Converts the time of an edge captured by the port into the millisecond time base. The microsecond time wraps around much earlier than the millisecond one, so the age of the edge is used. An edge that looks newer than the current time is taken as current, and an edge older than the start of the system as the start.
+ * @param edge_us Time of the edge in microseconds.
+ * @return Time of the edge in milliseconds.
+ */
+
+static uint32_t _edge_to_millis(uint32_t edge_us)
+{
+    uint32_t age_us = port_system_get_micros() - edge_us;
+    uint32_t now_ms = port_system_get_millis();
+    if ((int32_t)age_us < 0)
+    {
+        age_us = 0;
+    }
+    if (age_us / 1000 > now_ms)
+    {
+        return 0;
+    }
+    return now_ms - age_us / 1000;
+}
+
 /* State machine output or action functions */
 
 /**
- * @brief Stores the timestamp when the button was pressed.
+ * @brief Stores the timestamp when the button was pressed, taken at the edge instead of at the fire.
  * @param p_this Pointer to the FSM instance.
  */
 
 static void do_store_tick_pressed(fsm_t *p_this)
 {
     fsm_button_t *p_fsm = (fsm_button_t *)(p_this);
-    p_fsm->tick_pressed = port_system_get_millis();
+    p_fsm->edge_pressed_us = port_button_get_edge_time_us(p_fsm->button_id);
+    p_fsm->tick_pressed = _edge_to_millis(p_fsm->edge_pressed_us);
     p_fsm->next_timeout = p_fsm->tick_pressed + p_fsm->debounce_time;
 }
 
 /**
- * @brief Sets the duration the button was pressed.
+ * @brief Sets the duration the button was pressed, from the press and release edges.
  * @param p_this Pointer to the FSM instance.
  */
 
 static void do_set_duration(fsm_t *p_this)
 {
     fsm_button_t *p_fsm = (fsm_button_t *)(p_this);
-    uint32_t current_tick = port_system_get_millis();
-    p_fsm->duration = current_tick - p_fsm->tick_pressed;
-    p_fsm->next_timeout = current_tick + p_fsm->debounce_time;
+    uint32_t edge_released_us = port_button_get_edge_time_us(p_fsm->button_id);
+    uint32_t duration_us = edge_released_us - p_fsm->edge_pressed_us;
+    p_fsm->duration = ((int32_t)duration_us < 0) ? 0 : duration_us / 1000;
+    p_fsm->tick_released = _edge_to_millis(edge_released_us);
+    p_fsm->next_timeout = p_fsm->tick_released + p_fsm->debounce_time;
 }
 
 /**
@@ -113,6 +151,98 @@ static fsm_trans_t fsm_trans_button[] = {
 
 /* Other auxiliary functions */
 
+/**
+ * @brief Pushes a gesture into the queue. The gesture is lost if the queue is full.
+ * @param p_fsm Pointer to the Button FSM instance.
+ * @param gesture Gesture (see `FSM_BUTTON_GESTURES`).
+ * @param timestamp_ms Timestamp of the gesture in milliseconds.
+ * @param duration_ms Duration of the press in milliseconds.
+ */
+
+static void _push_event(fsm_button_t *p_fsm, uint8_t gesture, uint32_t timestamp_ms, uint32_t duration_ms)
+{
+    if (p_fsm->event_count == FSM_BUTTON_EVENT_QUEUE_SIZE)
+    {
+        return;
+    }
+    fsm_button_event_t *p_event = &p_fsm->events[(p_fsm->event_head + p_fsm->event_count) % FSM_BUTTON_EVENT_QUEUE_SIZE];
+    p_event->gesture = gesture;
+    p_event->timestamp_ms = timestamp_ms;
+    p_event->duration_ms = duration_ms;
+    p_fsm->event_count++;
+}
+
+/**
+ * @brief Classifies the gestures from the debounced presses and releases of the last fire.
+ * @param p_fsm Pointer to the Button FSM instance.
+ * @param prev_state State of the FSM before the last fire.
+ */
+
+static void _update_gestures(fsm_button_t *p_fsm, uint32_t prev_state)
+{
+    uint32_t state = p_fsm->f.current_state;
+    uint32_t now = port_system_get_millis();
+
+    // A pending click followed by no press within the double-click time is a click
+    if (p_fsm->click_pending && (state == BUTTON_RELEASED || state == BUTTON_RELEASED_WAIT) && (now - p_fsm->click_ms) >= p_fsm->double_click_ms)
+    {
+        _push_event(p_fsm, FSM_BUTTON_GESTURE_CLICK, now, p_fsm->click_duration);
+        p_fsm->click_pending = false;
+    }
+
+    if ((prev_state == BUTTON_PRESSED_WAIT) && (state == BUTTON_PRESSED))
+    {
+        // A press started too late to complete a double click
+        if (p_fsm->click_pending && (p_fsm->tick_pressed - p_fsm->click_ms) > p_fsm->double_click_ms)
+        {
+            _push_event(p_fsm, FSM_BUTTON_GESTURE_CLICK, now, p_fsm->click_duration);
+            p_fsm->click_pending = false;
+        }
+        p_fsm->long_press_sent = false;
+        p_fsm->next_hold_ms = p_fsm->tick_pressed + p_fsm->long_press_ms;
+    }
+
+    bool hold_enabled = (p_fsm->long_press_ms > 0) && (!p_fsm->long_press_sent || (p_fsm->repeat_ms > 0));
+    if ((state == BUTTON_PRESSED) && hold_enabled && ((int32_t)(now - p_fsm->next_hold_ms) >= 0))
+    {
+        if (!p_fsm->long_press_sent)
+        {
+            // The first press of a double click that ends in a long press was a click
+            if (p_fsm->click_pending)
+            {
+                _push_event(p_fsm, FSM_BUTTON_GESTURE_CLICK, now, p_fsm->click_duration);
+                p_fsm->click_pending = false;
+            }
+            _push_event(p_fsm, FSM_BUTTON_GESTURE_LONG_PRESS, now, now - p_fsm->tick_pressed);
+            p_fsm->long_press_sent = true;
+        }
+        else
+        {
+            _push_event(p_fsm, FSM_BUTTON_GESTURE_HOLD_REPEAT, now, now - p_fsm->tick_pressed);
+        }
+        p_fsm->next_hold_ms += p_fsm->repeat_ms;
+    }
+
+    if ((prev_state == BUTTON_PRESSED) && (state == BUTTON_RELEASED_WAIT) && !p_fsm->long_press_sent)
+    {
+        if (p_fsm->click_pending)
+        {
+            _push_event(p_fsm, FSM_BUTTON_GESTURE_DOUBLE_CLICK, now, p_fsm->duration);
+            p_fsm->click_pending = false;
+        }
+        else if (p_fsm->double_click_ms == 0)
+        {
+            _push_event(p_fsm, FSM_BUTTON_GESTURE_CLICK, now, p_fsm->duration);
+        }
+        else
+        {
+            p_fsm->click_pending = true;
+            p_fsm->click_ms = p_fsm->tick_released;
+            p_fsm->click_duration = p_fsm->duration;
+        }
+    }
+}
+
 /**
  * @brief Initializes the Button FSM.
  * @param p_fsm_button Pointer to the Button FSM instance.
@@ -128,7 +258,15 @@ void fsm_button_init(fsm_button_t *p_fsm_button, uint32_t debounce_time, uint32_
     p_fsm_button->debounce_time = debounce_time;
     p_fsm_button->button_id = button_id;
     p_fsm_button->tick_pressed = 0;
+    p_fsm_button->tick_released = 0;
+    p_fsm_button->edge_pressed_us = 0;
     p_fsm_button->duration = 0;
+    p_fsm_button->long_press_sent = false;
+    p_fsm_button->click_pending = false;
+    p_fsm_button->event_head = 0;
+    p_fsm_button->event_count = 0;
+    p_fsm_button->p_transition_trace = NULL;
+    fsm_button_set_gesture_times(p_fsm_button, FSM_BUTTON_DEFAULT_LONG_PRESS_MS, FSM_BUTTON_DEFAULT_DOUBLE_CLICK_MS, FSM_BUTTON_DEFAULT_REPEAT_MS);
     port_button_init(button_id);
 }
 
@@ -146,7 +284,13 @@ fsm_button_t *fsm_button_new(uint32_t debounce_time, uint32_t button_id)
 
 void fsm_button_fire(fsm_button_t *p_fsm)
 {
+    uint32_t prev_state = p_fsm->f.current_state;
     fsm_fire(&p_fsm->f); // Is it also possible to it in this way: fsm_fire((fsm_t *)p_fsm);
+    if ((p_fsm->p_transition_trace != NULL) && (p_fsm->f.current_state != (int)prev_state))
+    {
+        transition_trace_add(p_fsm->p_transition_trace, port_system_get_millis(), TRANSITION_TRACE_ID(TRANSITION_TRACE_FSM_BUTTON, p_fsm->button_id), (uint8_t)prev_state, (uint8_t)p_fsm->f.current_state);
+    }
+    _update_gestures(p_fsm, prev_state);
 }
 
 
@@ -193,5 +337,43 @@ uint32_t fsm_button_get_debounce_time_ms(fsm_button_t *p_fsm)
 
 bool fsm_button_check_activity(fsm_button_t *p_fsm)
 {
-    return !(p_fsm->f.current_state == BUTTON_RELEASED);
+    return !(p_fsm->f.current_state == BUTTON_RELEASED) || p_fsm->click_pending || (p_fsm->event_count > 0);
+}
+
+
+
+void fsm_button_set_gesture_times(fsm_button_t *p_fsm, uint32_t long_press_ms, uint32_t double_click_ms, uint32_t repeat_ms)
+{
+    p_fsm->long_press_ms = long_press_ms;
+    p_fsm->double_click_ms = double_click_ms;
+    p_fsm->repeat_ms = repeat_ms;
+}
+
+
+
+const fsm_button_event_t *fsm_button_peek_event(fsm_button_t *p_fsm)
+{
+    return (p_fsm->event_count > 0) ? &p_fsm->events[p_fsm->event_head] : NULL;
+}
+
+
+
+bool fsm_button_get_event(fsm_button_t *p_fsm, fsm_button_event_t *p_event)
+{
+    if (p_fsm->event_count == 0)
+    {
+        return false;
+    }
+    if (p_event != NULL)
+    {
+        *p_event = p_fsm->events[p_fsm->event_head];
+    }
+    p_fsm->event_head = (p_fsm->event_head + 1) % FSM_BUTTON_EVENT_QUEUE_SIZE;
+    p_fsm->event_count--;
+    return true;
+}
+
+void fsm_button_set_transition_trace(fsm_button_t *p_fsm, transition_trace_t *p_trace)
+{
+    p_fsm->p_transition_trace = p_trace;
 }
\ No newline at end of file
@@ -0,0 +1,287 @@
+/**
+ * @file fsm_buzzer.c
+ * @brief Buzzer FSM main file.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+
+#include <stdlib.h>
+
+/* HW dependent includes */
+
+#include "port_buzzer.h"
+#include "port_system.h"
+
+/* Project includes */
+
+#include "fsm.h"
+#include "fsm_display.h"
+#include "fsm_buzzer.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+
+/**
+ * @brief Structure representing the FSM for the buzzer.
+ */
+
+struct fsm_buzzer_t
+{
+    fsm_t f;                /**< Base FSM structure. */
+    uint32_t distance_cm;   /**< Distance in centimeters. */
+    bool new_distance;      /**< Flag indicating if a new distance is set. */
+    bool status;            /**< Status of the FSM (active or paused). */
+    uint32_t period_ms;     /**< Beep period currently programmed in the buzzer. */
+    uint32_t on_ms;         /**< Beep duration currently programmed in the buzzer. */
+    uint32_t buzzer_id;     /**< ID of the associated buzzer. */
+    transition_trace_t *p_transition_trace; /**< Trace of the changes of state (NULL if they are not recorded). */
+    fsm_display_t *p_display; /**< Display whose band table gives the beep period of the distances (NULL for the default band table). */
+};
+
+/* Private functions -----------------------------------------------------------*/
+
+/**
+ * @brief Computes the beep cadence based on the band of the distance, using the same band table as the display.
+ *
+ * @param p_period_ms Pointer to store the beep period in milliseconds.
+ * @param p_on_ms Pointer to store the beep duration in milliseconds. 0 means silent.
+ * @param p_band Pointer to the band that contains the distance, or NULL if it is out of range.
+ */
+
+static void _compute_buzzer_cadence(uint32_t *p_period_ms, uint32_t *p_on_ms, const fsm_display_band_t *p_band)
+{
+    if ((p_band == NULL) || (p_band->beep_period_ms == FSM_DISPLAY_BEEP_SILENT))
+    {
+        *p_period_ms = 0;
+        *p_on_ms = 0;
+        return;
+    }
+
+    uint32_t period_ms = p_band->beep_period_ms;
+    if (period_ms == 0)
+    {
+        // Continuous tone
+        *p_period_ms = FSM_BUZZER_BEEP_MS;
+        *p_on_ms = FSM_BUZZER_BEEP_MS;
+    }
+    else
+    {
+        *p_period_ms = period_ms;
+        *p_on_ms = FSM_BUZZER_BEEP_MS;
+    }
+}
+
+/* State machine input or transition functions */
+
+/**
+ * @brief Checks if the FSM is active.
+ *
+ * @param p_this Pointer to the FSM instance.
+ *
+ * @return `true` if the FSM is active, `false` otherwise.
+ */
+
+static bool check_active(fsm_t *p_this)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    return p_fsm->status;
+}
+
+/**
+ * @brief Checks if a new distance has been set.
+ *
+ * @param p_this Pointer to the FSM instance.
+ *
+ * @return `true` if a new distance has been set, `false` otherwise.
+ */
+
+static bool check_set_new_distance(fsm_t *p_this)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    return p_fsm->new_distance;
+}
+
+/**
+ * @brief Checks if the FSM should be turned off.
+ *
+ * @param p_this Pointer to the FSM instance.
+ *
+ * @return `true` if the FSM should be turned off, `false` otherwise.
+ */
+
+static bool check_off(fsm_t *p_this)
+{
+    return !check_active(p_this);
+}
+
+/* State machine output or action functions */
+
+/**
+ * @brief Action to start the buzzer silent.
+ *
+ * @param p_this Pointer to the FSM instance.
+ */
+
+static void do_set_on(fsm_t *p_this)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    port_buzzer_stop(p_fsm->buzzer_id);
+    p_fsm->period_ms = 0;
+    p_fsm->on_ms = 0;
+}
+
+/**
+ * @brief Action to set the cadence based on the distance. The hardware is only reprogrammed if the cadence changes, so the beeps are not restarted with every measurement.
+ *
+ * @param p_this Pointer to the FSM instance.
+ */
+
+static void do_set_cadence(fsm_t *p_this)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    uint32_t period_ms;
+    uint32_t on_ms;
+    const fsm_display_band_t *p_band = NULL;
+    if (p_fsm->distance_cm != FSM_BUZZER_NO_DISTANCE)
+    {
+        p_band = (p_fsm->p_display != NULL) ? fsm_display_get_band(p_fsm->p_display, (int32_t)p_fsm->distance_cm) : fsm_display_get_default_band((int32_t)p_fsm->distance_cm);
+    }
+    _compute_buzzer_cadence(&period_ms, &on_ms, p_band);
+    if ((period_ms != p_fsm->period_ms) || (on_ms != p_fsm->on_ms))
+    {
+        port_buzzer_set_cadence(p_fsm->buzzer_id, period_ms, on_ms);
+        p_fsm->period_ms = period_ms;
+        p_fsm->on_ms = on_ms;
+    }
+    p_fsm->new_distance = false;
+}
+
+/**
+ * @brief Action to silence the buzzer.
+ *
+ * @param p_this Pointer to the FSM instance.
+ */
+
+static void do_set_off(fsm_t *p_this)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    port_buzzer_stop(p_fsm->buzzer_id);
+    p_fsm->period_ms = 0;
+    p_fsm->on_ms = 0;
+}
+
+/**
+ * @brief Transition table for the FSM.
+ */
+
+static fsm_trans_t fsm_trans_buzzer[] = {
+    {WAIT_BUZZER, check_active, SET_BUZZER, do_set_on},
+    {SET_BUZZER, check_set_new_distance, SET_BUZZER, do_set_cadence},
+    {SET_BUZZER, check_off, WAIT_BUZZER, do_set_off},
+    {-1, NULL, -1, NULL},
+};
+
+/* Other auxiliary functions */
+
+/**
+ * @brief Initializes the FSM for the buzzer.
+ *
+ * @param p_fsm_buzzer Pointer to the FSM instance.
+ * @param buzzer_id The ID of the associated buzzer.
+ */
+
+static void fsm_buzzer_init(fsm_buzzer_t *p_fsm_buzzer, uint32_t buzzer_id)
+{
+    fsm_init(&p_fsm_buzzer->f, fsm_trans_buzzer);
+    p_fsm_buzzer->distance_cm = FSM_BUZZER_NO_DISTANCE;
+    p_fsm_buzzer->buzzer_id = buzzer_id;
+    p_fsm_buzzer->new_distance = false;
+    p_fsm_buzzer->status = false;
+    p_fsm_buzzer->period_ms = 0;
+    p_fsm_buzzer->on_ms = 0;
+    p_fsm_buzzer->p_transition_trace = NULL;
+    p_fsm_buzzer->p_display = NULL;
+    port_buzzer_init(buzzer_id);
+}
+
+/* Public functions -----------------------------------------------------------*/
+
+fsm_buzzer_t *fsm_buzzer_new(uint32_t buzzer_id)
+{
+    fsm_buzzer_t *p_fsm_buzzer = malloc(sizeof(fsm_buzzer_t)); /* Do malloc to reserve memory of all other FSM elements, although it is interpreted as fsm_t (the first element of the structure) */
+    fsm_buzzer_init(p_fsm_buzzer, buzzer_id); /* Initialize the FSM */
+    return p_fsm_buzzer;
+}
+
+void fsm_buzzer_fire(fsm_buzzer_t *p_fsm)
+{
+    int prev_state = p_fsm->f.current_state;
+    fsm_fire(&p_fsm->f);
+    if ((p_fsm->p_transition_trace != NULL) && (p_fsm->f.current_state != prev_state))
+    {
+        transition_trace_add(p_fsm->p_transition_trace, port_system_get_millis(), TRANSITION_TRACE_ID(TRANSITION_TRACE_FSM_BUZZER, p_fsm->buzzer_id), (uint8_t)prev_state, (uint8_t)p_fsm->f.current_state);
+    }
+}
+
+void fsm_buzzer_destroy(fsm_buzzer_t *p_fsm)
+{
+    free(&p_fsm->f);
+}
+
+fsm_t *fsm_buzzer_get_inner_fsm(fsm_buzzer_t *p_fsm)
+{
+    return &p_fsm->f;
+}
+
+uint32_t fsm_buzzer_get_state(fsm_buzzer_t *p_fsm)
+{
+    return p_fsm->f.current_state;
+}
+
+void fsm_buzzer_set_state(fsm_buzzer_t *p_fsm, int8_t state)
+{
+    p_fsm->f.current_state = state;
+}
+
+void fsm_buzzer_set_transition_trace(fsm_buzzer_t *p_fsm, transition_trace_t *p_trace)
+{
+    p_fsm->p_transition_trace = p_trace;
+}
+
+void fsm_buzzer_set_display(fsm_buzzer_t *p_fsm, fsm_display_t *p_display)
+{
+    p_fsm->p_display = p_display;
+}
+
+uint32_t fsm_buzzer_get_distance(fsm_buzzer_t *p_fsm)
+{
+    return p_fsm->distance_cm;
+}
+
+void fsm_buzzer_set_distance(fsm_buzzer_t *p_fsm, uint32_t distance_cm)
+{
+    p_fsm->distance_cm = distance_cm;
+    p_fsm->new_distance = true;
+}
+
+bool fsm_buzzer_get_status(fsm_buzzer_t *p_fsm)
+{
+    return p_fsm->status;
+}
+
+void fsm_buzzer_set_status(fsm_buzzer_t *p_fsm, bool status)
+{
+    p_fsm->status = status;
+}
+
+bool fsm_buzzer_check_activity(fsm_buzzer_t *p_fsm)
+{
+    if (p_fsm->f.current_state == WAIT_BUZZER)
+    {
+        return p_fsm->status;
+    }
+    return !(p_fsm->status) || p_fsm->new_distance;
+}
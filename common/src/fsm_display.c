@@ -21,6 +21,8 @@
  
 #include "fsm.h"
 #include "fsm_display.h"
+#include "fsm_buzzer.h"
+#include "latency_probe.h"
  
 /* Typedefs --------------------------------------------------------------------*/
 
@@ -36,53 +38,109 @@ struct fsm_display_t
     bool status;            /**<  Status of the FSM (active or paused). */
     bool idle;              /**< Idle state of the FSM.*/
     uint32_t display_id;     /**< ID of the associated display. */
+    uint8_t num_bands;       /**< Number of bands of the band table. */
+    fsm_display_band_t bands[FSM_DISPLAY_MAX_BANDS]; /**< Band table, sorted by increasing upper limit. */
+    uint32_t frame_period_ms; /**< Minimum time between two frames, in ms (0 if the frame rate is not limited). */
+    uint32_t last_frame_ms;   /**< System time of the last frame shown, in ms. */
+    bool first_frame;         /**< Flag indicating that no frame has been shown yet. */
+    latency_probe_t *p_latency_probe; /**< Histogram of the latencies from the echo to the frame (NULL if they are not measured). */
+    uint32_t distance_time_us; /**< Time of the echo of the distance to show, in us. */
+    bool distance_timed;      /**< Flag indicating that the time of the echo of the distance to show is known. */
+    transition_trace_t *p_transition_trace; /**< Trace of the changes of state (NULL if they are not recorded). */
 };
 
 
 /* Private functions -----------------------------------------------------------*/
 
 /**
- * @brief Computes the RGB color levels based on the distance.
- * 
- * @param pcolor Pointer to the RGB color structure to update.
+ * @brief Default band table, built from the thresholds of `fsm_display.h`. The first half of the "Danger" range is the only band with urgency `FSM_DISPLAY_URGENCY_DANGER`. The beep periods are those of the ranges of `fsm_buzzer.h`; the buzzer is silent in the last "OK" band.
+ */
+
+static const fsm_display_band_t default_bands[] = {
+    {(WARNING_MIN_CM / 2) - 1, {255, 0, 0}, FSM_DISPLAY_URGENCY_DANGER, FSM_BUZZER_DANGER_PERIOD_MS},
+    {WARNING_MIN_CM, {255, 0, 0}, FSM_DISPLAY_URGENCY_HIGH, FSM_BUZZER_DANGER_PERIOD_MS},
+    {NO_PROBLEM_MIN_CM, {237, 237, 0}, FSM_DISPLAY_URGENCY_MEDIUM, FSM_BUZZER_WARNING_PERIOD_MS},
+    {INFO_MIN_CM, {0, 255, 0}, FSM_DISPLAY_URGENCY_LOW, FSM_BUZZER_NO_PROBLEM_PERIOD_MS},
+    {OK_MIN_CM, {25, 89, 81}, FSM_DISPLAY_URGENCY_LOW, FSM_BUZZER_INFO_PERIOD_MS},
+    {OK_MAX_CM, {0, 0, 255}, FSM_DISPLAY_URGENCY_LOW, FSM_DISPLAY_BEEP_SILENT},
+};
+
+/**
+ * @brief Finds the band of a band table that contains a distance, with a binary search.
+ *
+ * @param p_bands Pointer to the bands, sorted by strictly increasing `max_cm`.
+ * @param num_bands Number of bands.
  * @param distance_cm The distance in centimeters.
+ *
+ * @return Pointer to the band, or NULL if the distance is out of the range of the table.
  */
 
-void _compute_display_levels(rgb_color_t *pcolor, int32_t distance_cm){
-    if(distance_cm<=WARNING_MIN_CM && distance_cm>=DANGER_MIN_CM){
-        pcolor->r=255;
-        pcolor->g=0;
-        pcolor->b=0;
-    }
-    else 
-    if(distance_cm>WARNING_MIN_CM && distance_cm <=NO_PROBLEM_MIN_CM){
-        pcolor->r=237;
-        pcolor->g=237;
-        pcolor->b=0;
-    }
-    else
-    if(distance_cm>NO_PROBLEM_MIN_CM && distance_cm <=INFO_MIN_CM){
-        pcolor->r=0;
-        pcolor->g=255;
-        pcolor->b=0;
+static const fsm_display_band_t *_find_band(const fsm_display_band_t *p_bands, uint32_t num_bands, int32_t distance_cm)
+{
+    if (distance_cm < DANGER_MIN_CM)
+    {
+        return NULL;
     }
-    else
-    if(distance_cm>INFO_MIN_CM && distance_cm <=OK_MIN_CM){
-        pcolor->r=25;
-        pcolor->g=89;
-        pcolor->b=81;
+    // First band whose upper limit is not below the distance
+    uint32_t low = 0;
+    uint32_t high = num_bands;
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+        if ((uint32_t)distance_cm <= p_bands[mid].max_cm)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1;
+        }
     }
-    else
-    if(distance_cm>OK_MIN_CM && distance_cm <=OK_MAX_CM){
-        pcolor->r=0;
-        pcolor->g=0;
-        pcolor->b=255;
+    return (low < num_bands) ? &p_bands[low] : NULL;
+}
+
+/**
+ * @brief Computes the fill level of the display based on the distance. The closer the obstacle, the higher the level. Any distance in the range of the band table gives a level greater than 0.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ * @param distance_cm The distance in centimeters.
+ *
+ * @return The fill level, from 0 to `PORT_DISPLAY_RGB_MAX_VALUE`.
+ */
+
+static uint8_t _compute_display_fill_level(fsm_display_t *p_fsm, int32_t distance_cm)
+{
+    int32_t max_cm = p_fsm->bands[p_fsm->num_bands - 1].max_cm;
+    if (distance_cm < DANGER_MIN_CM || distance_cm > max_cm)
+    {
+        return 0;
     }
-    else{
-        pcolor->r=0;
-        pcolor->g=0;
-        pcolor->b=0;
+    return (uint8_t)(((max_cm + 1 - distance_cm) * PORT_DISPLAY_RGB_MAX_VALUE) / (max_cm + 1 - DANGER_MIN_CM));
+}
+
+uint8_t _compute_display_levels(fsm_display_t *p_fsm, rgb_color_t *pcolor, int32_t distance_cm)
+{
+    const fsm_display_band_t *p_band = _find_band(p_fsm->bands, p_fsm->num_bands, distance_cm);
+    *pcolor = (p_band != NULL) ? p_band->color : COLOR_OFF;
+    return _compute_display_fill_level(p_fsm, distance_cm);
+}
+
+/**
+ * @brief Checks if the frame period has elapsed since the previous frame, so that a new color can be shown. A distance in a band of urgency `FSM_DISPLAY_URGENCY_DANGER` does not wait for the next frame.
+ *
+ * @param p_fsm Pointer to the FSM instance.
+ *
+ * @return `true` if a new frame can be shown, `false` otherwise.
+ */
+
+static bool _check_frame_due(fsm_display_t *p_fsm)
+{
+    if (p_fsm->first_frame || (port_system_get_millis() - p_fsm->last_frame_ms) >= p_fsm->frame_period_ms)
+    {
+        return true;
     }
+    // A danger distance cannot wait for the next frame
+    return fsm_display_get_urgency(p_fsm, p_fsm->distance_cm) == FSM_DISPLAY_URGENCY_DANGER;
 }
 
 /* State machine input or transition functions */
@@ -112,7 +170,7 @@ static bool check_active(fsm_t *p_this)
 static bool check_set_new_color(fsm_t *p_this)
 {
     fsm_display_t *p_fsm = (fsm_display_t *)(p_this);
-    return p_fsm->new_color;
+    return p_fsm->new_color && _check_frame_due(p_fsm);
 }
 
 /**
@@ -152,10 +210,22 @@ static void do_set_color(fsm_t *p_this)
 {
     fsm_display_t *p_fsm = (fsm_display_t *)(p_this);
     rgb_color_t color;
-    _compute_display_levels(&color, p_fsm->distance_cm);
-    port_display_set_rgb(p_fsm->display_id, color);
+    uint8_t level = _compute_display_levels(p_fsm, &color, p_fsm->distance_cm);
+    port_display_set_bar(p_fsm->display_id, color, level);
+    if (p_fsm->distance_timed)
+    {
+        // The color is applied: the latency ends here
+        if (p_fsm->p_latency_probe != NULL)
+        {
+            latency_probe_record(p_fsm->p_latency_probe, port_system_get_micros() - p_fsm->distance_time_us);
+        }
+        port_system_probe_pin_write(false);
+        p_fsm->distance_timed = false;
+    }
     p_fsm->new_color = false;
     p_fsm->idle = true;
+    p_fsm->last_frame_ms = port_system_get_millis();
+    p_fsm->first_frame = false;
 }
 
 /**
@@ -168,6 +238,12 @@ static void do_set_off(fsm_t *p_this)
 {
     fsm_display_t *p_fsm = (fsm_display_t *)(p_this);
     port_display_set_rgb(p_fsm->display_id, COLOR_OFF);
+    if (p_fsm->distance_timed)
+    {
+        // The pending frame is dropped: the probe pin is lowered anyway
+        port_system_probe_pin_write(false);
+        p_fsm->distance_timed = false;
+    }
     p_fsm->idle = false;
 }
 
@@ -199,6 +275,14 @@ static void fsm_display_init(fsm_display_t *p_fsm_display, uint32_t display_id){
     p_fsm_display->new_color = false;
     p_fsm_display->status = false;
     p_fsm_display->idle = false;
+    p_fsm_display->last_frame_ms = 0;
+    p_fsm_display->first_frame = true;
+    p_fsm_display->p_latency_probe = NULL;
+    p_fsm_display->distance_time_us = 0;
+    p_fsm_display->distance_timed = false;
+    p_fsm_display->p_transition_trace = NULL;
+    fsm_display_set_max_frame_rate(p_fsm_display, FSM_DISPLAY_DEFAULT_MAX_FPS);
+    fsm_display_load_default_bands(p_fsm_display);
     port_display_init(display_id);
 }
 
@@ -217,7 +301,12 @@ fsm_display_t *fsm_display_new(uint32_t display_id)
 
 void fsm_display_fire(fsm_display_t *p_fsm)
 {
-    fsm_fire(&p_fsm->f); 
+    int prev_state = p_fsm->f.current_state;
+    fsm_fire(&p_fsm->f);
+    if ((p_fsm->p_transition_trace != NULL) && (p_fsm->f.current_state != prev_state))
+    {
+        transition_trace_add(p_fsm->p_transition_trace, port_system_get_millis(), TRANSITION_TRACE_ID(TRANSITION_TRACE_FSM_DISPLAY, p_fsm->display_id), (uint8_t)prev_state, (uint8_t)p_fsm->f.current_state);
+    }
 }
 
 
@@ -277,5 +366,94 @@ void fsm_display_set_state(fsm_display_t *p_fsm, int8_t state)
 
 bool fsm_display_check_activity(fsm_display_t *p_fsm)
 {
-    return !(p_fsm->idle);
-}
\ No newline at end of file
+    return p_fsm->status && (!(p_fsm->idle) || (p_fsm->new_color && _check_frame_due(p_fsm)));
+}
+
+
+bool fsm_display_check_pending_frame(fsm_display_t *p_fsm)
+{
+    return p_fsm->status && p_fsm->new_color && !_check_frame_due(p_fsm);
+}
+
+
+bool fsm_display_load_bands(fsm_display_t *p_fsm, const fsm_display_band_t *p_bands, uint32_t num_bands)
+{
+    if (num_bands == 0 || num_bands > FSM_DISPLAY_MAX_BANDS)
+    {
+        return false;
+    }
+    for (uint32_t i = 1; i < num_bands; i++)
+    {
+        if (p_bands[i].max_cm <= p_bands[i - 1].max_cm)
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < num_bands; i++)
+    {
+        p_fsm->bands[i] = p_bands[i];
+    }
+    p_fsm->num_bands = num_bands;
+    return true;
+}
+
+
+void fsm_display_load_default_bands(fsm_display_t *p_fsm)
+{
+    fsm_display_load_bands(p_fsm, default_bands, sizeof(default_bands) / sizeof(default_bands[0]));
+}
+
+
+uint32_t fsm_display_get_bands(fsm_display_t *p_fsm, fsm_display_band_t *p_bands, uint32_t max_bands)
+{
+    uint32_t num_bands = (p_fsm->num_bands < max_bands) ? p_fsm->num_bands : max_bands;
+    for (uint32_t i = 0; i < num_bands; i++)
+    {
+        p_bands[i] = p_fsm->bands[i];
+    }
+    return num_bands;
+}
+
+
+const fsm_display_band_t *fsm_display_get_band(fsm_display_t *p_fsm, int32_t distance_cm)
+{
+    return _find_band(p_fsm->bands, p_fsm->num_bands, distance_cm);
+}
+
+
+uint8_t fsm_display_get_urgency(fsm_display_t *p_fsm, int32_t distance_cm)
+{
+    const fsm_display_band_t *p_band = fsm_display_get_band(p_fsm, distance_cm);
+    return (p_band != NULL) ? p_band->urgency : FSM_DISPLAY_URGENCY_NONE;
+}
+
+
+const fsm_display_band_t *fsm_display_get_default_band(int32_t distance_cm)
+{
+    return _find_band(default_bands, sizeof(default_bands) / sizeof(default_bands[0]), distance_cm);
+}
+
+
+void fsm_display_set_max_frame_rate(fsm_display_t *p_fsm, uint32_t max_fps)
+{
+    p_fsm->frame_period_ms = (max_fps == 0) ? 0 : (1000 + max_fps - 1) / max_fps;
+}
+
+
+void fsm_display_set_distance_time_us(fsm_display_t *p_fsm, uint32_t echo_time_us)
+{
+    p_fsm->distance_time_us = echo_time_us;
+    p_fsm->distance_timed = true;
+}
+
+
+void fsm_display_set_latency_probe(fsm_display_t *p_fsm, latency_probe_t *p_probe)
+{
+    p_fsm->p_latency_probe = p_probe;
+}
+
+
+void fsm_display_set_transition_trace(fsm_display_t *p_fsm, transition_trace_t *p_trace)
+{
+    p_fsm->p_transition_trace = p_trace;
+}
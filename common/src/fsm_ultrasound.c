@@ -15,9 +15,11 @@
 /* HW dependent includes */
 #include "port_ultrasound.h"
 #include "port_system.h"
+#include "port_temperature.h"
 /* Project includes */
 #include "fsm.h"
 #include "fsm_ultrasound.h"
+#include "speed_of_sound.h"
 
 /**
  * @brief Structure of the Ultrasound FSM.
@@ -27,26 +29,66 @@ struct fsm_ultrasound_t
 {
     fsm_t f; /*!< Base FSM structure */
     uint32_t distance_cm; /*!< Distance measured in cm */
+    uint32_t distance_time_us; /*!< Time of the falling edge of the last echo of the distance measured, in us */
     bool status; /*!< Status of the ultrasound sensor */
     bool new_measurement; /*!< Flag to indicate if a new measurement is ready */
     uint32_t ultrasound_id; /*!< ID of the ultrasound sensor */
     uint32_t distance_arr[FSM_ULTRASOUND_NUM_MEASUREMENTS]; /*!< Array of distances measured */
     uint32_t distance_idx; /*!< Index of the distance array */
+    uint32_t num_measurements; /*!< Number of measurements of the distance array whose median gives a distance */
+    echo_trace_t *p_trace; /*!< Trace of the raw echoes (NULL if they are not traced) */
+    distance_history_t *p_history; /*!< History of the filtered distances (NULL if it is not kept) */
+    ranging_stats_t *p_stats; /*!< Statistics of the pings (NULL if they are not kept) */
+    transition_trace_t *p_transition_trace; /*!< Trace of the changes of state (NULL if they are not recorded) */
+    int32_t temperature_dc; /*!< Temperature of the air, in tenths of ºC */
+    uint32_t distance_scale; /*!< Scale from the width of an echo to its distance at that temperature (see `speed_of_sound_get_scale()`) */
+    uint32_t temperature_pings; /*!< Pings since the last reading of the temperature was started */
+    uint32_t max_echoes; /*!< Number of echoes captured in each ping */
+    uint32_t echo_distances_cm[FSM_ULTRASOUND_MAX_ECHOES]; /*!< Distances of the echoes of the last ping, from the nearest one */
+    uint32_t num_echoes; /*!< Number of echoes of the last ping */
 
 };
 /* Typedefs --------------------------------------------------------------------*/
 
+/* Defines ---------------------------------------------------------------------*/
+#define FSM_ULTRASOUND_ECHO_TIMER_TICKS ((uint64_t)TIMER_MAX_ARR + 1) /*!< Number of ticks of a period of the echo timer */
+#define FSM_ULTRASOUND_MAX_ECHO_TICKS (UINT32_MAX / SPEED_OF_SOUND_MS) /*!< Longest echo whose distance is computed; longer ones saturate to it */
+
+#if FSM_ULTRASOUND_MAX_ECHOES > PORT_ULTRASOUND_MAX_ECHOES
+#error "The ultrasound FSM cannot keep more echoes than the port captures"
+#endif
+
 /* Private functions -----------------------------------------------------------*/
 /**
- * @brief Comparison function for qsort.
+ * @brief Picks up the reading of the temperature started by a previous ping, if it has finished, and starts a new one every `FSM_ULTRASOUND_TEMPERATURE_PERIOD_PINGS` pings. The conversion runs while the sensor waits for the next echo.
+ * 
+ * @param p_fsm_ultrasound Pointer to the ultrasound FSM.
+ */
+static void _update_temperature(fsm_ultrasound_t *p_fsm_ultrasound)
+{
+    int32_t temperature_dc;
+    if (port_temperature_get_conversion(&temperature_dc)) {
+        fsm_ultrasound_set_temperature(p_fsm_ultrasound, temperature_dc);
+    }
+    p_fsm_ultrasound->temperature_pings++;
+    if (p_fsm_ultrasound->temperature_pings >= FSM_ULTRASOUND_TEMPERATURE_PERIOD_PINGS) {
+        p_fsm_ultrasound->temperature_pings = 0;
+        port_temperature_start_conversion();
+    }
+}
+
+/**
+ * @brief Comparison function for qsort. The values are compared instead of subtracted, since the difference of two `uint32_t` can wrap around and invert the order.
  * 
- * @param a 
- * @param b 
- * @return int 
+ * @param a Pointer to the first distance.
+ * @param b Pointer to the second distance.
+ * @return int Negative, zero or positive if the first distance is smaller, equal or greater than the second one.
  */
 int _compare(const void *a, const void *b)
 {
-    return (*(uint32_t *)a - *(uint32_t *)b);
+    uint32_t distance_a = *(const uint32_t *)a;
+    uint32_t distance_b = *(const uint32_t *)b;
+    return (distance_a > distance_b) - (distance_a < distance_b);
 }
 
 /* State machine input or transition functions */
@@ -165,22 +207,62 @@ static void do_stop_trigger (fsm_t *p_this){
  */
 static void do_set_distance (fsm_t *p_this){
     fsm_ultrasound_t *p_fsm_ultrasound = (fsm_ultrasound_t *)p_this;
-    int32_t init_tick = port_ultrasound_get_echo_init_tick(p_fsm_ultrasound->ultrasound_id);
-    int32_t end_tick = port_ultrasound_get_echo_end_tick(p_fsm_ultrasound->ultrasound_id);
-    int32_t over_tick = port_ultrasound_get_echo_overflows(p_fsm_ultrasound->ultrasound_id);
-    double time = (double)(end_tick-(init_tick-65535.0*over_tick));
-    double distance = (time * SPEED_OF_SOUND_MS)/(2*10000);
-    p_fsm_ultrasound->distance_arr[p_fsm_ultrasound->distance_idx] = (uint32_t)distance;
-    if(p_fsm_ultrasound->distance_idx==FSM_ULTRASOUND_NUM_MEASUREMENTS-1){
-        qsort(p_fsm_ultrasound->distance_arr, FSM_ULTRASOUND_NUM_MEASUREMENTS, sizeof(uint32_t), _compare);
-        if (FSM_ULTRASOUND_NUM_MEASUREMENTS % 2 == 0) {
-            p_fsm_ultrasound->distance_cm = (p_fsm_ultrasound->distance_arr[FSM_ULTRASOUND_NUM_MEASUREMENTS / 2 - 1]+p_fsm_ultrasound->distance_arr[FSM_ULTRASOUND_NUM_MEASUREMENTS / 2]) / 2;
+    uint32_t init_tick = port_ultrasound_get_echo_init_tick(p_fsm_ultrasound->ultrasound_id);
+    uint32_t end_tick = port_ultrasound_get_echo_end_tick(p_fsm_ultrasound->ultrasound_id);
+    uint32_t over_tick = port_ultrasound_get_echo_overflows(p_fsm_ultrasound->ultrasound_id);
+    if (p_fsm_ultrasound->p_trace != NULL) {
+        echo_trace_record_t record = {
+            .timestamp_ms = port_system_get_millis(),
+            .init_tick = (uint16_t)init_tick,
+            .end_tick = (uint16_t)end_tick,
+            .overflows = (uint16_t)over_tick,
+            .ultrasound_id = (uint16_t)p_fsm_ultrasound->ultrasound_id,
+        };
+        echo_trace_add(p_fsm_ultrasound->p_trace, &record);
+    }
+    // Width of the echo in ticks (us), in integer arithmetic. An end before the start with no overflow means that the overflow between both edges has not been counted yet
+    uint64_t end_ticks = (uint64_t)over_tick * FSM_ULTRASOUND_ECHO_TIMER_TICKS + end_tick;
+    if (end_ticks < init_tick) {
+        end_ticks += FSM_ULTRASOUND_ECHO_TIMER_TICKS;
+    }
+    uint64_t echo_ticks = (end_ticks > init_tick) ? end_ticks - init_tick : 0;
+    if (echo_ticks > FSM_ULTRASOUND_MAX_ECHO_TICKS) {
+        echo_ticks = FSM_ULTRASOUND_MAX_ECHO_TICKS;
+    }
+    _update_temperature(p_fsm_ultrasound);
+    uint32_t echo_distance_cm = speed_of_sound_get_distance_cm((uint32_t)echo_ticks, p_fsm_ultrasound->distance_scale);
+    p_fsm_ultrasound->distance_arr[p_fsm_ultrasound->distance_idx] = echo_distance_cm;
+    // The first echo is the one of the ticks. The next ones arrive within the window, so their time of flight fits in a period of the echo timer
+    uint32_t num_echoes = port_ultrasound_get_num_echoes(p_fsm_ultrasound->ultrasound_id);
+    p_fsm_ultrasound->echo_distances_cm[0] = echo_distance_cm;
+    p_fsm_ultrasound->num_echoes = 1;
+    for (uint32_t i = 1; (i < num_echoes) && (i < p_fsm_ultrasound->max_echoes); i++) {
+        uint32_t width_us = port_ultrasound_get_echo_width_us(p_fsm_ultrasound->ultrasound_id, i);
+        p_fsm_ultrasound->echo_distances_cm[p_fsm_ultrasound->num_echoes++] = speed_of_sound_get_distance_cm(width_us, p_fsm_ultrasound->distance_scale);
+    }
+    if (p_fsm_ultrasound->p_stats != NULL) {
+        // The echo timer counts microseconds, so the rising edge of the echo is its width before the falling edge
+        uint32_t echo_start_us = port_ultrasound_get_echo_end_time_us(p_fsm_ultrasound->ultrasound_id) - (uint32_t)echo_ticks;
+        ranging_stats_add_ping(p_fsm_ultrasound->p_stats, echo_start_us, (uint32_t)echo_ticks, echo_distance_cm, over_tick > 0);
+    }
+    uint32_t num_measurements = p_fsm_ultrasound->num_measurements;
+    if(p_fsm_ultrasound->distance_idx==num_measurements-1){
+        qsort(p_fsm_ultrasound->distance_arr, num_measurements, sizeof(uint32_t), _compare);
+        if (num_measurements % 2 == 0) {
+            p_fsm_ultrasound->distance_cm = (p_fsm_ultrasound->distance_arr[num_measurements / 2 - 1]+p_fsm_ultrasound->distance_arr[num_measurements / 2]) / 2;
         } else {
-            p_fsm_ultrasound->distance_cm = p_fsm_ultrasound->distance_arr[FSM_ULTRASOUND_NUM_MEASUREMENTS / 2];
+            p_fsm_ultrasound->distance_cm = p_fsm_ultrasound->distance_arr[num_measurements / 2];
         }
+        p_fsm_ultrasound->distance_time_us = port_ultrasound_get_echo_end_time_us(p_fsm_ultrasound->ultrasound_id);
         p_fsm_ultrasound->new_measurement = true;
+        if (p_fsm_ultrasound->p_history != NULL) {
+            distance_history_add(p_fsm_ultrasound->p_history, port_system_get_millis(), p_fsm_ultrasound->distance_cm);
+        }
+    } else {
+        // The probe pin stays high only for the echoes that give a new distance
+        port_system_probe_pin_write(false);
     }
-    p_fsm_ultrasound->distance_idx = (p_fsm_ultrasound->distance_idx + 1) % FSM_ULTRASOUND_NUM_MEASUREMENTS;
+    p_fsm_ultrasound->distance_idx = (p_fsm_ultrasound->distance_idx + 1) % num_measurements;
     port_ultrasound_stop_echo_timer(p_fsm_ultrasound->ultrasound_id);
     port_ultrasound_reset_echo_ticks(p_fsm_ultrasound->ultrasound_id);
 }
@@ -228,11 +310,23 @@ void fsm_ultrasound_init(fsm_ultrasound_t *p_fsm_ultrasound, uint32_t ultrasound
     // Initialize the fields of the FSM structure
     p_fsm_ultrasound -> distance_cm = 0;
     p_fsm_ultrasound -> distance_idx = 0;
+    p_fsm_ultrasound->num_measurements = FSM_ULTRASOUND_NUM_MEASUREMENTS;
+    p_fsm_ultrasound->distance_time_us = 0;
     p_fsm_ultrasound->status = false;
     p_fsm_ultrasound->new_measurement = false;
     p_fsm_ultrasound->ultrasound_id = ultrasound_id;
+    p_fsm_ultrasound->p_trace = NULL;
+    p_fsm_ultrasound->p_history = NULL;
+    p_fsm_ultrasound->p_stats = NULL;
+    p_fsm_ultrasound->p_transition_trace = NULL;
+    p_fsm_ultrasound->temperature_pings = 0;
+    p_fsm_ultrasound->max_echoes = 1;
+    p_fsm_ultrasound->num_echoes = 0;
+    fsm_ultrasound_set_temperature(p_fsm_ultrasound, FSM_ULTRASOUND_DEFAULT_TEMPERATURE_DC);
     memset(p_fsm_ultrasound->distance_arr, 0, sizeof(p_fsm_ultrasound->distance_arr));
     port_ultrasound_init(p_fsm_ultrasound->ultrasound_id);
+    port_ultrasound_set_max_echoes(p_fsm_ultrasound->ultrasound_id, p_fsm_ultrasound->max_echoes);
+    port_temperature_init();
 
 }
 
@@ -256,7 +350,11 @@ void fsm_ultrasound_destroy (fsm_ultrasound_t *p_fsm){
 
 
 void fsm_ultrasound_fire (fsm_ultrasound_t *p_fsm){
+    int prev_state = p_fsm->f.current_state;
     fsm_fire(&p_fsm->f);
+    if ((p_fsm->p_transition_trace != NULL) && (p_fsm->f.current_state != prev_state)) {
+        transition_trace_add(p_fsm->p_transition_trace, port_system_get_millis(), TRANSITION_TRACE_ID(TRANSITION_TRACE_FSM_ULTRASOUND, p_fsm->ultrasound_id), (uint8_t)prev_state, (uint8_t)p_fsm->f.current_state);
+    }
 }
 
 
@@ -265,6 +363,14 @@ uint32_t fsm_ultrasound_get_distance (fsm_ultrasound_t *p_fsm){
     return p_fsm->distance_cm;
 }
 
+uint32_t fsm_ultrasound_get_last_distance (fsm_ultrasound_t *p_fsm){
+    return p_fsm->distance_cm;
+}
+
+uint32_t fsm_ultrasound_get_distance_time_us (fsm_ultrasound_t *p_fsm){
+    return p_fsm->distance_time_us;
+}
+
 void fsm_ultrasound_stop (fsm_ultrasound_t *p_fsm){
     p_fsm->status=false;
     port_ultrasound_stop_ultrasound(p_fsm->ultrasound_id);
@@ -274,6 +380,14 @@ void fsm_ultrasound_start (fsm_ultrasound_t *p_fsm){
     p_fsm->status=true;
     p_fsm->distance_idx=0;
     p_fsm->distance_cm=0;
+    p_fsm->new_measurement=false; // A distance measured before the start is stale
+    p_fsm->num_echoes=0;
+    if (p_fsm->p_stats != NULL) {
+        ranging_stats_restart(p_fsm->p_stats);
+    }
+    // The temperature may have changed while the sensor was off
+    p_fsm->temperature_pings = 0;
+    port_temperature_start_conversion();
     port_ultrasound_reset_echo_ticks(p_fsm->ultrasound_id);
     port_ultrasound_set_trigger_ready(p_fsm->ultrasound_id,true);
     port_ultrasound_start_new_measurement_timer();
@@ -299,6 +413,75 @@ fsm_t *fsm_ultrasound_get_inner_fsm (fsm_ultrasound_t *p_fsm){
     return &p_fsm->f;
 }
 
+void fsm_ultrasound_set_trace (fsm_ultrasound_t *p_fsm, echo_trace_t *p_trace){
+    p_fsm->p_trace = p_trace;
+}
+
+void fsm_ultrasound_set_history (fsm_ultrasound_t *p_fsm, distance_history_t *p_history){
+    p_fsm->p_history = p_history;
+}
+
+void fsm_ultrasound_set_stats (fsm_ultrasound_t *p_fsm, ranging_stats_t *p_stats){
+    p_fsm->p_stats = p_stats;
+}
+
+void fsm_ultrasound_set_transition_trace (fsm_ultrasound_t *p_fsm, transition_trace_t *p_trace){
+    p_fsm->p_transition_trace = p_trace;
+}
+
+bool fsm_ultrasound_get_stats (fsm_ultrasound_t *p_fsm, ranging_stats_snapshot_t *p_snapshot){
+    if (p_fsm->p_stats == NULL) {
+        return false;
+    }
+    ranging_stats_get_snapshot(p_fsm->p_stats, p_snapshot);
+    return true;
+}
+
+bool fsm_ultrasound_set_num_measurements (fsm_ultrasound_t *p_fsm, uint32_t num_measurements){
+    if (num_measurements == 0 || num_measurements > FSM_ULTRASOUND_NUM_MEASUREMENTS) {
+        return false;
+    }
+    p_fsm->num_measurements = num_measurements;
+    p_fsm->distance_idx = 0;
+    return true;
+}
+
+uint32_t fsm_ultrasound_get_num_measurements (fsm_ultrasound_t *p_fsm){
+    return p_fsm->num_measurements;
+}
+
+void fsm_ultrasound_set_temperature (fsm_ultrasound_t *p_fsm, int32_t temperature_dc){
+    p_fsm->temperature_dc = temperature_dc;
+    p_fsm->distance_scale = speed_of_sound_get_scale(speed_of_sound_get_mm_s(temperature_dc));
+}
+
+int32_t fsm_ultrasound_get_temperature (fsm_ultrasound_t *p_fsm){
+    return p_fsm->temperature_dc;
+}
+
+bool fsm_ultrasound_set_max_echoes (fsm_ultrasound_t *p_fsm, uint32_t max_echoes){
+    if (max_echoes == 0 || max_echoes > FSM_ULTRASOUND_MAX_ECHOES) {
+        return false;
+    }
+    p_fsm->max_echoes = max_echoes;
+    port_ultrasound_set_max_echoes(p_fsm->ultrasound_id, max_echoes);
+    return true;
+}
+
+uint32_t fsm_ultrasound_get_max_echoes (fsm_ultrasound_t *p_fsm){
+    return p_fsm->max_echoes;
+}
+
+uint32_t fsm_ultrasound_get_echoes (fsm_ultrasound_t *p_fsm, uint32_t *p_distances_cm, uint32_t max_distances){
+    uint32_t num_echoes = (p_fsm->num_echoes < max_distances) ? p_fsm->num_echoes : max_distances;
+    memcpy(p_distances_cm, p_fsm->echo_distances_cm, num_echoes * sizeof(uint32_t));
+    return num_echoes;
+}
+
+uint32_t fsm_ultrasound_get_echo_range (fsm_ultrasound_t *p_fsm){
+    return speed_of_sound_get_distance_cm(PORT_ULTRASOUND_ECHO_WINDOW_US, p_fsm->distance_scale);
+}
+
 
 uint32_t fsm_ultrasound_get_state (fsm_ultrasound_t *p_fsm){
     return p_fsm->f.current_state;
@@ -14,6 +14,13 @@
 #include "fsm.h"
 #include "fsm_urbanite.h"
 
+/* Defines -------------------------------------------------------------------*/
+#ifdef USE_PRINTF
+#define URBANITE_PRINTF(...) printf(__VA_ARGS__) /*!< Log of the system */
+#else
+#define URBANITE_PRINTF(...) ((void)0) /*!< Log of the system, removed so that production images do not link printf */
+#endif
+
 /* Typedefs ------------------------------------------------------------------*/
 /**
  * @brief Structure representing the FSM for the Urbanite system.
@@ -26,10 +33,64 @@ struct fsm_urbanite_t{
     bool is_paused; /*!< Indicates if the display is paused. */
     fsm_ultrasound_t * p_fsm_ultrasound_rear; /*!< Pointer to the rear ultrasound FSM. */
     fsm_display_t * p_fsm_display_rear; /*!< Pointer to the rear display FSM.  */
+    fsm_buzzer_t * p_fsm_buzzer_rear; /*!< Pointer to the rear buzzer FSM.  */
+    power_stats_t * p_power_stats; /*!< Pointer to the power accounting, or NULL if it is not accounted. */
+    flash_log_t * p_flash_log; /*!< Pointer to the flash log of distances and events, or NULL if they are not logged. */
+    transition_trace_t * p_transition_trace; /*!< Pointer to the trace of the changes of state, or NULL if they are not recorded. */
+    int traced_state; /*!< State of the last change recorded in the trace. */
+    uint32_t min_obstacle_cm; /*!< Distance in cm below which the echoes are not obstacles (0 to take all of them). */
 };
 
 /* Private functions ---------------------------------------------------------*/
 
+/**
+ * @brief Appends a record to the flash log, if any.
+ *
+ * @param p_fsm_urbanite Pointer to the FSM instance.
+ * @param type Type of the record, one of `FSM_URBANITE_LOG_TYPES`.
+ * @param value Distance in cm or event.
+ */
+static void _log (fsm_urbanite_t *p_fsm_urbanite, uint8_t type, uint32_t value){
+    if (p_fsm_urbanite->p_flash_log != NULL){
+        fsm_urbanite_log_record_t record = {.timestamp_ms = port_system_get_millis(), .value = value};
+        flash_log_append(p_fsm_urbanite->p_flash_log, type, &record, sizeof(record));
+    }
+}
+
+/**
+ * @brief Records the change of state since the last one recorded, if any, in the transition trace.
+ *
+ * @param p_fsm_urbanite Pointer to the FSM instance.
+ */
+static void _trace (fsm_urbanite_t *p_fsm_urbanite){
+    if ((p_fsm_urbanite->p_transition_trace != NULL) && (p_fsm_urbanite->f.current_state != p_fsm_urbanite->traced_state)){
+        transition_trace_add(p_fsm_urbanite->p_transition_trace, port_system_get_millis(), TRANSITION_TRACE_ID(TRANSITION_TRACE_FSM_URBANITE, 0), (uint8_t)p_fsm_urbanite->traced_state, (uint8_t)p_fsm_urbanite->f.current_state);
+        p_fsm_urbanite->traced_state = p_fsm_urbanite->f.current_state;
+    }
+}
+
+/**
+ * @brief Selects the distance of the nearest relevant obstacle. An obstacle nearer than the minimum distance (a tow bar, a bumper) does not hide the ones behind it: the nearest echo of the last ping beyond it is taken instead. If there is none, nothing is in front of the car up to the range of the echoes.
+ *
+ * @param p_fsm_urbanite Pointer to the FSM instance.
+ * @param distance_cm Distance measured by the rear sensor, in cm.
+ *
+ * @return uint32_t Distance of the nearest relevant obstacle, in cm.
+ */
+static uint32_t _select_distance (fsm_urbanite_t *p_fsm_urbanite, uint32_t distance_cm){
+    if (distance_cm >= p_fsm_urbanite->min_obstacle_cm){
+        return distance_cm;
+    }
+    uint32_t echoes_cm[FSM_ULTRASOUND_MAX_ECHOES];
+    uint32_t num_echoes = fsm_ultrasound_get_echoes(p_fsm_urbanite->p_fsm_ultrasound_rear, echoes_cm, FSM_ULTRASOUND_MAX_ECHOES);
+    for (uint32_t i = 0; i < num_echoes; i++){
+        if (echoes_cm[i] >= p_fsm_urbanite->min_obstacle_cm){
+            return echoes_cm[i];
+        }
+    }
+    return fsm_ultrasound_get_echo_range(p_fsm_urbanite->p_fsm_ultrasound_rear);
+}
+
 /**
  * @brief Checks if the system should be turned on.
  * 
@@ -40,10 +101,8 @@ struct fsm_urbanite_t{
 
 static bool check_on (fsm_t *p_this){
     fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
-    if (fsm_button_get_duration(p_fsm_urbanite->p_fsm_button)>(p_fsm_urbanite->on_off_press_time_ms)){
-        return true;
-    }
-    return false;
+    const fsm_button_event_t *p_event = fsm_button_peek_event(p_fsm_urbanite->p_fsm_button);
+    return (p_event != NULL) && (p_event->gesture == FSM_BUTTON_GESTURE_LONG_PRESS);
 }
 
 /**
@@ -81,10 +140,34 @@ static bool check_new_measure (fsm_t *p_this){
 
 static bool check_pause_display (fsm_t *p_this){
     fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
-    if ((fsm_button_get_duration(p_fsm_urbanite->p_fsm_button)>(p_fsm_urbanite->pause_display_time_ms)) && (fsm_button_get_duration(p_fsm_urbanite->p_fsm_button)<(p_fsm_urbanite->on_off_press_time_ms))){
-        return true;
-    }
-    return false;
+    const fsm_button_event_t *p_event = fsm_button_peek_event(p_fsm_urbanite->p_fsm_button);
+    return (p_event != NULL) && (p_event->gesture == FSM_BUTTON_GESTURE_CLICK) && (p_event->duration_ms > p_fsm_urbanite->pause_display_time_ms);
+}
+
+/**
+ * @brief Checks if there is a button gesture that is not a command while the system is off.
+ * 
+ * @param p_this Pointer to the FSM instance.
+ * 
+ * @return `true` if the oldest gesture must be discarded, `false` otherwise.
+ */
+
+static bool check_ignored_gesture_off (fsm_t *p_this){
+    fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
+    return (fsm_button_peek_event(p_fsm_urbanite->p_fsm_button) != NULL) && !check_on(p_this);
+}
+
+/**
+ * @brief Checks if there is a button gesture that is not a command while the system is measuring.
+ * 
+ * @param p_this Pointer to the FSM instance.
+ * 
+ * @return `true` if the oldest gesture must be discarded, `false` otherwise.
+ */
+
+static bool check_ignored_gesture_measure (fsm_t *p_this){
+    fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
+    return (fsm_button_peek_event(p_fsm_urbanite->p_fsm_button) != NULL) && !check_off(p_this) && !check_pause_display(p_this);
 }
 
 /**
@@ -97,7 +180,7 @@ static bool check_pause_display (fsm_t *p_this){
 
 static bool check_activity (fsm_t *p_this){
     fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
-    return (fsm_button_check_activity(p_fsm_urbanite->p_fsm_button) || fsm_ultrasound_check_activity(p_fsm_urbanite->p_fsm_ultrasound_rear) || fsm_display_check_activity(p_fsm_urbanite->p_fsm_display_rear));
+    return (fsm_button_check_activity(p_fsm_urbanite->p_fsm_button) || fsm_ultrasound_check_activity(p_fsm_urbanite->p_fsm_ultrasound_rear) || fsm_display_check_activity(p_fsm_urbanite->p_fsm_display_rear) || fsm_buzzer_check_activity(p_fsm_urbanite->p_fsm_buzzer_rear));
 }
 
 /**
@@ -121,7 +204,8 @@ static bool check_no_activity (fsm_t *p_this){
  */
 
 static bool check_activity_in_measure (fsm_t *p_this){
-    return check_new_measure(p_this); 
+    fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
+    return check_new_measure(p_this) || (fsm_button_peek_event(p_fsm_urbanite->p_fsm_button) != NULL);
 }
 
 /**
@@ -132,10 +216,16 @@ static bool check_activity_in_measure (fsm_t *p_this){
 
 static void do_start_up_measure (fsm_t *p_this){
     fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
-    fsm_button_reset_duration(p_fsm_urbanite->p_fsm_button);
+    fsm_button_get_event(p_fsm_urbanite->p_fsm_button, NULL);
     fsm_ultrasound_start(p_fsm_urbanite->p_fsm_ultrasound_rear);
     fsm_display_set_status(p_fsm_urbanite->p_fsm_display_rear, true);
-    printf("[URBANITE][%ld] Urbanite system ON\n", port_system_get_millis());
+    fsm_buzzer_set_status(p_fsm_urbanite->p_fsm_buzzer_rear, true);
+    // Erasing a sector of the flash log would stall the measurements: the records are held or dropped until the system is switched off
+    if (p_fsm_urbanite->p_flash_log != NULL) {
+        flash_log_set_erase_allowed(p_fsm_urbanite->p_flash_log, false);
+    }
+    _log(p_fsm_urbanite, FSM_URBANITE_LOG_EVENT, FSM_URBANITE_EVENT_ON);
+    URBANITE_PRINTF("[URBANITE][%lu] Urbanite system ON\n", (unsigned long)port_system_get_millis());
 }
 
 /**
@@ -147,19 +237,28 @@ static void do_start_up_measure (fsm_t *p_this){
 static void do_display_distance (fsm_t *p_this){
     fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
 
-    uint32_t distance_cm = fsm_ultrasound_get_distance(p_fsm_urbanite->p_fsm_ultrasound_rear);
+    uint32_t distance_cm = _select_distance(p_fsm_urbanite, fsm_ultrasound_get_distance(p_fsm_urbanite->p_fsm_ultrasound_rear));
+    _log(p_fsm_urbanite, FSM_URBANITE_LOG_DISTANCE, distance_cm);
 
     if (p_fsm_urbanite->is_paused) {
-        if (distance_cm < (WARNING_MIN_CM / 2)) {
+        if (fsm_display_get_urgency(p_fsm_urbanite->p_fsm_display_rear, distance_cm) == FSM_DISPLAY_URGENCY_DANGER) {
             fsm_display_set_distance(p_fsm_urbanite->p_fsm_display_rear, distance_cm);
+            fsm_display_set_distance_time_us(p_fsm_urbanite->p_fsm_display_rear, fsm_ultrasound_get_distance_time_us(p_fsm_urbanite->p_fsm_ultrasound_rear));
             fsm_display_set_status(p_fsm_urbanite->p_fsm_display_rear, true);
-            printf("[URBANITE][%ld] DANGER: Distance: %ld cm\n", port_system_get_millis(), distance_cm);
+            fsm_buzzer_set_distance(p_fsm_urbanite->p_fsm_buzzer_rear, distance_cm);
+            fsm_buzzer_set_status(p_fsm_urbanite->p_fsm_buzzer_rear, true);
+            URBANITE_PRINTF("[URBANITE][%lu] DANGER: Distance: %lu cm\n", (unsigned long)port_system_get_millis(), (unsigned long)distance_cm);
         } else {
             fsm_display_set_status(p_fsm_urbanite->p_fsm_display_rear, false);
+            fsm_buzzer_set_status(p_fsm_urbanite->p_fsm_buzzer_rear, false);
+            // The distance is not shown, so the time from its echo ends here
+            port_system_probe_pin_write(false);
         }
     } else {
         fsm_display_set_distance(p_fsm_urbanite->p_fsm_display_rear, distance_cm);
-        printf("[URBANITE][%ld] Distance: %ld cm\n", port_system_get_millis(), distance_cm);
+        fsm_display_set_distance_time_us(p_fsm_urbanite->p_fsm_display_rear, fsm_ultrasound_get_distance_time_us(p_fsm_urbanite->p_fsm_ultrasound_rear));
+        fsm_buzzer_set_distance(p_fsm_urbanite->p_fsm_buzzer_rear, distance_cm);
+        URBANITE_PRINTF("[URBANITE][%lu] Distance: %lu cm\n", (unsigned long)port_system_get_millis(), (unsigned long)distance_cm);
     }
 }
 
@@ -172,16 +271,19 @@ static void do_display_distance (fsm_t *p_this){
 static void do_pause_display (fsm_t *p_this){
     fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
 
-    fsm_button_reset_duration(p_fsm_urbanite->p_fsm_button);
+    fsm_button_get_event(p_fsm_urbanite->p_fsm_button, NULL);
 
     p_fsm_urbanite->is_paused = !p_fsm_urbanite->is_paused;
 
     fsm_display_set_status(p_fsm_urbanite->p_fsm_display_rear, !p_fsm_urbanite->is_paused);
+    fsm_buzzer_set_status(p_fsm_urbanite->p_fsm_buzzer_rear, !p_fsm_urbanite->is_paused);
 
     if (p_fsm_urbanite->is_paused) {
-        printf("[URBANITE][%ld] Urbanite system display PAUSE\n", port_system_get_millis());
+        _log(p_fsm_urbanite, FSM_URBANITE_LOG_EVENT, FSM_URBANITE_EVENT_PAUSE);
+        URBANITE_PRINTF("[URBANITE][%lu] Urbanite system display PAUSE\n", (unsigned long)port_system_get_millis());
     } else {
-        printf("[URBANITE][%ld] Urbanite system display RESUME\n", port_system_get_millis());
+        _log(p_fsm_urbanite, FSM_URBANITE_LOG_EVENT, FSM_URBANITE_EVENT_RESUME);
+        URBANITE_PRINTF("[URBANITE][%lu] Urbanite system display RESUME\n", (unsigned long)port_system_get_millis());
     }
 }
  
@@ -194,17 +296,62 @@ static void do_pause_display (fsm_t *p_this){
 static void do_stop_urbanite (fsm_t *p_this){
     fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
 
-    fsm_button_reset_duration(p_fsm_urbanite->p_fsm_button);
+    fsm_button_get_event(p_fsm_urbanite->p_fsm_button, NULL);
 
     fsm_ultrasound_stop(p_fsm_urbanite->p_fsm_ultrasound_rear);
 
     fsm_display_set_status(p_fsm_urbanite->p_fsm_display_rear, false);
 
+    fsm_buzzer_set_status(p_fsm_urbanite->p_fsm_buzzer_rear, false);
+
     if (p_fsm_urbanite->is_paused) {
         p_fsm_urbanite->is_paused = false;
     }
 
-    printf("[URBANITE][%ld] Urbanite system OFF\n", port_system_get_millis());
+    // The system may be unplugged while off: the records pending are programmed now, erasing a sector if needed
+    _log(p_fsm_urbanite, FSM_URBANITE_LOG_EVENT, FSM_URBANITE_EVENT_OFF);
+    if (p_fsm_urbanite->p_flash_log != NULL) {
+        flash_log_set_erase_allowed(p_fsm_urbanite->p_flash_log, true);
+        flash_log_flush(p_fsm_urbanite->p_flash_log);
+    }
+
+    URBANITE_PRINTF("[URBANITE][%lu] Urbanite system OFF\n", (unsigned long)port_system_get_millis());
+}
+
+/**
+ * @brief Discards the oldest button gesture, which is not a command in the current state.
+ * 
+ * @param p_this Pointer to the FSM instance.
+ */
+
+static void do_discard_gesture (fsm_t *p_this){
+    fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *) p_this;
+    fsm_button_get_event(p_fsm_urbanite->p_fsm_button, NULL);
+}
+
+/**
+ * @brief Puts the system to sleep and accounts the time asleep, if the power is accounted.
+ *
+ * `fsm_fire()` has already moved the FSM to the sleep state, so the state is accounted and traced before sleeping. Programming the flash stalls the CPU, so the records of the flash log are programmed here, when nothing else is pending, once half a batch has been appended. While the system is on, the flash log never erases a sector here. While a color of the display waits for its next frame, the system sleeps with the SysTick running, so that it wakes up every millisecond until the frame is due.
+ *
+ * @param p_this Pointer to the FSM instance.
+ */
+static void _sleep (fsm_t *p_this){
+    fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *)p_this;
+    if ((p_fsm_urbanite->p_flash_log != NULL) && (flash_log_get_pending_bytes(p_fsm_urbanite->p_flash_log) >= FLASH_LOG_BATCH_SIZE / 2)){
+        flash_log_flush(p_fsm_urbanite->p_flash_log);
+    }
+    if (p_fsm_urbanite->p_power_stats != NULL){
+        power_stats_set_state(p_fsm_urbanite->p_power_stats, (uint8_t)p_this->current_state, port_system_get_power_clock_us());
+    }
+    _trace(p_fsm_urbanite);
+    if (fsm_display_check_pending_frame(p_fsm_urbanite->p_fsm_display_rear)){
+        // No interrupt may come before the next frame: the millis only advance with the SysTick running
+        power_stats_sleep_tick(p_fsm_urbanite->p_power_stats);
+    }
+    else{
+        power_stats_sleep(p_fsm_urbanite->p_power_stats);
+    }
 }
 
 /**
@@ -214,7 +361,7 @@ static void do_stop_urbanite (fsm_t *p_this){
  */
 
 static void do_sleep_while_off (fsm_t *p_this){
-    port_system_sleep();
+    _sleep(p_this);
 }
 
 /**
@@ -224,7 +371,7 @@ static void do_sleep_while_off (fsm_t *p_this){
  */
 
 static void do_sleep_while_on (fsm_t *p_this){
-    port_system_sleep();
+    _sleep(p_this);
 }
 
 /**
@@ -234,18 +381,22 @@ static void do_sleep_while_on (fsm_t *p_this){
  */
 
 static void do_sleep_while_measure (fsm_t *p_this){
-    port_system_sleep();
+    _sleep(p_this);
 }
 
 /**
- * @brief Puts the system to sleep while off. 
+ * @brief Puts the system to sleep while off. A stall does not matter while off, so the next sector of the flash log is erased now if the active one is half full, and the next measurements rarely need an erase.
  *
  * @param p_this Pointer to the FSM instance.
  */
  
 
 static void do_sleep_off (fsm_t *p_this){
-    port_system_sleep();
+    fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *)p_this;
+    if (p_fsm_urbanite->p_flash_log != NULL){
+        flash_log_prepare(p_fsm_urbanite->p_flash_log);
+    }
+    _sleep(p_this);
 }
 
 /**
@@ -255,10 +406,12 @@ static void do_sleep_off (fsm_t *p_this){
 static fsm_trans_t fsm_trans_urbanite[] = {
     {OFF, check_no_activity, SLEEP_WHILE_OFF, do_sleep_off},
     {OFF, check_on, MEASURE, do_start_up_measure},
+    {OFF, check_ignored_gesture_off, OFF, do_discard_gesture},
     {MEASURE, check_new_measure, MEASURE, do_display_distance},
     {MEASURE, check_pause_display, MEASURE, do_pause_display},
     {MEASURE, check_no_activity, SLEEP_WHILE_ON, do_sleep_while_on},
     {MEASURE, check_off, OFF, do_stop_urbanite},
+    {MEASURE, check_ignored_gesture_measure, MEASURE, do_discard_gesture},
     {SLEEP_WHILE_OFF, check_activity, OFF, NULL},
     {SLEEP_WHILE_OFF, check_no_activity, SLEEP_WHILE_OFF, do_sleep_while_off},
     {SLEEP_WHILE_ON, check_activity_in_measure, MEASURE, NULL},
@@ -273,13 +426,14 @@ static fsm_trans_t fsm_trans_urbanite[] = {
  * 
  * @param p_fsm_urbanite Pointer to the Urbanite FSM instance.
  * @param p_fsm_button Pointer to the button FSM.
- * @param on_off_press_time_ms Time in milliseconds to toggle the system on/off.
- * @param pause_display_time_ms Time in milliseconds to pause/resume the display.
+ * @param on_off_press_time_ms Time in milliseconds to toggle the system on/off. It is used as the long-press time of the button.
+ * @param pause_display_time_ms Time in milliseconds to pause/resume the display. Shorter clicks are ignored.
  * @param p_fsm_ultrasound_rear Pointer to the rear ultrasound FSM.
  * @param p_fsm_display_rear Pointer to the rear display FSM.
+ * @param p_fsm_buzzer_rear Pointer to the rear buzzer FSM.
  */
 
-static void fsm_urbanite_init (fsm_urbanite_t *p_fsm_urbanite, fsm_button_t *p_fsm_button, uint32_t on_off_press_time_ms, uint32_t pause_display_time_ms, fsm_ultrasound_t *p_fsm_ultrasound_rear, fsm_display_t *p_fsm_display_rear){
+static void fsm_urbanite_init (fsm_urbanite_t *p_fsm_urbanite, fsm_button_t *p_fsm_button, uint32_t on_off_press_time_ms, uint32_t pause_display_time_ms, fsm_ultrasound_t *p_fsm_ultrasound_rear, fsm_display_t *p_fsm_display_rear, fsm_buzzer_t *p_fsm_buzzer_rear){
         
     fsm_init((fsm_t *)p_fsm_urbanite, fsm_trans_urbanite);
 
@@ -288,17 +442,27 @@ static void fsm_urbanite_init (fsm_urbanite_t *p_fsm_urbanite, fsm_button_t *p_f
     p_fsm_urbanite->pause_display_time_ms = pause_display_time_ms;
     p_fsm_urbanite->p_fsm_ultrasound_rear = p_fsm_ultrasound_rear;
     p_fsm_urbanite->p_fsm_display_rear = p_fsm_display_rear;
+    p_fsm_urbanite->p_fsm_buzzer_rear = p_fsm_buzzer_rear;
+    // The buzzer follows the band table of the display, so both agree on the urgency of a distance, also while paused
+    fsm_buzzer_set_display(p_fsm_buzzer_rear, p_fsm_display_rear);
 
     p_fsm_urbanite->is_paused = false;
+    p_fsm_urbanite->p_power_stats = NULL;
+    p_fsm_urbanite->p_flash_log = NULL;
+    p_fsm_urbanite->p_transition_trace = NULL;
+    p_fsm_urbanite->min_obstacle_cm = 0;
+
+    // The on/off command is a long press, reported while the button is still held. No command uses double clicks, so clicks are reported without waiting for a second one
+    fsm_button_set_gesture_times(p_fsm_button, on_off_press_time_ms, 0, FSM_BUTTON_DEFAULT_REPEAT_MS);
 }
 
 
 
-fsm_urbanite_t *fsm_urbanite_new (fsm_button_t *p_fsm_button, uint32_t on_off_press_time_ms, uint32_t pause_display_time_ms, fsm_ultrasound_t *p_fsm_ultrasound_rear, fsm_display_t *p_fsm_display_rear){
+fsm_urbanite_t *fsm_urbanite_new (fsm_button_t *p_fsm_button, uint32_t on_off_press_time_ms, uint32_t pause_display_time_ms, fsm_ultrasound_t *p_fsm_ultrasound_rear, fsm_display_t *p_fsm_display_rear, fsm_buzzer_t *p_fsm_buzzer_rear){
 
         fsm_urbanite_t *p_fsm_urbanite = (fsm_urbanite_t *)malloc(sizeof(fsm_urbanite_t));
 
-        fsm_urbanite_init(p_fsm_urbanite, p_fsm_button, on_off_press_time_ms, pause_display_time_ms, p_fsm_ultrasound_rear, p_fsm_display_rear);
+        fsm_urbanite_init(p_fsm_urbanite, p_fsm_button, on_off_press_time_ms, pause_display_time_ms, p_fsm_ultrasound_rear, p_fsm_display_rear, p_fsm_buzzer_rear);
     
         return p_fsm_urbanite;
 }
@@ -306,10 +470,66 @@ fsm_urbanite_t *fsm_urbanite_new (fsm_button_t *p_fsm_button, uint32_t on_off_pr
 
 void fsm_urbanite_fire (fsm_urbanite_t *p_fsm_urbanite){
     fsm_fire(&p_fsm_urbanite->f);
+    _trace(p_fsm_urbanite);
+    if (p_fsm_urbanite->p_power_stats != NULL){
+        power_stats_set_state(p_fsm_urbanite->p_power_stats, (uint8_t)p_fsm_urbanite->f.current_state, port_system_get_power_clock_us());
+    }
+}
+
+
+void fsm_urbanite_set_power_stats (fsm_urbanite_t *p_fsm, power_stats_t *p_power_stats){
+    p_fsm->p_power_stats = p_power_stats;
+    if (p_power_stats != NULL){
+        power_stats_init(p_power_stats, (uint8_t)p_fsm->f.current_state, port_system_get_power_clock_us());
+    }
 }
  
 
 
+void fsm_urbanite_set_flash_log (fsm_urbanite_t *p_fsm, flash_log_t *p_flash_log){
+    p_fsm->p_flash_log = p_flash_log;
+}
+
+
+void fsm_urbanite_set_transition_trace (fsm_urbanite_t *p_fsm, transition_trace_t *p_trace){
+    p_fsm->p_transition_trace = p_trace;
+    p_fsm->traced_state = p_fsm->f.current_state;
+}
+
+
+uint32_t fsm_urbanite_get_state (fsm_urbanite_t *p_fsm){
+    return p_fsm->f.current_state;
+}
+
+
+void fsm_urbanite_set_press_times (fsm_urbanite_t *p_fsm, uint32_t on_off_press_time_ms, uint32_t pause_display_time_ms){
+    p_fsm->on_off_press_time_ms = on_off_press_time_ms;
+    p_fsm->pause_display_time_ms = pause_display_time_ms;
+    fsm_button_set_gesture_times(p_fsm->p_fsm_button, on_off_press_time_ms, 0, FSM_BUTTON_DEFAULT_REPEAT_MS);
+}
+
+
+uint32_t fsm_urbanite_get_on_off_press_time_ms (fsm_urbanite_t *p_fsm){
+    return p_fsm->on_off_press_time_ms;
+}
+
+
+uint32_t fsm_urbanite_get_pause_display_time_ms (fsm_urbanite_t *p_fsm){
+    return p_fsm->pause_display_time_ms;
+}
+
+
+void fsm_urbanite_set_min_obstacle_distance (fsm_urbanite_t *p_fsm, uint32_t min_obstacle_cm){
+    p_fsm->min_obstacle_cm = min_obstacle_cm;
+}
+
+
+uint32_t fsm_urbanite_get_min_obstacle_distance (fsm_urbanite_t *p_fsm){
+    return p_fsm->min_obstacle_cm;
+}
+
+
+
 void fsm_urbanite_destroy (fsm_urbanite_t *p_fsm){
     free(&p_fsm->f);
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+/**
+ * @file latency_probe.c
+ * @brief Histogram of the latencies of a path of the system.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <string.h>
+
+/* Other includes */
+#include "latency_probe.h"
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Returns the bucket of a latency.
+ *
+ * @param latency_us Latency, in us.
+ *
+ * @return uint32_t Index of the bucket.
+ */
+static uint32_t _bucket(uint32_t latency_us)
+{
+    if (latency_us < LATENCY_PROBE_LINEAR_US)
+    {
+        return latency_us;
+    }
+    // Position of the most significant bit, and the next bits as the sub-bucket
+    uint32_t msb = LATENCY_PROBE_SUB_BUCKET_BITS + 1;
+    while ((msb + 1 < 32) && (latency_us >> (msb + 1)) != 0)
+    {
+        msb++;
+    }
+    if (msb >= LATENCY_PROBE_MAX_BITS)
+    {
+        return LATENCY_PROBE_NUM_BUCKETS - 1;
+    }
+    uint32_t sub = (latency_us >> (msb - LATENCY_PROBE_SUB_BUCKET_BITS)) & (LATENCY_PROBE_SUB_BUCKETS - 1);
+    return LATENCY_PROBE_LINEAR_US + (msb - LATENCY_PROBE_SUB_BUCKET_BITS - 1) * LATENCY_PROBE_SUB_BUCKETS + sub;
+}
+
+/**
+ * @brief Returns the highest latency of a bucket.
+ *
+ * @param bucket Index of the bucket.
+ *
+ * @return uint32_t Latency, in us.
+ */
+static uint32_t _bucket_max_us(uint32_t bucket)
+{
+    if (bucket < LATENCY_PROBE_LINEAR_US)
+    {
+        return bucket;
+    }
+    if (bucket >= LATENCY_PROBE_NUM_BUCKETS - 1)
+    {
+        return UINT32_MAX;
+    }
+    uint32_t shift = (bucket - LATENCY_PROBE_LINEAR_US) / LATENCY_PROBE_SUB_BUCKETS + 1;
+    uint32_t sub = (bucket - LATENCY_PROBE_LINEAR_US) % LATENCY_PROBE_SUB_BUCKETS;
+    return ((LATENCY_PROBE_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void latency_probe_init(latency_probe_t *p_probe)
+{
+    memset(p_probe, 0, sizeof(*p_probe));
+    p_probe->min_us = UINT32_MAX;
+}
+
+void latency_probe_record(latency_probe_t *p_probe, uint32_t latency_us)
+{
+    p_probe->buckets[_bucket(latency_us)]++;
+    p_probe->count++;
+    p_probe->sum_us += latency_us;
+    p_probe->last_us = latency_us;
+    if (latency_us < p_probe->min_us)
+    {
+        p_probe->min_us = latency_us;
+    }
+    if (latency_us > p_probe->max_us)
+    {
+        p_probe->max_us = latency_us;
+    }
+}
+
+uint32_t latency_probe_get_percentile_us(latency_probe_t *p_probe, uint32_t permille)
+{
+    if (p_probe->count == 0)
+    {
+        return 0;
+    }
+    // Rank of the percentile, rounded up so that the 1000 per mille is the maximum
+    uint64_t rank = ((uint64_t)p_probe->count * permille + 999U) / 1000U;
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    uint32_t bucket = 0;
+    for (; bucket < LATENCY_PROBE_NUM_BUCKETS - 1; bucket++)
+    {
+        seen += p_probe->buckets[bucket];
+        if (seen >= rank)
+        {
+            break;
+        }
+    }
+    uint32_t latency_us = _bucket_max_us(bucket);
+    if (latency_us > p_probe->max_us)
+    {
+        latency_us = p_probe->max_us;
+    }
+    return (latency_us < p_probe->min_us) ? p_probe->min_us : latency_us;
+}
+
+void latency_probe_print(latency_probe_t *p_probe, const char *p_name)
+{
+    if (p_probe->count == 0)
+    {
+        printf("[LATENCY] %s: no samples\n", p_name);
+        return;
+    }
+    printf("[LATENCY] %s: %lu samples, min %lu us, p50 %lu us, p99 %lu us, max %lu us, mean %lu us\n", p_name, (unsigned long)p_probe->count,
+           (unsigned long)p_probe->min_us, (unsigned long)latency_probe_get_percentile_us(p_probe, 500), (unsigned long)latency_probe_get_percentile_us(p_probe, 990),
+           (unsigned long)p_probe->max_us, (unsigned long)(p_probe->sum_us / p_probe->count));
+}
@@ -0,0 +1,221 @@
+/**
+ * @file power_stats.c
+ * @brief Accounting of the time and the energy spent in each power mode for each state of an FSM.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_system.h"
+
+/* Other includes */
+#include "power_stats.h"
+
+/* Global variables -----------------------------------------------------------*/
+static const uint32_t default_current_ua[POWER_STATS_NUM_MODES] = {POWER_STATS_DEFAULT_RUN_UA, POWER_STATS_DEFAULT_SLEEP_UA, POWER_STATS_DEFAULT_STOP_UA}; /*!< Default current table */
+static const char *const mode_names[POWER_STATS_NUM_MODES] = {"run", "sleep", "stop"}; /*!< Names of the power modes */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Limits a state to the states accounted.
+ *
+ * @param state State.
+ *
+ * @return uint8_t Index of the state in the tables.
+ */
+static uint8_t _state_index(uint8_t state)
+{
+    return (state < POWER_STATS_MAX_STATES) ? state : POWER_STATS_MAX_STATES - 1;
+}
+
+/**
+ * @brief Converts a time in a power mode into energy.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param time_us Time in us.
+ * @param mode Power mode.
+ *
+ * @return uint64_t Energy in uJ.
+ */
+static uint64_t _energy_uj(power_stats_t *p_stats, uint64_t time_us, uint8_t mode)
+{
+    // uA x us = pC; the charge is kept in nC so that days of residency do not overflow
+    uint64_t charge_nc = (time_us * p_stats->current_ua[mode]) / 1000U;
+    return (charge_nc * p_stats->voltage_mv) / 1000000U;
+}
+
+/**
+ * @brief Accounts a change of state, of power mode or both.
+ *
+ * @param p_stats Pointer to the accounting.
+ * @param state New state.
+ * @param mode New power mode.
+ * @param now_us Current time of the power clock.
+ */
+static void _account(power_stats_t *p_stats, uint8_t state, uint8_t mode, uint64_t now_us)
+{
+    power_stats_update(p_stats, now_us);
+    if (state != p_stats->state)
+    {
+        p_stats->num_state_changes++;
+    }
+    if (state != p_stats->state || mode != p_stats->mode)
+    {
+        p_stats->num_entries[_state_index(state)][mode]++;
+    }
+    p_stats->state = state;
+    p_stats->mode = mode;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void power_stats_init(power_stats_t *p_stats, uint8_t state, uint64_t now_us)
+{
+    memset(p_stats, 0, sizeof(*p_stats));
+    power_stats_set_current_table(p_stats, default_current_ua, POWER_STATS_DEFAULT_VOLTAGE_MV);
+    p_stats->state = state;
+    p_stats->mode = POWER_STATS_MODE_RUN;
+    p_stats->num_entries[_state_index(state)][POWER_STATS_MODE_RUN] = 1;
+    p_stats->start_us = now_us;
+    p_stats->last_us = now_us;
+    p_stats->magic = POWER_STATS_MAGIC;
+}
+
+void power_stats_set_current_table(power_stats_t *p_stats, const uint32_t *p_current_ua, uint32_t voltage_mv)
+{
+    memcpy(p_stats->current_ua, p_current_ua, sizeof(p_stats->current_ua));
+    p_stats->voltage_mv = voltage_mv;
+}
+
+void power_stats_set_state(power_stats_t *p_stats, uint8_t state, uint64_t now_us)
+{
+    if (state != p_stats->state)
+    {
+        _account(p_stats, state, p_stats->mode, now_us);
+    }
+}
+
+void power_stats_set_mode(power_stats_t *p_stats, uint8_t mode, uint64_t now_us)
+{
+    if (mode != p_stats->mode && mode < POWER_STATS_NUM_MODES)
+    {
+        _account(p_stats, p_stats->state, mode, now_us);
+    }
+}
+
+void power_stats_update(power_stats_t *p_stats, uint64_t now_us)
+{
+    if (now_us > p_stats->last_us)
+    {
+        p_stats->residency_us[_state_index(p_stats->state)][p_stats->mode] += now_us - p_stats->last_us;
+        p_stats->last_us = now_us;
+    }
+}
+
+void power_stats_sleep(power_stats_t *p_stats)
+{
+    if (p_stats == NULL)
+    {
+        port_system_sleep();
+        return;
+    }
+    power_stats_set_mode(p_stats, POWER_STATS_MODE_SLEEP, port_system_get_power_clock_us());
+    port_system_sleep();
+    power_stats_set_mode(p_stats, POWER_STATS_MODE_RUN, port_system_get_power_clock_us());
+}
+
+void power_stats_sleep_tick(power_stats_t *p_stats)
+{
+    if (p_stats == NULL)
+    {
+        port_system_power_sleep();
+        return;
+    }
+    power_stats_set_mode(p_stats, POWER_STATS_MODE_SLEEP, port_system_get_power_clock_us());
+    port_system_power_sleep();
+    power_stats_set_mode(p_stats, POWER_STATS_MODE_RUN, port_system_get_power_clock_us());
+}
+
+void power_stats_stop(power_stats_t *p_stats)
+{
+    if (p_stats == NULL)
+    {
+        port_system_power_stop();
+        return;
+    }
+    power_stats_set_mode(p_stats, POWER_STATS_MODE_STOP, port_system_get_power_clock_us());
+    port_system_power_stop();
+    power_stats_set_mode(p_stats, POWER_STATS_MODE_RUN, port_system_get_power_clock_us());
+}
+
+uint64_t power_stats_get_residency_us(power_stats_t *p_stats, uint8_t state, uint8_t mode)
+{
+    return (mode < POWER_STATS_NUM_MODES) ? p_stats->residency_us[_state_index(state)][mode] : 0;
+}
+
+uint32_t power_stats_get_cpu_load_permille(power_stats_t *p_stats)
+{
+    uint64_t run_us = 0;
+    uint64_t total_us = 0;
+    for (uint8_t state = 0; state < POWER_STATS_MAX_STATES; state++)
+    {
+        run_us += p_stats->residency_us[state][POWER_STATS_MODE_RUN];
+        for (uint8_t mode = 0; mode < POWER_STATS_NUM_MODES; mode++)
+        {
+            total_us += p_stats->residency_us[state][mode];
+        }
+    }
+    return (total_us > 0) ? (uint32_t)((run_us * 1000U) / total_us) : 0;
+}
+
+uint64_t power_stats_get_energy_uj(power_stats_t *p_stats, uint8_t state)
+{
+    uint64_t energy_uj = 0;
+    for (uint8_t mode = 0; mode < POWER_STATS_NUM_MODES; mode++)
+    {
+        energy_uj += _energy_uj(p_stats, p_stats->residency_us[_state_index(state)][mode], mode);
+    }
+    return energy_uj;
+}
+
+uint64_t power_stats_get_total_energy_uj(power_stats_t *p_stats)
+{
+    uint64_t energy_uj = 0;
+    for (uint8_t state = 0; state < POWER_STATS_MAX_STATES; state++)
+    {
+        energy_uj += power_stats_get_energy_uj(p_stats, state);
+    }
+    return energy_uj;
+}
+
+void power_stats_print(power_stats_t *p_stats, const char *const *p_state_names, uint8_t num_states)
+{
+    uint64_t total_us = p_stats->last_us - p_stats->start_us;
+    printf("[POWER] %lu ms accounted, CPU load %lu.%lu %%, %lu state changes, %lu uJ\n", (unsigned long)(total_us / 1000U), (unsigned long)(power_stats_get_cpu_load_permille(p_stats) / 10U), (unsigned long)(power_stats_get_cpu_load_permille(p_stats) % 10U), (unsigned long)p_stats->num_state_changes, (unsigned long)power_stats_get_total_energy_uj(p_stats));
+    for (uint8_t state = 0; state < num_states && state < POWER_STATS_MAX_STATES; state++)
+    {
+        for (uint8_t mode = 0; mode < POWER_STATS_NUM_MODES; mode++)
+        {
+            uint64_t residency_us = p_stats->residency_us[state][mode];
+            if (residency_us == 0 && p_stats->num_entries[state][mode] == 0)
+            {
+                continue;
+            }
+            if (p_state_names != NULL)
+            {
+                printf("[POWER] %-16s", p_state_names[state]);
+            }
+            else
+            {
+                printf("[POWER] state %-10u", state);
+            }
+            printf(" %-5s %10lu ms %8lu entries %10lu uJ\n", mode_names[mode], (unsigned long)(residency_us / 1000U), (unsigned long)p_stats->num_entries[state][mode], (unsigned long)_energy_uj(p_stats, residency_us, mode));
+        }
+    }
+}
@@ -0,0 +1,146 @@
+/**
+ * @file ranging_stats.c
+ * @brief Running statistics of the pings of an ultrasound sensor.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <string.h>
+
+/* Other includes */
+#include "ranging_stats.h"
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Updates the smoothed period and jitter with the time of a ping.
+ *
+ * @param p_stats Pointer to the statistics.
+ * @param time_us Time of the ping, in us.
+ */
+static void _update_timing(ranging_stats_t *p_stats, uint32_t time_us)
+{
+    uint32_t interval_us = time_us - p_stats->last_ping_us;
+    p_stats->last_ping_us = time_us;
+    if (p_stats->num_times == 0 || interval_us > RANGING_STATS_MAX_INTERVAL_US)
+    {
+        p_stats->num_times = 1; // First ping of a run
+        return;
+    }
+
+    int32_t interval_q4 = (int32_t)(interval_us << 4);
+    if (p_stats->period_q4 == 0)
+    {
+        p_stats->period_q4 = (uint32_t)interval_q4;
+    }
+    else
+    {
+        p_stats->period_q4 = (uint32_t)((int32_t)p_stats->period_q4 + ((interval_q4 - (int32_t)p_stats->period_q4) >> RANGING_STATS_GAIN_SHIFT));
+    }
+    if (p_stats->num_times == 2)
+    {
+        int32_t change_q4 = (int32_t)(interval_us << 4) - (int32_t)(p_stats->last_interval_us << 4);
+        if (change_q4 < 0)
+        {
+            change_q4 = -change_q4;
+        }
+        p_stats->jitter_q4 = (uint32_t)((int32_t)p_stats->jitter_q4 + ((change_q4 - (int32_t)p_stats->jitter_q4) >> RANGING_STATS_GAIN_SHIFT));
+    }
+    p_stats->last_interval_us = interval_us;
+    p_stats->num_times = 2;
+}
+
+/**
+ * @brief Adds a distance in range with Welford's algorithm.
+ *
+ * @param p_stats Pointer to the statistics.
+ * @param distance_cm Distance, in cm (up to `RANGING_STATS_MAX_RANGE_CM`).
+ */
+static void _update_distance(ranging_stats_t *p_stats, uint32_t distance_cm)
+{
+    p_stats->num_samples++;
+    if (p_stats->num_samples == 1 || distance_cm < p_stats->min_cm)
+    {
+        p_stats->min_cm = distance_cm;
+    }
+    if (distance_cm > p_stats->max_cm)
+    {
+        p_stats->max_cm = distance_cm;
+    }
+
+    // The mean moves towards the sample but never past it, so both deviations have the same sign and their product is never negative
+    int64_t sample_q16 = (int64_t)distance_cm << RANGING_STATS_FRAC_BITS;
+    int64_t delta_q16 = sample_q16 - p_stats->mean_q16;
+    int64_t mean_q16 = p_stats->mean_q16 + delta_q16 / (int64_t)p_stats->num_samples;
+    p_stats->mean_q16 = (uint32_t)mean_q16;
+    p_stats->m2_q16 += (uint64_t)((delta_q16 * (sample_q16 - mean_q16)) >> RANGING_STATS_FRAC_BITS);
+}
+
+/* Public functions -----------------------------------------------------------*/
+void ranging_stats_init(ranging_stats_t *p_stats)
+{
+    memset(p_stats, 0, sizeof(*p_stats));
+}
+
+void ranging_stats_restart(ranging_stats_t *p_stats)
+{
+    p_stats->num_times = 0;
+}
+
+void ranging_stats_add_ping(ranging_stats_t *p_stats, uint32_t time_us, uint32_t echo_us, uint32_t distance_cm, bool overflow)
+{
+    p_stats->num_pings++;
+    if (overflow)
+    {
+        p_stats->num_overflows++;
+    }
+    _update_timing(p_stats, time_us);
+
+    if (echo_us >= RANGING_STATS_TIMEOUT_ECHO_US)
+    {
+        p_stats->num_timeouts++;
+    }
+    else if (distance_cm < RANGING_STATS_MIN_RANGE_CM || distance_cm > RANGING_STATS_MAX_RANGE_CM)
+    {
+        p_stats->num_out_of_range++;
+    }
+    else
+    {
+        _update_distance(p_stats, distance_cm);
+    }
+}
+
+void ranging_stats_get_snapshot(const ranging_stats_t *p_stats, ranging_stats_snapshot_t *p_snapshot)
+{
+    p_snapshot->num_pings = p_stats->num_pings;
+    p_snapshot->num_samples = p_stats->num_samples;
+    p_snapshot->num_timeouts = p_stats->num_timeouts;
+    p_snapshot->num_out_of_range = p_stats->num_out_of_range;
+    p_snapshot->num_overflows = p_stats->num_overflows;
+    p_snapshot->min_cm = p_stats->min_cm;
+    p_snapshot->max_cm = p_stats->max_cm;
+    p_snapshot->mean_cm_q16 = p_stats->mean_q16;
+    p_snapshot->variance_cm2_q16 = 0;
+    if (p_stats->num_samples > 1)
+    {
+        uint64_t variance_q16 = p_stats->m2_q16 / (p_stats->num_samples - 1);
+        p_snapshot->variance_cm2_q16 = (variance_q16 > UINT32_MAX) ? UINT32_MAX : (uint32_t)variance_q16;
+    }
+    p_snapshot->period_us = (p_stats->period_q4 + 8) >> 4;
+    p_snapshot->ping_rate_millihz = (p_stats->period_q4 == 0) ? 0 : (uint32_t)((16000000000ULL + p_stats->period_q4 / 2) / p_stats->period_q4);
+    p_snapshot->jitter_us = (p_stats->jitter_q4 + 8) >> 4;
+}
+
+void ranging_stats_print(const ranging_stats_snapshot_t *p_snapshot, const char *p_name)
+{
+    printf("[RANGING] %s: %lu pings, %lu.%03lu pings/s, jitter %lu us, %lu timeouts, %lu out of range, %lu overflows, %lu samples, min %lu cm, max %lu cm, mean %lu.%02lu cm, variance %lu.%02lu cm2\n",
+           p_name, (unsigned long)p_snapshot->num_pings, (unsigned long)(p_snapshot->ping_rate_millihz / 1000), (unsigned long)(p_snapshot->ping_rate_millihz % 1000),
+           (unsigned long)p_snapshot->jitter_us, (unsigned long)p_snapshot->num_timeouts, (unsigned long)p_snapshot->num_out_of_range, (unsigned long)p_snapshot->num_overflows,
+           (unsigned long)p_snapshot->num_samples, (unsigned long)p_snapshot->min_cm, (unsigned long)p_snapshot->max_cm,
+           (unsigned long)(p_snapshot->mean_cm_q16 >> RANGING_STATS_FRAC_BITS), (unsigned long)(((p_snapshot->mean_cm_q16 & 0xFFFF) * 100U) >> RANGING_STATS_FRAC_BITS),
+           (unsigned long)(p_snapshot->variance_cm2_q16 >> RANGING_STATS_FRAC_BITS), (unsigned long)(((p_snapshot->variance_cm2_q16 & 0xFFFF) * 100U) >> RANGING_STATS_FRAC_BITS));
+}
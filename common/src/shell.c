@@ -0,0 +1,390 @@
+/**
+ * @file shell.c
+ * @brief Command shell to tune the parameters of the system at runtime: incremental line parser, table of parameters and commands.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_shell.h"
+
+/* Other includes */
+#include "shell.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define SHELL_CHAR_BS 0x08  /*!< Backspace */
+#define SHELL_CHAR_DEL 0x7F /*!< Delete, sent by most terminals for the backspace key */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Handler of a command.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param argc Number of words of the command line, the command included.
+ * @param argv Words of the command line.
+ *
+ * @retval true if the command has been executed.
+ * @retval false if it has been rejected.
+ */
+typedef bool (shell_command_handler_t)(shell_t *p_shell, uint32_t argc, char *argv[]);
+
+/**
+ * @brief Structure representing a command of the shell.
+ */
+typedef struct
+{
+    const char *p_name;                /*!< Name of the command.*/
+    shell_command_handler_t *p_handler; /*!< Handler of the command.*/
+    const char *p_usage;               /*!< Usage of the command, for `help`.*/
+} shell_command_t;
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Parses the value of a parameter: decimal, or hexadecimal with `0x`.
+ *
+ * @param p_text Text of the value.
+ * @param p_value Pointer to the value parsed.
+ *
+ * @retval true if the text is a valid value.
+ * @retval false if it is not a number, or it does not fit in 32 bits.
+ */
+static bool _parse_value(const char *p_text, uint32_t *p_value)
+{
+    int base = 10;
+    if (p_text[0] == '0' && (p_text[1] == 'x' || p_text[1] == 'X'))
+    {
+        base = 16;
+        p_text += 2;
+    }
+    // strtoull() would also accept a sign and leading spaces
+    if (!((p_text[0] >= '0' && p_text[0] <= '9') || (base == 16 && ((p_text[0] >= 'a' && p_text[0] <= 'f') || (p_text[0] >= 'A' && p_text[0] <= 'F')))))
+    {
+        return false;
+    }
+    char *p_end = NULL;
+    unsigned long long value = strtoull(p_text, &p_end, base);
+    if (*p_end != '\0' || value > UINT32_MAX)
+    {
+        return false;
+    }
+    *p_value = (uint32_t)value;
+    return true;
+}
+
+/**
+ * @brief Finds a parameter by its name, and writes an error if there is none.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param p_name Name of the parameter.
+ *
+ * @return Pointer to the parameter, or NULL.
+ */
+static const shell_param_t *_get_param(shell_t *p_shell, const char *p_name)
+{
+    const shell_param_t *p_param = shell_find_param(p_shell, p_name);
+    if (p_param == NULL)
+    {
+        shell_printf(p_shell, "error: unknown parameter %s\n", p_name);
+    }
+    return p_param;
+}
+
+static bool _command_help(shell_t *p_shell, uint32_t argc, char *argv[]);
+
+/**
+ * @brief Writes the value of a parameter, or of all of them.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param argc Number of words of the command line.
+ * @param argv Words of the command line.
+ *
+ * @retval true if the values have been written.
+ * @retval false if the parameter does not exist.
+ */
+static bool _command_get(shell_t *p_shell, uint32_t argc, char *argv[])
+{
+    if (argc == 1)
+    {
+        for (uint32_t i = 0; i < p_shell->num_params; i++)
+        {
+            shell_printf(p_shell, "%s = %lu\n", p_shell->p_params[i].p_name, (unsigned long)*p_shell->p_params[i].p_value);
+        }
+        return true;
+    }
+    const shell_param_t *p_param = _get_param(p_shell, argv[1]);
+    if (p_param == NULL)
+    {
+        return false;
+    }
+    shell_printf(p_shell, "%s = %lu\n", p_param->p_name, (unsigned long)*p_param->p_value);
+    return true;
+}
+
+/**
+ * @brief Changes a parameter. The value is checked against the range of the parameter, applied by its setter, if any, and then stored.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param argc Number of words of the command line.
+ * @param argv Words of the command line.
+ *
+ * @retval true if the parameter has been changed.
+ * @retval false if the parameter does not exist, or the value is invalid or rejected.
+ */
+static bool _command_set(shell_t *p_shell, uint32_t argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        shell_printf(p_shell, "error: usage: set <name> <value>\n");
+        return false;
+    }
+    const shell_param_t *p_param = _get_param(p_shell, argv[1]);
+    if (p_param == NULL)
+    {
+        return false;
+    }
+    uint32_t value;
+    if (!_parse_value(argv[2], &value))
+    {
+        shell_printf(p_shell, "error: invalid value %s\n", argv[2]);
+        return false;
+    }
+    if (value < p_param->min || value > p_param->max)
+    {
+        shell_printf(p_shell, "error: %s must be in [%lu, %lu]\n", p_param->p_name, (unsigned long)p_param->min, (unsigned long)p_param->max);
+        return false;
+    }
+    if (p_param->p_set != NULL && !p_param->p_set(p_shell->p_ctx, p_param, value))
+    {
+        shell_printf(p_shell, "error: %s %lu rejected\n", p_param->p_name, (unsigned long)value);
+        return false;
+    }
+    *p_param->p_value = value;
+    shell_printf(p_shell, "%s = %lu\n", p_param->p_name, (unsigned long)value);
+    return true;
+}
+
+/**
+ * @brief Writes the statistics of the system, followed by those of the shell.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param argc Number of words of the command line.
+ * @param argv Words of the command line.
+ *
+ * @retval true always.
+ */
+static bool _command_stats(shell_t *p_shell, uint32_t argc, char *argv[])
+{
+    if (p_shell->p_stats != NULL)
+    {
+        p_shell->p_stats(p_shell->p_ctx, p_shell);
+    }
+    shell_printf(p_shell, "shell: %lu commands, %lu errors, %lu bytes lost\n", (unsigned long)p_shell->num_commands, (unsigned long)p_shell->num_errors,
+                 (unsigned long)port_shell_get_num_overruns());
+    return true;
+}
+
+/**
+ * @brief Commands of the shell.
+ */
+static const shell_command_t commands[] = {
+    {"help", _command_help, "help [name]"},
+    {"get", _command_get, "get [name]"},
+    {"set", _command_set, "set <name> <value>"},
+    {"stats", _command_stats, "stats"},
+};
+
+/**
+ * @brief Lists the commands and the names of the parameters, or describes a parameter.
+ *
+ * @param p_shell Pointer to the shell.
+ * @param argc Number of words of the command line.
+ * @param argv Words of the command line.
+ *
+ * @retval true if the help has been written.
+ * @retval false if the parameter does not exist.
+ */
+static bool _command_help(shell_t *p_shell, uint32_t argc, char *argv[])
+{
+    if (argc == 1)
+    {
+        // Few lines, so that the replies fit in the telemetry ring at once
+        char text[SHELL_REPLY_SIZE];
+        uint32_t length = (uint32_t)snprintf(text, sizeof(text), "commands:");
+        for (uint32_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+        {
+            length += (uint32_t)snprintf(&text[length], sizeof(text) - length, " %s,", commands[i].p_usage);
+        }
+        text[length - 1] = '\n';
+        p_shell->p_write(p_shell->p_ctx, text, length);
+
+        length = (uint32_t)snprintf(text, sizeof(text), "params:");
+        for (uint32_t i = 0; i < p_shell->num_params; i++)
+        {
+            uint32_t name_length = (uint32_t)strlen(p_shell->p_params[i].p_name);
+            if (length + 1 + name_length + 1 > sizeof(text))
+            {
+                p_shell->p_write(p_shell->p_ctx, text, length);
+                length = 0;
+            }
+            text[length++] = ' ';
+            memcpy(&text[length], p_shell->p_params[i].p_name, name_length);
+            length += name_length;
+        }
+        text[length++] = '\n';
+        p_shell->p_write(p_shell->p_ctx, text, length);
+        return true;
+    }
+    const shell_param_t *p_param = _get_param(p_shell, argv[1]);
+    if (p_param == NULL)
+    {
+        return false;
+    }
+    shell_printf(p_shell, "%s: %s [%lu, %lu]\n", p_param->p_name, p_param->p_help, (unsigned long)p_param->min, (unsigned long)p_param->max);
+    return true;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void shell_init(shell_t *p_shell, const shell_param_t *p_params, uint32_t num_params, shell_write_t *p_write, shell_stats_t *p_stats, void *p_ctx)
+{
+    memset(p_shell, 0, sizeof(*p_shell));
+    p_shell->p_params = p_params;
+    p_shell->num_params = num_params;
+    p_shell->p_write = p_write;
+    p_shell->p_stats = p_stats;
+    p_shell->p_ctx = p_ctx;
+    port_shell_init();
+}
+
+void shell_service(shell_t *p_shell)
+{
+    uint8_t byte;
+    while (port_shell_read(&byte))
+    {
+        shell_feed(p_shell, (char)byte);
+    }
+}
+
+bool shell_feed(shell_t *p_shell, char c)
+{
+    if (c == '\r' || c == '\n')
+    {
+        // A CR LF ends a line and then an empty line, which is ignored
+        bool overflow = p_shell->overflow;
+        uint32_t length = p_shell->length;
+        p_shell->overflow = false;
+        p_shell->length = 0;
+        if (overflow)
+        {
+            p_shell->num_commands++;
+            p_shell->num_errors++;
+            shell_printf(p_shell, "error: line longer than %u characters\n", SHELL_LINE_SIZE - 1);
+            return true;
+        }
+        if (length == 0)
+        {
+            return false;
+        }
+        p_shell->line[length] = '\0';
+        shell_execute(p_shell, p_shell->line);
+        return true;
+    }
+    if (c == SHELL_CHAR_BS || c == SHELL_CHAR_DEL)
+    {
+        if (p_shell->length > 0)
+        {
+            p_shell->length--;
+        }
+        return false;
+    }
+    if (c < ' ' || c > '~')
+    {
+        return false;
+    }
+    if (p_shell->length < SHELL_LINE_SIZE - 1)
+    {
+        p_shell->line[p_shell->length++] = c;
+    }
+    else
+    {
+        p_shell->overflow = true;
+    }
+    return false;
+}
+
+bool shell_execute(shell_t *p_shell, char *p_line)
+{
+    char *argv[SHELL_MAX_ARGS];
+    uint32_t argc = 0;
+    char *p_word = strtok(p_line, " \t");
+    while (p_word != NULL)
+    {
+        if (argc == SHELL_MAX_ARGS)
+        {
+            p_shell->num_commands++;
+            p_shell->num_errors++;
+            shell_printf(p_shell, "error: too many arguments\n");
+            return false;
+        }
+        argv[argc++] = p_word;
+        p_word = strtok(NULL, " \t");
+    }
+    if (argc == 0)
+    {
+        return true;
+    }
+
+    p_shell->num_commands++;
+    for (uint32_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+    {
+        if (strcmp(argv[0], commands[i].p_name) == 0)
+        {
+            bool ok = commands[i].p_handler(p_shell, argc, argv);
+            if (!ok)
+            {
+                p_shell->num_errors++;
+            }
+            return ok;
+        }
+    }
+    p_shell->num_errors++;
+    shell_printf(p_shell, "error: unknown command %s, try help\n", argv[0]);
+    return false;
+}
+
+const shell_param_t *shell_find_param(const shell_t *p_shell, const char *p_name)
+{
+    for (uint32_t i = 0; i < p_shell->num_params; i++)
+    {
+        if (strcmp(p_name, p_shell->p_params[i].p_name) == 0)
+        {
+            return &p_shell->p_params[i];
+        }
+    }
+    return NULL;
+}
+
+void shell_printf(shell_t *p_shell, const char *p_format, ...)
+{
+    char text[SHELL_REPLY_SIZE];
+    va_list args;
+    va_start(args, p_format);
+    int length = vsnprintf(text, sizeof(text), p_format, args);
+    va_end(args);
+    if (length < 0)
+    {
+        return;
+    }
+    if ((uint32_t)length >= sizeof(text))
+    {
+        length = sizeof(text) - 1;
+    }
+    p_shell->p_write(p_shell->p_ctx, text, (uint32_t)length);
+}
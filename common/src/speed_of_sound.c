@@ -0,0 +1,36 @@
+/**
+ * @file speed_of_sound.c
+ * @brief Speed of sound in air as a function of the temperature.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Project includes */
+#include "speed_of_sound.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define SPEED_OF_SOUND_SCALE_DIVISOR 20000000ULL /*!< Product of the round trip (2) and the units of the scale: mm/s x us = 10^-9 m, and a cm is 10^7 of them */
+
+/* Public functions -----------------------------------------------------------*/
+uint32_t speed_of_sound_get_mm_s(int32_t temperature_dc)
+{
+    if (temperature_dc < SPEED_OF_SOUND_MIN_TEMPERATURE_DC)
+    {
+        temperature_dc = SPEED_OF_SOUND_MIN_TEMPERATURE_DC;
+    }
+    else if (temperature_dc > SPEED_OF_SOUND_MAX_TEMPERATURE_DC)
+    {
+        temperature_dc = SPEED_OF_SOUND_MAX_TEMPERATURE_DC;
+    }
+    // The slope is per 10 ºC and the temperature in tenths of ºC, rounded half away from zero
+    int32_t delta_mm_s = temperature_dc * SPEED_OF_SOUND_SLOPE_MM_S;
+    delta_mm_s = (delta_mm_s >= 0) ? (delta_mm_s + 50) / 100 : (delta_mm_s - 50) / 100;
+    return (uint32_t)(SPEED_OF_SOUND_0C_MM_S + delta_mm_s);
+}
+
+uint32_t speed_of_sound_get_scale(uint32_t speed_mm_s)
+{
+    return (uint32_t)((((uint64_t)speed_mm_s << SPEED_OF_SOUND_SCALE_SHIFT) + SPEED_OF_SOUND_SCALE_DIVISOR / 2) / SPEED_OF_SOUND_SCALE_DIVISOR);
+}
@@ -0,0 +1,353 @@
+/**
+ * @file telemetry.c
+ * @brief Binary telemetry stream: COBS-framed packets sent by DMA from a ring buffer, and their decoder.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_telemetry.h"
+
+/* Other includes */
+#include "telemetry.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TELEMETRY_RING_MASK (TELEMETRY_RING_SIZE - 1) /*!< Mask of an index of the ring */
+#define TELEMETRY_COBS_MAX_CODE 0xFF /*!< Code of a COBS block of 254 bytes not followed by a zero */
+
+#if (TELEMETRY_RING_SIZE & TELEMETRY_RING_MASK) != 0 || TELEMETRY_RING_SIZE < 2 * TELEMETRY_MAX_FRAME
+#error "TELEMETRY_RING_SIZE must be a power of 2 and hold two frames"
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief Table of the CRC-16/CCITT for a nibble, to keep the table small.
+ */
+static const uint16_t crc16_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Writes a 32-bit value in little endian.
+ *
+ * @param p_dst Pointer to the bytes.
+ * @param value Value to write.
+ */
+static void _put_u32(uint8_t *p_dst, uint32_t value)
+{
+    p_dst[0] = (uint8_t)value;
+    p_dst[1] = (uint8_t)(value >> 8);
+    p_dst[2] = (uint8_t)(value >> 16);
+    p_dst[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief Reads a 32-bit value in little endian.
+ *
+ * @param p_src Pointer to the bytes.
+ *
+ * @return uint32_t Value read.
+ */
+static uint32_t _get_u32(const uint8_t *p_src)
+{
+    return (uint32_t)p_src[0] | ((uint32_t)p_src[1] << 8) | ((uint32_t)p_src[2] << 16) | ((uint32_t)p_src[3] << 24);
+}
+
+/**
+ * @brief COBS-encodes a packet straight into the ring, followed by the delimiter. The ring must have room for `length + length / 254 + 2` bytes.
+ *
+ * @param p_telemetry Pointer to the sender.
+ * @param p_src Pointer to the packet.
+ * @param length Length of the packet, in bytes.
+ */
+static void _encode_to_ring(telemetry_t *p_telemetry, const uint8_t *p_src, uint32_t length)
+{
+    uint8_t *p_ring = p_telemetry->ring;
+    uint32_t code_index = p_telemetry->head;
+    uint32_t index = code_index + 1;
+    uint8_t code = 1;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (p_src[i] == 0)
+        {
+            p_ring[code_index & TELEMETRY_RING_MASK] = code;
+            code_index = index++;
+            code = 1;
+            continue;
+        }
+        p_ring[index++ & TELEMETRY_RING_MASK] = p_src[i];
+        if (++code == TELEMETRY_COBS_MAX_CODE)
+        {
+            p_ring[code_index & TELEMETRY_RING_MASK] = code;
+            code_index = index++;
+            code = 1;
+        }
+    }
+    p_ring[code_index & TELEMETRY_RING_MASK] = code;
+    p_ring[index++ & TELEMETRY_RING_MASK] = 0;
+    p_telemetry->head = index;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void telemetry_init(telemetry_t *p_telemetry, uint32_t period_ms)
+{
+    memset(p_telemetry, 0, sizeof(*p_telemetry));
+    p_telemetry->period_ms = period_ms;
+    port_telemetry_init();
+
+    // A leading delimiter, so that the host decodes the first packet even if the line was idle
+    p_telemetry->ring[0] = 0;
+    p_telemetry->head = 1;
+    telemetry_service(p_telemetry);
+}
+
+bool telemetry_is_due(telemetry_t *p_telemetry, uint32_t now_ms)
+{
+    if ((int32_t)(now_ms - p_telemetry->next_ms) < 0)
+    {
+        return false;
+    }
+    p_telemetry->next_ms = now_ms + p_telemetry->period_ms;
+    return true;
+}
+
+bool telemetry_send(telemetry_t *p_telemetry, uint8_t type, const void *p_payload, uint32_t length)
+{
+    if (length > TELEMETRY_MAX_PAYLOAD)
+    {
+        return false;
+    }
+
+    // Release the bytes already sent before checking the room left
+    telemetry_service(p_telemetry);
+    uint32_t packet_length = TELEMETRY_HEADER_SIZE + length + TELEMETRY_CRC_SIZE;
+    uint32_t frame_length = packet_length + packet_length / 254 + 2;
+    if (TELEMETRY_RING_SIZE - telemetry_get_pending_bytes(p_telemetry) < frame_length)
+    {
+        p_telemetry->num_dropped++;
+        return false;
+    }
+
+    uint8_t packet[TELEMETRY_MAX_PACKET];
+    packet[0] = type;
+    packet[1] = p_telemetry->sequence++;
+    memcpy(&packet[TELEMETRY_HEADER_SIZE], p_payload, length);
+    uint16_t crc = telemetry_crc16(packet, TELEMETRY_HEADER_SIZE + length);
+    packet[TELEMETRY_HEADER_SIZE + length] = (uint8_t)crc;
+    packet[TELEMETRY_HEADER_SIZE + length + 1] = (uint8_t)(crc >> 8);
+    _encode_to_ring(p_telemetry, packet, packet_length);
+    p_telemetry->num_packets++;
+
+    telemetry_service(p_telemetry);
+    return true;
+}
+
+bool telemetry_send_status(telemetry_t *p_telemetry, const telemetry_status_t *p_status)
+{
+    uint8_t payload[TELEMETRY_STATUS_SIZE];
+    _put_u32(&payload[0], p_status->timestamp_ms);
+    _put_u32(&payload[4], p_status->distance_cm);
+    payload[8] = p_status->urbanite_state;
+    payload[9] = p_status->ultrasound_state;
+    payload[10] = p_status->display_state;
+    payload[11] = p_status->buzzer_state;
+    _put_u32(&payload[12], p_telemetry->num_packets);
+    _put_u32(&payload[16], p_telemetry->num_dropped);
+    return telemetry_send(p_telemetry, TELEMETRY_PACKET_STATUS, payload, sizeof(payload));
+}
+
+bool telemetry_send_text(telemetry_t *p_telemetry, const char *p_text, uint32_t length)
+{
+    bool ok = true;
+    while (length > 0)
+    {
+        uint32_t chunk = (length < TELEMETRY_MAX_PAYLOAD) ? length : TELEMETRY_MAX_PAYLOAD;
+        ok = telemetry_send(p_telemetry, TELEMETRY_PACKET_TEXT, p_text, chunk) && ok;
+        p_text += chunk;
+        length -= chunk;
+    }
+    return ok;
+}
+
+void telemetry_service(telemetry_t *p_telemetry)
+{
+    if (p_telemetry->in_flight > 0)
+    {
+        if (port_telemetry_is_busy())
+        {
+            return;
+        }
+        p_telemetry->tail += p_telemetry->in_flight;
+        p_telemetry->in_flight = 0;
+    }
+
+    // The DMA reads contiguous bytes: up to the head, or up to the end of the ring if the frames wrap
+    uint32_t pending = p_telemetry->head - p_telemetry->tail;
+    if (pending == 0)
+    {
+        return;
+    }
+    uint32_t start = p_telemetry->tail & TELEMETRY_RING_MASK;
+    uint32_t length = TELEMETRY_RING_SIZE - start;
+    if (length > pending)
+    {
+        length = pending;
+    }
+    p_telemetry->in_flight = length;
+    p_telemetry->num_transfers++;
+    port_telemetry_start(&p_telemetry->ring[start], length);
+}
+
+uint32_t telemetry_get_pending_bytes(const telemetry_t *p_telemetry)
+{
+    return p_telemetry->head - p_telemetry->tail;
+}
+
+uint32_t telemetry_cobs_encode(const uint8_t *p_src, uint32_t length, uint8_t *p_dst)
+{
+    uint32_t code_index = 0;
+    uint32_t index = 1;
+    uint8_t code = 1;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (p_src[i] == 0)
+        {
+            p_dst[code_index] = code;
+            code_index = index++;
+            code = 1;
+            continue;
+        }
+        p_dst[index++] = p_src[i];
+        if (++code == TELEMETRY_COBS_MAX_CODE)
+        {
+            p_dst[code_index] = code;
+            code_index = index++;
+            code = 1;
+        }
+    }
+    p_dst[code_index] = code;
+    return index;
+}
+
+int32_t telemetry_cobs_decode(const uint8_t *p_src, uint32_t length, uint8_t *p_dst)
+{
+    uint32_t index = 0;
+    uint32_t out = 0;
+    while (index < length)
+    {
+        uint8_t code = p_src[index++];
+        if (code == 0 || index + code - 1 > length)
+        {
+            return -1;
+        }
+        for (uint32_t i = 1; i < code; i++)
+        {
+            if (p_src[index] == 0)
+            {
+                return -1;
+            }
+            p_dst[out++] = p_src[index++];
+        }
+        // A block shorter than the longest one ends with a zero, except the last one
+        if (code != TELEMETRY_COBS_MAX_CODE && index < length)
+        {
+            p_dst[out++] = 0;
+        }
+    }
+    return (int32_t)out;
+}
+
+uint16_t telemetry_crc16(const uint8_t *p_data, uint32_t length)
+{
+    uint16_t crc = 0xFFFF;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        crc = (uint16_t)(crc << 4) ^ crc16_table[(crc >> 12) ^ (p_data[i] >> 4)];
+        crc = (uint16_t)(crc << 4) ^ crc16_table[(crc >> 12) ^ (p_data[i] & 0x0F)];
+    }
+    return crc;
+}
+
+void telemetry_decoder_init(telemetry_decoder_t *p_decoder)
+{
+    memset(p_decoder, 0, sizeof(*p_decoder));
+}
+
+bool telemetry_decoder_feed(telemetry_decoder_t *p_decoder, uint8_t byte, telemetry_packet_t *p_packet)
+{
+    if (byte != 0)
+    {
+        if (p_decoder->length < sizeof(p_decoder->frame))
+        {
+            p_decoder->frame[p_decoder->length++] = byte;
+        }
+        else
+        {
+            p_decoder->overflow = true;
+        }
+        return false;
+    }
+
+    // A delimiter ends the frame, which is decoded only if it has been received from its start
+    uint32_t frame_length = p_decoder->length;
+    bool synced = p_decoder->synced;
+    bool overflow = p_decoder->overflow;
+    p_decoder->length = 0;
+    p_decoder->overflow = false;
+    p_decoder->synced = true;
+    if (!synced || frame_length == 0)
+    {
+        return false;
+    }
+
+    int32_t packet_length = overflow ? -1 : telemetry_cobs_decode(p_decoder->frame, frame_length, p_decoder->frame);
+    if (packet_length < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE || packet_length > TELEMETRY_MAX_PACKET)
+    {
+        p_decoder->num_errors++;
+        return false;
+    }
+    uint32_t length = (uint32_t)packet_length - TELEMETRY_CRC_SIZE;
+    uint16_t crc = (uint16_t)(p_decoder->frame[length] | (p_decoder->frame[length + 1] << 8));
+    if (telemetry_crc16(p_decoder->frame, length) != crc)
+    {
+        p_decoder->num_errors++;
+        return false;
+    }
+
+    p_packet->type = p_decoder->frame[0];
+    p_packet->sequence = p_decoder->frame[1];
+    p_packet->length = length - TELEMETRY_HEADER_SIZE;
+    memcpy(p_packet->payload, &p_decoder->frame[TELEMETRY_HEADER_SIZE], p_packet->length);
+    if (p_decoder->has_sequence)
+    {
+        p_decoder->num_lost += (uint8_t)(p_packet->sequence - p_decoder->sequence - 1);
+    }
+    p_decoder->sequence = p_packet->sequence;
+    p_decoder->has_sequence = true;
+    p_decoder->num_packets++;
+    return true;
+}
+
+bool telemetry_parse_status(const telemetry_packet_t *p_packet, telemetry_status_t *p_status)
+{
+    if (p_packet->type != TELEMETRY_PACKET_STATUS || p_packet->length != TELEMETRY_STATUS_SIZE)
+    {
+        return false;
+    }
+    const uint8_t *p_payload = p_packet->payload;
+    p_status->timestamp_ms = _get_u32(&p_payload[0]);
+    p_status->distance_cm = _get_u32(&p_payload[4]);
+    p_status->urbanite_state = p_payload[8];
+    p_status->ultrasound_state = p_payload[9];
+    p_status->display_state = p_payload[10];
+    p_status->buzzer_state = p_payload[11];
+    p_status->num_packets = _get_u32(&p_payload[12]);
+    p_status->num_dropped = _get_u32(&p_payload[16]);
+    return true;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file transition_trace.c
+ * @brief Trace of the transitions of the FSMs, kept across resets.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stddef.h>
+
+/* Project includes */
+#include "transition_trace.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define TRANSITION_TRACE_HEADER_SIZE offsetof(transition_trace_t, records) /*!< Size of the header of a trace, in bytes */
+
+_Static_assert((TRANSITION_TRACE_MAX_RECORDS & (TRANSITION_TRACE_MAX_RECORDS - 1)) == 0, "TRANSITION_TRACE_MAX_RECORDS must be a power of 2");
+_Static_assert(sizeof(transition_trace_record_t) == 8, "A record of the transition trace must be 8 bytes");
+
+/* Public functions -----------------------------------------------------------*/
+void transition_trace_init(transition_trace_t *p_trace)
+{
+    p_trace->magic = TRANSITION_TRACE_MAGIC;
+    p_trace->record_size = sizeof(transition_trace_record_t);
+    p_trace->max_records = TRANSITION_TRACE_MAX_RECORDS;
+    p_trace->num_transitions = 0;
+    p_trace->num_resets = 0;
+}
+
+bool transition_trace_restore(transition_trace_t *p_trace, uint32_t timestamp_ms)
+{
+    // After a power-on the RAM holds garbage: a trace is only kept if its whole header matches this build
+    if ((p_trace->magic != TRANSITION_TRACE_MAGIC) || (p_trace->record_size != sizeof(transition_trace_record_t)) || (p_trace->max_records != TRANSITION_TRACE_MAX_RECORDS))
+    {
+        transition_trace_init(p_trace);
+        return false;
+    }
+    p_trace->num_resets++;
+    transition_trace_add(p_trace, timestamp_ms, TRANSITION_TRACE_ID_RESET, 0, 0);
+    return true;
+}
+
+uint32_t transition_trace_get_count(const transition_trace_t *p_trace)
+{
+    return (p_trace->num_transitions < p_trace->max_records) ? p_trace->num_transitions : p_trace->max_records;
+}
+
+const transition_trace_record_t *transition_trace_get_record(const transition_trace_t *p_trace, uint32_t idx)
+{
+    uint32_t count = transition_trace_get_count(p_trace);
+    if (idx >= count)
+    {
+        return NULL;
+    }
+    // Once the buffer is full, the oldest record is the one that will be overwritten next
+    uint32_t oldest_idx = (p_trace->num_transitions > p_trace->max_records) ? p_trace->num_transitions : 0;
+    return &p_trace->records[(oldest_idx + idx) % p_trace->max_records];
+}
+
+bool transition_trace_save(const transition_trace_t *p_trace, const char *p_path)
+{
+    FILE *p_file = fopen(p_path, "wb");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    size_t size = TRANSITION_TRACE_HEADER_SIZE + (size_t)p_trace->max_records * sizeof(transition_trace_record_t);
+    bool ok = fwrite(p_trace, 1, size, p_file) == size;
+    return (fclose(p_file) == 0) && ok;
+}
+
+bool transition_trace_load(transition_trace_t *p_trace, const char *p_path)
+{
+    FILE *p_file = fopen(p_path, "rb");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    // The header of the file is read in place and the records are then replayed into the trace, from the oldest to the newest one
+    bool ok = (fread(p_trace, 1, TRANSITION_TRACE_HEADER_SIZE, p_file) == TRANSITION_TRACE_HEADER_SIZE) &&
+              (p_trace->magic == TRANSITION_TRACE_MAGIC) && (p_trace->record_size == sizeof(transition_trace_record_t)) && (p_trace->max_records > 0);
+    uint32_t file_max_records = ok ? p_trace->max_records : 0;
+    uint32_t file_count = ok ? transition_trace_get_count(p_trace) : 0;
+    uint32_t oldest_idx = (ok && p_trace->num_transitions > file_max_records) ? p_trace->num_transitions % file_max_records : 0;
+    uint32_t num_resets = ok ? p_trace->num_resets : 0;
+    uint32_t skipped = (file_count > TRANSITION_TRACE_MAX_RECORDS) ? file_count - TRANSITION_TRACE_MAX_RECORDS : 0;
+
+    transition_trace_init(p_trace);
+    p_trace->num_resets = num_resets;
+    for (uint32_t i = skipped; ok && i < file_count; i++)
+    {
+        transition_trace_record_t record;
+        long offset = (long)(TRANSITION_TRACE_HEADER_SIZE + ((oldest_idx + i) % file_max_records) * sizeof(transition_trace_record_t));
+        ok = (fseek(p_file, offset, SEEK_SET) == 0) && (fread(&record, sizeof(record), 1, p_file) == 1);
+        if (ok)
+        {
+            transition_trace_add(p_trace, record.timestamp_ms, record.fsm_id, record.from_state, record.to_state);
+        }
+    }
+    fclose(p_file);
+    return ok;
+}
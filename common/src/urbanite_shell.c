@@ -0,0 +1,259 @@
+/**
+ * @file urbanite_shell.c
+ * @brief Command shell of the Urbanite: table of the tunable parameters, their setters and the statistics.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+
+/* HW dependent includes */
+#include "port_system.h"
+#include "port_ultrasound.h"
+
+/* Other includes */
+#include "ranging_stats.h"
+#include "urbanite_shell.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define URBANITE_SHELL_MIN_PING_MS 30 /*!< Shortest period of the pings: the echo of an obstacle at 4 m takes 23 ms */
+#define URBANITE_SHELL_MAX_PING_MS 1000 /*!< Longest period of the pings */
+#define URBANITE_SHELL_MIN_PRESS_MS 100 /*!< Shortest hold time to switch the system on/off */
+#define URBANITE_SHELL_MAX_PRESS_MS 10000 /*!< Longest time of the commands of the button */
+#define URBANITE_SHELL_MAX_BAND_CM 1000 /*!< Largest limit of a band of the display */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the system tuned by the shell.
+ */
+typedef struct
+{
+    fsm_urbanite_t *p_fsm_urbanite;          /*!< Urbanite FSM.*/
+    fsm_ultrasound_t *p_fsm_ultrasound_rear; /*!< Rear ultrasound FSM.*/
+    fsm_display_t *p_fsm_display_rear;       /*!< Rear display FSM.*/
+    telemetry_t *p_telemetry;                /*!< Sender of the replies, or NULL.*/
+} urbanite_shell_ctx_t;
+
+/**
+ * @brief Structure representing the values of the parameters.
+ */
+typedef struct
+{
+    uint32_t on_off_press_time_ms;  /*!< Time to switch the system on/off, in ms.*/
+    uint32_t pause_display_time_ms; /*!< Time to pause/resume the display, in ms.*/
+    uint32_t ping_period_ms;        /*!< Period of the pings of the rear sensor, in ms.*/
+    uint32_t num_measurements;      /*!< Pings whose median gives a distance.*/
+    uint32_t band_max_cm[URBANITE_SHELL_NUM_BANDS]; /*!< Upper limits of the bands of the rear display, in cm.*/
+    uint32_t max_echoes;            /*!< Echoes captured in each ping of the rear sensor.*/
+    uint32_t min_obstacle_cm;       /*!< Distance below which the echoes are not obstacles, in cm.*/
+} urbanite_shell_values_t;
+
+/* Private variables ---------------------------------------------------------*/
+static urbanite_shell_ctx_t ctx;        /*!< System tuned by the shell */
+static urbanite_shell_values_t values;  /*!< Values of the parameters */
+static const char *const urbanite_state_names[] = {"OFF", "MEASURE", "SLEEP_WHILE_OFF", "SLEEP_WHILE_ON"}; /*!< Names of the states of the Urbanite FSM in the statistics */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Applies a new time of a command of the button. A click must be shorter than a long press to pause the display.
+ *
+ * @param p_ctx Pointer to the system.
+ * @param p_param Parameter being changed.
+ * @param value New time, in ms.
+ *
+ * @retval true if the times have been applied.
+ * @retval false if the pause time would not be shorter than the on/off time.
+ */
+static bool _set_press_time(void *p_ctx, const shell_param_t *p_param, uint32_t value)
+{
+    urbanite_shell_ctx_t *p_system = (urbanite_shell_ctx_t *)p_ctx;
+    uint32_t on_off_ms = (p_param->p_value == &values.on_off_press_time_ms) ? value : values.on_off_press_time_ms;
+    uint32_t pause_ms = (p_param->p_value == &values.pause_display_time_ms) ? value : values.pause_display_time_ms;
+    if (pause_ms >= on_off_ms)
+    {
+        return false;
+    }
+    fsm_urbanite_set_press_times(p_system->p_fsm_urbanite, on_off_ms, pause_ms);
+    return true;
+}
+
+/**
+ * @brief Applies a new period of the pings of the rear sensor, from the next ping.
+ *
+ * @param p_ctx Pointer to the system.
+ * @param p_param Parameter being changed.
+ * @param value New period, in ms.
+ *
+ * @retval true always.
+ */
+static bool _set_ping_period(void *p_ctx, const shell_param_t *p_param, uint32_t value)
+{
+    port_ultrasound_set_measurement_period_ms(value);
+    return true;
+}
+
+/**
+ * @brief Applies a new number of pings whose median gives a distance.
+ *
+ * @param p_ctx Pointer to the system.
+ * @param p_param Parameter being changed.
+ * @param value New number of pings.
+ *
+ * @retval true if the number has been applied.
+ * @retval false if the ultrasound FSM rejects it.
+ */
+static bool _set_num_measurements(void *p_ctx, const shell_param_t *p_param, uint32_t value)
+{
+    urbanite_shell_ctx_t *p_system = (urbanite_shell_ctx_t *)p_ctx;
+    return fsm_ultrasound_set_num_measurements(p_system->p_fsm_ultrasound_rear, value);
+}
+
+/**
+ * @brief Applies a new upper limit of a band of the rear display. The rest of the band table is kept.
+ *
+ * @param p_ctx Pointer to the system.
+ * @param p_param Parameter being changed.
+ * @param value New limit, in cm.
+ *
+ * @retval true if the band table has been loaded.
+ * @retval false if the band does not exist or the limits would not be strictly increasing.
+ */
+static bool _set_band(void *p_ctx, const shell_param_t *p_param, uint32_t value)
+{
+    urbanite_shell_ctx_t *p_system = (urbanite_shell_ctx_t *)p_ctx;
+    fsm_display_band_t bands[FSM_DISPLAY_MAX_BANDS];
+    uint32_t num_bands = fsm_display_get_bands(p_system->p_fsm_display_rear, bands, FSM_DISPLAY_MAX_BANDS);
+    uint32_t band = (uint32_t)(p_param->p_value - values.band_max_cm);
+    if (band >= num_bands)
+    {
+        return false;
+    }
+    bands[band].max_cm = (uint16_t)value;
+    return fsm_display_load_bands(p_system->p_fsm_display_rear, bands, num_bands);
+}
+
+/**
+ * @brief Applies a new number of echoes captured in each ping of the rear sensor.
+ *
+ * @param p_ctx Pointer to the system.
+ * @param p_param Parameter being changed.
+ * @param value New number of echoes.
+ *
+ * @retval true if the number has been applied.
+ * @retval false if the ultrasound FSM rejects it.
+ */
+static bool _set_max_echoes(void *p_ctx, const shell_param_t *p_param, uint32_t value)
+{
+    urbanite_shell_ctx_t *p_system = (urbanite_shell_ctx_t *)p_ctx;
+    return fsm_ultrasound_set_max_echoes(p_system->p_fsm_ultrasound_rear, value);
+}
+
+/**
+ * @brief Applies a new distance below which the echoes of the rear sensor are not obstacles.
+ *
+ * @param p_ctx Pointer to the system.
+ * @param p_param Parameter being changed.
+ * @param value New distance, in cm.
+ *
+ * @retval true always.
+ */
+static bool _set_min_obstacle(void *p_ctx, const shell_param_t *p_param, uint32_t value)
+{
+    urbanite_shell_ctx_t *p_system = (urbanite_shell_ctx_t *)p_ctx;
+    fsm_urbanite_set_min_obstacle_distance(p_system->p_fsm_urbanite, value);
+    return true;
+}
+
+/**
+ * @brief Table of the parameters of the Urbanite.
+ */
+static const shell_param_t urbanite_shell_params[] = {
+    SHELL_PARAM("on_off_ms", &values.on_off_press_time_ms, URBANITE_SHELL_MIN_PRESS_MS, URBANITE_SHELL_MAX_PRESS_MS, _set_press_time, "hold time to switch on/off, in ms"),
+    SHELL_PARAM("pause_ms", &values.pause_display_time_ms, 0, URBANITE_SHELL_MAX_PRESS_MS, _set_press_time, "shortest click to pause/resume the display, in ms"),
+    SHELL_PARAM("ping_ms", &values.ping_period_ms, URBANITE_SHELL_MIN_PING_MS, URBANITE_SHELL_MAX_PING_MS, _set_ping_period, "period of the pings of the rear sensor, in ms"),
+    SHELL_PARAM("median_n", &values.num_measurements, 1, FSM_ULTRASOUND_NUM_MEASUREMENTS, _set_num_measurements, "pings whose median gives a distance"),
+    SHELL_PARAM("band0_cm", &values.band_max_cm[0], 0, URBANITE_SHELL_MAX_BAND_CM, _set_band, "upper limit of the danger band of the display, in cm"),
+    SHELL_PARAM("band1_cm", &values.band_max_cm[1], 0, URBANITE_SHELL_MAX_BAND_CM, _set_band, "upper limit of the warning band of the display, in cm"),
+    SHELL_PARAM("band2_cm", &values.band_max_cm[2], 0, URBANITE_SHELL_MAX_BAND_CM, _set_band, "upper limit of the no problem band of the display, in cm"),
+    SHELL_PARAM("band3_cm", &values.band_max_cm[3], 0, URBANITE_SHELL_MAX_BAND_CM, _set_band, "upper limit of the info band of the display, in cm"),
+    SHELL_PARAM("band4_cm", &values.band_max_cm[4], 0, URBANITE_SHELL_MAX_BAND_CM, _set_band, "upper limit of the first OK band of the display, in cm"),
+    SHELL_PARAM("band5_cm", &values.band_max_cm[5], 0, URBANITE_SHELL_MAX_BAND_CM, _set_band, "upper limit of the display, in cm"),
+    SHELL_PARAM("echoes", &values.max_echoes, 1, FSM_ULTRASOUND_MAX_ECHOES, _set_max_echoes, "echoes captured in each ping of the rear sensor"),
+    SHELL_PARAM("min_obstacle_cm", &values.min_obstacle_cm, 0, URBANITE_SHELL_MAX_BAND_CM, _set_min_obstacle, "nearer echoes are not obstacles, in cm (0: all are)"),
+};
+
+/**
+ * @brief Writes a reply of the shell: in the telemetry stream if there is a sender, or with `printf()`.
+ *
+ * @param p_ctx Pointer to the system.
+ * @param p_text Pointer to the text.
+ * @param length Length of the text, in bytes.
+ */
+static void _write(void *p_ctx, const char *p_text, uint32_t length)
+{
+    urbanite_shell_ctx_t *p_system = (urbanite_shell_ctx_t *)p_ctx;
+    if (p_system->p_telemetry != NULL)
+    {
+        telemetry_send_text(p_system->p_telemetry, p_text, length);
+    }
+    else
+    {
+        printf("%.*s", (int)length, p_text);
+    }
+}
+
+/**
+ * @brief Writes the state of the Urbanite, the statistics of the pings of the rear sensor (if they are kept) and those of the telemetry.
+ *
+ * @param p_ctx Pointer to the system.
+ * @param p_shell Pointer to the shell.
+ */
+static void _stats(void *p_ctx, shell_t *p_shell)
+{
+    urbanite_shell_ctx_t *p_system = (urbanite_shell_ctx_t *)p_ctx;
+    uint32_t state = fsm_urbanite_get_state(p_system->p_fsm_urbanite);
+    shell_printf(p_shell, "urbanite: %s at %lu ms, rear distance %lu cm\n",
+                 (state < sizeof(urbanite_state_names) / sizeof(urbanite_state_names[0])) ? urbanite_state_names[state] : "?",
+                 (unsigned long)port_system_get_millis(), (unsigned long)fsm_ultrasound_get_last_distance(p_system->p_fsm_ultrasound_rear));
+
+    ranging_stats_snapshot_t snapshot;
+    if (fsm_ultrasound_get_stats(p_system->p_fsm_ultrasound_rear, &snapshot))
+    {
+        shell_printf(p_shell, "ranging: %lu pings, %lu.%03lu pings/s, jitter %lu us, %lu timeouts, %lu out of range\n", (unsigned long)snapshot.num_pings,
+                     (unsigned long)(snapshot.ping_rate_millihz / 1000), (unsigned long)(snapshot.ping_rate_millihz % 1000), (unsigned long)snapshot.jitter_us,
+                     (unsigned long)snapshot.num_timeouts, (unsigned long)snapshot.num_out_of_range);
+        shell_printf(p_shell, "ranging: min %lu cm, max %lu cm, mean %lu cm\n", (unsigned long)snapshot.min_cm, (unsigned long)snapshot.max_cm,
+                     (unsigned long)(snapshot.mean_cm_q16 >> RANGING_STATS_FRAC_BITS));
+    }
+    if (p_system->p_telemetry != NULL)
+    {
+        shell_printf(p_shell, "telemetry: %lu packets, %lu dropped\n", (unsigned long)p_system->p_telemetry->num_packets, (unsigned long)p_system->p_telemetry->num_dropped);
+    }
+}
+
+/* Public functions -----------------------------------------------------------*/
+void urbanite_shell_init(shell_t *p_shell, fsm_urbanite_t *p_fsm_urbanite, fsm_ultrasound_t *p_fsm_ultrasound_rear, fsm_display_t *p_fsm_display_rear, telemetry_t *p_telemetry)
+{
+    ctx.p_fsm_urbanite = p_fsm_urbanite;
+    ctx.p_fsm_ultrasound_rear = p_fsm_ultrasound_rear;
+    ctx.p_fsm_display_rear = p_fsm_display_rear;
+    ctx.p_telemetry = p_telemetry;
+
+    values.on_off_press_time_ms = fsm_urbanite_get_on_off_press_time_ms(p_fsm_urbanite);
+    values.pause_display_time_ms = fsm_urbanite_get_pause_display_time_ms(p_fsm_urbanite);
+    values.ping_period_ms = port_ultrasound_get_measurement_period_ms();
+    values.num_measurements = fsm_ultrasound_get_num_measurements(p_fsm_ultrasound_rear);
+    fsm_display_band_t bands[FSM_DISPLAY_MAX_BANDS];
+    uint32_t num_bands = fsm_display_get_bands(p_fsm_display_rear, bands, FSM_DISPLAY_MAX_BANDS);
+    for (uint32_t i = 0; i < URBANITE_SHELL_NUM_BANDS; i++)
+    {
+        values.band_max_cm[i] = (i < num_bands) ? bands[i].max_cm : 0;
+    }
+    values.max_echoes = fsm_ultrasound_get_max_echoes(p_fsm_ultrasound_rear);
+    values.min_obstacle_cm = fsm_urbanite_get_min_obstacle_distance(p_fsm_urbanite);
+
+    shell_init(p_shell, urbanite_shell_params, sizeof(urbanite_shell_params) / sizeof(urbanite_shell_params[0]), _write, _stats, &ctx);
+}
@@ -0,0 +1,5 @@
+# Footprint budgets of main on the host (bytes): only the code of the project is relevant, the C library is shared
+SET(FOOTPRINT_BUDGET_STACK 4096)   # deepest call of main plus the deepest signal handler
+
+SET(FOOTPRINT_BUDGET_FLASH_fsm_urbanite 8192)
+SET(FOOTPRINT_BUDGET_FLASH_fsm_ultrasound 8192)
@@ -0,0 +1,12 @@
+# Footprint budgets of main on the STM32F4 (bytes). The unused budgets can be removed
+SET(FOOTPRINT_BUDGET_FLASH 65536)  # the image, in the lower sectors of the flash (sectors 6 and 7 are reserved for the flash log)
+SET(FOOTPRINT_BUDGET_RAM 16384)    # data and bss, without the heap and the stack
+SET(FOOTPRINT_BUDGET_HEAP 1024)    # the FSMs are the only users of malloc
+SET(FOOTPRINT_BUDGET_STACK 2048)   # deepest call of main plus the deepest ISR
+
+# Budgets of an object: FOOTPRINT_BUDGET_FLASH_<object> and FOOTPRINT_BUDGET_RAM_<object>, with the name of the object as it appears in the report
+SET(FOOTPRINT_BUDGET_FLASH_fsm_urbanite 4096)
+SET(FOOTPRINT_BUDGET_FLASH_fsm_ultrasound 4096)
+SET(FOOTPRINT_BUDGET_FLASH_fsm_display 2048)
+SET(FOOTPRINT_BUDGET_FLASH_fsm_button 1024)
+SET(FOOTPRINT_BUDGET_FLASH_fsm_buzzer 1024)
@@ -0,0 +1,420 @@
+# Footprint report of an executable, from its linker map and from the stack usage and call graph files of GCC.
+#
+# Usage: cmake -DMAP_FILE=<main.map> [-DBUILD_DIR=<dir>] [-DTARGET_DIRS=<a,b,...>] [-DBUDGET_FILE=<budget.cmake>]
+#              [-DREPORT_FILE=<report.txt>] [-DHEAP_HIGH_WATER=<bytes>] [-DTOP_SYMBOLS=<n>] -P footprint.cmake
+#
+# - MAP_FILE: map written by GNU ld with -Wl,-Map.
+# - BUILD_DIR, TARGET_DIRS: the .su and .ci files of the objects of the targets TARGET_DIRS (CMakeFiles/<target>.dir) under BUILD_DIR give the stack estimate.
+# - BUDGET_FILE: script that sets the budgets (see budget_stm32f4.cmake). Without it, the budgets are the FLASH and RAM regions of the map.
+# - HEAP_HIGH_WATER: heap used at run time, checked against the heap budget instead of the heap reserved by the linker script.
+#
+# The sections are split into text (only in flash), data (in flash and copied to RAM) and bss (only in RAM), and accounted to the object file and to the
+# symbol of each input section (one per function or variable with -ffunction-sections -fdata-sections). The script fails if any budget is exceeded, or if the
+# .noinit section (see TRANSITION_TRACE_NOINIT) does not end below the heap, which starts at the symbol end: the linker script must place it, or the heap may
+# overwrite it.
+CMAKE_MINIMUM_REQUIRED(VERSION 3.24)
+
+IF(NOT DEFINED MAP_FILE OR NOT EXISTS ${MAP_FILE})
+    MESSAGE(FATAL_ERROR "footprint: MAP_FILE not found (${MAP_FILE})")
+ENDIF()
+IF(NOT DEFINED TOP_SYMBOLS)
+    SET(TOP_SYMBOLS 20)
+ENDIF()
+# Functions called through pointers: the actions of the FSM tables and the comparison of qsort
+SET(FOOTPRINT_INDIRECT_TARGETS "^(check_|do_|_compare)")
+IF(DEFINED BUDGET_FILE AND EXISTS ${BUDGET_FILE})
+    INCLUDE(${BUDGET_FILE})
+ENDIF()
+
+SET(report "")
+MACRO(_report line)
+    STRING(APPEND report "${line}\n")
+ENDMACRO()
+
+# Converts a hexadecimal number of the map into decimal
+MACRO(_hex_to_dec hex out)
+    MATH(EXPR ${out} "${hex}" OUTPUT_FORMAT DECIMAL)
+ENDMACRO()
+
+# Right-aligns a number in a column
+FUNCTION(_pad value width out)
+    STRING(LENGTH "${value}" length)
+    SET(padded "${value}")
+    WHILE(length LESS width)
+        STRING(PREPEND padded " ")
+        MATH(EXPR length "${length} + 1")
+    ENDWHILE()
+    SET(${out} "${padded}" PARENT_SCOPE)
+ENDFUNCTION()
+
+# Kind of an output section: text, data, bss, heap_stack, or empty if it is not loaded
+FUNCTION(_section_kind name out)
+    IF(name MATCHES "^\\.(debug|comment|stab|note|gnu|symtab|strtab|shstrtab|ARM\\.attributes|interp|dynamic|dynsym|dynstr|hash|rela?\\.)" OR name STREQUAL "/DISCARD/")
+        SET(${out} "" PARENT_SCOPE)
+    ELSEIF(name MATCHES "^\\._user_heap_stack")
+        SET(${out} "heap_stack" PARENT_SCOPE)
+    ELSEIF(name MATCHES "^\\.(bss|tbss|noinit)")
+        SET(${out} "bss" PARENT_SCOPE)
+    ELSEIF(name MATCHES "^\\.(data|tdata|got)")
+        SET(${out} "data" PARENT_SCOPE)
+    ELSE()
+        SET(${out} "text" PARENT_SCOPE)
+    ENDIF()
+ENDFUNCTION()
+
+# Short name of an object file: the member of an archive, or the source file, without the extension
+FUNCTION(_object_name path out)
+    IF(path MATCHES "\\(([^)]+)\\)$")
+        SET(name "${CMAKE_MATCH_1}")
+    ELSE()
+        GET_FILENAME_COMPONENT(name "${path}" NAME)
+    ENDIF()
+    STRING(REGEX REPLACE "(\\.c|\\.s|\\.S)?\\.(o|obj)$" "" name "${name}")
+    SET(${out} "${name}" PARENT_SCOPE)
+ENDFUNCTION()
+
+########################################################################################
+# Linker map
+########################################################################################
+FILE(STRINGS ${MAP_FILE} map_lines)
+SET(in_map false)
+SET(in_memory false)
+SET(kind "")
+SET(pending_section "")
+SET(objects "")
+SET(symbols "")
+FOREACH(kind_name text data bss)
+    SET(total_${kind_name} 0)
+ENDFOREACH()
+SET(reserved_heap 0)
+SET(reserved_stack 0)
+
+FOREACH(line IN LISTS map_lines)
+    IF(NOT in_map)
+        # Regions of the memory, as default budgets
+        IF(line MATCHES "^Memory Configuration")
+            SET(in_memory true)
+        ELSEIF(line MATCHES "^Linker script and memory map")
+            SET(in_memory false)
+            SET(in_map true)
+        ELSEIF(in_memory AND line MATCHES "^(FLASH|RAM)[ \t]+0x[0-9a-fA-F]+[ \t]+(0x[0-9a-fA-F]+)")
+            _hex_to_dec(${CMAKE_MATCH_2} region_size)
+            SET(region_${CMAKE_MATCH_1} ${region_size})
+        ENDIF()
+        CONTINUE()
+    ENDIF()
+
+    # Start of the heap (see _sbrk)
+    IF(line MATCHES "^[ \t]+(0x[0-9a-fA-F]+)[ \t]+(PROVIDE \\()?end = ")
+        _hex_to_dec(${CMAKE_MATCH_1} heap_start)
+        CONTINUE()
+    ENDIF()
+
+    # Sizes reserved by the linker script
+    IF(line MATCHES "^[ \t]+(0x[0-9a-fA-F]+)[ \t]+_Min_(Heap|Stack)_Size = ")
+        _hex_to_dec(${CMAKE_MATCH_1} reserved)
+        STRING(TOLOWER ${CMAKE_MATCH_2} which)
+        SET(reserved_${which} ${reserved})
+        CONTINUE()
+    ENDIF()
+
+    # Output section
+    IF(line MATCHES "^\\.noinit[ \t]+(0x[0-9a-fA-F]+)[ \t]+(0x[0-9a-fA-F]+)")
+        _hex_to_dec(${CMAKE_MATCH_1} noinit_start)
+        _hex_to_dec(${CMAKE_MATCH_2} noinit_size)
+        MATH(EXPR noinit_end "${noinit_start} + ${noinit_size}")
+    ENDIF()
+    IF(line MATCHES "^(\\.[^ \t]+|/DISCARD/)")
+        _section_kind("${CMAKE_MATCH_1}" kind)
+        SET(pending_section "")
+        CONTINUE()
+    ENDIF()
+    IF(kind STREQUAL "")
+        CONTINUE()
+    ENDIF()
+
+    # Input section, with its address on the same line or, if the name is long, on the next one
+    SET(section "")
+    IF(line MATCHES "^ (\\.[^ \t]+)[ \t]+0x[0-9a-fA-F]+[ \t]+(0x[0-9a-fA-F]+)[ \t]+(.+)$")
+        SET(section "${CMAKE_MATCH_1}")
+        SET(size_hex "${CMAKE_MATCH_2}")
+        SET(object "${CMAKE_MATCH_3}")
+    ELSEIF(line MATCHES "^ (\\.[^ \t]+)$")
+        SET(pending_section "${CMAKE_MATCH_1}")
+        CONTINUE()
+    ELSEIF(NOT pending_section STREQUAL "" AND line MATCHES "^[ \t]+0x[0-9a-fA-F]+[ \t]+(0x[0-9a-fA-F]+)[ \t]+(.+)$")
+        SET(section "${pending_section}")
+        SET(size_hex "${CMAKE_MATCH_1}")
+        SET(object "${CMAKE_MATCH_2}")
+    ELSEIF(line MATCHES "^ \\*fill\\*[ \t]+0x[0-9a-fA-F]+[ \t]+(0x[0-9a-fA-F]+)")
+        SET(section "*fill*")
+        SET(size_hex "${CMAKE_MATCH_1}")
+        SET(object "*fill*")
+    ENDIF()
+    SET(pending_section "")
+    IF(section STREQUAL "")
+        CONTINUE()
+    ENDIF()
+    _hex_to_dec(${size_hex} size)
+    IF(size EQUAL 0)
+        CONTINUE()
+    ENDIF()
+
+    IF(kind STREQUAL "heap_stack")
+        CONTINUE() # Reserved heap and stack, reported apart
+    ENDIF()
+    _object_name("${object}" object_name)
+    IF(NOT object_name IN_LIST objects)
+        LIST(APPEND objects "${object_name}")
+        SET(object_text_${object_name} 0)
+        SET(object_data_${object_name} 0)
+        SET(object_bss_${object_name} 0)
+    ENDIF()
+    MATH(EXPR object_${kind}_${object_name} "${object_${kind}_${object_name}} + ${size}")
+    MATH(EXPR total_${kind} "${total_${kind}} + ${size}")
+
+    # Symbol of the input section (the whole object if it was not compiled with one section per symbol)
+    IF(section MATCHES "^\\.(text|rodata|data|bss|sdata|sbss)\\.(rel\\.)?(ro\\.)?(local\\.)?(.+)$")
+        SET(symbol "${CMAKE_MATCH_5}")
+    ELSE()
+        SET(symbol "${section}")
+    ENDIF()
+    LIST(APPEND symbols "${size}|${kind}|${symbol}|${object_name}")
+ENDFOREACH()
+
+IF(NOT in_map)
+    MESSAGE(FATAL_ERROR "footprint: ${MAP_FILE} is not a map of GNU ld")
+ENDIF()
+
+MATH(EXPR total_flash "${total_text} + ${total_data}")
+MATH(EXPR total_ram "${total_data} + ${total_bss}")
+_report("Footprint of ${MAP_FILE}")
+_report("")
+_report("Flash ${total_flash} bytes (text ${total_text}, data ${total_data}), RAM ${total_ram} bytes (data ${total_data}, bss ${total_bss})")
+_report("Reserved by the linker script: heap ${reserved_heap} bytes, stack ${reserved_stack} bytes")
+_report("")
+
+# Objects, by decreasing flash and then RAM
+SET(sorted "")
+FOREACH(object_name IN LISTS objects)
+    MATH(EXPR object_flash "${object_text_${object_name}} + ${object_data_${object_name}}")
+    MATH(EXPR object_ram "${object_data_${object_name}} + ${object_bss_${object_name}}")
+    SET(object_flash_${object_name} ${object_flash})
+    SET(object_ram_${object_name} ${object_ram})
+    MATH(EXPR object_total "${object_flash} + ${object_ram}")
+    LIST(APPEND sorted "${object_total}|${object_name}")
+ENDFOREACH()
+LIST(SORT sorted COMPARE NATURAL ORDER DESCENDING)
+_report("    text     data      bss  object")
+FOREACH(entry IN LISTS sorted)
+    STRING(REGEX REPLACE "^[0-9]+\\|" "" object_name "${entry}")
+    _pad(${object_text_${object_name}} 8 text)
+    _pad(${object_data_${object_name}} 8 data)
+    _pad(${object_bss_${object_name}} 8 bss)
+    _report("${text} ${data} ${bss}  ${object_name}")
+ENDFOREACH()
+_report("")
+
+# Largest symbols
+LIST(SORT symbols COMPARE NATURAL ORDER DESCENDING)
+_report("Largest ${TOP_SYMBOLS} symbols:")
+SET(count 0)
+FOREACH(entry IN LISTS symbols)
+    IF(count EQUAL TOP_SYMBOLS)
+        BREAK()
+    ENDIF()
+    STRING(REPLACE "|" ";" fields "${entry}")
+    LIST(GET fields 0 size)
+    LIST(GET fields 1 symbol_kind)
+    LIST(GET fields 2 symbol)
+    LIST(GET fields 3 object_name)
+    _pad(${size} 8 size)
+    _pad(${symbol_kind} 5 symbol_kind)
+    _report("${size} ${symbol_kind}  ${symbol} (${object_name})")
+    MATH(EXPR count "${count} + 1")
+ENDFOREACH()
+_report("")
+
+########################################################################################
+# Stack estimate, from the call graph of GCC (-fcallgraph-info=su)
+########################################################################################
+SET(stack_estimate "")
+IF(DEFINED BUILD_DIR AND DEFINED TARGET_DIRS)
+    STRING(REPLACE "," "|" target_regex "${TARGET_DIRS}")
+    FILE(GLOB_RECURSE ci_files ${BUILD_DIR}/*.ci)
+    LIST(FILTER ci_files INCLUDE REGEX "/CMakeFiles/(${target_regex})\\.dir/")
+    SET(functions "")
+    SET(unbounded "")
+    FOREACH(ci_file IN LISTS ci_files)
+        FILE(STRINGS ${ci_file} ci_lines)
+        FOREACH(line IN LISTS ci_lines)
+            # The static functions are prefixed with their file
+            IF(line MATCHES "^node: { title: \"([^\":]+:)?([^\"]+)\" label: \"[^\"]*\\\\n([0-9]+) bytes \\(([a-z,]+)\\)")
+                # Static functions with the same name in several files keep the largest frame
+                SET(function "${CMAKE_MATCH_2}")
+                IF(NOT function IN_LIST functions)
+                    LIST(APPEND functions "${function}")
+                    SET(frame_${function} ${CMAKE_MATCH_3})
+                ELSEIF(CMAKE_MATCH_3 GREATER frame_${function})
+                    SET(frame_${function} ${CMAKE_MATCH_3})
+                ENDIF()
+                # Frames that grow at run time without a bound (alloca, variable length arrays)
+                IF(CMAKE_MATCH_4 STREQUAL "dynamic")
+                    LIST(APPEND unbounded "${function}")
+                ENDIF()
+            ELSEIF(line MATCHES "^edge: { sourcename: \"([^\":]+:)?([^\"]+)\" targetname: \"([^\":]+:)?([^\"]+)\"")
+                LIST(APPEND callees_${CMAKE_MATCH_2} "${CMAKE_MATCH_4}")
+            ENDIF()
+        ENDFOREACH()
+    ENDFOREACH()
+
+    # The indirect calls can reach any of the functions called through pointers
+    SET(indirect_targets ${functions})
+    LIST(FILTER indirect_targets INCLUDE REGEX "${FOOTPRINT_INDIRECT_TARGETS}")
+    SET(callees___indirect_call ${indirect_targets})
+    SET(frame___indirect_call 0)
+    SET(externals "")
+
+    # Deepest path from a function, memoized. A recursive call is not followed
+    FUNCTION(_deepest function)
+        IF(DEFINED deepest_${function})
+            RETURN()
+        ENDIF()
+        IF(NOT DEFINED frame_${function})
+            SET(deepest_${function} 0 PARENT_SCOPE)
+            SET(path_${function} "${function}?" PARENT_SCOPE)
+            SET(externals ${externals} ${function} PARENT_SCOPE)
+            RETURN()
+        ENDIF()
+        SET(visiting_${function} true)
+        SET(best 0)
+        SET(best_path "")
+        FOREACH(callee IN LISTS callees_${function})
+            IF(DEFINED visiting_${callee})
+                CONTINUE()
+            ENDIF()
+            _deepest(${callee})
+            IF(deepest_${callee} GREATER best OR best_path STREQUAL "")
+                SET(best ${deepest_${callee}})
+                SET(best_path "${path_${callee}}")
+            ENDIF()
+        ENDFOREACH()
+        # Propagate the memo of the callees to the caller
+        GET_CMAKE_PROPERTY(variables VARIABLES)
+        LIST(FILTER variables INCLUDE REGEX "^(deepest|path)_")
+        FOREACH(variable IN LISTS variables)
+            SET(${variable} "${${variable}}" PARENT_SCOPE)
+        ENDFOREACH()
+        SET(externals ${externals} PARENT_SCOPE)
+        MATH(EXPR total "${frame_${function}} + ${best}")
+        SET(deepest_${function} ${total} PARENT_SCOPE)
+        IF(best_path STREQUAL "")
+            SET(path_${function} "${function}" PARENT_SCOPE)
+        ELSE()
+            SET(path_${function} "${function} -> ${best_path}" PARENT_SCOPE)
+        ENDIF()
+    ENDFUNCTION()
+
+    IF("main" IN_LIST functions)
+        _deepest(main)
+        SET(worst_isr 0)
+        SET(worst_isr_path "")
+        FOREACH(function IN LISTS functions)
+            IF(function MATCHES "_(IRQ)?Handler$")
+                _deepest(${function})
+                IF(deepest_${function} GREATER worst_isr)
+                    SET(worst_isr ${deepest_${function}})
+                    SET(worst_isr_path "${path_${function}}")
+                ENDIF()
+            ENDIF()
+        ENDFOREACH()
+        MATH(EXPR stack_estimate "${deepest_main} + ${worst_isr}")
+        _report("Stack estimate ${stack_estimate} bytes:")
+        _report("  main   ${deepest_main} bytes: ${path_main}")
+        IF(NOT worst_isr_path STREQUAL "")
+            _report("  ISR    ${worst_isr} bytes: ${worst_isr_path}")
+        ENDIF()
+        LIST(REMOVE_DUPLICATES externals)
+        LIST(REMOVE_ITEM externals __indirect_call)
+        IF(externals)
+            LIST(SORT externals)
+            STRING(REPLACE ";" ", " externals "${externals}")
+            _report("  Not counted (no call graph, marked with ?): ${externals}")
+        ENDIF()
+        IF(unbounded)
+            STRING(REPLACE ";" ", " unbounded "${unbounded}")
+            _report("  Unbounded frames: ${unbounded}")
+        ENDIF()
+    ELSE()
+        _report("Stack estimate: no call graph of main (build with GCC 10 or newer)")
+    ENDIF()
+    _report("")
+ENDIF()
+
+########################################################################################
+# Budgets
+########################################################################################
+IF(NOT DEFINED FOOTPRINT_BUDGET_FLASH AND DEFINED region_FLASH)
+    SET(FOOTPRINT_BUDGET_FLASH ${region_FLASH})
+ENDIF()
+IF(NOT DEFINED FOOTPRINT_BUDGET_RAM AND DEFINED region_RAM)
+    MATH(EXPR FOOTPRINT_BUDGET_RAM "${region_RAM} - ${reserved_heap} - ${reserved_stack}")
+ENDIF()
+IF(DEFINED HEAP_HIGH_WATER)
+    SET(heap ${HEAP_HIGH_WATER})
+ELSE()
+    SET(heap ${reserved_heap})
+ENDIF()
+
+SET(failures 0)
+FUNCTION(_check what used budget)
+    IF(budget STREQUAL "")
+        RETURN()
+    ENDIF()
+    IF(used GREATER budget)
+        SET(verdict "EXCEEDED")
+        MATH(EXPR count "${failures} + 1")
+        SET(failures ${count} PARENT_SCOPE)
+    ELSE()
+        SET(verdict "ok")
+    ENDIF()
+    _pad(${used} 8 used)
+    _pad(${budget} 8 budget)
+    SET(report "${report}${used} / ${budget}  ${what} ${verdict}\n" PARENT_SCOPE)
+ENDFUNCTION()
+
+_report("    used /   budget")
+_check("flash" ${total_flash} "${FOOTPRINT_BUDGET_FLASH}")
+_check("RAM" ${total_ram} "${FOOTPRINT_BUDGET_RAM}")
+_check("heap" ${heap} "${FOOTPRINT_BUDGET_HEAP}")
+IF(NOT stack_estimate STREQUAL "")
+    _check("stack" ${stack_estimate} "${FOOTPRINT_BUDGET_STACK}")
+ENDIF()
+FOREACH(object_name IN LISTS objects)
+    _check("flash of ${object_name}" ${object_flash_${object_name}} "${FOOTPRINT_BUDGET_FLASH_${object_name}}")
+    _check("RAM of ${object_name}" ${object_ram_${object_name}} "${FOOTPRINT_BUDGET_RAM_${object_name}}")
+ENDFOREACH()
+
+# The records of .noinit survive a reset only if the heap does not overlap them
+IF(DEFINED noinit_end AND noinit_size GREATER 0)
+    IF(NOT DEFINED heap_start)
+        _report("Warning: .noinit is not checked against the heap: the map defines no symbol end")
+    ELSE()
+        MATH(EXPR noinit_end_hex "${noinit_end}" OUTPUT_FORMAT HEXADECIMAL)
+        MATH(EXPR heap_start_hex "${heap_start}" OUTPUT_FORMAT HEXADECIMAL)
+        IF(noinit_end GREATER heap_start)
+            _report(".noinit ends at ${noinit_end_hex}, above the heap at ${heap_start_hex}: the linker script must place .noinit EXCEEDED")
+            MATH(EXPR failures "${failures} + 1")
+        ELSE()
+            _report(".noinit ends at ${noinit_end_hex}, below the heap at ${heap_start_hex} ok")
+        ENDIF()
+    ENDIF()
+ENDIF()
+
+IF(DEFINED REPORT_FILE)
+    FILE(WRITE ${REPORT_FILE} "${report}")
+ENDIF()
+MESSAGE("${report}")
+IF(failures GREATER 0)
+    MESSAGE(FATAL_ERROR "footprint: ${failures} budgets exceeded")
+ENDIF()
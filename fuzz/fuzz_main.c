@@ -0,0 +1,75 @@
+/**
+ * @file fuzz_main.c
+ * @brief Standalone driver of the fuzzing harnesses, for compilers without libFuzzer and for AFL.
+ *
+ * The driver runs the harness over every file given as argument, or over the standard input if there are none, which is the way AFL hands its inputs. It is also the regression test of the corpus.
+ *
+ * Usage: `fuzz_<harness> [input...]`
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Defines ------------------------------------------------------------------*/
+#define FUZZ_MAX_INPUT 65536 /*!< Maximum size of an input, in bytes; longer inputs are truncated */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Runs the harness over an input.
+ *
+ * @param p_data Input.
+ * @param size Number of bytes of the input.
+ *
+ * @return int Always 0.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *p_data, size_t size);
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Reads an input and runs the harness over it.
+ *
+ * @param p_stream Stream of the input.
+ */
+static void _run(FILE *p_stream)
+{
+    static uint8_t data[FUZZ_MAX_INPUT];
+    size_t size = fread(data, 1, sizeof(data), p_stream);
+    LLVMFuzzerTestOneInput(data, size);
+}
+
+/**
+ * @brief Runs the harness over the inputs.
+ *
+ * @param argc Number of arguments.
+ * @param argv Paths of the inputs.
+ *
+ * @return int 0 if every input holds the invariants (a broken one aborts), `EXIT_FAILURE` if an input cannot be read.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        _run(stdin);
+        return 0;
+    }
+    for (int i = 1; i < argc; i++)
+    {
+        FILE *p_stream = fopen(argv[i], "rb");
+        if (p_stream == NULL)
+        {
+            perror(argv[i]);
+            return EXIT_FAILURE;
+        }
+        _run(p_stream);
+        fclose(p_stream);
+    }
+    printf("%d inputs\n", argc - 1);
+    return 0;
+}
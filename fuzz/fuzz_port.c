@@ -0,0 +1,182 @@
+/**
+ * @file fuzz_port.c
+ * @brief Stubbed port of the ultrasound sensor and of the system for the fuzzing harnesses.
+ *
+ * The stubs only keep the flags and the echo ticks, so that the harness decides every value that the FSM reads. Starting or stopping the timers has no effect, except that stopping the echo timer and resetting the ticks clear the echo as the real ports do. The temperature sensor never finishes a reading.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* HW dependent includes */
+#include "port_system.h"
+#include "port_ultrasound.h"
+#include "port_temperature.h"
+#include "fuzz_port.h"
+
+/* Global variables -----------------------------------------------------------*/
+static fuzz_port_ultrasound_t ultrasound; /*!< Values of the stubbed ultrasound sensor (a single one, whatever the ID) */
+static uint32_t millis = 0;               /*!< Stubbed system time in ms */
+
+/* Stub control functions -----------------------------------------------------*/
+fuzz_port_ultrasound_t *fuzz_port_get_ultrasound(void)
+{
+    return &ultrasound;
+}
+
+/* Public functions -----------------------------------------------------------*/
+uint32_t port_system_get_millis(void)
+{
+    return millis;
+}
+
+void port_system_set_millis(uint32_t ms)
+{
+    millis = ms;
+}
+
+void port_system_probe_pin_write(bool high)
+{
+}
+
+void port_ultrasound_init(uint32_t ultrasound_id)
+{
+    ultrasound = (fuzz_port_ultrasound_t){.trigger_ready = false};
+}
+
+void port_ultrasound_start_measurement(uint32_t ultrasound_id)
+{
+    ultrasound.num_measurements++;
+}
+
+void port_ultrasound_stop_trigger_timer(uint32_t ultrasound_id)
+{
+}
+
+void port_ultrasound_stop_echo_timer(uint32_t ultrasound_id)
+{
+}
+
+void port_ultrasound_start_new_measurement_timer(void)
+{
+}
+
+void port_ultrasound_stop_new_measurement_timer(void)
+{
+}
+
+void port_ultrasound_reset_echo_ticks(uint32_t ultrasound_id)
+{
+    ultrasound.echo_init_tick = 0;
+    ultrasound.echo_end_tick = 0;
+    ultrasound.echo_overflows = 0;
+    ultrasound.echo_received = false;
+}
+
+void port_ultrasound_stop_ultrasound(uint32_t ultrasound_id)
+{
+    port_ultrasound_reset_echo_ticks(ultrasound_id);
+}
+
+bool port_ultrasound_get_trigger_ready(uint32_t ultrasound_id)
+{
+    return ultrasound.trigger_ready;
+}
+
+void port_ultrasound_set_trigger_ready(uint32_t ultrasound_id, bool trigger_ready)
+{
+    ultrasound.trigger_ready = trigger_ready;
+}
+
+bool port_ultrasound_get_trigger_end(uint32_t ultrasound_id)
+{
+    return ultrasound.trigger_end;
+}
+
+void port_ultrasound_set_trigger_end(uint32_t ultrasound_id, bool trigger_end)
+{
+    ultrasound.trigger_end = trigger_end;
+}
+
+uint32_t port_ultrasound_get_echo_init_tick(uint32_t ultrasound_id)
+{
+    return ultrasound.echo_init_tick;
+}
+
+void port_ultrasound_set_echo_init_tick(uint32_t ultrasound_id, uint32_t echo_init_tick)
+{
+    ultrasound.echo_init_tick = echo_init_tick;
+}
+
+uint32_t port_ultrasound_get_echo_end_tick(uint32_t ultrasound_id)
+{
+    return ultrasound.echo_end_tick;
+}
+
+void port_ultrasound_set_echo_end_tick(uint32_t ultrasound_id, uint32_t echo_end_tick)
+{
+    ultrasound.echo_end_tick = echo_end_tick;
+}
+
+bool port_ultrasound_get_echo_received(uint32_t ultrasound_id)
+{
+    return ultrasound.echo_received;
+}
+
+void port_ultrasound_set_echo_received(uint32_t ultrasound_id, bool echo_received)
+{
+    ultrasound.echo_received = echo_received;
+}
+
+uint32_t port_ultrasound_get_echo_overflows(uint32_t ultrasound_id)
+{
+    return ultrasound.echo_overflows;
+}
+
+void port_ultrasound_set_echo_overflows(uint32_t ultrasound_id, uint32_t echo_overflows)
+{
+    ultrasound.echo_overflows = echo_overflows;
+}
+
+uint32_t port_ultrasound_get_echo_end_time_us(uint32_t ultrasound_id)
+{
+    return ultrasound.echo_end_time_us;
+}
+
+void port_ultrasound_set_echo_end_time_us(uint32_t ultrasound_id, uint32_t echo_end_time_us)
+{
+    ultrasound.echo_end_time_us = echo_end_time_us;
+}
+
+void port_ultrasound_set_max_echoes(uint32_t ultrasound_id, uint32_t max_echoes)
+{
+}
+
+uint32_t port_ultrasound_get_num_echoes(uint32_t ultrasound_id)
+{
+    return 1;
+}
+
+uint32_t port_ultrasound_get_echo_width_us(uint32_t ultrasound_id, uint32_t echo_idx)
+{
+    return 0;
+}
+
+void port_temperature_init(void)
+{
+}
+
+void port_temperature_start_conversion(void)
+{
+}
+
+bool port_temperature_get_conversion(int32_t *p_temperature_dc)
+{
+    return false;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file fuzz_port.h
+ * @brief Header for fuzz_port.c file.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef FUZZ_PORT_H_
+#define FUZZ_PORT_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the values of the stubbed ultrasound sensor.
+ */
+typedef struct
+{
+    bool trigger_ready;        /*!< Flag of the measurement timer */
+    bool trigger_end;          /*!< Flag of the trigger timer */
+    bool echo_received;        /*!< Flag of the end of the echo */
+    uint32_t echo_init_tick;   /*!< Tick of the rising edge of the echo */
+    uint32_t echo_end_tick;    /*!< Tick of the falling edge of the echo */
+    uint32_t echo_overflows;   /*!< Overflows of the echo timer */
+    uint32_t echo_end_time_us; /*!< Time of the falling edge of the echo */
+    uint32_t num_measurements; /*!< Number of measurements started by the FSM */
+} fuzz_port_ultrasound_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Returns the values of the stubbed ultrasound sensor, so that the harness can set and check them.
+ *
+ * @return Pointer to the values.
+ */
+fuzz_port_ultrasound_t *fuzz_port_get_ultrasound(void);
+
+#endif /* FUZZ_PORT_H_ */
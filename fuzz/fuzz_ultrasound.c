@@ -0,0 +1,329 @@
+/**
+ * @file fuzz_ultrasound.c
+ * @brief Fuzzing harness of the echo tick arithmetic and of the ultrasound FSM.
+ *
+ * The harness drives the ultrasound FSM on a stubbed port, so that every flag and every echo tick that the FSM reads comes from the input. The first byte of the input selects one of two modes:
+ *
+ * - Sequence mode (even byte): the rest of the input is a sequence of steps of `FUZZ_STEP_SIZE` bytes. Each step sets the flags, the status, the state and the echo ticks and fires the FSM once. Every echo consumed by the FSM is also converted by a reference model, and every new measurement must be the median of the last `FSM_ULTRASOUND_NUM_MEASUREMENTS` reference distances.
+ * - Monotonic mode (odd byte): the rest of the input is a sequence of pairs of echo widths. Each width is measured `FSM_ULTRASOUND_NUM_MEASUREMENTS` times, splitting it in a different way between the start tick, the overflows and the end tick each time. The distance must not depend on the split and must not decrease with the width.
+ *
+ * In the sequence mode the FSM also keeps the statistics of the pings: every echo consumed must be counted once, in exactly one class, and the mean must stay between the minimum and the maximum.
+ *
+ * In both modes the state must stay in the states of the FSM and the distance must stay in the range that the echo timer can measure. A broken invariant aborts, so that libFuzzer, AFL or the standalone driver report the input.
+ *
+ * The reference model is the plain 64-bit formula of the distance, so the harness also checks any optimised version of the filters of `do_set_distance()` against it. The stubbed port never finishes a reading of the temperature, so the distances are those of the default temperature of the FSM.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_ultrasound.h"
+#include "fsm.h"
+#include "fsm_ultrasound.h"
+#include "speed_of_sound.h"
+#include "fuzz_port.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define FUZZ_STEP_SIZE 11     /*!< Bytes of a step of the sequence mode: flags, start tick, end tick and overflows */
+#define FUZZ_PAIR_SIZE 8      /*!< Bytes of a pair of widths of the monotonic mode */
+#define FUZZ_MAX_STEPS 4096   /*!< Maximum number of steps run for an input, so that no input can hang the harness */
+#define FUZZ_ECHO_TIMER_TICKS ((int64_t)TIMER_MAX_ARR + 1) /*!< Ticks of a period of the echo timer */
+#define FUZZ_MAX_WIDTH (1UL << 23) /*!< Longest echo width of the monotonic mode, in ticks (about 1.4 km), below the saturation of the FSM */
+#define FUZZ_MAX_DISTANCE_CM _width_to_cm(UINT32_MAX / SPEED_OF_SOUND_MS) /*!< Longest distance that the FSM may return */
+
+#define FUZZ_FLAG_TRIGGER_READY 0x01 /*!< Flag of a step: the measurement timer has elapsed */
+#define FUZZ_FLAG_TRIGGER_END 0x02   /*!< Flag of a step: the trigger signal has ended */
+#define FUZZ_FLAG_ECHO_RECEIVED 0x04 /*!< Flag of a step: the echo has ended */
+#define FUZZ_FLAG_STATUS 0x08        /*!< Flag of a step: the FSM is on */
+#define FUZZ_FLAG_SET_STATE 0x10     /*!< Flag of a step: the three upper bits force the state of the FSM */
+
+/**
+ * @brief Aborts if a condition does not hold, writing the broken invariant.
+ */
+#define FUZZ_ASSERT(condition)                                                      \
+    do                                                                              \
+    {                                                                               \
+        if (!(condition))                                                           \
+        {                                                                           \
+            fprintf(stderr, "%s:%d: invariant failed: %s\n", __FILE__, __LINE__, #condition); \
+            abort();                                                                \
+        }                                                                           \
+    } while (0)
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Reads a little-endian unsigned integer of the input.
+ *
+ * @param p_data Position of the integer.
+ * @param size Number of bytes of the integer.
+ *
+ * @return uint32_t Value of the integer.
+ */
+static uint32_t _read_le(const uint8_t *p_data, size_t size)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        value |= (uint32_t)p_data[i] << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Converts an echo width into a distance, at the default temperature of the FSM.
+ *
+ * @param width Width of the echo, in ticks.
+ *
+ * @return uint32_t Distance in cm.
+ */
+static uint32_t _width_to_cm(uint64_t width)
+{
+    uint64_t scale = speed_of_sound_get_scale(speed_of_sound_get_mm_s(FSM_ULTRASOUND_DEFAULT_TEMPERATURE_DC));
+    return (uint32_t)((width * scale + (1ULL << (SPEED_OF_SOUND_SCALE_SHIFT - 1))) >> SPEED_OF_SOUND_SCALE_SHIFT);
+}
+
+/**
+ * @brief Reference model of the distance of an echo.
+ *
+ * The width is computed in signed 64-bit arithmetic, so that it cannot wrap around. An end tick before the start tick with no overflows means that the overflow between both edges has not been counted yet, and an echo that still ends before it starts is empty.
+ *
+ * @param init_tick Tick of the rising edge of the echo.
+ * @param end_tick Tick of the falling edge of the echo.
+ * @param overflows Overflows of the echo timer between both edges.
+ *
+ * @return uint32_t Distance in cm.
+ */
+static uint32_t _reference_distance(uint32_t init_tick, uint32_t end_tick, uint32_t overflows)
+{
+    int64_t width = (int64_t)overflows * FUZZ_ECHO_TIMER_TICKS + end_tick - init_tick;
+    if (width < 0)
+    {
+        width += FUZZ_ECHO_TIMER_TICKS;
+    }
+    if (width < 0)
+    {
+        width = 0;
+    }
+    if (width > UINT32_MAX / SPEED_OF_SOUND_MS)
+    {
+        width = UINT32_MAX / SPEED_OF_SOUND_MS;
+    }
+    return _width_to_cm((uint64_t)width);
+}
+
+/**
+ * @brief Reference model of the filter of the FSM: the median of the last distances.
+ *
+ * @param p_distances Last distances, in any order.
+ *
+ * @return uint32_t Median of the distances.
+ */
+static uint32_t _reference_median(const uint32_t *p_distances)
+{
+    uint32_t sorted[FSM_ULTRASOUND_NUM_MEASUREMENTS];
+    memcpy(sorted, p_distances, sizeof(sorted));
+    // Insertion sort, deliberately different from the qsort of the FSM
+    for (uint32_t i = 1; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+    {
+        uint32_t value = sorted[i];
+        uint32_t j = i;
+        for (; j > 0 && sorted[j - 1] > value; j--)
+        {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = value;
+    }
+    if (FSM_ULTRASOUND_NUM_MEASUREMENTS % 2 == 0)
+    {
+        return (uint32_t)(((uint64_t)sorted[FSM_ULTRASOUND_NUM_MEASUREMENTS / 2 - 1] + sorted[FSM_ULTRASOUND_NUM_MEASUREMENTS / 2]) / 2);
+    }
+    return sorted[FSM_ULTRASOUND_NUM_MEASUREMENTS / 2];
+}
+
+/**
+ * @brief Hands an echo to the FSM as the echo timer would and fires it once.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param init_tick Tick of the rising edge of the echo.
+ * @param end_tick Tick of the falling edge of the echo.
+ * @param overflows Overflows of the echo timer between both edges.
+ */
+static void _fire_echo(fsm_ultrasound_t *p_fsm, uint32_t init_tick, uint32_t end_tick, uint32_t overflows)
+{
+    fuzz_port_ultrasound_t *p_port = fuzz_port_get_ultrasound();
+    p_port->echo_init_tick = init_tick;
+    p_port->echo_end_tick = end_tick;
+    p_port->echo_overflows = overflows;
+    p_port->echo_received = true;
+    p_port->trigger_ready = false;
+    fsm_ultrasound_set_state(p_fsm, WAIT_ECHO_END);
+    fsm_ultrasound_fire(p_fsm);
+    FUZZ_ASSERT(fsm_ultrasound_get_state(p_fsm) == SET_DISTANCE);
+}
+
+/**
+ * @brief Measures an echo width `FSM_ULTRASOUND_NUM_MEASUREMENTS` times, each one split in a different way between the ticks and the overflows.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param width Width of the echo, in ticks.
+ * @param seed Value that selects the splits.
+ *
+ * @return uint32_t Distance returned by the FSM.
+ */
+static uint32_t _measure_width(fsm_ultrasound_t *p_fsm, uint32_t width, uint32_t seed)
+{
+    for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+    {
+        // The start tick is never 0, since the FSM waits for a start tick greater than 0
+        uint32_t init_tick = 1 + (seed * (2 * i + 1) + i * 7919) % TIMER_MAX_ARR;
+        uint64_t end = (uint64_t)init_tick + width;
+        uint32_t overflows = (uint32_t)(end / FUZZ_ECHO_TIMER_TICKS);
+        uint32_t end_tick = (uint32_t)(end % FUZZ_ECHO_TIMER_TICKS);
+        if ((i % 2 == 1) && overflows == 1 && end_tick < init_tick)
+        {
+            // The falling edge arrived before the ISR counted the overflow
+            overflows = 0;
+        }
+        _fire_echo(p_fsm, init_tick, end_tick, overflows);
+        if (i < FSM_ULTRASOUND_NUM_MEASUREMENTS - 1)
+        {
+            FUZZ_ASSERT(!fsm_ultrasound_get_new_measurement_ready(p_fsm));
+        }
+    }
+    FUZZ_ASSERT(fsm_ultrasound_get_new_measurement_ready(p_fsm));
+    uint32_t distance = fsm_ultrasound_get_distance(p_fsm);
+    FUZZ_ASSERT(distance == _width_to_cm(width));
+    return distance;
+}
+
+/**
+ * @brief Runs the monotonic mode over an input.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param p_data Pairs of widths.
+ * @param size Number of bytes of the pairs.
+ */
+static void _run_monotonic(fsm_ultrasound_t *p_fsm, const uint8_t *p_data, size_t size)
+{
+    for (size_t i = 0; i + FUZZ_PAIR_SIZE <= size && i / FUZZ_PAIR_SIZE < FUZZ_MAX_STEPS; i += FUZZ_PAIR_SIZE)
+    {
+        uint32_t width_a = _read_le(&p_data[i], 4) % FUZZ_MAX_WIDTH;
+        uint32_t width_b = _read_le(&p_data[i + 4], 4) % FUZZ_MAX_WIDTH;
+        uint32_t width_short = (width_a < width_b) ? width_a : width_b;
+        uint32_t width_long = (width_a < width_b) ? width_b : width_a;
+        uint32_t distance_short = _measure_width(p_fsm, width_short, width_a ^ (width_b << 3));
+        uint32_t distance_long = _measure_width(p_fsm, width_long, width_b ^ (width_a << 5));
+        FUZZ_ASSERT(distance_short <= distance_long);
+    }
+}
+
+/**
+ * @brief Runs the sequence mode over an input.
+ *
+ * @param p_fsm Pointer to the ultrasound FSM.
+ * @param p_data Steps.
+ * @param size Number of bytes of the steps.
+ */
+static void _run_sequence(fsm_ultrasound_t *p_fsm, const uint8_t *p_data, size_t size)
+{
+    fuzz_port_ultrasound_t *p_port = fuzz_port_get_ultrasound();
+    uint32_t distances[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {0};
+    uint32_t num_echoes = 0;
+    ranging_stats_t stats;
+    ranging_stats_snapshot_t snapshot;
+    ranging_stats_init(&stats);
+    fsm_ultrasound_set_stats(p_fsm, &stats);
+
+    for (size_t i = 0; i + FUZZ_STEP_SIZE <= size && i / FUZZ_STEP_SIZE < FUZZ_MAX_STEPS; i += FUZZ_STEP_SIZE)
+    {
+        uint8_t flags = p_data[i];
+        p_port->trigger_ready = (flags & FUZZ_FLAG_TRIGGER_READY) != 0;
+        p_port->trigger_end = (flags & FUZZ_FLAG_TRIGGER_END) != 0;
+        p_port->echo_received = (flags & FUZZ_FLAG_ECHO_RECEIVED) != 0;
+        p_port->echo_init_tick = _read_le(&p_data[i + 1], 4);
+        p_port->echo_end_tick = _read_le(&p_data[i + 5], 4);
+        p_port->echo_overflows = _read_le(&p_data[i + 9], 2);
+        fsm_ultrasound_set_status(p_fsm, (flags & FUZZ_FLAG_STATUS) != 0);
+        if (flags & FUZZ_FLAG_SET_STATE)
+        {
+            fsm_ultrasound_set_state(p_fsm, (int8_t)((flags >> 5) % (SET_DISTANCE + 1)));
+        }
+
+        uint32_t state = fsm_ultrasound_get_state(p_fsm);
+        uint32_t init_tick = p_port->echo_init_tick;
+        uint32_t end_tick = p_port->echo_end_tick;
+        uint32_t overflows = p_port->echo_overflows;
+        fsm_ultrasound_fire(p_fsm);
+        uint32_t new_state = fsm_ultrasound_get_state(p_fsm);
+        FUZZ_ASSERT(new_state <= SET_DISTANCE);
+
+        if (state == WAIT_ECHO_END && new_state == SET_DISTANCE)
+        {
+            // The FSM has consumed the echo: it must clear it and keep the same distance as the reference
+            FUZZ_ASSERT(p_port->echo_init_tick == 0 && !p_port->echo_received);
+            distances[num_echoes % FSM_ULTRASOUND_NUM_MEASUREMENTS] = _reference_distance(init_tick, end_tick, overflows);
+            num_echoes++;
+            bool ready = fsm_ultrasound_get_new_measurement_ready(p_fsm);
+            FUZZ_ASSERT(ready == (num_echoes % FSM_ULTRASOUND_NUM_MEASUREMENTS == 0));
+            if (ready)
+            {
+                uint32_t distance = fsm_ultrasound_get_distance(p_fsm);
+                FUZZ_ASSERT(distance == _reference_median(distances));
+                FUZZ_ASSERT(distance <= FUZZ_MAX_DISTANCE_CM);
+            }
+        }
+        else
+        {
+            FUZZ_ASSERT(!fsm_ultrasound_get_new_measurement_ready(p_fsm));
+        }
+    }
+
+    FUZZ_ASSERT(fsm_ultrasound_get_stats(p_fsm, &snapshot));
+    FUZZ_ASSERT(snapshot.num_pings == num_echoes);
+    FUZZ_ASSERT(snapshot.num_samples + snapshot.num_timeouts + snapshot.num_out_of_range == snapshot.num_pings);
+    FUZZ_ASSERT(snapshot.num_overflows <= snapshot.num_pings);
+    if (snapshot.num_samples > 0)
+    {
+        FUZZ_ASSERT(snapshot.min_cm <= snapshot.max_cm && snapshot.max_cm <= RANGING_STATS_MAX_RANGE_CM);
+        FUZZ_ASSERT(snapshot.mean_cm_q16 >= (snapshot.min_cm << RANGING_STATS_FRAC_BITS) && snapshot.mean_cm_q16 <= (snapshot.max_cm << RANGING_STATS_FRAC_BITS));
+    }
+}
+
+/* Public functions -----------------------------------------------------------*/
+/**
+ * @brief Runs the harness over an input. This is the entry point of libFuzzer, and the standalone driver calls it for every input file.
+ *
+ * @param p_data Input.
+ * @param size Number of bytes of the input.
+ *
+ * @return int Always 0.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *p_data, size_t size)
+{
+    if (size < 1)
+    {
+        return 0;
+    }
+    fsm_ultrasound_t *p_fsm = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
+    if (p_data[0] % 2 == 0)
+    {
+        _run_sequence(p_fsm, &p_data[1], size - 1);
+    }
+    else
+    {
+        fsm_ultrasound_set_status(p_fsm, true);
+        _run_monotonic(p_fsm, &p_data[1], size - 1);
+    }
+    fsm_ultrasound_destroy(p_fsm);
+    return 0;
+}
@@ -16,15 +16,63 @@
 #include "port_button.h"
 #include "port_ultrasound.h"
 #include "port_display.h"
+#include "port_buzzer.h"
 #include "fsm.h"
 #include "fsm_button.h"
 #include "fsm_ultrasound.h"
 #include "fsm_display.h"
+#include "fsm_buzzer.h"
 #include "fsm_urbanite.h"
+#include "echo_trace.h"
+#include "power_stats.h"
+#include "latency_probe.h"
+#include "distance_history.h"
+#include "flash_log.h"
+#include "telemetry.h"
+#include "ranging_stats.h"
+#include "shell.h"
+#include "urbanite_shell.h"
+#include "transition_trace.h"
 
 /* Defines ------------------------------------------------------------------*/
 #define URBANITE_ON_OFF_PRESS_TIME_MS 1000 /*!< Time in milliseconds to toggle the system on/off */
 #define URBANITE_PAUSE_DISPLAY_TIME_MS 500 /*!< Time in milliseconds to pause/resume the display */
+#define URBANITE_POWER_STATS_PERIOD_US 60000000ULL /*!< Period of the power report, in microseconds of the power clock */
+#define URBANITE_LATENCY_REPORT_SAMPLES 100 /*!< Number of new latencies between two latency reports */
+#define URBANITE_RANGING_REPORT_PINGS 600 /*!< Number of new pings of the rear sensor between two reports of its statistics */
+#define URBANITE_TELEMETRY_PERIOD_MS 100 /*!< Period of the status packets of the telemetry, in milliseconds */
+#define URBANITE_MAX_ECHOES 3 /*!< Number of echoes captured in each ping of the rear sensor with `USE_MULTI_ECHO` */
+#define URBANITE_MIN_OBSTACLE_CM 20 /*!< Distance in cm below which the echoes of the rear sensor are not obstacles with `USE_MULTI_ECHO` (tow bar) */
+
+/* Global variables ---------------------------------------------------------*/
+#ifdef USE_ECHO_TRACE
+echo_trace_t rear_echo_trace; /*!< Raw echoes of the rear sensor. Dump it with `dump binary memory trace.bin &rear_echo_trace (&rear_echo_trace)+1` in GDB */
+#endif
+#ifdef USE_POWER_STATS
+power_stats_t urbanite_power_stats; /*!< Time and energy spent in each state and power mode of the Urbanite. Read it with `print urbanite_power_stats` in GDB */
+static const char *const urbanite_state_names[] = {"OFF", "MEASURE", "SLEEP_WHILE_OFF", "SLEEP_WHILE_ON"}; /*!< Names of the states of the Urbanite FSM in the power report */
+#endif
+#ifdef USE_DISTANCE_HISTORY
+distance_history_t rear_distance_history; /*!< Filtered distances of the rear sensor. Dump it with `dump binary memory history.bin &rear_distance_history (&rear_distance_history)+1` in GDB and decode it with `history_dump` */
+#endif
+#ifdef USE_FLASH_LOG
+flash_log_t urbanite_flash_log; /*!< Distances and commands of the Urbanite, kept in the reserved flash sectors across power cycles. Dump the sectors with `dump binary memory flash.bin 0x08040000 0x08080000` in GDB and decode them with `flash_log_dump` */
+#endif
+#ifdef USE_RANGING_STATS
+ranging_stats_t rear_ranging_stats; /*!< Statistics of the pings of the rear sensor. Read it with `print rear_ranging_stats` in GDB */
+#endif
+#if defined(USE_TELEMETRY) || defined(USE_SHELL)
+telemetry_t urbanite_telemetry; /*!< Stream of the status of the system and of the replies of the shell through the UART. Capture it on the host (e.g., `cat /dev/ttyACM0 > telemetry.bin`) and decode it with `telemetry_decode` */
+#endif
+#ifdef USE_SHELL
+shell_t urbanite_shell; /*!< Command shell to tune the parameters at runtime through the UART. Type the commands on the virtual COM port (e.g., `echo "set ping_ms 50" > /dev/ttyACM0`) and read the replies with `telemetry_decode /dev/ttyACM0` */
+#endif
+#ifdef USE_TRANSITION_TRACE
+transition_trace_t urbanite_transition_trace TRANSITION_TRACE_NOINIT; /*!< Last transitions of all the FSMs, kept across resets. Dump it with `dump binary memory transitions.bin &urbanite_transition_trace (&urbanite_transition_trace)+1` in GDB and decode it with `transition_trace_dump` */
+#endif
+#ifdef USE_LATENCY_PROBE
+latency_probe_t rear_latency_probe; /*!< Latencies from the falling edge of an echo of the rear sensor to the color of its distance on the rear display. Read it with `print rear_latency_probe` in GDB */
+#endif
 
 /**
  * @brief  The application entry point.
@@ -34,10 +82,63 @@ int main(void)
 {
     /* Init board */
     port_system_init();
-    fsm_button_t *p_fsm_button = fsm_button_new(PORT_PARKING_BUTTON_DEBOUNCE_TIME_MS, PORT_PARKING_BUTTON_ID);
+    fsm_button_t *p_fsm_button = fsm_button_new(0, PORT_PARKING_BUTTON_ID); // The button is debounced in hardware
+    port_button_set_debounce(PORT_PARKING_BUTTON_ID, PORT_PARKING_BUTTON_DEBOUNCE_TIME_MS);
     fsm_ultrasound_t *p_fsm_ultrasound_rear = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
+#ifdef USE_ECHO_TRACE
+    echo_trace_init(&rear_echo_trace);
+    fsm_ultrasound_set_trace(p_fsm_ultrasound_rear, &rear_echo_trace);
+#endif
+#ifdef USE_DISTANCE_HISTORY
+    distance_history_init(&rear_distance_history);
+    fsm_ultrasound_set_history(p_fsm_ultrasound_rear, &rear_distance_history);
+#endif
+#ifdef USE_RANGING_STATS
+    ranging_stats_init(&rear_ranging_stats);
+    fsm_ultrasound_set_stats(p_fsm_ultrasound_rear, &rear_ranging_stats);
+    uint32_t ranging_report_count = URBANITE_RANGING_REPORT_PINGS;
+#endif
     fsm_display_t *p_fsm_display_rear = fsm_display_new(PORT_REAR_PARKING_DISPLAY_ID);
-    fsm_urbanite_t *p_fsm_urbanite = fsm_urbanite_new(p_fsm_button, URBANITE_ON_OFF_PRESS_TIME_MS, URBANITE_PAUSE_DISPLAY_TIME_MS, p_fsm_ultrasound_rear, p_fsm_display_rear);
+    fsm_buzzer_t *p_fsm_buzzer_rear = fsm_buzzer_new(PORT_REAR_PARKING_BUZZER_ID);
+    fsm_urbanite_t *p_fsm_urbanite = fsm_urbanite_new(p_fsm_button, URBANITE_ON_OFF_PRESS_TIME_MS, URBANITE_PAUSE_DISPLAY_TIME_MS, p_fsm_ultrasound_rear, p_fsm_display_rear, p_fsm_buzzer_rear);
+#ifdef USE_MULTI_ECHO
+    // The echo of the tow bar does not hide the obstacles behind it
+    fsm_ultrasound_set_max_echoes(p_fsm_ultrasound_rear, URBANITE_MAX_ECHOES);
+    fsm_urbanite_set_min_obstacle_distance(p_fsm_urbanite, URBANITE_MIN_OBSTACLE_CM);
+#endif
+#ifdef USE_POWER_STATS
+    port_system_power_clock_init();
+    fsm_urbanite_set_power_stats(p_fsm_urbanite, &urbanite_power_stats);
+    uint64_t power_report_us = port_system_get_power_clock_us() + URBANITE_POWER_STATS_PERIOD_US;
+#endif
+#ifdef USE_FLASH_LOG
+    if (flash_log_init(&urbanite_flash_log))
+    {
+        fsm_urbanite_set_flash_log(p_fsm_urbanite, &urbanite_flash_log);
+    }
+#endif
+#if defined(USE_TELEMETRY) || defined(USE_SHELL)
+    telemetry_init(&urbanite_telemetry, URBANITE_TELEMETRY_PERIOD_MS);
+#endif
+#ifdef USE_SHELL
+    urbanite_shell_init(&urbanite_shell, p_fsm_urbanite, p_fsm_ultrasound_rear, p_fsm_display_rear, &urbanite_telemetry);
+#endif
+#ifdef USE_TRANSITION_TRACE
+    transition_trace_restore(&urbanite_transition_trace, port_system_get_millis()); // Kept if the RAM has survived a reset, emptied after a power-on
+    fsm_button_set_transition_trace(p_fsm_button, &urbanite_transition_trace);
+    fsm_ultrasound_set_transition_trace(p_fsm_ultrasound_rear, &urbanite_transition_trace);
+    fsm_display_set_transition_trace(p_fsm_display_rear, &urbanite_transition_trace);
+    fsm_buzzer_set_transition_trace(p_fsm_buzzer_rear, &urbanite_transition_trace);
+    fsm_urbanite_set_transition_trace(p_fsm_urbanite, &urbanite_transition_trace);
+#endif
+#ifdef USE_LATENCY_PROBE
+    latency_probe_init(&rear_latency_probe);
+    fsm_display_set_latency_probe(p_fsm_display_rear, &rear_latency_probe);
+    uint32_t latency_report_count = URBANITE_LATENCY_REPORT_SAMPLES;
+#endif
+#ifdef USE_PROBE_PIN
+    port_system_probe_pin_init(); // High from the echo to the color of its distance, to check the latencies with a scope
+#endif
 
     /* Infinite loop */
     while (1)
@@ -45,12 +146,58 @@ int main(void)
         fsm_button_fire(p_fsm_button); // Check button state and fire FSM
         fsm_ultrasound_fire(p_fsm_ultrasound_rear); // Check ultrasound state and fire FSM
         fsm_display_fire(p_fsm_display_rear); // Check display state and fire FSM
+        fsm_buzzer_fire(p_fsm_buzzer_rear); // Check buzzer state and fire FSM
         fsm_urbanite_fire(p_fsm_urbanite); // Check urbanite state and fire FSM
+#ifdef USE_POWER_STATS
+        if (port_system_get_power_clock_us() >= power_report_us)
+        {
+            power_stats_update(&urbanite_power_stats, port_system_get_power_clock_us());
+            power_stats_print(&urbanite_power_stats, urbanite_state_names, sizeof(urbanite_state_names) / sizeof(urbanite_state_names[0])); // Through semihosting
+            power_report_us += URBANITE_POWER_STATS_PERIOD_US;
+        }
+#endif
+#ifdef USE_RANGING_STATS
+        if (rear_ranging_stats.num_pings >= ranging_report_count)
+        {
+            ranging_stats_snapshot_t ranging_snapshot;
+            fsm_ultrasound_get_stats(p_fsm_ultrasound_rear, &ranging_snapshot);
+            ranging_stats_print(&ranging_snapshot, "rear"); // Through semihosting
+            ranging_report_count += URBANITE_RANGING_REPORT_PINGS;
+        }
+#endif
+#ifdef USE_SHELL
+        shell_service(&urbanite_shell); // Execute the command lines received; a partial line waits for the next wake-up
+#endif
+#ifdef USE_TELEMETRY
+        // The status is sent at the period while the system is awake; the system is not woken up only to send it
+        if (telemetry_is_due(&urbanite_telemetry, port_system_get_millis()))
+        {
+            telemetry_status_t status = {
+                .timestamp_ms = port_system_get_millis(),
+                .distance_cm = fsm_ultrasound_get_last_distance(p_fsm_ultrasound_rear),
+                .urbanite_state = (uint8_t)fsm_urbanite_get_state(p_fsm_urbanite),
+                .ultrasound_state = (uint8_t)fsm_ultrasound_get_state(p_fsm_ultrasound_rear),
+                .display_state = (uint8_t)fsm_display_get_state(p_fsm_display_rear),
+                .buzzer_state = (uint8_t)fsm_buzzer_get_state(p_fsm_buzzer_rear)};
+            telemetry_send_status(&urbanite_telemetry, &status);
+        }
+#endif
+#if defined(USE_TELEMETRY) || defined(USE_SHELL)
+        telemetry_service(&urbanite_telemetry); // Start the next DMA transfer if the last one has completed
+#endif
+#ifdef USE_LATENCY_PROBE
+        if (rear_latency_probe.count >= latency_report_count)
+        {
+            latency_probe_print(&rear_latency_probe, "rear echo to display"); // Through semihosting
+            latency_report_count += URBANITE_LATENCY_REPORT_SAMPLES;
+        }
+#endif
     } // End of while(1)
 
     fsm_urbanite_destroy(p_fsm_urbanite); // Destroy urbanite FSM
     fsm_button_destroy(p_fsm_button); // Destroy button FSM
     fsm_ultrasound_destroy(p_fsm_ultrasound_rear); // Destroy ultrasound FSM
     fsm_display_destroy(p_fsm_display_rear); // Destroy display FSM
+    fsm_buzzer_destroy(p_fsm_buzzer_rear); // Destroy buzzer FSM
     return 0;
 }
@@ -52,13 +52,22 @@ bool port_button_get_value (uint32_t button_id);
 
 
 /**
- * @brief Sets the value of the button with the specified identifier.
+ * @brief Sets the value of the button with the specified identifier. The time of the edge is set to the current time.
  *
  * @param button_id Identifier of the button to set the value.
  * @param pressed Value to set.
  */
 void port_button_set_pressed (uint32_t button_id, bool pressed);
 
+/**
+ * @brief Returns the time of the edge of the last change of the pressed flag of the button with the specified identifier. It is captured in the ISR of the button (the first edge of the bounces if the hardware debounce is enabled), so it does not depend on when the FSM of the button is fired.
+ *
+ * @param button_id Identifier of the button.
+ *
+ * @return Time of the edge in microseconds, in the time base of `port_system_get_micros()`.
+ */
+uint32_t port_button_get_edge_time_us (uint32_t button_id);
+
 /**
  * @brief Enables the interrupts of the button with the specified identifier.
  *
@@ -82,4 +91,15 @@ void port_button_clear_pending_interrupt (uint32_t button_id);
  */
 void port_button_disable_interrupts (uint32_t button_id);
 
+
+/**
+ * @brief Sets the hardware debounce of the button with the specified identifier.
+ *
+ * With a debounce time greater than 0, the first edge of a press or a release masks the interrupt of the button and starts a one-shot timer. The pin is sampled, and the pressed flag updated, only when the timer expires, so a burst of bounces costs a single interrupt. With a debounce time of 0 (default), the pressed flag follows every edge and the debounce must be done by the FSM of the button.
+ *
+ * @param button_id Identifier of the button.
+ * @param debounce_ms Debounce time in milliseconds, or 0 to disable the hardware debounce.
+ */
+void port_button_set_debounce (uint32_t button_id, uint32_t debounce_ms);
+
 #endif
\ No newline at end of file
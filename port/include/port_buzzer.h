@@ -0,0 +1,49 @@
+/**
+ * @file port_buzzer.h
+ * @brief Header for the portable functions to interact with the HW of the buzzers. The functions must be implemented in the platform-specific code.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+
+#ifndef PORT_BUZZER_H_
+#define PORT_BUZZER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PORT_REAR_PARKING_BUZZER_ID 0 /*!<Identifier of the rear parking buzzer*/
+
+#define PORT_BUZZER_TONE_HZ 2000 /*!<Frequency in Hz of the tone generated by the buzzer*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Initializes the buzzer with the specified identifier. The buzzer remains silent until a cadence is set.
+ *
+ * @param buzzer_id Identifier of the buzzer to initialize.
+ */
+void port_buzzer_init(uint32_t buzzer_id);
+
+/**
+ * @brief Sets the beep cadence of the buzzer with the specified identifier.
+ *
+ * The tone is emitted during the first `on_ms` milliseconds of every `period_ms` milliseconds. Both the tone and the cadence are generated by the hardware, so no further calls are needed to keep beeping.
+ *
+ * @param buzzer_id Identifier of the buzzer.
+ * @param period_ms Time in milliseconds between the start of two consecutive beeps.
+ * @param on_ms Duration in milliseconds of each beep. If it is 0 the buzzer is silenced. If it is greater than or equal to `period_ms` the tone is continuous.
+ */
+void port_buzzer_set_cadence(uint32_t buzzer_id, uint32_t period_ms, uint32_t on_ms);
+
+/**
+ * @brief Silences the buzzer with the specified identifier and stops its timers.
+ *
+ * @param buzzer_id Identifier of the buzzer.
+ */
+void port_buzzer_stop(uint32_t buzzer_id);
+
+#endif /* PORT_BUZZER_H_ */
@@ -30,6 +30,12 @@ typedef struct {
 
 
 #define PORT_REAR_PARKING_DISPLAY_ID 0 /*!<Identifier of the rear parking display*/
+
+#define PORT_FRONT_PARKING_DISPLAY_ID 1 /*!<Identifier of the front parking display*/
+
+#define PORT_REAR_PARKING_BAR_DISPLAY_ID 2 /*!<Identifier of the rear parking LED bar display*/
+
+#define PORT_DISPLAY_BAR_NUM_LEDS 8 /*!<Number of LEDs (segments) of a LED bar display*/
  
 #define PORT_DISPLAY_RGB_MAX_VALUE 255 /*!<Maximum value of the RGB color component*/
  
@@ -64,4 +70,15 @@ void port_display_init(uint32_t display_id);
  */
 void port_display_set_rgb (uint32_t display_id, rgb_color_t color);
 
+/**
+ * @brief Sets the RGB color and the fill level of the specified display.
+ *
+ * On a LED bar display, the number of lit segments is proportional to `level`, and any level greater than 0 lits at least one segment. On a single RGB LED display the level is ignored and the function behaves as `port_display_set_rgb()`.
+ *
+ * @param display_id The ID of the display to set the color for.
+ * @param color The RGB color to set.
+ * @param level Fill level of the display, from 0 (empty) to `PORT_DISPLAY_RGB_MAX_VALUE` (full).
+ */
+void port_display_set_bar (uint32_t display_id, rgb_color_t color, uint8_t level);
+
 #endif /*PORT_DISPLAY_SYSTEM_H_*/
\ No newline at end of file
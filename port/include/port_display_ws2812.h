@@ -0,0 +1,97 @@
+/**
+ * @file port_display_ws2812.h
+ * @brief Platform-independent encoding of the frames of WS2812 LED bar displays.
+ *
+ * Each bit of a WS2812 frame is sent as a pulse of fixed period whose high time selects a 0 or a 1. A frame is encoded as one PWM compare value (slot) per bit, so that a platform can clock it out with a timer and a DMA stream. The LEDs expect the colors in green, red, blue order, most significant bit first. The frame ends with some slots at 0 to leave the line low once the transfer is over, long enough for the LEDs to latch it before the next frame.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+
+#ifndef PORT_DISPLAY_WS2812_H_
+#define PORT_DISPLAY_WS2812_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "port_display.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define PORT_DISPLAY_WS2812_BITS_PER_LED 24 /*!< Number of bits (slots) of each LED in a frame.*/
+
+#define PORT_DISPLAY_WS2812_RESET_SLOTS 42 /*!< Number of slots at 0 at the end of a frame. A platform may start the next frame as soon as the last two are being sent, so the line stays low for at least 40 slots (50 us at 800 kHz), the time after which the LEDs latch the frame.*/
+
+#define PORT_DISPLAY_WS2812_FRAME_SLOTS(num_leds) ((num_leds) * PORT_DISPLAY_WS2812_BITS_PER_LED + PORT_DISPLAY_WS2812_RESET_SLOTS) /*!< Number of slots of the frame of a bar of `num_leds` LEDs.*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Computes the number of lit LEDs of a bar for a fill level. Any level greater than 0 lits at least one LED.
+ *
+ * @param level Fill level, from 0 to `PORT_DISPLAY_RGB_MAX_VALUE`.
+ * @param num_leds Number of LEDs of the bar.
+ *
+ * @return Number of lit LEDs, from 0 to `num_leds`.
+ */
+
+static inline uint32_t port_display_ws2812_get_lit_leds(uint8_t level, uint32_t num_leds)
+{
+    return ((uint32_t)level * num_leds + PORT_DISPLAY_RGB_MAX_VALUE - 1) / PORT_DISPLAY_RGB_MAX_VALUE;
+}
+
+/**
+ * @brief Encodes one byte of a frame, most significant bit first.
+ *
+ * @param value Byte to encode.
+ * @param t0h Compare value of a 0 bit.
+ * @param t1h Compare value of a 1 bit.
+ * @param p_slot Pointer to the first slot to write.
+ *
+ * @return Pointer to the slot next to the last one written.
+ */
+
+static inline uint16_t *port_display_ws2812_encode_byte(uint8_t value, uint16_t t0h, uint16_t t1h, uint16_t *p_slot)
+{
+    for (uint32_t mask = 0x80; mask != 0; mask >>= 1)
+    {
+        *p_slot++ = (value & mask) ? t1h : t0h;
+    }
+    return p_slot;
+}
+
+/**
+ * @brief Encodes the frame of a bar in which the first LEDs show `color` and the rest are off.
+ *
+ * @param p_frame Pointer to the frame. It must have room for `PORT_DISPLAY_WS2812_FRAME_SLOTS(num_leds)` slots.
+ * @param num_leds Number of LEDs of the bar.
+ * @param color Color of the lit LEDs.
+ * @param level Fill level, from 0 to `PORT_DISPLAY_RGB_MAX_VALUE`.
+ * @param t0h Compare value of a 0 bit.
+ * @param t1h Compare value of a 1 bit.
+ *
+ * @return Number of slots of the frame.
+ */
+
+static inline uint32_t port_display_ws2812_encode_bar(uint16_t *p_frame, uint32_t num_leds, rgb_color_t color, uint8_t level, uint16_t t0h, uint16_t t1h)
+{
+    uint32_t lit_leds = port_display_ws2812_get_lit_leds(level, num_leds);
+    uint16_t *p_slot = p_frame;
+
+    for (uint32_t i = 0; i < num_leds; i++)
+    {
+        rgb_color_t led = (i < lit_leds) ? color : COLOR_OFF;
+        p_slot = port_display_ws2812_encode_byte(led.g, t0h, t1h, p_slot);
+        p_slot = port_display_ws2812_encode_byte(led.r, t0h, t1h, p_slot);
+        p_slot = port_display_ws2812_encode_byte(led.b, t0h, t1h, p_slot);
+    }
+    for (uint32_t i = 0; i < PORT_DISPLAY_WS2812_RESET_SLOTS; i++)
+    {
+        *p_slot++ = 0;
+    }
+    return (uint32_t)(p_slot - p_frame);
+}
+
+#endif /* PORT_DISPLAY_WS2812_H_ */
@@ -0,0 +1,48 @@
+/**
+ * @file port_shell.h
+ * @brief Header for the portable functions to receive the command lines of the shell. The functions must be implemented in the platform-specific code.
+ *
+ * The commands are received by the UART of the telemetry, whose receive interrupt queues each byte in a ring buffer, so no byte is lost while the main loop is busy or the system sleeps (the interrupt wakes it up). The main loop takes the bytes from the ring without waiting. The replies are sent in the telemetry stream.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+#ifndef PORT_SHELL_H_
+#define PORT_SHELL_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PORT_SHELL_RX_RING_SIZE 64 /*!< Size of the ring buffer of the bytes received, in bytes (a power of 2). It holds a line typed at once. */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Enables the reception of the UART and its receive interrupt, and empties the ring.
+ */
+void port_shell_init(void);
+
+/**
+ * @brief Takes the oldest byte received from the ring. It returns at once.
+ *
+ * @param p_byte Pointer to the byte taken.
+ *
+ * @retval true if a byte has been taken.
+ * @retval false if the ring is empty.
+ */
+bool port_shell_read(uint8_t *p_byte);
+
+/**
+ * @brief Returns the number of bytes received and lost because the ring was full.
+ *
+ * @return uint32_t Number of bytes lost.
+ */
+uint32_t port_shell_get_num_overruns(void);
+
+#endif /* PORT_SHELL_H_ */
@@ -0,0 +1,81 @@
+/**
+ * @file port_storage.h
+ * @brief Header for the portable functions to interact with the non-volatile storage. The functions must be implemented in the platform-specific code.
+ *
+ * The storage is a set of sectors of flash memory with the semantics of NOR flash: an erase sets every bit of a sector to 1, and a program can only clear bits, one 32-bit word at a time. On the STM32F4 the storage is a reserved part of the internal flash, and on the native platform it is an emulator backed by a file.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+#ifndef PORT_STORAGE_H_
+#define PORT_STORAGE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PORT_STORAGE_ERASED_WORD 0xFFFFFFFFU /*!< Value of a word of an erased sector */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Initializes the storage. Its contents are kept.
+ *
+ * @retval true if the storage can be used.
+ * @retval false if the storage is not available.
+ */
+bool port_storage_init(void);
+
+/**
+ * @brief Returns the number of sectors of the storage.
+ *
+ * @return uint32_t Number of sectors.
+ */
+uint32_t port_storage_get_num_sectors(void);
+
+/**
+ * @brief Returns the size of a sector of the storage. All the sectors have the same size.
+ *
+ * @return uint32_t Size in bytes (a multiple of 4).
+ */
+uint32_t port_storage_get_sector_size(void);
+
+/**
+ * @brief Reads words of a sector.
+ *
+ * @param sector Index of the sector.
+ * @param offset Offset of the first word in the sector, in bytes (a multiple of 4).
+ * @param p_words Pointer to the words read.
+ * @param num_words Number of words to read.
+ */
+void port_storage_read(uint32_t sector, uint32_t offset, uint32_t *p_words, uint32_t num_words);
+
+/**
+ * @brief Programs words of a sector. The CPU may stall until the words are programmed (about 16 us per word on the STM32F4).
+ *
+ * @param sector Index of the sector.
+ * @param offset Offset of the first word in the sector, in bytes (a multiple of 4).
+ * @param p_words Pointer to the words to program. Each word must have been erased.
+ * @param num_words Number of words to program.
+ *
+ * @retval true if the words have been programmed.
+ * @retval false if the storage reported an error.
+ */
+bool port_storage_program(uint32_t sector, uint32_t offset, const uint32_t *p_words, uint32_t num_words);
+
+/**
+ * @brief Erases a sector. The CPU may stall until the sector is erased (about 1 s per 128 KB sector on the STM32F4).
+ *
+ * @param sector Index of the sector.
+ *
+ * @retval true if the sector has been erased.
+ * @retval false if the storage reported an error.
+ */
+bool port_storage_erase(uint32_t sector);
+
+#endif /* PORT_STORAGE_H_ */
@@ -10,6 +10,7 @@
 
 /* Includes del sistema */
 #include <stdint.h>
+#include <stdbool.h>
 
 /**
  * @brief Initializes the system.
@@ -23,6 +24,15 @@ uint32_t port_system_init(void);
  */
 uint32_t port_system_get_millis(void);
 
+/**
+ * @brief Returns the number of microseconds since the system started, modulo 2^32 (it wraps around every 71 minutes).
+ *
+ * It has the same time base as `port_system_get_millis()`, so it does not advance while the system sleeps with the SysTick suspended. Use the difference of two values to measure intervals.
+ *
+ * @retval number of microseconds since the system started.
+ */
+uint32_t port_system_get_micros(void);
+
 /**
  * @brief Sets the number of milliseconds since the system started.
  *
@@ -59,7 +69,7 @@ void port_system_power_stop(void);
 void port_system_power_sleep(void);
 
 /**
- * @brief Suspends the SysTick timer.
+ * @brief Suspends the SysTick timer. Its counter is stopped too, so that `port_system_get_micros()` stays monotonic while the system sleeps.
  */
 void port_system_systick_suspend(void);
 
@@ -73,4 +83,28 @@ void port_system_systick_resume(void);
  */
 void port_system_sleep(void);
 
+/**
+ * @brief Starts the power clock: a time base that, unlike the SysTick, keeps counting while the system sleeps or is stopped.
+ */
+void port_system_power_clock_init(void);
+
+/**
+ * @brief Returns the time of the power clock, to measure how long the system stays in each power mode.
+ *
+ * @retval number of microseconds since the power clock was started.
+ */
+uint64_t port_system_get_power_clock_us(void);
+
+/**
+ * @brief Configures the probe pin: a GPIO output that the application raises and lowers to measure the time between two events with a scope. Until it is configured, writing it does nothing.
+ */
+void port_system_probe_pin_init(void);
+
+/**
+ * @brief Sets the level of the probe pin.
+ *
+ * @param high `true` to raise the pin, `false` to lower it.
+ */
+void port_system_probe_pin_write(bool high);
+
 #endif /* PORT_SYSTEM_H_ */
@@ -0,0 +1,49 @@
+/**
+ * @file port_telemetry.h
+ * @brief Header for the portable functions to send the telemetry stream. The functions must be implemented in the platform-specific code.
+ *
+ * The stream is sent by chunks of contiguous bytes that the hardware reads on its own (a DMA stream feeding a UART on the STM32F4), so the CPU does not touch each byte. The bytes of a chunk must not change until the transfer is over.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+#ifndef PORT_TELEMETRY_H_
+#define PORT_TELEMETRY_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#ifndef PORT_TELEMETRY_BAUD_RATE
+#define PORT_TELEMETRY_BAUD_RATE 115200 /*!< Baud rate of the telemetry UART (8N1, 10 bits per byte) */
+#endif
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Configures the UART of the telemetry stream and its DMA stream. No transfer is in progress after the call.
+ */
+void port_telemetry_init(void);
+
+/**
+ * @brief Starts the transfer of a chunk of the telemetry stream. It returns at once.
+ *
+ * @param p_data Pointer to the bytes. They must not change until `port_telemetry_is_busy()` returns false.
+ * @param length Number of bytes (at least 1, and less than 65536).
+ */
+void port_telemetry_start(const uint8_t *p_data, uint32_t length);
+
+/**
+ * @brief Returns whether a chunk is being transferred. The end of a transfer raises an interrupt, so that a sleeping system wakes up to send the next chunk.
+ *
+ * @retval true if the bytes of the last chunk have not been read yet.
+ * @retval false if a new transfer can be started.
+ */
+bool port_telemetry_is_busy(void);
+
+#endif /* PORT_TELEMETRY_H_ */
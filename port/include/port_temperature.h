@@ -0,0 +1,40 @@
+/**
+ * @file port_temperature.h
+ * @brief Header for the portable functions to read the temperature of the air. The functions must be implemented in the platform-specific code.
+ *
+ * The temperature only changes slowly, so it is read at a low rate to compensate the speed of sound. A reading is split in a start and a poll, so that the caller never waits for the conversion: on the STM32F4 it is a conversion of the ADC, and on the native platform the temperature is set by the scenario.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef PORT_TEMPERATURE_H_
+#define PORT_TEMPERATURE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initializes the temperature sensor. It may be called more than once.
+ */
+void port_temperature_init(void);
+
+/**
+ * @brief Starts a reading of the temperature. A reading that is in progress is restarted.
+ */
+void port_temperature_start_conversion(void);
+
+/**
+ * @brief Returns the reading of the temperature once it is finished. Each reading is returned only once.
+ *
+ * @param p_temperature_dc Pointer to the temperature, in tenths of ºC. It is only written if the reading is finished.
+ *
+ * @retval true if a reading has finished since the last call.
+ * @retval false if no reading has been started or it is still in progress.
+ */
+bool port_temperature_get_conversion(int32_t *p_temperature_dc);
+
+#endif /* PORT_TEMPERATURE_H_ */
@@ -18,8 +18,10 @@
 #define	PORT_REAR_PARKING_SENSOR_ID   0 /*!<Identifier of the rear parking sensor*/
 #define	PORT_PARKING_SENSOR_TRIGGER_UP_US   10 /*!<Time in microseconds that the trigger signal must be up*/
 #define PORT_PARKING_SENSOR_TIMEOUT_MS 100   /*!<Timeout in milliseconds to wait for the echo signal*/
-#define SPEED_OF_SOUND_MS   343 /*!<Speed of sound in meters per second*/
+#define SPEED_OF_SOUND_MS   343 /*!<Speed of sound in meters per second at 20 ºC. The ultrasound FSM compensates it with the temperature of the air (see `speed_of_sound.h`)*/
 #define TIMER_MAX_ARR 65535 /*!<Maximum value of the timer auto-reload register*/
+#define PORT_ULTRASOUND_MAX_ECHOES 4 /*!<Maximum number of echoes captured in a single ping*/
+#define PORT_ULTRASOUND_ECHO_WINDOW_US 25000 /*!<Time in microseconds from the rising edge of the echo signal during which the echoes of a ping are captured, when more than one is listened to (about 4.3 m at 20 ºC). It must be shorter than a period of the echo timer*/
 
 /* Function prototypes and explanation -------------------------------------------------*/
 
@@ -61,6 +63,20 @@ void port_ultrasound_start_new_measurement_timer (void);
  */
 void port_ultrasound_stop_new_measurement_timer (void);
 
+/**
+ * @brief Sets the period of the timer to start a new measurement, which is also the time to wait for the echo signal. If the timer is running, the new period applies from its next update.
+ *
+ * @param period_ms Period in milliseconds (`PORT_PARKING_SENSOR_TIMEOUT_MS` by default). It must be longer than the echo of the farthest obstacle.
+ */
+void port_ultrasound_set_measurement_period_ms (uint32_t period_ms);
+
+/**
+ * @brief Gets the period of the timer to start a new measurement.
+ *
+ * @return uint32_t Period in milliseconds.
+ */
+uint32_t port_ultrasound_get_measurement_period_ms (void);
+
 /**
  * @brief Resets the number of ticks of the timer.
  */
@@ -173,5 +189,51 @@ uint32_t port_ultrasound_get_echo_overflows (uint32_t ultrasound_id);
  */
 void port_ultrasound_set_echo_overflows (uint32_t ultrasound_id, uint32_t echo_overflows);
 
+/**
+ * @brief Returns the time of the falling edge of the last echo of the ultrasound sensor with the specified identifier. It is captured in the ISR of the echo timer, so it does not depend on when the FSM of the sensor is fired.
+ *
+ * @param ultrasound_id Identifier of the ultrasound sensor.
+ *
+ * @retval Time of the edge in microseconds, in the time base of `port_system_get_micros()`.
+ */
+uint32_t port_ultrasound_get_echo_end_time_us (uint32_t ultrasound_id);
+
+/**
+ * @brief Sets the time of the falling edge of the last echo of the ultrasound sensor with the specified identifier.
+ *
+ * @param ultrasound_id Identifier of the ultrasound sensor.
+ * @param echo_end_time_us Time of the edge in microseconds, in the time base of `port_system_get_micros()`.
+ */
+void port_ultrasound_set_echo_end_time_us (uint32_t ultrasound_id, uint32_t echo_end_time_us);
+
+/**
+ * @brief Sets the number of echoes captured in each ping of the ultrasound sensor with the specified identifier, from the next ping.
+ *
+ * The rising edge of the echo signal starts the time of flight and each falling edge is the arrival of an echo. With a single echo, the ping ends at the first falling edge, as with an HC-SR04. With more, the edges are captured until `max_echoes` echoes have arrived or the window of `PORT_ULTRASOUND_ECHO_WINDOW_US` is over, and the sensor must raise the signal again between two echoes. The first echo is always the one of the fields echo init tick, echo end tick and echo overflows.
+ *
+ * @param ultrasound_id Identifier of the ultrasound sensor.
+ * @param max_echoes Number of echoes, from 1 to `PORT_ULTRASOUND_MAX_ECHOES`. Larger values are limited to it.
+ */
+void port_ultrasound_set_max_echoes (uint32_t ultrasound_id, uint32_t max_echoes);
+
+/**
+ * @brief Returns the number of echoes captured in the current ping of the ultrasound sensor with the specified identifier.
+ *
+ * @param ultrasound_id Identifier of the ultrasound sensor.
+ *
+ * @retval Number of echoes, up to the one set with `port_ultrasound_set_max_echoes()`.
+ */
+uint32_t port_ultrasound_get_num_echoes (uint32_t ultrasound_id);
+
+/**
+ * @brief Returns the time of flight of an echo captured in the current ping of the ultrasound sensor with the specified identifier.
+ *
+ * @param ultrasound_id Identifier of the ultrasound sensor.
+ * @param echo_idx Index of the echo, from 0 (the nearest one).
+ *
+ * @retval Time from the rising edge of the echo signal to the arrival of the echo in microseconds, or 0 if the echo has not been captured.
+ */
+uint32_t port_ultrasound_get_echo_width_us (uint32_t ultrasound_id, uint32_t echo_idx);
+
 
 #endif /* PORT_ULTRASOUND_H_ */
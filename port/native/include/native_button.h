@@ -0,0 +1,51 @@
+/**
+ * @file native_button.h
+ * @brief Header for native_button.c file.
+ *
+ * The simulated button has a pin that follows the presses of a scenario. Each change of the pin may bounce a random number of times, and every edge runs the same logic as the interrupt of the STM32F4 port, including the timer of the hardware debounce.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef NATIVE_BUTTON_H_
+#define NATIVE_BUTTON_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define NATIVE_BUTTON_MAX_BOUNCES 8 /*!< Maximum number of bounces of an edge of the pin.*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Sets the bounces of the edges of a button. Each edge bounces a random number of times, from 0 to `max_bounces`, within `window_us` microseconds.
+ *
+ * @param button_id ID of the button.
+ * @param max_bounces Maximum number of bounces, up to `NATIVE_BUTTON_MAX_BOUNCES`. 0 disables the bounces.
+ * @param window_us Time in microseconds during which the pin bounces.
+ */
+void native_button_set_bounce(uint32_t button_id, uint32_t max_bounces, uint32_t window_us);
+
+/**
+ * @brief Presses or releases a button now. The pin changes at once and then bounces as configured with `native_button_set_bounce()`.
+ *
+ * @param button_id ID of the button.
+ * @param pressed True to press the button, false to release it.
+ */
+void native_button_set_contact(uint32_t button_id, bool pressed);
+
+/**
+ * @brief Returns the level of the pin of a button, as seen by the microcontroller, including the bounces.
+ *
+ * @param button_id ID of the button.
+ *
+ * @retval true if the pin says that the button is pressed.
+ * @retval false otherwise.
+ */
+bool native_button_get_pin(uint32_t button_id);
+
+#endif /* NATIVE_BUTTON_H_ */
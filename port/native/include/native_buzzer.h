@@ -0,0 +1,37 @@
+/**
+ * @file native_buzzer.h
+ * @brief Header for native_buzzer.c file.
+ *
+ * The simulated buzzers keep the last cadence set by the FSMs and write every change in the timeline.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef NATIVE_BUZZER_H_
+#define NATIVE_BUZZER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Returns the period of the cadence of a buzzer.
+ *
+ * @param buzzer_id ID of the buzzer.
+ *
+ * @return Period in milliseconds (0 if the buzzer is silent).
+ */
+uint32_t native_buzzer_get_period_ms(uint32_t buzzer_id);
+
+/**
+ * @brief Returns the duration of the beeps of a buzzer.
+ *
+ * @param buzzer_id ID of the buzzer.
+ *
+ * @return Duration in milliseconds of each beep (0 if the buzzer is silent).
+ */
+uint32_t native_buzzer_get_on_ms(uint32_t buzzer_id);
+
+#endif /* NATIVE_BUZZER_H_ */
@@ -0,0 +1,40 @@
+/**
+ * @file native_display.h
+ * @brief Header for native_display.c file.
+ *
+ * The simulated displays keep the last color and fill level set by the FSMs and write every change in the timeline.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef NATIVE_DISPLAY_H_
+#define NATIVE_DISPLAY_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "port_display.h"
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Returns the color shown by a display.
+ *
+ * @param display_id ID of the display.
+ *
+ * @return Color of the display.
+ */
+rgb_color_t native_display_get_rgb(uint32_t display_id);
+
+/**
+ * @brief Returns the fill level of a display. The RGB LED displays are either off or full.
+ *
+ * @param display_id ID of the display.
+ *
+ * @return Fill level, from 0 to `PORT_DISPLAY_RGB_MAX_VALUE`.
+ */
+uint8_t native_display_get_level(uint32_t display_id);
+
+#endif /* NATIVE_DISPLAY_H_ */
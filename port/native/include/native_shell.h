@@ -0,0 +1,40 @@
+/**
+ * @file native_shell.h
+ * @brief Header for native_shell.c file.
+ *
+ * The simulated UART receives the text typed on the host one byte at a time, at `PORT_TELEMETRY_BAUD_RATE`. Each byte is queued in the ring by a simulated receive interrupt, which wakes the system up, as on the STM32F4.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef NATIVE_SHELL_H_
+#define NATIVE_SHELL_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#define NATIVE_SHELL_INPUT_SIZE 256 /*!< Bytes typed on the host and not received yet that can be queued.*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Types a text on the host. Its bytes are received after those typed before, one every byte time.
+ *
+ * @param p_text Text to type, e.g., a command line ended by `\n`.
+ *
+ * @retval true if the whole text has been queued.
+ * @retval false if it does not fit in `NATIVE_SHELL_INPUT_SIZE`: nothing is typed.
+ */
+bool native_shell_type(const char *p_text);
+
+/**
+ * @brief Returns the number of bytes typed on the host and received by the UART.
+ *
+ * @return uint32_t Number of bytes.
+ */
+uint32_t native_shell_get_num_bytes(void);
+
+#endif /* NATIVE_SHELL_H_ */
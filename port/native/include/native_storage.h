@@ -0,0 +1,88 @@
+/**
+ * @file native_storage.h
+ * @brief Header for native_storage.c file.
+ *
+ * The simulated storage emulates the reserved flash sectors of the STM32F4: an erase sets every bit of a sector to 1, a program can only clear bits, and both stall the CPU (the virtual time advances) for as long as on the target. The image of the sectors is kept in RAM and, if a file is set, written through to it, so that the contents survive between runs of the simulator as they survive power cycles on the target. A power cut can be scheduled to tear a program or an erase, to test the recovery of the data.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef NATIVE_STORAGE_H_
+#define NATIVE_STORAGE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#ifndef NATIVE_STORAGE_NUM_SECTORS
+#define NATIVE_STORAGE_NUM_SECTORS 2 /*!< Number of sectors of the simulated storage (as in the STM32F4).*/
+#endif
+
+#ifndef NATIVE_STORAGE_SECTOR_SIZE
+#define NATIVE_STORAGE_SECTOR_SIZE 0x20000U /*!< Size of the sectors of the simulated storage (as in the STM32F4).*/
+#endif
+
+#define NATIVE_STORAGE_PROGRAM_WORD_US 16 /*!< Time to program a word with a parallelism of 32 bits (STM32F446 datasheet, typical).*/
+
+#define NATIVE_STORAGE_ERASE_SECTOR_US 1000000 /*!< Time to erase a 128 KB sector with a parallelism of 32 bits (STM32F446 datasheet, typical).*/
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the counters of the operations of the simulated storage.
+ */
+typedef struct
+{
+    uint32_t num_words_programmed; /*!< Number of words programmed.*/
+    uint32_t num_erases;           /*!< Number of sectors erased.*/
+    uint32_t erase_counts[NATIVE_STORAGE_NUM_SECTORS]; /*!< Number of erases of each sector.*/
+    uint64_t busy_us;              /*!< Time in microseconds the CPU has been stalled by the storage.*/
+} native_storage_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Sets the file backing the storage and loads its image. A missing file, or one of another size, is created with every sector erased. The counters are reset and any power cut is cancelled.
+ *
+ * @param p_path Path of the file, or NULL to keep the image only in RAM, with every sector erased.
+ *
+ * @retval true if the image has been loaded or created.
+ * @retval false if the file cannot be written.
+ */
+bool native_storage_set_file(const char *p_path);
+
+/**
+ * @brief Loads the image of the storage from a file, without writing the changes through to it. The counters are reset and any power cut is cancelled.
+ *
+ * @param p_path Path of the file.
+ *
+ * @retval true if the image has been loaded.
+ * @retval false if the file cannot be read or it is not of the size of the storage.
+ */
+bool native_storage_load_file(const char *p_path);
+
+/**
+ * @brief Schedules a power cut. After the given number of words has been programmed, the next operation is torn: the word being programmed only clears some of its bits, or the sector being erased is only erased up to a random word. The storage then fails every operation, as if the power were lost, until the file is set again.
+ *
+ * @param num_words Number of words that are still programmed completely. An erase counts as one word.
+ */
+void native_storage_set_power_cut(uint32_t num_words);
+
+/**
+ * @brief Returns whether a power cut has happened.
+ *
+ * @retval true if the storage fails every operation.
+ * @retval false otherwise.
+ */
+bool native_storage_is_power_cut(void);
+
+/**
+ * @brief Returns the counters of the operations since the file was set.
+ *
+ * @return const native_storage_stats_t* Pointer to the counters.
+ */
+const native_storage_stats_t *native_storage_get_stats(void);
+
+#endif /* NATIVE_STORAGE_H_ */
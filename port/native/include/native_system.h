@@ -0,0 +1,170 @@
+/**
+ * @file native_system.h
+ * @brief Header for native_system.c file.
+ *
+ * The native platform is a deterministic discrete-event simulator of the hardware of the Urbanite. The time is virtual: it only advances when the main loop consumes it or when the system sleeps, in which case it jumps to the next scheduled event. The peripherals schedule their interrupts as events and the events scheduled at the same time run in the order in which they were scheduled. All the randomness comes from a seeded generator, so a run is reproducible bit by bit from its seed.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef NATIVE_SYSTEM_H_
+#define NATIVE_SYSTEM_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define NATIVE_SYSTEM_MAX_EVENTS 64 /*!< Maximum number of events scheduled at the same time.*/
+
+#define NATIVE_SYSTEM_DEFAULT_SEED 1 /*!< Seed of the random generator if none is given.*/
+
+#define NATIVE_SYSTEM_DEFAULT_LOOP_US 10 /*!< Default time in microseconds consumed by each iteration of the main loop while the system is awake.*/
+
+#define NATIVE_SYSTEM_NO_END UINT64_MAX /*!< End time of a simulation that never ends.*/
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Handler of a simulated event. It plays the role of an interrupt service routine or of a change of the environment.
+ *
+ * @param p_ctx Context given when the event was scheduled.
+ */
+typedef void (native_system_event_handler_t)(void *p_ctx);
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Resets the simulator: the virtual clock goes back to 0, all the events are discarded and the random generator is seeded.
+ *
+ * @param seed Seed of the random generator. 0 selects `NATIVE_SYSTEM_DEFAULT_SEED`.
+ */
+void native_system_reset(uint32_t seed);
+
+/**
+ * @brief Returns the current virtual time.
+ *
+ * @return Time in microseconds since the last reset.
+ */
+uint64_t native_system_get_time_us(void);
+
+/**
+ * @brief Sets the time at which the simulation ends. Once it is reached, the time does not advance anymore and the sleeps return immediately.
+ *
+ * @param end_us End time in microseconds, or `NATIVE_SYSTEM_NO_END`.
+ */
+void native_system_set_end_time_us(uint64_t end_us);
+
+/**
+ * @brief Checks if the simulation has reached its end time.
+ *
+ * @retval true if the simulation is over.
+ * @retval false otherwise.
+ */
+bool native_system_is_over(void);
+
+/**
+ * @brief Sets the time consumed by each iteration of the main loop while the system is awake.
+ *
+ * @param loop_us Time in microseconds.
+ */
+void native_system_set_loop_time_us(uint32_t loop_us);
+
+/**
+ * @brief Schedules an event.
+ *
+ * @param time_us Absolute virtual time in microseconds of the event. A time in the past runs the event as soon as possible.
+ * @param p_handler Function to call.
+ * @param p_ctx Context passed to the handler.
+ *
+ * @retval true if the event has been scheduled.
+ * @retval false if the event queue is full.
+ */
+bool native_system_schedule(uint64_t time_us, native_system_event_handler_t *p_handler, void *p_ctx);
+
+/**
+ * @brief Signals an interrupt: the system wakes up from sleep once the current event has run. The handlers of the events that model an interrupt of a peripheral must call it, whereas the observers of the simulation (e.g., the checks of a scenario) must not.
+ */
+void native_system_wake_up(void);
+
+/**
+ * @brief Discards all the pending events with the given handler and context.
+ *
+ * @param p_handler Handler of the events.
+ * @param p_ctx Context of the events.
+ */
+void native_system_cancel(native_system_event_handler_t *p_handler, void *p_ctx);
+
+/**
+ * @brief Checks if there is a pending event with the given handler and context.
+ *
+ * @param p_handler Handler of the event.
+ * @param p_ctx Context of the event.
+ *
+ * @retval true if the event is pending.
+ * @retval false otherwise.
+ */
+bool native_system_is_scheduled(native_system_event_handler_t *p_handler, void *p_ctx);
+
+/**
+ * @brief Advances the virtual time, running all the events that are due in the meantime.
+ *
+ * @param delta_us Time in microseconds to advance. It is truncated at the end of the simulation.
+ */
+void native_system_advance(uint64_t delta_us);
+
+/**
+ * @brief Consumes the time of one iteration of the main loop.
+ */
+void native_system_loop(void);
+
+/**
+ * @brief Returns a pseudo-random number of the seeded generator of the simulator (xorshift32).
+ *
+ * @return Random number.
+ */
+uint32_t native_system_random(void);
+
+/**
+ * @brief Returns a pseudo-random number in a range.
+ *
+ * @param min Minimum value.
+ * @param max Maximum value (included).
+ *
+ * @return Random number between `min` and `max`.
+ */
+int32_t native_system_random_range(int32_t min, int32_t max);
+
+/**
+ * @brief Sets the stream where the timeline of the simulation is written. NULL disables the timeline.
+ *
+ * @param p_stream Stream of the timeline.
+ */
+void native_system_set_timeline(FILE *p_stream);
+
+/**
+ * @brief Writes an entry of the timeline. Each entry is a line with the virtual time in milliseconds (with microsecond resolution), the source and a message.
+ *
+ * @param p_source Name of the source of the entry (e.g., `display0`).
+ * @param p_format Format of the message, as in `printf()`.
+ */
+void native_system_log(const char *p_source, const char *p_format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Sets a function to call each time the system goes to sleep, before the time jumps to the next interrupt. It lets an observer see the state of the system just before sleeping.
+ *
+ * @param p_handler Function to call, or NULL.
+ * @param p_ctx Context passed to the function.
+ */
+void native_system_set_sleep_hook(native_system_event_handler_t *p_handler, void *p_ctx);
+
+/**
+ * @brief Returns the time in microseconds that the system has spent sleeping since the last reset.
+ *
+ * @return Sleep time in microseconds.
+ */
+uint64_t native_system_get_sleep_time_us(void);
+
+#endif /* NATIVE_SYSTEM_H_ */
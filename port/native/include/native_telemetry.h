@@ -0,0 +1,37 @@
+/**
+ * @file native_telemetry.h
+ * @brief Header for native_telemetry.c file.
+ *
+ * The simulated UART writes each chunk of the telemetry stream to a file, or to a pseudo-terminal, as soon as its transfer starts, and stays busy for the time the chunk takes at `PORT_TELEMETRY_BAUD_RATE`.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef NATIVE_TELEMETRY_H_
+#define NATIVE_TELEMETRY_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Sets the file where the telemetry stream is written. It is truncated, unless it is a terminal.
+ *
+ * @param p_path Path of the file or of the pseudo-terminal, or NULL to discard the stream.
+ *
+ * @retval true if the file has been opened.
+ * @retval false if the file cannot be written.
+ */
+bool native_telemetry_set_file(const char *p_path);
+
+/**
+ * @brief Returns the number of bytes of the telemetry stream sent.
+ *
+ * @return uint32_t Number of bytes.
+ */
+uint32_t native_telemetry_get_num_bytes(void);
+
+#endif /* NATIVE_TELEMETRY_H_ */
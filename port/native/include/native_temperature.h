@@ -0,0 +1,46 @@
+/**
+ * @file native_temperature.h
+ * @brief Header for native_temperature.c file.
+ *
+ * The simulated air has a temperature set by the scenario. It is read by the simulated ADC, whose conversion takes `NATIVE_TEMPERATURE_CONVERSION_US`, and it sets the speed of sound of the simulated ultrasound sensors with the exact law, so that the approximation of the firmware is checked against it.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef NATIVE_TEMPERATURE_H_
+#define NATIVE_TEMPERATURE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define NATIVE_TEMPERATURE_DEFAULT_DC 200 /*!< Temperature of the air when the scenario does not set it, in tenths of ºC.*/
+
+#define NATIVE_TEMPERATURE_CONVERSION_US 25 /*!< Time of a conversion of the simulated ADC, in microseconds (480 cycles at 21 MHz, as in the STM32F4 port).*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Sets the temperature of the air now.
+ *
+ * @param temperature_dc Temperature, in tenths of ºC.
+ */
+void native_temperature_set(int32_t temperature_dc);
+
+/**
+ * @brief Returns the temperature of the air.
+ *
+ * @return int32_t Temperature, in tenths of ºC.
+ */
+int32_t native_temperature_get(void);
+
+/**
+ * @brief Returns the speed of sound in the air at its temperature, with the exact law 331.3 * sqrt(1 + T / 273.15) m/s.
+ *
+ * @return uint32_t Speed of sound, in mm/s.
+ */
+uint32_t native_temperature_get_speed_of_sound_mm_s(void);
+
+#endif /* NATIVE_TEMPERATURE_H_ */
@@ -0,0 +1,76 @@
+/**
+ * @file native_ultrasound.h
+ * @brief Header for native_ultrasound.c file.
+ *
+ * The simulated ultrasound sensor answers the falling edge of its trigger with an echo pulse whose width is the time of flight of the sound to the obstacle and back, at the speed of sound in the simulated air (see `native_temperature.h`). The obstacle is placed and moved by a scenario. Up to `NATIVE_ULTRASOUND_MAX_OBSTACLES - 1` static obstacles can be added: the sensor then raises the echo signal again after each echo, so that its falling edges are the arrivals of the echoes of all the obstacles, from the nearest one. The trigger, echo and measurement timers are simulated with the same time bases and interrupts as in the STM32F4 port.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef NATIVE_ULTRASOUND_H_
+#define NATIVE_ULTRASOUND_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define NATIVE_ULTRASOUND_NO_OBSTACLE UINT32_MAX /*!< Distance of an obstacle out of the range of the sensor.*/
+
+#define NATIVE_ULTRASOUND_NO_OBSTACLE_PULSE_US 38000 /*!< Width in microseconds of the echo pulse when there is no obstacle in range (HC-SR04).*/
+
+#define NATIVE_ULTRASOUND_ECHO_DELAY_US 460 /*!< Time in microseconds from the falling edge of the trigger to the rising edge of the echo (HC-SR04).*/
+
+#define NATIVE_ULTRASOUND_ECHO_TICK_US 1 /*!< Period in microseconds of the counter of the echo timer.*/
+
+#define NATIVE_ULTRASOUND_MAX_OBSTACLES 3 /*!< Maximum number of obstacles in front of a sensor: the main one and the static ones.*/
+
+#define NATIVE_ULTRASOUND_REARM_US 100 /*!< Time in microseconds that the echo signal stays low after an echo. An echo that arrives earlier is lost.*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Places the obstacle in front of an ultrasound sensor now.
+ *
+ * @param ultrasound_id ID of the ultrasound sensor.
+ * @param distance_cm Distance in cm, or `NATIVE_ULTRASOUND_NO_OBSTACLE`.
+ */
+void native_ultrasound_set_obstacle(uint32_t ultrasound_id, uint32_t distance_cm);
+
+/**
+ * @brief Moves the obstacle in front of an ultrasound sensor at a constant speed, from its current distance to a new one.
+ *
+ * @param ultrasound_id ID of the ultrasound sensor.
+ * @param distance_cm Final distance in cm.
+ * @param duration_us Time in microseconds to reach the final distance.
+ */
+void native_ultrasound_move_obstacle(uint32_t ultrasound_id, uint32_t distance_cm, uint64_t duration_us);
+
+/**
+ * @brief Returns the distance to the obstacle in front of an ultrasound sensor now.
+ *
+ * @param ultrasound_id ID of the ultrasound sensor.
+ *
+ * @return Distance in cm, or `NATIVE_ULTRASOUND_NO_OBSTACLE`.
+ */
+uint32_t native_ultrasound_get_obstacle(uint32_t ultrasound_id);
+
+/**
+ * @brief Sets the noise of the measurements of an ultrasound sensor. Each echo measures the distance plus a random error of up to `noise_cm`.
+ *
+ * @param ultrasound_id ID of the ultrasound sensor.
+ * @param noise_cm Maximum error in cm (0 for exact measurements).
+ */
+void native_ultrasound_set_noise(uint32_t ultrasound_id, uint32_t noise_cm);
+
+/**
+ * @brief Places static obstacles in front of an ultrasound sensor now, besides the main one, or removes them. Each of them sends its own echo.
+ *
+ * @param ultrasound_id ID of the ultrasound sensor.
+ * @param p_distances_cm Pointer to the distances in cm.
+ * @param num_obstacles Number of obstacles, up to `NATIVE_ULTRASOUND_MAX_OBSTACLES - 1` (0 to remove them).
+ */
+void native_ultrasound_set_extra_obstacles(uint32_t ultrasound_id, const uint32_t *p_distances_cm, uint32_t num_obstacles);
+
+#endif /* NATIVE_ULTRASOUND_H_ */
@@ -0,0 +1,249 @@
+/**
+ * @file native_button.c
+ * @brief Portable functions to interact with the button FSM library in the native platform.
+ *
+ * Every edge of the pin runs the same logic as the EXTI handler of the STM32F4 port: the edge is timestamped and, if the hardware debounce is enabled, the interrupt is masked until the debounce timer expires and samples the pin. As in the Nucleo board, the pin is active low.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* HW dependent includes */
+#include "port_button.h"
+#include "port_system.h"
+#include "native_system.h"
+#include "native_button.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the simulated hardware of a button.
+ */
+typedef struct
+{
+    bool contact;              /*!< The button is being pressed (without bounces) */
+    bool pin_pressed;          /*!< The pin says that the button is pressed (with bounces) */
+    bool flag_pressed;         /*!< Pressed flag, as set by the interrupt */
+    bool pending;              /*!< Pending flag of the interrupt line */
+    bool interrupts_enabled;   /*!< The interrupt line is enabled */
+    bool debouncing;           /*!< The debounce timer is running and the interrupt is masked */
+    uint32_t edge_time_us;     /*!< Time of the last edge that changed the pressed flag */
+    uint32_t debounce_edge_us; /*!< Time of the first edge of the bounces being debounced */
+    uint32_t debounce_ms;      /*!< Hardware debounce time (0 if disabled) */
+    uint32_t max_bounces;      /*!< Maximum number of bounces of an edge */
+    uint32_t bounce_window_us; /*!< Time during which the pin bounces */
+    uint32_t toggles_left;     /*!< Number of changes of the pin left to end the bounces of the current edge */
+    uint32_t max_gap_us;       /*!< Maximum time between two changes of the pin while bouncing */
+} native_button_hw_t;
+
+/* Global variables -----------------------------------------------------------*/
+/**
+ * @brief Array of elements that represents the simulated hardware of the buttons.
+ */
+static native_button_hw_t buttons_arr[] = {
+    [PORT_PARKING_BUTTON_ID] = {.interrupts_enabled = true},
+};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Get the button struct with the given ID.
+ *
+ * @param button_id Button ID.
+ *
+ * @return Pointer to the button struct.
+ * @return NULL If the button ID is not valid.
+ */
+static native_button_hw_t *_native_button_get(uint32_t button_id)
+{
+    if (button_id < sizeof(buttons_arr) / sizeof(buttons_arr[0]))
+    {
+        return &buttons_arr[button_id];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Logs the pressed flag of a button in the timeline.
+ *
+ * @param p_button Pointer to the button.
+ */
+static void _log_flag(native_button_hw_t *p_button)
+{
+    native_system_log("button", "%u %s", (unsigned)(p_button - buttons_arr), p_button->flag_pressed ? "pressed" : "released");
+}
+
+/**
+ * @brief Handler of the expiration of the debounce timer of a button. It samples the pin as `stm32f4_button_debounce_timeout()`.
+ *
+ * @param p_ctx Pointer to the button.
+ */
+static void _debounce_timeout(void *p_ctx)
+{
+    native_button_hw_t *p_button = (native_button_hw_t *)p_ctx;
+    native_system_wake_up();
+    p_button->debouncing = false;
+    p_button->pending = false;
+    if (p_button->pin_pressed != p_button->flag_pressed)
+    {
+        p_button->edge_time_us = p_button->debounce_edge_us;
+        p_button->flag_pressed = p_button->pin_pressed;
+        _log_flag(p_button);
+    }
+}
+
+/**
+ * @brief Emulates the interrupt of an edge of the pin of a button.
+ *
+ * @param p_button Pointer to the button.
+ */
+static void _edge(native_button_hw_t *p_button)
+{
+    if (p_button->debouncing || !p_button->interrupts_enabled)
+    {
+        // The line is masked: the edge is only latched
+        p_button->pending = true;
+        return;
+    }
+    native_system_wake_up();
+    uint32_t now_us = port_system_get_micros();
+    if (p_button->debounce_ms == 0)
+    {
+        p_button->edge_time_us = now_us;
+        if (p_button->flag_pressed != p_button->pin_pressed)
+        {
+            p_button->flag_pressed = p_button->pin_pressed;
+            _log_flag(p_button);
+        }
+    }
+    else
+    {
+        p_button->debouncing = true;
+        p_button->debounce_edge_us = now_us;
+        native_system_schedule(native_system_get_time_us() + (uint64_t)p_button->debounce_ms * 1000, _debounce_timeout, p_button);
+    }
+}
+
+/**
+ * @brief Handler of a bounce of the pin of a button.
+ *
+ * @param p_ctx Pointer to the button.
+ */
+static void _bounce(void *p_ctx)
+{
+    native_button_hw_t *p_button = (native_button_hw_t *)p_ctx;
+    p_button->pin_pressed = !p_button->pin_pressed;
+    _edge(p_button);
+    if (--p_button->toggles_left > 0)
+    {
+        uint32_t gap_us = (uint32_t)native_system_random_range(1, (int32_t)p_button->max_gap_us);
+        native_system_schedule(native_system_get_time_us() + gap_us, _bounce, p_button);
+    }
+}
+
+/* Simulation functions -------------------------------------------------------*/
+void native_button_set_bounce(uint32_t button_id, uint32_t max_bounces, uint32_t window_us)
+{
+    native_button_hw_t *p_button = _native_button_get(button_id);
+    p_button->max_bounces = (max_bounces > NATIVE_BUTTON_MAX_BOUNCES) ? NATIVE_BUTTON_MAX_BOUNCES : max_bounces;
+    p_button->bounce_window_us = window_us;
+}
+
+void native_button_set_contact(uint32_t button_id, bool pressed)
+{
+    native_button_hw_t *p_button = _native_button_get(button_id);
+    if (pressed == p_button->contact)
+    {
+        return;
+    }
+    p_button->contact = pressed;
+
+    // A new edge ends the bounces of the previous one
+    native_system_cancel(_bounce, p_button);
+    p_button->toggles_left = 0;
+    if (p_button->pin_pressed != pressed)
+    {
+        p_button->pin_pressed = pressed;
+        _edge(p_button);
+    }
+
+    // Each bounce is a pair of changes, so that the pin ends at the level of the contact
+    uint32_t bounces = (uint32_t)native_system_random_range(0, (int32_t)p_button->max_bounces);
+    if (bounces > 0 && p_button->bounce_window_us >= 2 * p_button->max_bounces)
+    {
+        p_button->toggles_left = 2 * bounces;
+        p_button->max_gap_us = p_button->bounce_window_us / (2 * p_button->max_bounces);
+        uint32_t gap_us = (uint32_t)native_system_random_range(1, (int32_t)p_button->max_gap_us);
+        native_system_schedule(native_system_get_time_us() + gap_us, _bounce, p_button);
+    }
+}
+
+bool native_button_get_pin(uint32_t button_id)
+{
+    return _native_button_get(button_id)->pin_pressed;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void port_button_init(uint32_t button_id)
+{
+    native_button_hw_t *p_button = _native_button_get(button_id);
+    native_system_cancel(_bounce, p_button);
+    native_system_cancel(_debounce_timeout, p_button);
+    p_button->contact = false;
+    p_button->pin_pressed = false;
+    p_button->flag_pressed = false;
+    p_button->pending = false;
+    p_button->interrupts_enabled = true;
+    p_button->debouncing = false;
+    p_button->edge_time_us = 0;
+    p_button->toggles_left = 0;
+}
+
+bool port_button_get_pressed(uint32_t button_id)
+{
+    return _native_button_get(button_id)->flag_pressed;
+}
+
+bool port_button_get_value(uint32_t button_id)
+{
+    // Active low
+    return !_native_button_get(button_id)->pin_pressed;
+}
+
+void port_button_set_pressed(uint32_t button_id, bool pressed)
+{
+    native_button_hw_t *p_button = _native_button_get(button_id);
+    p_button->edge_time_us = port_system_get_micros();
+    p_button->flag_pressed = pressed;
+}
+
+uint32_t port_button_get_edge_time_us(uint32_t button_id)
+{
+    return _native_button_get(button_id)->edge_time_us;
+}
+
+bool port_button_get_pending_interrupt(uint32_t button_id)
+{
+    return _native_button_get(button_id)->pending;
+}
+
+void port_button_clear_pending_interrupt(uint32_t button_id)
+{
+    _native_button_get(button_id)->pending = false;
+}
+
+void port_button_disable_interrupts(uint32_t button_id)
+{
+    _native_button_get(button_id)->interrupts_enabled = false;
+}
+
+void port_button_set_debounce(uint32_t button_id, uint32_t debounce_ms)
+{
+    native_button_hw_t *p_button = _native_button_get(button_id);
+    p_button->debounce_ms = debounce_ms;
+    if (debounce_ms == 0)
+    {
+        // Abort any debounce in progress and let every edge through again
+        native_system_cancel(_debounce_timeout, p_button);
+        p_button->debouncing = false;
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * @file native_buzzer.c
+ * @brief Portable functions to interact with the buzzer FSM library in the native platform.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* HW dependent includes */
+#include "port_buzzer.h"
+#include "native_system.h"
+#include "native_buzzer.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the simulated hardware of a buzzer.
+ */
+typedef struct
+{
+    uint32_t period_ms; /*!< Period of the cadence (0 if silent) */
+    uint32_t on_ms;     /*!< Duration of each beep (0 if silent) */
+} native_buzzer_hw_t;
+
+/* Global variables -----------------------------------------------------------*/
+/**
+ * @brief Array of elements that represents the simulated hardware of the buzzers.
+ */
+static native_buzzer_hw_t buzzers_arr[] = {
+    [PORT_REAR_PARKING_BUZZER_ID] = {.period_ms = 0},
+};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Get the buzzer struct with the given ID.
+ *
+ * @param buzzer_id Buzzer ID.
+ *
+ * @return Pointer to the buzzer struct.
+ * @return NULL If the buzzer ID is not valid.
+ */
+static native_buzzer_hw_t *_native_buzzer_get(uint32_t buzzer_id)
+{
+    if (buzzer_id < sizeof(buzzers_arr) / sizeof(buzzers_arr[0]))
+    {
+        return &buzzers_arr[buzzer_id];
+    }
+    return NULL;
+}
+
+/* Simulation functions -------------------------------------------------------*/
+uint32_t native_buzzer_get_period_ms(uint32_t buzzer_id)
+{
+    return _native_buzzer_get(buzzer_id)->period_ms;
+}
+
+uint32_t native_buzzer_get_on_ms(uint32_t buzzer_id)
+{
+    return _native_buzzer_get(buzzer_id)->on_ms;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void port_buzzer_init(uint32_t buzzer_id)
+{
+    native_buzzer_hw_t *p_buzzer = _native_buzzer_get(buzzer_id);
+    p_buzzer->period_ms = 0;
+    p_buzzer->on_ms = 0;
+}
+
+void port_buzzer_set_cadence(uint32_t buzzer_id, uint32_t period_ms, uint32_t on_ms)
+{
+    native_buzzer_hw_t *p_buzzer = _native_buzzer_get(buzzer_id);
+    if ((on_ms == 0) || (period_ms == 0))
+    {
+        port_buzzer_stop(buzzer_id);
+        return;
+    }
+    if (on_ms > period_ms)
+    {
+        on_ms = period_ms;
+    }
+    if (p_buzzer->period_ms != period_ms || p_buzzer->on_ms != on_ms)
+    {
+        native_system_log("buzzer", "%lu beep %lu ms every %lu ms", (unsigned long)buzzer_id, (unsigned long)on_ms, (unsigned long)period_ms);
+    }
+    p_buzzer->period_ms = period_ms;
+    p_buzzer->on_ms = on_ms;
+}
+
+void port_buzzer_stop(uint32_t buzzer_id)
+{
+    native_buzzer_hw_t *p_buzzer = _native_buzzer_get(buzzer_id);
+    if (p_buzzer->period_ms != 0)
+    {
+        native_system_log("buzzer", "%lu silent", (unsigned long)buzzer_id);
+    }
+    p_buzzer->period_ms = 0;
+    p_buzzer->on_ms = 0;
+}
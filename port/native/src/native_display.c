@@ -0,0 +1,97 @@
+/**
+ * @file native_display.c
+ * @brief Portable functions to interact with the display FSM library in the native platform.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* HW dependent includes */
+#include "port_display.h"
+#include "native_system.h"
+#include "native_display.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the simulated hardware of a display.
+ */
+typedef struct
+{
+    rgb_color_t color; /*!< Color shown by the display */
+    uint8_t level;     /*!< Fill level of the display */
+} native_display_hw_t;
+
+/* Global variables -----------------------------------------------------------*/
+/**
+ * @brief Array of elements that represents the simulated hardware of the displays.
+ */
+static native_display_hw_t displays_arr[] = {
+    [PORT_REAR_PARKING_DISPLAY_ID] = {.level = 0},
+    [PORT_FRONT_PARKING_DISPLAY_ID] = {.level = 0},
+    [PORT_REAR_PARKING_BAR_DISPLAY_ID] = {.level = 0},
+};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Get the display struct with the given ID.
+ *
+ * @param display_id Display ID.
+ *
+ * @return Pointer to the display struct.
+ * @return NULL If the display ID is not valid.
+ */
+static native_display_hw_t *_native_display_get(uint32_t display_id)
+{
+    if (display_id < sizeof(displays_arr) / sizeof(displays_arr[0]))
+    {
+        return &displays_arr[display_id];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Sets the color and the fill level of a display and writes the change in the timeline.
+ *
+ * @param display_id Display ID.
+ * @param color Color of the display.
+ * @param level Fill level of the display.
+ */
+static void _set(uint32_t display_id, rgb_color_t color, uint8_t level)
+{
+    native_display_hw_t *p_display = _native_display_get(display_id);
+    if (p_display->color.r != color.r || p_display->color.g != color.g || p_display->color.b != color.b || p_display->level != level)
+    {
+        native_system_log("display", "%lu rgb %u %u %u level %u", (unsigned long)display_id, color.r, color.g, color.b, level);
+    }
+    p_display->color = color;
+    p_display->level = level;
+}
+
+/* Simulation functions -------------------------------------------------------*/
+rgb_color_t native_display_get_rgb(uint32_t display_id)
+{
+    return _native_display_get(display_id)->color;
+}
+
+uint8_t native_display_get_level(uint32_t display_id)
+{
+    return _native_display_get(display_id)->level;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void port_display_init(uint32_t display_id)
+{
+    native_display_hw_t *p_display = _native_display_get(display_id);
+    p_display->color = COLOR_OFF;
+    p_display->level = 0;
+}
+
+void port_display_set_rgb(uint32_t display_id, rgb_color_t color)
+{
+    _set(display_id, color, PORT_DISPLAY_RGB_MAX_VALUE);
+}
+
+void port_display_set_bar(uint32_t display_id, rgb_color_t color, uint8_t level)
+{
+    _set(display_id, color, level);
+}
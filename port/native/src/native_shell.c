@@ -0,0 +1,109 @@
+/**
+ * @file native_shell.c
+ * @brief Portable functions to receive the command lines of the shell in the native platform.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Standard C includes */
+#include <string.h>
+/* HW dependent includes */
+#include "port_shell.h"
+#include "port_telemetry.h"
+#include "native_system.h"
+#include "native_shell.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define NATIVE_SHELL_BITS_PER_BYTE 10 /*!< Start bit, 8 data bits and stop bit */
+#define NATIVE_SHELL_BYTE_US ((NATIVE_SHELL_BITS_PER_BYTE * 1000000 + PORT_TELEMETRY_BAUD_RATE - 1) / PORT_TELEMETRY_BAUD_RATE) /*!< Time of a byte on the line, in microseconds */
+#define NATIVE_SHELL_RX_RING_MASK (PORT_SHELL_RX_RING_SIZE - 1) /*!< Mask of an index of the ring */
+
+/* Global variables -----------------------------------------------------------*/
+static uint8_t rx_ring[PORT_SHELL_RX_RING_SIZE]; /*!< Bytes received and not taken yet */
+static uint32_t rx_head = 0;                     /*!< Free-running index where the next byte is received */
+static uint32_t rx_tail = 0;                     /*!< Free-running index of the next byte to take */
+static uint32_t num_overruns = 0;                /*!< Bytes lost because the ring was full */
+static char input[NATIVE_SHELL_INPUT_SIZE];      /*!< Bytes typed on the host and not sent yet */
+static uint32_t input_length = 0;                /*!< Number of bytes of `input` */
+static uint32_t num_bytes = 0;                   /*!< Bytes received */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Receives the next byte typed, as the receive interrupt of the UART, and schedules the following one.
+ *
+ * @param p_ctx Unused.
+ */
+static void _native_shell_receive(void *p_ctx)
+{
+    if (rx_head - rx_tail < PORT_SHELL_RX_RING_SIZE)
+    {
+        rx_ring[rx_head & NATIVE_SHELL_RX_RING_MASK] = (uint8_t)input[0];
+        rx_head++;
+    }
+    else
+    {
+        num_overruns++;
+    }
+    num_bytes++;
+    input_length--;
+    memmove(input, &input[1], input_length);
+    if (input_length > 0)
+    {
+        native_system_schedule(native_system_get_time_us() + NATIVE_SHELL_BYTE_US, _native_shell_receive, NULL);
+    }
+    native_system_wake_up();
+}
+
+/* Public functions -----------------------------------------------------------*/
+void port_shell_init(void)
+{
+    native_system_cancel(_native_shell_receive, NULL);
+    rx_head = 0;
+    rx_tail = 0;
+    num_overruns = 0;
+    input_length = 0;
+    num_bytes = 0;
+}
+
+bool port_shell_read(uint8_t *p_byte)
+{
+    if (rx_tail == rx_head)
+    {
+        return false;
+    }
+    *p_byte = rx_ring[rx_tail & NATIVE_SHELL_RX_RING_MASK];
+    rx_tail++;
+    return true;
+}
+
+uint32_t port_shell_get_num_overruns(void)
+{
+    return num_overruns;
+}
+
+/* Simulation functions -------------------------------------------------------*/
+bool native_shell_type(const char *p_text)
+{
+    uint32_t length = (uint32_t)strlen(p_text);
+    if (length > NATIVE_SHELL_INPUT_SIZE - input_length)
+    {
+        return false;
+    }
+    if (length == 0)
+    {
+        return true;
+    }
+    memcpy(&input[input_length], p_text, length);
+    if (input_length == 0)
+    {
+        native_system_schedule(native_system_get_time_us() + NATIVE_SHELL_BYTE_US, _native_shell_receive, NULL);
+    }
+    input_length += length;
+    return true;
+}
+
+uint32_t native_shell_get_num_bytes(void)
+{
+    return num_bytes;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file native_storage.c
+ * @brief Portable functions to interact with the non-volatile storage in the native platform.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <string.h>
+/* HW dependent includes */
+#include "port_storage.h"
+#include "native_system.h"
+#include "native_storage.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define NATIVE_STORAGE_SIZE (NATIVE_STORAGE_NUM_SECTORS * NATIVE_STORAGE_SECTOR_SIZE) /*!< Size of the image of the storage, in bytes.*/
+
+/* Global variables -----------------------------------------------------------*/
+static uint32_t image[NATIVE_STORAGE_SIZE / sizeof(uint32_t)]; /*!< Image of the sectors.*/
+static bool image_loaded = false;                              /*!< The image has been loaded or erased.*/
+static FILE *p_file = NULL;                                    /*!< File backing the image, or NULL.*/
+static native_storage_stats_t stats;                           /*!< Counters of the operations.*/
+static bool power_cut_scheduled = false;                       /*!< A power cut will tear an operation.*/
+static uint32_t power_cut_words = 0;                           /*!< Words that are still programmed before the power cut.*/
+static bool power_cut = false;                                 /*!< The power has been cut.*/
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Returns the index of a word of the image.
+ *
+ * @param sector Index of the sector.
+ * @param offset Offset of the word in the sector, in bytes.
+ *
+ * @return uint32_t Index of the word in `image`.
+ */
+static uint32_t _native_storage_index(uint32_t sector, uint32_t offset)
+{
+    return (sector * NATIVE_STORAGE_SECTOR_SIZE + offset) / sizeof(uint32_t);
+}
+
+/**
+ * @brief Writes words of the image through to the file, if any.
+ *
+ * @param index Index of the first word.
+ * @param num_words Number of words.
+ */
+static void _native_storage_write_through(uint32_t index, uint32_t num_words)
+{
+    if (p_file == NULL)
+    {
+        return;
+    }
+    fseek(p_file, (long)(index * sizeof(uint32_t)), SEEK_SET);
+    fwrite(&image[index], sizeof(uint32_t), num_words, p_file);
+    fflush(p_file);
+}
+
+/**
+ * @brief Stalls the CPU while the storage is busy.
+ *
+ * @param busy_us Time in microseconds.
+ */
+static void _native_storage_stall(uint32_t busy_us)
+{
+    stats.busy_us += busy_us;
+    native_system_advance(busy_us);
+}
+
+/**
+ * @brief Consumes one word of the schedule of the power cut.
+ *
+ * @retval true if the power is cut during this word.
+ * @retval false if the word can be completed.
+ */
+static bool _native_storage_cut_now(void)
+{
+    if (!power_cut_scheduled)
+    {
+        return false;
+    }
+    if (power_cut_words > 0)
+    {
+        power_cut_words--;
+        return false;
+    }
+    power_cut_scheduled = false;
+    power_cut = true;
+    return true;
+}
+
+/* Public functions -----------------------------------------------------------*/
+bool port_storage_init(void)
+{
+    if (!image_loaded)
+    {
+        memset(image, 0xFF, sizeof(image));
+        image_loaded = true;
+    }
+    return true;
+}
+
+uint32_t port_storage_get_num_sectors(void)
+{
+    return NATIVE_STORAGE_NUM_SECTORS;
+}
+
+uint32_t port_storage_get_sector_size(void)
+{
+    return NATIVE_STORAGE_SECTOR_SIZE;
+}
+
+void port_storage_read(uint32_t sector, uint32_t offset, uint32_t *p_words, uint32_t num_words)
+{
+    port_storage_init();
+    memcpy(p_words, &image[_native_storage_index(sector, offset)], num_words * sizeof(uint32_t));
+}
+
+bool port_storage_program(uint32_t sector, uint32_t offset, const uint32_t *p_words, uint32_t num_words)
+{
+    port_storage_init();
+    if (power_cut || sector >= NATIVE_STORAGE_NUM_SECTORS || (offset % sizeof(uint32_t)) != 0 || offset + num_words * sizeof(uint32_t) > NATIVE_STORAGE_SECTOR_SIZE)
+    {
+        return false;
+    }
+    uint32_t index = _native_storage_index(sector, offset);
+    uint32_t i = 0;
+    for (; i < num_words; i++)
+    {
+        if (_native_storage_cut_now())
+        {
+            // Only some of the bits that should be cleared are cleared
+            image[index + i] &= p_words[i] | native_system_random();
+            break;
+        }
+        image[index + i] &= p_words[i]; // A program can only clear bits
+    }
+    uint32_t num_programmed = (i < num_words) ? i + 1 : num_words;
+    stats.num_words_programmed += num_programmed;
+    _native_storage_write_through(index, num_programmed);
+    _native_storage_stall(num_programmed * NATIVE_STORAGE_PROGRAM_WORD_US);
+    native_system_log("storage", "program sector %lu offset %lu words %lu%s", (unsigned long)sector, (unsigned long)offset, (unsigned long)num_programmed, power_cut ? " POWER CUT" : "");
+    return !power_cut;
+}
+
+bool port_storage_erase(uint32_t sector)
+{
+    port_storage_init();
+    if (power_cut || sector >= NATIVE_STORAGE_NUM_SECTORS)
+    {
+        return false;
+    }
+    uint32_t index = _native_storage_index(sector, 0);
+    uint32_t num_words = NATIVE_STORAGE_SECTOR_SIZE / sizeof(uint32_t);
+    uint32_t busy_us = NATIVE_STORAGE_ERASE_SECTOR_US;
+    if (_native_storage_cut_now())
+    {
+        // The sector is only erased up to a random word
+        uint32_t num_erased = native_system_random() % num_words;
+        busy_us = (uint32_t)((uint64_t)busy_us * num_erased / num_words);
+        num_words = num_erased;
+    }
+    memset(&image[index], 0xFF, num_words * sizeof(uint32_t));
+    stats.num_erases++;
+    stats.erase_counts[sector]++;
+    _native_storage_write_through(index, num_words);
+    _native_storage_stall(busy_us);
+    native_system_log("storage", "erase sector %lu%s", (unsigned long)sector, power_cut ? " POWER CUT" : "");
+    return !power_cut;
+}
+
+/**
+ * @brief Closes the file backing the storage, erases the image and resets the counters and the power cut.
+ */
+static void _native_storage_reset(void)
+{
+    if (p_file != NULL)
+    {
+        fclose(p_file);
+        p_file = NULL;
+    }
+    memset(&stats, 0, sizeof(stats));
+    power_cut_scheduled = false;
+    power_cut = false;
+    memset(image, 0xFF, sizeof(image));
+    image_loaded = true;
+}
+
+/**
+ * @brief Reads the image from an open file.
+ *
+ * @param p_stream File.
+ *
+ * @return `true` if the file has the size of the image and has been read, `false` otherwise. The image is left erased if it has not been read.
+ */
+static bool _native_storage_read_image(FILE *p_stream)
+{
+    fseek(p_stream, 0, SEEK_END);
+    if (ftell(p_stream) == (long)sizeof(image))
+    {
+        fseek(p_stream, 0, SEEK_SET);
+        if (fread(image, sizeof(image), 1, p_stream) == 1)
+        {
+            return true;
+        }
+    }
+    memset(image, 0xFF, sizeof(image));
+    return false;
+}
+
+/* Simulation functions -------------------------------------------------------*/
+bool native_storage_set_file(const char *p_path)
+{
+    _native_storage_reset();
+    if (p_path == NULL)
+    {
+        return true;
+    }
+
+    p_file = fopen(p_path, "r+b");
+    if (p_file != NULL)
+    {
+        if (_native_storage_read_image(p_file))
+        {
+            return true;
+        }
+        fclose(p_file);
+    }
+
+    p_file = fopen(p_path, "w+b");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    _native_storage_write_through(0, sizeof(image) / sizeof(uint32_t));
+    return true;
+}
+
+bool native_storage_load_file(const char *p_path)
+{
+    _native_storage_reset();
+    FILE *p_stream = fopen(p_path, "rb");
+    if (p_stream == NULL)
+    {
+        return false;
+    }
+    bool ok = _native_storage_read_image(p_stream);
+    fclose(p_stream);
+    return ok;
+}
+
+void native_storage_set_power_cut(uint32_t num_words)
+{
+    power_cut_scheduled = true;
+    power_cut_words = num_words;
+}
+
+bool native_storage_is_power_cut(void)
+{
+    return power_cut;
+}
+
+const native_storage_stats_t *native_storage_get_stats(void)
+{
+    return &stats;
+}
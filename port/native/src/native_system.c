@@ -0,0 +1,317 @@
+/**
+ * @file native_system.c
+ * @brief This file implements the port layer for the system functions in the native platform: a deterministic discrete-event simulator.
+ *
+ * The pending events are kept in an array sorted by time and, for the same time, by order of arrival. The queue is short (a few timers and the scripted inputs), so a sorted array is simpler and faster than a heap.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Standard C includes */
+#include <stdarg.h>
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_system.h"
+#include "native_system.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing a pending event of the simulation.
+ */
+typedef struct
+{
+    uint64_t time_us;                        /*!< Virtual time of the event */
+    native_system_event_handler_t *p_handler; /*!< Function to call */
+    void *p_ctx;                             /*!< Context of the function */
+} native_system_event_t;
+
+/* Private variables ----------------------------------------------------------*/
+static native_system_event_t events_arr[NATIVE_SYSTEM_MAX_EVENTS]; /*!< Pending events, sorted by time */
+static uint32_t num_events = 0;                                   /*!< Number of pending events */
+static bool interrupt = false;                                    /*!< An interrupt has been signaled while running an event */
+static bool systick = true;                                       /*!< The SysTick is running, so its tick wakes the system up every millisecond */
+static uint64_t now_us = 0;                                       /*!< Virtual time */
+static uint64_t end_us = NATIVE_SYSTEM_NO_END;                    /*!< End of the simulation */
+static uint64_t sleep_us = 0;                                     /*!< Time spent sleeping */
+static uint32_t loop_us = NATIVE_SYSTEM_DEFAULT_LOOP_US;          /*!< Time of an iteration of the main loop */
+static uint32_t millis_offset = 0;                                /*!< Offset of the millisecond counter set by `port_system_set_millis()` */
+static uint32_t random_state = NATIVE_SYSTEM_DEFAULT_SEED;        /*!< State of the random generator */
+static FILE *p_timeline = NULL;                                   /*!< Stream of the timeline */
+static native_system_event_handler_t *p_sleep_hook = NULL;        /*!< Function called before sleeping */
+static void *p_sleep_hook_ctx = NULL;                             /*!< Context of the function called before sleeping */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Removes the first pending event and runs it. The virtual time advances to the time of the event.
+ */
+static void _run_first_event(void)
+{
+    native_system_event_t event = events_arr[0];
+    num_events--;
+    memmove(&events_arr[0], &events_arr[1], num_events * sizeof(events_arr[0]));
+    if (event.time_us > now_us)
+    {
+        now_us = event.time_us;
+    }
+    event.p_handler(event.p_ctx);
+}
+
+/* Public functions -----------------------------------------------------------*/
+void native_system_reset(uint32_t seed)
+{
+    num_events = 0;
+    interrupt = false;
+    systick = true;
+    now_us = 0;
+    end_us = NATIVE_SYSTEM_NO_END;
+    sleep_us = 0;
+    loop_us = NATIVE_SYSTEM_DEFAULT_LOOP_US;
+    millis_offset = 0;
+    random_state = (seed != 0) ? seed : NATIVE_SYSTEM_DEFAULT_SEED;
+}
+
+uint64_t native_system_get_time_us(void)
+{
+    return now_us;
+}
+
+void native_system_set_end_time_us(uint64_t end_time_us)
+{
+    end_us = end_time_us;
+}
+
+bool native_system_is_over(void)
+{
+    return now_us >= end_us;
+}
+
+void native_system_set_loop_time_us(uint32_t time_us)
+{
+    loop_us = time_us;
+}
+
+bool native_system_schedule(uint64_t time_us, native_system_event_handler_t *p_handler, void *p_ctx)
+{
+    if (num_events == NATIVE_SYSTEM_MAX_EVENTS)
+    {
+        return false;
+    }
+    // Insert after the events of the same time, so that they run in order of arrival
+    uint32_t idx = num_events;
+    while (idx > 0 && events_arr[idx - 1].time_us > time_us)
+    {
+        events_arr[idx] = events_arr[idx - 1];
+        idx--;
+    }
+    events_arr[idx] = (native_system_event_t){.time_us = time_us, .p_handler = p_handler, .p_ctx = p_ctx};
+    num_events++;
+    return true;
+}
+
+void native_system_wake_up(void)
+{
+    // The interrupt service routines resume the SysTick
+    interrupt = true;
+    systick = true;
+}
+
+void native_system_cancel(native_system_event_handler_t *p_handler, void *p_ctx)
+{
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < num_events; i++)
+    {
+        if (events_arr[i].p_handler != p_handler || events_arr[i].p_ctx != p_ctx)
+        {
+            events_arr[kept++] = events_arr[i];
+        }
+    }
+    num_events = kept;
+}
+
+bool native_system_is_scheduled(native_system_event_handler_t *p_handler, void *p_ctx)
+{
+    for (uint32_t i = 0; i < num_events; i++)
+    {
+        if (events_arr[i].p_handler == p_handler && events_arr[i].p_ctx == p_ctx)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void native_system_advance(uint64_t delta_us)
+{
+    uint64_t target_us = (end_us - now_us > delta_us) ? now_us + delta_us : end_us;
+    while (num_events > 0 && events_arr[0].time_us <= target_us)
+    {
+        _run_first_event();
+    }
+    now_us = target_us;
+}
+
+void native_system_loop(void)
+{
+    native_system_advance(loop_us);
+}
+
+uint32_t native_system_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+int32_t native_system_random_range(int32_t min, int32_t max)
+{
+    if (max <= min)
+    {
+        return min;
+    }
+    return min + (int32_t)(native_system_random() % (uint32_t)(max - min + 1));
+}
+
+void native_system_set_timeline(FILE *p_stream)
+{
+    p_timeline = p_stream;
+}
+
+void native_system_log(const char *p_source, const char *p_format, ...)
+{
+    if (p_timeline == NULL)
+    {
+        return;
+    }
+    va_list args;
+    va_start(args, p_format);
+    fprintf(p_timeline, "%8llu.%03llu %-12s ", (unsigned long long)(now_us / 1000), (unsigned long long)(now_us % 1000), p_source);
+    vfprintf(p_timeline, p_format, args);
+    fputc('\n', p_timeline);
+    va_end(args);
+}
+
+void native_system_set_sleep_hook(native_system_event_handler_t *p_handler, void *p_ctx)
+{
+    p_sleep_hook = p_handler;
+    p_sleep_hook_ctx = p_ctx;
+}
+
+uint64_t native_system_get_sleep_time_us(void)
+{
+    return sleep_us;
+}
+
+/* Port functions -------------------------------------------------------------*/
+uint32_t port_system_init()
+{
+    return 0;
+}
+
+uint32_t port_system_get_millis()
+{
+    return (uint32_t)(now_us / 1000) + millis_offset;
+}
+
+uint32_t port_system_get_micros()
+{
+    return (uint32_t)now_us + millis_offset * 1000;
+}
+
+void port_system_set_millis(uint32_t ms)
+{
+    millis_offset = ms - (uint32_t)(now_us / 1000);
+}
+
+void port_system_delay_ms(uint32_t ms)
+{
+    native_system_advance((uint64_t)ms * 1000);
+}
+
+void port_system_delay_until_ms(uint32_t *p_t, uint32_t ms)
+{
+    uint32_t until = *p_t + ms;
+    uint32_t now = port_system_get_millis();
+    if (until > now)
+    {
+        port_system_delay_ms(until - now);
+    }
+    *p_t = port_system_get_millis();
+}
+
+void port_system_systick_resume()
+{
+    // The virtual clock never stops, but a running SysTick wakes the system up
+    systick = true;
+}
+
+void port_system_systick_suspend()
+{
+    systick = false;
+}
+
+void port_system_power_stop()
+{
+    // The clock of the SysTick is stopped too
+    bool running = systick;
+    systick = false;
+    port_system_power_sleep();
+    systick = systick || running;
+}
+
+void port_system_power_sleep()
+{
+    if (p_sleep_hook != NULL)
+    {
+        p_sleep_hook(p_sleep_hook_ctx);
+    }
+
+    // Jump from event to event until one of them is an interrupt, or to the next tick of the SysTick if it is running
+    uint64_t start_us = now_us;
+    uint64_t wake_us = end_us;
+    if (systick && ((now_us / 1000) + 1) * 1000 < end_us)
+    {
+        wake_us = ((now_us / 1000) + 1) * 1000;
+    }
+    interrupt = false;
+    while (!interrupt && now_us < wake_us)
+    {
+        if (num_events == 0 || events_arr[0].time_us > wake_us)
+        {
+            now_us = wake_us;
+        }
+        else
+        {
+            _run_first_event();
+        }
+    }
+    sleep_us += now_us - start_us;
+}
+
+void port_system_sleep()
+{
+    port_system_systick_suspend();
+    port_system_power_sleep();
+}
+
+void port_system_power_clock_init()
+{
+    // The virtual clock never stops, so it is also the power clock
+}
+
+uint64_t port_system_get_power_clock_us()
+{
+    return now_us;
+}
+
+void port_system_probe_pin_init()
+{
+    // There is no scope on the host: the latencies are measured with the virtual clock
+}
+
+void port_system_probe_pin_write(bool high)
+{
+}
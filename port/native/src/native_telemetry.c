@@ -0,0 +1,81 @@
+/**
+ * @file native_telemetry.c
+ * @brief Portable functions to send the telemetry stream in the native platform.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+/* HW dependent includes */
+#include "port_telemetry.h"
+#include "native_system.h"
+#include "native_telemetry.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define NATIVE_TELEMETRY_BITS_PER_BYTE 10 /*!< Start bit, 8 data bits and stop bit */
+
+/* Global variables -----------------------------------------------------------*/
+static FILE *p_file = NULL;   /*!< File of the stream, or NULL to discard it */
+static bool busy = false;     /*!< A chunk is being transferred */
+static uint32_t num_bytes = 0; /*!< Bytes sent */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Ends the transfer of a chunk, as the transfer complete interrupt of the DMA stream.
+ *
+ * @param p_ctx Unused.
+ */
+static void _native_telemetry_transfer_complete(void *p_ctx)
+{
+    busy = false;
+    native_system_wake_up();
+}
+
+/* Public functions -----------------------------------------------------------*/
+void port_telemetry_init(void)
+{
+    native_system_cancel(_native_telemetry_transfer_complete, NULL);
+    busy = false;
+    num_bytes = 0;
+}
+
+void port_telemetry_start(const uint8_t *p_data, uint32_t length)
+{
+    if (p_file != NULL)
+    {
+        fwrite(p_data, 1, length, p_file);
+        fflush(p_file);
+    }
+    num_bytes += length;
+    busy = true;
+    uint64_t transfer_us = ((uint64_t)length * NATIVE_TELEMETRY_BITS_PER_BYTE * 1000000 + PORT_TELEMETRY_BAUD_RATE - 1) / PORT_TELEMETRY_BAUD_RATE;
+    native_system_schedule(native_system_get_time_us() + transfer_us, _native_telemetry_transfer_complete, NULL);
+}
+
+bool port_telemetry_is_busy(void)
+{
+    return busy;
+}
+
+/* Simulation functions -------------------------------------------------------*/
+bool native_telemetry_set_file(const char *p_path)
+{
+    if (p_file != NULL)
+    {
+        fclose(p_file);
+        p_file = NULL;
+    }
+    if (p_path == NULL)
+    {
+        return true;
+    }
+    p_file = fopen(p_path, "wb");
+    return p_file != NULL;
+}
+
+uint32_t native_telemetry_get_num_bytes(void)
+{
+    return num_bytes;
+}
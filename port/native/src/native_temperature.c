@@ -0,0 +1,102 @@
+/**
+ * @file native_temperature.c
+ * @brief Portable functions to read the temperature of the air in the native platform.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Standard C includes */
+#include <stdbool.h>
+/* HW dependent includes */
+#include "port_temperature.h"
+#include "native_system.h"
+#include "native_temperature.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define NATIVE_TEMPERATURE_0C_MM_S 331300ULL /*!< Speed of sound at 0 ºC, in mm/s */
+#define NATIVE_TEMPERATURE_0C_CK 27315 /*!< 0 ºC in hundredths of K */
+
+/* Global variables -----------------------------------------------------------*/
+static int32_t temperature_dc = NATIVE_TEMPERATURE_DEFAULT_DC; /*!< Temperature of the air */
+static bool conversion_pending = false;                         /*!< A conversion has been started and not returned */
+static uint64_t conversion_end_us = 0;                          /*!< Time at which the conversion ends */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Returns the integer square root of a number.
+ *
+ * @param value Number.
+ *
+ * @return uint64_t Largest integer whose square is not greater than the number.
+ */
+static uint64_t _native_temperature_isqrt(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void port_temperature_init(void)
+{
+    conversion_pending = false;
+}
+
+void port_temperature_start_conversion(void)
+{
+    conversion_pending = true;
+    conversion_end_us = native_system_get_time_us() + NATIVE_TEMPERATURE_CONVERSION_US;
+}
+
+bool port_temperature_get_conversion(int32_t *p_temperature_dc)
+{
+    if (!conversion_pending || native_system_get_time_us() < conversion_end_us)
+    {
+        return false;
+    }
+    conversion_pending = false;
+    *p_temperature_dc = temperature_dc;
+    return true;
+}
+
+/* Simulation functions -------------------------------------------------------*/
+void native_temperature_set(int32_t new_temperature_dc)
+{
+    temperature_dc = new_temperature_dc;
+    int32_t magnitude_dc = (temperature_dc < 0) ? -temperature_dc : temperature_dc;
+    native_system_log("temperature", "%s%ld.%ld C", (temperature_dc < 0) ? "-" : "", (long)(magnitude_dc / 10), (long)(magnitude_dc % 10));
+}
+
+int32_t native_temperature_get(void)
+{
+    return temperature_dc;
+}
+
+uint32_t native_temperature_get_speed_of_sound_mm_s(void)
+{
+    // c = c0 * sqrt(T / T0), with the temperatures in hundredths of K
+    int64_t temperature_ck = NATIVE_TEMPERATURE_0C_CK + (int64_t)temperature_dc * 10;
+    if (temperature_ck <= 0)
+    {
+        return 0;
+    }
+    return (uint32_t)_native_temperature_isqrt(NATIVE_TEMPERATURE_0C_MM_S * NATIVE_TEMPERATURE_0C_MM_S * (uint64_t)temperature_ck / NATIVE_TEMPERATURE_0C_CK);
+}
@@ -0,0 +1,572 @@
+/**
+ * @file native_ultrasound.c
+ * @brief Portable functions to interact with the ultrasound FSM library in the native platform.
+ *
+ * The timers are simulated as in the STM32F4 port: the trigger timer interrupts every `PORT_PARKING_SENSOR_TRIGGER_UP_US`, the echo timer counts at 1 MHz up to `TIMER_MAX_ARR`, interrupts on every overflow, captures both edges of the echo and ends the window of the echoes, and the measurement timer interrupts every `PORT_PARKING_SENSOR_TIMEOUT_MS` (or the period set at runtime).
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+/* HW dependent includes */
+#include "port_ultrasound.h"
+#include "port_system.h"
+#include "native_system.h"
+#include "native_ultrasound.h"
+#include "native_temperature.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the simulated hardware of an ultrasound sensor and of its obstacle.
+ */
+typedef struct
+{
+    bool trigger_ready;        /*!< Flag to indicate if the trigger signal is ready to start a new measurement */
+    bool trigger_end;          /*!< Flag to indicate if the trigger signal has ended */
+    bool echo_received;        /*!< Flag to indicate if the echo signal has been received */
+    uint32_t echo_init_tick;   /*!< Initial tick of the echo signal */
+    uint32_t echo_end_tick;    /*!< End tick of the echo signal */
+    uint32_t echo_overflows;   /*!< Number of overflows of the echo signal */
+    uint32_t echo_end_time_us; /*!< Time of the falling edge of the echo signal, in microseconds */
+    bool trigger_high;         /*!< Level of the trigger pin */
+    bool echo_timer_running;   /*!< The echo timer is counting */
+    uint64_t echo_timer_start_us; /*!< Time at which the counter of the echo timer was reset */
+    uint32_t max_echoes;       /*!< Number of echoes captured in each ping */
+    uint32_t ping_max_echoes;  /*!< Number of echoes captured in the current ping, fixed at its first edge */
+    uint32_t num_edges;        /*!< Number of edges of the echo signal captured in the current ping */
+    uint32_t num_echoes;       /*!< Number of echoes captured in the current ping */
+    uint32_t echo_widths_us[PORT_ULTRASOUND_MAX_ECHOES]; /*!< Time of flight of each echo captured in the current ping, in microseconds */
+    bool echo_window_over;     /*!< The window of the echoes of the current ping is over */
+    bool echo_done;            /*!< The current ping has ended, so its later edges are not taken as a new one */
+    uint32_t flights_us[NATIVE_ULTRASOUND_MAX_OBSTACLES]; /*!< Time of flight of each echo being sent by the sensor, from the nearest one */
+    uint32_t num_flights;      /*!< Number of echoes being sent by the sensor */
+    uint32_t next_flight;      /*!< Index of the next echo to be sent by the sensor */
+    uint64_t echo_rise_us;     /*!< Time of the first rising edge of the echo signal being sent by the sensor */
+    uint32_t from_cm;          /*!< Distance to the obstacle at the start of its movement */
+    uint32_t to_cm;            /*!< Distance to the obstacle at the end of its movement */
+    uint64_t from_us;          /*!< Start time of the movement of the obstacle */
+    uint64_t to_us;            /*!< End time of the movement of the obstacle */
+    uint32_t noise_cm;         /*!< Maximum error of the measurements */
+    uint32_t extra_cm[NATIVE_ULTRASOUND_MAX_OBSTACLES - 1]; /*!< Distances to the static obstacles behind or in front of the main one */
+    uint32_t num_extra;        /*!< Number of static obstacles */
+} native_ultrasound_hw_t;
+
+/* Private functions prototypes ------------------------------------------------*/
+static void _echo_rise(void *p_ctx);
+
+/* Global variables -----------------------------------------------------------*/
+/**
+ * @brief Array of elements that represents the simulated hardware of the ultrasound sensors.
+ */
+static native_ultrasound_hw_t ultrasounds_arr[] = {
+    [PORT_REAR_PARKING_SENSOR_ID] = {.trigger_ready = false, .max_echoes = 1, .from_cm = NATIVE_ULTRASOUND_NO_OBSTACLE, .to_cm = NATIVE_ULTRASOUND_NO_OBSTACLE},
+};
+
+static uint32_t measurement_period_ms = PORT_PARKING_SENSOR_TIMEOUT_MS; /*!< Period of the measurement timer */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Get the ultrasound sensor struct with the given ID.
+ *
+ * @param ultrasound_id Ultrasound sensor ID.
+ *
+ * @return Pointer to the ultrasound sensor struct.
+ * @return NULL If the ultrasound sensor ID is not valid.
+ */
+static native_ultrasound_hw_t *_native_ultrasound_get(uint32_t ultrasound_id)
+{
+    if (ultrasound_id < sizeof(ultrasounds_arr) / sizeof(ultrasounds_arr[0]))
+    {
+        return &ultrasounds_arr[ultrasound_id];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Handler of the update interrupt of the trigger timer.
+ *
+ * @param p_ctx Pointer to the ultrasound sensor.
+ */
+static void _trigger_timer_update(void *p_ctx)
+{
+    native_ultrasound_hw_t *p_ultrasound = (native_ultrasound_hw_t *)p_ctx;
+    native_system_wake_up();
+    p_ultrasound->trigger_end = true;
+    native_system_schedule(native_system_get_time_us() + PORT_PARKING_SENSOR_TRIGGER_UP_US, _trigger_timer_update, p_ultrasound);
+}
+
+/**
+ * @brief Handler of the update interrupt of the echo timer. It counts the overflows.
+ *
+ * @param p_ctx Pointer to the ultrasound sensor.
+ */
+static void _echo_timer_update(void *p_ctx)
+{
+    native_ultrasound_hw_t *p_ultrasound = (native_ultrasound_hw_t *)p_ctx;
+    native_system_wake_up();
+    p_ultrasound->echo_overflows++;
+    native_system_schedule(native_system_get_time_us() + (TIMER_MAX_ARR + 1) * NATIVE_ULTRASOUND_ECHO_TICK_US, _echo_timer_update, p_ultrasound);
+}
+
+/**
+ * @brief Ends the current ping: the echoes captured are ready for the FSM.
+ *
+ * @param p_ultrasound Pointer to the ultrasound sensor.
+ */
+static void _echo_done(native_ultrasound_hw_t *p_ultrasound)
+{
+    p_ultrasound->echo_done = true;
+    p_ultrasound->echo_received = true;
+}
+
+/**
+ * @brief Handler of the compare interrupt of the echo timer that ends the window of the echoes, as in the STM32F4 port.
+ *
+ * @param p_ctx Pointer to the ultrasound sensor.
+ */
+static void _echo_window_end(void *p_ctx)
+{
+    native_ultrasound_hw_t *p_ultrasound = (native_ultrasound_hw_t *)p_ctx;
+    native_system_wake_up();
+    p_ultrasound->echo_window_over = true;
+    // With no echo yet, the ping ends at the first one, however late
+    if (!p_ultrasound->echo_done && (p_ultrasound->num_echoes > 0))
+    {
+        _echo_done(p_ultrasound);
+    }
+}
+
+/**
+ * @brief Clears the edges and the echoes of the current ping, and disables the end of its window.
+ *
+ * @param p_ultrasound Pointer to the ultrasound sensor.
+ */
+static void _echo_clear(native_ultrasound_hw_t *p_ultrasound)
+{
+    native_system_cancel(_echo_window_end, p_ultrasound);
+    p_ultrasound->num_edges = 0;
+    p_ultrasound->num_echoes = 0;
+    p_ultrasound->echo_window_over = false;
+}
+
+/**
+ * @brief Captures an edge of the echo with the echo timer, as the handler of its capture interrupt in the STM32F4 port.
+ *
+ * @param p_ultrasound Pointer to the ultrasound sensor.
+ */
+static void _echo_capture(native_ultrasound_hw_t *p_ultrasound)
+{
+    if (!p_ultrasound->echo_timer_running || p_ultrasound->echo_done)
+    {
+        return;
+    }
+    native_system_wake_up();
+    uint32_t tick = (uint32_t)(((native_system_get_time_us() - p_ultrasound->echo_timer_start_us) / NATIVE_ULTRASOUND_ECHO_TICK_US) % (TIMER_MAX_ARR + 1));
+    if (p_ultrasound->num_edges == 0)
+    {
+        // Rising edge: the time of flight starts
+        p_ultrasound->echo_init_tick = tick;
+        p_ultrasound->ping_max_echoes = p_ultrasound->max_echoes;
+        if (p_ultrasound->ping_max_echoes > 1)
+        {
+            native_system_schedule(native_system_get_time_us() + PORT_ULTRASOUND_ECHO_WINDOW_US, _echo_window_end, p_ultrasound);
+        }
+    }
+    else if (p_ultrasound->num_edges % 2 == 1)
+    {
+        // Falling edge: an echo has arrived
+        if (p_ultrasound->num_echoes == 0)
+        {
+            p_ultrasound->echo_end_tick = tick;
+            p_ultrasound->echo_end_time_us = port_system_get_micros();
+        }
+        p_ultrasound->echo_widths_us[p_ultrasound->num_echoes++] = (uint16_t)(tick - p_ultrasound->echo_init_tick);
+        if ((p_ultrasound->num_echoes >= p_ultrasound->ping_max_echoes) || p_ultrasound->echo_window_over)
+        {
+            _echo_done(p_ultrasound);
+        }
+    }
+    p_ultrasound->num_edges++;
+}
+
+/**
+ * @brief Handler of a falling edge of the echo signal: an echo arrives. The sensor raises the signal again for the next echo, if any.
+ *
+ * @param p_ctx Pointer to the ultrasound sensor.
+ */
+static void _echo_fall(void *p_ctx)
+{
+    native_ultrasound_hw_t *p_ultrasound = (native_ultrasound_hw_t *)p_ctx;
+    _echo_capture(p_ultrasound);
+    p_ultrasound->next_flight++;
+    if (p_ultrasound->next_flight < p_ultrasound->num_flights)
+    {
+        native_system_schedule(native_system_get_time_us() + NATIVE_ULTRASOUND_REARM_US, _echo_rise, p_ultrasound);
+    }
+}
+
+/**
+ * @brief Handler of a rising edge of the echo signal. The first one starts the time of flight of all the echoes, which are fixed by the distances to the obstacles at the falling edge of the trigger.
+ *
+ * @param p_ctx Pointer to the ultrasound sensor.
+ */
+static void _echo_rise(void *p_ctx)
+{
+    native_ultrasound_hw_t *p_ultrasound = (native_ultrasound_hw_t *)p_ctx;
+    if (p_ultrasound->next_flight == 0)
+    {
+        p_ultrasound->echo_rise_us = native_system_get_time_us();
+    }
+    _echo_capture(p_ultrasound);
+    native_system_schedule(p_ultrasound->echo_rise_us + p_ultrasound->flights_us[p_ultrasound->next_flight], _echo_fall, p_ultrasound);
+}
+
+/**
+ * @brief Handler of the update interrupt of the measurement timer.
+ *
+ * @param p_ctx Pointer to the ultrasound sensor.
+ */
+static void _measurement_timer_update(void *p_ctx)
+{
+    native_system_wake_up();
+    ultrasounds_arr[PORT_REAR_PARKING_SENSOR_ID].trigger_ready = true;
+    native_system_schedule(native_system_get_time_us() + (uint64_t)measurement_period_ms * 1000, _measurement_timer_update, NULL);
+}
+
+/**
+ * @brief Comparison function for qsort of the times of flight.
+ *
+ * @param a Pointer to the first time.
+ * @param b Pointer to the second time.
+ * @return int Negative, zero or positive if the first time is smaller, equal or greater than the second one.
+ */
+static int _compare_flights(const void *a, const void *b)
+{
+    uint32_t flight_a = *(const uint32_t *)a;
+    uint32_t flight_b = *(const uint32_t *)b;
+    return (flight_a > flight_b) - (flight_a < flight_b);
+}
+
+/**
+ * @brief Computes the time of flight of the echo of an obstacle now.
+ *
+ * @param p_ultrasound Pointer to the ultrasound sensor.
+ * @param distance_cm Distance to the obstacle in cm.
+ *
+ * @return Time of flight in microseconds.
+ */
+static uint32_t _echo_width_us(native_ultrasound_hw_t *p_ultrasound, uint32_t distance_cm)
+{
+    int64_t measured_cm = (int64_t)distance_cm + native_system_random_range(-(int32_t)p_ultrasound->noise_cm, (int32_t)p_ultrasound->noise_cm);
+    if (measured_cm < 0)
+    {
+        measured_cm = 0;
+    }
+    // Round trip of the sound at the temperature of the air: t = 2 d / v, rounded to the closest microsecond
+    uint64_t speed_mm_s = native_temperature_get_speed_of_sound_mm_s();
+    uint64_t width_us = ((uint64_t)measured_cm * 20000000 + speed_mm_s / 2) / speed_mm_s;
+    return (width_us > NATIVE_ULTRASOUND_NO_OBSTACLE_PULSE_US) ? NATIVE_ULTRASOUND_NO_OBSTACLE_PULSE_US : (uint32_t)width_us;
+}
+
+/**
+ * @brief Computes the echoes that the sensor sends now, from the nearest one. An echo that arrives before the sensor can raise the signal again after the previous one is lost. With no obstacle, the sensor sends a single pulse of `NATIVE_ULTRASOUND_NO_OBSTACLE_PULSE_US`.
+ *
+ * @param ultrasound_id ID of the ultrasound sensor.
+ */
+static void _echo_flights(uint32_t ultrasound_id)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    uint32_t flights_us[NATIVE_ULTRASOUND_MAX_OBSTACLES];
+    uint32_t num_flights = 0;
+    uint32_t distance_cm = native_ultrasound_get_obstacle(ultrasound_id);
+    if (distance_cm != NATIVE_ULTRASOUND_NO_OBSTACLE)
+    {
+        flights_us[num_flights++] = _echo_width_us(p_ultrasound, distance_cm);
+    }
+    for (uint32_t i = 0; i < p_ultrasound->num_extra; i++)
+    {
+        flights_us[num_flights++] = _echo_width_us(p_ultrasound, p_ultrasound->extra_cm[i]);
+    }
+    if (num_flights == 0)
+    {
+        flights_us[num_flights++] = NATIVE_ULTRASOUND_NO_OBSTACLE_PULSE_US;
+    }
+    qsort(flights_us, num_flights, sizeof(uint32_t), _compare_flights);
+
+    p_ultrasound->num_flights = 0;
+    p_ultrasound->next_flight = 0;
+    for (uint32_t i = 0; i < num_flights; i++)
+    {
+        if ((p_ultrasound->num_flights == 0) || (flights_us[i] > p_ultrasound->flights_us[p_ultrasound->num_flights - 1] + NATIVE_ULTRASOUND_REARM_US))
+        {
+            p_ultrasound->flights_us[p_ultrasound->num_flights++] = flights_us[i];
+        }
+    }
+}
+
+/* Simulation functions -------------------------------------------------------*/
+void native_ultrasound_set_obstacle(uint32_t ultrasound_id, uint32_t distance_cm)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    p_ultrasound->from_cm = distance_cm;
+    p_ultrasound->to_cm = distance_cm;
+    p_ultrasound->from_us = native_system_get_time_us();
+    p_ultrasound->to_us = p_ultrasound->from_us;
+    if (distance_cm == NATIVE_ULTRASOUND_NO_OBSTACLE)
+    {
+        native_system_log("obstacle", "%lu none", (unsigned long)ultrasound_id);
+    }
+    else
+    {
+        native_system_log("obstacle", "%lu %lu cm", (unsigned long)ultrasound_id, (unsigned long)distance_cm);
+    }
+}
+
+void native_ultrasound_move_obstacle(uint32_t ultrasound_id, uint32_t distance_cm, uint64_t duration_us)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    uint32_t current_cm = native_ultrasound_get_obstacle(ultrasound_id);
+    if (current_cm == NATIVE_ULTRASOUND_NO_OBSTACLE || distance_cm == NATIVE_ULTRASOUND_NO_OBSTACLE)
+    {
+        // There is no way from or to the infinity: the obstacle appears or disappears at once
+        native_ultrasound_set_obstacle(ultrasound_id, distance_cm);
+        return;
+    }
+    p_ultrasound->from_cm = current_cm;
+    p_ultrasound->to_cm = distance_cm;
+    p_ultrasound->from_us = native_system_get_time_us();
+    p_ultrasound->to_us = p_ultrasound->from_us + duration_us;
+    native_system_log("obstacle", "%lu %lu cm -> %lu cm in %llu ms", (unsigned long)ultrasound_id, (unsigned long)current_cm, (unsigned long)distance_cm, (unsigned long long)(duration_us / 1000));
+}
+
+uint32_t native_ultrasound_get_obstacle(uint32_t ultrasound_id)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    uint64_t now_us = native_system_get_time_us();
+    if (now_us >= p_ultrasound->to_us)
+    {
+        return p_ultrasound->to_cm;
+    }
+    int64_t delta_cm = (int64_t)p_ultrasound->to_cm - (int64_t)p_ultrasound->from_cm;
+    int64_t elapsed_us = (int64_t)(now_us - p_ultrasound->from_us);
+    int64_t duration_us = (int64_t)(p_ultrasound->to_us - p_ultrasound->from_us);
+    return (uint32_t)((int64_t)p_ultrasound->from_cm + delta_cm * elapsed_us / duration_us);
+}
+
+void native_ultrasound_set_noise(uint32_t ultrasound_id, uint32_t noise_cm)
+{
+    _native_ultrasound_get(ultrasound_id)->noise_cm = noise_cm;
+}
+
+void native_ultrasound_set_extra_obstacles(uint32_t ultrasound_id, const uint32_t *p_distances_cm, uint32_t num_obstacles)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    char text[64];
+    int length = snprintf(text, sizeof(text), "%s", (num_obstacles == 0) ? " none" : "");
+    p_ultrasound->num_extra = 0;
+    for (uint32_t i = 0; (i < num_obstacles) && (i < NATIVE_ULTRASOUND_MAX_OBSTACLES - 1); i++)
+    {
+        p_ultrasound->extra_cm[p_ultrasound->num_extra++] = p_distances_cm[i];
+        length += snprintf(text + length, sizeof(text) - (size_t)length, " %lu cm", (unsigned long)p_distances_cm[i]);
+    }
+    native_system_log("extra", "%lu%s", (unsigned long)ultrasound_id, text);
+}
+
+/* Public functions -----------------------------------------------------------*/
+void port_ultrasound_init(uint32_t ultrasound_id)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    native_system_cancel(_trigger_timer_update, p_ultrasound);
+    native_system_cancel(_echo_timer_update, p_ultrasound);
+    native_system_cancel(_echo_rise, p_ultrasound);
+    native_system_cancel(_echo_fall, p_ultrasound);
+    native_system_cancel(_measurement_timer_update, NULL);
+    _echo_clear(p_ultrasound);
+    p_ultrasound->echo_done = false;
+    p_ultrasound->trigger_high = false;
+    p_ultrasound->echo_timer_running = false;
+    p_ultrasound->echo_init_tick = 0;
+    p_ultrasound->echo_end_tick = 0;
+    p_ultrasound->echo_overflows = 0;
+    p_ultrasound->trigger_ready = true;
+    p_ultrasound->trigger_end = false;
+    p_ultrasound->echo_received = false;
+}
+
+void port_ultrasound_start_measurement(uint32_t ultrasound_id)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    uint64_t now_us = native_system_get_time_us();
+    p_ultrasound->trigger_ready = false;
+    p_ultrasound->trigger_high = true;
+    // The edges of the echo signal belong to this ping from now on
+    _echo_clear(p_ultrasound);
+    p_ultrasound->echo_done = false;
+
+    // Reset the counters and enable the timers
+    native_system_cancel(_trigger_timer_update, p_ultrasound);
+    native_system_schedule(now_us + PORT_PARKING_SENSOR_TRIGGER_UP_US, _trigger_timer_update, p_ultrasound);
+    native_system_cancel(_echo_timer_update, p_ultrasound);
+    native_system_schedule(now_us + (TIMER_MAX_ARR + 1) * NATIVE_ULTRASOUND_ECHO_TICK_US, _echo_timer_update, p_ultrasound);
+    p_ultrasound->echo_timer_running = true;
+    p_ultrasound->echo_timer_start_us = now_us;
+    native_system_cancel(_measurement_timer_update, NULL);
+    native_system_schedule(now_us + (uint64_t)measurement_period_ms * 1000, _measurement_timer_update, NULL);
+}
+
+void port_ultrasound_stop_trigger_timer(uint32_t ultrasound_id)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    native_system_cancel(_trigger_timer_update, p_ultrasound);
+    if (p_ultrasound->trigger_high)
+    {
+        // The sensor answers the falling edge of the trigger
+        p_ultrasound->trigger_high = false;
+        _echo_flights(ultrasound_id);
+        native_system_cancel(_echo_rise, p_ultrasound);
+        native_system_cancel(_echo_fall, p_ultrasound);
+        native_system_schedule(native_system_get_time_us() + NATIVE_ULTRASOUND_ECHO_DELAY_US, _echo_rise, p_ultrasound);
+    }
+}
+
+void port_ultrasound_stop_echo_timer(uint32_t ultrasound_id)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    native_system_cancel(_echo_timer_update, p_ultrasound);
+    p_ultrasound->echo_timer_running = false;
+}
+
+void port_ultrasound_start_new_measurement_timer(void)
+{
+    if (!native_system_is_scheduled(_measurement_timer_update, NULL))
+    {
+        native_system_schedule(native_system_get_time_us() + (uint64_t)measurement_period_ms * 1000, _measurement_timer_update, NULL);
+    }
+}
+
+void port_ultrasound_set_measurement_period_ms(uint32_t period_ms)
+{
+    measurement_period_ms = period_ms; // The next update is already scheduled with the old period
+}
+
+uint32_t port_ultrasound_get_measurement_period_ms(void)
+{
+    return measurement_period_ms;
+}
+
+void port_ultrasound_set_max_echoes(uint32_t ultrasound_id, uint32_t max_echoes)
+{
+    if (max_echoes == 0)
+    {
+        max_echoes = 1;
+    }
+    _native_ultrasound_get(ultrasound_id)->max_echoes = (max_echoes > PORT_ULTRASOUND_MAX_ECHOES) ? PORT_ULTRASOUND_MAX_ECHOES : max_echoes;
+}
+
+uint32_t port_ultrasound_get_num_echoes(uint32_t ultrasound_id)
+{
+    return _native_ultrasound_get(ultrasound_id)->num_echoes;
+}
+
+uint32_t port_ultrasound_get_echo_width_us(uint32_t ultrasound_id, uint32_t echo_idx)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    return (echo_idx < p_ultrasound->num_echoes) ? p_ultrasound->echo_widths_us[echo_idx] : 0;
+}
+
+void port_ultrasound_stop_new_measurement_timer(void)
+{
+    native_system_cancel(_measurement_timer_update, NULL);
+}
+
+void port_ultrasound_reset_echo_ticks(uint32_t ultrasound_id)
+{
+    native_ultrasound_hw_t *p_ultrasound = _native_ultrasound_get(ultrasound_id);
+    p_ultrasound->echo_init_tick = 0;
+    p_ultrasound->echo_end_tick = 0;
+    p_ultrasound->echo_overflows = 0;
+    p_ultrasound->echo_received = false;
+    _echo_clear(p_ultrasound);
+}
+
+void port_ultrasound_stop_ultrasound(uint32_t ultrasound_id)
+{
+    port_ultrasound_stop_trigger_timer(ultrasound_id);
+    port_ultrasound_stop_echo_timer(ultrasound_id);
+    port_ultrasound_stop_new_measurement_timer();
+    port_ultrasound_reset_echo_ticks(ultrasound_id);
+}
+
+bool port_ultrasound_get_trigger_ready(uint32_t ultrasound_id)
+{
+    return _native_ultrasound_get(ultrasound_id)->trigger_ready;
+}
+
+void port_ultrasound_set_trigger_ready(uint32_t ultrasound_id, bool trigger_ready)
+{
+    _native_ultrasound_get(ultrasound_id)->trigger_ready = trigger_ready;
+}
+
+bool port_ultrasound_get_trigger_end(uint32_t ultrasound_id)
+{
+    return _native_ultrasound_get(ultrasound_id)->trigger_end;
+}
+
+void port_ultrasound_set_trigger_end(uint32_t ultrasound_id, bool trigger_end)
+{
+    _native_ultrasound_get(ultrasound_id)->trigger_end = trigger_end;
+}
+
+uint32_t port_ultrasound_get_echo_init_tick(uint32_t ultrasound_id)
+{
+    return _native_ultrasound_get(ultrasound_id)->echo_init_tick;
+}
+
+void port_ultrasound_set_echo_init_tick(uint32_t ultrasound_id, uint32_t echo_init_tick)
+{
+    _native_ultrasound_get(ultrasound_id)->echo_init_tick = echo_init_tick;
+}
+
+uint32_t port_ultrasound_get_echo_end_tick(uint32_t ultrasound_id)
+{
+    return _native_ultrasound_get(ultrasound_id)->echo_end_tick;
+}
+
+void port_ultrasound_set_echo_end_tick(uint32_t ultrasound_id, uint32_t echo_end_tick)
+{
+    _native_ultrasound_get(ultrasound_id)->echo_end_tick = echo_end_tick;
+}
+
+bool port_ultrasound_get_echo_received(uint32_t ultrasound_id)
+{
+    return _native_ultrasound_get(ultrasound_id)->echo_received;
+}
+
+void port_ultrasound_set_echo_received(uint32_t ultrasound_id, bool echo_received)
+{
+    _native_ultrasound_get(ultrasound_id)->echo_received = echo_received;
+}
+
+uint32_t port_ultrasound_get_echo_overflows(uint32_t ultrasound_id)
+{
+    return _native_ultrasound_get(ultrasound_id)->echo_overflows;
+}
+
+void port_ultrasound_set_echo_overflows(uint32_t ultrasound_id, uint32_t echo_overflows)
+{
+    _native_ultrasound_get(ultrasound_id)->echo_overflows = echo_overflows;
+}
+
+uint32_t port_ultrasound_get_echo_end_time_us(uint32_t ultrasound_id)
+{
+    return _native_ultrasound_get(ultrasound_id)->echo_end_time_us;
+}
+
+void port_ultrasound_set_echo_end_time_us(uint32_t ultrasound_id, uint32_t echo_end_time_us)
+{
+    _native_ultrasound_get(ultrasound_id)->echo_end_time_us = echo_end_time_us;
+}
@@ -10,6 +10,7 @@
 /* Includes ------------------------------------------------------------------*/
 /* Standard C includes */
 #include <stdint.h>
+#include <stdbool.h>
 
 /* HW dependent includes */
 #include "stm32f4xx.h"
@@ -19,6 +20,10 @@
 #define STM32F4_PARKING_BUTTON_GPIO GPIOC /*!< GPIO port for the parking button.*/
 #define STM32F4_PARKING_BUTTON_PIN 13 /*!< GPIO pin for the parking button.*/
 
+#define STM32F4_PARKING_BUTTON_DEBOUNCE_TIMER TIM10 /*!< One-shot timer of the hardware debounce of the parking button.*/
+
+#define STM32F4_BUTTON_DEBOUNCE_TICK_HZ 1000 /*!< Frequency of the counter of the debounce timers (1 tick = 1 ms). With a system clock above 65.5 MHz the counter runs at a multiple of it, so that its prescaler fits in 16 bits.*/
+
 
 
 /* Function prototypes and explanation -------------------------------------------------*/
@@ -32,4 +37,28 @@
  */
 void stm32f4_button_set_new_gpio(uint32_t button_id, GPIO_TypeDef *p_port, uint8_t pin);
 
+/**
+ * @brief Starts the hardware debounce of a button after an edge. It masks the interrupt of the button and starts its debounce timer. It is called from the handler of the EXTI line of the button.
+ *
+ * @param button_id ID of the button.
+ *
+ * @retval true if the debounce has been started: the pressed flag will be updated when the debounce timer expires.
+ * @retval false if the hardware debounce of the button is disabled: the caller must update the pressed flag.
+ */
+bool stm32f4_button_debounce_start(uint32_t button_id);
+
+/**
+ * @brief Ends the hardware debounce of a button. It samples the pin, updates the pressed flag and unmasks the interrupt of the button. To be called from the ISR of the debounce timer.
+ *
+ * @param button_id ID of the button.
+ */
+void stm32f4_button_debounce_timeout(uint32_t button_id);
+
+/**
+ * @brief Ends the hardware debounce of all the buttons that are being debounced with a timer. To be called from the ISR of the timer.
+ *
+ * @param p_timer Debounce timer that has expired.
+ */
+void stm32f4_button_debounce_timer_expired(TIM_TypeDef *p_timer);
+
 #endif /* STM32F4_BUTTON_H_ */
\ No newline at end of file
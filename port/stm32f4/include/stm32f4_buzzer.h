@@ -0,0 +1,26 @@
+/**
+ * @file stm32f4_buzzer.h
+ * @brief Header for stm32f4_buzzer.c file.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+#ifndef STM32F4_BUZZER_H_
+#define STM32F4_BUZZER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define STM32F4_REAR_PARKING_BUZZER_GPIO GPIOB /*!< GPIO port for the rear parking buzzer.*/
+
+#define STM32F4_REAR_PARKING_BUZZER_PIN 14 /*!< GPIO pin for the rear parking buzzer (TIM12_CH1).*/
+
+#define STM32F4_BUZZER_CADENCE_TICK_HZ 1000 /*!< Frequency of the counter of the cadence timer (1 tick = 1 ms). With a system clock above 65.5 MHz the counter runs at a multiple of it, so that its prescaler fits in 16 bits.*/
+
+#endif /* STM32F4_BUZZER_H_ */
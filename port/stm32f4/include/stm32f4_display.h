@@ -13,6 +13,7 @@
 #include <stdint.h>
 
 /* HW dependent includes */
+#include "port_display.h"
 #include "stm32f4xx.h"
 
 /* Defines and enums ----------------------------------------------------------*/
@@ -29,4 +30,49 @@
  
 #define STM32F4_REAR_PARKING_DISPLAY_RGB_B_PIN 9 /*!< GPIO pin for the blue component of the RGB LED.*/
 
+#define STM32F4_FRONT_PARKING_DISPLAY_RGB_R_GPIO GPIOA /*!< GPIO port for the red component of the front RGB LED (TIM1_CH1).*/
+
+#define STM32F4_FRONT_PARKING_DISPLAY_RGB_R_PIN 8 /*!< GPIO pin for the red component of the front RGB LED.*/
+
+#define STM32F4_FRONT_PARKING_DISPLAY_RGB_G_GPIO GPIOA /*!< GPIO port for the green component of the front RGB LED (TIM1_CH2).*/
+
+#define STM32F4_FRONT_PARKING_DISPLAY_RGB_G_PIN 9 /*!< GPIO pin for the green component of the front RGB LED.*/
+
+#define STM32F4_FRONT_PARKING_DISPLAY_RGB_B_GPIO GPIOA /*!< GPIO port for the blue component of the front RGB LED (TIM1_CH3).*/
+
+#define STM32F4_FRONT_PARKING_DISPLAY_RGB_B_PIN 10 /*!< GPIO pin for the blue component of the front RGB LED.*/
+
+#define STM32F4_REAR_PARKING_BAR_ID 0 /*!< Index of the rear parking LED bar in the table of LED bars.*/
+
+#define STM32F4_REAR_PARKING_BAR_DATA_GPIO GPIOC /*!< GPIO port for the data line of the rear LED bar (TIM8_CH1).*/
+
+#define STM32F4_REAR_PARKING_BAR_DATA_PIN 6 /*!< GPIO pin for the data line of the rear LED bar.*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+
+/**
+ * @brief Configures the GPIO, the PWM timer and the DMA stream of a WS2812 LED bar, and switches all its LEDs off.
+ *
+ * @param bar_id The index of the LED bar.
+ */
+void stm32f4_display_bar_init(uint32_t bar_id);
+
+/**
+ * @brief Sets the color and the fill level of a WS2812 LED bar.
+ *
+ * The frame is only encoded and sent if the color or the number of lit LEDs change. The bits are clocked out by the DMA, so the function returns as soon as the transfer is started.
+ *
+ * @param bar_id The index of the LED bar.
+ * @param color The color of the lit LEDs.
+ * @param level Fill level of the bar, from 0 (empty) to `PORT_DISPLAY_RGB_MAX_VALUE` (full).
+ */
+void stm32f4_display_bar_set(uint32_t bar_id, rgb_color_t color, uint8_t level);
+
+/**
+ * @brief Stops the timer of a WS2812 LED bar once the DMA has transferred the whole frame. It must be called from the ISR of the DMA stream.
+ *
+ * @param bar_id The index of the LED bar.
+ */
+void stm32f4_display_bar_transfer_complete(uint32_t bar_id);
+
 #endif /* STM32F4_DISPLAY_SYSTEM_H_ */
\ No newline at end of file
@@ -0,0 +1,23 @@
+/**
+ * @file stm32f4_shell.h
+ * @brief Header for stm32f4_shell.c file.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef STM32F4_SHELL_H_
+#define STM32F4_SHELL_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Queues a byte received by the UART of the shell in the ring. The byte is lost and counted if the ring is full. It must be called from the ISR of the UART.
+ *
+ * @param byte Byte received.
+ */
+void stm32f4_shell_receive(uint8_t byte);
+
+#endif /* STM32F4_SHELL_H_ */
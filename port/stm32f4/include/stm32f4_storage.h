@@ -0,0 +1,32 @@
+/**
+ * @file stm32f4_storage.h
+ * @brief Header for stm32f4_storage.c file.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef STM32F4_STORAGE_H_
+#define STM32F4_STORAGE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define STM32F4_STORAGE_FIRST_SECTOR 6 /*!< First flash sector reserved for the storage (sectors 6 and 7 of the STM32F446RE). The image must stay below it (see the flash budget of the footprint report).*/
+
+#define STM32F4_STORAGE_NUM_SECTORS 2 /*!< Number of flash sectors reserved for the storage.*/
+
+#define STM32F4_STORAGE_SECTOR_SIZE 0x20000U /*!< Size of the reserved flash sectors (128 KB).*/
+
+#define STM32F4_STORAGE_BASE_ADDRESS 0x08040000U /*!< Address of the first flash sector reserved for the storage.*/
+
+#define STM32F4_FLASH_KEY1 0x45670123U /*!< First key to unlock the flash control register.*/
+
+#define STM32F4_FLASH_KEY2 0xCDEF89ABU /*!< Second key to unlock the flash control register.*/
+
+#endif /* STM32F4_STORAGE_H_ */
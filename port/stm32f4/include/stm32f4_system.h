@@ -41,6 +41,32 @@
 /* Alternate functions */
 #define STM32F4_AF1 0x01U /*!< Alternate function 1 */
 #define STM32F4_AF2 0x02U /*!< Alternate function 2 */
+#define STM32F4_AF3 0x03U /*!< Alternate function 3 */
+#define STM32F4_AF7 0x07U /*!< Alternate function 7 */
+#define STM32F4_AF9 0x09U /*!< Alternate function 9 */
+
+/* Probe pin */
+#define STM32F4_PROBE_PIN_GPIO GPIOA /*!< GPIO port of the probe pin (LD2 of the Nucleo board) */
+#define STM32F4_PROBE_PIN 5          /*!< GPIO pin of the probe pin (LD2 of the Nucleo board) */
+
+/* EXTI */
+#define STM32F4_SYSTEM_EXTI_NUM_LINES 16 /*!< Number of EXTI lines connected to the GPIOs */
+#define STM32F4_EXTI_LINES_0 0x0001U     /*!< Mask of the EXTI lines of the EXTI0 interrupt */
+#define STM32F4_EXTI_LINES_1 0x0002U     /*!< Mask of the EXTI lines of the EXTI1 interrupt */
+#define STM32F4_EXTI_LINES_2 0x0004U     /*!< Mask of the EXTI lines of the EXTI2 interrupt */
+#define STM32F4_EXTI_LINES_3 0x0008U     /*!< Mask of the EXTI lines of the EXTI3 interrupt */
+#define STM32F4_EXTI_LINES_4 0x0010U     /*!< Mask of the EXTI lines of the EXTI4 interrupt */
+#define STM32F4_EXTI_LINES_9_5 0x03E0U   /*!< Mask of the EXTI lines of the EXTI9_5 interrupt */
+#define STM32F4_EXTI_LINES_15_10 0xFC00U /*!< Mask of the EXTI lines of the EXTI15_10 interrupt */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Handler of an EXTI line. It is called from the ISR once the pending bit of the line has been cleared.
+ *
+ * @param line EXTI line (index from 0 to 15)
+ * @param p_ctx Context registered with the handler
+ */
+typedef void (*stm32f4_system_exti_handler_t)(uint8_t line, void *p_ctx);
 
 /** @verbatim
       ==============================================================================
@@ -165,6 +191,28 @@ void stm32f4_system_gpio_exti_enable(uint8_t pin, uint8_t priority, uint8_t subp
  */
 void stm32f4_system_gpio_exti_disable(uint8_t pin);
 
+/**
+ * @brief Register the handler of an EXTI line. It replaces the previous handler of the line, if any. The interrupts are masked while the entry changes, so it can be called while the line is enabled.
+ *
+ * @param line EXTI line (index from 0 to 15)
+ * @param p_handler Handler of the line, or NULL to remove it
+ * @param p_ctx Context passed to the handler
+ *
+ */
+void stm32f4_system_exti_register(uint8_t line, stm32f4_system_exti_handler_t p_handler, void *p_ctx);
+
+/**
+ * @brief Dispatch the pending EXTI lines of an interrupt to their handlers. To be called from the EXTI ISRs.
+ *
+ * > 1. Read `EXTI->PR` once and keep the lines of the interrupt \n
+ * > 2. Clear all of them at once \n
+ * > 3. Call the handler of each pending line, from the lowest line to the highest
+ *
+ * @param lines_mask Mask of the EXTI lines of the interrupt (`STM32F4_EXTI_LINES_x`)
+ *
+ */
+void stm32f4_system_exti_dispatch(uint32_t lines_mask);
+
 
 /**
  * @brief Read the value of a GPIO pin
@@ -0,0 +1,39 @@
+/**
+ * @file stm32f4_telemetry.h
+ * @brief Header for stm32f4_telemetry.c file.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef STM32F4_TELEMETRY_H_
+#define STM32F4_TELEMETRY_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define STM32F4_TELEMETRY_TX_GPIO GPIOA /*!< GPIO port of the TX line of the telemetry UART (USART2_TX, routed to the ST-LINK virtual COM port of the Nucleo board).*/
+
+#define STM32F4_TELEMETRY_TX_PIN 2 /*!< GPIO pin of the TX line of the telemetry UART.*/
+
+#define STM32F4_TELEMETRY_RX_GPIO GPIOA /*!< GPIO port of the RX line of the telemetry UART (USART2_RX).*/
+
+#define STM32F4_TELEMETRY_RX_PIN 3 /*!< GPIO pin of the RX line of the telemetry UART.*/
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Configures the pins, the clock and the baud rate of the UART shared by the telemetry and the shell, and enables it with its transmitter and receiver off. It does nothing if the UART is already enabled.
+ */
+void stm32f4_telemetry_uart_init(void);
+
+/**
+ * @brief Clears the flags of the DMA stream of the telemetry UART once a chunk has been transferred. It must be called from the ISR of the DMA stream.
+ */
+void stm32f4_telemetry_transfer_complete(void);
+
+#endif /* STM32F4_TELEMETRY_H_ */
@@ -0,0 +1,39 @@
+/**
+ * @file stm32f4_temperature.h
+ * @brief Header for stm32f4_temperature.c file.
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef STM32F4_TEMPERATURE_H_
+#define STM32F4_TEMPERATURE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define STM32F4_TEMPERATURE_ADC ADC1 /*!< ADC that reads the temperature.*/
+
+#ifdef USE_EXTERNAL_TEMPERATURE
+#define STM32F4_TEMPERATURE_GPIO GPIOA /*!< GPIO port of the output of the external sensor (TMP36).*/
+#define STM32F4_TEMPERATURE_PIN 4 /*!< GPIO pin of the output of the external sensor (ADC1_IN4, A2 of the Nucleo board).*/
+#define STM32F4_TEMPERATURE_ADC_CHANNEL 4U /*!< ADC channel of the external sensor.*/
+#define STM32F4_TEMPERATURE_EXTERNAL_OFFSET_MV 500 /*!< Output of the external sensor at 0 ºC, in mV (TMP36).*/
+#else
+#define STM32F4_TEMPERATURE_ADC_CHANNEL 18U /*!< ADC channel of the internal temperature sensor.*/
+#endif
+
+#define STM32F4_TEMPERATURE_TS_CAL1 ((const volatile uint16_t *)0x1FFF7A2CU) /*!< Factory reading of the internal sensor at 30 ºC and VDDA = 3.3 V.*/
+#define STM32F4_TEMPERATURE_TS_CAL2 ((const volatile uint16_t *)0x1FFF7A2EU) /*!< Factory reading of the internal sensor at 110 ºC and VDDA = 3.3 V.*/
+#define STM32F4_TEMPERATURE_TS_CAL1_DC 300 /*!< Temperature of `STM32F4_TEMPERATURE_TS_CAL1`, in tenths of ºC.*/
+#define STM32F4_TEMPERATURE_TS_CAL2_DC 1100 /*!< Temperature of `STM32F4_TEMPERATURE_TS_CAL2`, in tenths of ºC.*/
+
+#define STM32F4_TEMPERATURE_VDDA_MV 3300 /*!< Reference voltage of the ADC, in mV.*/
+#define STM32F4_TEMPERATURE_ADC_MAX 4095 /*!< Reading of the ADC at the reference voltage (12 bits).*/
+
+#endif /* STM32F4_TEMPERATURE_H_ */
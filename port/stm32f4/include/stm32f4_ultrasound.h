@@ -43,5 +43,20 @@ void stm32f4_ultrasound_set_new_trigger_gpio(uint32_t ultrasound_id, GPIO_TypeDe
  */
 void stm32f4_ultrasound_set_new_echo_gpio(uint32_t ultrasound_id, GPIO_TypeDef *p_port, uint8_t pin);
 
+/**
+ * @brief Captures an edge of the echo signal of an ultrasound transceiver. It is called by the ISR of the echo timer on each input capture: the first edge of a ping starts the time of flight, and each falling edge after it is an echo. The ping ends at the first echo, or when the number of echoes set with `port_ultrasound_set_max_echoes()` have arrived, or at the first echo after the end of the window.
+ *
+ * @param ultrasound_id ID of the ultrasound sensor.
+ * @param tick Value of the counter of the echo timer captured at the edge.
+ */
+void stm32f4_ultrasound_capture_echo_edge(uint32_t ultrasound_id, uint32_t tick);
+
+/**
+ * @brief Closes the window of the echoes of the current ping of an ultrasound transceiver. It is called by the ISR of the echo timer on the compare of channel 3, which is only enabled when more than one echo is listened to. The ping ends if an echo has arrived.
+ *
+ * @param ultrasound_id ID of the ultrasound sensor.
+ */
+void stm32f4_ultrasound_close_echo_window(uint32_t ultrasound_id);
+
 
 #endif /* STM32F4_ULTRASOUND_H_ */
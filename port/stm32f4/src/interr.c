@@ -9,6 +9,11 @@
 #include "stm32f4_system.h"
 #include <port_button.h>
 #include <port_ultrasound.h>
+#include "stm32f4_display.h"
+#include "stm32f4_button.h"
+#include "stm32f4_ultrasound.h"
+#include "stm32f4_telemetry.h"
+#include "stm32f4_shell.h"
 
 // Include headers of different port elements:
 
@@ -35,22 +40,78 @@ void SysTick_Handler(void)
 }
 
 /**
- * @brief Handler of the button interruption
+ * @brief Handler of the EXTI line 0 interruption. The lines are dispatched to the handlers registered with `stm32f4_system_exti_register()`.
+ * 
+ */
+void EXTI0_IRQHandler(void)
+{
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_0);
+}
+
+/**
+ * @brief Handler of the EXTI line 1 interruption.
+ * 
+ */
+void EXTI1_IRQHandler(void)
+{
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_1);
+}
+
+/**
+ * @brief Handler of the EXTI line 2 interruption.
+ * 
+ */
+void EXTI2_IRQHandler(void)
+{
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_2);
+}
+
+/**
+ * @brief Handler of the EXTI line 3 interruption.
+ * 
+ */
+void EXTI3_IRQHandler(void)
+{
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_3);
+}
+
+/**
+ * @brief Handler of the EXTI line 4 interruption.
+ * 
+ */
+void EXTI4_IRQHandler(void)
+{
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_4);
+}
+
+/**
+ * @brief Handler of the EXTI lines 5 to 9 interruption.
+ * 
+ */
+void EXTI9_5_IRQHandler(void)
+{
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_9_5);
+}
+
+/**
+ * @brief Handler of the EXTI lines 10 to 15 interruption (parking button).
  * 
  */
 void EXTI15_10_IRQHandler (void)
 {
-    port_system_systick_resume();
-    /* ISR parking button */
-    if (port_button_get_pending_interrupt (PORT_PARKING_BUTTON_ID))
-    {
-        if(port_button_get_value (PORT_PARKING_BUTTON_ID)){
-            port_button_set_pressed (PORT_PARKING_BUTTON_ID, false);
-        }else{
-            port_button_set_pressed (PORT_PARKING_BUTTON_ID, true);
-        }
-        port_button_clear_pending_interrupt (PORT_PARKING_BUTTON_ID);
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_15_10);
+}
 
+/**
+ * @brief Handler of the debounce timer of the buttons. The debounced level of the buttons is sampled.
+ * 
+ */
+void TIM1_UP_TIM10_IRQHandler(void)
+{
+    if (TIM10->SR & TIM_SR_UIF) {
+        TIM10->SR &= ~TIM_SR_UIF;
+        port_system_systick_resume();
+        stm32f4_button_debounce_timer_expired(TIM10);
     }
 }
 
@@ -83,18 +144,16 @@ void TIM2_IRQHandler(void){
     // If it is a CC2IF interrupt
     if (TIM2->SR & TIM_SR_CC2IF) {
         current_tick = TIM2->CCR2;
-        uint32_t echo_init_tick = port_ultrasound_get_echo_init_tick(ultrasound_id);
-        uint32_t echo_end_tick = port_ultrasound_get_echo_end_tick(ultrasound_id);
-        // If the echo signal has not been received yet
-        if (echo_init_tick == 0 && echo_end_tick == 0) {
-            port_ultrasound_set_echo_init_tick(ultrasound_id, current_tick);
-        } else {
-            port_ultrasound_set_echo_end_tick(ultrasound_id, current_tick);
-            port_ultrasound_set_echo_received(ultrasound_id, true);
-        }
+        // The start of the echo signal, or one of its echoes
+        stm32f4_ultrasound_capture_echo_edge(ultrasound_id, current_tick);
         // Clear the interrupt flag CC2IF in the status register SR
         TIM2->SR &= ~TIM_SR_CC2IF;
     }
+    // If it is a CC3IF interrupt: the window of the echoes is over
+    if ((TIM2->DIER & TIM_DIER_CC3IE) && (TIM2->SR & TIM_SR_CC3IF)) {
+        TIM2->SR &= ~TIM_SR_CC3IF;
+        stm32f4_ultrasound_close_echo_window(ultrasound_id);
+    }
 }
 
 /**
@@ -108,3 +167,40 @@ void TIM5_IRQHandler(void)
     // Call the function to set the flag that indicates that a new measurement can be started
     port_ultrasound_set_trigger_ready(PORT_REAR_PARKING_SENSOR_ID, true);
 }
+
+/**
+ * @brief Handler of the DMA stream of the rear LED bar display. The frame has been sent.
+ * 
+ */
+void DMA2_Stream1_IRQHandler(void)
+{
+    if (DMA2->LISR & DMA_LISR_TCIF1) {
+        // Clear the transfer complete flag
+        DMA2->LIFCR = DMA_LIFCR_CTCIF1;
+        stm32f4_display_bar_transfer_complete(STM32F4_REAR_PARKING_BAR_ID);
+    }
+}
+
+/**
+ * @brief Handler of the DMA stream of the telemetry UART. A chunk of the stream has been sent, and the main loop can send the next one.
+ * 
+ */
+void DMA1_Stream6_IRQHandler(void)
+{
+    if (DMA1->HISR & DMA_HISR_TCIF6) {
+        stm32f4_telemetry_transfer_complete();
+    }
+}
+
+/**
+ * @brief Handler of the telemetry UART. A byte of a command line of the shell has been received.
+ * 
+ */
+void USART2_IRQHandler(void)
+{
+    // Reading the data register clears both the receive and the overrun flags
+    if (USART2->SR & (USART_SR_RXNE | USART_SR_ORE)) {
+        port_system_systick_resume();
+        stm32f4_shell_receive((uint8_t)USART2->DR);
+    }
+}
@@ -18,6 +18,9 @@
 #include "stm32f4_system.h"
 #include "stm32f4_button.h"
 
+/* Defines --------------------------------------------------------------------*/
+#define TIMER_MAX_ARR 0xFFFF /*!<Maximum value for the timer auto-reload register.*/
+#define TIMER_MAX_PSC 0xFFFF /*!<Maximum value for the timer prescaler register.*/
 
 /* Typedefs --------------------------------------------------------------------*/
 
@@ -31,6 +34,11 @@ typedef struct
     uint8_t pin; /*!< Pin number */
     uint8_t pupd_mode; /*!< Pull-up/pull-down mode */
     bool flag_pressed; /*!< Flag to indicate if the button is pressed */
+    TIM_TypeDef *p_debounce_timer; /*!< One-shot timer of the hardware debounce */
+    uint32_t debounce_ms; /*!< Hardware debounce time in milliseconds (0 if disabled) */
+    volatile bool debouncing; /*!< Flag to indicate that the debounce timer is running for this button */
+    uint32_t edge_time_us; /*!< Time of the edge of the last change of the pressed flag, in microseconds */
+    uint32_t debounce_edge_us; /*!< Time of the first edge of the debounce in progress, in microseconds */
 } stm32f4_button_hw_t;
 
 /* Global variables ------------------------------------------------------------*/
@@ -40,7 +48,7 @@ typedef struct
  */
 
 static stm32f4_button_hw_t buttons_arr [] = {
-    [PORT_PARKING_BUTTON_ID] = {.p_port = STM32F4_PARKING_BUTTON_GPIO, .pin = STM32F4_PARKING_BUTTON_PIN, .pupd_mode = STM32F4_GPIO_PUPDR_NOPULL},
+    [PORT_PARKING_BUTTON_ID] = {.p_port = STM32F4_PARKING_BUTTON_GPIO, .pin = STM32F4_PARKING_BUTTON_PIN, .pupd_mode = STM32F4_GPIO_PUPDR_NOPULL, .p_debounce_timer = STM32F4_PARKING_BUTTON_DEBOUNCE_TIMER, .debounce_ms = 0},
 };
 
 /* Private functions ----------------------------------------------------------*/
@@ -67,6 +75,85 @@ stm32f4_button_hw_t *_stm32f4_button_get(uint32_t button_id)
     }
 }
 
+/**
+ * @brief Returns the number of ticks of the debounce timers per millisecond. The counter runs at `STM32F4_BUTTON_DEBOUNCE_TICK_HZ` while its prescaler fits in 16 bits, and at a multiple of it with a faster system clock.
+ *
+ * @return uint32_t Ticks per millisecond (at least 1).
+ */
+
+static uint32_t _debounce_ticks_per_ms(void)
+{
+    uint32_t ticks = (SystemCoreClock / STM32F4_BUTTON_DEBOUNCE_TICK_HZ + TIMER_MAX_PSC) / (TIMER_MAX_PSC + 1);
+    return (ticks == 0) ? 1 : ticks;
+}
+
+/**
+ * @brief Configures the debounce timer of a button as a one-shot timer with a time base of 1 ms or a fraction of it that interrupts on expiry.
+ *
+ * @param p_button Pointer to the hardware configuration of the button.
+ */
+
+static void _timer_debounce_setup(stm32f4_button_hw_t *p_button)
+{
+    TIM_TypeDef *p_timer = p_button->p_debounce_timer;
+    IRQn_Type irqn = TIM1_UP_TIM10_IRQn;
+
+    if (p_timer == TIM10)
+    {
+        RCC->APB2ENR |= RCC_APB2ENR_TIM10EN;
+        irqn = TIM1_UP_TIM10_IRQn;
+    }
+    else if (p_timer == TIM11)
+    {
+        RCC->APB2ENR |= RCC_APB2ENR_TIM11EN;
+        irqn = TIM1_TRG_COM_TIM11_IRQn;
+    }
+
+    p_timer->CR1 &= ~TIM_CR1_CEN;
+    // One pulse mode: the counter stops at the update event. The UG bit does not raise the interrupt
+    p_timer->CR1 |= TIM_CR1_OPM | TIM_CR1_URS;
+    p_timer->CNT = 0;
+
+    uint32_t ticks_per_ms = _debounce_ticks_per_ms();
+    p_timer->PSC = (SystemCoreClock / (STM32F4_BUTTON_DEBOUNCE_TICK_HZ * ticks_per_ms)) - 1;
+    p_timer->ARR = p_button->debounce_ms * ticks_per_ms - 1;
+    p_timer->EGR |= TIM_EGR_UG;
+
+    p_timer->SR &= ~TIM_SR_UIF;
+    p_timer->DIER |= TIM_DIER_UIE;
+
+    // Same priority as the EXTI line of the button, so that the two ISRs do not preempt each other
+    NVIC_SetPriority(irqn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 1, 0));
+    NVIC_EnableIRQ(irqn);
+}
+
+/**
+ * @brief Handler of the EXTI line of a button. With the hardware debounce enabled, the first edge only starts the debounce timer and the system keeps sleeping until it expires.
+ *
+ * @param line EXTI line of the button.
+ * @param p_ctx Pointer to the hardware configuration of the button.
+ */
+
+static void _stm32f4_button_exti_handler(uint8_t line, void *p_ctx)
+{
+    stm32f4_button_hw_t *p_button = (stm32f4_button_hw_t *)p_ctx;
+    uint32_t button_id = (uint32_t)(p_button - buttons_arr);
+    // The edge may wake the system up: the SysTick is resumed before the time is taken
+    port_system_systick_resume();
+    uint32_t now_us = port_system_get_micros();
+
+    if (!stm32f4_button_debounce_start(button_id))
+    {
+        // The time is stored first, so that it is valid as soon as the flag changes
+        p_button->edge_time_us = now_us;
+        p_button->flag_pressed = !stm32f4_system_gpio_read(p_button->p_port, p_button->pin);
+    }
+    else
+    {
+        p_button->debounce_edge_us = now_us;
+    }
+}
+
 /* Public functions -----------------------------------------------------------*/
 
 
@@ -79,6 +166,7 @@ void port_button_init(uint32_t button_id)
 
     /* TO-DO alumnos */
     stm32f4_system_gpio_config(p_button->p_port, p_button->pin, STM32F4_GPIO_MODE_IN, STM32F4_GPIO_PUPDR_NOPULL);
+    stm32f4_system_exti_register(p_button->pin, _stm32f4_button_exti_handler, p_button);
     stm32f4_system_gpio_config_exti(p_button->p_port, p_button->pin, STM32F4_TRIGGER_BOTH_EDGE | STM32F4_TRIGGER_ENABLE_INTERR_REQ);
     stm32f4_system_gpio_exti_enable(p_button->pin, 1, 0);
 }
@@ -109,11 +197,19 @@ bool port_button_get_value	(uint32_t button_id){
 
 void port_button_set_pressed(uint32_t button_id, bool pressed){
     stm32f4_button_hw_t *p_button = _stm32f4_button_get(button_id);
+    p_button->edge_time_us = port_system_get_micros();
     p_button->flag_pressed = pressed;
 }
 
 
 
+uint32_t port_button_get_edge_time_us(uint32_t button_id){
+    stm32f4_button_hw_t *p_button = _stm32f4_button_get(button_id);
+    return p_button->edge_time_us;
+}
+
+
+
 bool port_button_get_pending_interrupt(uint32_t button_id){
     stm32f4_button_hw_t *p_button = _stm32f4_button_get(button_id);
     return (EXTI->PR & BIT_POS_TO_MASK(p_button->pin)) != 0;
@@ -130,4 +226,70 @@ void port_button_clear_pending_interrupt(uint32_t button_id){
 void port_button_disable_interrupts(uint32_t button_id){
     stm32f4_button_hw_t *p_button = _stm32f4_button_get(button_id);
     stm32f4_system_gpio_exti_disable(p_button->pin);
-}
\ No newline at end of file
+}
+
+void port_button_set_debounce(uint32_t button_id, uint32_t debounce_ms)
+{
+    stm32f4_button_hw_t *p_button = _stm32f4_button_get(button_id);
+    if (debounce_ms > (TIMER_MAX_ARR + 1) / _debounce_ticks_per_ms())
+    {
+        debounce_ms = (TIMER_MAX_ARR + 1) / _debounce_ticks_per_ms();
+    }
+    p_button->debounce_ms = debounce_ms;
+
+    if (debounce_ms == 0)
+    {
+        // Abort any debounce in progress and let every edge through again
+        p_button->p_debounce_timer->CR1 &= ~TIM_CR1_CEN;
+        p_button->debouncing = false;
+        p_button->p_debounce_timer->DIER &= ~TIM_DIER_UIE;
+        EXTI->IMR |= BIT_POS_TO_MASK(p_button->pin);
+        return;
+    }
+    _timer_debounce_setup(p_button);
+}
+
+
+bool stm32f4_button_debounce_start(uint32_t button_id)
+{
+    stm32f4_button_hw_t *p_button = _stm32f4_button_get(button_id);
+    if (p_button->debounce_ms == 0)
+    {
+        return false;
+    }
+    // Ignore the bounces until the timer expires
+    EXTI->IMR &= ~BIT_POS_TO_MASK(p_button->pin);
+    p_button->debouncing = true;
+    p_button->p_debounce_timer->CNT = 0;
+    p_button->p_debounce_timer->CR1 |= TIM_CR1_CEN;
+    return true;
+}
+
+
+void stm32f4_button_debounce_timeout(uint32_t button_id)
+{
+    stm32f4_button_hw_t *p_button = _stm32f4_button_get(button_id);
+    p_button->debouncing = false;
+    // Discard the edges of the bounces and unmask the line before sampling, so that an edge after the sample is not lost
+    EXTI->PR = BIT_POS_TO_MASK(p_button->pin);
+    EXTI->IMR |= BIT_POS_TO_MASK(p_button->pin);
+    bool pressed = !stm32f4_system_gpio_read(p_button->p_port, p_button->pin);
+    // The change happened at the first edge of the bounces, not now
+    if (pressed != p_button->flag_pressed)
+    {
+        p_button->edge_time_us = p_button->debounce_edge_us;
+    }
+    p_button->flag_pressed = pressed;
+}
+
+
+void stm32f4_button_debounce_timer_expired(TIM_TypeDef *p_timer)
+{
+    for (uint32_t button_id = 0; button_id < sizeof(buttons_arr) / sizeof(buttons_arr[0]); button_id++)
+    {
+        if ((buttons_arr[button_id].p_debounce_timer == p_timer) && buttons_arr[button_id].debouncing)
+        {
+            stm32f4_button_debounce_timeout(button_id);
+        }
+    }
+}
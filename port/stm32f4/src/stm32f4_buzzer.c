@@ -0,0 +1,249 @@
+/**
+ * @file stm32f4_buzzer.c
+ * @brief Portable functions to interact with the buzzer FSM library. All portable functions must be implemented in this file.
+ *
+ * The tone is a 50 % PWM generated by a timer working in gated slave mode. A second timer generates the cadence in PWM mode and its output compare (OC1REF) is internally routed as the trigger (gate) of the tone timer. The tone is therefore only produced while the cadence output is high, and neither the tone nor the cadence require any interrupt.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+
+/* Standard C includes */
+#include <stdio.h>
+#include <math.h>
+/* HW dependent includes */
+#include "port_buzzer.h"
+#include "port_system.h"
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_buzzer.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define TIMER_MAX_ARR 0xFFFF /*!<Maximum value for the timer auto-reload register.*/
+#define TIMER_MAX_PSC 0xFFFF /*!<Maximum value for the timer prescaler register.*/
+#define STM32F4_TIM_SMCR_SMS_GATED 0x05U /*!< Slave mode selection: gated mode.*/
+#define STM32F4_TIM_SMCR_TS_ITR3 0x03U /*!< Trigger selection: internal trigger 3 (TIM14_OC for TIM12).*/
+#define STM32F4_TIM_OCM_PWM1 0x06U /*!< Output compare mode: PWM mode 1.*/
+
+/* Typedefs --------------------------------------------------------------------*/
+
+/**
+ * @brief Structure representing the hardware configuration of a buzzer.
+ */
+
+typedef struct {
+    GPIO_TypeDef *p_port; /*!< GPIO port of the buzzer.*/
+    uint8_t pin; /*!< GPIO pin of the buzzer.*/
+    uint8_t alt_func; /*!< Alternate function of the pin (tone timer channel 1).*/
+    TIM_TypeDef *p_tone_timer; /*!< Timer that generates the tone on its channel 1.*/
+    TIM_TypeDef *p_cadence_timer; /*!< Timer whose OC1REF gates the tone timer.*/
+    uint8_t cadence_trigger; /*!< Internal trigger (ITRx) of the tone timer connected to the cadence timer.*/
+} stm32f4_buzzer_hw_t;
+
+/* Global variables */
+
+/**
+ * @brief Array of hardware configurations for the buzzers.
+ */
+
+static stm32f4_buzzer_hw_t buzzers_arr[] = {
+    [PORT_REAR_PARKING_BUZZER_ID] = {
+        .p_port = STM32F4_REAR_PARKING_BUZZER_GPIO,
+        .pin = STM32F4_REAR_PARKING_BUZZER_PIN,
+        .alt_func = STM32F4_AF9,
+        .p_tone_timer = TIM12,
+        .p_cadence_timer = TIM14,
+        .cadence_trigger = STM32F4_TIM_SMCR_TS_ITR3
+    }
+};
+
+/* Private functions -----------------------------------------------------------*/
+
+/**
+ * @brief Retrieves the hardware configuration for a specific buzzer ID.
+ *
+ * @param buzzer_id The ID of the buzzer to retrieve.
+ *
+ * @return Pointer to the hardware configuration structure, or NULL if the ID is invalid.
+ */
+
+static stm32f4_buzzer_hw_t *_stm32f4_buzzer_get(uint32_t buzzer_id)
+{
+    if (buzzer_id < sizeof(buzzers_arr) / sizeof(buzzers_arr[0]))
+    {
+        return &buzzers_arr[buzzer_id];
+    }
+    else
+    {
+        return NULL;
+    }
+}
+
+/**
+ * @brief Returns the number of ticks of the cadence timer per millisecond. The counter runs at `STM32F4_BUZZER_CADENCE_TICK_HZ` while its prescaler fits in 16 bits, and at a multiple of it with a faster system clock.
+ *
+ * @return uint32_t Ticks per millisecond (at least 1).
+ */
+
+static uint32_t _cadence_ticks_per_ms(void)
+{
+    uint32_t ticks = (SystemCoreClock / STM32F4_BUZZER_CADENCE_TICK_HZ + TIMER_MAX_PSC) / (TIMER_MAX_PSC + 1);
+    return (ticks == 0) ? 1 : ticks;
+}
+
+/**
+ * @brief Enables the peripheral clock of one of the timers that can be used by the buzzers.
+ *
+ * @param p_timer Timer whose clock is enabled.
+ */
+
+static void _timer_clock_enable(TIM_TypeDef *p_timer)
+{
+    if (p_timer == TIM12)
+    {
+        RCC->APB1ENR |= RCC_APB1ENR_TIM12EN;
+    }
+    else if (p_timer == TIM13)
+    {
+        RCC->APB1ENR |= RCC_APB1ENR_TIM13EN;
+    }
+    else if (p_timer == TIM14)
+    {
+        RCC->APB1ENR |= RCC_APB1ENR_TIM14EN;
+    }
+}
+
+/**
+ * @brief Configures the tone timer: PWM mode 1 at 50 % duty cycle on channel 1, gated by the cadence timer.
+ *
+ * @param p_buzzer Pointer to the hardware configuration of the buzzer.
+ */
+
+static void _timer_tone_setup(stm32f4_buzzer_hw_t *p_buzzer)
+{
+    TIM_TypeDef *p_timer = p_buzzer->p_tone_timer;
+    _timer_clock_enable(p_timer);
+
+    p_timer->CR1 &= ~TIM_CR1_CEN;
+    p_timer->CR1 |= TIM_CR1_ARPE;
+    p_timer->CNT = 0;
+
+    double system_core_clock = (double)SystemCoreClock;
+    double max_arr = TIMER_MAX_ARR;
+    double tone_period = (double)1/PORT_BUZZER_TONE_HZ;
+    double psc = round(system_core_clock*tone_period/(max_arr+1.0)-1.0);
+    double arr = round(system_core_clock*tone_period/(psc+1.0)-1.0);
+    if (arr > max_arr)
+    {
+        psc += 1.0;
+        arr = round(system_core_clock*tone_period/(psc+1.0)-1.0);
+    }
+    p_timer->PSC = (uint32_t)psc;
+    p_timer->ARR = (uint32_t)arr;
+    p_timer->CCR1 = ((uint32_t)arr + 1) / 2;
+
+    p_timer->CCER &= ~(TIM_CCER_CC1E | TIM_CCER_CC1P | TIM_CCER_CC1NP);
+    p_timer->CCMR1 &= ~(TIM_CCMR1_CC1S | TIM_CCMR1_OC1M);
+    p_timer->CCMR1 |= (STM32F4_TIM_OCM_PWM1 << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE;
+
+    // The counter only runs while the cadence output is high
+    p_timer->SMCR &= ~(TIM_SMCR_TS | TIM_SMCR_SMS);
+    p_timer->SMCR |= (p_buzzer->cadence_trigger << TIM_SMCR_TS_Pos) | (STM32F4_TIM_SMCR_SMS_GATED << TIM_SMCR_SMS_Pos);
+
+    p_timer->EGR |= TIM_EGR_UG;
+}
+
+/**
+ * @brief Configures the cadence timer: a time base of 1 ms or a fraction of it, whose OC1REF is used as gate of the tone timer.
+ *
+ * @param p_buzzer Pointer to the hardware configuration of the buzzer.
+ */
+
+static void _timer_cadence_setup(stm32f4_buzzer_hw_t *p_buzzer)
+{
+    TIM_TypeDef *p_timer = p_buzzer->p_cadence_timer;
+    _timer_clock_enable(p_timer);
+
+    p_timer->CR1 &= ~TIM_CR1_CEN;
+    p_timer->CR1 |= TIM_CR1_ARPE;
+    p_timer->CNT = 0;
+
+    p_timer->PSC = (SystemCoreClock / (STM32F4_BUZZER_CADENCE_TICK_HZ * _cadence_ticks_per_ms())) - 1;
+    p_timer->ARR = 0;
+    p_timer->CCR1 = 0;
+
+    // OC1REF is only used internally as trigger of the tone timer, so the pin is not configured
+    p_timer->CCER &= ~(TIM_CCER_CC1P | TIM_CCER_CC1NP);
+    p_timer->CCMR1 &= ~(TIM_CCMR1_CC1S | TIM_CCMR1_OC1M);
+    p_timer->CCMR1 |= (STM32F4_TIM_OCM_PWM1 << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE;
+    p_timer->CCER |= TIM_CCER_CC1E;
+
+    p_timer->EGR |= TIM_EGR_UG;
+}
+
+/* Public functions -----------------------------------------------------------*/
+
+void port_buzzer_init(uint32_t buzzer_id)
+{
+    stm32f4_buzzer_hw_t *p_buzzer = _stm32f4_buzzer_get(buzzer_id);
+    if (p_buzzer == NULL)
+    {
+        return;
+    }
+
+    stm32f4_system_gpio_config(p_buzzer->p_port, p_buzzer->pin, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
+    stm32f4_system_gpio_config_alternate(p_buzzer->p_port, p_buzzer->pin, p_buzzer->alt_func);
+
+    _timer_tone_setup(p_buzzer);
+    _timer_cadence_setup(p_buzzer);
+
+    port_buzzer_stop(buzzer_id);
+}
+
+void port_buzzer_set_cadence(uint32_t buzzer_id, uint32_t period_ms, uint32_t on_ms)
+{
+    stm32f4_buzzer_hw_t *p_buzzer = _stm32f4_buzzer_get(buzzer_id);
+    if (p_buzzer == NULL)
+    {
+        return;
+    }
+
+    if ((on_ms == 0) || (period_ms == 0))
+    {
+        port_buzzer_stop(buzzer_id);
+        return;
+    }
+    uint32_t ticks_per_ms = _cadence_ticks_per_ms();
+    if (period_ms > (TIMER_MAX_ARR + 1) / ticks_per_ms)
+    {
+        period_ms = (TIMER_MAX_ARR + 1) / ticks_per_ms;
+    }
+
+    TIM_TypeDef *p_cadence = p_buzzer->p_cadence_timer;
+    TIM_TypeDef *p_tone = p_buzzer->p_tone_timer;
+
+    p_cadence->CR1 &= ~TIM_CR1_CEN;
+    p_cadence->ARR = period_ms * ticks_per_ms - 1;
+    // In PWM mode 1 OC1REF is always high if CCR1 > ARR: continuous tone
+    p_cadence->CCR1 = ((on_ms >= period_ms) ? period_ms : on_ms) * ticks_per_ms;
+    p_cadence->CNT = 0;
+    p_cadence->EGR |= TIM_EGR_UG;
+
+    p_tone->CCER |= TIM_CCER_CC1E;
+    p_tone->CR1 |= TIM_CR1_CEN;
+    p_cadence->CR1 |= TIM_CR1_CEN;
+}
+
+void port_buzzer_stop(uint32_t buzzer_id)
+{
+    stm32f4_buzzer_hw_t *p_buzzer = _stm32f4_buzzer_get(buzzer_id);
+    if (p_buzzer == NULL)
+    {
+        return;
+    }
+
+    p_buzzer->p_cadence_timer->CR1 &= ~TIM_CR1_CEN;
+    p_buzzer->p_tone_timer->CR1 &= ~TIM_CR1_CEN;
+    p_buzzer->p_tone_timer->CCER &= ~TIM_CCER_CC1E;
+}
@@ -1,6 +1,9 @@
 /**
  * @file stm32f4_display.c
  * @brief Portable functions to interact with the display system FSM library. All portable functions must be implemented in this file.
+ *
+ * Each display is described in `displays_arr` by its backend and its hardware. A single RGB LED display has one PWM channel per color component (GPIO, alternate function, timer and channel); a LED bar display is driven by the WS2812 backend of `stm32f4_display_bar.c`. Several RGB displays can share a timer as long as they use different channels: all the timers run the same PWM period, so the time base of a timer is only configured while none of its channels is lit.
+ *
  * @author Marcos Perez
  * @author Jorge Lopez-Galvez
  * @date 01/04/2025
@@ -18,44 +21,108 @@
 /* Defines --------------------------------------------------------------------*/
 #define TIMER_MAX_ARR 0xFFFF /*!<Maximum value for the timer auto-reload register.*/
 #define frec_PWD 50 /*!< Frequency of the PWM signal.*/
+#define STM32F4_DISPLAY_NUM_COMPONENTS 3 /*!< Number of color components (red, green and blue) of a display.*/
+#define STM32F4_TIM_OCM_PWM1 0x06U /*!< Output compare mode: PWM mode 1.*/
+#define STM32F4_TIM_CCER_CHANNEL_BITS 4 /*!< Number of bits of each channel in the CCER register.*/
+#define STM32F4_TIM_CCMR_CHANNEL_BITS 8 /*!< Number of bits of each channel in the CCMRx registers.*/
+#define STM32F4_TIM_CCER_ALL_CCE (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E) /*!< Enable bits of all the channels of a timer.*/
 /* Typedefs --------------------------------------------------------------------*/
 
 /**
- * @brief Structure representing the hardware configuration for an RGB display.
+ * @brief Structure representing the hardware configuration of one color component of an RGB display.
  */
 
 typedef struct {
-    GPIO_TypeDef *p_port_red; /*!< GPIO port for the red component.*/
-    uint8_t pin_red; /*!< GPIO pin for the red component.*/
-    GPIO_TypeDef *p_port_green; /*!< GPIO port for the green component.*/
-    uint8_t pin_green; /*!< GPIO pin for the green component.*/
-    GPIO_TypeDef * p_port_blue; /*!< GPIO port for the blue component.*/
-    uint8_t 	pin_blue; /*!< GPIO pin for the blue component.*/
-} stm32f4_display_hw_t;
+    GPIO_TypeDef *p_port; /*!< GPIO port of the component.*/
+    uint8_t pin; /*!< GPIO pin of the component.*/
+    uint8_t alt_func; /*!< Alternate function that connects the pin to the timer channel.*/
+    TIM_TypeDef *p_timer; /*!< Timer that generates the PWM signal.*/
+    uint8_t channel; /*!< Channel of the timer (1 to 4).*/
+    volatile uint32_t *p_ccr; /*!< Capture/compare register of the channel. Computed in `port_display_init()`.*/
+    uint32_t ccer_en; /*!< Enable bit of the channel in the CCER register. Computed in `port_display_init()`.*/
+} stm32f4_display_channel_hw_t;
+
+typedef struct stm32f4_display_hw_t stm32f4_display_hw_t;
+
+/**
+ * @brief Structure representing the functions that drive a kind of display.
+ */
+
+typedef struct {
+    void (*p_init)(stm32f4_display_hw_t *p_display); /*!< Configures the hardware of the display.*/
+    void (*p_set)(stm32f4_display_hw_t *p_display, rgb_color_t color, uint8_t level); /*!< Sets the color and the fill level of the display.*/
+} stm32f4_display_backend_t;
+
+/**
+ * @brief Structure representing the hardware configuration for a display.
+ */
+
+struct stm32f4_display_hw_t {
+    const stm32f4_display_backend_t *p_backend; /*!< Functions that drive the display.*/
+    stm32f4_display_channel_hw_t rgb[STM32F4_DISPLAY_NUM_COMPONENTS]; /*!< Red, green and blue components, in this order (single RGB LED displays).*/
+    uint32_t bar_id; /*!< Index of the LED bar in `stm32f4_display_bar.c` (LED bar displays).*/
+};
+
+/* Private functions prototypes ------------------------------------------------*/
+static void _display_pwm_init(stm32f4_display_hw_t *p_display);
+static void _display_pwm_set(stm32f4_display_hw_t *p_display, rgb_color_t color, uint8_t level);
+static void _display_bar_init(stm32f4_display_hw_t *p_display);
+static void _display_bar_set(stm32f4_display_hw_t *p_display, rgb_color_t color, uint8_t level);
+
 /* Global variables */
 
+/**
+ * @brief Backend of the single RGB LED displays driven by PWM timers.
+ */
+
+static const stm32f4_display_backend_t display_pwm_backend = {
+    .p_init = _display_pwm_init,
+    .p_set = _display_pwm_set
+};
+
+/**
+ * @brief Backend of the WS2812 LED bar displays.
+ */
+
+static const stm32f4_display_backend_t display_bar_backend = {
+    .p_init = _display_bar_init,
+    .p_set = _display_bar_set
+};
+
 /**
  * @brief Array of hardware configurations for the displays.
  */
 
-static 
+static
 stm32f4_display_hw_t displays_arr[]= {
     [PORT_REAR_PARKING_DISPLAY_ID] ={
-        .p_port_red =  STM32F4_REAR_PARKING_DISPLAY_RGB_R_GPIO,
-        .pin_red =  STM32F4_REAR_PARKING_DISPLAY_RGB_R_PIN,
-        .p_port_green =STM32F4_REAR_PARKING_DISPLAY_RGB_G_GPIO,
-        .pin_green = STM32F4_REAR_PARKING_DISPLAY_RGB_G_PIN,
-        .p_port_blue = STM32F4_REAR_PARKING_DISPLAY_RGB_B_GPIO,
-        .pin_blue =STM32F4_REAR_PARKING_DISPLAY_RGB_B_PIN
+        .p_backend = &display_pwm_backend,
+        .rgb = {
+            {.p_port = STM32F4_REAR_PARKING_DISPLAY_RGB_R_GPIO, .pin = STM32F4_REAR_PARKING_DISPLAY_RGB_R_PIN, .alt_func = STM32F4_AF2, .p_timer = TIM4, .channel = 1},
+            {.p_port = STM32F4_REAR_PARKING_DISPLAY_RGB_G_GPIO, .pin = STM32F4_REAR_PARKING_DISPLAY_RGB_G_PIN, .alt_func = STM32F4_AF2, .p_timer = TIM4, .channel = 3},
+            {.p_port = STM32F4_REAR_PARKING_DISPLAY_RGB_B_GPIO, .pin = STM32F4_REAR_PARKING_DISPLAY_RGB_B_PIN, .alt_func = STM32F4_AF2, .p_timer = TIM4, .channel = 4}
+        }
+    },
+    [PORT_FRONT_PARKING_DISPLAY_ID] ={
+        .p_backend = &display_pwm_backend,
+        .rgb = {
+            {.p_port = STM32F4_FRONT_PARKING_DISPLAY_RGB_R_GPIO, .pin = STM32F4_FRONT_PARKING_DISPLAY_RGB_R_PIN, .alt_func = STM32F4_AF1, .p_timer = TIM1, .channel = 1},
+            {.p_port = STM32F4_FRONT_PARKING_DISPLAY_RGB_G_GPIO, .pin = STM32F4_FRONT_PARKING_DISPLAY_RGB_G_PIN, .alt_func = STM32F4_AF1, .p_timer = TIM1, .channel = 2},
+            {.p_port = STM32F4_FRONT_PARKING_DISPLAY_RGB_B_GPIO, .pin = STM32F4_FRONT_PARKING_DISPLAY_RGB_B_PIN, .alt_func = STM32F4_AF1, .p_timer = TIM1, .channel = 3}
+        }
+    },
+    [PORT_REAR_PARKING_BAR_DISPLAY_ID] ={
+        .p_backend = &display_bar_backend,
+        .bar_id = STM32F4_REAR_PARKING_BAR_ID
     }
 };
 /* Private functions -----------------------------------------------------------*/
 
 /**
  * @brief Retrieves the hardware configuration for a specific display ID.
- * 
+ *
  * @param display_id The ID of the display to retrieve.
- * 
+ *
  * @return Pointer to the hardware configuration structure, or NULL if the ID is invalid.
  */
 
@@ -74,120 +141,192 @@ stm32f4_display_hw_t *_stm32f4_display_get(uint32_t display_id)
 }
 
 /**
- * @brief Configures the PWM timer for the specified display.
- * 
- * @param display_id The ID of the display to configure.
+ * @brief Enables the peripheral clock of one of the timers that can be used by the displays.
+ *
+ * @param p_timer Timer whose clock is enabled.
  */
 
-void _timer_pwm_config(uint32_t display_id)
+static void _timer_clock_enable(TIM_TypeDef *p_timer)
 {
-    if(display_id == PORT_REAR_PARKING_DISPLAY_ID)
+    if (p_timer == TIM1)
+    {
+        RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
+    }
+    else if (p_timer == TIM4)
     {
-        RCC->APB1ENR |= RCC_APB1ENR_TIM4EN; 
+        RCC->APB1ENR |= RCC_APB1ENR_TIM4EN;
+    }
+    else if (p_timer == TIM8)
+    {
+        RCC->APB2ENR |= RCC_APB2ENR_TIM8EN;
+    }
+}
 
-        TIM4->CR1 &= ~TIM_CR1_CEN; 
-        TIM4->CR1 |= TIM_CR1_ARPE; 
+/**
+ * @brief Configures the time base of a PWM timer. The timer is only configured if it is stopped, so a timer shared with a display that is already lit is not disturbed.
+ *
+ * @param p_timer Timer to configure.
+ */
 
-        TIM4->CNT = 0; 
+void _timer_pwm_config(TIM_TypeDef *p_timer)
+{
+    _timer_clock_enable(p_timer);
+    if (p_timer->CR1 & TIM_CR1_CEN)
+    {
+        return;
+    }
 
-        double system_core_clock = (double)SystemCoreClock;
-        double max_arr = TIMER_MAX_ARR;
-        double time_PWD = (double)1/frec_PWD;
-        double psc = round(system_core_clock*time_PWD/(max_arr+1.0)-1.0);
-        double arr = round(system_core_clock*time_PWD/(psc+1.0)-1.0);
-        if (arr > max_arr)
-        {
-            psc += 1.0;
-            arr = round(system_core_clock*time_PWD/(psc+1.0)-1.0);
-        }
-        TIM4->PSC = (uint32_t)psc;
-        TIM4->ARR = (uint32_t)arr;
+    p_timer->CR1 |= TIM_CR1_ARPE;
+
+    p_timer->CNT = 0;
 
-        TIM4->CCER &= ~TIM_CCER_CC1E;
-        TIM4->CCER &= ~TIM_CCER_CC3E;
-        TIM4->CCER &= ~TIM_CCER_CC4E;
+    double system_core_clock = (double)SystemCoreClock;
+    double max_arr = TIMER_MAX_ARR;
+    double time_PWD = (double)1/frec_PWD;
+    double psc = round(system_core_clock*time_PWD/(max_arr+1.0)-1.0);
+    double arr = round(system_core_clock*time_PWD/(psc+1.0)-1.0);
+    if (arr > max_arr)
+    {
+        psc += 1.0;
+        arr = round(system_core_clock*time_PWD/(psc+1.0)-1.0);
+    }
+    p_timer->PSC = (uint32_t)psc;
+    p_timer->ARR = (uint32_t)arr;
 
-        TIM4->CCER &= ~TIM_CCER_CC1P;
-        TIM4->CCER &= ~TIM_CCER_CC3P;
-        TIM4->CCER &= ~TIM_CCER_CC4P;
+    // Advanced-control timers only drive their outputs if the main output is enabled
+    if ((p_timer == TIM1) || (p_timer == TIM8))
+    {
+        p_timer->BDTR |= TIM_BDTR_MOE;
+    }
 
-        TIM4->CCER &= ~TIM_CCER_CC1NP;
-        TIM4->CCER &= ~TIM_CCER_CC3NP;
-        TIM4->CCER &= ~TIM_CCER_CC4NP;
+    p_timer->EGR |= TIM_EGR_UG;
+}
 
-        TIM4->CCMR1 |= TIM_CCMR1_OC1M_0;  
-        TIM4->CCMR2 |= TIM_CCMR2_OC3M_0;  
-        TIM4->CCMR2 |= TIM_CCMR2_OC4M_0; 
+/**
+ * @brief Configures one channel of a timer in PWM mode 1 with preload, and computes its CCR address and CCER enable bit.
+ *
+ * @param p_channel Pointer to the hardware configuration of the color component.
+ */
 
-        TIM4->CCMR1 |= TIM_CCMR1_OC1PE;
-        TIM4->CCMR2 |= TIM_CCMR2_OC3PE;
-        TIM4->CCMR2 |= TIM_CCMR2_OC4PE;
+void _timer_pwm_channel_config(stm32f4_display_channel_hw_t *p_channel)
+{
+    TIM_TypeDef *p_timer = p_channel->p_timer;
+    uint32_t index = p_channel->channel - 1;
 
-        TIM4->EGR |= TIM_EGR_UG;  
-    }
+    // CCR1 to CCR4 and CCMR1 to CCMR2 are consecutive registers
+    p_channel->p_ccr = &p_timer->CCR1 + index;
+    p_channel->ccer_en = TIM_CCER_CC1E << (index * STM32F4_TIM_CCER_CHANNEL_BITS);
+
+    p_timer->CCER &= ~((TIM_CCER_CC1E | TIM_CCER_CC1P | TIM_CCER_CC1NP) << (index * STM32F4_TIM_CCER_CHANNEL_BITS));
+
+    volatile uint32_t *p_ccmr = &p_timer->CCMR1 + (index / 2);
+    uint32_t ccmr_shift = (index % 2) * STM32F4_TIM_CCMR_CHANNEL_BITS;
+    *p_ccmr &= ~((TIM_CCMR1_CC1S | TIM_CCMR1_OC1M) << ccmr_shift);
+    *p_ccmr |= ((STM32F4_TIM_OCM_PWM1 << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE) << ccmr_shift;
 }
-/* Public functions -----------------------------------------------------------*/
 
+/**
+ * @brief Configures the GPIOs and the PWM channels of a single RGB LED display.
+ *
+ * @param p_display Pointer to the hardware configuration of the display.
+ */
+
+static void _display_pwm_init(stm32f4_display_hw_t *p_display)
+{
+    for (uint32_t i = 0; i < STM32F4_DISPLAY_NUM_COMPONENTS; i++)
+    {
+        stm32f4_display_channel_hw_t *p_channel = &p_display->rgb[i];
 
-void port_display_init(uint32_t display_id){
-    stm32f4_display_hw_t *p_display = _stm32f4_display_get(display_id);
-    stm32f4_system_gpio_config(p_display->p_port_red, p_display->pin_red, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
-    
-    stm32f4_system_gpio_config_alternate(p_display->p_port_red, p_display->pin_red, STM32F4_AF2);
-    
-    stm32f4_system_gpio_config(p_display->p_port_green, p_display->pin_green, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
-    
-    stm32f4_system_gpio_config_alternate(p_display->p_port_green, p_display->pin_green, STM32F4_AF2);
-    
-    stm32f4_system_gpio_config(p_display->p_port_blue, p_display->pin_blue, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
-    
-    stm32f4_system_gpio_config_alternate(p_display->p_port_blue, p_display->pin_blue, STM32F4_AF2);
-    
-    _timer_pwm_config(display_id);
-    
-    port_display_set_rgb(display_id, COLOR_OFF);
+        stm32f4_system_gpio_config(p_channel->p_port, p_channel->pin, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
+
+        stm32f4_system_gpio_config_alternate(p_channel->p_port, p_channel->pin, p_channel->alt_func);
+
+        _timer_pwm_config(p_channel->p_timer);
+
+        _timer_pwm_channel_config(p_channel);
+    }
 }
 
-void port_display_set_rgb(uint32_t display_id, rgb_color_t color){
-    uint8_t r = color.r;
-    uint8_t g = color.g;
-    uint8_t b = color.b;
-    
-    if (display_id == PORT_REAR_PARKING_DISPLAY_ID)
+/**
+ * @brief Sets the color of a single RGB LED display. The fill level is ignored.
+ *
+ * @param p_display Pointer to the hardware configuration of the display.
+ * @param color The RGB color to set.
+ * @param level Fill level of the display (not used).
+ */
+
+static void _display_pwm_set(stm32f4_display_hw_t *p_display, rgb_color_t color, uint8_t level)
+{
+    uint32_t levels[STM32F4_DISPLAY_NUM_COMPONENTS] = {color.r, color.g, color.b};
+
+    for (uint32_t i = 0; i < STM32F4_DISPLAY_NUM_COMPONENTS; i++)
     {
-        TIM4->CR1 &= ~TIM_CR1_CEN;
-        if((r==0) & (g== 0) & (b==0)){
-            TIM4->CCER &= ~TIM_CCER_CC1E;
-            TIM4->CCER &= ~TIM_CCER_CC3E;
-            TIM4->CCER &= ~TIM_CCER_CC4E;
-            return;
-        }
-        else if(r==0){
-            TIM4->CCER &= ~TIM_CCER_CC1E;
-        }
-        else{
-            double duty_cycle = (double)r/(double)PORT_DISPLAY_RGB_MAX_VALUE;
-            TIM4->CCR1 = (uint32_t)(duty_cycle*(double)TIM4->ARR);
-            TIM4->CCER |= TIM_CCER_CC1E;
-        }
-        if(g==0){
-            TIM4->CCER &= ~TIM_CCER_CC3E;
+        stm32f4_display_channel_hw_t *p_channel = &p_display->rgb[i];
+        TIM_TypeDef *p_timer = p_channel->p_timer;
+
+        if (levels[i] == 0)
+        {
+            p_timer->CCER &= ~p_channel->ccer_en;
         }
-        else{
-            double duty_cycle = (double)g/(double)PORT_DISPLAY_RGB_MAX_VALUE;
-            TIM4->CCR3 = (uint32_t)(duty_cycle*(double)TIM4->ARR);
-            TIM4->CCER |= TIM_CCER_CC3E;
+        else
+        {
+            // The CCRx are preloaded: the new duty cycle is applied at the next update event without glitches
+            *p_channel->p_ccr = (levels[i] * p_timer->ARR) / PORT_DISPLAY_RGB_MAX_VALUE;
+            p_timer->CCER |= p_channel->ccer_en;
         }
-        if(b==0){
-            TIM4->CCER &= ~TIM_CCER_CC4E;
+
+        // A timer runs while any of its channels is lit, whichever display it belongs to
+        if ((p_timer->CCER & STM32F4_TIM_CCER_ALL_CCE) == 0)
+        {
+            p_timer->CR1 &= ~TIM_CR1_CEN;
         }
-        else{
-            double duty_cycle = (double)b/(double)PORT_DISPLAY_RGB_MAX_VALUE;
-            TIM4->CCR4 = (uint32_t)(duty_cycle*(double)TIM4->ARR);
-            TIM4->CCER |= TIM_CCER_CC4E;
+        else if ((p_timer->CR1 & TIM_CR1_CEN) == 0)
+        {
+            p_timer->EGR |= TIM_EGR_UG;
+            p_timer->CR1 |= TIM_CR1_CEN;
         }
-        TIM4->EGR |= TIM_EGR_UG;  
-        TIM4->CR1 |= TIM_CR1_CEN;
-        return;
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Configures a WS2812 LED bar display.
+ *
+ * @param p_display Pointer to the hardware configuration of the display.
+ */
+
+static void _display_bar_init(stm32f4_display_hw_t *p_display)
+{
+    stm32f4_display_bar_init(p_display->bar_id);
+}
+
+/**
+ * @brief Sets the color and the fill level of a WS2812 LED bar display.
+ *
+ * @param p_display Pointer to the hardware configuration of the display.
+ * @param color The color of the lit LEDs.
+ * @param level Fill level of the bar.
+ */
+
+static void _display_bar_set(stm32f4_display_hw_t *p_display, rgb_color_t color, uint8_t level)
+{
+    stm32f4_display_bar_set(p_display->bar_id, color, level);
+}
+
+/* Public functions -----------------------------------------------------------*/
+
+
+void port_display_init(uint32_t display_id){
+    stm32f4_display_hw_t *p_display = _stm32f4_display_get(display_id);
+    p_display->p_backend->p_init(p_display);
+    p_display->p_backend->p_set(p_display, COLOR_OFF, 0);
+}
+
+void port_display_set_rgb(uint32_t display_id, rgb_color_t color){
+    stm32f4_display_hw_t *p_display = _stm32f4_display_get(display_id);
+    p_display->p_backend->p_set(p_display, color, PORT_DISPLAY_RGB_MAX_VALUE);
+}
+
+void port_display_set_bar(uint32_t display_id, rgb_color_t color, uint8_t level){
+    stm32f4_display_hw_t *p_display = _stm32f4_display_get(display_id);
+    p_display->p_backend->p_set(p_display, color, level);
+}
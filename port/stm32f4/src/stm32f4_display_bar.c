@@ -0,0 +1,273 @@
+/**
+ * @file stm32f4_display_bar.c
+ * @brief Portable functions of the WS2812 LED bar displays.
+ *
+ * The data line of the bar is a PWM channel of a timer running at the WS2812 bit rate. Each bit of the frame is a compare value that a DMA stream, requested by the update event of the timer, copies into the preloaded CCR of the channel. The CPU only encodes the frame when it changes; the timer is stopped by the transfer complete interrupt of the DMA stream.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+
+/* Standard C includes */
+#include <stdbool.h>
+#include <stddef.h>
+/* HW dependent includes */
+#include "port_display.h"
+#include "port_display_ws2812.h"
+#include "port_system.h"
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_display.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define STM32F4_WS2812_BIT_HZ 800000 /*!< Bit rate of the WS2812 data line.*/
+#define STM32F4_WS2812_T0H_NS 400 /*!< High time (in ns) of a 0 bit.*/
+#define STM32F4_WS2812_T1H_NS 800 /*!< High time (in ns) of a 1 bit.*/
+#define STM32F4_TIM_OCM_PWM1 0x06U /*!< Output compare mode: PWM mode 1.*/
+#define STM32F4_DMA_SxCR_DIR_M2P 0x01U /*!< DMA direction: memory to peripheral.*/
+#define STM32F4_DMA_SxCR_SIZE_HALFWORD 0x01U /*!< DMA data size: half-word (16 bits).*/
+#define STM32F4_DMA_SxCR_PL_HIGH 0x02U /*!< DMA priority level: high.*/
+
+/* Typedefs --------------------------------------------------------------------*/
+
+/**
+ * @brief Structure representing the hardware configuration and the frame of a WS2812 LED bar.
+ */
+
+typedef struct {
+    GPIO_TypeDef *p_port; /*!< GPIO port of the data line.*/
+    uint8_t pin; /*!< GPIO pin of the data line.*/
+    uint8_t alt_func; /*!< Alternate function that connects the pin to channel 1 of the timer.*/
+    TIM_TypeDef *p_timer; /*!< Timer whose channel 1 drives the data line.*/
+    DMA_Stream_TypeDef *p_dma_stream; /*!< DMA stream requested by the update event of the timer.*/
+    uint8_t dma_channel; /*!< Channel of the DMA stream connected to the update event of the timer.*/
+    IRQn_Type dma_irqn; /*!< Interrupt of the DMA stream.*/
+    volatile uint32_t *p_dma_ifcr; /*!< Interrupt flag clear register of the DMA stream.*/
+    uint32_t dma_ifcr_mask; /*!< Mask to clear all the interrupt flags of the DMA stream.*/
+    uint16_t t0h; /*!< Compare value of a 0 bit. Computed in `stm32f4_display_bar_init()`.*/
+    uint16_t t1h; /*!< Compare value of a 1 bit. Computed in `stm32f4_display_bar_init()`.*/
+    bool frame_valid; /*!< Flag indicating that the last frame sent is stored in `color` and `lit_leds`.*/
+    rgb_color_t color; /*!< Color of the last frame sent.*/
+    uint32_t lit_leds; /*!< Number of lit LEDs of the last frame sent.*/
+    uint16_t frame[PORT_DISPLAY_WS2812_FRAME_SLOTS(PORT_DISPLAY_BAR_NUM_LEDS)]; /*!< Compare values of the frame, read by the DMA.*/
+} stm32f4_display_bar_hw_t;
+
+/* Global variables */
+
+/**
+ * @brief Array of hardware configurations for the LED bars.
+ */
+
+static stm32f4_display_bar_hw_t bars_arr[] = {
+    [STM32F4_REAR_PARKING_BAR_ID] = {
+        .p_port = STM32F4_REAR_PARKING_BAR_DATA_GPIO,
+        .pin = STM32F4_REAR_PARKING_BAR_DATA_PIN,
+        .alt_func = STM32F4_AF3,
+        .p_timer = TIM8,
+        .p_dma_stream = DMA2_Stream1,
+        .dma_channel = 7,
+        .dma_irqn = DMA2_Stream1_IRQn,
+        .p_dma_ifcr = &DMA2->LIFCR,
+        .dma_ifcr_mask = DMA_LIFCR_CFEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CTEIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTCIF1
+    }
+};
+
+/* Private functions -----------------------------------------------------------*/
+
+/**
+ * @brief Retrieves the hardware configuration for a specific LED bar.
+ *
+ * @param bar_id The index of the LED bar to retrieve.
+ *
+ * @return Pointer to the hardware configuration structure, or NULL if the index is invalid.
+ */
+
+static stm32f4_display_bar_hw_t *_stm32f4_display_bar_get(uint32_t bar_id)
+{
+    if (bar_id < sizeof(bars_arr) / sizeof(bars_arr[0]))
+    {
+        return &bars_arr[bar_id];
+    }
+    else
+    {
+        return NULL;
+    }
+}
+
+/**
+ * @brief Converts a time in nanoseconds into ticks of a timer clocked at `SystemCoreClock`, rounding to the nearest tick.
+ *
+ * @param ns Time in nanoseconds.
+ *
+ * @return Number of ticks.
+ */
+
+static uint32_t _ns_to_ticks(uint32_t ns)
+{
+    return ((SystemCoreClock / 1000) * ns + 500000) / 1000000;
+}
+
+/**
+ * @brief Configures channel 1 of the timer of a LED bar in PWM mode 1 at the WS2812 bit rate, with the output low.
+ *
+ * @param p_bar Pointer to the hardware configuration of the LED bar.
+ */
+
+static void _timer_bar_config(stm32f4_display_bar_hw_t *p_bar)
+{
+    TIM_TypeDef *p_timer = p_bar->p_timer;
+
+    if (p_timer == TIM1)
+    {
+        RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
+    }
+    else if (p_timer == TIM8)
+    {
+        RCC->APB2ENR |= RCC_APB2ENR_TIM8EN;
+    }
+
+    p_timer->CR1 &= ~TIM_CR1_CEN;
+    p_timer->CR1 |= TIM_CR1_ARPE;
+    p_timer->DIER &= ~TIM_DIER_UDE;
+    p_timer->CNT = 0;
+
+    p_timer->PSC = 0;
+    p_timer->ARR = ((SystemCoreClock + STM32F4_WS2812_BIT_HZ / 2) / STM32F4_WS2812_BIT_HZ) - 1;
+    p_bar->t0h = (uint16_t)_ns_to_ticks(STM32F4_WS2812_T0H_NS);
+    p_bar->t1h = (uint16_t)_ns_to_ticks(STM32F4_WS2812_T1H_NS);
+
+    p_timer->CCER &= ~(TIM_CCER_CC1P | TIM_CCER_CC1NP);
+    p_timer->CCMR1 &= ~(TIM_CCMR1_CC1S | TIM_CCMR1_OC1M);
+    p_timer->CCMR1 |= (STM32F4_TIM_OCM_PWM1 << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE;
+    p_timer->CCR1 = 0;
+    p_timer->CCER |= TIM_CCER_CC1E;
+    p_timer->BDTR |= TIM_BDTR_MOE;
+
+    p_timer->EGR |= TIM_EGR_UG;
+}
+
+/**
+ * @brief Configures the DMA stream of a LED bar to copy half-words from the frame to the CCR1 of the timer, with the transfer complete interrupt enabled.
+ *
+ * @param p_bar Pointer to the hardware configuration of the LED bar.
+ */
+
+static void _dma_bar_config(stm32f4_display_bar_hw_t *p_bar)
+{
+    DMA_Stream_TypeDef *p_stream = p_bar->p_dma_stream;
+
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+
+    p_stream->CR &= ~DMA_SxCR_EN;
+    while (p_stream->CR & DMA_SxCR_EN)
+    {
+    }
+    *p_bar->p_dma_ifcr = p_bar->dma_ifcr_mask;
+
+    p_stream->CR = ((uint32_t)p_bar->dma_channel << DMA_SxCR_CHSEL_Pos) |
+                   (STM32F4_DMA_SxCR_PL_HIGH << DMA_SxCR_PL_Pos) |
+                   (STM32F4_DMA_SxCR_SIZE_HALFWORD << DMA_SxCR_MSIZE_Pos) |
+                   (STM32F4_DMA_SxCR_SIZE_HALFWORD << DMA_SxCR_PSIZE_Pos) |
+                   DMA_SxCR_MINC |
+                   (STM32F4_DMA_SxCR_DIR_M2P << DMA_SxCR_DIR_Pos) |
+                   DMA_SxCR_TCIE;
+    p_stream->FCR = 0; // Direct mode
+    p_stream->PAR = (uint32_t)&p_bar->p_timer->CCR1;
+    p_stream->M0AR = (uint32_t)p_bar->frame;
+
+    NVIC_SetPriority(p_bar->dma_irqn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 6, 0));
+    NVIC_EnableIRQ(p_bar->dma_irqn);
+}
+
+/**
+ * @brief Starts the transfer of the frame of a LED bar. The first period of the timer is sent low, and the DMA writes the next slot in every update event.
+ *
+ * @param p_bar Pointer to the hardware configuration of the LED bar.
+ * @param num_slots Number of slots of the frame.
+ */
+
+static void _start_transfer(stm32f4_display_bar_hw_t *p_bar, uint32_t num_slots)
+{
+    TIM_TypeDef *p_timer = p_bar->p_timer;
+    DMA_Stream_TypeDef *p_stream = p_bar->p_dma_stream;
+
+    p_timer->CR1 &= ~TIM_CR1_CEN;
+    p_timer->DIER &= ~TIM_DIER_UDE;
+    p_timer->CCR1 = 0;
+    p_timer->CNT = 0;
+    p_timer->EGR |= TIM_EGR_UG;
+
+    *p_bar->p_dma_ifcr = p_bar->dma_ifcr_mask;
+    p_stream->NDTR = num_slots;
+    p_stream->CR |= DMA_SxCR_EN;
+
+    p_timer->DIER |= TIM_DIER_UDE;
+    p_timer->CR1 |= TIM_CR1_CEN;
+}
+
+/* Public functions -----------------------------------------------------------*/
+
+void stm32f4_display_bar_init(uint32_t bar_id)
+{
+    stm32f4_display_bar_hw_t *p_bar = _stm32f4_display_bar_get(bar_id);
+    if (p_bar == NULL)
+    {
+        return;
+    }
+
+    stm32f4_system_gpio_config(p_bar->p_port, p_bar->pin, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
+    stm32f4_system_gpio_config_alternate(p_bar->p_port, p_bar->pin, p_bar->alt_func);
+
+    _timer_bar_config(p_bar);
+    _dma_bar_config(p_bar);
+
+    p_bar->frame_valid = false;
+    stm32f4_display_bar_set(bar_id, COLOR_OFF, 0);
+}
+
+void stm32f4_display_bar_set(uint32_t bar_id, rgb_color_t color, uint8_t level)
+{
+    stm32f4_display_bar_hw_t *p_bar = _stm32f4_display_bar_get(bar_id);
+    if (p_bar == NULL)
+    {
+        return;
+    }
+    uint32_t lit_leds = port_display_ws2812_get_lit_leds(level, PORT_DISPLAY_BAR_NUM_LEDS);
+
+    // The color of a bar with no lit LEDs is irrelevant
+    if (lit_leds == 0)
+    {
+        color = COLOR_OFF;
+    }
+    if (p_bar->frame_valid && (lit_leds == p_bar->lit_leds) &&
+        (color.r == p_bar->color.r) && (color.g == p_bar->color.g) && (color.b == p_bar->color.b))
+    {
+        return;
+    }
+
+    // The frame cannot be modified while the DMA reads it (a frame lasts less than 0.3 ms). Its reset slots then keep the line low long enough to latch it before the next one
+    while (p_bar->p_dma_stream->CR & DMA_SxCR_EN)
+    {
+    }
+
+    uint32_t num_slots = port_display_ws2812_encode_bar(p_bar->frame, PORT_DISPLAY_BAR_NUM_LEDS, color, level, p_bar->t0h, p_bar->t1h);
+    p_bar->color = color;
+    p_bar->lit_leds = lit_leds;
+    p_bar->frame_valid = true;
+
+    _start_transfer(p_bar, num_slots);
+}
+
+void stm32f4_display_bar_transfer_complete(uint32_t bar_id)
+{
+    stm32f4_display_bar_hw_t *p_bar = _stm32f4_display_bar_get(bar_id);
+    if (p_bar == NULL)
+    {
+        return;
+    }
+
+    // The reset slots at the end of the frame keep the line low while the timer is stopped
+    p_bar->p_timer->DIER &= ~TIM_DIER_UDE;
+    p_bar->p_timer->CR1 &= ~TIM_CR1_CEN;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file stm32f4_shell.c
+ * @brief Portable functions to receive the command lines of the shell in the STM32F4 platform.
+ *
+ * The lines are received by USART2, the UART of the telemetry (see `stm32f4_telemetry.c`). Its receive interrupt queues each byte in the ring, and the main loop takes them. The ISR only writes the head of the ring and the main loop only writes its tail, so no critical section is needed.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* HW dependent includes */
+#include "port_shell.h"
+#include "port_system.h"
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_telemetry.h"
+#include "stm32f4_shell.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define STM32F4_SHELL_UART USART2 /*!< UART of the shell.*/
+#define STM32F4_SHELL_RX_RING_MASK (PORT_SHELL_RX_RING_SIZE - 1) /*!< Mask of an index of the ring.*/
+
+/* Global variables -----------------------------------------------------------*/
+static uint8_t rx_ring[PORT_SHELL_RX_RING_SIZE]; /*!< Bytes received and not taken yet.*/
+static volatile uint32_t rx_head = 0;            /*!< Free-running index where the ISR writes the next byte.*/
+static volatile uint32_t rx_tail = 0;            /*!< Free-running index of the next byte to take.*/
+static volatile uint32_t num_overruns = 0;       /*!< Bytes lost because the ring was full.*/
+
+/* Public functions -----------------------------------------------------------*/
+void port_shell_init(void)
+{
+    USART_TypeDef *p_uart = STM32F4_SHELL_UART;
+
+    NVIC_DisableIRQ(USART2_IRQn);
+    rx_head = 0;
+    rx_tail = 0;
+    num_overruns = 0;
+
+    stm32f4_telemetry_uart_init();
+    p_uart->CR1 |= USART_CR1_RE | USART_CR1_RXNEIE;
+
+    // Below the timers of the sensor: a byte takes 87 us at 115200 bauds, so the ISR can wait
+    NVIC_SetPriority(USART2_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 6, 0));
+    NVIC_EnableIRQ(USART2_IRQn);
+}
+
+bool port_shell_read(uint8_t *p_byte)
+{
+    uint32_t tail = rx_tail;
+    if (tail == rx_head)
+    {
+        return false;
+    }
+    *p_byte = rx_ring[tail & STM32F4_SHELL_RX_RING_MASK];
+    rx_tail = tail + 1;
+    return true;
+}
+
+uint32_t port_shell_get_num_overruns(void)
+{
+    return num_overruns;
+}
+
+void stm32f4_shell_receive(uint8_t byte)
+{
+    uint32_t head = rx_head;
+    if (head - rx_tail >= PORT_SHELL_RX_RING_SIZE)
+    {
+        num_overruns++;
+        return;
+    }
+    rx_ring[head & STM32F4_SHELL_RX_RING_MASK] = byte;
+    rx_head = head + 1;
+}
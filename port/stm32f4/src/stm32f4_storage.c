@@ -0,0 +1,140 @@
+/**
+ * @file stm32f4_storage.c
+ * @brief Portable functions to interact with the non-volatile storage in the STM32F4 platform.
+ *
+ * The storage is made of the last sectors of the internal flash, which are reserved for it. The sectors are read through the memory map, and programmed and erased with the flash interface: the CPU stalls on any access to the flash while it is busy, so the functions simply wait for the end of the operation. The words are programmed with a parallelism of 32 bits, which requires a supply voltage of 2.7 V to 3.6 V.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Standard C includes */
+#include <string.h>
+/* HW dependent includes */
+#include "port_storage.h"
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_storage.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define STM32F4_FLASH_SR_ERRORS (FLASH_SR_WRPERR | FLASH_SR_PGAERR | FLASH_SR_PGPERR | FLASH_SR_PGSERR) /*!< Error flags of the flash status register.*/
+#define STM32F4_FLASH_CR_PSIZE_X32 FLASH_CR_PSIZE_1 /*!< Program parallelism of 32 bits.*/
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Returns the address of a word of the storage.
+ *
+ * @param sector Index of the sector of the storage.
+ * @param offset Offset of the word in the sector, in bytes.
+ *
+ * @return uintptr_t Address of the word in the memory map.
+ */
+static uintptr_t _stm32f4_storage_address(uint32_t sector, uint32_t offset)
+{
+    return STM32F4_STORAGE_BASE_ADDRESS + sector * STM32F4_STORAGE_SECTOR_SIZE + offset;
+}
+
+/**
+ * @brief Unlocks the flash control register and clears the flags of previous operations.
+ */
+static void _stm32f4_storage_unlock(void)
+{
+    if (FLASH->CR & FLASH_CR_LOCK)
+    {
+        FLASH->KEYR = STM32F4_FLASH_KEY1;
+        FLASH->KEYR = STM32F4_FLASH_KEY2;
+    }
+    FLASH->SR = STM32F4_FLASH_SR_ERRORS | FLASH_SR_EOP; // The flags are cleared by writing 1
+}
+
+/**
+ * @brief Waits for the end of the current flash operation.
+ *
+ * @retval true if the operation succeeded.
+ * @retval false if the flash reported an error.
+ */
+static bool _stm32f4_storage_wait(void)
+{
+    while (FLASH->SR & FLASH_SR_BSY)
+    {
+    }
+    return (FLASH->SR & STM32F4_FLASH_SR_ERRORS) == 0;
+}
+
+/**
+ * @brief Clears the operation bits of the flash control register and locks it.
+ */
+static void _stm32f4_storage_lock(void)
+{
+    FLASH->CR &= ~(FLASH_CR_PG | FLASH_CR_SER | FLASH_CR_SNB);
+    FLASH->CR |= FLASH_CR_LOCK;
+}
+
+/* Public functions -----------------------------------------------------------*/
+bool port_storage_init(void)
+{
+    _stm32f4_storage_lock();
+    return true;
+}
+
+uint32_t port_storage_get_num_sectors(void)
+{
+    return STM32F4_STORAGE_NUM_SECTORS;
+}
+
+uint32_t port_storage_get_sector_size(void)
+{
+    return STM32F4_STORAGE_SECTOR_SIZE;
+}
+
+void port_storage_read(uint32_t sector, uint32_t offset, uint32_t *p_words, uint32_t num_words)
+{
+    memcpy(p_words, (const void *)_stm32f4_storage_address(sector, offset), num_words * sizeof(uint32_t));
+}
+
+bool port_storage_program(uint32_t sector, uint32_t offset, const uint32_t *p_words, uint32_t num_words)
+{
+    if (sector >= STM32F4_STORAGE_NUM_SECTORS || offset + num_words * sizeof(uint32_t) > STM32F4_STORAGE_SECTOR_SIZE)
+    {
+        return false;
+    }
+    volatile uint32_t *p_flash = (volatile uint32_t *)_stm32f4_storage_address(sector, offset);
+    bool ok = true;
+
+    _stm32f4_storage_unlock();
+    FLASH->CR &= ~FLASH_CR_PSIZE;
+    FLASH->CR |= STM32F4_FLASH_CR_PSIZE_X32 | FLASH_CR_PG;
+    for (uint32_t i = 0; i < num_words && ok; i++)
+    {
+        p_flash[i] = p_words[i];
+        ok = _stm32f4_storage_wait();
+    }
+    _stm32f4_storage_lock();
+    return ok;
+}
+
+bool port_storage_erase(uint32_t sector)
+{
+    if (sector >= STM32F4_STORAGE_NUM_SECTORS)
+    {
+        return false;
+    }
+
+    _stm32f4_storage_unlock();
+    FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+    FLASH->CR |= STM32F4_FLASH_CR_PSIZE_X32 | FLASH_CR_SER | ((STM32F4_STORAGE_FIRST_SECTOR + sector) << FLASH_CR_SNB_Pos);
+    FLASH->CR |= FLASH_CR_STRT;
+    bool ok = _stm32f4_storage_wait();
+    _stm32f4_storage_lock();
+
+    // The data cache may still hold the old contents of the sector. It can only be reset while it is disabled.
+    if (FLASH->ACR & FLASH_ACR_DCEN)
+    {
+        FLASH->ACR &= ~FLASH_ACR_DCEN;
+        FLASH->ACR |= FLASH_ACR_DCRST;
+        FLASH->ACR &= ~FLASH_ACR_DCRST;
+        FLASH->ACR |= FLASH_ACR_DCEN;
+    }
+    return ok;
+}
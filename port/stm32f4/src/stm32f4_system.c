@@ -5,6 +5,9 @@
  * @date 2025-01-01
  */
 
+/* Standard C includes */
+#include <stddef.h>
+
 /* HW dependent includes */
 #include "port_system.h"
 #include "stm32f4_system.h"
@@ -26,11 +29,31 @@ extern void initialise_monitor_handles(void);
                                                          0 bit  for subpriority */
 /* Power */
 #define POWER_REGULATOR_VOLTAGE_SCALE3 0x01 /*!< Scale 3 mode: the maximum value of fHCLK is 120 MHz. */
+#define POWER_CLOCK_PREDIV_A 7U    /*!< Asynchronous prescaler of the RTC (divides by 8) */
+#define POWER_CLOCK_PREDIV_S 3999U /*!< Synchronous prescaler of the RTC (divides by 4000): 1 s from the 32 kHz LSI, with a resolution of 250 us */
+#define POWER_CLOCK_SECONDS_PER_DAY 86400U /*!< Seconds of a day, the period of the time of the RTC */
+#define RTC_WPR_KEY1 0xCAU /*!< First key to unlock the write protection of the RTC */
+#define RTC_WPR_KEY2 0x53U /*!< Second key to unlock the write protection of the RTC */
+#define RTC_WPR_LOCK 0xFFU /*!< Any wrong key locks the write protection of the RTC again */
 
 //------------------------------------------------------
 // PRIVATE (STATIC) VARIABLES
 //------------------------------------------------------
 static volatile uint32_t msTicks = 0; /*!< Variable to store millisecond ticks. @warning **It must be declared volatile!** Just because it is modified in an ISR. **Add it to the definition** after *static*. */
+static uint32_t power_clock_last_s = 0; /*!< Second of the day of the last reading of the power clock, to detect the change of day */
+static uint32_t power_clock_days = 0;   /*!< Days counted by the power clock */
+static bool probe_pin_enabled = false;  /*!< The probe pin has been configured */
+
+/**
+ * @brief Structure representing the handler registered for an EXTI line.
+ */
+typedef struct
+{
+  stm32f4_system_exti_handler_t p_handler; /*!< Handler of the line (NULL if none) */
+  void *p_ctx;                             /*!< Context passed to the handler */
+} stm32f4_system_exti_entry_t;
+
+static volatile stm32f4_system_exti_entry_t exti_arr[STM32F4_SYSTEM_EXTI_NUM_LINES]; /*!< Handlers of the EXTI lines, indexed by line. Volatile, as they are read in the ISRs */
 
 //------------------------------------------------------
 // PUBLIC (GLOBAL) VARIABLES
@@ -183,6 +206,21 @@ uint32_t port_system_get_millis()
   return msTicks;
 }
 
+uint32_t port_system_get_micros()
+{
+  uint32_t ms;
+  uint32_t val;
+  /* Read the counter again if a tick has happened in the middle */
+  do
+  {
+    ms = msTicks;
+    val = SysTick->VAL;
+  } while (ms != msTicks);
+
+  uint32_t load = SysTick->LOAD + 1U; /* The counter counts down from LOAD to 0 every millisecond */
+  return ms * 1000U + ((load - 1U - val) * 1000U) / load;
+}
+
 void port_system_set_millis(uint32_t ms)
 {
   msTicks = ms;
@@ -190,12 +228,13 @@ void port_system_set_millis(uint32_t ms)
 
 void port_system_systick_resume()
 {
-  SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+  SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
 }
 
 void port_system_systick_suspend()
 {
- SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+  /* The counter is stopped too, so that the microseconds freeze with the milliseconds instead of wrapping back */
+  SysTick->CTRL &= ~(SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk);
 }
 
 // ------------------------------------------------------
@@ -297,6 +336,38 @@ void stm32f4_system_gpio_exti_disable(uint8_t pin)
   NVIC_DisableIRQ(GET_PIN_IRQN(pin));
 }
 
+void stm32f4_system_exti_register(uint8_t line, stm32f4_system_exti_handler_t p_handler, void *p_ctx)
+{
+  if (line >= STM32F4_SYSTEM_EXTI_NUM_LINES)
+  {
+    return;
+  }
+  /* An ISR must never see the new handler with the old context: the interrupts are masked while the entry changes */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  exti_arr[line].p_handler = NULL;
+  exti_arr[line].p_ctx = p_ctx;
+  exti_arr[line].p_handler = p_handler;
+  __set_PRIMASK(primask);
+}
+
+void stm32f4_system_exti_dispatch(uint32_t lines_mask)
+{
+  uint32_t pending = EXTI->PR & lines_mask;
+  EXTI->PR = pending; /* Write 1 to clear */
+
+  while (pending != 0)
+  {
+    uint8_t line = (uint8_t)__builtin_ctz(pending); /* RBIT + CLZ on Cortex-M4 */
+    pending &= pending - 1;
+    stm32f4_system_exti_handler_t p_handler = exti_arr[line].p_handler;
+    if (p_handler != NULL)
+    {
+      p_handler(line, exti_arr[line].p_ctx);
+    }
+  }
+}
+
 void stm32f4_system_gpio_config_alternate(GPIO_TypeDef *p_port, uint8_t pin, uint8_t alternate)
 {
   uint32_t base_mask = 0x0FU;
@@ -352,4 +423,103 @@ void port_system_power_sleep()
 void port_system_sleep(){
   port_system_systick_suspend();
   port_system_power_sleep();
-}
\ No newline at end of file
+}
+
+// ------------------------------------------------------
+// POWER CLOCK RELATED FUNCTIONS
+// ------------------------------------------------------
+/**
+ * @brief Converts a BCD field of a register of the RTC into binary.
+ *
+ * @param reg Value of the register.
+ * @param tens_mask Mask of the tens of the field.
+ * @param tens_pos Position of the tens of the field.
+ * @param units_mask Mask of the units of the field.
+ * @param units_pos Position of the units of the field.
+ *
+ * @return uint32_t Value of the field.
+ */
+static uint32_t _rtc_bcd_to_bin(uint32_t reg, uint32_t tens_mask, uint32_t tens_pos, uint32_t units_mask, uint32_t units_pos)
+{
+  return ((reg & tens_mask) >> tens_pos) * 10U + ((reg & units_mask) >> units_pos);
+}
+
+void port_system_power_clock_init()
+{
+  // The RTC runs from the LSI, which keeps running in Stop mode
+  RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+  PWR->CR |= PWR_CR_DBP; // Allow the access to the backup domain
+  RCC->CSR |= RCC_CSR_LSION;
+  while (!(RCC->CSR & RCC_CSR_LSIRDY))
+  {
+  }
+  if ((RCC->BDCR & RCC_BDCR_RTCSEL) != RCC_BDCR_RTCSEL_1)
+  {
+    // The clock of the RTC can only be selected after a reset of the backup domain
+    RCC->BDCR |= RCC_BDCR_BDRST;
+    RCC->BDCR &= ~RCC_BDCR_BDRST;
+    RCC->BDCR |= RCC_BDCR_RTCSEL_1;
+  }
+  RCC->BDCR |= RCC_BDCR_RTCEN;
+
+  RTC->WPR = RTC_WPR_KEY1;
+  RTC->WPR = RTC_WPR_KEY2;
+  RTC->ISR |= RTC_ISR_INIT;
+  while (!(RTC->ISR & RTC_ISR_INITF))
+  {
+  }
+  // The prescalers must be written in two separate accesses, the synchronous one first
+  RTC->PRER = (POWER_CLOCK_PREDIV_S << RTC_PRER_PREDIV_S_Pos);
+  RTC->PRER |= (POWER_CLOCK_PREDIV_A << RTC_PRER_PREDIV_A_Pos);
+  RTC->TR = 0;
+  RTC->CR |= RTC_CR_BYPSHAD; // Read the counters directly, so that they are valid right after waking up
+  RTC->ISR &= ~RTC_ISR_INIT;
+  RTC->WPR = RTC_WPR_LOCK;
+
+  power_clock_last_s = 0;
+  power_clock_days = 0;
+}
+
+uint64_t port_system_get_power_clock_us()
+{
+  // The counters are read directly: read them again if the RTC has counted in the middle
+  uint32_t ssr;
+  uint32_t tr;
+  do
+  {
+    ssr = RTC->SSR;
+    tr = RTC->TR;
+  } while ((ssr != RTC->SSR) || (tr != RTC->TR));
+
+  uint32_t seconds = _rtc_bcd_to_bin(tr, RTC_TR_HT, RTC_TR_HT_Pos, RTC_TR_HU, RTC_TR_HU_Pos) * 3600U +
+                     _rtc_bcd_to_bin(tr, RTC_TR_MNT, RTC_TR_MNT_Pos, RTC_TR_MNU, RTC_TR_MNU_Pos) * 60U +
+                     _rtc_bcd_to_bin(tr, RTC_TR_ST, RTC_TR_ST_Pos, RTC_TR_SU, RTC_TR_SU_Pos);
+  // The time of the RTC wraps around every day. A sleep longer than a day would lose it, but the system wakes up much more often
+  if (seconds < power_clock_last_s)
+  {
+    power_clock_days++;
+  }
+  power_clock_last_s = seconds;
+
+  // The sub-second counter counts down from the synchronous prescaler
+  uint32_t sub_us = (uint32_t)(((uint64_t)(POWER_CLOCK_PREDIV_S - (ssr & RTC_SSR_SS)) * 1000000U) / (POWER_CLOCK_PREDIV_S + 1U));
+  return ((uint64_t)power_clock_days * POWER_CLOCK_SECONDS_PER_DAY + seconds) * 1000000U + sub_us;
+}
+
+// ------------------------------------------------------
+// PROBE PIN RELATED FUNCTIONS
+// ------------------------------------------------------
+void port_system_probe_pin_init()
+{
+  stm32f4_system_gpio_config(STM32F4_PROBE_PIN_GPIO, STM32F4_PROBE_PIN, STM32F4_GPIO_MODE_OUT, STM32F4_GPIO_PUPDR_NOPULL);
+  stm32f4_system_gpio_write(STM32F4_PROBE_PIN_GPIO, STM32F4_PROBE_PIN, false);
+  probe_pin_enabled = true;
+}
+
+void port_system_probe_pin_write(bool high)
+{
+  if (probe_pin_enabled)
+  {
+    stm32f4_system_gpio_write(STM32F4_PROBE_PIN_GPIO, STM32F4_PROBE_PIN, high);
+  }
+}
@@ -0,0 +1,96 @@
+/**
+ * @file stm32f4_telemetry.c
+ * @brief Portable functions to send the telemetry stream in the STM32F4 platform.
+ *
+ * The stream is sent by USART2 (PA2/PA3, the virtual COM port of the ST-LINK), whose receiver is used by the shell. Each chunk is copied to the data register of the UART by DMA1 stream 6, channel 4, which is requested by the UART each time its transmit register is empty. The stream is disabled by the hardware at the end of the chunk, and its transfer complete interrupt only wakes the CPU up.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* HW dependent includes */
+#include "port_telemetry.h"
+#include "port_system.h"
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_telemetry.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define STM32F4_TELEMETRY_UART USART2 /*!< UART of the telemetry stream.*/
+#define STM32F4_TELEMETRY_DMA_STREAM DMA1_Stream6 /*!< DMA stream requested by USART2_TX.*/
+#define STM32F4_TELEMETRY_DMA_CHANNEL 4U /*!< Channel of the DMA stream connected to USART2_TX.*/
+#define STM32F4_TELEMETRY_DMA_IFCR_MASK (DMA_HIFCR_CFEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTCIF6) /*!< Mask to clear all the interrupt flags of the DMA stream.*/
+#define STM32F4_DMA_SxCR_DIR_M2P 0x01U /*!< DMA direction: memory to peripheral.*/
+#define STM32F4_DMA_SxCR_PL_LOW 0x00U /*!< DMA priority level: low, below the LED bar.*/
+
+/* Public functions -----------------------------------------------------------*/
+void port_telemetry_init(void)
+{
+    USART_TypeDef *p_uart = STM32F4_TELEMETRY_UART;
+    DMA_Stream_TypeDef *p_stream = STM32F4_TELEMETRY_DMA_STREAM;
+
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+    stm32f4_telemetry_uart_init();
+    p_uart->CR3 |= USART_CR3_DMAT;
+    p_uart->CR1 |= USART_CR1_TE;
+
+    p_stream->CR &= ~DMA_SxCR_EN;
+    while (p_stream->CR & DMA_SxCR_EN)
+    {
+    }
+    DMA1->HIFCR = STM32F4_TELEMETRY_DMA_IFCR_MASK;
+    p_stream->CR = (STM32F4_TELEMETRY_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) |
+                   (STM32F4_DMA_SxCR_PL_LOW << DMA_SxCR_PL_Pos) |
+                   DMA_SxCR_MINC |
+                   (STM32F4_DMA_SxCR_DIR_M2P << DMA_SxCR_DIR_Pos) |
+                   DMA_SxCR_TCIE; // Bytes on both sides
+    p_stream->FCR = 0; // Direct mode
+    p_stream->PAR = (uint32_t)&p_uart->DR;
+
+    NVIC_SetPriority(DMA1_Stream6_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 7, 0));
+    NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+}
+
+void port_telemetry_start(const uint8_t *p_data, uint32_t length)
+{
+    DMA_Stream_TypeDef *p_stream = STM32F4_TELEMETRY_DMA_STREAM;
+
+    DMA1->HIFCR = STM32F4_TELEMETRY_DMA_IFCR_MASK;
+    p_stream->M0AR = (uint32_t)p_data;
+    p_stream->NDTR = length;
+    p_stream->CR |= DMA_SxCR_EN;
+}
+
+bool port_telemetry_is_busy(void)
+{
+    return (STM32F4_TELEMETRY_DMA_STREAM->CR & DMA_SxCR_EN) != 0;
+}
+
+void stm32f4_telemetry_uart_init(void)
+{
+    USART_TypeDef *p_uart = STM32F4_TELEMETRY_UART;
+    if (p_uart->CR1 & USART_CR1_UE)
+    {
+        return; // Already configured by the telemetry or the shell
+    }
+
+    RCC->APB1ENR |= RCC_APB1ENR_USART2EN;
+
+    stm32f4_system_gpio_config(STM32F4_TELEMETRY_TX_GPIO, STM32F4_TELEMETRY_TX_PIN, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
+    stm32f4_system_gpio_config_alternate(STM32F4_TELEMETRY_TX_GPIO, STM32F4_TELEMETRY_TX_PIN, STM32F4_AF7);
+    stm32f4_system_gpio_config(STM32F4_TELEMETRY_RX_GPIO, STM32F4_TELEMETRY_RX_PIN, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_PULLUP);
+    stm32f4_system_gpio_config_alternate(STM32F4_TELEMETRY_RX_GPIO, STM32F4_TELEMETRY_RX_PIN, STM32F4_AF7);
+
+    // 8N1, oversampling by 16. APB1 runs at the system clock (no prescaler). The transmitter and the receiver are enabled by their users
+    p_uart->CR1 = 0;
+    p_uart->CR2 = 0;
+    p_uart->CR3 = 0;
+    p_uart->BRR = (SystemCoreClock + PORT_TELEMETRY_BAUD_RATE / 2) / PORT_TELEMETRY_BAUD_RATE;
+    p_uart->CR1 = USART_CR1_UE;
+}
+
+void stm32f4_telemetry_transfer_complete(void)
+{
+    DMA1->HIFCR = STM32F4_TELEMETRY_DMA_IFCR_MASK;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file stm32f4_temperature.c
+ * @brief Portable functions to read the temperature of the air in the STM32F4 platform.
+ *
+ * The temperature is a single conversion of ADC1, started by software and polled: there is no interrupt, since the conversion takes some tens of microseconds and the reading is only needed seconds later. By default the sensor is the one inside the microcontroller (channel 18), calibrated with its factory readings at 30 ºC and 110 ºC. It gives the temperature of the die, which is a few degrees above that of the air while the system runs. With `USE_EXTERNAL_TEMPERATURE` the sensor is an analog TMP36 (10 mV per ºC) on PA4, next to the ultrasound sensor.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* HW dependent includes */
+#include "port_temperature.h"
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_temperature.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define STM32F4_ADC_SMP_480_CYCLES 0x07U /*!< Sampling time of 480 cycles of the ADC clock, above the 10 us required by the internal sensor.*/
+#define STM32F4_ADC_SMP_BITS 3U /*!< Number of bits of the sampling time of each channel.*/
+#define STM32F4_ADC_SMPR1_FIRST_CHANNEL 10U /*!< First channel whose sampling time is in SMPR1.*/
+
+/* Public functions -----------------------------------------------------------*/
+void port_temperature_init(void)
+{
+    ADC_TypeDef *p_adc = STM32F4_TEMPERATURE_ADC;
+
+    RCC->APB2ENR |= RCC_APB2ENR_ADC1EN;
+    // ADC clock: PCLK2 / 4, below the maximum of 36 MHz
+    ADC123_COMMON->CCR = (ADC123_COMMON->CCR & ~ADC_CCR_ADCPRE) | ADC_CCR_ADCPRE_0;
+#ifdef USE_EXTERNAL_TEMPERATURE
+    stm32f4_system_gpio_config(STM32F4_TEMPERATURE_GPIO, STM32F4_TEMPERATURE_PIN, STM32F4_GPIO_MODE_AN, STM32F4_GPIO_PUPDR_NOPULL);
+#else
+    ADC123_COMMON->CCR |= ADC_CCR_TSVREFE;
+#endif
+
+    // 12-bit single conversion of a regular channel, started by software
+    p_adc->CR1 = 0;
+    p_adc->CR2 = 0;
+    p_adc->SQR1 &= ~ADC_SQR1_L;
+    p_adc->SQR3 = (p_adc->SQR3 & ~ADC_SQR3_SQ1) | (STM32F4_TEMPERATURE_ADC_CHANNEL << ADC_SQR3_SQ1_Pos);
+#if STM32F4_TEMPERATURE_ADC_CHANNEL >= STM32F4_ADC_SMPR1_FIRST_CHANNEL
+    p_adc->SMPR1 |= STM32F4_ADC_SMP_480_CYCLES << ((STM32F4_TEMPERATURE_ADC_CHANNEL - STM32F4_ADC_SMPR1_FIRST_CHANNEL) * STM32F4_ADC_SMP_BITS);
+#else
+    p_adc->SMPR2 |= STM32F4_ADC_SMP_480_CYCLES << (STM32F4_TEMPERATURE_ADC_CHANNEL * STM32F4_ADC_SMP_BITS);
+#endif
+    p_adc->CR2 |= ADC_CR2_ADON;
+}
+
+void port_temperature_start_conversion(void)
+{
+    ADC_TypeDef *p_adc = STM32F4_TEMPERATURE_ADC;
+    p_adc->SR &= ~ADC_SR_EOC;
+    p_adc->CR2 |= ADC_CR2_SWSTART;
+}
+
+bool port_temperature_get_conversion(int32_t *p_temperature_dc)
+{
+    ADC_TypeDef *p_adc = STM32F4_TEMPERATURE_ADC;
+    if (!(p_adc->SR & ADC_SR_EOC))
+    {
+        return false;
+    }
+    int32_t raw = (int32_t)(p_adc->DR & STM32F4_TEMPERATURE_ADC_MAX); // The read clears the end of conversion
+#ifdef USE_EXTERNAL_TEMPERATURE
+    // 10 mV per ºC is 1 mV per tenth of ºC
+    *p_temperature_dc = raw * STM32F4_TEMPERATURE_VDDA_MV / STM32F4_TEMPERATURE_ADC_MAX - STM32F4_TEMPERATURE_EXTERNAL_OFFSET_MV;
+#else
+    // Line through the two factory readings
+    int32_t cal1 = *STM32F4_TEMPERATURE_TS_CAL1;
+    int32_t cal2 = *STM32F4_TEMPERATURE_TS_CAL2;
+    if (cal2 <= cal1)
+    {
+        return false;
+    }
+    *p_temperature_dc = STM32F4_TEMPERATURE_TS_CAL1_DC + (raw - cal1) * (STM32F4_TEMPERATURE_TS_CAL2_DC - STM32F4_TEMPERATURE_TS_CAL1_DC) / (cal2 - cal1);
+#endif
+    return true;
+}
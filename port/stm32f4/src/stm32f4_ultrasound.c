@@ -34,6 +34,14 @@ typedef struct
     uint32_t echo_init_tick; /*!<Initial tick of the echo signal*/
     uint32_t echo_end_tick;    /*!<End tick of the echo signal*/
     uint32_t echo_overflows; /*!<Number of overflows of the echo signal*/
+    uint32_t echo_end_time_us; /*!<Time of the falling edge of the echo signal, in microseconds*/
+    uint32_t max_echoes; /*!<Number of echoes captured in each ping*/
+    uint32_t ping_max_echoes; /*!<Number of echoes captured in the current ping, fixed at its first edge*/
+    uint32_t num_edges; /*!<Number of edges of the echo signal captured in the current ping*/
+    uint32_t num_echoes; /*!<Number of echoes captured in the current ping*/
+    uint32_t echo_widths_us[PORT_ULTRASOUND_MAX_ECHOES]; /*!<Time of flight of each echo captured in the current ping, in microseconds*/
+    bool echo_window_over; /*!<Flag to indicate that the window of the echoes of the current ping is over*/
+    bool echo_done; /*!<Flag to indicate that the current ping has ended, so that its later edges are not taken as a new one*/
 } stm32f4_ultrasound_hw_t;
 
 /* Global variables */
@@ -54,9 +62,13 @@ stm32f4_ultrasound_hw_t ultrasounds_arr[] = {
         .echo_received = false, 
         .echo_init_tick = 0, 
         .echo_end_tick = 0, 
-        .echo_overflows = 0},
+        .echo_overflows = 0,
+        .echo_end_time_us = 0,
+        .max_echoes = 1},
 };
 
+static uint32_t measurement_period_ms = PORT_PARKING_SENSOR_TIMEOUT_MS; /*!< Period of the timer used for the measurements */
+
 /* Private functions ----------------------------------------------------------*/
 
 /**
@@ -136,18 +148,13 @@ static void _timer_echo_setup(uint32_t ultrasound_id) {
 }
 
 /**
- * @brief Configures the timer used for the measurements.
+ * @brief Sets the prescaler and the auto-reload value of the timer used for the measurements. Both are preloaded, so a running timer keeps its period until its next update.
+ *
+ * @param period_ms Period of the timer in milliseconds.
  */
-void _timer_new_measurement_setup(){
-    // Enable the timer clock
-    RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
-    // Disable the timer
-    TIM5->CR1 &= ~TIM_CR1_CEN;
-    // Enable the auto-reload preload
-    TIM5->CR1 |= TIM_CR1_ARPE;
-    //PS and ARR
+static void _timer_new_measurement_set_period(uint32_t period_ms){
     double system_core_clock = (double)SystemCoreClock;
-    double desired_duration_ms = (double) PORT_PARKING_SENSOR_TIMEOUT_MS/1000; 
+    double desired_duration_ms = (double) period_ms/1000; 
     double max_arr = 65535.0;
     double psc = round(system_core_clock*(desired_duration_ms) / (max_arr + 1.0) - 1.0); // 10 Hz for 100 ms period
     double arr = round(system_core_clock*desired_duration_ms/(psc+1.0)-1.0);
@@ -158,6 +165,20 @@ void _timer_new_measurement_setup(){
     }
     TIM5->PSC = (uint32_t)psc;
     TIM5->ARR = (uint32_t)arr;
+}
+
+/**
+ * @brief Configures the timer used for the measurements.
+ */
+void _timer_new_measurement_setup(){
+    // Enable the timer clock
+    RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
+    // Disable the timer
+    TIM5->CR1 &= ~TIM_CR1_CEN;
+    // Enable the auto-reload preload
+    TIM5->CR1 |= TIM_CR1_ARPE;
+    //PS and ARR
+    _timer_new_measurement_set_period(measurement_period_ms);
     // Generate an update event to update the prescaler value
     TIM5->EGR |= TIM_EGR_UG;
     // Clear the update interrupt flag
@@ -188,6 +209,32 @@ stm32f4_ultrasound_hw_t *_stm32f4_ultrasound_get(uint32_t ultrasound_id)
 }
 
 
+/**
+ * @brief Ends the current ping: the echoes captured are ready for the FSM.
+ * 
+ * @param p_ultrasound Pointer to the ultrasound sensor.
+ */
+static void _echo_done(stm32f4_ultrasound_hw_t *p_ultrasound)
+{
+    TIM2->DIER &= ~TIM_DIER_CC3IE;
+    p_ultrasound->echo_done = true;
+    port_system_probe_pin_write(true);
+    p_ultrasound->echo_received = true;
+}
+
+/**
+ * @brief Clears the edges and the echoes of the current ping, and disables the end of its window.
+ * 
+ * @param p_ultrasound Pointer to the ultrasound sensor.
+ */
+static void _echo_clear(stm32f4_ultrasound_hw_t *p_ultrasound)
+{
+    TIM2->DIER &= ~TIM_DIER_CC3IE;
+    p_ultrasound->num_edges = 0;
+    p_ultrasound->num_echoes = 0;
+    p_ultrasound->echo_window_over = false;
+}
+
 /* Public functions -----------------------------------------------------------*/
 void port_ultrasound_init(uint32_t ultrasound_id)
 {
@@ -207,6 +254,8 @@ void port_ultrasound_init(uint32_t ultrasound_id)
     p_ultrasound->echo_init_tick = 0;
     p_ultrasound->echo_end_tick = 0;
     p_ultrasound->echo_overflows = 0;
+    _echo_clear(p_ultrasound);
+    p_ultrasound->echo_done = false;
     p_ultrasound->trigger_ready = true;
     p_ultrasound->trigger_end = false;
     p_ultrasound->echo_received = false;
@@ -265,6 +314,7 @@ void port_ultrasound_reset_echo_ticks(uint32_t 	ultrasound_id){
     _stm32f4_ultrasound_get(ultrasound_id)->echo_end_tick = 0;
     _stm32f4_ultrasound_get(ultrasound_id)->echo_overflows = 0;
     _stm32f4_ultrasound_get(ultrasound_id)->echo_received = false;
+    _echo_clear(_stm32f4_ultrasound_get(ultrasound_id));
 }
 
 
@@ -288,11 +338,24 @@ void port_ultrasound_set_echo_received(uint32_t ultrasound_id, bool echo_receive
 }	
 
 
+uint32_t port_ultrasound_get_echo_end_time_us(uint32_t ultrasound_id){
+    return _stm32f4_ultrasound_get(ultrasound_id)->echo_end_time_us;
+}
+
+
+void port_ultrasound_set_echo_end_time_us(uint32_t ultrasound_id, uint32_t echo_end_time_us){
+    _stm32f4_ultrasound_get(ultrasound_id)->echo_end_time_us = echo_end_time_us;
+}
+
+
 void port_ultrasound_start_measurement(uint32_t ultrasound_id){
     /* Get the ultrasound sensor */
     stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
     /* Reset the flag trigger_ready to indicate that a new measurement has started */
     p_ultrasound->trigger_ready = false;
+    /* The edges of the echo signal belong to this ping from now on */
+    _echo_clear(p_ultrasound);
+    p_ultrasound->echo_done = false;
 
     /* Reset the counters (CNT) of the trigger timer, the echo timer, and the new measurement timer */
     if(ultrasound_id==PORT_REAR_PARKING_SENSOR_ID){
@@ -341,6 +404,36 @@ void port_ultrasound_stop_new_measurement_timer(void){
 }
 
 
+void port_ultrasound_set_measurement_period_ms(uint32_t period_ms){
+    measurement_period_ms = period_ms;
+    _timer_new_measurement_set_period(period_ms);
+}
+
+
+uint32_t port_ultrasound_get_measurement_period_ms(void){
+    return measurement_period_ms;
+}
+
+
+void port_ultrasound_set_max_echoes(uint32_t ultrasound_id, uint32_t max_echoes){
+    if (max_echoes == 0) {
+        max_echoes = 1;
+    }
+    _stm32f4_ultrasound_get(ultrasound_id)->max_echoes = (max_echoes > PORT_ULTRASOUND_MAX_ECHOES) ? PORT_ULTRASOUND_MAX_ECHOES : max_echoes;
+}
+
+
+uint32_t port_ultrasound_get_num_echoes(uint32_t ultrasound_id){
+    return _stm32f4_ultrasound_get(ultrasound_id)->num_echoes;
+}
+
+
+uint32_t port_ultrasound_get_echo_width_us(uint32_t ultrasound_id, uint32_t echo_idx){
+    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
+    return (echo_idx < p_ultrasound->num_echoes) ? p_ultrasound->echo_widths_us[echo_idx] : 0;
+}
+
+
 void port_ultrasound_stop_ultrasound(uint32_t ultrasound_id){
         // Stop the trigger timer
         port_ultrasound_stop_trigger_timer(ultrasound_id);
@@ -368,4 +461,46 @@ void stm32f4_ultrasound_set_new_echo_gpio(uint32_t ultrasound_id, GPIO_TypeDef *
     stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
     p_ultrasound->p_echo_port = p_port;
     p_ultrasound->echo_pin = pin;
-}
\ No newline at end of file
+}
+
+void stm32f4_ultrasound_capture_echo_edge(uint32_t ultrasound_id, uint32_t tick)
+{
+    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
+    if (p_ultrasound->echo_done) {
+        return;
+    }
+    if (p_ultrasound->num_edges == 0) {
+        // Rising edge: the time of flight starts
+        p_ultrasound->echo_init_tick = tick;
+        p_ultrasound->ping_max_echoes = p_ultrasound->max_echoes;
+        if (p_ultrasound->ping_max_echoes > 1) {
+            // The window ends when the counter reaches the compare value of channel 3
+            TIM2->CCR3 = (tick + PORT_ULTRASOUND_ECHO_WINDOW_US) % (TIMER_MAX_ARR + 1);
+            TIM2->SR &= ~TIM_SR_CC3IF;
+            TIM2->DIER |= TIM_DIER_CC3IE;
+        }
+    } else if (p_ultrasound->num_edges % 2 == 1) {
+        // Falling edge: an echo has arrived
+        if (p_ultrasound->num_echoes == 0) {
+            p_ultrasound->echo_end_tick = tick;
+            // Time of the edge: the counter runs at 1 MHz, so the ticks since the capture are microseconds. The time is stored before the flag, so that it is valid as soon as the flag changes
+            p_ultrasound->echo_end_time_us = port_system_get_micros() - (uint16_t)(TIM2->CNT - tick);
+        }
+        p_ultrasound->echo_widths_us[p_ultrasound->num_echoes++] = (uint16_t)(tick - p_ultrasound->echo_init_tick);
+        if ((p_ultrasound->num_echoes >= p_ultrasound->ping_max_echoes) || p_ultrasound->echo_window_over) {
+            _echo_done(p_ultrasound);
+        }
+    }
+    p_ultrasound->num_edges++;
+}
+
+void stm32f4_ultrasound_close_echo_window(uint32_t ultrasound_id)
+{
+    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
+    TIM2->DIER &= ~TIM_DIER_CC3IE;
+    p_ultrasound->echo_window_over = true;
+    // With no echo yet, the ping ends at the first one, however late
+    if (!p_ultrasound->echo_done && (p_ultrasound->num_echoes > 0)) {
+        _echo_done(p_ultrasound);
+    }
+}
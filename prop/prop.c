@@ -0,0 +1,236 @@
+/**
+ * @file prop.c
+ * @brief Minimal property-based testing engine for the host.
+ *
+ * A case is fully described by the sequence of values it draws, so a failure is shrunk by editing that sequence and replaying the property: first deleting chunks of values, then lowering each value, as long as the property still fails. Since a replayed case draws 0 once the sequence is exhausted, deleting values tends to remove whole steps and lowering them tends to select the simplest action of each step.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* Other includes */
+#include "prop.h"
+
+/* Global variables -----------------------------------------------------------*/
+static prop_t candidate; /*!< Case being tried while shrinking */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Returns the next value of a xorshift32 generator.
+ *
+ * @param p_state State of the generator, never 0.
+ *
+ * @return uint32_t Random value.
+ */
+static uint32_t _xorshift32(uint32_t *p_state)
+{
+    uint32_t x = *p_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *p_state = x;
+    return x;
+}
+
+/**
+ * @brief Replays a sequence of values through a property.
+ *
+ * The sequence is truncated to the values actually drawn, so that the unused tail is never kept.
+ *
+ * @param property Property.
+ * @param p_arg Argument of the property.
+ * @param p_prop Case, whose `choices` and `num_choices` hold the sequence.
+ * @param verbose Whether the property prints its messages.
+ *
+ * @return bool `true` if the property fails for the sequence.
+ */
+static bool _replay_fails(prop_property_t property, void *p_arg, prop_t *p_prop, bool verbose)
+{
+    p_prop->next = 0;
+    p_prop->replay = true;
+    p_prop->verbose = verbose;
+    p_prop->message[0] = '\0';
+    bool fails = !property(p_prop, p_arg);
+    if (p_prop->next < p_prop->num_choices)
+    {
+        p_prop->num_choices = p_prop->next;
+    }
+    return fails;
+}
+
+/**
+ * @brief Tries a simpler sequence of values: if it still fails, it becomes the counterexample.
+ *
+ * @param property Property.
+ * @param p_arg Argument of the property.
+ * @param p_best Current counterexample.
+ * @param p_runs Runs spent shrinking, incremented by one.
+ *
+ * @return bool `true` if `candidate` fails and has replaced the counterexample.
+ */
+static bool _try_candidate(prop_property_t property, void *p_arg, prop_t *p_best, uint32_t *p_runs)
+{
+    (*p_runs)++;
+    if (!_replay_fails(property, p_arg, &candidate, false))
+    {
+        return false;
+    }
+    memcpy(p_best->choices, candidate.choices, candidate.num_choices * sizeof(uint32_t));
+    p_best->num_choices = candidate.num_choices;
+    memcpy(p_best->message, candidate.message, sizeof(p_best->message));
+    return true;
+}
+
+/**
+ * @brief Shrinks a failing case to a minimal one.
+ *
+ * @param property Property.
+ * @param p_arg Argument of the property.
+ * @param p_best Failing case, replaced by the minimal one.
+ * @param max_runs Maximum number of runs.
+ *
+ * @return uint32_t Number of runs spent.
+ */
+static uint32_t _shrink(prop_property_t property, void *p_arg, prop_t *p_best, uint32_t max_runs)
+{
+    uint32_t runs = 0;
+    bool improved = true;
+    while (improved && runs < max_runs)
+    {
+        improved = false;
+
+        // Delete chunks of values, largest first and from the end, where the values matter least
+        for (uint32_t chunk = 8; chunk > 0 && runs < max_runs; chunk /= 2)
+        {
+            for (uint32_t i = p_best->num_choices; i >= chunk && runs < max_runs; i--)
+            {
+                uint32_t start = i - chunk;
+                if (start + chunk > p_best->num_choices)
+                {
+                    continue;
+                }
+                memcpy(candidate.choices, p_best->choices, start * sizeof(uint32_t));
+                memcpy(&candidate.choices[start], &p_best->choices[start + chunk], (p_best->num_choices - start - chunk) * sizeof(uint32_t));
+                candidate.num_choices = p_best->num_choices - chunk;
+                improved |= _try_candidate(property, p_arg, p_best, &runs);
+            }
+        }
+
+        // Lower every value, by binary search of the lowest one that still fails
+        for (uint32_t i = 0; i < p_best->num_choices && runs < max_runs; i++)
+        {
+            uint32_t low = 0;
+            uint32_t high = p_best->choices[i];
+            while (low < high && runs < max_runs && i < p_best->num_choices)
+            {
+                uint32_t mid = low + (high - low) / 2;
+                memcpy(candidate.choices, p_best->choices, p_best->num_choices * sizeof(uint32_t));
+                candidate.num_choices = p_best->num_choices;
+                candidate.choices[i] = mid;
+                if (_try_candidate(property, p_arg, p_best, &runs))
+                {
+                    improved = true;
+                    high = mid;
+                }
+                else
+                {
+                    low = mid + 1;
+                }
+            }
+        }
+    }
+    return runs;
+}
+
+/* Public functions -----------------------------------------------------------*/
+uint32_t prop_draw(prop_t *p_prop, uint32_t max)
+{
+    uint32_t value;
+    if (p_prop->replay)
+    {
+        value = (p_prop->next < p_prop->num_choices) ? p_prop->choices[p_prop->next] : 0;
+        if (value > max)
+        {
+            value = max;
+        }
+    }
+    else
+    {
+        value = (max == UINT32_MAX) ? _xorshift32(&p_prop->rng) : _xorshift32(&p_prop->rng) % (max + 1);
+        if (p_prop->next < PROP_MAX_CHOICES)
+        {
+            p_prop->choices[p_prop->next] = value;
+            p_prop->num_choices = p_prop->next + 1;
+        }
+        else
+        {
+            value = 0;
+        }
+    }
+    p_prop->next++;
+    return value;
+}
+
+void prop_log(prop_t *p_prop, const char *p_format, ...)
+{
+    if (!p_prop->verbose)
+    {
+        return;
+    }
+    va_list args;
+    va_start(args, p_format);
+    vfprintf(stderr, p_format, args);
+    va_end(args);
+}
+
+bool prop_fail(prop_t *p_prop, const char *p_format, ...)
+{
+    va_list args;
+    va_start(args, p_format);
+    vsnprintf(p_prop->message, sizeof(p_prop->message), p_format, args);
+    va_end(args);
+    return false;
+}
+
+bool prop_check(const char *p_name, prop_property_t property, void *p_arg, const prop_config_t *p_config, prop_t *p_counterexample)
+{
+    for (uint32_t i = 0; i < p_config->num_cases; i++)
+    {
+        p_counterexample->next = 0;
+        p_counterexample->num_choices = 0;
+        p_counterexample->replay = false;
+        p_counterexample->verbose = false;
+        p_counterexample->message[0] = '\0';
+        // Every case has its own seed, so that a failure can be reproduced alone
+        p_counterexample->rng = (p_config->seed + i) * 2654435761u;
+        if (p_counterexample->rng == 0)
+        {
+            p_counterexample->rng = 1;
+        }
+        if (property(p_counterexample, p_arg))
+        {
+            continue;
+        }
+
+        uint32_t num_choices = p_counterexample->num_choices;
+        uint32_t runs = _shrink(property, p_arg, p_counterexample, p_config->max_shrinks);
+        fprintf(stderr, "[PROP] %s: FAILED at case %lu (seed %lu), shrunk from %lu to %lu values in %lu runs\n", p_name, (unsigned long)i, (unsigned long)p_config->seed, (unsigned long)num_choices, (unsigned long)p_counterexample->num_choices, (unsigned long)runs);
+        _replay_fails(property, p_arg, p_counterexample, true);
+        fprintf(stderr, "[PROP] %s: values", p_name);
+        for (uint32_t j = 0; j < p_counterexample->num_choices; j++)
+        {
+            fprintf(stderr, " %lu", (unsigned long)p_counterexample->choices[j]);
+        }
+        fprintf(stderr, "\n[PROP] %s: %s\n", p_name, p_counterexample->message);
+        return false;
+    }
+    fprintf(stderr, "[PROP] %s: passed %lu cases\n", p_name, (unsigned long)p_config->num_cases);
+    return true;
+}
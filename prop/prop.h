@@ -0,0 +1,118 @@
+/**
+ * @file prop.h
+ * @brief Header for prop.c file.
+ *
+ * Minimal property-based testing engine for the host. A property is a function that draws every random value it needs with `prop_draw()` and returns whether it holds. The engine runs it over many random cases, and when one fails it shrinks the sequence of drawn values to a minimal one that still fails, so the counterexample is as short and as simple as possible.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef PROP_H_
+#define PROP_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PROP_MAX_CHOICES 4096   /*!< Maximum number of values drawn by a case. Further draws return 0 */
+#define PROP_MAX_MESSAGE 256    /*!< Maximum length of the failure message, including the terminator */
+#define PROP_DEFAULT_NUM_CASES 1000 /*!< Default number of random cases */
+#define PROP_DEFAULT_MAX_SHRINKS 20000 /*!< Default maximum number of runs spent shrinking a failure */
+
+/**
+ * @brief Checks a condition of a property. If it does not hold, it records the failure and returns `false` from the property.
+ */
+#define PROP_ASSERT(p_prop, condition)                                                       \
+    do                                                                                       \
+    {                                                                                        \
+        if (!(condition))                                                                    \
+        {                                                                                    \
+            return prop_fail((p_prop), "%s:%d: %s", __FILE__, __LINE__, #condition);         \
+        }                                                                                    \
+    } while (0)
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing a case of a property: the values it draws and the result.
+ */
+typedef struct
+{
+    uint32_t choices[PROP_MAX_CHOICES]; /*!< Values drawn by the case, in order */
+    uint32_t num_choices;               /*!< Number of values recorded (random cases) or available (replayed cases) */
+    uint32_t next;                      /*!< Index of the next value to draw */
+    bool replay;                        /*!< The values are replayed from `choices` instead of drawn at random */
+    bool verbose;                       /*!< `prop_log()` prints its messages */
+    uint32_t rng;                       /*!< State of the random number generator */
+    char message[PROP_MAX_MESSAGE];     /*!< Message of the failure */
+} prop_t;
+
+/**
+ * @brief Property under test.
+ *
+ * @param p_prop Case, to draw values from.
+ * @param p_arg Argument given to `prop_check()`.
+ *
+ * @return `true` if the property holds for the case, `false` otherwise (see `prop_fail()`).
+ */
+typedef bool (*prop_property_t)(prop_t *p_prop, void *p_arg);
+
+/**
+ * @brief Structure representing the configuration of a check.
+ */
+typedef struct
+{
+    uint32_t seed;        /*!< Seed of the random cases */
+    uint32_t num_cases;   /*!< Number of random cases */
+    uint32_t max_shrinks; /*!< Maximum number of runs spent shrinking a failure */
+} prop_config_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Draws a value of a case. Random cases draw it uniformly; replayed cases take the next value of the sequence, limited to `max`, or 0 once the sequence is exhausted, so 0 must be the simplest value for the property.
+ *
+ * @param p_prop Case.
+ * @param max Maximum value.
+ *
+ * @return uint32_t Value in [0, `max`].
+ */
+uint32_t prop_draw(prop_t *p_prop, uint32_t max);
+
+/**
+ * @brief Prints a message of the property on the standard error, only when the case is replayed to report a failure.
+ *
+ * @param p_prop Case.
+ * @param p_format Format of the message, as in `printf()`.
+ */
+void prop_log(prop_t *p_prop, const char *p_format, ...);
+
+/**
+ * @brief Records the failure of a property.
+ *
+ * @param p_prop Case.
+ * @param p_format Format of the message, as in `printf()`.
+ *
+ * @return bool Always `false`, so that the property can return it.
+ */
+bool prop_fail(prop_t *p_prop, const char *p_format, ...);
+
+/**
+ * @brief Checks a property over random cases and shrinks the first failure.
+ *
+ * On failure it prints the minimal counterexample on the standard error: the property is replayed verbosely with the shrunk values, followed by the values themselves and the failure message.
+ *
+ * @param p_name Name of the property.
+ * @param property Property.
+ * @param p_arg Argument of the property.
+ * @param p_config Configuration of the check.
+ * @param p_counterexample Destination of the minimal counterexample. It is large, so it should not be on the stack.
+ *
+ * @retval true if the property holds for every case.
+ * @retval false if it fails; `p_counterexample` holds the minimal failing case.
+ */
+bool prop_check(const char *p_name, prop_property_t property, void *p_arg, const prop_config_t *p_config, prop_t *p_counterexample);
+
+#endif /* PROP_H_ */
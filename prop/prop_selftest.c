@@ -0,0 +1,86 @@
+/**
+ * @file prop_selftest.c
+ * @brief Test of the property-based testing engine: a property with a known minimal counterexample must be shrunk to it.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Other includes */
+#include "prop.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define PROP_SELFTEST_MAX_VALUES 20  /*!< Maximum number of values of a case */
+#define PROP_SELFTEST_MAX_VALUE 1000 /*!< Maximum value */
+#define PROP_SELFTEST_LIMIT 500      /*!< Values below it hold the property */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Property that fails as soon as a value reaches the limit. Its minimal counterexample is a single value equal to the limit.
+ *
+ * @param p_prop Case.
+ * @param p_arg Unused.
+ *
+ * @return `true` if every value is below the limit.
+ */
+static bool _property_below_limit(prop_t *p_prop, void *p_arg)
+{
+    uint32_t num_values = prop_draw(p_prop, PROP_SELFTEST_MAX_VALUES);
+    for (uint32_t i = 0; i < num_values; i++)
+    {
+        uint32_t value = prop_draw(p_prop, PROP_SELFTEST_MAX_VALUE);
+        prop_log(p_prop, "value %lu\n", (unsigned long)value);
+        PROP_ASSERT(p_prop, value < PROP_SELFTEST_LIMIT);
+    }
+    return true;
+}
+
+/**
+ * @brief Property that always holds: the engine must not report a failure.
+ *
+ * @param p_prop Case.
+ * @param p_arg Unused.
+ *
+ * @return Always `true`.
+ */
+static bool _property_sorted(prop_t *p_prop, void *p_arg)
+{
+    uint32_t low = prop_draw(p_prop, PROP_SELFTEST_MAX_VALUE);
+    uint32_t high = low + prop_draw(p_prop, PROP_SELFTEST_MAX_VALUE);
+    PROP_ASSERT(p_prop, low <= high);
+    return true;
+}
+
+/**
+ * @brief Tests the engine.
+ *
+ * @return int 0 if the engine finds and shrinks the counterexample, 1 otherwise.
+ */
+int main(void)
+{
+    static prop_t counterexample;
+    prop_config_t config = {.seed = 1, .num_cases = PROP_DEFAULT_NUM_CASES, .max_shrinks = PROP_DEFAULT_MAX_SHRINKS};
+
+    if (!prop_check("sorted", _property_sorted, NULL, &config, &counterexample))
+    {
+        return 1;
+    }
+    if (prop_check("below_limit", _property_below_limit, NULL, &config, &counterexample))
+    {
+        fprintf(stderr, "[PROP] selftest: the counterexample has not been found\n");
+        return 1;
+    }
+    if (counterexample.num_choices != 2 || counterexample.choices[0] != 1 || counterexample.choices[1] != PROP_SELFTEST_LIMIT)
+    {
+        fprintf(stderr, "[PROP] selftest: the counterexample has not been shrunk to the minimal one\n");
+        return 1;
+    }
+    fprintf(stderr, "[PROP] selftest: passed\n");
+    return 0;
+}
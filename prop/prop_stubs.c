@@ -0,0 +1,266 @@
+/**
+ * @file prop_stubs.c
+ * @brief Stubs of the sub-FSMs and of the system port used by the Urbanite FSM.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* HW dependent includes */
+#include "port_system.h"
+
+/* Other includes */
+#include "prop_stubs.h"
+#include "flash_log.h"
+
+/* Global variables -----------------------------------------------------------*/
+static fsm_button_t button;         /*!< Stubbed button FSM */
+static fsm_ultrasound_t ultrasound; /*!< Stubbed rear ultrasound FSM */
+static fsm_display_t display;       /*!< Stubbed rear display FSM */
+static fsm_buzzer_t buzzer;         /*!< Stubbed rear buzzer FSM */
+static uint32_t millis;             /*!< Stubbed system time in ms */
+static uint32_t num_sleeps;         /*!< Number of calls to `port_system_sleep()` */
+
+/* Stub control functions -----------------------------------------------------*/
+void prop_stubs_reset(void)
+{
+    button = (fsm_button_t){.event_count = 0};
+    ultrasound = (fsm_ultrasound_t){.status = false};
+    display = (fsm_display_t){.status = false};
+    buzzer = (fsm_buzzer_t){.status = false};
+    millis = 0;
+    num_sleeps = 0;
+}
+
+fsm_button_t *prop_stubs_get_button(void)
+{
+    return &button;
+}
+
+fsm_ultrasound_t *prop_stubs_get_ultrasound(void)
+{
+    return &ultrasound;
+}
+
+fsm_display_t *prop_stubs_get_display(void)
+{
+    return &display;
+}
+
+fsm_buzzer_t *prop_stubs_get_buzzer(void)
+{
+    return &buzzer;
+}
+
+void prop_stubs_push_gesture(uint8_t gesture, uint32_t duration_ms)
+{
+    if (button.event_count == FSM_BUTTON_EVENT_QUEUE_SIZE)
+    {
+        return;
+    }
+    uint32_t tail = (button.event_head + button.event_count) % FSM_BUTTON_EVENT_QUEUE_SIZE;
+    button.events[tail] = (fsm_button_event_t){.gesture = gesture, .timestamp_ms = millis, .duration_ms = duration_ms};
+    button.event_count++;
+}
+
+uint32_t prop_stubs_get_num_sleeps(void)
+{
+    return num_sleeps;
+}
+
+void prop_stubs_advance_millis(uint32_t ms)
+{
+    millis += ms;
+}
+
+/* Stubbed system port --------------------------------------------------------*/
+uint32_t port_system_get_millis(void)
+{
+    return millis;
+}
+
+void port_system_sleep(void)
+{
+    num_sleeps++;
+}
+
+void port_system_power_stop(void)
+{
+    num_sleeps++;
+}
+
+void port_system_power_sleep(void)
+{
+    num_sleeps++;
+}
+
+uint64_t port_system_get_power_clock_us(void)
+{
+    return (uint64_t)millis * 1000U;
+}
+
+void port_system_probe_pin_write(bool high)
+{
+}
+
+/* Stubbed button FSM ---------------------------------------------------------*/
+bool fsm_button_check_activity(fsm_button_t *p_fsm)
+{
+    return p_fsm->pressed || (p_fsm->event_count > 0);
+}
+
+void fsm_button_set_gesture_times(fsm_button_t *p_fsm, uint32_t long_press_ms, uint32_t double_click_ms, uint32_t repeat_ms)
+{
+    p_fsm->long_press_ms = long_press_ms;
+}
+
+const fsm_button_event_t *fsm_button_peek_event(fsm_button_t *p_fsm)
+{
+    return (p_fsm->event_count > 0) ? &p_fsm->events[p_fsm->event_head] : NULL;
+}
+
+bool fsm_button_get_event(fsm_button_t *p_fsm, fsm_button_event_t *p_event)
+{
+    if (p_fsm->event_count == 0)
+    {
+        return false;
+    }
+    if (p_event != NULL)
+    {
+        *p_event = p_fsm->events[p_fsm->event_head];
+    }
+    p_fsm->event_head = (p_fsm->event_head + 1) % FSM_BUTTON_EVENT_QUEUE_SIZE;
+    p_fsm->event_count--;
+    return true;
+}
+
+/* Stubbed ultrasound FSM -----------------------------------------------------*/
+uint32_t fsm_ultrasound_get_distance(fsm_ultrasound_t *p_fsm)
+{
+    p_fsm->new_measurement = false;
+    return p_fsm->distance_cm;
+}
+
+uint32_t fsm_ultrasound_get_distance_time_us(fsm_ultrasound_t *p_fsm)
+{
+    return millis * 1000U;
+}
+
+bool fsm_ultrasound_get_new_measurement_ready(fsm_ultrasound_t *p_fsm)
+{
+    return p_fsm->new_measurement;
+}
+
+void fsm_ultrasound_start(fsm_ultrasound_t *p_fsm)
+{
+    p_fsm->status = true;
+}
+
+void fsm_ultrasound_stop(fsm_ultrasound_t *p_fsm)
+{
+    p_fsm->status = false;
+}
+
+bool fsm_ultrasound_check_activity(fsm_ultrasound_t *p_fsm)
+{
+    return false;
+}
+
+uint32_t fsm_ultrasound_get_echoes(fsm_ultrasound_t *p_fsm, uint32_t *p_distances_cm, uint32_t max_distances)
+{
+    if (max_distances == 0)
+    {
+        return 0;
+    }
+    p_distances_cm[0] = p_fsm->distance_cm;
+    return 1;
+}
+
+uint32_t fsm_ultrasound_get_echo_range(fsm_ultrasound_t *p_fsm)
+{
+    return UINT32_MAX;
+}
+
+/* Stubbed display FSM --------------------------------------------------------*/
+void fsm_display_set_distance(fsm_display_t *p_fsm, uint32_t distance_cm)
+{
+    p_fsm->distance_cm = distance_cm;
+    p_fsm->busy = true;
+}
+
+void fsm_display_set_distance_time_us(fsm_display_t *p_fsm, uint32_t echo_time_us)
+{
+}
+
+void fsm_display_set_status(fsm_display_t *p_fsm, bool status)
+{
+    p_fsm->status = status;
+    p_fsm->busy = true;
+}
+
+bool fsm_display_check_activity(fsm_display_t *p_fsm)
+{
+    return p_fsm->status && p_fsm->busy;
+}
+
+bool fsm_display_check_pending_frame(fsm_display_t *p_fsm)
+{
+    return false;
+}
+
+uint8_t fsm_display_get_urgency(fsm_display_t *p_fsm, int32_t distance_cm)
+{
+    return (distance_cm <= PROP_STUBS_DANGER_CM) ? FSM_DISPLAY_URGENCY_DANGER : FSM_DISPLAY_URGENCY_LOW;
+}
+
+/* Stubbed buzzer FSM ---------------------------------------------------------*/
+void fsm_buzzer_set_distance(fsm_buzzer_t *p_fsm, uint32_t distance_cm)
+{
+    p_fsm->distance_cm = distance_cm;
+    p_fsm->busy = true;
+}
+
+void fsm_buzzer_set_status(fsm_buzzer_t *p_fsm, bool status)
+{
+    p_fsm->status = status;
+    p_fsm->busy = true;
+}
+
+bool fsm_buzzer_check_activity(fsm_buzzer_t *p_fsm)
+{
+    return p_fsm->busy;
+}
+
+void fsm_buzzer_set_display(fsm_buzzer_t *p_fsm, fsm_display_t *p_display)
+{
+}
+
+/* The properties are checked without a flash log, so its functions are never called */
+bool flash_log_append(flash_log_t *p_log, uint8_t type, const void *p_payload, uint32_t length)
+{
+    return false;
+}
+
+bool flash_log_flush(flash_log_t *p_log)
+{
+    return false;
+}
+
+void flash_log_set_erase_allowed(flash_log_t *p_log, bool allowed)
+{
+}
+
+bool flash_log_prepare(flash_log_t *p_log)
+{
+    return false;
+}
+
+uint32_t flash_log_get_pending_bytes(const flash_log_t *p_log)
+{
+    return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file prop_stubs.h
+ * @brief Header for prop_stubs.c file.
+ *
+ * Stubs of the sub-FSMs and of the system port used by the Urbanite FSM. They keep only the state that the Urbanite FSM reads or writes, and they honour the contracts of the real FSMs: the button reports activity while it is pressed or has gestures waiting, and the display and the buzzer report activity until they have applied their last change.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+#ifndef PROP_STUBS_H_
+#define PROP_STUBS_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Other includes */
+#include "fsm_button.h"
+#include "fsm_ultrasound.h"
+#include "fsm_display.h"
+#include "fsm_buzzer.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define PROP_STUBS_DANGER_CM 11 /*!< Longest distance of the band of urgency `FSM_DISPLAY_URGENCY_DANGER` of the stubbed display */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Stubbed button FSM: a queue of gestures and whether it is pressed.
+ */
+struct fsm_button_t
+{
+    fsm_button_event_t events[FSM_BUTTON_EVENT_QUEUE_SIZE]; /*!< Gestures waiting to be consumed */
+    uint32_t event_head;                                    /*!< Index of the oldest gesture */
+    uint32_t event_count;                                   /*!< Number of gestures waiting */
+    bool pressed;                                           /*!< The button is pressed */
+    uint32_t long_press_ms;                                 /*!< Long-press time set by the Urbanite FSM */
+};
+
+/**
+ * @brief Stubbed ultrasound FSM: its status and the last measurement.
+ */
+struct fsm_ultrasound_t
+{
+    bool status;          /*!< The sensor is measuring */
+    bool new_measurement; /*!< A measurement is waiting to be read */
+    uint32_t distance_cm; /*!< Last measurement */
+};
+
+/**
+ * @brief Stubbed display FSM: its status, the last distance and whether it is still applying a change.
+ */
+struct fsm_display_t
+{
+    bool status;          /*!< The display is on */
+    uint32_t distance_cm; /*!< Last distance set */
+    bool busy;            /*!< A change has not been applied yet */
+};
+
+/**
+ * @brief Stubbed buzzer FSM: its status, the last distance and whether it is still applying a change.
+ */
+struct fsm_buzzer_t
+{
+    bool status;          /*!< The buzzer is on */
+    uint32_t distance_cm; /*!< Last distance set */
+    bool busy;            /*!< A change has not been applied yet */
+};
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Resets the stubbed sub-FSMs and the stubbed system.
+ */
+void prop_stubs_reset(void);
+
+/**
+ * @brief Returns the stubbed button FSM.
+ *
+ * @return fsm_button_t* Pointer to the button FSM.
+ */
+fsm_button_t *prop_stubs_get_button(void);
+
+/**
+ * @brief Returns the stubbed ultrasound FSM.
+ *
+ * @return fsm_ultrasound_t* Pointer to the ultrasound FSM.
+ */
+fsm_ultrasound_t *prop_stubs_get_ultrasound(void);
+
+/**
+ * @brief Returns the stubbed display FSM.
+ *
+ * @return fsm_display_t* Pointer to the display FSM.
+ */
+fsm_display_t *prop_stubs_get_display(void);
+
+/**
+ * @brief Returns the stubbed buzzer FSM.
+ *
+ * @return fsm_buzzer_t* Pointer to the buzzer FSM.
+ */
+fsm_buzzer_t *prop_stubs_get_buzzer(void);
+
+/**
+ * @brief Queues a gesture of the stubbed button, as the real button FSM does when it recognizes one. The gesture is lost if the queue is full.
+ *
+ * @param gesture Gesture (see `FSM_BUTTON_GESTURES`).
+ * @param duration_ms Time the button has been pressed.
+ */
+void prop_stubs_push_gesture(uint8_t gesture, uint32_t duration_ms);
+
+/**
+ * @brief Returns the number of times the system has been put to sleep since the last reset.
+ *
+ * @return uint32_t Number of calls to `port_system_sleep()`.
+ */
+uint32_t prop_stubs_get_num_sleeps(void);
+
+/**
+ * @brief Advances the stubbed system time.
+ *
+ * @param ms Time to advance, in ms.
+ */
+void prop_stubs_advance_millis(uint32_t ms);
+
+#endif /* PROP_STUBS_H_ */
@@ -0,0 +1,283 @@
+/**
+ * @file prop_urbanite.c
+ * @brief Property-based test of the transitions of the Urbanite FSM.
+ *
+ * The Urbanite FSM runs against stubbed sub-FSMs. Each case is a random sequence of steps, and each step injects one event and fires the FSM once. The events are button gestures of random durations, presses and releases, new measurements, the display or the buzzer finishing their last change, and the passing of time. After every step the FSM is checked against a reference model of the system:
+ *
+ * - The system is on exactly when the model is on: long presses toggle it and are the only gestures that do.
+ * - While off, the ultrasound sensor, the display and the buzzer are stopped; while on, the sensor is measuring.
+ * - The system never sleeps while a sub-FSM is active, nor while on with a measurement waiting.
+ * - A measurement waiting while on is shown within two steps, on the display and on the buzzer; while paused only dangerous distances are shown and the rest switch them off.
+ * - A gesture waiting is consumed within two steps, unless a measurement is shown instead.
+ *
+ * A failure is shrunk to a minimal sequence of steps, which is printed together with the broken property.
+ *
+ * Usage: `prop_urbanite [-s seed] [-n cases]`
+ *
+ * - `-s seed`: seed of the random cases (1 by default).
+ * - `-n cases`: number of random cases (`PROP_DEFAULT_NUM_CASES` by default).
+ *
+ * The messages of the Urbanite FSM are discarded; the report goes to the standard error.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Other includes */
+#include "fsm.h"
+#include "fsm_urbanite.h"
+#include "prop.h"
+#include "prop_stubs.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define PROP_URBANITE_ON_OFF_PRESS_TIME_MS 1000 /*!< Long-press time of the FSM under test, as in `main.c` */
+#define PROP_URBANITE_PAUSE_DISPLAY_TIME_MS 500 /*!< Pause time of the FSM under test, as in `main.c` */
+#define PROP_URBANITE_MAX_STEPS 200             /*!< Maximum number of steps of a case */
+#define PROP_URBANITE_MAX_DISTANCE_CM 300       /*!< Longest distance of a measurement */
+#define PROP_URBANITE_MAX_LATENCY 2             /*!< Maximum number of steps a measurement or a gesture may wait */
+
+/**
+ * @brief Events injected by a step. `STEP_NONE` is 0 because it is the simplest one.
+ */
+enum PROP_URBANITE_STEPS
+{
+    STEP_NONE = 0,    /*!< Only fire the FSM */
+    STEP_CLICK,       /*!< Click of a random duration */
+    STEP_LONG_PRESS,  /*!< Long press */
+    STEP_OTHER,       /*!< Double click or hold-repeat, which are not commands */
+    STEP_PRESS,       /*!< Press or release of the button, with no gesture yet */
+    STEP_MEASUREMENT, /*!< New measurement of a random distance, if the sensor is measuring */
+    STEP_DISPLAY_IDLE, /*!< The display finishes its last change */
+    STEP_BUZZER_IDLE, /*!< The buzzer finishes its last change */
+    STEP_TIME,        /*!< Time passes */
+    NUM_STEPS
+};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Draws the event of a step and injects it into the stubs.
+ *
+ * @param p_prop Case.
+ */
+static void _inject_step(prop_t *p_prop)
+{
+    fsm_button_t *p_button = prop_stubs_get_button();
+    fsm_ultrasound_t *p_ultrasound = prop_stubs_get_ultrasound();
+    uint32_t value;
+    switch (prop_draw(p_prop, NUM_STEPS - 1))
+    {
+    case STEP_CLICK:
+        value = prop_draw(p_prop, 2 * PROP_URBANITE_PAUSE_DISPLAY_TIME_MS);
+        prop_stubs_push_gesture(FSM_BUTTON_GESTURE_CLICK, value);
+        prop_log(p_prop, "click %lu ms", (unsigned long)value);
+        break;
+    case STEP_LONG_PRESS:
+        value = PROP_URBANITE_ON_OFF_PRESS_TIME_MS + prop_draw(p_prop, PROP_URBANITE_ON_OFF_PRESS_TIME_MS);
+        prop_stubs_push_gesture(FSM_BUTTON_GESTURE_LONG_PRESS, value);
+        prop_log(p_prop, "long press %lu ms", (unsigned long)value);
+        break;
+    case STEP_OTHER:
+        value = prop_draw(p_prop, 1) ? FSM_BUTTON_GESTURE_HOLD_REPEAT : FSM_BUTTON_GESTURE_DOUBLE_CLICK;
+        prop_stubs_push_gesture(value, PROP_URBANITE_PAUSE_DISPLAY_TIME_MS);
+        prop_log(p_prop, "%s", (value == FSM_BUTTON_GESTURE_HOLD_REPEAT) ? "hold-repeat" : "double click");
+        break;
+    case STEP_PRESS:
+        p_button->pressed = !p_button->pressed;
+        prop_log(p_prop, "button %s", p_button->pressed ? "pressed" : "released");
+        break;
+    case STEP_MEASUREMENT:
+        // A stopped sensor does not measure
+        value = prop_draw(p_prop, PROP_URBANITE_MAX_DISTANCE_CM);
+        if (p_ultrasound->status)
+        {
+            p_ultrasound->distance_cm = value;
+            p_ultrasound->new_measurement = true;
+        }
+        prop_log(p_prop, "measurement %lu cm%s", (unsigned long)value, p_ultrasound->status ? "" : " (sensor stopped)");
+        break;
+    case STEP_DISPLAY_IDLE:
+        prop_stubs_get_display()->busy = false;
+        prop_log(p_prop, "display idle");
+        break;
+    case STEP_BUZZER_IDLE:
+        prop_stubs_get_buzzer()->busy = false;
+        prop_log(p_prop, "buzzer idle");
+        break;
+    case STEP_TIME:
+        value = prop_draw(p_prop, 1000);
+        prop_stubs_advance_millis(value);
+        prop_log(p_prop, "wait %lu ms", (unsigned long)value);
+        break;
+    default:
+        prop_log(p_prop, "fire");
+        break;
+    }
+}
+
+/**
+ * @brief Runs the steps of a case on the Urbanite FSM and checks them against the model.
+ *
+ * @param p_prop Case.
+ * @param p_fsm Pointer to the Urbanite FSM, just created.
+ *
+ * @return `true` if the FSM behaves as the model for the whole case.
+ */
+static bool _check_steps(prop_t *p_prop, fsm_urbanite_t *p_fsm)
+{
+    static const char *state_names[] = {"OFF", "MEASURE", "SLEEP_WHILE_OFF", "SLEEP_WHILE_ON"};
+    fsm_button_t *p_button = prop_stubs_get_button();
+    fsm_ultrasound_t *p_ultrasound = prop_stubs_get_ultrasound();
+    fsm_display_t *p_display = prop_stubs_get_display();
+    fsm_buzzer_t *p_buzzer = prop_stubs_get_buzzer();
+    fsm_t *p_inner = (fsm_t *)p_fsm;
+
+    // Reference model
+    bool on = false;
+    bool paused = false;
+    uint32_t measurement_wait = 0;
+    uint32_t gesture_wait = 0;
+
+    uint32_t num_steps = prop_draw(p_prop, PROP_URBANITE_MAX_STEPS);
+    for (uint32_t i = 0; i < num_steps; i++)
+    {
+        prop_log(p_prop, "[%3lu] ", (unsigned long)i);
+        _inject_step(p_prop);
+
+        // State of the stubs before firing
+        bool measurement_before = p_ultrasound->new_measurement;
+        uint32_t distance = p_ultrasound->distance_cm;
+        uint32_t num_events_before = p_button->event_count;
+        fsm_button_event_t event = p_button->events[p_button->event_head];
+        uint32_t num_sleeps = prop_stubs_get_num_sleeps();
+        bool active = fsm_button_check_activity(p_button) || fsm_display_check_activity(p_display) || fsm_buzzer_check_activity(p_buzzer);
+
+        fsm_fire(p_inner);
+        int32_t state = p_inner->current_state;
+        prop_log(p_prop, " -> %s\n", (state >= OFF && state <= SLEEP_WHILE_ON) ? state_names[state] : "?");
+
+        PROP_ASSERT(p_prop, state >= OFF && state <= SLEEP_WHILE_ON);
+        PROP_ASSERT(p_prop, p_button->event_count + 1 >= num_events_before);
+
+        // Update the model with the gesture consumed, if any
+        bool consumed = (p_button->event_count < num_events_before);
+        if (consumed && event.gesture == FSM_BUTTON_GESTURE_LONG_PRESS)
+        {
+            on = !on;
+            paused = false;
+        }
+        else if (consumed && on && event.gesture == FSM_BUTTON_GESTURE_CLICK && event.duration_ms > PROP_URBANITE_PAUSE_DISPLAY_TIME_MS)
+        {
+            paused = !paused;
+            PROP_ASSERT(p_prop, p_display->status == !paused && p_buzzer->status == !paused);
+        }
+
+        // On and off
+        PROP_ASSERT(p_prop, on == (state == MEASURE || state == SLEEP_WHILE_ON));
+        if (on)
+        {
+            PROP_ASSERT(p_prop, p_ultrasound->status);
+        }
+        else
+        {
+            PROP_ASSERT(p_prop, !p_ultrasound->status && !p_display->status && !p_buzzer->status);
+        }
+
+        // Sleep
+        if (prop_stubs_get_num_sleeps() > num_sleeps)
+        {
+            PROP_ASSERT(p_prop, !active);
+            PROP_ASSERT(p_prop, !(on && measurement_before));
+        }
+
+        // Measurements
+        bool shown = on && measurement_before && !p_ultrasound->new_measurement;
+        if (shown && (!paused || distance <= PROP_STUBS_DANGER_CM))
+        {
+            PROP_ASSERT(p_prop, p_display->status && p_display->distance_cm == distance);
+            PROP_ASSERT(p_prop, p_buzzer->status && p_buzzer->distance_cm == distance);
+        }
+        else if (shown)
+        {
+            PROP_ASSERT(p_prop, !p_display->status && !p_buzzer->status);
+        }
+        measurement_wait = (on && p_ultrasound->new_measurement) ? measurement_wait + 1 : 0;
+        PROP_ASSERT(p_prop, measurement_wait < PROP_URBANITE_MAX_LATENCY);
+
+        // Gestures
+        gesture_wait = (p_button->event_count > 0 && !consumed && !shown) ? gesture_wait + 1 : 0;
+        PROP_ASSERT(p_prop, gesture_wait < PROP_URBANITE_MAX_LATENCY);
+    }
+    return true;
+}
+
+/**
+ * @brief Property of the transitions of the Urbanite FSM.
+ *
+ * @param p_prop Case.
+ * @param p_arg Unused.
+ *
+ * @return `true` if the FSM behaves as the model for the whole case.
+ */
+static bool _property_urbanite(prop_t *p_prop, void *p_arg)
+{
+    prop_stubs_reset();
+    fsm_urbanite_t *p_fsm = fsm_urbanite_new(prop_stubs_get_button(), PROP_URBANITE_ON_OFF_PRESS_TIME_MS, PROP_URBANITE_PAUSE_DISPLAY_TIME_MS, prop_stubs_get_ultrasound(), prop_stubs_get_display(), prop_stubs_get_buzzer());
+    bool holds = _check_steps(p_prop, p_fsm);
+    fsm_urbanite_destroy(p_fsm);
+    return holds;
+}
+
+/**
+ * @brief Writes the usage of the program.
+ *
+ * @param p_program Name of the program.
+ */
+static void _usage(const char *p_program)
+{
+    fprintf(stderr, "Usage: %s [-s seed] [-n cases]\n", p_program);
+}
+
+/* Public functions -----------------------------------------------------------*/
+/**
+ * @brief Checks the properties of the Urbanite FSM.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ *
+ * @return int 0 if every property holds, 1 if one fails, `EXIT_FAILURE` if the arguments are wrong.
+ */
+int main(int argc, char *argv[])
+{
+    static prop_t counterexample;
+    prop_config_t config = {.seed = 1, .num_cases = PROP_DEFAULT_NUM_CASES, .max_shrinks = PROP_DEFAULT_MAX_SHRINKS};
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            config.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            config.num_cases = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            _usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    // The FSM writes every transition on the standard output, thousands of times per check
+    if (freopen("/dev/null", "w", stdout) == NULL)
+    {
+        perror("/dev/null");
+        return EXIT_FAILURE;
+    }
+    return prop_check("urbanite", _property_urbanite, NULL, &config, &counterexample) ? 0 : 1;
+}
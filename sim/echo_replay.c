@@ -0,0 +1,127 @@
+/**
+ * @file echo_replay.c
+ * @brief Replays an echo trace through the filters of the ultrasound FSM and prints the resulting distances.
+ *
+ * Each raw echo of the trace is handed to the ultrasound FSM as if the echo timer had just captured it, so that `do_set_distance()` computes and filters the distance exactly as on the target. The FSM runs on the native port and the replay runs at full CPU speed.
+ *
+ * Usage: `echo_replay [-r] [-s sensor_id] trace.bin`
+ *
+ * - `-r`: print also every raw echo.
+ * - `-s sensor_id`: replay the echoes of this sensor (0 by default).
+ *
+ * Each line of the output is `<timestamp_ms> distance <cm>` for the distances of the FSM and `<timestamp_ms> echo <init_tick> <end_tick> <overflows>` for the raw echoes.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* HW libraries */
+#include "port_system.h"
+#include "port_ultrasound.h"
+#include "fsm.h"
+#include "fsm_ultrasound.h"
+#include "echo_trace.h"
+
+/* Global variables -----------------------------------------------------------*/
+static echo_trace_t trace; /*!< Trace being replayed */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Writes the usage of the program.
+ *
+ * @param p_program Name of the program.
+ */
+static void _usage(const char *p_program)
+{
+    fprintf(stderr, "Usage: %s [-r] [-s sensor_id] trace.bin\n", p_program);
+}
+
+/**
+ * @brief Replays an echo trace.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ *
+ * @return int 0 on success, `EXIT_FAILURE` if the trace cannot be loaded.
+ */
+int main(int argc, char *argv[])
+{
+    bool raw = false;
+    uint32_t sensor_id = 0;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0)
+        {
+            raw = true;
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            sensor_id = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            _usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - i != 1)
+    {
+        _usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!echo_trace_load(&trace, argv[i]))
+    {
+        fprintf(stderr, "%s: not a valid echo trace\n", argv[i]);
+        return EXIT_FAILURE;
+    }
+
+    // The filters do not depend on the sensor, so every trace is replayed through the rear one
+    port_system_init();
+    fsm_ultrasound_t *p_fsm_ultrasound = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
+    fsm_ultrasound_set_status(p_fsm_ultrasound, true);
+
+    uint32_t num_echoes = 0;
+    uint32_t num_distances = 0;
+    for (uint32_t j = 0; j < echo_trace_get_count(&trace); j++)
+    {
+        const echo_trace_record_t *p_record = echo_trace_get_record(&trace, j);
+        if (p_record->ultrasound_id != sensor_id)
+        {
+            continue;
+        }
+        num_echoes++;
+        if (raw)
+        {
+            printf("%lu echo %u %u %u\n", (unsigned long)p_record->timestamp_ms, p_record->init_tick, p_record->end_tick, p_record->overflows);
+        }
+
+        // Hand the echo to the FSM as the echo timer would
+        port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, p_record->init_tick);
+        port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, p_record->end_tick);
+        port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, p_record->overflows);
+        port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+        port_ultrasound_set_trigger_ready(PORT_REAR_PARKING_SENSOR_ID, false);
+        fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+        fsm_ultrasound_fire(p_fsm_ultrasound);
+
+        if (fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound))
+        {
+            num_distances++;
+            printf("%lu distance %lu\n", (unsigned long)p_record->timestamp_ms, (unsigned long)fsm_ultrasound_get_distance(p_fsm_ultrasound));
+        }
+    }
+    fprintf(stderr, "%lu echoes of sensor %lu, %lu distances\n", (unsigned long)num_echoes, (unsigned long)sensor_id, (unsigned long)num_distances);
+
+    fsm_ultrasound_destroy(p_fsm_ultrasound);
+    return 0;
+}
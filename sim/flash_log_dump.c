@@ -0,0 +1,114 @@
+/**
+ * @file flash_log_dump.c
+ * @brief Decodes a flash log and prints its records.
+ *
+ * The image is loaded into the simulated storage and read with the same reader as on the target, from the oldest record kept to the newest one. It may come from the simulator (`urbanite_sim -f`) or from the reserved sectors of the target (`dump binary memory flash.bin 0x08040000 0x08080000` in GDB).
+ *
+ * Usage: `flash_log_dump [-s] flash.bin`
+ *
+ * - `-s`: print also the headers of the sectors.
+ *
+ * Each line of the output is `<timestamp_ms> distance <distance_cm>` or `<timestamp_ms> event ON|OFF|PAUSE|RESUME` for the records of the Urbanite, `type <type> length <bytes>` for other records, and `sector <n> sequence <sequence> erases <erases>` for the sectors. A summary is written to the standard error.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* HW libraries */
+#include "native_storage.h"
+#include "flash_log.h"
+#include "fsm_urbanite.h"
+
+/* Global variables -----------------------------------------------------------*/
+static flash_log_t flash_log;     /*!< Log being decoded */
+static flash_log_record_t record; /*!< Last record read */
+
+static const char *const event_names[] = {"ON", "OFF", "PAUSE", "RESUME"}; /*!< Names of the events of the Urbanite, as in `FSM_URBANITE_LOG_EVENTS` */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Writes the usage of the program.
+ *
+ * @param p_program Name of the program.
+ */
+static void _usage(const char *p_program)
+{
+    fprintf(stderr, "Usage: %s [-s] flash.bin\n", p_program);
+}
+
+/**
+ * @brief Decodes a flash log.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ *
+ * @return int 0 on success, `EXIT_FAILURE` if the image cannot be loaded or it holds no log.
+ */
+int main(int argc, char *argv[])
+{
+    bool sectors = false;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0)
+        {
+            sectors = true;
+        }
+        else
+        {
+            _usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - i != 1)
+    {
+        _usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    // The image is only loaded, so that the recovery of the log does not change the file
+    if (!native_storage_load_file(argv[i]) || !flash_log_init(&flash_log))
+    {
+        fprintf(stderr, "%s: not an image of %u sectors of %u bytes\n", argv[i], (unsigned)NATIVE_STORAGE_NUM_SECTORS, (unsigned)NATIVE_STORAGE_SECTOR_SIZE);
+        return EXIT_FAILURE;
+    }
+
+    flash_log_iter_t iter;
+    flash_log_iter_init(&iter, &flash_log);
+    uint32_t sequence = 0;
+    uint32_t num_records = 0;
+    while (flash_log_iter_next(&iter, &record))
+    {
+        if (sectors && (num_records == 0 || record.sequence != sequence))
+        {
+            sequence = record.sequence;
+            printf("sector %lu sequence %lu erases %lu\n", (unsigned long)iter.sector, (unsigned long)sequence, (unsigned long)flash_log_get_erase_count(&flash_log, iter.sector));
+        }
+        const fsm_urbanite_log_record_t *p_payload = (const fsm_urbanite_log_record_t *)record.payload;
+        if (record.type == FSM_URBANITE_LOG_DISTANCE && record.length == sizeof(*p_payload))
+        {
+            printf("%lu distance %lu\n", (unsigned long)p_payload->timestamp_ms, (unsigned long)p_payload->value);
+        }
+        else if (record.type == FSM_URBANITE_LOG_EVENT && record.length == sizeof(*p_payload) && p_payload->value < sizeof(event_names) / sizeof(event_names[0]))
+        {
+            printf("%lu event %s\n", (unsigned long)p_payload->timestamp_ms, event_names[p_payload->value]);
+        }
+        else
+        {
+            printf("type %u length %u\n", record.type, record.length);
+        }
+        num_records++;
+    }
+
+    fprintf(stderr, "%lu records, %lu corrupt, active sector %lu (sequence %lu) at offset %lu%s\n", (unsigned long)num_records, (unsigned long)iter.num_corrupt,
+            (unsigned long)flash_log.sector, (unsigned long)flash_log.sequence, (unsigned long)flash_log.offset, flash_log.rotate_pending ? ", full" : "");
+    return 0;
+}
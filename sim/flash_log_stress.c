@@ -0,0 +1,250 @@
+/**
+ * @file flash_log_stress.c
+ * @brief Measures the throughput of a flash log and checks its recovery from power cuts on the simulated storage.
+ *
+ * Records as those of the Urbanite are appended and flushed as the Urbanite does, while the power is cut at a random word in each cycle. After each cut the image is loaded again from its file, as after a power cycle, the log is recovered and every record is read. The check fails if the records read are not in the order they were appended, or if a record whose batch was programmed before the cut is missing (unless its sector has been erased since).
+ *
+ * Usage: `flash_log_stress [-s seed] [-n cycles] [-w words] flash.bin`
+ *
+ * - `-s seed`: seed of the random generator.
+ * - `-n cycles`: number of power cycles (100 by default).
+ * - `-w words`: maximum number of words programmed before each power cut (20000 by default).
+ *
+ * The file is recreated. The throughput, the stalls of the CPU and the wear of the sectors are written to the standard output. The exit code is the number of failed checks.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* HW libraries */
+#include "native_system.h"
+#include "native_storage.h"
+#include "flash_log.h"
+#include "fsm_urbanite.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define STRESS_DEFAULT_CYCLES 100    /*!< Default number of power cycles */
+#define STRESS_DEFAULT_WORDS 20000   /*!< Default maximum number of words programmed before a power cut */
+#define STRESS_PERIOD_MS 50          /*!< Period of the records (20 Hz) */
+
+/* Global variables -----------------------------------------------------------*/
+static flash_log_t flash_log;     /*!< Log under test */
+static flash_log_record_t record; /*!< Last record read */
+static uint8_t *p_acked = NULL;   /*!< For each record appended, whether its batch has been programmed */
+static uint32_t num_failures = 0; /*!< Number of failed checks */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Writes the usage of the program.
+ *
+ * @param p_program Name of the program.
+ */
+static void _usage(const char *p_program)
+{
+    fprintf(stderr, "Usage: %s [-s seed] [-n cycles] [-w words] flash.bin\n", p_program);
+}
+
+/**
+ * @brief Reads every record of the recovered log and checks it against the records appended.
+ *
+ * @param cycle Index of the power cycle.
+ * @param num_appended Number of records appended so far.
+ * @param p_num_corrupt Pointer to the number of corrupt records skipped, which is accumulated.
+ */
+static void _check(uint32_t cycle, uint32_t num_appended, uint32_t *p_num_corrupt)
+{
+    flash_log_iter_t iter;
+    flash_log_iter_init(&iter, &flash_log);
+    bool first = true;
+    uint32_t expected = 0;
+    while (flash_log_iter_next(&iter, &record))
+    {
+        uint32_t index = ((const fsm_urbanite_log_record_t *)record.payload)->value;
+        if (index >= num_appended || (!first && index < expected))
+        {
+            printf("cycle %lu: record %lu out of order\n", (unsigned long)cycle, (unsigned long)index);
+            num_failures++;
+            return;
+        }
+        // Only the oldest sector is erased, so the records missing after the first one read must never have been programmed
+        for (uint32_t i = expected; !first && i < index; i++)
+        {
+            if (p_acked[i])
+            {
+                printf("cycle %lu: record %lu lost\n", (unsigned long)cycle, (unsigned long)i);
+                num_failures++;
+                return;
+            }
+        }
+        first = false;
+        expected = index + 1;
+    }
+    // The newest record programmed must always be kept
+    for (uint32_t i = num_appended; i > expected; i--)
+    {
+        if (p_acked[i - 1])
+        {
+            printf("cycle %lu: record %lu lost\n", (unsigned long)cycle, (unsigned long)(i - 1));
+            num_failures++;
+            return;
+        }
+    }
+    *p_num_corrupt += iter.num_corrupt;
+}
+
+/**
+ * @brief Appends records and flushes them as the Urbanite does until the power is cut.
+ *
+ * @param p_num_appended Pointer to the number of records appended so far, which is updated.
+ * @param p_max_stall_us Pointer to the longest stall of a flush without erase, which is updated.
+ */
+static void _run_until_power_cut(uint32_t *p_num_appended, uint64_t *p_max_stall_us)
+{
+    uint32_t pending_from = *p_num_appended;
+    while (!native_storage_is_power_cut())
+    {
+        uint32_t index = *p_num_appended;
+        fsm_urbanite_log_record_t payload = {.timestamp_ms = index * STRESS_PERIOD_MS, .value = index};
+        uint32_t num_flushes = flash_log.num_flushes;
+        if (!flash_log_append(&flash_log, FSM_URBANITE_LOG_DISTANCE, &payload, sizeof(payload)))
+        {
+            break;
+        }
+        (*p_num_appended)++;
+        if (flash_log.num_flushes != num_flushes)
+        {
+            memset(&p_acked[pending_from], 1, index - pending_from); // The batch before this record has been programmed
+            pending_from = index;
+        }
+
+        if (flash_log_get_pending_bytes(&flash_log) >= FLASH_LOG_BATCH_SIZE / 2)
+        {
+            uint64_t busy_us = native_storage_get_stats()->busy_us;
+            uint32_t num_rotations = flash_log.num_rotations;
+            if (flash_log_flush(&flash_log))
+            {
+                memset(&p_acked[pending_from], 1, *p_num_appended - pending_from);
+                pending_from = *p_num_appended;
+            }
+            uint64_t stall_us = native_storage_get_stats()->busy_us - busy_us;
+            if (flash_log.num_rotations == num_rotations && stall_us > *p_max_stall_us)
+            {
+                *p_max_stall_us = stall_us;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Stresses a flash log.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ *
+ * @return int Number of failed checks, or `EXIT_FAILURE` if the arguments are wrong.
+ */
+int main(int argc, char *argv[])
+{
+    uint32_t seed = NATIVE_SYSTEM_DEFAULT_SEED;
+    uint32_t num_cycles = STRESS_DEFAULT_CYCLES;
+    uint32_t max_words = STRESS_DEFAULT_WORDS;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            num_cycles = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            max_words = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            _usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - i != 1 || max_words == 0)
+    {
+        _usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *p_path = argv[i];
+
+    // Each word programmed appends at most one record
+    p_acked = calloc((size_t)num_cycles * max_words + 1, 1);
+    if (p_acked == NULL)
+    {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+    native_system_reset(seed);
+    remove(p_path);
+
+    uint32_t num_appended = 0;
+    uint32_t num_corrupt = 0;
+    uint32_t num_dropped = 0;
+    uint32_t num_erases = 0;
+    uint32_t num_words = 0;
+    uint64_t busy_us = 0;
+    uint64_t max_stall_us = 0;
+    for (uint32_t cycle = 0; cycle < num_cycles; cycle++)
+    {
+        // Power on: the image is loaded from the file and the log is recovered
+        if (!native_storage_set_file(p_path) || !flash_log_init(&flash_log))
+        {
+            perror(p_path);
+            free(p_acked);
+            return EXIT_FAILURE;
+        }
+        _check(cycle, num_appended, &num_corrupt);
+
+        native_storage_set_power_cut((uint32_t)native_system_random_range(0, (int32_t)max_words - 1));
+        _run_until_power_cut(&num_appended, &max_stall_us);
+
+        const native_storage_stats_t *p_stats = native_storage_get_stats();
+        num_dropped += flash_log.num_dropped + flash_log.batch_records;
+        num_erases += p_stats->num_erases;
+        num_words += p_stats->num_words_programmed;
+        busy_us += p_stats->busy_us;
+    }
+    native_storage_set_file(p_path);
+    flash_log_init(&flash_log);
+    _check(num_cycles, num_appended, &num_corrupt);
+
+    uint32_t min_erases = UINT32_MAX;
+    uint32_t max_erases = 0;
+    for (uint32_t sector = 0; sector < flash_log.num_sectors; sector++)
+    {
+        uint32_t erases = flash_log_get_erase_count(&flash_log, sector);
+        min_erases = (erases < min_erases) ? erases : min_erases;
+        max_erases = (erases > max_erases) ? erases : max_erases;
+    }
+    if (max_erases - min_erases > 1)
+    {
+        printf("sectors erased from %lu to %lu times\n", (unsigned long)min_erases, (unsigned long)max_erases);
+        num_failures++;
+    }
+
+    printf("%lu power cycles, %lu records appended, %lu lost in the batch, %lu torn\n", (unsigned long)num_cycles, (unsigned long)num_appended, (unsigned long)num_dropped, (unsigned long)num_corrupt);
+    printf("%lu words programmed, %lu sectors erased (%lu to %lu per sector)\n", (unsigned long)num_words, (unsigned long)num_erases, (unsigned long)min_erases, (unsigned long)max_erases);
+    printf("stalled %llu ms, %.1f us per record, %llu us per flush at most (without erase)\n", (unsigned long long)(busy_us / 1000),
+           (num_appended > 0) ? (double)busy_us / num_appended : 0.0, (unsigned long long)max_stall_us);
+    printf("%lu failures\n", (unsigned long)num_failures);
+    free(p_acked);
+    return (int)num_failures;
+}
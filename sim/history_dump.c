@@ -0,0 +1,106 @@
+/**
+ * @file history_dump.c
+ * @brief Decodes a distance history and prints its samples.
+ *
+ * The history is read with the same iterator as on the target, from the oldest sample kept to the newest one.
+ *
+ * Usage: `history_dump [-b] history.bin`
+ *
+ * - `-b`: print also the blocks of the history.
+ *
+ * Each line of the output is `<timestamp_ms> <distance_cm>` for the samples and `block <n> <timestamp_ms> <distance_cm> <samples> <bytes>` for the blocks, before their samples. A summary with the size of the history is written to the standard error.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* HW libraries */
+#include "distance_history.h"
+
+/* Global variables -----------------------------------------------------------*/
+static distance_history_t history; /*!< History being decoded */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Writes the usage of the program.
+ *
+ * @param p_program Name of the program.
+ */
+static void _usage(const char *p_program)
+{
+    fprintf(stderr, "Usage: %s [-b] history.bin\n", p_program);
+}
+
+/**
+ * @brief Decodes a distance history.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ *
+ * @return int 0 on success, `EXIT_FAILURE` if the history cannot be loaded or it is corrupt.
+ */
+int main(int argc, char *argv[])
+{
+    bool blocks = false;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-b") == 0)
+        {
+            blocks = true;
+        }
+        else
+        {
+            _usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - i != 1)
+    {
+        _usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!distance_history_load(&history, argv[i]))
+    {
+        fprintf(stderr, "%s: not a valid distance history\n", argv[i]);
+        return EXIT_FAILURE;
+    }
+
+    distance_history_iter_t iter;
+    distance_history_sample_t sample;
+    distance_history_iter_init(&iter, &history);
+    uint32_t block = UINT32_MAX;
+    uint32_t num_samples = 0;
+    while (distance_history_iter_next(&iter, &sample))
+    {
+        // The reader is in the block of the sample, or past the last one for the samples not written to a block yet
+        if (blocks && iter.block != block && iter.block < history.used_blocks)
+        {
+            block = iter.block;
+            const distance_history_block_t *p_block = &history.blocks[block];
+            printf("block %lu %lu %lu %u %u\n", (unsigned long)block, (unsigned long)p_block->timestamp_ms, (unsigned long)p_block->distance_cm, p_block->num_samples, p_block->num_bytes);
+        }
+        printf("%lu %lu\n", (unsigned long)sample.timestamp_ms, (unsigned long)sample.distance_cm);
+        num_samples++;
+    }
+
+    uint32_t count = distance_history_get_count(&history);
+    uint32_t bytes = distance_history_get_bytes_used(&history);
+    fprintf(stderr, "%lu samples of %lu added, %lu bytes in %lu blocks, %.2f bits per sample\n", (unsigned long)num_samples, (unsigned long)history.num_samples,
+            (unsigned long)bytes, (unsigned long)history.used_blocks, (num_samples > 0) ? 8.0 * bytes / num_samples : 0.0);
+    if (num_samples != count)
+    {
+        fprintf(stderr, "%s: corrupt after %lu of %lu samples\n", argv[i], (unsigned long)num_samples, (unsigned long)count);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file telemetry_decode.c
+ * @brief Decodes a telemetry stream and prints its packets.
+ *
+ * The stream is read from a file captured from the UART, from a pseudo-terminal or a serial port (where the packets are printed as they arrive, until the port is closed), or from the standard input. The decoder synchronizes at the first frame delimiter, so the capture may start in the middle of a frame.
+ *
+ * Usage: `telemetry_decode [telemetry.bin]`
+ *
+ * Each line of the output is `<timestamp_ms> <sequence> distance <cm> urbanite <STATE> ultrasound <STATE> display <STATE> buzzer <STATE>` for the status packets, and `<sequence> type <n> length <n>` for the packets of unknown types. The text packets (the replies of the shell) are written as they are. A summary with the packets decoded, the corrupt frames and the packets lost is written to the standard error.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* HW libraries */
+#include "telemetry.h"
+
+/* Private variables ----------------------------------------------------------*/
+static const char *const urbanite_states[] = {"OFF", "MEASURE", "SLEEP_WHILE_OFF", "SLEEP_WHILE_ON"};                          /*!< Names of the states of the Urbanite FSM */
+static const char *const ultrasound_states[] = {"WAIT_START", "TRIGGER_START", "WAIT_ECHO_START", "WAIT_ECHO_END", "SET_DISTANCE"}; /*!< Names of the states of the ultrasound FSM */
+static const char *const display_states[] = {"WAIT_DISPLAY", "SET_DISPLAY"};                                                   /*!< Names of the states of the display FSM */
+static const char *const buzzer_states[] = {"WAIT_BUZZER", "SET_BUZZER"};                                                      /*!< Names of the states of the buzzer FSM */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Writes the usage of the program.
+ *
+ * @param p_program Name of the program.
+ */
+static void _usage(const char *p_program)
+{
+    fprintf(stderr, "Usage: %s [telemetry.bin]\n", p_program);
+}
+
+/**
+ * @brief Returns the name of a state.
+ *
+ * @param p_states Names of the states of the FSM.
+ * @param num_states Number of states of the FSM.
+ * @param state State.
+ *
+ * @return Name of the state, or "?" if it is not known.
+ */
+static const char *_state_name(const char *const *p_states, uint32_t num_states, uint8_t state)
+{
+    return (state < num_states) ? p_states[state] : "?";
+}
+
+/**
+ * @brief Decodes a telemetry stream.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ *
+ * @return int 0 on success, `EXIT_FAILURE` if the stream cannot be read, has no packets, or has corrupt frames or lost packets.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc > 2 || (argc == 2 && argv[1][0] == '-'))
+    {
+        _usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    FILE *p_file = stdin;
+    if (argc == 2 && (p_file = fopen(argv[1], "rb")) == NULL)
+    {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    telemetry_decoder_t decoder;
+    telemetry_packet_t packet;
+    telemetry_status_t status = {0};
+    telemetry_decoder_init(&decoder);
+    int c;
+    while ((c = getc(p_file)) != EOF)
+    {
+        if (!telemetry_decoder_feed(&decoder, (uint8_t)c, &packet))
+        {
+            continue;
+        }
+        if (telemetry_parse_status(&packet, &status))
+        {
+            printf("%lu %u distance %lu urbanite %s ultrasound %s display %s buzzer %s\n", (unsigned long)status.timestamp_ms, packet.sequence, (unsigned long)status.distance_cm,
+                   _state_name(urbanite_states, sizeof(urbanite_states) / sizeof(urbanite_states[0]), status.urbanite_state),
+                   _state_name(ultrasound_states, sizeof(ultrasound_states) / sizeof(ultrasound_states[0]), status.ultrasound_state),
+                   _state_name(display_states, sizeof(display_states) / sizeof(display_states[0]), status.display_state),
+                   _state_name(buzzer_states, sizeof(buzzer_states) / sizeof(buzzer_states[0]), status.buzzer_state));
+        }
+        else if (packet.type == TELEMETRY_PACKET_TEXT)
+        {
+            fwrite(packet.payload, 1, packet.length, stdout);
+        }
+        else
+        {
+            printf("%u type %u length %lu\n", packet.sequence, packet.type, (unsigned long)packet.length);
+        }
+        fflush(stdout); // Follow a live stream
+    }
+    if (p_file != stdin)
+    {
+        fclose(p_file);
+    }
+
+    fprintf(stderr, "%lu packets, %lu corrupt frames, %lu lost, %lu dropped by the sender\n", (unsigned long)decoder.num_packets, (unsigned long)decoder.num_errors,
+            (unsigned long)decoder.num_lost, (unsigned long)status.num_dropped);
+    if (decoder.num_packets == 0 || decoder.num_errors > 0 || decoder.num_lost > 0)
+    {
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
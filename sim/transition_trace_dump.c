@@ -0,0 +1,143 @@
+/**
+ * @file transition_trace_dump.c
+ * @brief Decodes a transition trace and prints the changes of state of the FSMs.
+ *
+ * The trace is read from the oldest record kept to the newest one, as dumped from the no-init RAM of the target or saved by `urbanite_sim -x`.
+ *
+ * Usage: `transition_trace_dump transitions.bin`
+ *
+ * Each line of the output is `<timestamp_ms> +<gap_ms> <fsm> <FROM> -> <TO> (<dwell_ms> ms)` for the transitions, where the gap is the time since the previous record of any FSM and the dwell is the time the FSM spent in `FROM` (`?` if it entered it before the oldest record kept), and `reset` for the resets survived by the trace. A summary is written to the standard error.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* HW libraries */
+#include "transition_trace.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing the names of a type of FSM and of its states.
+ */
+typedef struct
+{
+    const char *p_name;                /*!< Name of the type of FSM */
+    const char *const *p_state_names;  /*!< Names of its states */
+    uint32_t num_states;               /*!< Number of states */
+} fsm_names_t;
+
+/* Global variables -----------------------------------------------------------*/
+static transition_trace_t trace; /*!< Trace being decoded */
+
+static const char *const button_states[] = {"BUTTON_RELEASED", "BUTTON_RELEASED_WAIT", "BUTTON_PRESSED", "BUTTON_PRESSED_WAIT"}; /*!< Names of the states of the button FSM */
+static const char *const ultrasound_states[] = {"WAIT_START", "TRIGGER_START", "WAIT_ECHO_START", "WAIT_ECHO_END", "SET_DISTANCE"}; /*!< Names of the states of the ultrasound FSM */
+static const char *const display_states[] = {"WAIT_DISPLAY", "SET_DISPLAY"}; /*!< Names of the states of the display FSM */
+static const char *const buzzer_states[] = {"WAIT_BUZZER", "SET_BUZZER"}; /*!< Names of the states of the buzzer FSM */
+static const char *const urbanite_states[] = {"OFF", "MEASURE", "SLEEP_WHILE_OFF", "SLEEP_WHILE_ON"}; /*!< Names of the states of the Urbanite FSM */
+
+/**
+ * @brief Names of the FSMs, indexed by `TRANSITION_TRACE_FSMS`.
+ */
+static const fsm_names_t fsm_names[] = {
+    [TRANSITION_TRACE_FSM_BUTTON] = {"button", button_states, sizeof(button_states) / sizeof(button_states[0])},
+    [TRANSITION_TRACE_FSM_ULTRASOUND] = {"ultrasound", ultrasound_states, sizeof(ultrasound_states) / sizeof(ultrasound_states[0])},
+    [TRANSITION_TRACE_FSM_DISPLAY] = {"display", display_states, sizeof(display_states) / sizeof(display_states[0])},
+    [TRANSITION_TRACE_FSM_BUZZER] = {"buzzer", buzzer_states, sizeof(buzzer_states) / sizeof(buzzer_states[0])},
+    [TRANSITION_TRACE_FSM_URBANITE] = {"urbanite", urbanite_states, sizeof(urbanite_states) / sizeof(urbanite_states[0])},
+};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Writes the name of a state, or its number if it is unknown.
+ *
+ * @param p_names Names of the FSM, or NULL if it is unknown.
+ * @param state State.
+ */
+static void _print_state(const fsm_names_t *p_names, uint8_t state)
+{
+    if (p_names != NULL && state < p_names->num_states)
+    {
+        printf("%s", p_names->p_state_names[state]);
+    }
+    else
+    {
+        printf("%u", state);
+    }
+}
+
+/**
+ * @brief Decodes a transition trace.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ *
+ * @return int 0 on success, `EXIT_FAILURE` if the trace cannot be loaded.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s transitions.bin\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!transition_trace_load(&trace, argv[1]))
+    {
+        fprintf(stderr, "%s: not a valid transition trace\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    // Time at which each FSM entered its current state, since the last reset
+    uint32_t entered_ms[256];
+    bool entered[256] = {false};
+    uint32_t last_ms = 0;
+    uint32_t count = transition_trace_get_count(&trace);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const transition_trace_record_t *p_record = transition_trace_get_record(&trace, i);
+        if (p_record->fsm_id == TRANSITION_TRACE_ID_RESET)
+        {
+            // The time of the system restarts at the reset
+            printf("%lu reset\n", (unsigned long)p_record->timestamp_ms);
+            memset(entered, 0, sizeof(entered));
+            last_ms = p_record->timestamp_ms;
+            continue;
+        }
+
+        uint32_t fsm = TRANSITION_TRACE_GET_FSM(p_record->fsm_id);
+        const fsm_names_t *p_names = (fsm < sizeof(fsm_names) / sizeof(fsm_names[0])) ? &fsm_names[fsm] : NULL;
+        printf("%lu +%lu ", (unsigned long)p_record->timestamp_ms, (unsigned long)((i > 0) ? p_record->timestamp_ms - last_ms : 0));
+        if (p_names != NULL)
+        {
+            printf("%s%u ", p_names->p_name, (unsigned)TRANSITION_TRACE_GET_INSTANCE(p_record->fsm_id));
+        }
+        else
+        {
+            printf("fsm%u ", p_record->fsm_id);
+        }
+        _print_state(p_names, p_record->from_state);
+        printf(" -> ");
+        _print_state(p_names, p_record->to_state);
+        if (entered[p_record->fsm_id])
+        {
+            printf(" (%lu ms)\n", (unsigned long)(p_record->timestamp_ms - entered_ms[p_record->fsm_id]));
+        }
+        else
+        {
+            printf(" (? ms)\n");
+        }
+        entered[p_record->fsm_id] = true;
+        entered_ms[p_record->fsm_id] = p_record->timestamp_ms;
+        last_ms = p_record->timestamp_ms;
+    }
+    fprintf(stderr, "%s: %lu records of %u, %lu resets\n", argv[1], (unsigned long)count, (unsigned)trace.max_records, (unsigned long)trace.num_resets);
+    return 0;
+}
@@ -0,0 +1,936 @@
+/**
+ * @file urbanite_sim.c
+ * @brief Runs a scenario of the Urbanite system in the discrete-event simulator of the native platform.
+ *
+ * The FSMs are created and fired exactly as in `main.c`, on top of the simulated port. A scenario script places obstacles, presses the button and checks the state of the system at given times. The timeline of the run (states, distances, colors and beeps) is written to the standard output. The exit code is the number of failed checks, so a scenario can be run as a test.
+ *
+ * Usage: `urbanite_sim [-s seed] [-q] [-v] [-p] [-l] [-r] [-t trace.bin] [-H history.bin] [-f flash.bin] [-T telemetry.bin] [-x transitions.bin] scenario`
+ *
+ * - `-s seed`: seed of the random generator. It overrides the seed of the scenario.
+ * - `-q`: do not write the timeline, only the failed checks and the summary. The messages that the FSMs print are not affected.
+ * - `-v`: write also the states of the sensor, display and buzzer FSMs.
+ * - `-p`: account the time and the energy spent in each state and power mode of the Urbanite, and write them at the end.
+ * - `-l`: measure the latency from each echo of the rear sensor to the color of its distance on the rear display, and write its histogram at the end.
+ * - `-r`: keep the statistics of the pings of the rear sensor, and write them at the end.
+ * - `-t trace.bin`: save the raw echoes of the rear sensor as an echo trace, to be replayed with `echo_replay`.
+ * - `-H history.bin`: save the history of the distances of the rear sensor, to be decoded with `history_dump`.
+ * - `-T telemetry.bin`: send the status of the system through the simulated UART at the period of `main.c`, and write the stream to this file (or pseudo-terminal), to be decoded with `telemetry_decode`.
+ * - `-f flash.bin`: keep the distances and the commands in a flash log on the simulated storage, backed by this file, to be decoded with `flash_log_dump`. The log of previous runs is kept, as across power cycles, and the records pending at the end are programmed.
+ * - `-x transitions.bin`: record the changes of state of all the FSMs in a transition trace, backed by this file, to be decoded with `transition_trace_dump`. The trace of previous runs is kept and the run is marked as a reset, as with the no-init RAM of the target.
+ *
+ * Each line of a scenario is a setting or a command. The times are in milliseconds and `#` starts a comment:
+ *
+ * - `seed <n>`: seed of the random generator.
+ * - `duration <ms>`: length of the simulation.
+ * - `loop <us>`: time consumed by each iteration of the main loop while the system is awake.
+ * - `bounce <max> <us>`: each edge of the button bounces up to `max` times within `us` microseconds.
+ * - `noise <cm>`: maximum error of each echo.
+ * - `temperature <celsius>`: temperature of the air, which sets the speed of sound (20 by default).
+ * - `at <ms> press <hold_ms>`: presses the button and releases it `hold_ms` later.
+ * - `at <ms> obstacle <cm>|none`: places the obstacle, or removes it.
+ * - `at <ms> move <cm> <duration_ms>`: moves the obstacle at a constant speed.
+ * - `at <ms> extra <cm> [<cm>]|none`: places up to two static obstacles besides the moving one, such as a tow bar, or removes them. Each of them sends its own echo.
+ * - `at <ms> temperature <celsius>`: changes the temperature of the air.
+ * - `at <ms> expect urbanite|button|ultrasound|display|buzzer <STATE>`: checks the state of a FSM.
+ * - `at <ms> expect color <r> <g> <b>`: checks the color of the rear display.
+ * - `at <ms> expect distance <cm> [<tolerance_cm>]`: checks the last distance measured by the rear sensor.
+ * - `at <ms> expect beep <period_ms>|off`: checks the cadence of the rear buzzer.
+ * - `at <ms> shell <command line>`: types a command line on the UART of the shell, as in `main.c` with `USE_SHELL`. The replies are sent in the telemetry stream with `-T`, or written to the standard output otherwise.
+ * - `at <ms> expect param <name> <value>`: checks the value of a parameter of the shell.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/* HW libraries */
+#include "port_system.h"
+#include "port_button.h"
+#include "port_ultrasound.h"
+#include "port_display.h"
+#include "port_buzzer.h"
+#include "native_system.h"
+#include "native_button.h"
+#include "native_ultrasound.h"
+#include "native_temperature.h"
+#include "native_display.h"
+#include "native_buzzer.h"
+#include "native_storage.h"
+#include "native_telemetry.h"
+#include "native_shell.h"
+#include "fsm.h"
+#include "fsm_button.h"
+#include "fsm_ultrasound.h"
+#include "fsm_display.h"
+#include "fsm_buzzer.h"
+#include "fsm_urbanite.h"
+#include "echo_trace.h"
+#include "power_stats.h"
+#include "latency_probe.h"
+#include "distance_history.h"
+#include "flash_log.h"
+#include "telemetry.h"
+#include "ranging_stats.h"
+#include "transition_trace.h"
+#include "shell.h"
+#include "urbanite_shell.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define URBANITE_ON_OFF_PRESS_TIME_MS 1000 /*!< Time in milliseconds to toggle the system on/off (as in `main.c`) */
+#define URBANITE_PAUSE_DISPLAY_TIME_MS 500 /*!< Time in milliseconds to pause/resume the display (as in `main.c`) */
+#define URBANITE_TELEMETRY_PERIOD_MS 100 /*!< Period of the status packets of the telemetry (as in `main.c`) */
+
+#define SIM_DEFAULT_DURATION_MS 10000 /*!< Length of a simulation if the scenario does not set it */
+#define SIM_MAX_LINE 256              /*!< Maximum length of a line of a scenario */
+#define SIM_MAX_NAME 16               /*!< Maximum length of the name of a state */
+
+/**
+ * @brief Commands of a scenario.
+ */
+enum SIM_COMMANDS
+{
+    SIM_PRESS = 0,     /*!< Press the button */
+    SIM_RELEASE,       /*!< Release the button */
+    SIM_OBSTACLE,      /*!< Place the obstacle */
+    SIM_MOVE,          /*!< Move the obstacle */
+    SIM_EXTRA,         /*!< Place the static obstacles */
+    SIM_TEMPERATURE,   /*!< Change the temperature of the air */
+    SIM_EXPECT_STATE,  /*!< Check the state of a FSM */
+    SIM_EXPECT_COLOR,  /*!< Check the color of the rear display */
+    SIM_EXPECT_DISTANCE, /*!< Check the last distance */
+    SIM_EXPECT_BEEP,   /*!< Check the cadence of the buzzer */
+    SIM_SHELL,         /*!< Type a command line on the shell */
+    SIM_EXPECT_PARAM   /*!< Check the value of a parameter of the shell */
+};
+
+/**
+ * @brief FSMs whose state is followed by the simulator.
+ */
+enum SIM_FSMS
+{
+    SIM_FSM_URBANITE = 0,
+    SIM_FSM_BUTTON,
+    SIM_FSM_ULTRASOUND,
+    SIM_FSM_DISPLAY,
+    SIM_FSM_BUZZER,
+    SIM_NUM_FSMS
+};
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure representing a command of a scenario.
+ */
+typedef struct
+{
+    uint64_t time_us;  /*!< Time of the command */
+    uint32_t order;    /*!< Order of the command in the script, to keep it among commands of the same time */
+    uint32_t line;     /*!< Line of the command in the script */
+    uint8_t command;   /*!< Command (see `SIM_COMMANDS`) */
+    uint32_t args[3];  /*!< Arguments of the command */
+    char *p_text;      /*!< Text argument of the command (command line or name of a parameter), or NULL */
+} sim_command_t;
+
+/**
+ * @brief Structure representing the settings of a scenario.
+ */
+typedef struct
+{
+    uint32_t seed;            /*!< Seed of the random generator */
+    uint64_t duration_ms;     /*!< Length of the simulation */
+    uint32_t loop_us;         /*!< Time of an iteration of the main loop */
+    uint32_t max_bounces;     /*!< Maximum number of bounces of the button */
+    uint32_t bounce_window_us; /*!< Time during which the button bounces */
+    uint32_t noise_cm;        /*!< Maximum error of each echo */
+    int32_t temperature_dc;   /*!< Temperature of the air, in tenths of ºC */
+} sim_settings_t;
+
+/**
+ * @brief Structure representing a FSM followed by the simulator.
+ */
+typedef struct
+{
+    const char *p_name;        /*!< Name of the FSM in the scenarios and the timeline */
+    const char *const *p_states; /*!< Names of the states */
+    uint32_t num_states;       /*!< Number of states */
+    bool verbose;              /*!< The states are only written in verbose mode */
+    int32_t last_state;        /*!< Last state written in the timeline */
+} sim_fsm_t;
+
+/* Private variables ----------------------------------------------------------*/
+static const char *const urbanite_states[] = {"OFF", "MEASURE", "SLEEP_WHILE_OFF", "SLEEP_WHILE_ON"};                          /*!< Names of the states of the Urbanite FSM */
+static const char *const button_states[] = {"BUTTON_RELEASED", "BUTTON_RELEASED_WAIT", "BUTTON_PRESSED", "BUTTON_PRESSED_WAIT"}; /*!< Names of the states of the button FSM */
+static const char *const ultrasound_states[] = {"WAIT_START", "TRIGGER_START", "WAIT_ECHO_START", "WAIT_ECHO_END", "SET_DISTANCE"}; /*!< Names of the states of the ultrasound FSM */
+static const char *const display_states[] = {"WAIT_DISPLAY", "SET_DISPLAY"};                                                   /*!< Names of the states of the display FSM */
+static const char *const buzzer_states[] = {"WAIT_BUZZER", "SET_BUZZER"};                                                      /*!< Names of the states of the buzzer FSM */
+
+static sim_fsm_t fsms_arr[SIM_NUM_FSMS] = {
+    [SIM_FSM_URBANITE] = {"urbanite", urbanite_states, sizeof(urbanite_states) / sizeof(urbanite_states[0]), false, -1},
+    [SIM_FSM_BUTTON] = {"button", button_states, sizeof(button_states) / sizeof(button_states[0]), false, -1},
+    [SIM_FSM_ULTRASOUND] = {"ultrasound", ultrasound_states, sizeof(ultrasound_states) / sizeof(ultrasound_states[0]), true, -1},
+    [SIM_FSM_DISPLAY] = {"display", display_states, sizeof(display_states) / sizeof(display_states[0]), true, -1},
+    [SIM_FSM_BUZZER] = {"buzzer", buzzer_states, sizeof(buzzer_states) / sizeof(buzzer_states[0]), true, -1},
+}; /*!< FSMs followed by the simulator */
+
+static sim_command_t *p_commands = NULL; /*!< Commands of the scenario, sorted by time */
+static uint32_t num_commands = 0;        /*!< Number of commands of the scenario */
+static uint32_t next_command = 0;        /*!< Index of the next command to run */
+
+static fsm_button_t *p_fsm_button = NULL;         /*!< Button FSM */
+static fsm_ultrasound_t *p_fsm_ultrasound_rear = NULL; /*!< Rear ultrasound FSM */
+static fsm_display_t *p_fsm_display_rear = NULL;  /*!< Rear display FSM */
+static fsm_buzzer_t *p_fsm_buzzer_rear = NULL;    /*!< Rear buzzer FSM */
+static fsm_urbanite_t *p_fsm_urbanite = NULL;     /*!< Urbanite FSM */
+
+static int64_t last_distance_cm = -1; /*!< Last distance of the rear ultrasound FSM written in the timeline */
+static bool verbose = false;          /*!< Write the states of all the FSMs */
+static echo_trace_t rear_echo_trace;  /*!< Raw echoes of the rear sensor (only with `-t`) */
+static power_stats_t urbanite_power_stats; /*!< Power accounting of the Urbanite (only with `-p`) */
+static latency_probe_t rear_latency_probe; /*!< Latencies from the echoes of the rear sensor to the rear display (only with `-l`) */
+static distance_history_t rear_distance_history; /*!< Filtered distances of the rear sensor (only with `-H`) */
+static flash_log_t urbanite_flash_log; /*!< Distances and commands of the Urbanite (only with `-f`) */
+static ranging_stats_t rear_ranging_stats; /*!< Statistics of the pings of the rear sensor (only with `-r`) */
+static telemetry_t urbanite_telemetry; /*!< Stream of the status of the system and of the replies of the shell (only with `-T`) */
+static transition_trace_t urbanite_transition_trace; /*!< Changes of state of all the FSMs (only with `-x`) */
+static shell_t urbanite_shell;         /*!< Command shell of the system */
+static bool quiet = false;            /*!< Write only the failed checks and the summary */
+static uint32_t num_checks = 0;       /*!< Number of checks run */
+static uint32_t num_failures = 0;     /*!< Number of failed checks */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Returns the state of a FSM followed by the simulator.
+ *
+ * @param fsm FSM (see `SIM_FSMS`).
+ *
+ * @return State of the FSM.
+ */
+static uint32_t _get_state(uint32_t fsm)
+{
+    switch (fsm)
+    {
+    case SIM_FSM_URBANITE:
+        return fsm_urbanite_get_state(p_fsm_urbanite);
+    case SIM_FSM_BUTTON:
+        return fsm_button_get_state(p_fsm_button);
+    case SIM_FSM_ULTRASOUND:
+        return fsm_ultrasound_get_state(p_fsm_ultrasound_rear);
+    case SIM_FSM_DISPLAY:
+        return fsm_display_get_state(p_fsm_display_rear);
+    default:
+        return fsm_buzzer_get_state(p_fsm_buzzer_rear);
+    }
+}
+
+/**
+ * @brief Returns the name of a state of a FSM.
+ *
+ * @param fsm FSM (see `SIM_FSMS`).
+ * @param state State.
+ *
+ * @return Name of the state, or "?" if it is not known.
+ */
+static const char *_get_state_name(uint32_t fsm, uint32_t state)
+{
+    return (state < fsms_arr[fsm].num_states) ? fsms_arr[fsm].p_states[state] : "?";
+}
+
+/**
+ * @brief Writes in the timeline the changes of the states of the FSMs and of the distance measured by the rear sensor. It is called after each iteration of the main loop and before each sleep.
+ *
+ * @param p_ctx Not used.
+ */
+static void _observe(void *p_ctx)
+{
+    for (uint32_t fsm = 0; fsm < SIM_NUM_FSMS; fsm++)
+    {
+        int32_t state = (int32_t)_get_state(fsm);
+        if (state != fsms_arr[fsm].last_state)
+        {
+            fsms_arr[fsm].last_state = state;
+            if (verbose || !fsms_arr[fsm].verbose)
+            {
+                native_system_log(fsms_arr[fsm].p_name, "%s", _get_state_name(fsm, state));
+            }
+        }
+    }
+
+    // Reading the distance clears the flag of a new measurement, so it is only read once the Urbanite FSM has consumed it
+    if (fsm_ultrasound_get_status(p_fsm_ultrasound_rear) && !fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound_rear))
+    {
+        int64_t distance_cm = fsm_ultrasound_get_distance(p_fsm_ultrasound_rear);
+        if (distance_cm != last_distance_cm)
+        {
+            last_distance_cm = distance_cm;
+            native_system_log("distance", "%lld cm", (long long)distance_cm);
+        }
+    }
+}
+
+/**
+ * @brief Writes the result of a check in the timeline.
+ *
+ * @param p_command Command of the check.
+ * @param ok Result of the check.
+ * @param p_expected Description of the expected value.
+ * @param p_actual Description of the actual value.
+ */
+static void _report(const sim_command_t *p_command, bool ok, const char *p_expected, const char *p_actual)
+{
+    num_checks++;
+    if (!ok)
+    {
+        num_failures++;
+        if (quiet)
+        {
+            // Failed checks are written even without a timeline
+            native_system_set_timeline(stdout);
+        }
+    }
+    native_system_log("expect", "%s line %lu: %s, got %s", ok ? "ok" : "FAIL", (unsigned long)p_command->line, p_expected, p_actual);
+    if (quiet)
+    {
+        native_system_set_timeline(NULL);
+    }
+}
+
+/**
+ * @brief Runs a command of the scenario.
+ *
+ * @param p_command Command to run.
+ */
+static void _run_command(const sim_command_t *p_command)
+{
+    char expected[64];
+    char actual[64];
+    switch (p_command->command)
+    {
+    case SIM_PRESS:
+        native_button_set_contact(PORT_PARKING_BUTTON_ID, true);
+        break;
+    case SIM_RELEASE:
+        native_button_set_contact(PORT_PARKING_BUTTON_ID, false);
+        break;
+    case SIM_OBSTACLE:
+        native_ultrasound_set_obstacle(PORT_REAR_PARKING_SENSOR_ID, p_command->args[0]);
+        break;
+    case SIM_MOVE:
+        native_ultrasound_move_obstacle(PORT_REAR_PARKING_SENSOR_ID, p_command->args[0], (uint64_t)p_command->args[1] * 1000);
+        break;
+    case SIM_EXTRA:
+        native_ultrasound_set_extra_obstacles(PORT_REAR_PARKING_SENSOR_ID, &p_command->args[1], p_command->args[0]);
+        break;
+    case SIM_TEMPERATURE:
+        native_temperature_set((int32_t)p_command->args[0]);
+        break;
+    case SIM_EXPECT_STATE:
+    {
+        uint32_t fsm = p_command->args[0];
+        uint32_t state = _get_state(fsm);
+        snprintf(expected, sizeof(expected), "%s %s", fsms_arr[fsm].p_name, _get_state_name(fsm, p_command->args[1]));
+        snprintf(actual, sizeof(actual), "%s", _get_state_name(fsm, state));
+        _report(p_command, state == p_command->args[1], expected, actual);
+        break;
+    }
+    case SIM_EXPECT_COLOR:
+    {
+        rgb_color_t color = native_display_get_rgb(PORT_REAR_PARKING_DISPLAY_ID);
+        snprintf(expected, sizeof(expected), "color %lu %lu %lu", (unsigned long)p_command->args[0], (unsigned long)p_command->args[1], (unsigned long)p_command->args[2]);
+        snprintf(actual, sizeof(actual), "%u %u %u", color.r, color.g, color.b);
+        _report(p_command, color.r == p_command->args[0] && color.g == p_command->args[1] && color.b == p_command->args[2], expected, actual);
+        break;
+    }
+    case SIM_EXPECT_DISTANCE:
+    {
+        int64_t error_cm = last_distance_cm - (int64_t)p_command->args[0];
+        snprintf(expected, sizeof(expected), "distance %lu +/- %lu cm", (unsigned long)p_command->args[0], (unsigned long)p_command->args[1]);
+        snprintf(actual, sizeof(actual), "%lld cm", (long long)last_distance_cm);
+        _report(p_command, last_distance_cm >= 0 && error_cm <= (int64_t)p_command->args[1] && -error_cm <= (int64_t)p_command->args[1], expected, actual);
+        break;
+    }
+    case SIM_SHELL:
+        native_shell_type(p_command->p_text);
+        break;
+    case SIM_EXPECT_PARAM:
+    {
+        const shell_param_t *p_param = shell_find_param(&urbanite_shell, p_command->p_text);
+        snprintf(expected, sizeof(expected), "param %s %lu", p_command->p_text, (unsigned long)p_command->args[0]);
+        snprintf(actual, sizeof(actual), "%lu", (p_param != NULL) ? (unsigned long)*p_param->p_value : 0UL);
+        _report(p_command, p_param != NULL && *p_param->p_value == p_command->args[0], expected, actual);
+        break;
+    }
+    default:
+    {
+        uint32_t period_ms = native_buzzer_get_period_ms(PORT_REAR_PARKING_BUZZER_ID);
+        snprintf(expected, sizeof(expected), "beep %lu ms", (unsigned long)p_command->args[0]);
+        snprintf(actual, sizeof(actual), "%lu ms", (unsigned long)period_ms);
+        _report(p_command, period_ms == p_command->args[0], expected, actual);
+        break;
+    }
+    }
+}
+
+/**
+ * @brief Handler of the event of the scenario. It runs all the commands that are due and schedules the next ones. It is not an interrupt, so it does not wake the system up.
+ *
+ * @param p_ctx Not used.
+ */
+static void _scenario_event(void *p_ctx)
+{
+    uint64_t now_us = native_system_get_time_us();
+    while (next_command < num_commands && p_commands[next_command].time_us <= now_us)
+    {
+        _run_command(&p_commands[next_command++]);
+    }
+    if (next_command < num_commands)
+    {
+        native_system_schedule(p_commands[next_command].time_us, _scenario_event, NULL);
+    }
+}
+
+/**
+ * @brief Compares two commands by time and order, for `qsort()`.
+ *
+ * @param p_a Pointer to the first command.
+ * @param p_b Pointer to the second command.
+ *
+ * @return Negative, zero or positive if the first command goes before, with or after the second.
+ */
+static int _compare_commands(const void *p_a, const void *p_b)
+{
+    const sim_command_t *p_cmd_a = (const sim_command_t *)p_a;
+    const sim_command_t *p_cmd_b = (const sim_command_t *)p_b;
+    if (p_cmd_a->time_us != p_cmd_b->time_us)
+    {
+        return (p_cmd_a->time_us < p_cmd_b->time_us) ? -1 : 1;
+    }
+    return (p_cmd_a->order < p_cmd_b->order) ? -1 : (p_cmd_a->order > p_cmd_b->order);
+}
+
+/**
+ * @brief Appends a command to the scenario.
+ *
+ * @param time_ms Time of the command in milliseconds.
+ * @param line Line of the command in the script.
+ * @param command Command (see `SIM_COMMANDS`).
+ * @param arg0 First argument.
+ * @param arg1 Second argument.
+ * @param arg2 Third argument.
+ *
+ * @return Pointer to the command added.
+ */
+static sim_command_t *_add_command(uint64_t time_ms, uint32_t line, uint8_t command, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+    p_commands = realloc(p_commands, (num_commands + 1) * sizeof(sim_command_t));
+    if (p_commands == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    p_commands[num_commands] = (sim_command_t){.time_us = time_ms * 1000, .order = num_commands, .line = line, .command = command, .args = {arg0, arg1, arg2}, .p_text = NULL};
+    return &p_commands[num_commands++];
+}
+
+/**
+ * @brief Copies the text argument of a command.
+ *
+ * @param p_text Pointer to the text.
+ * @param length Length of the text.
+ *
+ * @return Pointer to the terminated copy.
+ */
+static char *_copy_text(const char *p_text, size_t length)
+{
+    char *p_copy = malloc(length + 1);
+    if (p_copy == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(p_copy, p_text, length);
+    p_copy[length] = '\0';
+    return p_copy;
+}
+
+/**
+ * @brief Parses a command of a scenario that starts with `at <ms>`.
+ *
+ * @param time_ms Time of the command.
+ * @param line Line of the command in the script.
+ * @param p_rest Text of the line after the time.
+ *
+ * @return True if the command is valid.
+ */
+static bool _parse_command(uint64_t time_ms, uint32_t line, const char *p_rest)
+{
+    char what[SIM_MAX_NAME];
+    char name[SIM_MAX_NAME];
+    unsigned long a = 0, b = 0, c = 0;
+    long celsius = 0;
+    int used = 0;
+
+    if (sscanf(p_rest, " press %lu", &a) == 1)
+    {
+        _add_command(time_ms, line, SIM_PRESS, 0, 0, 0);
+        _add_command(time_ms + a, line, SIM_RELEASE, 0, 0, 0);
+        return true;
+    }
+    if (sscanf(p_rest, " obstacle %15s", name) == 1 && strcmp(name, "none") == 0)
+    {
+        _add_command(time_ms, line, SIM_OBSTACLE, NATIVE_ULTRASOUND_NO_OBSTACLE, 0, 0);
+        return true;
+    }
+    if (sscanf(p_rest, " obstacle %lu", &a) == 1)
+    {
+        _add_command(time_ms, line, SIM_OBSTACLE, a, 0, 0);
+        return true;
+    }
+    if (sscanf(p_rest, " move %lu %lu", &a, &b) == 2)
+    {
+        _add_command(time_ms, line, SIM_MOVE, a, b, 0);
+        return true;
+    }
+    if (sscanf(p_rest, " extra %15s", name) == 1 && strcmp(name, "none") == 0)
+    {
+        _add_command(time_ms, line, SIM_EXTRA, 0, 0, 0);
+        return true;
+    }
+    int num_extra = sscanf(p_rest, " extra %lu %lu", &a, &b);
+    if (num_extra >= 1)
+    {
+        _add_command(time_ms, line, SIM_EXTRA, (uint32_t)num_extra, a, b);
+        return true;
+    }
+    if (sscanf(p_rest, " temperature %ld", &celsius) == 1)
+    {
+        _add_command(time_ms, line, SIM_TEMPERATURE, (uint32_t)(int32_t)(celsius * 10), 0, 0);
+        return true;
+    }
+    if (sscanf(p_rest, " expect color %lu %lu %lu", &a, &b, &c) == 3)
+    {
+        _add_command(time_ms, line, SIM_EXPECT_COLOR, a, b, c);
+        return true;
+    }
+    int n = sscanf(p_rest, " expect distance %lu %lu", &a, &b);
+    if (n >= 1)
+    {
+        _add_command(time_ms, line, SIM_EXPECT_DISTANCE, a, (n == 2) ? b : 0, 0);
+        return true;
+    }
+    if (sscanf(p_rest, " shell %n", &used) == 0 && used > 0)
+    {
+        // The rest of the line, without its end and trailing spaces, is typed with a LF
+        size_t length = strcspn(p_rest + used, "\r\n");
+        while (length > 0 && (p_rest[used + length - 1] == ' ' || p_rest[used + length - 1] == '\t'))
+        {
+            length--;
+        }
+        char *p_line = _copy_text(p_rest + used, length + 1);
+        p_line[length] = '\n';
+        _add_command(time_ms, line, SIM_SHELL, 0, 0, 0)->p_text = p_line;
+        return true;
+    }
+    if (sscanf(p_rest, " expect param %15s %lu", name, &a) == 2)
+    {
+        _add_command(time_ms, line, SIM_EXPECT_PARAM, a, 0, 0)->p_text = _copy_text(name, strlen(name));
+        return true;
+    }
+    if (sscanf(p_rest, " expect beep %15s", name) == 1)
+    {
+        _add_command(time_ms, line, SIM_EXPECT_BEEP, (strcmp(name, "off") == 0) ? 0 : (uint32_t)strtoul(name, NULL, 10), 0, 0);
+        return true;
+    }
+    if (sscanf(p_rest, " expect %15s %15s", what, name) == 2)
+    {
+        for (uint32_t fsm = 0; fsm < SIM_NUM_FSMS; fsm++)
+        {
+            if (strcmp(what, fsms_arr[fsm].p_name) != 0)
+            {
+                continue;
+            }
+            for (uint32_t state = 0; state < fsms_arr[fsm].num_states; state++)
+            {
+                if (strcmp(name, fsms_arr[fsm].p_states[state]) == 0)
+                {
+                    _add_command(time_ms, line, SIM_EXPECT_STATE, fsm, state, 0);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Loads the settings and the commands of a scenario.
+ *
+ * @param p_path Path of the script.
+ * @param p_settings Settings of the scenario. Only the settings present in the script are written.
+ *
+ * @return True if the scenario is valid.
+ */
+static bool _load_scenario(const char *p_path, sim_settings_t *p_settings)
+{
+    FILE *p_file = fopen(p_path, "r");
+    if (p_file == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", p_path);
+        return false;
+    }
+
+    char text[SIM_MAX_LINE];
+    uint32_t line = 0;
+    bool ok = true;
+    while (fgets(text, sizeof(text), p_file) != NULL)
+    {
+        line++;
+        char *p_comment = strchr(text, '#');
+        if (p_comment != NULL)
+        {
+            *p_comment = '\0';
+        }
+        unsigned long long time_ms = 0;
+        unsigned long a = 0, b = 0;
+        long celsius = 0;
+        int used = 0;
+        char word[SIM_MAX_NAME];
+        if (sscanf(text, " %15s", word) != 1)
+        {
+            continue; // Empty line
+        }
+        if (sscanf(text, " seed %lu", &a) == 1)
+        {
+            p_settings->seed = (uint32_t)a;
+        }
+        else if (sscanf(text, " duration %llu", &time_ms) == 1)
+        {
+            p_settings->duration_ms = time_ms;
+        }
+        else if (sscanf(text, " loop %lu", &a) == 1)
+        {
+            p_settings->loop_us = (uint32_t)a;
+        }
+        else if (sscanf(text, " bounce %lu %lu", &a, &b) == 2)
+        {
+            p_settings->max_bounces = (uint32_t)a;
+            p_settings->bounce_window_us = (uint32_t)b;
+        }
+        else if (sscanf(text, " noise %lu", &a) == 1)
+        {
+            p_settings->noise_cm = (uint32_t)a;
+        }
+        else if (sscanf(text, " temperature %ld", &celsius) == 1)
+        {
+            p_settings->temperature_dc = (int32_t)(celsius * 10);
+        }
+        else if (!(sscanf(text, " at %llu%n", &time_ms, &used) == 1 && _parse_command(time_ms, line, text + used)))
+        {
+            fprintf(stderr, "%s:%lu: invalid line: %s", p_path, (unsigned long)line, text);
+            ok = false;
+        }
+    }
+    fclose(p_file);
+
+    if (num_commands > 0)
+    {
+        qsort(p_commands, num_commands, sizeof(sim_command_t), _compare_commands);
+    }
+    return ok;
+}
+
+/**
+ * @brief Prints the usage of the simulator.
+ *
+ * @param p_program Name of the program.
+ */
+static void _usage(const char *p_program)
+{
+    fprintf(stderr, "Usage: %s [-s seed] [-q] [-v] [-p] [-l] [-r] [-t trace.bin] [-H history.bin] [-f flash.bin] [-T telemetry.bin] [-x transitions.bin] scenario\n", p_program);
+}
+
+/**
+ * @brief  The simulator entry point.
+ * @retval int Number of failed checks, or `EXIT_FAILURE` if the scenario cannot be loaded.
+ */
+int main(int argc, char *argv[])
+{
+    const char *p_path = NULL;
+    const char *p_trace_path = NULL;
+    const char *p_history_path = NULL;
+    const char *p_flash_path = NULL;
+    const char *p_telemetry_path = NULL;
+    const char *p_transitions_path = NULL;
+    bool power = false;
+    bool latency = false;
+    bool ranging = false;
+    bool seed_given = false;
+    uint32_t seed = NATIVE_SYSTEM_DEFAULT_SEED;
+    sim_settings_t settings = {.seed = NATIVE_SYSTEM_DEFAULT_SEED, .duration_ms = SIM_DEFAULT_DURATION_MS, .loop_us = NATIVE_SYSTEM_DEFAULT_LOOP_US, .temperature_dc = NATIVE_TEMPERATURE_DEFAULT_DC};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+            seed_given = true;
+        }
+        else if (strcmp(argv[i], "-q") == 0)
+        {
+            quiet = true;
+        }
+        else if (strcmp(argv[i], "-v") == 0)
+        {
+            verbose = true;
+        }
+        else if (strcmp(argv[i], "-p") == 0)
+        {
+            power = true;
+        }
+        else if (strcmp(argv[i], "-l") == 0)
+        {
+            latency = true;
+        }
+        else if (strcmp(argv[i], "-r") == 0)
+        {
+            ranging = true;
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            p_trace_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc)
+        {
+            p_history_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+        {
+            p_flash_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc)
+        {
+            p_telemetry_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc)
+        {
+            p_transitions_path = argv[++i];
+        }
+        else if (p_path == NULL && argv[i][0] != '-')
+        {
+            p_path = argv[i];
+        }
+        else
+        {
+            _usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (p_path == NULL)
+    {
+        _usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Init simulator */
+    if (!_load_scenario(p_path, &settings))
+    {
+        return EXIT_FAILURE;
+    }
+    if (seed_given)
+    {
+        settings.seed = seed;
+    }
+    // The recovery of the flash log may erase a sector: its stall is not part of the scenario
+    if (p_flash_path != NULL && (!native_storage_set_file(p_flash_path) || !flash_log_init(&urbanite_flash_log)))
+    {
+        perror(p_flash_path);
+        return EXIT_FAILURE;
+    }
+    native_system_reset(settings.seed);
+    native_system_set_end_time_us(settings.duration_ms * 1000);
+    native_system_set_loop_time_us(settings.loop_us);
+    native_button_set_bounce(PORT_PARKING_BUTTON_ID, settings.max_bounces, settings.bounce_window_us);
+    native_ultrasound_set_noise(PORT_REAR_PARKING_SENSOR_ID, settings.noise_cm);
+    native_system_set_timeline(quiet ? NULL : stdout);
+    native_system_set_sleep_hook(_observe, NULL);
+    native_system_log("sim", "scenario %s seed %lu", p_path, (unsigned long)settings.seed);
+    native_temperature_set(settings.temperature_dc);
+
+    /* Init board, as in main.c */
+    port_system_init();
+    p_fsm_button = fsm_button_new(0, PORT_PARKING_BUTTON_ID);
+    port_button_set_debounce(PORT_PARKING_BUTTON_ID, PORT_PARKING_BUTTON_DEBOUNCE_TIME_MS);
+    p_fsm_ultrasound_rear = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
+    if (p_trace_path != NULL)
+    {
+        echo_trace_init(&rear_echo_trace);
+        fsm_ultrasound_set_trace(p_fsm_ultrasound_rear, &rear_echo_trace);
+    }
+    if (p_history_path != NULL)
+    {
+        distance_history_init(&rear_distance_history);
+        fsm_ultrasound_set_history(p_fsm_ultrasound_rear, &rear_distance_history);
+    }
+    if (ranging)
+    {
+        ranging_stats_init(&rear_ranging_stats);
+        fsm_ultrasound_set_stats(p_fsm_ultrasound_rear, &rear_ranging_stats);
+    }
+    p_fsm_display_rear = fsm_display_new(PORT_REAR_PARKING_DISPLAY_ID);
+    p_fsm_buzzer_rear = fsm_buzzer_new(PORT_REAR_PARKING_BUZZER_ID);
+    p_fsm_urbanite = fsm_urbanite_new(p_fsm_button, URBANITE_ON_OFF_PRESS_TIME_MS, URBANITE_PAUSE_DISPLAY_TIME_MS, p_fsm_ultrasound_rear, p_fsm_display_rear, p_fsm_buzzer_rear);
+    if (p_transitions_path != NULL)
+    {
+        // A missing or foreign file is a power-on: the trace starts empty
+        if (transition_trace_load(&urbanite_transition_trace, p_transitions_path))
+        {
+            transition_trace_restore(&urbanite_transition_trace, port_system_get_millis());
+        }
+        else
+        {
+            transition_trace_init(&urbanite_transition_trace);
+        }
+        fsm_button_set_transition_trace(p_fsm_button, &urbanite_transition_trace);
+        fsm_ultrasound_set_transition_trace(p_fsm_ultrasound_rear, &urbanite_transition_trace);
+        fsm_display_set_transition_trace(p_fsm_display_rear, &urbanite_transition_trace);
+        fsm_buzzer_set_transition_trace(p_fsm_buzzer_rear, &urbanite_transition_trace);
+        fsm_urbanite_set_transition_trace(p_fsm_urbanite, &urbanite_transition_trace);
+    }
+    if (power)
+    {
+        fsm_urbanite_set_power_stats(p_fsm_urbanite, &urbanite_power_stats);
+    }
+    if (p_flash_path != NULL)
+    {
+        fsm_urbanite_set_flash_log(p_fsm_urbanite, &urbanite_flash_log);
+    }
+    if (latency)
+    {
+        latency_probe_init(&rear_latency_probe);
+        fsm_display_set_latency_probe(p_fsm_display_rear, &rear_latency_probe);
+    }
+    if (p_telemetry_path != NULL)
+    {
+        if (!native_telemetry_set_file(p_telemetry_path))
+        {
+            perror(p_telemetry_path);
+            return EXIT_FAILURE;
+        }
+        telemetry_init(&urbanite_telemetry, URBANITE_TELEMETRY_PERIOD_MS);
+    }
+    urbanite_shell_init(&urbanite_shell, p_fsm_urbanite, p_fsm_ultrasound_rear, p_fsm_display_rear, (p_telemetry_path != NULL) ? &urbanite_telemetry : NULL);
+
+    if (num_commands > 0)
+    {
+        native_system_schedule(p_commands[0].time_us, _scenario_event, NULL);
+    }
+
+    /* Loop until the end of the simulation */
+    clock_t wall_start = clock();
+    while (!native_system_is_over())
+    {
+        fsm_button_fire(p_fsm_button);
+        fsm_ultrasound_fire(p_fsm_ultrasound_rear);
+        fsm_display_fire(p_fsm_display_rear);
+        fsm_buzzer_fire(p_fsm_buzzer_rear);
+        fsm_urbanite_fire(p_fsm_urbanite);
+        shell_service(&urbanite_shell);
+        if (p_telemetry_path != NULL)
+        {
+            if (telemetry_is_due(&urbanite_telemetry, port_system_get_millis()))
+            {
+                telemetry_status_t status = {
+                    .timestamp_ms = port_system_get_millis(),
+                    .distance_cm = fsm_ultrasound_get_last_distance(p_fsm_ultrasound_rear),
+                    .urbanite_state = (uint8_t)fsm_urbanite_get_state(p_fsm_urbanite),
+                    .ultrasound_state = (uint8_t)fsm_ultrasound_get_state(p_fsm_ultrasound_rear),
+                    .display_state = (uint8_t)fsm_display_get_state(p_fsm_display_rear),
+                    .buzzer_state = (uint8_t)fsm_buzzer_get_state(p_fsm_buzzer_rear)};
+                telemetry_send_status(&urbanite_telemetry, &status);
+            }
+            telemetry_service(&urbanite_telemetry);
+        }
+        _observe(NULL);
+        native_system_loop();
+    }
+    double wall_s = (double)(clock() - wall_start) / CLOCKS_PER_SEC;
+
+    /* Summary */
+    uint64_t sim_us = native_system_get_time_us();
+    native_system_set_timeline(stdout);
+    native_system_log("sim", "end: %lu checks, %lu failed, asleep %llu.%03llu ms", (unsigned long)num_checks, (unsigned long)num_failures,
+                      (unsigned long long)(native_system_get_sleep_time_us() / 1000), (unsigned long long)(native_system_get_sleep_time_us() % 1000));
+    if (next_command < num_commands)
+    {
+        native_system_log("sim", "warning: %lu commands after the end of the simulation", (unsigned long)(num_commands - next_command));
+    }
+    fprintf(stderr, "%.3f simulated s in %.3f wall s\n", (double)sim_us / 1e6, wall_s);
+    if (power)
+    {
+        power_stats_update(&urbanite_power_stats, port_system_get_power_clock_us());
+        power_stats_print(&urbanite_power_stats, urbanite_states, (uint8_t)(sizeof(urbanite_states) / sizeof(urbanite_states[0])));
+    }
+    if (latency)
+    {
+        latency_probe_print(&rear_latency_probe, "rear echo to display");
+    }
+    if (ranging)
+    {
+        ranging_stats_snapshot_t ranging_snapshot;
+        fsm_ultrasound_get_stats(p_fsm_ultrasound_rear, &ranging_snapshot);
+        ranging_stats_print(&ranging_snapshot, "rear");
+    }
+    if (p_trace_path != NULL && !echo_trace_save(&rear_echo_trace, p_trace_path))
+    {
+        perror(p_trace_path);
+        num_failures++;
+    }
+    if (p_history_path != NULL && !distance_history_save(&rear_distance_history, p_history_path))
+    {
+        perror(p_history_path);
+        num_failures++;
+    }
+    if (p_transitions_path != NULL && !transition_trace_save(&urbanite_transition_trace, p_transitions_path))
+    {
+        perror(p_transitions_path);
+        num_failures++;
+    }
+    if (p_flash_path != NULL)
+    {
+        // The records held while the system was on are programmed too
+        flash_log_set_erase_allowed(&urbanite_flash_log, true);
+        if (!flash_log_flush(&urbanite_flash_log))
+        {
+            num_failures++;
+        }
+        const native_storage_stats_t *p_stats = native_storage_get_stats();
+        native_system_log("sim", "flash log: %lu records, %lu dropped, %lu words programmed, %lu erases, stalled %llu.%03llu ms", (unsigned long)urbanite_flash_log.num_appended,
+                          (unsigned long)urbanite_flash_log.num_dropped, (unsigned long)p_stats->num_words_programmed, (unsigned long)p_stats->num_erases,
+                          (unsigned long long)(p_stats->busy_us / 1000), (unsigned long long)(p_stats->busy_us % 1000));
+    }
+
+    if (p_telemetry_path != NULL)
+    {
+        native_system_log("sim", "telemetry: %lu packets, %lu dropped, %lu bytes in %lu transfers", (unsigned long)urbanite_telemetry.num_packets,
+                          (unsigned long)urbanite_telemetry.num_dropped, (unsigned long)native_telemetry_get_num_bytes(), (unsigned long)urbanite_telemetry.num_transfers);
+        native_telemetry_set_file(NULL);
+    }
+
+    fsm_urbanite_destroy(p_fsm_urbanite);
+    fsm_button_destroy(p_fsm_button);
+    fsm_ultrasound_destroy(p_fsm_ultrasound_rear);
+    fsm_display_destroy(p_fsm_display_rear);
+    fsm_buzzer_destroy(p_fsm_buzzer_rear);
+    for (uint32_t i = 0; i < num_commands; i++)
+    {
+        free(p_commands[i].p_text);
+    }
+    free(p_commands);
+    return (int)num_failures;
+}
@@ -26,6 +26,27 @@
 #define LD2_PIN 5
 #define LD2_DELAY_MS 100
 
+static uint32_t exti_calls_mask;   /*!< EXTI lines whose handler has been called */
+static uint8_t exti_calls_order[2]; /*!< Order of the calls of the EXTI handlers */
+static uint32_t exti_num_calls;     /*!< Number of calls of the EXTI handlers */
+
+/**
+ * @brief Handler registered in the EXTI dispatch tests. It records the line and checks the context.
+ *
+ * @param line EXTI line.
+ * @param p_ctx Pointer to the expected line.
+ */
+static void _test_exti_handler(uint8_t line, void *p_ctx)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(*(uint8_t *)p_ctx, line, __LINE__, "ERROR: The EXTI handler has been called with the context of another line");
+    exti_calls_mask |= BIT_POS_TO_MASK(line);
+    if (exti_num_calls < 2)
+    {
+        exti_calls_order[exti_num_calls] = line;
+    }
+    exti_num_calls++;
+}
+
 void setUp(void)
 {
     RCC->AHB1ENR |= RCC_AHB1ENR_GPIOCEN;
@@ -197,6 +218,163 @@ void test_exti_priority(void)
     TEST_ASSERT_EQUAL(0, pSubPriority);
 }
 
+/**
+ * @brief Test the microsecond time base and the timestamp of the edges of the button.
+ *
+ */
+void test_edge_timestamp(void)
+{
+    uint32_t start_us = port_system_get_micros();
+    port_system_delay_ms(2);
+    uint32_t elapsed_us = port_system_get_micros() - start_us;
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1000, 2000, elapsed_us, __LINE__, "ERROR: port_system_get_micros() does not match the time of port_system_get_millis()");
+
+    uint32_t before_us = port_system_get_micros();
+    port_button_set_pressed(PORT_PARKING_BUTTON_ID, true);
+    uint32_t after_us = port_system_get_micros();
+    uint32_t edge_us = port_button_get_edge_time_us(PORT_PARKING_BUTTON_ID);
+    UNITY_TEST_ASSERT(((edge_us - before_us) <= (after_us - before_us)), __LINE__, "ERROR: The time of the edge must be taken when the pressed flag changes");
+    port_button_set_pressed(PORT_PARKING_BUTTON_ID, false);
+}
+
+/**
+ * @brief Test the EXTI dispatch table: each pending line of an interrupt calls its own handler with its context, and the pending bits are cleared.
+ *
+ */
+void test_exti_dispatch(void)
+{
+    static uint8_t line_a = 0;
+    static uint8_t line_b = 3;
+    uint32_t lines = BIT_POS_TO_MASK(line_a) | BIT_POS_TO_MASK(line_b);
+    uint32_t prev_imr = EXTI->IMR;
+
+    stm32f4_system_exti_register(line_a, _test_exti_handler, &line_a);
+    stm32f4_system_exti_register(line_b, _test_exti_handler, &line_b);
+    exti_calls_mask = 0;
+    exti_num_calls = 0;
+
+    // The NVIC interrupts of the lines are not enabled, so the lines stay pending until they are dispatched
+    EXTI->IMR |= lines;
+    EXTI->SWIER |= lines;
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_0);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(line_a), exti_calls_mask, __LINE__, "ERROR: Only the lines of the interrupt must be dispatched");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(line_b), EXTI->PR & lines, __LINE__, "ERROR: The lines of other interrupts must stay pending");
+
+    EXTI->SWIER |= BIT_POS_TO_MASK(line_a);
+    exti_calls_mask = 0;
+    exti_num_calls = 0;
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_0 | STM32F4_EXTI_LINES_3);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(lines, exti_calls_mask, __LINE__, "ERROR: All the pending lines must be dispatched");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, exti_num_calls, __LINE__, "ERROR: Each pending line must be dispatched once");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(line_a, exti_calls_order[0], __LINE__, "ERROR: The lines must be dispatched from the lowest to the highest");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, EXTI->PR & lines, __LINE__, "ERROR: The dispatched lines must be cleared");
+
+    // A line without handler is cleared but not dispatched
+    stm32f4_system_exti_register(line_b, NULL, NULL);
+    EXTI->SWIER |= BIT_POS_TO_MASK(line_b);
+    exti_calls_mask = 0;
+    stm32f4_system_exti_dispatch(STM32F4_EXTI_LINES_3);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, exti_calls_mask, __LINE__, "ERROR: A line without handler must not be dispatched");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, EXTI->PR & lines, __LINE__, "ERROR: A line without handler must be cleared");
+
+    stm32f4_system_exti_register(line_a, NULL, NULL);
+    EXTI->IMR = prev_imr;
+}
+
+/**
+ * @brief Test the hardware debounce: the first edge masks the EXTI line and starts a one-shot timer, and the line is unmasked when the timer expires.
+ *
+ */
+void test_hw_debounce(void)
+{
+    uint32_t test_debounce_ms = 50;
+    port_button_init(PORT_PARKING_BUTTON_ID);
+
+    // Disabled by default
+    UNITY_TEST_ASSERT_EQUAL_INT(false, stm32f4_button_debounce_start(PORT_PARKING_BUTTON_ID), __LINE__, "ERROR: The hardware debounce must be disabled by default");
+
+    port_button_set_debounce(PORT_PARKING_BUTTON_ID, test_debounce_ms);
+    TIM_TypeDef *p_timer = STM32F4_PARKING_BUTTON_DEBOUNCE_TIMER;
+    double tick_hz = (double)SystemCoreClock / (p_timer->PSC + 1.0);
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1, STM32F4_BUTTON_DEBOUNCE_TICK_HZ, (uint32_t)tick_hz, __LINE__, "ERROR: The counter of the debounce timer must run at 1 kHz");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(test_debounce_ms - 1, p_timer->ARR, __LINE__, "ERROR: The ARR of the debounce timer does not match the debounce time");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CR1_OPM, p_timer->CR1 & TIM_CR1_OPM, __LINE__, "ERROR: The debounce timer must work in one pulse mode");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_DIER_UIE, p_timer->DIER & TIM_DIER_UIE, __LINE__, "ERROR: The update interrupt of the debounce timer must be enabled");
+
+    // An edge masks the line and starts the timer
+    UNITY_TEST_ASSERT_EQUAL_INT(true, stm32f4_button_debounce_start(PORT_PARKING_BUTTON_ID), __LINE__, "ERROR: The hardware debounce must start after an edge");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, EXTI->IMR & BIT_POS_TO_MASK(STM32F4_PARKING_BUTTON_PIN), __LINE__, "ERROR: The EXTI line of the button must be masked during the debounce");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CR1_CEN, p_timer->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The debounce timer must be running during the debounce");
+
+    // The timer expires once and unmasks the line
+    port_system_delay_ms(test_debounce_ms + 5);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, p_timer->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The debounce timer must stop after the debounce time");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(STM32F4_PARKING_BUTTON_PIN), EXTI->IMR & BIT_POS_TO_MASK(STM32F4_PARKING_BUTTON_PIN), __LINE__, "ERROR: The EXTI line of the button must be unmasked after the debounce time");
+    UNITY_TEST_ASSERT_EQUAL_INT(!port_button_get_value(PORT_PARKING_BUTTON_ID), port_button_get_pressed(PORT_PARKING_BUTTON_ID), __LINE__, "ERROR: The pressed flag must be updated with the level of the pin after the debounce time");
+
+    port_button_set_debounce(PORT_PARKING_BUTTON_ID, 0);
+    UNITY_TEST_ASSERT_EQUAL_INT(false, stm32f4_button_debounce_start(PORT_PARKING_BUTTON_ID), __LINE__, "ERROR: The hardware debounce must be disabled with a debounce time of 0");
+}
+
+/**
+ * @brief Test the time base of the debounce timer with a system clock whose prescaler of a 1 ms tick does not fit in 16 bits.
+ *
+ */
+void test_hw_debounce_fast_clock(void)
+{
+    uint32_t test_debounce_ms = 50;
+    uint32_t system_core_clock = SystemCoreClock;
+    TIM_TypeDef *p_timer = STM32F4_PARKING_BUTTON_DEBOUNCE_TIMER;
+    SystemCoreClock = 180000000;
+    port_button_set_debounce(PORT_PARKING_BUTTON_ID, test_debounce_ms);
+    double tick_hz = (double)SystemCoreClock / (p_timer->PSC + 1.0);
+    uint32_t ticks_per_ms = (uint32_t)(tick_hz / STM32F4_BUTTON_DEBOUNCE_TICK_HZ + 0.5);
+    UNITY_TEST_ASSERT(ticks_per_ms > 1, __LINE__, "ERROR: The counter of the debounce timer must run faster than 1 kHz if the prescaler does not fit in 16 bits");
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1, ticks_per_ms * STM32F4_BUTTON_DEBOUNCE_TICK_HZ, (uint32_t)tick_hz, __LINE__, "ERROR: The counter of the debounce timer must run at a multiple of 1 kHz");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(test_debounce_ms * ticks_per_ms - 1, p_timer->ARR, __LINE__, "ERROR: The ARR of the debounce timer does not match the debounce time");
+
+    SystemCoreClock = system_core_clock;
+    port_button_set_debounce(PORT_PARKING_BUTTON_ID, 0);
+}
+
+/**
+ * @brief Test the time of an edge that wakes the system up: the system sleeps with the SysTick suspended between the edge and the end of the debounce, and the time of the edge must stay between the times read before and after the sleep.
+ *
+ */
+void test_edge_timestamp_sleep(void)
+{
+    uint32_t test_debounce_ms = 20;
+    uint32_t pin_mask = BIT_POS_TO_MASK(STM32F4_PARKING_BUTTON_PIN);
+    TIM_TypeDef *p_timer = STM32F4_PARKING_BUTTON_DEBOUNCE_TIMER;
+    port_button_init(PORT_PARKING_BUTTON_ID);
+    port_button_set_debounce(PORT_PARKING_BUTTON_ID, test_debounce_ms);
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        // The flag differs from the level of the pin, so the time of the edge is stored at the end of the debounce
+        port_button_set_pressed(PORT_PARKING_BUTTON_ID, port_button_get_value(PORT_PARKING_BUTTON_ID));
+        port_system_delay_ms(1 + i % 3);
+        uint32_t before_us = port_system_get_micros();
+
+        // The edge wakes the system up, which goes back to sleep until the debounce timer expires
+        port_system_systick_suspend();
+        EXTI->SWIER |= pin_mask;
+        port_system_systick_suspend();
+        for (uint32_t wait = 0; (p_timer->CR1 & TIM_CR1_CEN) && (wait < 10000000); wait++)
+        {
+        }
+        uint32_t after_us = port_system_get_micros();
+        uint32_t edge_us = port_button_get_edge_time_us(PORT_PARKING_BUTTON_ID);
+
+        UNITY_TEST_ASSERT_EQUAL_UINT32(0, p_timer->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The debounce timer must expire while the SysTick is suspended");
+        UNITY_TEST_ASSERT(((int32_t)(after_us - before_us) >= 0), __LINE__, "ERROR: port_system_get_micros() must not go back while the SysTick is suspended");
+        UNITY_TEST_ASSERT(((edge_us - before_us) <= (after_us - before_us)), __LINE__, "ERROR: The time of an edge that wakes the system up must be taken after the SysTick is resumed");
+    }
+
+    port_button_set_debounce(PORT_PARKING_BUTTON_ID, 0);
+    port_button_set_pressed(PORT_PARKING_BUTTON_ID, false);
+}
+
 /**
  * @brief Test the generalization of the button port driver. Particularly, test that the port driver functions work with the buttons_arr array and not with the specific GPIOx peripheral.
  *
@@ -298,6 +476,11 @@ int main(void)
     RUN_TEST(test_write_gpio);
     RUN_TEST(test_exti);
     RUN_TEST(test_exti_priority);
+    RUN_TEST(test_hw_debounce);
+    RUN_TEST(test_hw_debounce_fast_clock);
+    RUN_TEST(test_exti_dispatch);
+    RUN_TEST(test_edge_timestamp);
+    RUN_TEST(test_edge_timestamp_sleep);
     RUN_TEST(test_button_port_generalization);
     exit(UNITY_END());
 }
@@ -0,0 +1,138 @@
+/**
+ * @file test_port_buzzer.c
+ * @brief Unit test for the buzzer port driver.
+ *
+ * It checks the configuration of the tone and cadence timers and the GPIO pin of the buzzer using the Unity framework.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_buzzer.h"
+#include "port_system.h"
+#include "stm32f4_system.h"
+#include "stm32f4_buzzer.h"
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_PORT_REAR_PARKING_BUZZER_ID 0 /*!< Buzzer identifier @hideinitializer */
+
+#define TEST_STM32F4_REAR_PARKING_BUZZER_GPIO GPIOB     /*!< GPIO of the buzzer @hideinitializer */
+#define TEST_STM32F4_REAR_PARKING_BUZZER_PIN 14         /*!< Pin of the buzzer @hideinitializer */
+#define TEST_STM32F4_REAR_PARKING_BUZZER_AF STM32F4_AF9 /*!< Buzzer Alternate Function @hideinitializer */
+
+#define BUZZER_TONE_TIMER TIM12    /*!< Buzzer tone timer @hideinitializer */
+#define BUZZER_CADENCE_TIMER TIM14 /*!< Buzzer cadence timer @hideinitializer */
+#define BUZZER_GATED_MODE 0x05     /*!< Slave mode: gated @hideinitializer */
+#define BUZZER_TRIGGER_ITR3 0x03   /*!< Trigger selection: ITR3 (TIM14_OC) @hideinitializer */
+
+/* Private variables ---------------------------------------------------------*/
+static char msg[200]; /*!< Buffer for the error messages */
+
+/* Private functions ----------------------------------------------------------*/
+void setUp(void)
+{
+    port_buzzer_init(TEST_PORT_REAR_PARKING_BUZZER_ID);
+}
+
+void tearDown(void)
+{
+    port_buzzer_stop(TEST_PORT_REAR_PARKING_BUZZER_ID);
+}
+
+void test_identifiers(void)
+{
+    sprintf(msg, "ERROR: PORT_REAR_PARKING_BUZZER_ID must be %d", TEST_PORT_REAR_PARKING_BUZZER_ID);
+    UNITY_TEST_ASSERT_EQUAL_INT(TEST_PORT_REAR_PARKING_BUZZER_ID, PORT_REAR_PARKING_BUZZER_ID, __LINE__, msg);
+
+    UNITY_TEST_ASSERT_EQUAL_INT(TEST_STM32F4_REAR_PARKING_BUZZER_GPIO, STM32F4_REAR_PARKING_BUZZER_GPIO, __LINE__, "ERROR: STM32F4_REAR_PARKING_BUZZER_GPIO GPIO must be GPIOB");
+    sprintf(msg, "ERROR: STM32F4_REAR_PARKING_BUZZER_PIN pin must be %d", TEST_STM32F4_REAR_PARKING_BUZZER_PIN);
+    UNITY_TEST_ASSERT_EQUAL_INT(TEST_STM32F4_REAR_PARKING_BUZZER_PIN, STM32F4_REAR_PARKING_BUZZER_PIN, __LINE__, msg);
+}
+
+void test_pin_config(void)
+{
+    uint32_t mode = ((TEST_STM32F4_REAR_PARKING_BUZZER_GPIO->MODER) >> (TEST_STM32F4_REAR_PARKING_BUZZER_PIN * 2)) & GPIO_MODER_MODER0_Msk;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_AF, mode, __LINE__, "ERROR: Buzzer pin is not configured as alternate");
+
+    uint32_t af = ((TEST_STM32F4_REAR_PARKING_BUZZER_GPIO->AFR[TEST_STM32F4_REAR_PARKING_BUZZER_PIN / 8]) >> ((TEST_STM32F4_REAR_PARKING_BUZZER_PIN % 8) * 4)) & 0xF;
+    sprintf(msg, "ERROR: Buzzer alternate function is not configured correctly as AF%d", TEST_STM32F4_REAR_PARKING_BUZZER_AF);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_STM32F4_REAR_PARKING_BUZZER_AF, af, __LINE__, msg);
+}
+
+void test_tone_timer_config(void)
+{
+    // Check the frequency of the tone
+    double tone_hz = (double)SystemCoreClock / ((BUZZER_TONE_TIMER->PSC + 1.0) * (BUZZER_TONE_TIMER->ARR + 1.0));
+    sprintf(msg, "ERROR: The tone frequency must be %d Hz", PORT_BUZZER_TONE_HZ);
+    UNITY_TEST_ASSERT_UINT32_WITHIN(PORT_BUZZER_TONE_HZ / 100, PORT_BUZZER_TONE_HZ, (uint32_t)tone_hz, __LINE__, msg);
+
+    // Check the duty cycle (50 %)
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1, (BUZZER_TONE_TIMER->ARR + 1) / 2, BUZZER_TONE_TIMER->CCR1, __LINE__, "ERROR: The duty cycle of the tone must be 50 %");
+
+    // Check the gated slave mode
+    uint32_t sms = (BUZZER_TONE_TIMER->SMCR & TIM_SMCR_SMS) >> TIM_SMCR_SMS_Pos;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BUZZER_GATED_MODE, sms, __LINE__, "ERROR: The tone timer must work in gated slave mode");
+    uint32_t ts = (BUZZER_TONE_TIMER->SMCR & TIM_SMCR_TS) >> TIM_SMCR_TS_Pos;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BUZZER_TRIGGER_ITR3, ts, __LINE__, "ERROR: The tone timer must be gated by the cadence timer (ITR3)");
+}
+
+void test_cadence_timer_config(void)
+{
+    // Check the cadence time base (1 ms)
+    double tick_hz = (double)SystemCoreClock / (BUZZER_CADENCE_TIMER->PSC + 1.0);
+    sprintf(msg, "ERROR: The counter of the cadence timer must run at %d Hz", STM32F4_BUZZER_CADENCE_TICK_HZ);
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1, STM32F4_BUZZER_CADENCE_TICK_HZ, (uint32_t)tick_hz, __LINE__, msg);
+
+    // Check a cadence of 300 ms with beeps of 100 ms
+    port_buzzer_set_cadence(TEST_PORT_REAR_PARKING_BUZZER_ID, 300, 100);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(299, BUZZER_CADENCE_TIMER->ARR, __LINE__, "ERROR: The ARR of the cadence timer does not match the period");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(100, BUZZER_CADENCE_TIMER->CCR1, __LINE__, "ERROR: The CCR1 of the cadence timer does not match the beep duration");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CR1_CEN, BUZZER_CADENCE_TIMER->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The cadence timer must be enabled");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CR1_CEN, BUZZER_TONE_TIMER->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The tone timer must be enabled");
+
+    // A beep duration of 0 silences the buzzer
+    port_buzzer_set_cadence(TEST_PORT_REAR_PARKING_BUZZER_ID, 300, 0);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, BUZZER_CADENCE_TIMER->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The cadence timer must be disabled when the buzzer is silenced");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, BUZZER_TONE_TIMER->CCER & TIM_CCER_CC1E, __LINE__, "ERROR: The tone output must be disabled when the buzzer is silenced");
+}
+
+void test_cadence_timer_fast_clock(void)
+{
+    // With a system clock of 180 MHz, a 1 ms tick needs a prescaler that does not fit in 16 bits
+    uint32_t system_core_clock = SystemCoreClock;
+    SystemCoreClock = 180000000;
+    port_buzzer_init(TEST_PORT_REAR_PARKING_BUZZER_ID);
+    double tick_hz = (double)SystemCoreClock / (BUZZER_CADENCE_TIMER->PSC + 1.0);
+    uint32_t ticks_per_ms = (uint32_t)(tick_hz / STM32F4_BUZZER_CADENCE_TICK_HZ + 0.5);
+    UNITY_TEST_ASSERT(ticks_per_ms > 1, __LINE__, "ERROR: The counter of the cadence timer must run faster than 1 kHz if the prescaler does not fit in 16 bits");
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1, ticks_per_ms * STM32F4_BUZZER_CADENCE_TICK_HZ, (uint32_t)tick_hz, __LINE__, "ERROR: The counter of the cadence timer must run at a multiple of 1 kHz");
+
+    port_buzzer_set_cadence(TEST_PORT_REAR_PARKING_BUZZER_ID, 300, 100);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(300 * ticks_per_ms - 1, BUZZER_CADENCE_TIMER->ARR, __LINE__, "ERROR: The ARR of the cadence timer does not match the period");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(100 * ticks_per_ms, BUZZER_CADENCE_TIMER->CCR1, __LINE__, "ERROR: The CCR1 of the cadence timer does not match the beep duration");
+
+    SystemCoreClock = system_core_clock;
+    port_buzzer_init(TEST_PORT_REAR_PARKING_BUZZER_ID);
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_identifiers);
+    RUN_TEST(test_pin_config);
+    RUN_TEST(test_tone_timer_config);
+    RUN_TEST(test_cadence_timer_config);
+    RUN_TEST(test_cadence_timer_fast_clock);
+
+    exit(UNITY_END());
+}
@@ -42,6 +42,10 @@
 #define DISPLAY_RGB_PWM_PER_BUS_MASK RCC_APB1ENR_TIM4EN /*!< Display RGB timer peripheral bus mask @hideinitializer */
 #define DISPLAY_RGB_PWM_PERIOD_MS 20                    /*!< Period of the RGB display timer @hideinitializer */
 
+// Front display configuration
+#define TEST_PORT_FRONT_PARKING_DISPLAY_ID 1 /*!< Front display identifier @hideinitializer */
+#define DISPLAY_FRONT_RGB_PWM TIM1           /*!< Front display RGB timer @hideinitializer */
+
 /* Private variables ---------------------------------------------------------*/
 static char msg[200]; /*!< Buffer for the error messages */
 
@@ -313,6 +317,46 @@ void test_display_set_color(void)
     UNITY_TEST_ASSERT_EQUAL_UINT32(prev_tim_pwm_ccmr2, curr_tim_pwm_ccmr2, __LINE__, "ERROR: The register CCMR2 of the DISPLAY timer for PWM has been modified and it should not have been changed");
 }
 
+/**
+ * @brief Test that the front display uses its own timer and channels, and that it can be lit and switched off without modifying the rear display
+ *
+ */
+void test_display_front_independent(void)
+{
+    port_display_init(TEST_PORT_REAR_PARKING_DISPLAY_ID);
+    port_display_init(TEST_PORT_FRONT_PARKING_DISPLAY_ID);
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_BDTR_MOE, DISPLAY_FRONT_RGB_PWM->BDTR & TIM_BDTR_MOE, __LINE__, "ERROR: The main output of the front DISPLAY timer must be enabled");
+    uint32_t arr = DISPLAY_FRONT_RGB_PWM->ARR;
+    uint32_t psc = DISPLAY_FRONT_RGB_PWM->PSC;
+    uint32_t tim_dur_ms = round((((double)(arr) + 1.0) / ((double)SystemCoreClock / 1000.0)) * ((double)(psc) + 1));
+    UNITY_TEST_ASSERT_INT_WITHIN(1, DISPLAY_RGB_PWM_PERIOD_MS, tim_dur_ms, __LINE__, "ERROR: Front DISPLAY PWM period duration ARR and PSC are not configured correctly");
+
+    rgb_color_t rear_color = {TEST_PORT_DISPLAY_RGB_MAX_VALUE, 0, 0};
+    port_display_set_rgb(TEST_PORT_REAR_PARKING_DISPLAY_ID, rear_color);
+    uint32_t prev_rear_ccer = DISPLAY_RGB_PWM->CCER;
+    uint32_t prev_rear_ccr1 = DISPLAY_RGB_PWM->CCR1;
+
+    rgb_color_t front_color = {0, TEST_PORT_DISPLAY_RGB_MAX_VALUE / 2, TEST_PORT_DISPLAY_RGB_MAX_VALUE};
+    port_display_set_rgb(TEST_PORT_FRONT_PARKING_DISPLAY_ID, front_color);
+
+    uint32_t green_test = ((DISPLAY_FRONT_RGB_PWM->CCR2 + 1) * TEST_PORT_DISPLAY_RGB_MAX_VALUE) / (arr + 1);
+    uint32_t blue_test = ((DISPLAY_FRONT_RGB_PWM->CCR3 + 1) * TEST_PORT_DISPLAY_RGB_MAX_VALUE) / (arr + 1);
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1, front_color.g, green_test, __LINE__, "ERROR: Front DISPLAY green LED duty cycle is not configured correctly");
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1, front_color.b, blue_test, __LINE__, "ERROR: Front DISPLAY blue LED duty cycle is not configured correctly");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CCER_CC2E | TIM_CCER_CC3E, DISPLAY_FRONT_RGB_PWM->CCER & (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E), __LINE__, "ERROR: Only the green and blue channels of the front DISPLAY must be enabled");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CR1_CEN, DISPLAY_FRONT_RGB_PWM->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The front DISPLAY timer must be enabled after setting the RGB color");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(prev_rear_ccer, DISPLAY_RGB_PWM->CCER, __LINE__, "ERROR: Setting the front DISPLAY color has modified the CCER of the rear DISPLAY timer");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(prev_rear_ccr1, DISPLAY_RGB_PWM->CCR1, __LINE__, "ERROR: Setting the front DISPLAY color has modified the duty cycle of the rear DISPLAY");
+
+    port_display_set_rgb(TEST_PORT_FRONT_PARKING_DISPLAY_ID, COLOR_OFF);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, DISPLAY_FRONT_RGB_PWM->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The front DISPLAY timer must be disabled when all its channels are off");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CR1_CEN, DISPLAY_RGB_PWM->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: Switching off the front DISPLAY must not stop the rear DISPLAY timer");
+
+    port_display_set_rgb(TEST_PORT_REAR_PARKING_DISPLAY_ID, COLOR_OFF);
+}
+
 int main(void)
 {
     port_system_init();
@@ -324,6 +368,7 @@ int main(void)
     RUN_TEST(test_trigger_regs);
     RUN_TEST(test_display_timer_pwm_config);
     RUN_TEST(test_display_set_color);
+    RUN_TEST(test_display_front_independent);
 
     exit(UNITY_END());
 }
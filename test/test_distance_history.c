@@ -0,0 +1,156 @@
+/**
+ * @file test_distance_history.c
+ * @brief Unit test for the compressed history of the filtered distances.
+ *
+ * The history does not depend on the hardware, so this test can be run on the host.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "distance_history.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TEST_PERIOD_MS 50              /*!< Period of the samples (20 Hz) */
+#define TEST_NUM_SAMPLES (10 * 60 * 20) /*!< Ten minutes of samples at 20 Hz */
+
+/* Private variables ---------------------------------------------------------*/
+static distance_history_t history; /*!< History under test */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Distance of a sample of a parking manoeuvre: the vehicle approaches, waits, and moves away, with some noise.
+ *
+ * @param i Index of the sample.
+ *
+ * @return uint32_t Distance in cm.
+ */
+static uint32_t _manoeuvre_distance(uint32_t i)
+{
+    uint32_t phase = i % 2400; // A manoeuvre every 2 minutes
+    uint32_t noise = ((i * 7) % 11 == 0) ? 1 : 0;
+    if (phase < 600)
+    {
+        return 300 - phase / 3 + noise; // Approach at 20 cm/s
+    }
+    if (phase < 1800)
+    {
+        return 100 + noise; // Parked
+    }
+    return 100 + (phase - 1800) / 3 + noise; // Moving away
+}
+
+void setUp(void)
+{
+    distance_history_init(&history);
+}
+
+void tearDown(void)
+{
+}
+
+void test_empty(void)
+{
+    distance_history_iter_t iter;
+    distance_history_sample_t sample;
+    distance_history_iter_init(&iter, &history);
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, distance_history_get_count(&history), __LINE__, "ERROR: An empty history must have no samples");
+    UNITY_TEST_ASSERT(!distance_history_iter_next(&iter, &sample), __LINE__, "ERROR: An empty history must not be read");
+}
+
+void test_round_trip(void)
+{
+    // Irregular times, runs, large and negative changes
+    static const uint32_t timestamps_ms[] = {1000, 1050, 1100, 1150, 1200, 1250, 1700, 1750, 1800, 1850, 100000, 100050};
+    static const uint32_t distances_cm[] = {250, 240, 230, 220, 210, 210, 211, 5, 5, 400000, 0, 0};
+    uint32_t num_samples = sizeof(timestamps_ms) / sizeof(timestamps_ms[0]);
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        distance_history_add(&history, timestamps_ms[i], distances_cm[i]);
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(num_samples, distance_history_get_count(&history), __LINE__, "ERROR: Every sample must be kept");
+
+    distance_history_iter_t iter;
+    distance_history_sample_t sample;
+    distance_history_iter_init(&iter, &history);
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        UNITY_TEST_ASSERT(distance_history_iter_next(&iter, &sample), __LINE__, "ERROR: Every sample must be read");
+        UNITY_TEST_ASSERT_EQUAL_UINT32(timestamps_ms[i], sample.timestamp_ms, __LINE__, "ERROR: The timestamp read is not the one added");
+        UNITY_TEST_ASSERT_EQUAL_UINT32(distances_cm[i], sample.distance_cm, __LINE__, "ERROR: The distance read is not the one added");
+    }
+    UNITY_TEST_ASSERT(!distance_history_iter_next(&iter, &sample), __LINE__, "ERROR: No more samples than those added must be read");
+}
+
+void test_ten_minutes_fit(void)
+{
+    for (uint32_t i = 0; i < TEST_NUM_SAMPLES; i++)
+    {
+        distance_history_add(&history, i * TEST_PERIOD_MS, _manoeuvre_distance(i));
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_NUM_SAMPLES, distance_history_get_count(&history), __LINE__, "ERROR: Ten minutes of samples at 20 Hz must fit in the history");
+    UNITY_TEST_ASSERT(history.used_blocks < DISTANCE_HISTORY_NUM_BLOCKS, __LINE__, "ERROR: No block must have been dropped");
+
+    distance_history_iter_t iter;
+    distance_history_sample_t sample;
+    distance_history_iter_init(&iter, &history);
+    for (uint32_t i = 0; i < TEST_NUM_SAMPLES; i++)
+    {
+        UNITY_TEST_ASSERT(distance_history_iter_next(&iter, &sample), __LINE__, "ERROR: Every sample must be read");
+        UNITY_TEST_ASSERT_EQUAL_UINT32(i * TEST_PERIOD_MS, sample.timestamp_ms, __LINE__, "ERROR: The timestamp read is not the one added");
+        UNITY_TEST_ASSERT_EQUAL_UINT32(_manoeuvre_distance(i), sample.distance_cm, __LINE__, "ERROR: The distance read is not the one added");
+    }
+}
+
+void test_oldest_dropped(void)
+{
+    // Much more samples than fit in the history, with changes of up to 3 cm
+    uint32_t num_samples = 8 * DISTANCE_HISTORY_NUM_BLOCKS * DISTANCE_HISTORY_BLOCK_SIZE;
+    uint32_t distance_cm = 1000;
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        distance_cm += (i % 3) - 1 + ((i % 5 == 0) ? 2 : 0);
+        distance_history_add(&history, i * TEST_PERIOD_MS, distance_cm);
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(DISTANCE_HISTORY_NUM_BLOCKS, history.used_blocks, __LINE__, "ERROR: A full history must use all its blocks");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(num_samples, history.num_samples, __LINE__, "ERROR: Every sample added must be counted");
+
+    // The samples kept are the newest ones, in order, and end with the last one added
+    uint32_t count = distance_history_get_count(&history);
+    UNITY_TEST_ASSERT(count > 0 && count < num_samples, __LINE__, "ERROR: The oldest samples must have been dropped");
+    distance_history_iter_t iter;
+    distance_history_sample_t sample;
+    distance_history_iter_init(&iter, &history);
+    uint32_t expected_ms = (num_samples - count) * TEST_PERIOD_MS;
+    uint32_t num_read = 0;
+    while (distance_history_iter_next(&iter, &sample))
+    {
+        UNITY_TEST_ASSERT_EQUAL_UINT32(expected_ms, sample.timestamp_ms, __LINE__, "ERROR: The samples kept must be consecutive");
+        expected_ms += TEST_PERIOD_MS;
+        num_read++;
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(count, num_read, __LINE__, "ERROR: Every sample kept must be read");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(distance_cm, sample.distance_cm, __LINE__, "ERROR: The last sample read must be the last one added");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_ten_minutes_fit);
+    RUN_TEST(test_oldest_dropped);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,262 @@
+/**
+ * @file test_flash_log.c
+ * @brief Unit test for the wear-levelled log of records in the non-volatile storage.
+ *
+ * The test erases the sectors reserved for the storage. It uses only the portable functions of the storage, so it can also be run on the host with the simulated storage.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_storage.h"
+#include "flash_log.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TEST_TYPE 0x42         /*!< Type of the records of the test */
+#define TEST_PAYLOAD_WORDS 16  /*!< Words of the payload of the records of the test */
+
+/* Private variables ---------------------------------------------------------*/
+static flash_log_t flash_log;      /*!< Log under test */
+static flash_log_record_t record;  /*!< Last record read */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Appends a record whose payload is made of its index.
+ *
+ * @param index Index of the record.
+ *
+ * @return `true` if the record has been appended, `false` otherwise.
+ */
+static bool _append(uint32_t index)
+{
+    uint32_t payload[TEST_PAYLOAD_WORDS];
+    for (uint32_t i = 0; i < TEST_PAYLOAD_WORDS; i++)
+    {
+        payload[i] = index;
+    }
+    return flash_log_append(&flash_log, TEST_TYPE, payload, sizeof(payload));
+}
+
+/**
+ * @brief Reads the records of the log from the oldest one and checks that their indexes are consecutive.
+ *
+ * @param p_first Pointer to the index of the first record read.
+ * @param p_num_corrupt Pointer to the number of records skipped.
+ *
+ * @return uint32_t Number of records read.
+ */
+static uint32_t _read_all(uint32_t *p_first, uint32_t *p_num_corrupt)
+{
+    flash_log_iter_t iter;
+    flash_log_iter_init(&iter, &flash_log);
+    uint32_t num_read = 0;
+    while (flash_log_iter_next(&iter, &record))
+    {
+        UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_TYPE, record.type, __LINE__, "ERROR: The type read is not the one appended");
+        UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_PAYLOAD_WORDS * sizeof(uint32_t), record.length, __LINE__, "ERROR: The length read is not the one appended");
+        if (num_read == 0)
+        {
+            *p_first = record.payload[0];
+        }
+        UNITY_TEST_ASSERT_EQUAL_UINT32(*p_first + num_read, record.payload[TEST_PAYLOAD_WORDS - 1], __LINE__, "ERROR: The records must be read in the order they were appended");
+        num_read++;
+    }
+    *p_num_corrupt = iter.num_corrupt;
+    return num_read;
+}
+
+void setUp(void)
+{
+    UNITY_TEST_ASSERT(flash_log_init(&flash_log), __LINE__, "ERROR: The log must be initialized");
+    UNITY_TEST_ASSERT(flash_log_format(&flash_log), __LINE__, "ERROR: The log must be formatted");
+}
+
+void tearDown(void)
+{
+}
+
+void test_empty(void)
+{
+    uint32_t first = 0;
+    uint32_t num_corrupt = 0;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, _read_all(&first, &num_corrupt), __LINE__, "ERROR: A formatted log must have no records");
+    UNITY_TEST_ASSERT(flash_log_init(&flash_log), __LINE__, "ERROR: A formatted log must be recovered");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(FLASH_LOG_SECTOR_HEADER_SIZE, flash_log.offset, __LINE__, "ERROR: The head of a formatted log must be after the header of the sector");
+}
+
+void test_batch_and_recovery(void)
+{
+    // Payloads of every length modulo 4, up to the largest one
+    static const uint32_t lengths[] = {0, 1, 2, 3, 4, 5, FLASH_LOG_MAX_PAYLOAD};
+    uint8_t payload[FLASH_LOG_MAX_PAYLOAD];
+    uint32_t num_records = sizeof(lengths) / sizeof(lengths[0]);
+    for (uint32_t i = 0; i < num_records; i++)
+    {
+        memset(payload, (int)(0x10 + i), sizeof(payload));
+        UNITY_TEST_ASSERT(flash_log_append(&flash_log, (uint8_t)i, payload, lengths[i]), __LINE__, "ERROR: The record must be appended");
+    }
+    UNITY_TEST_ASSERT(flash_log_get_pending_bytes(&flash_log) > 0, __LINE__, "ERROR: The last records must wait in the batch");
+    UNITY_TEST_ASSERT(!flash_log_append(&flash_log, 0, payload, FLASH_LOG_MAX_PAYLOAD + 1), __LINE__, "ERROR: A record larger than a batch must be rejected");
+    UNITY_TEST_ASSERT(flash_log_flush(&flash_log), __LINE__, "ERROR: The batch must be programmed");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, flash_log_get_pending_bytes(&flash_log), __LINE__, "ERROR: The batch must be empty after a flush");
+
+    // The head is recovered at boot where it was left
+    uint32_t offset = flash_log.offset;
+    UNITY_TEST_ASSERT(flash_log_init(&flash_log), __LINE__, "ERROR: The log must be recovered");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(offset, flash_log.offset, __LINE__, "ERROR: The head recovered is not the one left");
+
+    flash_log_iter_t iter;
+    flash_log_iter_init(&iter, &flash_log);
+    for (uint32_t i = 0; i < num_records; i++)
+    {
+        UNITY_TEST_ASSERT(flash_log_iter_next(&iter, &record), __LINE__, "ERROR: Every record must be read");
+        UNITY_TEST_ASSERT_EQUAL_UINT32(i, record.type, __LINE__, "ERROR: The type read is not the one appended");
+        UNITY_TEST_ASSERT_EQUAL_UINT32(lengths[i], record.length, __LINE__, "ERROR: The length read is not the one appended");
+        memset(payload, (int)(0x10 + i), sizeof(payload));
+        UNITY_TEST_ASSERT(memcmp(payload, record.payload, lengths[i]) == 0, __LINE__, "ERROR: The payload read is not the one appended");
+    }
+    UNITY_TEST_ASSERT(!flash_log_iter_next(&iter, &record), __LINE__, "ERROR: No more records than those appended must be read");
+}
+
+void test_rotation(void)
+{
+    // Enough records to go round the sectors and a half
+    uint32_t record_size = FLASH_LOG_RECORD_HEADER_SIZE + TEST_PAYLOAD_WORDS * sizeof(uint32_t);
+    uint32_t num_records = (flash_log.num_sectors * 3 / 2) * (flash_log.sector_size / record_size);
+    for (uint32_t i = 0; i < num_records; i++)
+    {
+        UNITY_TEST_ASSERT(_append(i), __LINE__, "ERROR: The record must be appended");
+    }
+    UNITY_TEST_ASSERT(flash_log_flush(&flash_log), __LINE__, "ERROR: The batch must be programmed");
+    UNITY_TEST_ASSERT(flash_log.num_rotations >= flash_log.num_sectors, __LINE__, "ERROR: The log must have gone round the sectors");
+
+    // The oldest records have been dropped, and the newest ones are read in order after a reboot
+    UNITY_TEST_ASSERT(flash_log_init(&flash_log), __LINE__, "ERROR: The log must be recovered");
+    uint32_t first = 0;
+    uint32_t num_corrupt = 0;
+    uint32_t num_read = _read_all(&first, &num_corrupt);
+    UNITY_TEST_ASSERT(num_read > 0 && first > 0, __LINE__, "ERROR: The oldest records must have been dropped");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(num_records, first + num_read, __LINE__, "ERROR: The last record read must be the last one appended");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, num_corrupt, __LINE__, "ERROR: No record must be corrupt");
+
+    // Every sector has been erased as often as the others
+    uint32_t min_erases = UINT32_MAX;
+    uint32_t max_erases = 0;
+    for (uint32_t sector = 0; sector < flash_log.num_sectors; sector++)
+    {
+        uint32_t erases = flash_log_get_erase_count(&flash_log, sector);
+        min_erases = (erases < min_erases) ? erases : min_erases;
+        max_erases = (erases > max_erases) ? erases : max_erases;
+    }
+    UNITY_TEST_ASSERT(max_erases - min_erases <= 1, __LINE__, "ERROR: The sectors must wear evenly");
+}
+
+void test_deferred_erase(void)
+{
+    // Enough records to fill the active sector and a whole batch, and one more
+    uint32_t record_size = FLASH_LOG_RECORD_HEADER_SIZE + TEST_PAYLOAD_WORDS * sizeof(uint32_t);
+    uint32_t num_records = (flash_log.sector_size / record_size) + (FLASH_LOG_BATCH_SIZE / record_size) + 1;
+    uint32_t num_appended = 0;
+    flash_log_set_erase_allowed(&flash_log, false);
+    for (uint32_t i = 0; i < num_records; i++)
+    {
+        num_appended += _append(i) ? 1 : 0;
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, flash_log.num_rotations, __LINE__, "ERROR: No sector must be erased while the erases are not allowed");
+    UNITY_TEST_ASSERT(!flash_log_flush(&flash_log), __LINE__, "ERROR: A batch that needs a new sector must not be programmed while the erases are not allowed");
+    UNITY_TEST_ASSERT(flash_log_get_pending_bytes(&flash_log) > 0, __LINE__, "ERROR: A batch that needs a new sector must be held");
+    UNITY_TEST_ASSERT(flash_log.num_dropped > 0, __LINE__, "ERROR: The records that do not fit in the held batch must be dropped");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(num_records, num_appended + flash_log.num_dropped, __LINE__, "ERROR: Every record must be appended or dropped");
+
+    // The next sector is erased in advance, and only once
+    UNITY_TEST_ASSERT(flash_log_prepare(&flash_log), __LINE__, "ERROR: The log must be prepared");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, flash_log.num_rotations, __LINE__, "ERROR: The next sector must be erased when the active one is full");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, flash_log_get_pending_bytes(&flash_log), __LINE__, "ERROR: The held batch must be programmed when the log is prepared");
+    UNITY_TEST_ASSERT(flash_log_prepare(&flash_log), __LINE__, "ERROR: The log must be prepared");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, flash_log.num_rotations, __LINE__, "ERROR: A sector with room for the next records must not be erased again");
+
+    // The records held are read after those of the full sector
+    UNITY_TEST_ASSERT(flash_log_init(&flash_log), __LINE__, "ERROR: The log must be recovered");
+    uint32_t first = 0;
+    uint32_t num_corrupt = 0;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(num_appended, _read_all(&first, &num_corrupt), __LINE__, "ERROR: Every record appended must be read");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, first, __LINE__, "ERROR: No record appended must be lost");
+
+    // A sector more than half full is continued in the next one in advance
+    for (uint32_t i = 0; flash_log.offset + flash_log_get_pending_bytes(&flash_log) <= flash_log.sector_size / 2; i++)
+    {
+        UNITY_TEST_ASSERT(_append(i), __LINE__, "ERROR: The record must be appended");
+    }
+    UNITY_TEST_ASSERT(flash_log_prepare(&flash_log), __LINE__, "ERROR: The log must be prepared");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, flash_log.num_rotations, __LINE__, "ERROR: The next sector must be erased in advance when the active one is half full");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(FLASH_LOG_SECTOR_HEADER_SIZE, flash_log.offset, __LINE__, "ERROR: The log must continue at the start of the next sector");
+}
+
+void test_torn_record(void)
+{
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        _append(i);
+    }
+    flash_log_flush(&flash_log);
+
+    // A record whose header was programmed but not its CRC nor its payload, as if the power were lost while programming it
+    uint32_t torn_header = (TEST_PAYLOAD_WORDS * sizeof(uint32_t)) | ((uint32_t)TEST_TYPE << 16);
+    torn_header |= (uint32_t)((TEST_PAYLOAD_WORDS * sizeof(uint32_t)) ^ TEST_TYPE ^ 0xA5) << 24;
+    UNITY_TEST_ASSERT(port_storage_program(flash_log.sector, flash_log.offset, &torn_header, 1), __LINE__, "ERROR: The torn record must be programmed");
+
+    UNITY_TEST_ASSERT(flash_log_init(&flash_log), __LINE__, "ERROR: The log must be recovered");
+    UNITY_TEST_ASSERT(!flash_log.rotate_pending, __LINE__, "ERROR: A torn record must not fill the sector");
+    _append(3);
+    flash_log_flush(&flash_log);
+
+    uint32_t first = 0;
+    uint32_t num_corrupt = 0;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(4, _read_all(&first, &num_corrupt), __LINE__, "ERROR: The records around the torn one must be read");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, num_corrupt, __LINE__, "ERROR: The torn record must be skipped");
+}
+
+void test_torn_header(void)
+{
+    _append(0);
+    flash_log_flush(&flash_log);
+
+    // A header that only cleared some of its bits
+    uint32_t torn_header = 0xF7FF7FFE;
+    UNITY_TEST_ASSERT(port_storage_program(flash_log.sector, flash_log.offset, &torn_header, 1), __LINE__, "ERROR: The torn header must be programmed");
+    uint32_t sector = flash_log.sector;
+
+    UNITY_TEST_ASSERT(flash_log_init(&flash_log), __LINE__, "ERROR: The log must be recovered");
+    UNITY_TEST_ASSERT(flash_log.rotate_pending, __LINE__, "ERROR: A torn header must fill the sector");
+    _append(1);
+    UNITY_TEST_ASSERT(flash_log_flush(&flash_log), __LINE__, "ERROR: The batch must be programmed");
+    UNITY_TEST_ASSERT(flash_log.sector != sector, __LINE__, "ERROR: The records after a torn header must go to the next sector");
+
+    uint32_t first = 0;
+    uint32_t num_corrupt = 0;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, _read_all(&first, &num_corrupt), __LINE__, "ERROR: The records around the torn header must be read");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty);
+    RUN_TEST(test_batch_and_recovery);
+    RUN_TEST(test_rotation);
+    RUN_TEST(test_deferred_erase);
+    RUN_TEST(test_torn_record);
+    RUN_TEST(test_torn_header);
+
+    exit(UNITY_END());
+}
@@ -97,6 +97,68 @@ void test_long_button_press(void)
     _test_button_press(1000);
 }
 
+/**
+ * @brief Press the button for a time and release it, firing the FSM as the main loop does
+ *
+ * @param press_time Time in milliseconds the button is pressed.
+ */
+static void _press_and_release(uint32_t press_time)
+{
+    port_button_set_pressed(PORT_PARKING_BUTTON_ID, true);
+    fsm_button_fire(p_fsm_button);
+    port_system_delay_ms(press_time);
+    fsm_button_fire(p_fsm_button);
+    port_button_set_pressed(PORT_PARKING_BUTTON_ID, false);
+    fsm_button_fire(p_fsm_button);
+    port_system_delay_ms(USER_BUTTON_DEBOUNCE_TIME_MS + 1);
+    fsm_button_fire(p_fsm_button);
+}
+
+void test_gestures(void)
+{
+    uint32_t long_press_ms = 600;
+    uint32_t double_click_ms = 400;
+    uint32_t repeat_ms = 200;
+    fsm_button_event_t event;
+    fsm_button_set_gesture_times(p_fsm_button, long_press_ms, double_click_ms, repeat_ms);
+
+    // Click: reported once the double-click time has elapsed
+    _press_and_release(USER_BUTTON_DEBOUNCE_TIME_MS + 50);
+    UNITY_TEST_ASSERT_EQUAL_PTR(NULL, fsm_button_peek_event(p_fsm_button), __LINE__, "A click should not be reported before the double-click time has elapsed");
+    UNITY_TEST_ASSERT_EQUAL_INT(true, fsm_button_check_activity(p_fsm_button), __LINE__, "A click waiting for the double-click time should be reported as activity");
+    port_system_delay_ms(double_click_ms);
+    fsm_button_fire(p_fsm_button);
+    UNITY_TEST_ASSERT_EQUAL_INT(true, fsm_button_get_event(p_fsm_button, &event), __LINE__, "A click should be reported after the double-click time");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_BUTTON_GESTURE_CLICK, event.gesture, __LINE__, "A short press should be a click");
+    UNITY_TEST_ASSERT_UINT32_WITHIN(20, USER_BUTTON_DEBOUNCE_TIME_MS + 50, event.duration_ms, __LINE__, "The duration of the click is not correct");
+    UNITY_TEST_ASSERT_EQUAL_INT(false, fsm_button_get_event(p_fsm_button, &event), __LINE__, "The queue should be empty after consuming the click");
+
+    // Double click
+    _press_and_release(USER_BUTTON_DEBOUNCE_TIME_MS + 10);
+    _press_and_release(USER_BUTTON_DEBOUNCE_TIME_MS + 10);
+    UNITY_TEST_ASSERT_EQUAL_INT(true, fsm_button_get_event(p_fsm_button, &event), __LINE__, "A double click should be reported at the second release");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_BUTTON_GESTURE_DOUBLE_CLICK, event.gesture, __LINE__, "Two clicks within the double-click time should be a double click");
+
+    // Long press and hold-repeat, reported while the button is held
+    port_button_set_pressed(PORT_PARKING_BUTTON_ID, true);
+    fsm_button_fire(p_fsm_button);
+    port_system_delay_ms(USER_BUTTON_DEBOUNCE_TIME_MS + 1);
+    fsm_button_fire(p_fsm_button);
+    port_system_delay_ms(long_press_ms - USER_BUTTON_DEBOUNCE_TIME_MS);
+    fsm_button_fire(p_fsm_button);
+    UNITY_TEST_ASSERT_EQUAL_INT(true, fsm_button_get_event(p_fsm_button, &event), __LINE__, "A long press should be reported while the button is held");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_BUTTON_GESTURE_LONG_PRESS, event.gesture, __LINE__, "A press longer than the long-press time should be a long press");
+    port_system_delay_ms(repeat_ms);
+    fsm_button_fire(p_fsm_button);
+    UNITY_TEST_ASSERT_EQUAL_INT(true, fsm_button_get_event(p_fsm_button, &event), __LINE__, "A hold-repeat should be reported while the button is held");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_BUTTON_GESTURE_HOLD_REPEAT, event.gesture, __LINE__, "Holding the button after a long press should report hold-repeats");
+    port_button_set_pressed(PORT_PARKING_BUTTON_ID, false);
+    fsm_button_fire(p_fsm_button);
+    port_system_delay_ms(double_click_ms + USER_BUTTON_DEBOUNCE_TIME_MS);
+    fsm_button_fire(p_fsm_button);
+    UNITY_TEST_ASSERT_EQUAL_PTR(NULL, fsm_button_peek_event(p_fsm_button), __LINE__, "The release of a long press should not be reported as a click");
+}
+
 int main(void)
 {
     port_system_init();
@@ -105,6 +167,7 @@ int main(void)
     RUN_TEST(test_initial_config);
     RUN_TEST(test_short_button_press);
     RUN_TEST(test_long_button_press);
+    RUN_TEST(test_gestures);
 
     exit(UNITY_END());
 }
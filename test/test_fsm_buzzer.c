@@ -0,0 +1,115 @@
+/**
+ * @file test_fsm_buzzer.c
+ * @brief Unit test for the buzzer FSM.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+/* System dependent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW independent libraries */
+#include "port_buzzer.h"
+#include "port_system.h"
+#include "stm32f4_system.h"
+#include "stm32f4_buzzer.h"
+
+/* Include FSM libraries */
+#include "fsm.h"
+#include "fsm_display.h"
+#include "fsm_buzzer.h"
+
+/* Defines */
+#define BUZZER_TONE_TIMER TIM12    /*!< Buzzer tone timer @hideinitializer */
+#define BUZZER_CADENCE_TIMER TIM14 /*!< Buzzer cadence timer @hideinitializer */
+
+/* Private variables ---------------------------------------------------------*/
+static char msg[200]; /*!< Buffer for the error messages */
+static fsm_buzzer_t *p_fsm_buzzer;
+
+/* Private functions ----------------------------------------------------------*/
+void setUp(void)
+{
+    p_fsm_buzzer = fsm_buzzer_new(PORT_REAR_PARKING_BUZZER_ID);
+}
+
+void tearDown(void)
+{
+    fsm_buzzer_destroy(p_fsm_buzzer);
+}
+
+void test_initial_config(void)
+{
+    fsm_t *p_inner_fsm = fsm_buzzer_get_inner_fsm(p_fsm_buzzer);
+    UNITY_TEST_ASSERT_EQUAL_PTR(p_fsm_buzzer, p_inner_fsm, __LINE__, "The inner FSM of fsm_buzzer_t is not the first field of the struct");
+
+    UNITY_TEST_ASSERT_EQUAL_INT(WAIT_BUZZER, fsm_get_state(p_inner_fsm), __LINE__, "The initial state of the FSM is not WAIT_BUZZER");
+
+    // It assumes there are 3 transitions in the table plus the null transition
+    fsm_trans_t *last_transition = &p_inner_fsm->p_tt[3];
+
+    UNITY_TEST_ASSERT_EQUAL_INT(-1, last_transition->orig_state, __LINE__, "The origin state of the last transition of the FSM should be -1");
+    UNITY_TEST_ASSERT_EQUAL_INT(NULL, last_transition->in, __LINE__, "The input condition function of the last transition of the FSM should be NULL");
+
+    // The buzzer must be silent after the initialization
+    uint32_t tone_en = BUZZER_TONE_TIMER->CR1 & TIM_CR1_CEN;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, tone_en, __LINE__, "The tone timer should be disabled after the initialization");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(FSM_BUZZER_NO_DISTANCE, fsm_buzzer_get_distance(p_fsm_buzzer), __LINE__, "The distance should be FSM_BUZZER_NO_DISTANCE after the initialization");
+}
+
+/**
+ * @brief Check the transition from WAIT_BUZZER to SET_BUZZER and the cadence programmed for several distances.
+ *
+ */
+void test_cadence(void)
+{
+    fsm_buzzer_set_status(p_fsm_buzzer, true);
+    fsm_buzzer_fire(p_fsm_buzzer);
+    UNITY_TEST_ASSERT_EQUAL_INT(SET_BUZZER, fsm_buzzer_get_state(p_fsm_buzzer), __LINE__, "The FSM should move to the SET_BUZZER state if the buzzer is active");
+
+    // Warning range: periodic beeps
+    fsm_buzzer_set_distance(p_fsm_buzzer, (WARNING_MIN_CM + NO_PROBLEM_MIN_CM) / 2);
+    fsm_buzzer_fire(p_fsm_buzzer);
+    sprintf(msg, "ERROR: The cadence period must be %d ms in the warning range", FSM_BUZZER_WARNING_PERIOD_MS);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(FSM_BUZZER_WARNING_PERIOD_MS - 1, BUZZER_CADENCE_TIMER->ARR, __LINE__, msg);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(FSM_BUZZER_BEEP_MS, BUZZER_CADENCE_TIMER->CCR1, __LINE__, "ERROR: The beep duration is not correct in the warning range");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CR1_CEN, BUZZER_CADENCE_TIMER->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The cadence timer must be enabled in the warning range");
+    UNITY_TEST_ASSERT_EQUAL_INT(false, fsm_buzzer_check_activity(p_fsm_buzzer), __LINE__, "The FSM should be idle once the cadence is programmed");
+
+    // Danger range: continuous tone, CCR1 above ARR
+    fsm_buzzer_set_distance(p_fsm_buzzer, DANGER_MIN_CM);
+    fsm_buzzer_fire(p_fsm_buzzer);
+    UNITY_TEST_ASSERT_EQUAL_INT(true, BUZZER_CADENCE_TIMER->CCR1 > BUZZER_CADENCE_TIMER->ARR, __LINE__, "ERROR: The tone must be continuous in the danger range");
+
+    // Out of range: silent
+    fsm_buzzer_set_distance(p_fsm_buzzer, OK_MAX_CM + 1);
+    fsm_buzzer_fire(p_fsm_buzzer);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, BUZZER_TONE_TIMER->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The tone timer must be disabled out of range");
+}
+
+void test_check_off(void)
+{
+    fsm_buzzer_set_state(p_fsm_buzzer, SET_BUZZER);
+    fsm_buzzer_set_status(p_fsm_buzzer, false);
+    fsm_buzzer_fire(p_fsm_buzzer);
+
+    UNITY_TEST_ASSERT_EQUAL_INT(WAIT_BUZZER, fsm_buzzer_get_state(p_fsm_buzzer), __LINE__, "The FSM should move to the WAIT_BUZZER state if the buzzer is not active");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, BUZZER_CADENCE_TIMER->CR1 & TIM_CR1_CEN, __LINE__, "The cadence timer should be disabled if the buzzer is not active");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, BUZZER_TONE_TIMER->CCER & TIM_CCER_CC1E, __LINE__, "The tone output should be disabled if the buzzer is not active");
+    UNITY_TEST_ASSERT_EQUAL_INT(false, fsm_buzzer_check_activity(p_fsm_buzzer), __LINE__, "The FSM should not report activity if the buzzer is not active");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_initial_config);
+    RUN_TEST(test_cadence);
+    RUN_TEST(test_check_off);
+
+    exit(UNITY_END());
+}
@@ -216,6 +216,104 @@ void test_check_off(void)
 }
 
 
+/**
+ * @brief Check the classification of distances with the default band table and with a band table loaded at runtime
+ *
+ */
+void test_bands(void)
+{
+    // Default table
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_DISPLAY_URGENCY_DANGER, fsm_display_get_urgency(p_fsm_display, DANGER_MIN_CM), __LINE__, "The minimum distance should have urgency DANGER with the default bands");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_DISPLAY_URGENCY_HIGH, fsm_display_get_urgency(p_fsm_display, WARNING_MIN_CM), __LINE__, "The upper limit of the Danger range should have urgency HIGH with the default bands");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_DISPLAY_URGENCY_MEDIUM, fsm_display_get_urgency(p_fsm_display, WARNING_MIN_CM + 1), __LINE__, "The lower limit of the Warning range should have urgency MEDIUM with the default bands");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_DISPLAY_URGENCY_NONE, fsm_display_get_urgency(p_fsm_display, OK_MAX_CM + 1), __LINE__, "A distance out of range should have urgency NONE");
+    UNITY_TEST_ASSERT_EQUAL_PTR(NULL, fsm_display_get_band(p_fsm_display, -1), __LINE__, "A negative distance should not belong to any band");
+
+    const fsm_display_band_t *p_band = fsm_display_get_band(p_fsm_display, (OK_MIN_CM + INFO_MIN_CM) / 2);
+    UNITY_TEST_ASSERT_EQUAL_UINT8(25, p_band->color.r, __LINE__, "The color of the Info range is not correct with the default bands");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(89, p_band->color.g, __LINE__, "The color of the Info range is not correct with the default bands");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(81, p_band->color.b, __LINE__, "The color of the Info range is not correct with the default bands");
+
+    rgb_color_t color;
+    uint8_t level = _compute_display_levels(p_fsm_display, &color, WARNING_MIN_CM);
+    UNITY_TEST_ASSERT_EQUAL_UINT8(255, color.r, __LINE__, "The color of the Danger range is not correct with the default bands");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(0, color.g + color.b, __LINE__, "The color of the Danger range is not correct with the default bands");
+    UNITY_TEST_ASSERT(level > _compute_display_levels(p_fsm_display, &color, OK_MAX_CM), __LINE__, "The fill level should be higher for a closer obstacle");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(0, _compute_display_levels(p_fsm_display, &color, OK_MAX_CM + 1), __LINE__, "The fill level should be 0 for a distance out of range");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(0, color.r + color.g + color.b, __LINE__, "The color should be off for a distance out of range");
+
+    // Tables that are not sorted or too long are rejected and the previous table is kept
+    fsm_display_band_t unsorted_bands[] = {{100, COLOR_RED, FSM_DISPLAY_URGENCY_DANGER, 0}, {100, COLOR_GREEN, FSM_DISPLAY_URGENCY_LOW, FSM_DISPLAY_BEEP_SILENT}};
+    UNITY_TEST_ASSERT_EQUAL_INT(false, fsm_display_load_bands(p_fsm_display, unsorted_bands, 2), __LINE__, "A band table that is not sorted should be rejected");
+    UNITY_TEST_ASSERT_EQUAL_INT(false, fsm_display_load_bands(p_fsm_display, unsorted_bands, FSM_DISPLAY_MAX_BANDS + 1), __LINE__, "A band table with too many bands should be rejected");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_DISPLAY_URGENCY_DANGER, fsm_display_get_urgency(p_fsm_display, DANGER_MIN_CM), __LINE__, "The previous band table should be kept if the new one is not valid");
+
+    // Table for a bigger vehicle
+    fsm_display_band_t bands[] = {
+        {40, COLOR_RED, FSM_DISPLAY_URGENCY_DANGER, 0},
+        {80, COLOR_YELLOW, FSM_DISPLAY_URGENCY_HIGH, 250},
+        {300, COLOR_GREEN, FSM_DISPLAY_URGENCY_LOW, FSM_DISPLAY_BEEP_SILENT},
+    };
+    UNITY_TEST_ASSERT_EQUAL_INT(true, fsm_display_load_bands(p_fsm_display, bands, 3), __LINE__, "A valid band table should be loaded");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_DISPLAY_URGENCY_DANGER, fsm_display_get_urgency(p_fsm_display, 40), __LINE__, "The upper limit of a band should belong to the band");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_DISPLAY_URGENCY_HIGH, fsm_display_get_urgency(p_fsm_display, 41), __LINE__, "The distance next to the upper limit of a band should belong to the next band");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_DISPLAY_URGENCY_LOW, fsm_display_get_urgency(p_fsm_display, 250), __LINE__, "The distance should belong to the last band");
+    UNITY_TEST_ASSERT_EQUAL_INT(FSM_DISPLAY_URGENCY_NONE, fsm_display_get_urgency(p_fsm_display, 301), __LINE__, "A distance beyond the last band should be out of range");
+
+    // The color of the loaded table is shown
+    fsm_display_set_state(p_fsm_display, SET_DISPLAY);
+    fsm_display_set_status(p_fsm_display, true);
+    fsm_display_set_distance(p_fsm_display, 60);
+    fsm_display_fire(p_fsm_display);
+    uint32_t blue_ccer = DISPLAY_RGB_PWM->CCER & TIM_CCER_CC4E;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, blue_ccer, __LINE__, "The blue LED should be off with the yellow color of the loaded band table");
+    uint32_t red_ccer = DISPLAY_RGB_PWM->CCER & TIM_CCER_CC1E;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CCER_CC1E, red_ccer, __LINE__, "The red LED should be on with the yellow color of the loaded band table");
+}
+
+/**
+ * @brief Check that the distances set faster than the frame rate are coalesced, that the latest one is shown, and that the danger distances bypass the frame rate
+ *
+ */
+void test_frame_rate(void)
+{
+    uint32_t test_max_fps = 10;
+    fsm_display_set_max_frame_rate(p_fsm_display, test_max_fps);
+    fsm_display_set_state(p_fsm_display, SET_DISPLAY);
+    fsm_display_set_status(p_fsm_display, true);
+
+    // The first frame is shown at once
+    fsm_display_set_distance(p_fsm_display, OK_MAX_CM);
+    fsm_display_fire(p_fsm_display);
+    uint32_t blue_ccer = DISPLAY_RGB_PWM->CCER & TIM_CCER_CC4E;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CCER_CC4E, blue_ccer, __LINE__, "The first distance should be shown at once");
+
+    // Distances within the frame period are coalesced
+    fsm_display_set_distance(p_fsm_display, INFO_MIN_CM);
+    fsm_display_set_distance(p_fsm_display, NO_PROBLEM_MIN_CM);
+    fsm_display_fire(p_fsm_display);
+    blue_ccer = DISPLAY_RGB_PWM->CCER & TIM_CCER_CC4E;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CCER_CC4E, blue_ccer, __LINE__, "A distance set before the end of the frame period should not be shown yet");
+    UNITY_TEST_ASSERT_EQUAL_INT(false, fsm_display_check_activity(p_fsm_display), __LINE__, "A distance waiting for the next frame should not be reported as activity");
+    UNITY_TEST_ASSERT_EQUAL_INT(true, fsm_display_check_pending_frame(p_fsm_display), __LINE__, "A distance waiting for the next frame should be reported as pending");
+
+    // The latest distance is shown once the frame period has elapsed
+    port_system_delay_ms(1000 / test_max_fps + 1);
+    UNITY_TEST_ASSERT_EQUAL_INT(true, fsm_display_check_activity(p_fsm_display), __LINE__, "A distance should be reported as activity once the frame period has elapsed");
+    UNITY_TEST_ASSERT_EQUAL_INT(false, fsm_display_check_pending_frame(p_fsm_display), __LINE__, "A distance should not be pending once the frame period has elapsed");
+    fsm_display_fire(p_fsm_display);
+    blue_ccer = DISPLAY_RGB_PWM->CCER & TIM_CCER_CC4E;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, blue_ccer, __LINE__, "The latest distance should be shown once the frame period has elapsed");
+    uint32_t red_ccer = DISPLAY_RGB_PWM->CCER & TIM_CCER_CC1E;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CCER_CC1E, red_ccer, __LINE__, "The latest distance should be shown once the frame period has elapsed");
+
+    // A danger distance is shown at once
+    fsm_display_set_distance(p_fsm_display, DANGER_MIN_CM);
+    fsm_display_fire(p_fsm_display);
+    uint32_t green_ccer = DISPLAY_RGB_PWM->CCER & TIM_CCER_CC3E;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, green_ccer, __LINE__, "A danger distance should bypass the frame rate");
+}
+
 int main(void)
 {
     port_system_init();
@@ -225,6 +323,8 @@ int main(void)
     RUN_TEST(test_activation);
     RUN_TEST(test_new_color);
     RUN_TEST(test_check_off);
+    RUN_TEST(test_bands);
+    RUN_TEST(test_frame_rate);
 
     exit(UNITY_END());
 }
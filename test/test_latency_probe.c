@@ -0,0 +1,97 @@
+/**
+ * @file test_latency_probe.c
+ * @brief Unit test for the histogram of the latencies of a path of the system.
+ *
+ * The histogram does not depend on the hardware, so this test can be run on the host.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "latency_probe.h"
+
+/* Private variables ---------------------------------------------------------*/
+static latency_probe_t probe; /*!< Histogram under test */
+
+/* Private functions ----------------------------------------------------------*/
+void setUp(void)
+{
+    latency_probe_init(&probe);
+}
+
+void tearDown(void)
+{
+}
+
+void test_empty(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, probe.count, __LINE__, "ERROR: An empty histogram must have no samples");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, latency_probe_get_percentile_us(&probe, 500), __LINE__, "ERROR: The percentiles of an empty histogram must be 0");
+}
+
+void test_min_max(void)
+{
+    latency_probe_record(&probe, 700);
+    latency_probe_record(&probe, 25);
+    latency_probe_record(&probe, 90000);
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, probe.count, __LINE__, "ERROR: Every latency must be counted");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(25, probe.min_us, __LINE__, "ERROR: The minimum latency is not correct");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(90000, probe.max_us, __LINE__, "ERROR: The maximum latency is not correct");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(90000, probe.last_us, __LINE__, "ERROR: The last latency is not correct");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(25, latency_probe_get_percentile_us(&probe, 0), __LINE__, "ERROR: The lowest percentile must be the minimum");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(90000, latency_probe_get_percentile_us(&probe, 1000), __LINE__, "ERROR: The highest percentile must be the maximum");
+}
+
+void test_exact_small(void)
+{
+    // Below LATENCY_PROBE_LINEAR_US every latency has its own bucket
+    for (uint32_t latency_us = 0; latency_us < LATENCY_PROBE_LINEAR_US; latency_us++)
+    {
+        latency_probe_record(&probe, latency_us);
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(LATENCY_PROBE_LINEAR_US / 2 - 1, latency_probe_get_percentile_us(&probe, 500), __LINE__, "ERROR: The median of small latencies must be exact");
+}
+
+void test_percentiles(void)
+{
+    // 1 to 1000 ms: the percentiles are within the relative error of a bucket
+    for (uint32_t i = 1; i <= 1000; i++)
+    {
+        latency_probe_record(&probe, i * 1000);
+    }
+    uint32_t p50_us = latency_probe_get_percentile_us(&probe, 500);
+    uint32_t p99_us = latency_probe_get_percentile_us(&probe, 990);
+    UNITY_TEST_ASSERT(p50_us >= 500000 && p50_us <= 500000 + 500000 / LATENCY_PROBE_SUB_BUCKETS, __LINE__, "ERROR: The median is not within the error of a bucket");
+    UNITY_TEST_ASSERT(p99_us >= 990000 && p99_us <= 1000000, __LINE__, "ERROR: The 99th percentile is not within the error of a bucket");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(500500, (uint32_t)(probe.sum_us / probe.count), __LINE__, "ERROR: The mean latency is not correct");
+}
+
+void test_overflow(void)
+{
+    latency_probe_record(&probe, UINT32_MAX);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, probe.buckets[LATENCY_PROBE_NUM_BUCKETS - 1], __LINE__, "ERROR: The longest latencies must go to the last bucket");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, latency_probe_get_percentile_us(&probe, 500), __LINE__, "ERROR: The percentile of the last bucket must be the maximum");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty);
+    RUN_TEST(test_min_max);
+    RUN_TEST(test_exact_small);
+    RUN_TEST(test_percentiles);
+    RUN_TEST(test_overflow);
+
+    exit(UNITY_END());
+}
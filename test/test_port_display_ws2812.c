@@ -0,0 +1,121 @@
+/**
+ * @file test_port_display_ws2812.c
+ * @brief Unit test for the encoding of the frames of the WS2812 LED bar displays.
+ *
+ * The encoding does not depend on the hardware, so this test can be run on the host.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 05/05/2025
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_display.h"
+#include "port_display_ws2812.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_T0H 6  /*!< Compare value of a 0 bit used in the tests @hideinitializer */
+#define TEST_T1H 13 /*!< Compare value of a 1 bit used in the tests @hideinitializer */
+#define TEST_NUM_LEDS 8 /*!< Number of LEDs of the bar used in the tests @hideinitializer */
+#define TEST_LATCH_SLOTS 40 /*!< Number of slots of the 50 us low time that latches a frame at 800 kHz @hideinitializer */
+
+/* Private variables ---------------------------------------------------------*/
+static char msg[200]; /*!< Buffer for the error messages */
+static uint16_t frame[PORT_DISPLAY_WS2812_FRAME_SLOTS(TEST_NUM_LEDS)];
+
+/* Private functions ----------------------------------------------------------*/
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Check that a byte is encoded most significant bit first.
+ *
+ * @param p_slot Pointer to the first slot of the byte.
+ * @param value Expected value of the byte.
+ * @param line Line of the caller.
+ */
+
+static void _check_byte(const uint16_t *p_slot, uint8_t value, uint32_t line)
+{
+    for (uint32_t bit = 0; bit < 8; bit++)
+    {
+        uint16_t expected = (value & (0x80 >> bit)) ? TEST_T1H : TEST_T0H;
+        sprintf(msg, "ERROR: Bit %lu of the byte 0x%02X is not encoded correctly", (unsigned long)bit, value);
+        UNITY_TEST_ASSERT_EQUAL_UINT16(expected, p_slot[bit], line, msg);
+    }
+}
+
+void test_lit_leds(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_display_ws2812_get_lit_leds(0, TEST_NUM_LEDS), __LINE__, "ERROR: No LED must be lit with level 0");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, port_display_ws2812_get_lit_leds(1, TEST_NUM_LEDS), __LINE__, "ERROR: At least one LED must be lit with a level greater than 0");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_NUM_LEDS / 2, port_display_ws2812_get_lit_leds(PORT_DISPLAY_RGB_MAX_VALUE / 2, TEST_NUM_LEDS), __LINE__, "ERROR: Half of the LEDs must be lit with half of the maximum level");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_NUM_LEDS, port_display_ws2812_get_lit_leds(PORT_DISPLAY_RGB_MAX_VALUE, TEST_NUM_LEDS), __LINE__, "ERROR: All the LEDs must be lit with the maximum level");
+}
+
+void test_encode_byte(void)
+{
+    uint16_t slots[8];
+    uint16_t *p_next = port_display_ws2812_encode_byte(0xA5, TEST_T0H, TEST_T1H, slots);
+
+    UNITY_TEST_ASSERT_EQUAL_PTR(&slots[8], p_next, __LINE__, "ERROR: A byte must be encoded in 8 slots");
+    _check_byte(slots, 0xA5, __LINE__);
+}
+
+void test_encode_bar(void)
+{
+    rgb_color_t color = {0x12, 0x34, 0x56};
+    uint32_t num_slots = port_display_ws2812_encode_bar(frame, TEST_NUM_LEDS, color, PORT_DISPLAY_RGB_MAX_VALUE / 2, TEST_T0H, TEST_T1H);
+
+    sprintf(msg, "ERROR: The frame of %d LEDs must have %d slots", TEST_NUM_LEDS, PORT_DISPLAY_WS2812_FRAME_SLOTS(TEST_NUM_LEDS));
+    UNITY_TEST_ASSERT_EQUAL_UINT32(PORT_DISPLAY_WS2812_FRAME_SLOTS(TEST_NUM_LEDS), num_slots, __LINE__, msg);
+
+    // The lit LEDs are sent in green, red, blue order
+    for (uint32_t led = 0; led < TEST_NUM_LEDS / 2; led++)
+    {
+        const uint16_t *p_led = &frame[led * PORT_DISPLAY_WS2812_BITS_PER_LED];
+        _check_byte(&p_led[0], color.g, __LINE__);
+        _check_byte(&p_led[8], color.r, __LINE__);
+        _check_byte(&p_led[16], color.b, __LINE__);
+    }
+
+    // The rest of the LEDs are off
+    for (uint32_t led = TEST_NUM_LEDS / 2; led < TEST_NUM_LEDS; led++)
+    {
+        const uint16_t *p_led = &frame[led * PORT_DISPLAY_WS2812_BITS_PER_LED];
+        _check_byte(&p_led[0], 0, __LINE__);
+        _check_byte(&p_led[8], 0, __LINE__);
+        _check_byte(&p_led[16], 0, __LINE__);
+    }
+
+    // The line is left low at the end of the frame, long enough to latch it
+    sprintf(msg, "ERROR: The frame must end with at least %d slots at 0 to latch it", TEST_LATCH_SLOTS);
+    UNITY_TEST_ASSERT(num_slots - TEST_NUM_LEDS * PORT_DISPLAY_WS2812_BITS_PER_LED >= TEST_LATCH_SLOTS, __LINE__, msg);
+    for (uint32_t slot = TEST_NUM_LEDS * PORT_DISPLAY_WS2812_BITS_PER_LED; slot < num_slots; slot++)
+    {
+        UNITY_TEST_ASSERT_EQUAL_UINT16(0, frame[slot], __LINE__, "ERROR: The reset slots at the end of the frame must be 0");
+    }
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_lit_leds);
+    RUN_TEST(test_encode_byte);
+    RUN_TEST(test_encode_bar);
+
+    exit(UNITY_END());
+}
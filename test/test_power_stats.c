@@ -0,0 +1,98 @@
+/**
+ * @file test_power_stats.c
+ * @brief Unit test for the accounting of the time and the energy spent in each state and power mode.
+ *
+ * The times are given explicitly instead of read from the power clock, so this test can be run on the host.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "power_stats.h"
+
+/* Private variables ---------------------------------------------------------*/
+static power_stats_t stats; /*!< Accounting under test */
+
+/* Private functions ----------------------------------------------------------*/
+void setUp(void)
+{
+    power_stats_init(&stats, 0, 1000);
+}
+
+void tearDown(void)
+{
+}
+
+void test_init(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(POWER_STATS_MAGIC, stats.magic, __LINE__, "ERROR: The magic number must be set by the initialization");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(POWER_STATS_MODE_RUN, stats.mode, __LINE__, "ERROR: The accounting must start in run mode");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, stats.num_entries[0][POWER_STATS_MODE_RUN], __LINE__, "ERROR: The initial state must be entered once");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, power_stats_get_cpu_load_permille(&stats), __LINE__, "ERROR: The CPU load must be 0 if no time has been accounted");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)power_stats_get_total_energy_uj(&stats), __LINE__, "ERROR: The energy must be 0 if no time has been accounted");
+}
+
+void test_residency(void)
+{
+    power_stats_set_mode(&stats, POWER_STATS_MODE_SLEEP, 3000);
+    power_stats_set_mode(&stats, POWER_STATS_MODE_RUN, 10000);
+    power_stats_set_state(&stats, 1, 10500);
+    power_stats_set_state(&stats, 1, 11000); // Same state: nothing is accounted
+    power_stats_set_mode(&stats, POWER_STATS_MODE_STOP, 12000);
+    power_stats_update(&stats, 20000);
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2500, (uint32_t)power_stats_get_residency_us(&stats, 0, POWER_STATS_MODE_RUN), __LINE__, "ERROR: The time in run mode before and after the sleep must be accounted to the first state");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(7000, (uint32_t)power_stats_get_residency_us(&stats, 0, POWER_STATS_MODE_SLEEP), __LINE__, "ERROR: The time asleep must be accounted to the first state");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1500, (uint32_t)power_stats_get_residency_us(&stats, 1, POWER_STATS_MODE_RUN), __LINE__, "ERROR: The time in run mode must be accounted to the second state");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(8000, (uint32_t)power_stats_get_residency_us(&stats, 1, POWER_STATS_MODE_STOP), __LINE__, "ERROR: The time stopped must be accounted until the last update");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, stats.num_state_changes, __LINE__, "ERROR: Only the changes to a different state must be counted");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, stats.num_entries[0][POWER_STATS_MODE_RUN], __LINE__, "ERROR: Waking up must count as an entry in run mode");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, stats.num_entries[1][POWER_STATS_MODE_STOP], __LINE__, "ERROR: Stopping must count as an entry in stop mode");
+
+    // Run 4000 us out of 19000 us
+    UNITY_TEST_ASSERT_EQUAL_UINT32(210, power_stats_get_cpu_load_permille(&stats), __LINE__, "ERROR: The CPU load must be the fraction of the time in run mode");
+}
+
+void test_high_states(void)
+{
+    power_stats_set_state(&stats, POWER_STATS_MAX_STATES + 3, 2000);
+    power_stats_update(&stats, 5000);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3000, (uint32_t)power_stats_get_residency_us(&stats, POWER_STATS_MAX_STATES - 1, POWER_STATS_MODE_RUN), __LINE__, "ERROR: The states out of range must be accounted as the last one");
+}
+
+void test_energy(void)
+{
+    static const uint32_t current_ua[POWER_STATS_NUM_MODES] = {10000, 1000, 10};
+    power_stats_set_current_table(&stats, current_ua, 3000);
+
+    // 1 s at 10 mA and 3 V is 30000 uJ, 2 s at 1 mA is 6000 uJ and 10 s at 10 uA is 300 uJ
+    power_stats_set_mode(&stats, POWER_STATS_MODE_SLEEP, 1001000);
+    power_stats_set_state(&stats, 2, 2001000);
+    power_stats_set_mode(&stats, POWER_STATS_MODE_STOP, 3001000);
+    power_stats_update(&stats, 13001000);
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(33000, (uint32_t)power_stats_get_energy_uj(&stats, 0), __LINE__, "ERROR: The energy of a state must add the energy of each power mode");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3300, (uint32_t)power_stats_get_energy_uj(&stats, 2), __LINE__, "ERROR: The energy of a state must use the current of each power mode");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(36300, (uint32_t)power_stats_get_total_energy_uj(&stats), __LINE__, "ERROR: The total energy must add the energy of every state");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_init);
+    RUN_TEST(test_residency);
+    RUN_TEST(test_high_states);
+    RUN_TEST(test_energy);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,123 @@
+/**
+ * @file test_ranging_stats.c
+ * @brief Unit test for the running statistics of the pings of an ultrasound sensor.
+ *
+ * The statistics do not depend on the hardware, so this test can be run on the host.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "ranging_stats.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TEST_PERIOD_US 100000 /*!< Period of the pings (10 Hz) */
+#define TEST_ECHO_US 5831     /*!< Width of the echo of an obstacle at 100 cm */
+#define TEST_Q16(x) ((uint32_t)((x) * 65536.0 + 0.5)) /*!< Value in Q16.16 */
+
+/* Private variables ---------------------------------------------------------*/
+static ranging_stats_t stats;              /*!< Statistics under test */
+static ranging_stats_snapshot_t snapshot;  /*!< Snapshot of the statistics */
+
+void setUp(void)
+{
+    ranging_stats_init(&stats);
+}
+
+void tearDown(void)
+{
+}
+
+void test_empty(void)
+{
+    ranging_stats_get_snapshot(&stats, &snapshot);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, snapshot.num_pings, __LINE__, "ERROR: Empty statistics must have no pings");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, snapshot.variance_cm2_q16, __LINE__, "ERROR: Empty statistics must have no variance");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, snapshot.ping_rate_millihz, __LINE__, "ERROR: Empty statistics must have no ping rate");
+}
+
+void test_mean_and_variance(void)
+{
+    static const uint32_t distances_cm[] = {100, 102, 98, 101, 99};
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        ranging_stats_add_ping(&stats, i * TEST_PERIOD_US, TEST_ECHO_US, distances_cm[i], false);
+    }
+    ranging_stats_get_snapshot(&stats, &snapshot);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(5, snapshot.num_samples, __LINE__, "ERROR: Every distance in range must be a sample");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(98, snapshot.min_cm, __LINE__, "ERROR: Wrong minimum distance");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(102, snapshot.max_cm, __LINE__, "ERROR: Wrong maximum distance");
+    UNITY_TEST_ASSERT(abs((int32_t)(snapshot.mean_cm_q16 - TEST_Q16(100))) <= 4, __LINE__, "ERROR: The mean must be 100 cm");
+    UNITY_TEST_ASSERT(abs((int32_t)(snapshot.variance_cm2_q16 - TEST_Q16(2.5))) <= 16, __LINE__, "ERROR: The sample variance must be 2.5 cm2");
+}
+
+void test_long_run_is_stable(void)
+{
+    // The noise of a still obstacle over hours of pings: the fixed point must not drift
+    for (uint32_t i = 0; i < 100000; i++)
+    {
+        ranging_stats_add_ping(&stats, i * TEST_PERIOD_US, TEST_ECHO_US, (i % 2 == 0) ? 200 : 202, false);
+    }
+    ranging_stats_get_snapshot(&stats, &snapshot);
+    UNITY_TEST_ASSERT(abs((int32_t)(snapshot.mean_cm_q16 - TEST_Q16(201))) <= 64, __LINE__, "ERROR: The mean must be 201 cm");
+    UNITY_TEST_ASSERT(abs((int32_t)(snapshot.variance_cm2_q16 - TEST_Q16(1))) <= 656, __LINE__, "ERROR: The variance must be 1 cm2 within 1%");
+}
+
+void test_classes(void)
+{
+    uint32_t time_us = 0;
+    ranging_stats_add_ping(&stats, time_us += TEST_PERIOD_US, 38000, 651, false); // No echo
+    ranging_stats_add_ping(&stats, time_us += TEST_PERIOD_US, 29000, 497, false); // Beyond the range
+    ranging_stats_add_ping(&stats, time_us += TEST_PERIOD_US, 58, 0, false);      // Too close
+    ranging_stats_add_ping(&stats, time_us += TEST_PERIOD_US, TEST_ECHO_US, 100, true);
+    ranging_stats_get_snapshot(&stats, &snapshot);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(4, snapshot.num_pings, __LINE__, "ERROR: Every ping must be counted");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, snapshot.num_timeouts, __LINE__, "ERROR: The pulse of a missing echo must be a timeout");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, snapshot.num_out_of_range, __LINE__, "ERROR: The echoes out of the range of the sensor must be counted");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, snapshot.num_overflows, __LINE__, "ERROR: The overflows of the echo timer must be counted");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, snapshot.num_samples, __LINE__, "ERROR: Only the echoes in range must be samples");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(100, snapshot.max_cm, __LINE__, "ERROR: The pings out of range must not change the distance statistics");
+}
+
+void test_rate_and_jitter(void)
+{
+    // Pings at 10 Hz, every other one 2 ms late
+    uint32_t time_us = 0;
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        ranging_stats_add_ping(&stats, time_us + ((i % 2) ? 2000 : 0), TEST_ECHO_US, 100, false);
+        time_us += TEST_PERIOD_US;
+    }
+    ranging_stats_get_snapshot(&stats, &snapshot);
+    UNITY_TEST_ASSERT(abs((int32_t)snapshot.period_us - TEST_PERIOD_US) <= 2000, __LINE__, "ERROR: The period must be 100 ms");
+    UNITY_TEST_ASSERT(abs((int32_t)snapshot.ping_rate_millihz - 10000) <= 200, __LINE__, "ERROR: The ping rate must be 10 Hz");
+    UNITY_TEST_ASSERT(abs((int32_t)snapshot.jitter_us - 4000) <= 100, __LINE__, "ERROR: The jitter must be the 4 ms change of the period");
+
+    // A pause of the sensor is not a period
+    ranging_stats_restart(&stats);
+    ranging_stats_add_ping(&stats, time_us + 500000, TEST_ECHO_US, 100, false);
+    ranging_stats_get_snapshot(&stats, &snapshot);
+    UNITY_TEST_ASSERT(abs((int32_t)snapshot.period_us - TEST_PERIOD_US) <= 2000, __LINE__, "ERROR: A restart must not change the period");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty);
+    RUN_TEST(test_mean_and_variance);
+    RUN_TEST(test_long_run_is_stable);
+    RUN_TEST(test_classes);
+    RUN_TEST(test_rate_and_jitter);
+
+    exit(UNITY_END());
+}
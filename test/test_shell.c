@@ -0,0 +1,165 @@
+/**
+ * @file test_shell.c
+ * @brief Unit test for the command shell: line parsing, get and set of the parameters, and errors.
+ *
+ * The commands are fed a character at a time, as `shell_service()` does, and the replies are captured instead of sent.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "shell.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TEST_REPLY_SIZE 512 /*!< Size of the replies captured */
+
+/* Private variables ---------------------------------------------------------*/
+static shell_t shell;                /*!< Shell under test */
+static char reply[TEST_REPLY_SIZE];  /*!< Replies written since the last command */
+static uint32_t reply_length;        /*!< Length of the replies */
+static uint32_t period_ms;           /*!< Parameter stored only */
+static uint32_t threshold;           /*!< Parameter with a setter */
+static uint32_t num_sets;            /*!< Calls to the setter */
+
+/* Private functions ----------------------------------------------------------*/
+static void _write(void *p_ctx, const char *p_text, uint32_t length)
+{
+    UNITY_TEST_ASSERT(reply_length + length < TEST_REPLY_SIZE, __LINE__, "ERROR: The replies do not fit in the capture");
+    memcpy(&reply[reply_length], p_text, length);
+    reply_length += length;
+    reply[reply_length] = '\0';
+}
+
+static bool _set_threshold(void *p_ctx, const shell_param_t *p_param, uint32_t value)
+{
+    // The system only accepts even thresholds
+    num_sets++;
+    return (value % 2) == 0;
+}
+
+static const shell_param_t params[] = {
+    SHELL_PARAM("period_ms", &period_ms, 10, 1000, NULL, "Period"),
+    SHELL_PARAM("threshold", &threshold, 0, 0xFFFF, _set_threshold, "Threshold, even"),
+};
+
+static void _type(const char *p_text)
+{
+    reply_length = 0;
+    reply[0] = '\0';
+    while (*p_text != '\0')
+    {
+        shell_feed(&shell, *p_text++);
+    }
+}
+
+void setUp(void)
+{
+    period_ms = 100;
+    threshold = 0;
+    num_sets = 0;
+    shell_init(&shell, params, sizeof(params) / sizeof(params[0]), _write, NULL, NULL);
+}
+
+void tearDown(void)
+{
+}
+
+void test_get(void)
+{
+    _type("get period_ms\r\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("period_ms = 100\n", reply, __LINE__, "ERROR: Wrong reply to get");
+    _type("get\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("period_ms = 100\nthreshold = 0\n", reply, __LINE__, "ERROR: get without a name must write every parameter");
+    _type("get  \t period_ms   \n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("period_ms = 100\n", reply, __LINE__, "ERROR: Extra spaces must be ignored");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, shell.num_commands, __LINE__, "ERROR: The empty line of a CR LF must not be a command");
+}
+
+void test_set(void)
+{
+    _type("set period_ms 250\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("period_ms = 250\n", reply, __LINE__, "ERROR: Wrong reply to set");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(250, period_ms, __LINE__, "ERROR: set must store the value");
+    _type("set threshold 0x1F4\n");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(500, threshold, __LINE__, "ERROR: Hexadecimal values must be accepted");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, num_sets, __LINE__, "ERROR: set must call the setter");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, shell.num_errors, __LINE__, "ERROR: No command must have failed");
+}
+
+void test_set_errors(void)
+{
+    _type("set period_ms 5\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("error: period_ms must be in [10, 1000]\n", reply, __LINE__, "ERROR: A value out of range must be rejected");
+    _type("set threshold 7\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("error: threshold 7 rejected\n", reply, __LINE__, "ERROR: A value rejected by the setter must be reported");
+    _type("set period_ms -20\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("error: invalid value -20\n", reply, __LINE__, "ERROR: A negative value must be invalid");
+    _type("set period_ms 12ms\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("error: invalid value 12ms\n", reply, __LINE__, "ERROR: Trailing characters must be invalid");
+    _type("set period_ms 0x100000000\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("error: invalid value 0x100000000\n", reply, __LINE__, "ERROR: A value beyond 32 bits must be invalid");
+    _type("set speed 3\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("error: unknown parameter speed\n", reply, __LINE__, "ERROR: An unknown parameter must be reported");
+    _type("set period_ms\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("error: usage: set <name> <value>\n", reply, __LINE__, "ERROR: A missing value must be reported");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(100, period_ms, __LINE__, "ERROR: A rejected value must not be stored");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, threshold, __LINE__, "ERROR: A value rejected by the setter must not be stored");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(7, shell.num_errors, __LINE__, "ERROR: Every rejected command must be counted");
+}
+
+void test_line_editing(void)
+{
+    _type("gex\x7ft period_mx\bs\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("period_ms = 100\n", reply, __LINE__, "ERROR: Backspace must remove the last character");
+    _type("\b\bget\x01 period_ms\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("period_ms = 100\n", reply, __LINE__, "ERROR: Control characters and backspaces on an empty line must be ignored");
+    _type("reboot\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("error: unknown command reboot, try help\n", reply, __LINE__, "ERROR: An unknown command must be reported");
+}
+
+void test_long_line_is_discarded(void)
+{
+    char line[SHELL_LINE_SIZE + 16];
+    memset(line, 'a', sizeof(line) - 2);
+    line[sizeof(line) - 2] = '\n';
+    line[sizeof(line) - 1] = '\0';
+    memcpy(line, "set period_ms 20 ", 17);
+    _type(line);
+    UNITY_TEST_ASSERT_EQUAL_STRING("error: line longer than 63 characters\n", reply, __LINE__, "ERROR: A long line must be reported");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(100, period_ms, __LINE__, "ERROR: A long line must not be executed");
+    _type("get period_ms\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("period_ms = 100\n", reply, __LINE__, "ERROR: The line after a long one must be executed");
+}
+
+void test_help(void)
+{
+    _type("help\n");
+    UNITY_TEST_ASSERT(strstr(reply, "set <name> <value>") != NULL, __LINE__, "ERROR: help must list the commands");
+    UNITY_TEST_ASSERT(strstr(reply, "params: period_ms threshold\n") != NULL, __LINE__, "ERROR: help must list the parameters");
+    _type("help threshold\n");
+    UNITY_TEST_ASSERT_EQUAL_STRING("threshold: Threshold, even [0, 65535]\n", reply, __LINE__, "ERROR: Wrong description of a parameter");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_get);
+    RUN_TEST(test_set);
+    RUN_TEST(test_set_errors);
+    RUN_TEST(test_line_editing);
+    RUN_TEST(test_long_line_is_discarded);
+    RUN_TEST(test_help);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,93 @@
+/**
+ * @file test_speed_of_sound.c
+ * @brief Unit test for the compensation of the speed of sound with the temperature.
+ *
+ * The compensation does not depend on the hardware, so this test can be run on the host. The curve is checked against the exact law, 331.3 * sqrt(1 + T / 273.15) m/s, tabulated every 10 ºC.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "speed_of_sound.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TEST_MAX_ERROR_MM_S 250 /*!< Largest error of the curve from -20 ºC to 40 ºC */
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief Speed of sound of the exact law, in mm/s, from -20 ºC to 40 ºC every 10 ºC.
+ */
+static const uint32_t exact_mm_s[] = {318941, 325179, 331300, 337310, 343215, 349019, 354729};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_curve(void)
+{
+    for (uint32_t i = 0; i < sizeof(exact_mm_s) / sizeof(exact_mm_s[0]); i++)
+    {
+        int32_t temperature_dc = -200 + (int32_t)i * 100;
+        int32_t error_mm_s = (int32_t)speed_of_sound_get_mm_s(temperature_dc) - (int32_t)exact_mm_s[i];
+        UNITY_TEST_ASSERT((error_mm_s <= TEST_MAX_ERROR_MM_S) && (error_mm_s >= -TEST_MAX_ERROR_MM_S), __LINE__, "ERROR: The speed of sound is too far from the exact law");
+    }
+}
+
+void test_monotonic_and_clamped(void)
+{
+    uint32_t previous_mm_s = speed_of_sound_get_mm_s(SPEED_OF_SOUND_MIN_TEMPERATURE_DC);
+    for (int32_t temperature_dc = SPEED_OF_SOUND_MIN_TEMPERATURE_DC + 1; temperature_dc <= SPEED_OF_SOUND_MAX_TEMPERATURE_DC; temperature_dc++)
+    {
+        uint32_t speed_mm_s = speed_of_sound_get_mm_s(temperature_dc);
+        UNITY_TEST_ASSERT(speed_mm_s >= previous_mm_s, __LINE__, "ERROR: The speed of sound must grow with the temperature");
+        previous_mm_s = speed_mm_s;
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(speed_of_sound_get_mm_s(SPEED_OF_SOUND_MIN_TEMPERATURE_DC), speed_of_sound_get_mm_s(-2730), __LINE__, "ERROR: A colder reading must be clamped");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(speed_of_sound_get_mm_s(SPEED_OF_SOUND_MAX_TEMPERATURE_DC), speed_of_sound_get_mm_s(4095), __LINE__, "ERROR: A hotter reading must be clamped");
+}
+
+void test_distance(void)
+{
+    // Echo of an obstacle at 300 cm in air at -20 ºC
+    uint32_t width_us = 18812;
+    uint32_t cold_scale = speed_of_sound_get_scale(speed_of_sound_get_mm_s(-200));
+    uint32_t default_scale = speed_of_sound_get_scale(speed_of_sound_get_mm_s(200));
+    UNITY_TEST_ASSERT_EQUAL_UINT32(300, speed_of_sound_get_distance_cm(width_us, cold_scale), __LINE__, "ERROR: The distance must be compensated with the temperature");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(323, speed_of_sound_get_distance_cm(width_us, default_scale), __LINE__, "ERROR: Wrong distance at the default temperature");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, speed_of_sound_get_distance_cm(0, default_scale), __LINE__, "ERROR: An empty echo must give no distance");
+}
+
+void test_longest_echo(void)
+{
+    // The longest echo at the highest speed must not overflow the fixed point
+    uint32_t speed_mm_s = speed_of_sound_get_mm_s(SPEED_OF_SOUND_MAX_TEMPERATURE_DC);
+    uint32_t width_us = UINT32_MAX / 343;
+    uint64_t expected_cm = ((uint64_t)width_us * speed_mm_s + 10000000) / 20000000;
+    uint32_t distance_cm = speed_of_sound_get_distance_cm(width_us, speed_of_sound_get_scale(speed_mm_s));
+    UNITY_TEST_ASSERT((distance_cm + 1 >= expected_cm) && (distance_cm <= expected_cm + 1), __LINE__, "ERROR: The longest echo must give its distance");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_curve);
+    RUN_TEST(test_monotonic_and_clamped);
+    RUN_TEST(test_distance);
+    RUN_TEST(test_longest_echo);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,221 @@
+/**
+ * @file test_telemetry.c
+ * @brief Unit test for the COBS framing of the telemetry stream, its ring buffer and its decoder.
+ *
+ * The frames are read back from the ring buffer, so the test does not need a host on the UART.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_telemetry.h"
+#include "telemetry.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TEST_PERIOD_MS 100 /*!< Period of the status packets */
+
+/* Private variables ---------------------------------------------------------*/
+static telemetry_t telemetry;       /*!< Sender under test */
+static telemetry_decoder_t decoder; /*!< Decoder under test */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Feeds the bytes of the ring not sent yet to the decoder.
+ *
+ * @param p_packet Pointer to the last packet decoded.
+ *
+ * @return uint32_t Number of packets decoded.
+ */
+static uint32_t _decode_ring(telemetry_packet_t *p_packet)
+{
+    uint32_t num_packets = 0;
+    for (uint32_t i = telemetry.tail; i != telemetry.head; i++)
+    {
+        if (telemetry_decoder_feed(&decoder, telemetry.ring[i & (TELEMETRY_RING_SIZE - 1)], p_packet))
+        {
+            num_packets++;
+        }
+    }
+    return num_packets;
+}
+
+/**
+ * @brief Feeds a COBS frame and its delimiter to the decoder.
+ *
+ * @param p_frame Pointer to the encoded packet.
+ * @param length Length of the encoded packet.
+ * @param p_packet Pointer to the packet decoded.
+ *
+ * @return bool The frame has been decoded into a packet.
+ */
+static bool _feed_frame(const uint8_t *p_frame, uint32_t length, telemetry_packet_t *p_packet)
+{
+    for (uint32_t i = 0; i < length; i++)
+    {
+        telemetry_decoder_feed(&decoder, p_frame[i], p_packet);
+    }
+    return telemetry_decoder_feed(&decoder, 0, p_packet);
+}
+
+/**
+ * @brief Encodes a packet as the sender does.
+ *
+ * @param type Type of the packet.
+ * @param sequence Sequence number of the packet.
+ * @param p_frame Pointer to the encoded packet.
+ *
+ * @return uint32_t Length of the encoded packet.
+ */
+static uint32_t _encode_packet(uint8_t type, uint8_t sequence, uint8_t *p_frame)
+{
+    uint8_t packet[TELEMETRY_HEADER_SIZE + 3 + TELEMETRY_CRC_SIZE] = {type, sequence, 0x00, 0x11, 0x22};
+    uint16_t crc = telemetry_crc16(packet, TELEMETRY_HEADER_SIZE + 3);
+    packet[TELEMETRY_HEADER_SIZE + 3] = (uint8_t)crc;
+    packet[TELEMETRY_HEADER_SIZE + 4] = (uint8_t)(crc >> 8);
+    return telemetry_cobs_encode(packet, sizeof(packet), p_frame);
+}
+
+void setUp(void)
+{
+    telemetry_init(&telemetry, TEST_PERIOD_MS);
+    telemetry_decoder_init(&decoder);
+}
+
+void tearDown(void)
+{
+    // Let the DMA transfer in progress end before the ring is reused
+    while (telemetry_get_pending_bytes(&telemetry) > 0)
+    {
+        port_system_delay_ms(1);
+        telemetry_service(&telemetry);
+    }
+}
+
+void test_cobs_round_trip(void)
+{
+    // Zeros at both ends, consecutive zeros, and a run longer than a COBS block
+    static uint8_t data[600];
+    static uint8_t encoded[600 + 600 / 254 + 1];
+    static uint8_t decoded[sizeof(encoded)];
+    for (uint32_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)((i < 300) ? (i % 255) + 1 : i * 7);
+    }
+    data[0] = 0;
+    data[400] = 0;
+    data[401] = 0;
+    data[sizeof(data) - 1] = 0;
+
+    uint32_t length = telemetry_cobs_encode(data, sizeof(data), encoded);
+    UNITY_TEST_ASSERT(length <= sizeof(data) + sizeof(data) / 254 + 1, __LINE__, "ERROR: COBS must not add more than one byte every 254 bytes");
+    UNITY_TEST_ASSERT(memchr(encoded, 0, length) == NULL, __LINE__, "ERROR: The encoded bytes must have no zero");
+    int32_t decoded_length = telemetry_cobs_decode(encoded, length, decoded);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(sizeof(data), (uint32_t)decoded_length, __LINE__, "ERROR: The decoded length is not the original one");
+    UNITY_TEST_ASSERT(memcmp(data, decoded, sizeof(data)) == 0, __LINE__, "ERROR: The decoded bytes are not the original ones");
+
+    // Exactly one full block
+    length = telemetry_cobs_encode(&data[1], 254, encoded);
+    decoded_length = telemetry_cobs_decode(encoded, length, decoded);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(254, (uint32_t)decoded_length, __LINE__, "ERROR: A full block must decode to its 254 bytes");
+    UNITY_TEST_ASSERT(memcmp(&data[1], decoded, 254) == 0, __LINE__, "ERROR: The decoded bytes of a full block are not the original ones");
+}
+
+void test_crc16(void)
+{
+    static const uint8_t check[] = "123456789";
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0x29B1, telemetry_crc16(check, 9), __LINE__, "ERROR: The CRC-16/CCITT-FALSE of \"123456789\" must be 0x29B1");
+}
+
+void test_status_round_trip(void)
+{
+    telemetry_status_t status = {.timestamp_ms = 123456, .distance_cm = 0x01020300, .urbanite_state = 1, .ultrasound_state = 4, .display_state = 1, .buzzer_state = 0};
+    UNITY_TEST_ASSERT(telemetry_send_status(&telemetry, &status), __LINE__, "ERROR: A status must be queued in an empty ring");
+    UNITY_TEST_ASSERT(port_telemetry_is_busy(), __LINE__, "ERROR: The DMA transfer must start at once");
+
+    telemetry_packet_t packet;
+    telemetry_status_t parsed;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, _decode_ring(&packet), __LINE__, "ERROR: The ring must hold one packet");
+    UNITY_TEST_ASSERT(telemetry_parse_status(&packet, &parsed), __LINE__, "ERROR: The packet must be a status");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, packet.sequence, __LINE__, "ERROR: The first packet must have sequence number 0");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(status.timestamp_ms, parsed.timestamp_ms, __LINE__, "ERROR: The timestamp decoded is not the one sent");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(status.distance_cm, parsed.distance_cm, __LINE__, "ERROR: The distance decoded is not the one sent");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(status.ultrasound_state, parsed.ultrasound_state, __LINE__, "ERROR: The state decoded is not the one sent");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, parsed.num_packets, __LINE__, "ERROR: No packet must have been queued before the first one");
+}
+
+void test_due_at_period(void)
+{
+    UNITY_TEST_ASSERT(telemetry_is_due(&telemetry, 1000), __LINE__, "ERROR: The first status must be due at once");
+    UNITY_TEST_ASSERT(!telemetry_is_due(&telemetry, 1000 + TEST_PERIOD_MS - 1), __LINE__, "ERROR: A status must not be due before the period");
+    UNITY_TEST_ASSERT(telemetry_is_due(&telemetry, 1000 + 5 * TEST_PERIOD_MS), __LINE__, "ERROR: A late status must be due");
+    UNITY_TEST_ASSERT(!telemetry_is_due(&telemetry, 1000 + 5 * TEST_PERIOD_MS + 1), __LINE__, "ERROR: A late status must not make the next one come sooner");
+}
+
+void test_full_ring_drops_whole_frames(void)
+{
+    // Much faster than the UART: the ring fills and the packets that do not fit are dropped
+    telemetry_status_t status = {.timestamp_ms = 1, .distance_cm = 100};
+    uint32_t num_sent = 0;
+    for (uint32_t i = 0; i < 2 * TELEMETRY_RING_SIZE / TELEMETRY_MAX_FRAME + 10; i++)
+    {
+        num_sent += telemetry_send_status(&telemetry, &status) ? 1 : 0;
+    }
+    UNITY_TEST_ASSERT(telemetry.num_dropped > 0, __LINE__, "ERROR: The packets that do not fit in the ring must be dropped");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(num_sent, telemetry.num_packets, __LINE__, "ERROR: Every packet queued must be counted");
+    UNITY_TEST_ASSERT(telemetry_get_pending_bytes(&telemetry) <= TELEMETRY_RING_SIZE, __LINE__, "ERROR: The ring must not overflow");
+
+    // The ring holds whole frames from the first delimiter on, up to the last packet queued
+    telemetry_packet_t packet;
+    UNITY_TEST_ASSERT(_decode_ring(&packet) > 0, __LINE__, "ERROR: The ring must hold packets");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, decoder.num_errors, __LINE__, "ERROR: The ring must hold no corrupt frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, decoder.num_lost, __LINE__, "ERROR: The dropped packets must not use a sequence number");
+    UNITY_TEST_ASSERT_EQUAL_UINT32((uint8_t)(num_sent - 1), packet.sequence, __LINE__, "ERROR: The last packet of the ring must be the last one queued");
+}
+
+void test_decoder_resync(void)
+{
+    uint8_t frame[16];
+    telemetry_packet_t packet;
+
+    // The bytes before the first delimiter are a partial frame
+    uint32_t length = _encode_packet(7, 10, frame);
+    UNITY_TEST_ASSERT(!_feed_frame(&frame[2], length - 2, &packet), __LINE__, "ERROR: A frame before the first delimiter must be discarded");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, decoder.num_errors, __LINE__, "ERROR: A frame before the first delimiter is not an error");
+
+    UNITY_TEST_ASSERT(_feed_frame(frame, length, &packet), __LINE__, "ERROR: A whole frame must be decoded");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(7, packet.type, __LINE__, "ERROR: The type decoded is not the one sent");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, packet.length, __LINE__, "ERROR: The length decoded is not the one sent");
+
+    // A corrupt byte is caught by the CRC, and the next frame is decoded
+    length = _encode_packet(7, 11, frame);
+    frame[length - 1] ^= 0x40;
+    UNITY_TEST_ASSERT(!_feed_frame(frame, length, &packet), __LINE__, "ERROR: A corrupt frame must be discarded");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, decoder.num_errors, __LINE__, "ERROR: A corrupt frame must be counted");
+    length = _encode_packet(7, 13, frame);
+    UNITY_TEST_ASSERT(_feed_frame(frame, length, &packet), __LINE__, "ERROR: The frame after a corrupt one must be decoded");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, decoder.num_lost, __LINE__, "ERROR: The packets missing from the sequence numbers must be counted");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_cobs_round_trip);
+    RUN_TEST(test_crc16);
+    RUN_TEST(test_status_round_trip);
+    RUN_TEST(test_due_at_period);
+    RUN_TEST(test_full_ring_drops_whole_frames);
+    RUN_TEST(test_decoder_resync);
+
+    exit(UNITY_END());
+}
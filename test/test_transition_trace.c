@@ -0,0 +1,92 @@
+/**
+ * @file test_transition_trace.c
+ * @brief Unit test for the trace of the transitions of the FSMs.
+ *
+ * The trace does not depend on the hardware, so this test can be run on the host. A reset is emulated by restoring the trace without initializing it.
+ *
+ * @author Marcos Perez
+ * @author Jorge Lopez-Galvez
+ * @date 19/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "transition_trace.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TEST_FSM_ID TRANSITION_TRACE_ID(TRANSITION_TRACE_FSM_ULTRASOUND, 0) /*!< ID of the FSM of the records */
+
+/* Private variables ---------------------------------------------------------*/
+static transition_trace_t trace; /*!< Trace under test */
+
+void setUp(void)
+{
+    transition_trace_init(&trace);
+}
+
+void tearDown(void)
+{
+}
+
+void test_order(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, transition_trace_get_count(&trace), __LINE__, "ERROR: A new trace must be empty");
+    transition_trace_add(&trace, 10, TEST_FSM_ID, 0, 1);
+    transition_trace_add(&trace, 20, TEST_FSM_ID, 1, 2);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, transition_trace_get_count(&trace), __LINE__, "ERROR: Every transition must be kept");
+    const transition_trace_record_t *p_record = transition_trace_get_record(&trace, 0);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(10, p_record->timestamp_ms, __LINE__, "ERROR: The first record must be the oldest");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_FSM_ID, p_record->fsm_id, __LINE__, "ERROR: Wrong FSM of the record");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, p_record->to_state, __LINE__, "ERROR: Wrong state of the record");
+    UNITY_TEST_ASSERT(transition_trace_get_record(&trace, 2) == NULL, __LINE__, "ERROR: There must be no record beyond the count");
+}
+
+void test_wrap_around(void)
+{
+    for (uint32_t i = 0; i < TRANSITION_TRACE_MAX_RECORDS + 5; i++)
+    {
+        transition_trace_add(&trace, i, TEST_FSM_ID, (uint8_t)i, (uint8_t)(i + 1));
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TRANSITION_TRACE_MAX_RECORDS, transition_trace_get_count(&trace), __LINE__, "ERROR: A full trace must keep all its records");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(5, transition_trace_get_record(&trace, 0)->timestamp_ms, __LINE__, "ERROR: The oldest records must be overwritten");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TRANSITION_TRACE_MAX_RECORDS + 4, transition_trace_get_record(&trace, TRANSITION_TRACE_MAX_RECORDS - 1)->timestamp_ms, __LINE__, "ERROR: The last record must be the newest");
+}
+
+void test_restore_keeps_records(void)
+{
+    transition_trace_add(&trace, 100, TEST_FSM_ID, 0, 1);
+    transition_trace_add(&trace, 200, TEST_FSM_ID, 1, 0);
+    UNITY_TEST_ASSERT(transition_trace_restore(&trace, 3), __LINE__, "ERROR: A valid trace must be kept across a reset");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, transition_trace_get_count(&trace), __LINE__, "ERROR: The reset must be marked with a record");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(200, transition_trace_get_record(&trace, 1)->timestamp_ms, __LINE__, "ERROR: The records before the reset must be kept");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TRANSITION_TRACE_ID_RESET, transition_trace_get_record(&trace, 2)->fsm_id, __LINE__, "ERROR: The last record must mark the reset");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, trace.num_resets, __LINE__, "ERROR: The reset must be counted");
+}
+
+void test_restore_after_power_on(void)
+{
+    // The RAM holds garbage after a power-on
+    memset(&trace, 0xA5, sizeof(trace));
+    UNITY_TEST_ASSERT(!transition_trace_restore(&trace, 0), __LINE__, "ERROR: A trace with an invalid header must not be kept");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, transition_trace_get_count(&trace), __LINE__, "ERROR: A trace with an invalid header must be emptied");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TRANSITION_TRACE_MAGIC, trace.magic, __LINE__, "ERROR: An emptied trace must have a valid header");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_order);
+    RUN_TEST(test_wrap_around);
+    RUN_TEST(test_restore_keeps_records);
+    RUN_TEST(test_restore_after_power_on);
+
+    exit(UNITY_END());
+}